@@ -387,4 +387,74 @@ int readn(int fd, void *buf, int size)
   }
   return 0;
 }
+
+int pwriten(int fd, const void *buf, int size, off_t offset)
+{
+  const char *tmp = (const char *)buf;
+  while (size > 0) {
+    const ssize_t ret = ::pwrite(fd, tmp, size, offset);
+    if (ret >= 0) {
+      tmp    += ret;
+      size   -= ret;
+      offset += ret;
+      continue;
+    }
+    const int err = errno;
+    if (EAGAIN != err && EINTR != err)
+      return err;
+  }
+  return 0;
+}
+
+int preadn(int fd, void *buf, int size, off_t offset)
+{
+  char *tmp = (char *)buf;
+  while (size > 0) {
+    const ssize_t ret = ::pread(fd, tmp, size, offset);
+    if (ret > 0) {
+      tmp    += ret;
+      size   -= ret;
+      offset += ret;
+      continue;
+    }
+    if (0 == ret)
+      return -1; // end of file
+
+    const int err = errno;
+    if (EAGAIN != err && EINTR != err)
+      return err;
+  }
+  return 0;
+}
+
+int preadvn(int fd, struct iovec *iov, int iovcnt, off_t offset, int64_t &read_size)
+{
+  read_size = 0;
+  while (iovcnt > 0) {
+    const ssize_t ret = ::preadv(fd, iov, iovcnt, offset);
+    if (ret < 0) {
+      const int err = errno;
+      if (EAGAIN != err && EINTR != err)
+        return err;
+      continue;
+    }
+    if (0 == ret)
+      return -1; // end of file
+
+    read_size += ret;
+    offset    += ret;
+    // 跳过已经读满的缓冲区，调整读了一部分的缓冲区
+    size_t left = static_cast<size_t>(ret);
+    while (iovcnt > 0 && left >= iov->iov_len) {
+      left -= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+    if (iovcnt > 0) {
+      iov->iov_base = static_cast<char *>(iov->iov_base) + left;
+      iov->iov_len -= left;
+    }
+  }
+  return 0;
+}
 }  // namespace structor
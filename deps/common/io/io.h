@@ -16,6 +16,8 @@ See the Mulan PSL v2 for more details. */
 
 #include <string>
 #include <vector>
+#include <sys/types.h>
+#include <sys/uio.h>
 
 #include "common/defs.h"
 
@@ -77,4 +79,40 @@ int writen(int fd, const void *buf, int size);
  */
 int readn(int fd, void *buf, int size);
 
+/**
+ * @brief 在指定偏移位置一次性写入所有数据，不会修改文件描述符的读写位置
+ * @details 多个线程共享同一个描述符时，使用lseek+write会互相干扰，可以使用这个接口
+ *
+ * @param fd  写入的描述符
+ * @param buf 写入的数据
+ * @param size 写入多少数据
+ * @param offset 写入的位置
+ * @return int 0 表示成功，否则返回errno
+ */
+int pwriten(int fd, const void *buf, int size, off_t offset);
+
+/**
+ * @brief 从指定偏移位置一次性读取指定长度的数据，不会修改文件描述符的读写位置
+ *
+ * @param fd  读取的描述符
+ * @param buf 读取到这里
+ * @param size 读取的数据长度
+ * @param offset 读取的位置
+ * @return int 返回0表示成功。-1 表示读取到文件尾，并且没有读到size大小数据，其它表示errno
+ */
+int preadn(int fd, void *buf, int size, off_t offset);
+
+/**
+ * @brief 从指定偏移位置读取数据到多个缓冲区中，用一次系统调用读取多个连续的页面
+ * @details 读取了部分数据时会修改iov数组的内容
+ *
+ * @param fd  读取的描述符
+ * @param iov 缓冲区数组
+ * @param iovcnt 缓冲区个数
+ * @param offset 读取的位置
+ * @param read_size 返回实际读取了多少数据
+ * @return int 返回0表示成功。-1 表示读取到文件尾，只读到了read_size大小的数据，其它表示errno
+ */
+int preadvn(int fd, struct iovec *iov, int iovcnt, off_t offset, int64_t &read_size);
+
 }  // namespace structor
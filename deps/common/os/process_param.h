@@ -140,6 +140,86 @@ public:
     return buffer_pool_memory_size_;
   }
 
+  void set_worker_thread_num(int thread_num)
+  {
+    worker_thread_num_ = thread_num;
+  }
+
+  int worker_thread_num() const
+  {
+    return worker_thread_num_;
+  }
+
+  void set_sort_memory_size(int bytes)
+  {
+    sort_memory_size_ = bytes;
+  }
+
+  int sort_memory_size() const
+  {
+    return sort_memory_size_;
+  }
+
+  void set_join_memory_size(int bytes)
+  {
+    join_memory_size_ = bytes;
+  }
+
+  int join_memory_size() const
+  {
+    return join_memory_size_;
+  }
+
+  void set_group_memory_size(int bytes)
+  {
+    group_memory_size_ = bytes;
+  }
+
+  int group_memory_size() const
+  {
+    return group_memory_size_;
+  }
+
+  void set_index_fill_factor(int percent)
+  {
+    index_fill_factor_ = percent;
+  }
+
+  int index_fill_factor() const
+  {
+    return index_fill_factor_;
+  }
+
+  void set_index_key_compressed(bool compressed)
+  {
+    index_key_compressed_ = compressed;
+  }
+
+  bool index_key_compressed() const
+  {
+    return index_key_compressed_;
+  }
+
+  void set_load_thread_num(int thread_num)
+  {
+    load_thread_num_ = thread_num;
+  }
+
+  int load_thread_num() const
+  {
+    return load_thread_num_;
+  }
+
+  void set_scan_thread_num(int thread_num)
+  {
+    scan_thread_num_ = thread_num;
+  }
+
+  int scan_thread_num() const
+  {
+    return scan_thread_num_;
+  }
+
 private:
   std::string std_out_;           // The output file
   std::string std_err_;           // The err output file
@@ -152,6 +232,14 @@ private:
   std::string protocol_;
   std::string trx_kit_name_;
   int buffer_pool_memory_size_ = -1;
+  int worker_thread_num_ = -1;    // worker threads handling requests(if invalid, decided by the server)
+  int sort_memory_size_ = -1;     // memory used by a sort before spilling to temporary files(if invalid, use the default)
+  int join_memory_size_ = -1;     // memory used by a hash join before spilling to temporary files(if invalid, use the default)
+  int group_memory_size_ = -1;    // memory used by a hash aggregation before spilling to temporary files(if invalid, use the default)
+  int index_fill_factor_ = -1;    // percent of each page filled when building an index in bulk(if invalid, use the default)
+  bool index_key_compressed_ = false;  // whether new indexes store keys with prefix compression
+  int load_thread_num_ = -1;      // threads parsing the file of LOAD DATA(if invalid, the number of cpu cores)
+  int scan_thread_num_ = -1;      // threads scanning a table in parallel for an aggregation(if invalid, the number of cpu cores)
 };
 
 ProcessParam *&the_process_param();
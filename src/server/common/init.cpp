@@ -125,6 +125,8 @@ int init_global_objects(ProcessParam *process_param, Ini &properties)
 {
   GCTX.buffer_pool_manager_ = new BufferPoolManager();
   BufferPoolManager::set_instance(GCTX.buffer_pool_manager_);
+  GCTX.buffer_pool_manager_->page_writer().start();
+  GCTX.buffer_pool_manager_->page_reader().start();
 
   GCTX.handler_ = new DefaultHandler();
   
@@ -15,11 +15,13 @@ class FieldMeta;
 class CreateIndexStmt : public Stmt
 {
 public:
-  CreateIndexStmt(Table *table, std::vector<const FieldMeta*> &multi_field_metas, const std::string &index_name, bool is_unique)
+  CreateIndexStmt(Table *table, std::vector<const FieldMeta*> &multi_field_metas, const std::string &index_name, bool is_unique,
+      bool key_compressed = false)
         : table_(table),
           multi_field_metas_(multi_field_metas),
           index_name_(index_name),
-          is_unique_(is_unique)
+          is_unique_(is_unique),
+          key_compressed_(key_compressed)
   {}
 
   virtual ~CreateIndexStmt() = default;
@@ -31,6 +33,7 @@ public:
   std::vector<const FieldMeta*> &multi_field_metas()  { return multi_field_metas_; }
   const std::string &index_name() const { return index_name_; }
   const bool is_unique() const { return is_unique_; }
+  bool key_compressed() const { return key_compressed_; }
 
 public:
   static RC create(Db *db, const CreateIndexSqlNode &create_index, Stmt *&stmt);
@@ -40,4 +43,5 @@ private:
   std::vector<const FieldMeta*> multi_field_metas_;
   std::string index_name_;
   bool is_unique_;
+  bool key_compressed_ = false;
 };
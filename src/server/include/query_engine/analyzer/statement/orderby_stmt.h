@@ -53,13 +53,21 @@ public:
   {
     return order_units_;
   }
+  /**
+   * @brief 只需要排序后的前 limit 行，小于0表示没有限制
+   */
+  int limit() const
+  {
+    return limit_;
+  }
 
 public:
-  static RC create(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables, const std::vector<OrderByNode>& order_by_list, int order_by_num,   OrderByStmt *&stmt);
+  static RC create(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables, const std::vector<OrderByNode>& order_by_list, int order_by_num, int limit, OrderByStmt *&stmt);
 
   static RC create_order_unit(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
       const OrderByNode& orderByNode, OrderByUnit *&order_unit);
 
 private:
   std::vector<OrderByUnit *> order_units_;
+  int limit_ = -1;
 };
@@ -42,7 +42,8 @@ class Db;
   DEFINE_ENUM_ITEM(PREDICATE)       \
   DEFINE_ENUM_ITEM(SET_VARIABLE)    \
   DEFINE_ENUM_ITEM(GROUP_BY)        \
-  DEFINE_ENUM_ITEM(CREATE_VIEW)
+  DEFINE_ENUM_ITEM(CREATE_VIEW)     \
+  DEFINE_ENUM_ITEM(VACUUM)
 
 enum class StmtType {
   #define DEFINE_ENUM_ITEM(name)  name,
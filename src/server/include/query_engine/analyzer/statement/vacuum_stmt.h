@@ -0,0 +1,28 @@
+#pragma once
+
+#include "stmt.h"
+
+class Db;
+class Table;
+
+/**
+ * @brief 回收已删除记录的语句
+ * @ingroup Statement
+ */
+class VacuumStmt : public Stmt
+{
+public:
+  VacuumStmt(Table *table) : table_(table)
+  {}
+  virtual ~VacuumStmt() = default;
+
+  StmtType type() const override { return StmtType::VACUUM; }
+
+  /// 为空时回收所有的表
+  Table *table() const { return table_; }
+
+  static RC create(Db *db, const VacuumSqlNode &vacuum, Stmt *&stmt);
+
+private:
+  Table *table_ = nullptr;
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "include/common/rc.h"
+
+class QueryInfo;
+
+/**
+ * @brief 回收已删除记录的执行器
+ * @ingroup Executor
+ */
+class VacuumExecutor
+{
+public:
+  VacuumExecutor() = default;
+  virtual ~VacuumExecutor() = default;
+
+  RC execute(QueryInfo *query_info);
+};
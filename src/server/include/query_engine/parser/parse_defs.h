@@ -8,8 +8,9 @@
 #include "value.h"
 
 #define MAX_FIELD_AMOUNT 20
-#define MAX_TEXT_VALUE_LENGTH_IN_RECORD 100
+#define MAX_TEXT_VALUE_LENGTH_IN_RECORD 16  // 记录中只保存文本的位置，参考 TextRef
 #define MIN_TEXT_LENGTH 1024
+#define MAX_TEXT_LENGTH 65535
 
 class Expression;
 
@@ -92,6 +93,17 @@ struct OrderByNode
   int is_asc = 1;            // sort type
 };
 
+/**
+ * @brief 描述一个 order by 子句
+ * @ingroup SQLParser
+ * @details 后面可以跟 LIMIT n，只需要排序后的前 n 行。limit 小于0表示没有限制
+ */
+struct OrderBySqlNode
+{
+  std::vector<OrderByNode> order_lists;
+  int                      limit = -1;
+};
+
 /**
  * @brief 描述一个 join 结构
  * @ingroup SQLParser
@@ -153,6 +165,7 @@ struct SelectSqlNode
   std::vector<RelAttrSqlNode>     group_by_attributes; ///< group by 属性
   WhereConditions                 having_conditions; /// < group by 条件
   std::vector<OrderByNode>        order_lists;   ///< order 列表
+  int                             limit = -1;    ///< order by 后面的 limit，小于0表示没有限制
   std::vector<FunctionUnit>       functions;     ///< function 列表
 };
 //struct SelectFunctionNode
@@ -271,6 +284,7 @@ struct CreateIndexSqlNode
   std::string relation_name;   ///< Relation name
   std::vector<std::string> multi_attribute_names;
   bool is_unique_;
+  bool key_compressed = false;  ///< 索引节点中的键是否使用前缀压缩，-K 参数会让所有新建的索引都压缩
 };
 
 /**
@@ -304,6 +318,16 @@ struct LoadDataSqlNode
   std::string file_name;
 };
 
+/**
+ * @brief 描述一个vacuum语句
+ * @ingroup SQLParser
+ * @details 回收已经被删除、并且所有事务都不会再看到的记录。relation_name 为空时处理所有的表
+ */
+struct VacuumSqlNode
+{
+  std::string relation_name;
+};
+
 /**
  * @brief 设置变量的值
  * @ingroup SQLParser
@@ -372,6 +396,7 @@ enum SqlCommandFlag
   SCF_EXIT,
   SCF_EXPLAIN,
   SCF_SET_VARIABLE, ///< 设置变量
+  SCF_VACUUM,       ///< 回收已删除的记录
 };
 /**
  * @brief 表示一个SQL语句
@@ -397,6 +422,7 @@ public:
   LoadDataSqlNode           load_data;
   ExplainSqlNode            explain;
   SetVariableSqlNode        set_variable;
+  VacuumSqlNode             vacuum;
 
 public:
   ParsedSqlNode();
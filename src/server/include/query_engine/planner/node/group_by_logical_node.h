@@ -5,7 +5,8 @@
 class Expression;
 
 /**
- * TODO GroupBy的逻辑节点定义, GroupBy需要在聚合指定列的基础上进行聚合运算,因此需要有相应的描述符
+ * @brief GroupBy的逻辑节点，在分组列相同的行上做聚合运算
+ * @details 聚合函数的描述继承自AggrLogicalNode，这里另外记录分组列
  */
 class GroupByLogicalNode : public AggrLogicalNode
 {
@@ -18,4 +19,9 @@ public:
   LogicalNodeType type() const override {
     return LogicalNodeType::GROUP_BY;
   }
+
+  const std::vector<Field> &group_fields() const { return group_fields_; }
+
+private:
+  std::vector<Field> group_fields_;
 };
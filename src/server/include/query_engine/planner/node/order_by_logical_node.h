@@ -17,6 +17,14 @@ public:
   std::vector<OrderByUnit *> order_units() {
     return order_units_;
   }
+
+  /**
+   * @brief 只需要排序后的前 limit 行，小于0表示需要所有行
+   */
+  void set_limit(int64_t limit) { limit_ = limit; }
+  int64_t limit() const { return limit_; }
+
 private:
   std::vector<OrderByUnit *> order_units_;
+  int64_t limit_ = -1;
 };
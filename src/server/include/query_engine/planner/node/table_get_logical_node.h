@@ -17,6 +17,10 @@ public:
   Table *table() const  { return table_; }
   std::string table_alias() const { return table_alias_; }
   bool readonly() const { return readonly_; }
+  /**
+   * @brief 查询中用到的这个表的所有字段，包括投影、过滤、连接和排序中的字段
+   */
+  const std::vector<Field> &fields() const { return fields_; }
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
   std::vector<std::unique_ptr<Expression>> &predicates()
@@ -3,7 +3,18 @@
 #include "physical_operator.h"
 #include "include/query_engine/planner/node/aggr_logical_node.h"
 #include "include/query_engine/structor/tuple/aggregation_tuple.h"
+#include "include/query_engine/structor/chunk.h"
 
+class GatherPhysicalOperator;
+
+/**
+ * @brief 不分组的聚合算子
+ * @ingroup PhysicalOperator
+ * @details open 时确定每个聚合字段在下层元组中的下标，每行只按下标取值；
+ * 每个聚合函数的中间结果按类型分别累加，不需要每行构造新的 Value。
+ * 只有 COUNT(*) 并且下层是没有过滤条件的表扫描时，直接使用每个页面的记录个数。
+ * 下层是 GatherPhysicalOperator 时，每个扫描线程各自聚合自己扫描到的数据，最后合并各个线程的中间结果。
+ */
 class AggrPhysicalOperator : public PhysicalOperator
 {
 public:
@@ -35,16 +46,79 @@ public:
   Tuple *current_tuple() override;
 
 private:
+  /**
+   * @brief 一个聚合函数的中间结果
+   */
+  struct Accumulator
+  {
+    AttrType    type = AttrType::UNDEFINED;  // 输入值的类型，第一次遇到非null值时确定
+    int64_t     count = 0;                   // 非null值的个数，COUNT(*)时是行数
+    int64_t     int_value = 0;               // 整数和日期的和或者最值
+    double      float_value = 0;             // 浮点数和字符串的和，浮点数的最值
+    std::string string_value;                // 字符串的最值
+  };
+
+  /**
+   * @brief 所有聚合函数的中间结果，并行聚合时每个线程一个
+   */
+  struct PartialAggr
+  {
+    std::vector<Accumulator> accumulators;
+    std::vector<int>         columns;  // 聚合字段在 chunk 中的列，count(*)为-1，第一批数据到来时确定
+    Value                    value;    // 逐行聚合时复用
+  };
+
   std::vector<std::string> alias_;
   std::vector<AggrType> aggr_types_;
   std::vector<Field> aggr_fields_;
 
-  std::vector<Value> aggr_results_;
-  std::vector<bool> all_null_;
-  std::vector<int> counts_;
-  bool is_first_called_;
+  PartialAggr partial_;
+  bool finished_ = false;
   AggrTuple tuple_;
-  void aggr_init();
-  void aggr_update(AggrType aggr_type, Value& aggr_result, Value& value);
+
+  // 聚合字段在下层元组中的下标，COUNT(*)为-2，下层元组不支持按下标访问时为-1，这时按 specs_ 查找
+  std::vector<int> cell_indexes_;
+  std::vector<TupleCellSpec> specs_;
+
+  Chunk chunk_;  // 子算子支持向量化执行时，按批获取数据
+
+  void aggr_init(PartialAggr &partial) const;
+  void bind_cells(const Tuple *tuple);
   void aggr_done();
+
+  /**
+   * @brief 聚合一行中的一个非null值
+   */
+  void aggr_value(PartialAggr &partial, int index, const Value &value);
+  /**
+   * @brief 合并 count 个整数值的聚合结果，value 是它们的和或者最值，取决于聚合函数
+   */
+  void aggr_int(PartialAggr &partial, int index, AttrType type, int64_t count, int64_t value);
+  void aggr_float(PartialAggr &partial, int index, AttrType type, int64_t count, double value);
+  void aggr_string(PartialAggr &partial, int index, AttrType type, int64_t count, const std::string &value);
+
+  /**
+   * @brief 只有 COUNT(*) 时，尝试直接从下层的表扫描得到行数
+   */
+  RC count_records(bool &counted);
+
+  /**
+   * @brief 聚合一批数据
+   */
+  RC aggr_batch(PartialAggr &partial, Chunk &chunk);
+  /**
+   * @brief 定长数值列直接在数组上循环，每批只合并一次结果
+   */
+  template <typename T>
+  void aggr_numeric_column(PartialAggr &partial, int index, const Column &column, const std::vector<int> &selection);
+  /**
+   * @brief 其它类型的列逐行取出Value聚合
+   */
+  void aggr_column(PartialAggr &partial, int index, const Column &column, const std::vector<int> &selection);
+
+  /**
+   * @brief 每个扫描线程聚合到自己的 PartialAggr 中，全部结束后合并到 partial_
+   */
+  RC aggr_parallel(GatherPhysicalOperator &gather);
+  void merge(const PartialAggr &other);
 };
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "physical_operator.h"
+#include "include/query_engine/planner/operator/table_scan_physical_operator.h"
+#include "include/storage_engine/recorder/record_manager.h"
+
+/**
+ * @brief 并行扫描一张表的算子
+ * @ingroup PhysicalOperator
+ * @details 每个子算子是同一张表上的一个 TableScanPhysicalOperator，过滤条件相同，
+ * 它们共享一个 PageRangeDispenser，从中领取固定大小的页面范围(morsel)扫描，扫描完再领取下一个。
+ * execute 为每个子算子启动一个线程，读到的每批数据直接在这个线程上交给上层算子处理(比如部分聚合)，
+ * 上层算子最后合并各个线程的结果。
+ * 通过 next/next_batch 读取数据时，按顺序逐个读取子算子，与普通的表扫描相同，只是不并行。
+ */
+class GatherPhysicalOperator : public PhysicalOperator
+{
+public:
+  /**
+   * @brief 在一个线程上处理一批数据，worker 是子算子的下标
+   */
+  using Consumer = std::function<RC(int worker, Chunk &chunk)>;
+
+public:
+  GatherPhysicalOperator(std::unique_ptr<TableScanPhysicalOperator> scan, int worker_num);
+  virtual ~GatherPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override
+  {
+    return PhysicalOperatorType::GATHER;
+  }
+
+  std::string param() const override;
+
+  RC open(Trx *trx) override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override;
+
+  bool support_batch() const override { return children_.front()->support_batch(); }
+  RC next_batch(Chunk &chunk) override;
+
+  /**
+   * @brief 每个子算子一个线程，并行读取所有数据，交给 consumer 处理
+   * @details 返回第一个失败的子算子或者 consumer 的错误码，其它线程在领取下一批数据前停止
+   */
+  RC execute(const Consumer &consumer);
+
+  /**
+   * @brief 并行扫描最多使用多少个线程
+   * @details 没有开启 CONCURRENCY 时存储层的锁都是空操作，只能用一个线程
+   */
+  static int thread_num();
+
+  /**
+   * @brief 扫描这个算子的表时应该使用几个线程，返回1时不需要并行扫描
+   * @details 每个线程至少能领取到两个页面范围才值得启动
+   */
+  static int worker_num_of(const TableScanPhysicalOperator &scan);
+
+private:
+  Table             *table_ = nullptr;
+  PageRangeDispenser page_ranges_;
+  size_t             current_ = 0;  // 逐个读取子算子时，正在读取的子算子
+};
@@ -1,13 +1,34 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "physical_operator.h"
 #include "include/query_engine/planner/node/group_by_logical_node.h"
+#include "include/query_engine/structor/spill_file.h"
 #include "include/query_engine/structor/tuple/aggregation_tuple.h"
-#include "include/query_engine/structor/tuple/join_tuple.h"
 
 /**
- * TODO GroupBy算子的具体实现
+ * @brief GroupBy算子，使用哈希表做分组聚合
+ * @ingroup PhysicalOperator
+ * @details 分组列的值编码成紧凑的二进制串作为分组键，放在开放寻址的哈希表中。
+ * 每个分组的每个聚合函数(COUNT、SUM、MIN、MAX、AVG)的中间状态是一个定长的 AggrState，
+ * 所有分组的状态连续存放，累加一行时不需要分配内存。
+ *
+ * 哈希表占用的内存超过 memory_limit 时，把表中所有分组的中间状态按照分组键的哈希值写到
+ * PARTITION_NUM 个分区的临时文件中，清空哈希表以后继续读取下层算子(部分预聚合)。
+ * 下层算子读完以后，没有溢出时直接输出哈希表中的分组；否则把剩下的分组也写出去，
+ * 再逐个分区读回来合并中间状态(重新聚合)后输出。一个分区仍然放不进内存时用下一层的哈希种子重新分区，
+ * 最多 MAX_PARTITION_LEVEL 层。这样分组个数很多时也只读一遍下层算子，并且内存有上限。
  */
 class GroupByPhysicalOperator : public PhysicalOperator {
 
+public:
+  static constexpr int    PARTITION_NUM = 16;
+  static constexpr int    MAX_PARTITION_LEVEL = 4;
+  static constexpr size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
 public:
 
   GroupByPhysicalOperator(GroupByLogicalNode *logical_oper);
@@ -22,4 +43,102 @@ public:
   RC close() override;
 
   Tuple *current_tuple() override;
-};
\ No newline at end of file
+
+  /**
+   * @brief 分组聚合在内存中最多使用多少字节
+   */
+  static size_t memory_limit();
+
+private:
+  /**
+   * @brief 一个分组中一个聚合函数的中间状态
+   */
+  struct AggrState
+  {
+    int64_t count;         // 参与聚合的非null值的个数，COUNT(*)时是行数
+    union {
+      int64_t int_value;   // 整数和日期的和或者最值
+      double  float_value; // 浮点数和字符串的和，浮点数的最值
+    };
+    int32_t string_index;  // 字符串的最值在 HashTable::strings 中的下标，没有时是-1
+  };
+
+  /**
+   * @brief 哈希表中的一个分组，分组键放在 HashTable::keys 中
+   */
+  struct Group
+  {
+    uint64_t hash;
+    uint32_t key_offset;
+    uint32_t key_len;
+  };
+
+  /**
+   * @brief 开放寻址(线性探测)的哈希表，buckets 中是分组的下标，-1表示空
+   */
+  struct HashTable
+  {
+    std::vector<char>        keys;
+    std::vector<Group>       groups;
+    std::vector<AggrState>   states;   // 第i个分组的状态是 states[i * 聚合函数个数, (i + 1) * 聚合函数个数)
+    std::vector<std::string> strings;
+    std::vector<int32_t>     buckets;
+    size_t                   string_memory = 0;
+
+    size_t memory() const;
+    void   clear();
+  };
+
+  /**
+   * @brief 溢出的分区，每行是一个分组的中间状态
+   */
+  struct Partition
+  {
+    int                        level = 0;
+    std::unique_ptr<SpillFile> file;
+  };
+
+  RC   bind_cells(const Tuple &tuple);
+  RC   cell_of(const Tuple &tuple, int index, const TupleCellSpec &spec, Value &value) const;
+  void encode_group_key(const std::vector<Value> &values, std::string &key) const;
+  void decode_group_key(const char *key, int key_len, std::vector<Value> &values) const;
+
+  int  find_or_insert(HashTable &table, const std::string &key, uint64_t hash);
+  void grow(HashTable &table);
+  void accumulate(HashTable &table, AggrState &state, int index, const Value &value);
+  void merge(HashTable &table, AggrState &state, int index, const AggrState &other, const std::string *other_string);
+  void aggr_result(const HashTable &table, const AggrState &state, int index, Value &value) const;
+
+  RC aggregate();
+  RC spill(HashTable &table, std::vector<std::unique_ptr<Partition>> &partitions, int level);
+  RC process_partition(std::unique_ptr<Partition> partition);
+
+  static uint64_t hash_of(const char *key, int key_len);
+  static int      partition_of(uint64_t hash, int level);
+
+private:
+  std::vector<std::string> alias_;
+  std::vector<AggrType>    aggr_types_;
+  std::vector<Field>       aggr_fields_;
+  std::vector<Field>       group_fields_;
+
+  // 分组列和聚合字段在下层元组中的下标，找不到时是-1，每行按照名字查找。COUNT(*)的聚合字段是-2
+  bool                       bound_ = false;
+  std::vector<int>           group_indexes_;
+  std::vector<int>           aggr_indexes_;
+  std::vector<TupleCellSpec> group_specs_;
+  std::vector<TupleCellSpec> aggr_specs_;
+  std::vector<AttrType>      value_types_;  // 每个聚合函数输入值的类型，第一次遇到非null值时确定
+
+  bool                                    aggregated_ = false;
+  HashTable                               table_;       // 正在输出的哈希表
+  size_t                                  output_pos_ = 0;
+  std::vector<std::unique_ptr<Partition>> pending_;     // 等待重新聚合的溢出分区
+
+  // 累加一行时复用，避免每行分配内存
+  std::vector<Value> group_values_;
+  std::string        key_;
+  Value              value_;
+
+  AggrTuple tuple_;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "physical_operator.h"
+#include "include/query_engine/structor/tuple/row_tuple.h"
+#include "include/storage_engine/recorder/record_manager.h"
+
+class IndexScanner;
+
+/**
+ * @brief 只扫描索引的算子(covering index scan)
+ * @ingroup PhysicalOperator
+ * @details 查询用到的这个表的字段都在索引中时使用。叶子节点的键中已经保存了索引字段的值，
+ * 直接用它们拼出一条只有索引字段的记录，不需要再按照RID读取数据页面。
+ *
+ * 表中有事务字段(MVCC)时，仍然要知道记录对当前事务是否可见：此时在数据页面中原地检查事务字段和NULL位图，
+ * 不复制记录也不构造完整的元组。没有事务字段时索引中的数据都是可见的，完全不访问数据页面。
+ * NULL 值在索引中保存的是随机值，索引字段上的等值查找不会命中 NULL，所以不访问数据页面时认为索引字段都不是 NULL。
+ */
+class IndexOnlyScanPhysicalOperator : public PhysicalOperator
+{
+public:
+  IndexOnlyScanPhysicalOperator(Table *table, Index *index,
+                                const std::vector<Value> *left_values, bool left_inclusive,
+                                const std::vector<Value> *right_values, bool right_inclusive);
+
+  ~IndexOnlyScanPhysicalOperator() override = default;
+
+  PhysicalOperatorType type() const override
+  {
+    return PhysicalOperatorType::INDEX_ONLY_SCAN;
+  }
+
+  void set_table_alias(const std::string &alias)
+  {
+    table_alias_ = alias;
+  }
+
+  RC open(Trx *trx) override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override;
+
+  std::string param() const override;
+
+  void set_predicates(std::vector<std::unique_ptr<Expression>> &&predicates)
+  {
+    predicates_ = std::move(predicates);
+  }
+
+private:
+  RC check_heap(const RID &rid, bool &visible);
+  RC filter(RowTuple &tuple, bool &result);
+
+private:
+  Table *table_ = nullptr;
+  std::string table_alias_;
+  Index *index_ = nullptr;
+  IndexScanner *index_scanner_ = nullptr;
+  Trx *trx_ = nullptr;
+  bool check_heap_ = false;  // 表中有事务字段，需要检查记录是否可见
+
+  std::vector<const FieldMeta *> index_fields_;  // 索引字段在记录中的位置，与键中的顺序相同
+  std::vector<char> record_data_;
+  Record current_record_;
+  RowTuple tuple_;
+
+  std::vector<Value> left_values_;
+  std::vector<Value> right_values_;
+  bool left_inclusive_ = false;
+  bool right_inclusive_ = false;
+  bool left_null_ = true;
+  bool right_null_ = true;
+  std::vector<std::unique_ptr<Expression>> predicates_;
+};
@@ -1,11 +1,36 @@
 #pragma once
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "physical_operator.h"
+#include "include/query_engine/structor/spill_file.h"
 #include "include/query_engine/structor/tuple/join_tuple.h"
+#include "include/query_engine/structor/tuple/tuple_codec.h"
 
-// TODO [Lab3] join算子的头文件定义，根据需要添加对应的变量和方法
+/**
+ * @brief 连接算子
+ * @ingroup PhysicalOperator
+ * @details 连接条件中有左右两边字段相等的条件时使用哈希连接，否则使用嵌套循环连接。
+ *
+ * 哈希连接用左孩子构建哈希表，流式读取右孩子探测。构建时按照连接键的哈希值把数据分到 PARTITION_NUM 个分区，
+ * 内存中的数据超过 memory_limit 时，把最大的分区写到临时文件中(hybrid hash join)。
+ * 探测时落在内存分区的行直接输出结果，落在溢出分区的行也写到这个分区的临时文件中，
+ * 右孩子读完以后再逐个处理溢出的分区(grace hash join)。
+ * 如果某个溢出分区仍然放不进内存，用下一层的哈希种子重新分区，最多 MAX_PARTITION_LEVEL 层，
+ * 超过以后(例如大量相同的连接键)不再分区，直接在内存中处理。
+ *
+ * 哈希表只保证连接键的编码相同，输出之前仍然用完整的连接条件检查一遍。
+ */
 class JoinPhysicalOperator : public PhysicalOperator
 {
+public:
+  static constexpr int    PARTITION_NUM = 16;
+  static constexpr int    MAX_PARTITION_LEVEL = 4;
+  static constexpr size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
 public:
   JoinPhysicalOperator();
   ~JoinPhysicalOperator() override = default;
@@ -25,38 +50,91 @@ public:
     condition_ = std::move(condition);
   }
 
+  /**
+   * @brief 允许使用哈希连接，open 时找不到等值连接的字段仍然使用嵌套循环连接
+   */
   void enable_hash_join()
   {
     use_hash_join_ = true;
   }
+
+  /**
+   * @brief 哈希连接在内存中最多缓存多少字节的数据
+   */
+  static size_t memory_limit();
+
 private:
-  RC get_join_keys();
-  RC build_hash_table();
-  RC get_value_from_tuple(Tuple* tuple, const std::string& table_name, const std::string& field_name, Value& value);
+  /**
+   * @brief 内存中的哈希表，rows 中每行是 | key_len | key | 左孩子的记录 |
+   */
+  struct HashTable
+  {
+    std::vector<std::string>                              rows;
+    std::unordered_map<std::string, std::vector<size_t>> index;
+    size_t                                                memory = 0;
+  };
+
+  /**
+   * @brief 哈希连接的一个分区，溢出以后 build_file 不为空，之后属于这个分区的行都写到临时文件中
+   */
+  struct Partition
+  {
+    int                        level = 0;
+    HashTable                  table;
+    std::unique_ptr<SpillFile> build_file;
+    std::unique_ptr<SpillFile> probe_file;
+
+    bool spilled() const { return build_file != nullptr; }
+  };
+
+  RC nested_loop_next();
+  RC hash_join_next();
+
+  void resolve_join_keys();
+  bool add_join_key(Expression *left, Expression *right);
+  RC   make_join_key(const Tuple &tuple, const std::vector<int> &indexes, std::string &key, bool &has_null) const;
+  RC   check_condition(bool &matched);
+
+  RC build();
+  RC spill_largest_partition();
+  RC next_probe_row();
+  RC next_spilled_probe_row();
+  RC process_partition(std::unique_ptr<Partition> partition);
+  RC repartition(Partition &partition);
+
+  static int  partition_of(const std::string &key, int level);
+  static void add_row(HashTable &table, std::string &&row);
+  static void build_index(HashTable &table);
 
 private:
   Trx *trx_ = nullptr;
   JoinedTuple joined_tuple_;  // 当前关联的左右两个tuple
   std::unique_ptr<Expression> condition_;  // 连接条件
-  
+
   bool started_ = false;  // 是否开始执行
   bool left_ready_ = false;  // 左表是否已经遍历完
 
-  // Hash Join
-  bool use_hash_join_ = false;          // 是否使用哈希连接
-  bool hash_table_built_ = false;       // 哈希表是否已建立
-  std::string left_key_field_;          // 左表连接键字段
-  std::string right_key_field_;         // 右表连接键字段
-  std::string left_table_name_;          // 左表名称
-  std::string right_table_name_;         // 右表名称
+  // 连接键在左右孩子元组中的下标，open 时确定
+  bool use_hash_join_ = false;
+  std::vector<int> left_key_indexes_;
+  std::vector<int> right_key_indexes_;
+
+  Tuple *left_tuple_ = nullptr;
+  Tuple *right_tuple_ = nullptr;
 
-  // Hash: 键是连接键值，值是匹配该键的左表元组集合
-  std::unordered_map<std::string, std::vector<Tuple*>> hash_table_;
+  // 哈希连接的执行状态
+  bool                                    built_ = false;
+  bool                                    probe_child_done_ = false;
+  size_t                                  memory_ = 0;  // 内存分区占用的字节数
+  std::vector<std::unique_ptr<Partition>> partitions_;
+  std::vector<std::unique_ptr<Partition>> pending_;            // 等待处理的溢出分区
+  std::unique_ptr<Partition>              current_partition_;  // 正在从临时文件探测的分区
 
-  // 当前处理状态
-  Tuple* current_right_tuple_ = nullptr;                // 当前右表元组
-  std::vector<Tuple*>::iterator current_matches_iter_;  // 当前匹配集合迭代器
-  std::vector<Tuple*>::iterator current_matches_end_;   // 当前匹配集合结束位置
-  bool has_current_matches_ = false;                   // 是否有当前匹配
+  const HashTable           *current_table_ = nullptr;
+  const std::vector<size_t> *matches_ = nullptr;  // 当前探测行匹配的行
+  size_t                     match_pos_ = 0;
 
+  std::string     probe_row_;
+  RestoredRecords left_records_;
+  RestoredRecords right_records_;
 };
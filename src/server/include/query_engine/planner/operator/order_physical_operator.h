@@ -3,6 +3,8 @@
 #include <memory>
 #include "physical_operator.h"
 #include "include/query_engine/structor/expression/expression.h"
+#include "include/query_engine/structor/external_sorter.h"
+#include "include/query_engine/structor/tuple/tuple_codec.h"
 #include "include/query_engine/analyzer/statement/orderby_stmt.h"
 
 class OrderByStmt;
@@ -10,11 +12,14 @@ class OrderByStmt;
 /**
  * @brief 排序物理算子
  * @ingroup PhysicalOperator
+ * @details 每一行的排序值编码成可以直接用 memcmp 比较的二进制串，下层算子产生的记录作为负载，
+ * 交给 ExternalSorter 排序，内存不够时会写到临时文件中。输出时把记录还原回下层算子的元组。
+ * limit 不小于0时只需要前 limit 行，使用堆来做 top-k。
  */
 class OrderPhysicalOperator : public PhysicalOperator
 {
 public:
-  OrderPhysicalOperator(std::vector<OrderByUnit *> order_units);
+  OrderPhysicalOperator(std::vector<OrderByUnit *> order_units, int64_t limit = -1);
 
   virtual ~OrderPhysicalOperator() = default;
 
@@ -28,13 +33,19 @@ public:
   RC close() override;
 
   Tuple *current_tuple() override;
+  /**
+   * @brief 排序时内存中最多缓存多少字节，超过以后写到临时文件中
+   */
+  static size_t memory_limit();
+
 private:
   RC sort_table();
+  RC make_sort_key(Tuple &tuple, std::string &key);
 
 private:
   std::vector<OrderByUnit *> order_units_;
+  int64_t limit_;
   bool is_init_ = true;
-  std::vector<std::vector<Record *>> st_;  // sort table
-  std::vector<int> st_idx_;
-  std::vector<int>::iterator it_;
+  std::unique_ptr<ExternalSorter> sorter_;
+  RestoredRecords restored_records_;  // 当前输出的一行对应的记录
 };
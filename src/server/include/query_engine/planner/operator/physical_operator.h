@@ -10,6 +10,7 @@
 class Record;
 class TupleCellSpec;
 class Trx;
+class Chunk;
 
 enum class PhysicalOperatorType
 {
@@ -24,9 +25,11 @@ enum class PhysicalOperatorType
 
   AGGREGATION,
   INDEX_SCAN,
+  INDEX_ONLY_SCAN,
   GROUP_BY,
   ORDER_BY,
   JOIN,
+  GATHER,
 };
 
 class PhysicalOperator
@@ -51,6 +54,19 @@ public:
 
   virtual Tuple *current_tuple() = 0;
 
+  /**
+   * @brief 当前算子及其子算子是否都支持向量化执行
+   * @details 支持时可以用 next_batch 代替 next/current_tuple 逐行获取数据
+   */
+  virtual bool support_batch() const { return false; }
+
+  /**
+   * @brief 获取下一批数据
+   * @details 与 next 二选一使用。chunk 在多次调用之间复用，第一次调用时由最底层产生数据的算子设置列定义。
+   * 返回 RC::SUCCESS 时 chunk 中至少有一行被选中，没有数据时返回 RC::RECORD_EOF
+   */
+  virtual RC next_batch(Chunk &chunk) { return RC::UNIMPLENMENT; }
+
   void add_child(std::unique_ptr<PhysicalOperator> oper) {
     children_.emplace_back(std::move(oper));
   }
@@ -36,6 +36,7 @@ private:
   RC create_plan(PredicateLogicalNode &logical_oper, std::unique_ptr<PhysicalOperator> &oper, bool is_delete = false);
   RC create_plan(ProjectLogicalNode &logical_oper, std::unique_ptr<PhysicalOperator> &oper, bool is_delete = false);
   RC create_plan(AggrLogicalNode &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
+  RC create_plan(GroupByLogicalNode &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(OrderByLogicalNode &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(InsertLogicalNode &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(DeleteLogicalNode &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
@@ -24,6 +24,12 @@ public:
 
   Tuple *current_tuple() override;
 
+  /**
+   * @brief 相关子查询需要与外层元组一起求值，只能逐行执行
+   */
+  bool support_batch() const override { return father_tuple_ == nullptr && children_[0]->support_batch(); }
+  RC next_batch(Chunk &chunk) override;
+
 private:
   std::unique_ptr<Expression> expression_;
 };
@@ -5,6 +5,7 @@
 #include "physical_operator.h"
 #include "include/query_engine/planner/node/project_logical_node.h"
 #include "include/query_engine/structor/tuple/project_tuple.h"
+#include "include/query_engine/structor/chunk.h"
 
 /**
  * @brief 选择/投影物理算子
@@ -42,6 +43,12 @@ public:
 
   Tuple *current_tuple() override;
 
+  /**
+   * @brief 投影的都是字段，或者是数值类型的表达式时支持向量化执行
+   */
+  bool support_batch() const override;
+  RC next_batch(Chunk &chunk) override;
+
   ProjectPhysicalOperator *copy() {
     auto *res_oper = new ProjectPhysicalOperator(expressions_);
     res_oper->add_child(std::move(children_[0]));
@@ -54,4 +61,7 @@ public:
 private:
   ProjectTuple tuple_;
   std::vector<std::unique_ptr<Expression>> expressions_;
+
+  Chunk child_chunk_;  // 向量化执行时子算子的输出
+  std::vector<int> field_columns_;  // 投影的字段在 child_chunk_ 中的列，不是字段的表达式为-1
 };
@@ -2,6 +2,7 @@
 
 #include "physical_operator.h"
 #include "include/storage_engine/recorder/record_manager.h"
+#include "include/storage_engine/recorder/condition_filter.h"
 #include "include/common/rc.h"
 #include "include/query_engine/structor/tuple/row_tuple.h"
 
@@ -33,18 +34,56 @@ public:
 
   Tuple *current_tuple() override;
 
+  bool support_batch() const override;
+  RC next_batch(Chunk &chunk) override;
+
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 与其它扫描算子共享页面范围分配器，只扫描从中领取到的页面
+   */
+  void set_page_ranges(PageRangeDispenser *page_ranges) { page_ranges_ = page_ranges; }
+
+  /**
+   * @brief 创建一个扫描同一张表、使用相同过滤条件的算子，并行扫描时每个线程使用一个
+   */
+  std::unique_ptr<TableScanPhysicalOperator> copy() const;
+
+  Table *table() const { return table_; }
+
+  /**
+   * @brief 不逐条扫描，直接用每个页面的记录个数得到扫描结果的行数
+   * @details 有过滤条件或者需要检查事务可见性时返回 RC::UNIMPLENMENT，调用者仍然要逐条扫描
+   */
+  RC count_records(int64_t &count);
+
 private:
   RC filter(RowTuple &tuple, bool &result);
 
+  /**
+   * @brief 把 字段 op 常量 形式的过滤条件交给记录扫描器，直接在页面上批量过滤
+   * @details 只处理 INTS/DATES/FLOATS 字段与同类型的非null常量比较，其它条件仍然逐行计算
+   */
+  void init_condition_filter();
+
+  /**
+   * @brief 把当前记录的各个字段追加到 chunk 的各列中
+   */
+  void append_record(Chunk &chunk);
+
 private:
   Table *                                  table_ = nullptr;
   std::string                              table_alias_;
   Trx *                                    trx_ = nullptr;
   bool                                     readonly_ = false;
+  PageRangeDispenser *                     page_ranges_ = nullptr;
   RecordFileScanner                        record_scanner_;
   Record                                   current_record_;
   RowTuple                                 tuple_;
   std::vector<std::unique_ptr<Expression>> predicates_; // TODO chang predicate to table tuple filter
+
+  std::vector<std::unique_ptr<DefaultConditionFilter>> page_filters_;        // 交给记录扫描器的条件
+  std::vector<const ConditionFilter *>                 page_filter_ptrs_;
+  CompositeConditionFilter                             condition_filter_;
+  std::vector<Expression *>                            residual_predicates_;  // 需要逐行计算的条件
 };
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "include/query_engine/parser/value.h"
+
+/**
+ * @brief 一批数据中的一列
+ * @ingroup Tuple
+ * @details 按照字段在记录中的格式定长存储，INTS/DATES是int32_t，FLOATS是float，CHARS/TEXTS按字段长度存储。
+ * 这样从记录中取数据时只需要memcpy，数值类型的列可以直接当作数组做紧凑的循环。
+ * 列通过表名、字段名和表别名来标识，与 TupleCellSpec 的查找方式一致。
+ */
+class Column
+{
+public:
+  Column(AttrType attr_type, int attr_len, int capacity);
+  ~Column() = default;
+
+  void set_name(const char *table_name, const char *field_name, const char *table_alias);
+  bool match(const char *table_name, const char *field_name, const char *table_alias) const;
+
+  AttrType attr_type() const { return attr_type_; }
+  int      attr_len() const { return attr_len_; }
+  int      count() const { return count_; }
+
+  const char *data_at(int row) const { return data_.data() + static_cast<size_t>(row) * attr_len_; }
+  bool        is_null(int row) const { return nulls_[row] != 0; }
+
+  /**
+   * @brief 把列数据当作数组访问，只能用于定长的数值类型
+   */
+  template <typename T>
+  const T *values() const
+  {
+    return reinterpret_cast<const T *>(data_.data());
+  }
+
+  void clear() { count_ = 0; }
+
+  /**
+   * @brief 追加一行，data 的长度就是 attr_len
+   */
+  void append(const char *data, bool is_null);
+  void append_value(const Value &value);
+
+  /**
+   * @brief 追加另一列中的某一行，两列的类型和长度要相同
+   */
+  void append_from(const Column &other, int row) { append(other.data_at(row), other.is_null(row)); }
+
+  void get_value(int row, Value &value) const;
+
+  const std::string &table_name() const { return table_name_; }
+  const std::string &field_name() const { return field_name_; }
+  const std::string &table_alias() const { return table_alias_; }
+
+private:
+  AttrType          attr_type_ = UNDEFINED;
+  int               attr_len_  = 0;
+  int               count_     = 0;
+  std::vector<char> data_;
+  std::vector<char> nulls_;
+
+  std::string table_name_;
+  std::string field_name_;
+  std::string table_alias_;
+};
+
+/**
+ * @brief 一批数据，向量化执行时在算子之间传递
+ * @ingroup Tuple
+ * @details 按列存储若干行，另外有一个选择向量记录哪些行是有效的。
+ * 过滤时只需要缩小选择向量，不需要移动列数据。
+ * 同一个 Chunk 会在多次 next_batch 调用之间复用，列定义在第一次使用时由产生数据的算子设置。
+ */
+class Chunk
+{
+public:
+  static constexpr int DEFAULT_CAPACITY = 1024;  // 默认一批最多多少行
+
+public:
+  explicit Chunk(int capacity = DEFAULT_CAPACITY) : capacity_(capacity) {}
+  ~Chunk() = default;
+
+  int capacity() const { return capacity_; }
+
+  Column &add_column(AttrType attr_type, int attr_len);
+  int     column_num() const { return static_cast<int>(columns_.size()); }
+  Column &column(int index) { return *columns_[index]; }
+  const Column &column(int index) const { return *columns_[index]; }
+
+  /**
+   * @brief 查找列，找不到时返回-1
+   */
+  int find_column(const char *table_name, const char *field_name, const char *table_alias) const;
+
+  /**
+   * @brief 清空数据，保留列定义
+   */
+  void reset();
+
+  /**
+   * @brief 行数，包括没有被选中的行
+   */
+  int  row_num() const { return columns_.empty() ? 0 : columns_[0]->count(); }
+  bool full() const { return row_num() >= capacity_; }
+
+  /**
+   * @brief 选中所有行，产生数据的算子填充完数据后调用
+   */
+  void select_all();
+
+  std::vector<int>       &selection() { return selection_; }
+  const std::vector<int> &selection() const { return selection_; }
+  int                     select_num() const { return static_cast<int>(selection_.size()); }
+
+private:
+  int                                  capacity_;
+  std::vector<std::unique_ptr<Column>> columns_;
+  std::vector<int>                     selection_;  // 选择向量，有效行的下标，保持递增
+};
@@ -18,6 +18,11 @@ public:
 
   RC get_value(const Tuple &tuple, Value &value) const override;
 
+  /**
+   * @brief 字段与常量比较，并且字段是INTS/DATES/FLOATS类型时，直接在列上做比较
+   */
+  RC filter(Chunk &chunk) const override;
+
   AttrType value_type() const override { return BOOLEANS; }
 
   CompOp comp() const { return comp_; }
@@ -41,6 +46,8 @@ public:
 
   RC set_trx(Trx *trx) const;
 
+  void getFields(std::vector<Field *> &query_fields) const override;
+
   ComparisonExpr* copy() const override {
     ComparisonExpr *res = new ComparisonExpr(comp_, static_cast<std::unique_ptr<Expression>>(left_->copy()),
         static_cast<std::unique_ptr<Expression>>(right_->copy()));
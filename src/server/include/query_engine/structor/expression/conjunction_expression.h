@@ -17,12 +17,19 @@ public:
 
   RC get_value(const Tuple &tuple, Value &value) const override;
 
+  /**
+   * @brief AND 依次用每个子表达式过滤，OR 逐行求值
+   */
+  RC filter(Chunk &chunk) const override;
+
   ConjunctionType conjunction_type() const { return conjunction_type_; }
 
   std::vector<std::unique_ptr<Expression>> &children() { return children_; }
 
   RC set_trx(Trx *trx) const;
 
+  void getFields(std::vector<Field *> &query_fields) const override;
+
   ConjunctionExpr* copy() const override {
     std::vector<std::unique_ptr<Expression>> children;
     for (auto &child : children_) {
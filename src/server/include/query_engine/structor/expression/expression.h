@@ -10,6 +10,7 @@
 #include "common/log/log.h"
 
 class Tuple;
+class Chunk;
 class SelectStmt;
 class ProjectLogicalNode;
 class ProjectPhysicalOperator;
@@ -60,6 +61,13 @@ public:
    */
   virtual RC get_value(const Tuple &tuple, Value &value) const = 0;
 
+  /**
+   * @brief 对一批数据求值，只保留表达式的值为true的行
+   * @details 向量化执行时使用，结果体现在 chunk 的选择向量上。
+   * 默认实现逐行调用 get_value，比较表达式和联结表达式有批量的实现
+   */
+  virtual RC filter(Chunk &chunk) const;
+
   /**
    * @brief 在没有实际运行的情况下，也就是无法获取tuple的情况下，尝试获取表达式的值
    * @details 有些表达式的值是固定的，比如ValueExpr，这种情况下可以直接获取值
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "include/common/rc.h"
+
+/**
+ * @brief 外部排序
+ * @ingroup Tuple
+ * @details 每一行由排序键和负载两部分组成，排序键是规范化的二进制串，直接用 memcmp 比较，
+ * 负载是排序后需要还原的数据，排序时不关心它的内容。
+ *
+ * 内存中缓存的数据超过 memory_limit 时，先把这部分数据排好序写到临时文件中，称为一个有序段(run)。
+ * 所有数据添加完以后，如果没有产生有序段就直接在内存中排序，否则使用败者树对所有有序段做多路归并。
+ * 排序是稳定的：排序键相同的行按照添加的顺序输出。
+ *
+ * 如果只需要最小的前 limit 行，在内存中维护一个最多 limit 行的大顶堆，每行只需要与堆顶比较一次，
+ * 只有当堆占用的内存超过限制时才退回到外部排序。
+ */
+class ExternalSorter
+{
+public:
+  static constexpr size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+public:
+  /**
+   * @param memory_limit 内存中最多缓存多少字节的数据
+   * @param limit        只输出排序后的前 limit 行，小于0表示输出所有行
+   */
+  explicit ExternalSorter(size_t memory_limit = DEFAULT_MEMORY_LIMIT, int64_t limit = -1);
+  ~ExternalSorter();
+
+  /**
+   * @brief 添加一行数据，必须在 finish 之前调用
+   */
+  RC add(const std::string &key, const std::string &payload);
+
+  /**
+   * @brief 数据添加完毕，准备输出排序结果
+   */
+  RC finish();
+
+  /**
+   * @brief 按顺序获取下一行，没有数据时返回 RC::RECORD_EOF
+   * @details 返回的指针在下一次调用 next 之前有效
+   */
+  RC next(const char *&payload, int &payload_len);
+
+  /**
+   * @brief 写到临时文件中的有序段的个数
+   */
+  int run_num() const { return static_cast<int>(runs_.size()); }
+
+private:
+  /**
+   * @brief 内存中的一行，数据在 buffer_ 中依次存放排序键和负载
+   */
+  struct RowRef
+  {
+    size_t offset;
+    int    key_len;
+    int    payload_len;
+  };
+
+  /**
+   * @brief 堆中的一行，seq 是添加的顺序，排序键相同时用来保证稳定
+   */
+  struct HeapRow
+  {
+    std::string key;
+    std::string payload;
+    int64_t     seq;
+  };
+
+  class SortRun;
+
+  void append_row(const char *key, int key_len, const char *payload, int payload_len);
+  void sort_rows();
+  RC   spill();
+  RC   switch_from_heap();
+
+  bool heap_less(const HeapRow &a, const HeapRow &b) const;
+  bool run_less(int a, int b) const;
+  void adjust(int run);
+
+private:
+  size_t  memory_limit_;
+  int64_t limit_;
+  int64_t output_num_ = 0;
+  bool    finished_ = false;
+
+  // 小于 limit 行时使用的大顶堆
+  bool                 use_heap_ = false;
+  std::vector<HeapRow> heap_;
+  size_t               heap_memory_ = 0;
+  int64_t              seq_ = 0;
+
+  // 内存中还没有写出的数据
+  std::vector<char>   buffer_;
+  std::vector<RowRef> rows_;
+  size_t              read_pos_ = 0;  // 没有产生有序段时，输出到了第几行
+
+  // 写到临时文件中的有序段与归并使用的败者树，tree_[0] 是当前最小的有序段，其它节点是败者
+  std::vector<std::unique_ptr<SortRun>> runs_;
+  std::vector<int>                      tree_;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+#include "include/common/rc.h"
+
+/**
+ * @brief 算子内存不够时用来存放中间数据的临时文件
+ * @ingroup Tuple
+ * @details 使用 tmpfile 创建，关闭后自动删除。先顺序写入，调用 rewind 以后再从头顺序读出。
+ * 读写都经过 stdio 的缓存，每次调用的数据量很小也不会有太多的系统调用。
+ */
+class SpillFile
+{
+public:
+  static constexpr int IO_BUFFER_SIZE = 64 * 1024;
+
+public:
+  SpillFile() = default;
+  ~SpillFile();
+
+  SpillFile(const SpillFile &) = delete;
+  SpillFile &operator=(const SpillFile &) = delete;
+
+  RC open();
+
+  RC write(const void *data, size_t len);
+
+  /**
+   * @brief 写完以后回到文件开头，准备读取
+   */
+  RC rewind();
+
+  /**
+   * @brief 读取 len 个字节。已经读到文件末尾时 eof 为 true
+   */
+  RC read(void *data, size_t len, bool &eof);
+
+  /**
+   * @brief 按照 | len | data | 的格式写入或读出一块数据
+   */
+  RC write_block(const std::string &block);
+  RC read_block(std::string &block, bool &eof);
+
+  /**
+   * @brief 已经写入的字节数
+   */
+  size_t size() const { return size_; }
+
+private:
+  FILE  *file_ = nullptr;
+  size_t size_ = 0;
+};
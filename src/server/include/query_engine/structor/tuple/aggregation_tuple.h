@@ -1,6 +1,7 @@
 #pragma once
 
 #include "tuple.h"
+#include "include/storage_engine/recorder/field.h"
 
 
 class AggrTuple : public Tuple
@@ -24,12 +25,18 @@ public:
   }
 
   void set_tuple(std::vector<std::string> &alias, std::vector<Value> &aggr_results) {
-    for (auto &alia : alias) {
-      alias_.emplace_back(alia);
-    }
+    alias_ = alias;
     aggr_results_ = std::move(aggr_results);
   }
 
+  /**
+   * @brief 设置分组列的值，GROUP BY 时投影和 HAVING 中的分组列从这里取值
+   */
+  void set_group(const std::vector<Field> &group_fields, std::vector<Value> &group_values) {
+    group_fields_ = &group_fields;
+    group_values_ = std::move(group_values);
+  }
+
   RC cell_at(int index, Value &cell) const override
   {
     if (index < 0 || index >= static_cast<int>(aggr_results_.size())) {
@@ -40,6 +47,16 @@ public:
   }
 
   RC find_cell(const TupleCellSpec &spec, Value &cell) const override {
+    // 分组列只用表名和字段名匹配，GROUP BY 中的字段不一定带着查询中的表别名
+    if (group_fields_ != nullptr) {
+      for (size_t i = 0; i < group_fields_->size(); i++) {
+        const Field &field = (*group_fields_)[i];
+        if (0 == strcmp(field.table_name(), spec.table_name()) && 0 == strcmp(field.field_name(), spec.field_name())) {
+          cell = group_values_[i];
+          return RC::SUCCESS;
+        }
+      }
+    }
     for (int i = 0; i < alias_.size(); i++) {
       if (strcmp(alias_[i].c_str(), spec.alias()) == 0 || strcmp(alias_[i].c_str(), spec.field_name()) == 0) {
         cell = aggr_results_[i];
@@ -52,4 +69,6 @@ public:
 private:
   std::vector<std::string> alias_;
   std::vector<Value> aggr_results_;
+  const std::vector<Field> *group_fields_ = nullptr;
+  std::vector<Value> group_values_;
 };
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "tuple.h"
+#include "include/query_engine/structor/chunk.h"
+
+/**
+ * @brief 把 Chunk 中的一行当作元组访问
+ * @ingroup Tuple
+ * @details 向量化执行时，没有批量实现的表达式通过它逐行求值
+ */
+class ChunkTuple : public Tuple
+{
+public:
+  ChunkTuple() = default;
+  virtual ~ChunkTuple() = default;
+
+  const TupleType tuple_type() const override { return ChunkTuple_Type; }
+
+  void set_chunk(const Chunk *chunk) { chunk_ = chunk; }
+  void set_row(int row) { row_ = row; }
+
+  void get_record(std::vector<Record *> &records) const override {}
+  void set_record(std::vector<Record *> &records) override {}
+
+  int cell_num() const override { return chunk_->column_num(); }
+
+  RC cell_at(int index, Value &cell) const override
+  {
+    if (index < 0 || index >= chunk_->column_num()) {
+      LOG_WARN("invalid argument. index=%d", index);
+      return RC::INVALID_ARGUMENT;
+    }
+    chunk_->column(index).get_value(row_, cell);
+    return RC::SUCCESS;
+  }
+
+  RC find_cell(const TupleCellSpec &spec, Value &cell) const override
+  {
+    int index = chunk_->find_column(spec.table_name(), spec.field_name(), spec.alias());
+    if (index < 0) {
+      return RC::NOTFOUND;
+    }
+    chunk_->column(index).get_value(row_, cell);
+    return RC::SUCCESS;
+  }
+
+private:
+  const Chunk *chunk_ = nullptr;
+  int          row_   = 0;
+};
@@ -58,13 +58,27 @@ public:
   RC find_cell(const TupleCellSpec &spec, Value &value) const override
   {
     RC rc = left_->find_cell(spec, value);
-    if (rc == RC::SUCCESS || rc != RC::NOTFOUND) {
+    if (rc != RC::NOTFOUND) {
       return rc;
     }
 
     return right_->find_cell(spec, value);
   }
 
+  RC find_cell_index(const TupleCellSpec &spec, int &index) const override
+  {
+    RC rc = left_->find_cell_index(spec, index);
+    if (rc != RC::NOTFOUND) {
+      return rc;
+    }
+
+    rc = right_->find_cell_index(spec, index);
+    if (rc == RC::SUCCESS) {
+      index += left_->cell_num();
+    }
+    return rc;
+  }
+
 private:
   Tuple *left_ = nullptr;
   Tuple *right_ = nullptr;
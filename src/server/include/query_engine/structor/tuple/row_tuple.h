@@ -49,6 +49,7 @@ void _clear_species(){
    table_alias_ = table_alias;
    this->species_.reserve(fields->size());
    _clear_species(); //reopen时防止sepcies_就会积累多套重复的fields。
+   text_record_data_ = nullptr;
    for (const FieldMeta &field : *fields) {
      species_.push_back(new FieldExpr(table, &field));
      species_[species_.size() - 1]->set_field_table_alias(table_alias);
@@ -80,12 +81,30 @@ void _clear_species(){
      cell.set_null();
    } else {
      const FieldMeta *field_meta = field_expr->field().meta();
+     if (field_meta->type() == TEXTS) {
+       return text_cell_at(index, *field_meta, cell);
+     }
      cell.set_type(field_meta->type());
      cell.set_data(this->record_->data() + field_meta->offset(), field_meta->len());
    }
    return RC::SUCCESS;
  }
 
+ RC find_cell_index(const TupleCellSpec &spec, int &index) const override
+ {
+   if (0 != strcmp(spec.table_name(), table_->name()) || spec.alias() != table_alias_) {
+     return RC::NOTFOUND;
+   }
+
+   for (size_t i = 0; i < species_.size(); ++i) {
+     if (0 == strcmp(spec.field_name(), species_[i]->field().field_name())) {
+       index = static_cast<int>(i);
+       return RC::SUCCESS;
+     }
+   }
+   return RC::NOTFOUND;
+ }
+
  RC find_cell(const TupleCellSpec &spec, Value &cell) const override
  {
    const char *table_name = spec.table_name();
@@ -114,6 +133,31 @@ void _clear_species(){
    return *record_;
  }
 
+private:
+ /**
+  * @brief 读取 TEXTS 字段
+  * @details 记录中只有文本的位置，长文本在TOAST文件中。只有真正用到的时候才去读取，
+  * 同一条记录上读过的文本缓存下来，过滤和投影多次访问时不会重复读取TOAST文件
+  */
+ RC text_cell_at(int index, const FieldMeta &field_meta, Value &cell) const
+ {
+   if (text_record_data_ != record_->data() || text_rid_ != record_->rid()) {
+     text_record_data_ = record_->data();
+     text_rid_ = record_->rid();
+     text_cached_.assign(species_.size(), false);
+     text_cells_.resize(species_.size());
+   }
+   if (!text_cached_[index]) {
+     RC rc = table_->get_text(*record_, field_meta, text_cells_[index]);
+     if (rc != RC::SUCCESS) {
+       return rc;
+     }
+     text_cached_[index] = true;
+   }
+   cell = text_cells_[index];
+   return RC::SUCCESS;
+ }
+
 private:
  Record *record_ = nullptr;
  common::Bitmap bitmap_;
@@ -121,4 +165,10 @@ private:
  std::string table_alias_;
  std::vector<FieldExpr *> species_;
  bool order_set_ = false;
+
+ // 当前记录上已经读过的文本
+ mutable const char *text_record_data_ = nullptr;
+ mutable RID text_rid_;
+ mutable std::vector<bool> text_cached_;
+ mutable std::vector<Value> text_cells_;
 };
@@ -38,6 +38,7 @@ enum TupleType
   AggrTuple_Type,
   ValueListTuple_Type,
   JoinedTuple_Type,
+  ChunkTuple_Type,
 };
 
 /**
@@ -100,6 +101,15 @@ public:
    */
   virtual RC find_cell(const TupleCellSpec &spec, Value &cell) const = 0;
 
+  /**
+   * @brief Get the index of specified cell, so that it can be accessed by cell_at
+   * without looking up the name for every tuple
+   */
+  virtual RC find_cell_index(const TupleCellSpec &spec, int &index) const
+  {
+    return RC::UNIMPLENMENT;
+  }
+
   /**
    * @brief get Record
    */
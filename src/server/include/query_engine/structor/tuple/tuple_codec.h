@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "tuple.h"
+
+/**
+ * @brief 把一个值编码后追加到 key 中，编码后的二进制串可以直接用 memcmp 比较大小或者判断相等
+ * @ingroup Tuple
+ * @details null 比所有的值都小。INTS 和 FLOATS 都转成 double 编码，这样两种类型之间也可以比较，
+ * 但是不再像 Value::compare 一样把差值在EPSILON以内的浮点数当作相等。
+ * 字符串中的'\0'转义成"\0\xFF"，以"\0\0"结尾，这样是另一个字符串前缀的字符串更小。
+ * 降序时把这个值的编码按位取反。
+ */
+void append_value_key(const Value &value, bool asc, std::string &key);
+
+/**
+ * @brief 把元组当前对应的所有记录序列化后追加到 data 中
+ * @ingroup Tuple
+ * @details 每条记录的格式是 | page_num | slot_num | len | data |。
+ * 排序、哈希连接等算子需要把下层算子的数据缓存起来或者写到临时文件时使用，
+ * 之后通过 RestoredRecords 还原到同一个元组中
+ */
+void append_tuple_records(const Tuple &tuple, std::string &data);
+
+/**
+ * @brief 从 append_tuple_records 序列化的数据中还原记录，并设置到元组中
+ * @ingroup Tuple
+ * @details 记录的数据复制到自己管理的内存中，在下一次调用 restore 之前一直有效
+ */
+class RestoredRecords
+{
+public:
+  void restore(const char *data, int len, Tuple &tuple);
+
+private:
+  std::vector<Record>            records_;
+  std::vector<std::vector<char>> buffers_;
+  std::vector<Record *>          record_ptrs_;
+};
@@ -28,6 +28,7 @@
 #include "session_request.h"
 #include "session.h"
 #include "communicator.h"
+#include "worker_pool.h"
 
 class Communicator;
 class QueryEngine;
@@ -37,6 +38,7 @@ class QueryEngine;
  * @ingroup Communicator
  * @details 当前支持网络连接，有TCP和Unix Socket两种方式。通过命令行参数来指定使用哪种方式。
  * 启动后监听端口或unix socket，使用libevent来监听事件，当有新的连接到达时，创建一个Communicator对象进行处理。
+ * 连接上有新的消息时，事件线程把连接交给工作线程池去读取和执行请求，见 WorkerPool。
  */
 class Server 
 {
@@ -64,12 +66,19 @@ private:
   /**
    * @brief 接收到客户端消息时，调用此函数创建任务
    * @details 此函数作为libevent中客户端套接字对应的回调函数。当有新的消息到达时，调用此函数创建任务。
+   * 连接会先从事件循环中摘除，再交给工作线程处理，请求处理完成后才会重新监听这个连接。
    * @param fd libevent回调函数传入的参数，即客户端套接字
    * @param ev 本次触发的事件，通常是EV_READ
    * @param arg 在注册libevent回调函数时，传入的参数，即Communicator对象
    */
   static void recv(int fd, short ev, void *arg);
 
+  /**
+   * @brief 在工作线程中读取并处理一个连接上的请求
+   * @param comm 有新消息到达的连接
+   */
+  static void process(Communicator *comm);
+
 private:
   /**
    * @brief 将socket描述符设置为非阻塞模式
@@ -107,4 +116,5 @@ private:
   CommunicatorFactory communicator_factory_; ///< 通过这个对象创建新的Communicator对象
 
   static QueryEngine query_engine_;  ///< 通过这个对象处理查询请求
+  static WorkerPool worker_pool_;    ///< 处理请求的工作线程
 };
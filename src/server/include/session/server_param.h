@@ -32,4 +32,6 @@ public:
   bool use_unix_socket = false;
 
   CommunicateProtocol protocol; ///< 通讯协议，目前支持文本协议和mysql协议
+
+  int worker_thread_num = 1; ///< 处理请求的工作线程个数
 };
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Communicator;
+
+/**
+ * @brief 处理客户端请求的工作线程池
+ * @ingroup Communicator
+ * @details 原来所有请求都在libevent的事件循环线程中处理，一个慢查询会阻塞所有的连接。
+ * 现在事件线程只负责发现哪个连接上有新的消息，然后把连接交给工作线程去读取并执行请求。
+ * 连接在交给工作线程之前会先从事件循环中摘除，处理完一个请求后再重新加入，
+ * 所以同一个会话同时最多只有一个请求在执行，保证了会话内请求的顺序。
+ *
+ * 每个工作线程持有一个 ThreadData，处理请求期间会设置当前线程的会话。
+ */
+class WorkerPool
+{
+public:
+  using Handler = std::function<void(Communicator *)>;
+
+public:
+  WorkerPool() = default;
+  ~WorkerPool();
+
+  /**
+   * @brief 启动工作线程
+   * @param thread_num 线程个数，至少为1
+   * @param handler 处理一个连接上的请求
+   */
+  void start(int thread_num, Handler handler);
+
+  /**
+   * @brief 停止工作线程，会等待正在处理的请求结束，还在排队的连接不再处理
+   */
+  void stop();
+
+  /**
+   * @brief 将一个有消息到达的连接交给工作线程处理
+   */
+  void submit(Communicator *communicator);
+
+  int thread_num() const { return static_cast<int>(threads_.size()); }
+
+private:
+  void run();
+
+private:
+  Handler handler_;
+
+  std::vector<std::thread>  threads_;
+  std::mutex                lock_;
+  std::condition_variable   cond_;
+  std::deque<Communicator *> tasks_;
+  bool                      running_ = false;
+};
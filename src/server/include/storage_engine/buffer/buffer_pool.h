@@ -4,6 +4,8 @@
 #include <fcntl.h>
 #include <cstdio>
 #include <cstdlib>
+#include <functional>
+#include <shared_mutex>
 
 #include "common/lang/bitmap.h"
 #include "common/lang/mutex.h"
@@ -11,6 +13,8 @@
 #include "common/io/io.h"
 #include "include/common/rc.h"
 #include "include/storage_engine/buffer/frame_manager.h"
+#include "include/storage_engine/buffer/page_reader.h"
+#include "include/storage_engine/buffer/page_writer.h"
 
 class BufferPoolManager;
 
@@ -22,6 +26,10 @@ class BufferPoolManager;
 /**
  * @brief BufferPool的实现，负责实际与磁盘交互
  * 每个 FileBufferPool 对象对应一个物理文件
+ * @details 并发控制分成两部分：文件头（页面分配位图）由 hdr_lock_ 保护；
+ * 页面的加载、刷盘、驱逐按照页号哈希到 page_locks_ 的某个分区上加锁，
+ * 访问不同分区页面的线程之间不会互相等待。
+ * 同时需要加两种锁时，先加 hdr_lock_ 再加页面分区锁。
  */
 class FileBufferPool
 {
@@ -45,12 +53,49 @@ public:
    */
   RC unpin_page(Frame *frame);
 
+  /**
+   * @brief 获取页面并加读锁，多个线程可以同时读同一个页面
+   * @details 用 unpin_page_shared 释放
+   */
+  RC get_this_page_shared(PageNum page_num, Frame **frame);
+  /**
+   * @brief 获取页面并加写锁，与其它线程的读写互斥
+   * @details 用 unpin_page_exclusive 释放
+   */
+  RC get_this_page_exclusive(PageNum page_num, Frame **frame);
+  /**
+   * @brief 与 get_this_page_exclusive 相同，但是页面已经被其它线程加锁时不等待，返回 LOCKED_CONCURRENCY_CONFLICT
+   */
+  RC try_get_this_page_exclusive(PageNum page_num, Frame **frame);
+  RC unpin_page_shared(Frame *frame);
+  RC unpin_page_exclusive(Frame *frame);
+
   /**
    * 将dirty frame中的数据刷新到磁盘上
    */
   RC flush_page(Frame &frame);
   RC flush_all_pages();
 
+  /**
+   * @brief 根据页号将缓存中的脏页刷盘，页面不在缓存中或者不是脏页时什么都不做
+   * @param page_num 页号
+   * @param skip_pinned 是否跳过正在被其它线程使用的页面。后台刷盘时跳过，checkpoint时不能跳过
+   * @param written 是否真的写出了页面
+   */
+  RC write_page(PageNum page_num, bool skip_pinned, bool &written);
+
+  /**
+   * @brief 提交预读请求，异步加载从start_page开始的连续page_count个页面
+   */
+  void read_ahead(PageNum start_page, int page_count);
+
+  /**
+   * @brief 批量加载从start_page开始的连续page_count个页面到缓冲池中
+   * @details 已经在缓冲池中的页面和没有分配的页面会被跳过，其余连续的页面用一次preadv读取。
+   * 加载的页面不会被pin住，也不会被当成访问过
+   */
+  RC load_pages(PageNum start_page, int page_count);
+
   /**
    * 驱逐frame
    */
@@ -59,6 +104,11 @@ public:
 
   int file_desc() const;
 
+  /**
+   * @brief 文件中一共有多少个页面，包括文件头页面和已经释放的页面
+   */
+  int page_count() const;
+
   RC recover_page(PageNum page_num);
 
   /**
@@ -68,13 +118,29 @@ public:
   RC dispose_page(PageNum page_num);
 
 protected:
-  RC allocate_frame(PageNum page_num, Frame **buf);
+  /**
+   * @param wait 没有空闲的frame并且驱逐不出来时，是否一直重试
+   */
+  RC allocate_frame(PageNum page_num, Frame **buf, bool wait = true);
+  /**
+   * 从start_page开始，一次读取连续多个页面的数据到frames中。没有读到数据的frame会被释放
+   */
+  RC load_frames(PageNum start_page, std::vector<Frame *> &frames);
   RC flush_page_internal(Frame &frame);
   /**
    * 加载指定页面的数据到内存的Frame中
    */
   RC load_page(PageNum page_num, Frame *frame);
 
+  /**
+   * 获取页面所在分区的锁
+   */
+  common::Mutex &page_lock(PageNum page_num) { return page_locks_[page_num % PAGE_LOCK_PARTITION_NUM]; }
+
+private:
+  static constexpr int PAGE_LOCK_PARTITION_NUM = 64;  // 页面锁的分区个数
+  static constexpr int MAX_LOAD_PAGE_NUM = 32;  // 一次批量加载的最多页面数，不能超过分区个数
+
 private:
   BufferPoolManager &  bp_manager_;
   FrameManager &     frame_manager_;
@@ -85,9 +151,11 @@ private:
   FileHeader *       file_header_ = nullptr;  // 文件头
   std::set<PageNum>    disposed_pages_;  // 已经释放的页面
 
-  common::Mutex        lock_;
+  common::Mutex        hdr_lock_;  // 保护文件头，包括页面分配位图
+  common::Mutex        page_locks_[PAGE_LOCK_PARTITION_NUM];  // 按页号分区的页面锁
 private:
   friend class BufferPoolIterator;
+  friend class BufferPoolManager;
 };
 
 /**
@@ -100,6 +168,11 @@ public:
   ~BufferPoolIterator();
 
   RC init(FileBufferPool &bp, PageNum start_page = 0);
+
+  /**
+   * @brief 只遍历[begin_page, end_page)范围内已经分配的页面
+   */
+  RC init_range(FileBufferPool &bp, PageNum begin_page, PageNum end_page);
   bool has_next();
   PageNum next();
   RC reset();
@@ -107,6 +180,7 @@ public:
 private:
   common::Bitmap bitmap_;
   PageNum current_page_num_ = -1;
+  PageNum end_page_num_ = -1;  // 遍历到这个页面为止(不包含)，-1表示遍历到文件结尾
 };
 
 /**
@@ -122,15 +196,50 @@ public:
   RC open_file(const char *file_name, FileBufferPool *&bp);
   RC close_file(const char *file_name);
 
+  /**
+   * 将被驱逐的frame刷盘。frame已经不能被其它线程访问，所以不需要加页面锁
+   */
   RC flush_page(Frame &frame);
 
+  /**
+   * @brief 将所有打开文件的脏页刷盘，checkpoint时使用
+   */
+  RC flush_all_pages();
+
+  /**
+   * @brief 从最冷的脏页开始刷盘，直到干净页帧的比例达到target_clean_ratio
+   * @details 正在使用的页面会被跳过，所以不保证一定能达到目标
+   * @return 写出了多少个页面
+   */
+  int write_dirty_pages(double target_clean_ratio);
+
+  PageWriter &page_writer() { return page_writer_; }
+  PageReader &page_reader() { return page_reader_; }
+
+  /**
+   * @brief 预读线程调用，加载指定文件的连续多个页面
+   * @details 请求提交之后文件可能已经关闭了，所以要确认这个buffer pool仍然是打开的
+   */
+  RC load_pages(FileBufferPool *bp, PageNum start_page, int page_count);
+
 public:
   static void set_instance(BufferPoolManager *bpm);
   static BufferPoolManager &instance();
 
+private:
+  /**
+   * @brief 拷贝一份当前打开的buffer pool列表，调用者需要持有pools_lock_的读锁，防止buffer pool被删除
+   */
+  std::vector<FileBufferPool *> opened_buffer_pools();
+
 private:
   FrameManager frame_manager_{"BufPool"};
   common::Mutex  lock_;
   std::unordered_map<std::string, FileBufferPool *> buffer_pools_;  // 已经打开的文件
   std::unordered_map<int, FileBufferPool *> fd_buffer_pools_;
+
+  /// 后台刷盘时加读锁，删除buffer pool之前加写锁。不能在持有lock_时加这个锁
+  std::shared_mutex pools_lock_;
+  PageWriter page_writer_{*this};
+  PageReader page_reader_{*this};
 };
@@ -6,6 +6,7 @@
 #include <mutex>
 #include <set>
 #include <atomic>
+#include <thread>
 
 #include "common/log/log.h"
 #include "common/lang/mutex.h"
@@ -51,7 +52,13 @@ public:
    * @brief reinit 和 reset 在 MemPoolSimple 中使用
    * @details 在 MemPoolSimple 分配和释放一个Frame对象时，不会调用构造函数和析构函数 而是调用reinit和reset。
    */
-  void reinit() {}
+  void reinit()
+  {
+    referenced_.store(false);
+    prefetched_.store(false);
+    write_locker_.store(std::thread::id());
+    write_recursive_count_ = 0;
+  }
   void reset() {}
   
   void clear_page()
@@ -75,9 +82,9 @@ public:
    * @brief 标记指定页面为“脏”页。如果修改了页面的内容，则应调用此函数，
    * 以便该页面被淘汰出缓冲区时，系统将新的页面数据写入磁盘文件
    */
-  void mark_dirty() { dirty_ = true; }
-  void clear_dirty() { dirty_ = false; }
-  bool dirty() const { return dirty_; }
+  void mark_dirty() { dirty_.store(true); }
+  void clear_dirty() { dirty_.store(false); }
+  bool dirty() const { return dirty_.load(); }
 
   char *data() { return page_.data; }
 
@@ -101,11 +108,48 @@ public:
 
   int  pin_count() const { return pin_count_.load(); }
 
+  /**
+   * @brief 页帧被再次访问时设置引用标记，供FrameManager的置换策略使用
+   * @details 只修改一个原子变量，不需要加锁，也不会调整任何链表
+   */
+  void mark_referenced() { referenced_.store(true, std::memory_order_relaxed); }
+  void clear_referenced() { referenced_.store(false, std::memory_order_relaxed); }
+  bool referenced() const { return referenced_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 预读的页面还没有被真正访问过
+   * @details 预读加载的页面第一次被访问时，只清除这个标记，不设置引用标记，
+   * 否则顺序扫描会把每个预读的页面都当成访问过两次，提升到保护队列中
+   */
+  void set_prefetched() { prefetched_.store(true, std::memory_order_relaxed); }
+  bool clear_prefetched() { return prefetched_.exchange(false, std::memory_order_relaxed); }
+
+  /**
+   * @brief 页帧内容的读写锁
+   * @details 与pin count无关：pin保证页帧不被淘汰，latch保证读写页面内容时不会互相干扰。
+   * 与其它类型的锁一样，在CONCURRENCY编译模式下才会真正的生效。
+   *
+   * 拿着写锁的线程可以再次加读锁或写锁，只增加计数，比如删除时扫描器已经对页面加了写锁，删除记录时还会再加一次。
+   * 拿着读锁再加写锁会死锁。编译时打开 DEBUG_LATCH 选项后，每次等待页帧锁之前都会检查等待关系，
+   * 发现死锁时打印相关线程持有和等待的页帧，然后退出进程。
+   */
+  void write_latch();
+  bool try_write_latch();
+  void write_unlatch();
+  void read_latch();
+  bool try_read_latch();
+  void read_unlatch();
+
   friend std::string to_string(const Frame &frame);
 
 private:
-  bool              dirty_     = false;
+  std::atomic<bool> dirty_{false};  // 后台刷盘线程会在不加锁的情况下检查脏标记
   std::atomic<int>  pin_count_{0};
+  std::atomic<bool> referenced_{false};
+  std::atomic<bool> prefetched_{false};
+  common::SharedMutex lock_;
+  std::atomic<std::thread::id> write_locker_;  // 持有写锁的线程
+  int               write_recursive_count_ = 0;  // 持有写锁的线程加锁的次数，只有这个线程会访问
   unsigned long     acc_time_  = 0;
   int               file_desc_ = -1;
   Page              page_;
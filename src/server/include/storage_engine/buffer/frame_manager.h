@@ -1,16 +1,29 @@
 #pragma once
 
+#include <functional>
+#include <list>
 #include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
 #include "include/common/rc.h"
 #include "include/storage_engine/buffer/frame.h"
 #include "common/mm/mem_pool.h"
-#include "common/lang/lru_cache.h"
 
 /**
 * @brief 管理页帧Frame
 * @details 管理内存中的页帧。内存是有限的，内存中能够存放的页帧个数也是有限的。
 * 当内存中的页帧不够用时，需要从内存中淘汰一些页帧，以便为新的页帧腾出空间。
 * 这个管理器负责为所有的BufferPool提供页帧管理服务，也就是所有的磁盘文件在访问时都使用这个管理器映射到内存。
+*
+* 页帧按照FrameId的哈希值分布到多个分片(Shard)上，每个分片有自己的读写锁，访问不同分片的线程互不影响。
+* 命中时只加分片的读锁，pin和设置引用标记都是原子操作，不会调整任何链表。
+*
+* 置换策略是简化的2Q：
+* - 新加载的页帧先进入试用队列(probation)，按照FIFO的顺序淘汰；
+* - 在试用队列中被再次访问过的页帧，会被提升到保护队列(protected)，保护队列使用CLOCK算法淘汰；
+* - 试用队列的长度超过限制时优先从试用队列淘汰，否则从保护队列淘汰。
+* 这样一次大的全表扫描只会在试用队列中轮转，不会把B+树内部节点这类热点页面挤出去。
 */
 class FrameManager
 {
@@ -29,7 +42,7 @@ public:
   */
  RC cleanup();
  /**
-  * @brief 分配一个新的页面：先从LRUCache中找，如果找到就直接返回；如果没找到再用Allocator分配。
+  * @brief 分配一个新的页面：先从缓存中找，如果找到就直接返回；如果没找到再用Allocator分配。
   * @param file_desc 文件描述符
   * @param page_num 页面编号
   * @return Frame* 页帧指针
@@ -37,12 +50,13 @@ public:
  Frame *alloc(int file_desc, PageNum page_num);
 
  /**
-  * @brief 从LRUCache中获取指定的页面
+  * @brief 从缓存中获取指定的页面
   * @param file_desc 文件描述符，也可以当做buffer pool文件的标识
   * @param page_num  页面号
+  * @param touch     是否设置引用标记。后台刷盘这类不代表真实访问的操作不应该影响置换策略
   * @return Frame* 页帧指针, 如果没有找到，返回nullptr
   */
- Frame *get(int file_desc, PageNum page_num);
+ Frame *get(int file_desc, PageNum page_num, bool touch = true);
 
  /**
   * 当分配的frame已满时，就尝试驱逐一些pin count=0的frame
@@ -59,15 +73,38 @@ public:
   */
  std::list<Frame *> find_list(int file_desc);
 
- size_t frame_num() const { return frames_.count(); }
+ /**
+  * @brief 列出所有脏页的标识
+  * @details 不会pin页帧，调用者需要重新获取页帧并检查状态。
+  * 每个分片内按照试用队列、保护队列的顺序列出，越靠前的页帧越冷，越应该先刷盘
+  * @param file_desc 只列出指定文件的脏页，小于0时列出所有文件的脏页
+  */
+ std::vector<FrameId> find_dirty_list(int file_desc = -1);
+
+ size_t frame_num() const { return frame_num_.load(); }
+
+ /**
+  * @brief 最多可以容纳多少个页帧
+  */
+ size_t capacity() const { return static_cast<size_t>(allocator_.get_size()); }
 
  RC free(int file_desc, PageNum page_num, Frame *frame);
 
 private:
- Frame *get_internal(const FrameId &frame_id);
- RC free_internal(const FrameId &frame_id, Frame *frame);
+ static constexpr int SHARD_NUM = 16;  // 分片个数
+
+ using FrameList = std::list<Frame *>;
+
+ /**
+  * @brief 缓存中的一个页帧，记录它在哪个队列以及在队列中的位置
+  */
+ struct FrameEntry
+ {
+   Frame              *frame = nullptr;
+   bool                in_protected = false;
+   FrameList::iterator pos;
+ };
 
-private:
  class FrameIdHasher {
  public:
    size_t operator()(const FrameId &frame_id) const
@@ -76,10 +113,40 @@ private:
    }
  };
 
- using FrameLruCache = common::LruCache<FrameId, Frame *, FrameIdHasher>;
+ /**
+  * @brief 一个分片，包含这个分片上所有页帧的索引和两个置换队列
+  */
+ struct Shard
+ {
+   std::shared_mutex lock;  // 查找时加读锁，分配、驱逐、释放时加写锁
+   std::unordered_map<FrameId, FrameEntry, FrameIdHasher> frames;
+   FrameList probation;     // 只被访问过一次的页帧，FIFO
+   FrameList protected_;    // 被多次访问的页帧，CLOCK
+ };
+
+ Shard &shard_of(const FrameId &frame_id) { return shards_[frame_id.hash() % SHARD_NUM]; }
+
+ Frame *get_internal(Shard &shard, const FrameId &frame_id, bool touch = true);
+ RC free_internal(Shard &shard, const FrameId &frame_id, Frame *frame);
+
+ /**
+  * @brief 在一个分片的试用队列或者保护队列上驱逐最多count个页帧
+  * @details 调用时需要加着分片的写锁
+  */
+ int evict_from_probation(Shard &shard, int count, std::function<RC(Frame *frame)> &evict_action);
+ int evict_from_protected(Shard &shard, int count, std::function<RC(Frame *frame)> &evict_action);
+
+ /**
+  * @brief 尝试驱逐一个页帧，成功时从分片中删除并归还给allocator
+  */
+ bool evict_one(Shard &shard, Frame *frame, std::function<RC(Frame *frame)> &evict_action);
+
+private:
  using FrameAllocator = common::MemPoolSimple<Frame>;
 
- std::mutex lock_;  // 对frames_进行操作时需要加锁
- FrameLruCache  frames_;  // 用于存放Frame，但内存有限
- FrameAllocator allocator_;  // 用于分配新的Frame
-};
\ No newline at end of file
+ Shard               shards_[SHARD_NUM];
+ std::atomic<size_t> frame_num_{0};
+ std::atomic<int>    evict_cursor_{0};      // 下一次从哪个分片开始驱逐
+ size_t              probation_limit_ = 1;  // 每个分片上试用队列的长度限制
+ FrameAllocator      allocator_;            // 用于分配新的Frame
+};
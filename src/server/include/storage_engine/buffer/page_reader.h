@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "include/common/rc.h"
+#include "include/common/setting.h"
+
+class BufferPoolManager;
+class FileBufferPool;
+
+/**
+ * @brief 后台预读线程
+ * @details 顺序扫描时，扫描器提前提交后面若干个页面的预读请求，由后台线程批量加载到缓冲池中，
+ * 扫描器访问到这些页面时就不需要再等待磁盘读。
+ * 连续的页面用一次preadv读取，见 FileBufferPool::load_pages。
+ *
+ * 只有在 CONCURRENCY 编译模式下才会启动线程，否则 submit 会直接在当前线程中批量读取。
+ */
+class PageReader
+{
+public:
+  static constexpr int DEFAULT_THREAD_NUM = 2;   // 默认的预读线程个数
+  static constexpr int MAX_PENDING_NUM    = 64;  // 最多缓存多少个预读请求，超过时丢弃新的请求
+
+public:
+  explicit PageReader(BufferPoolManager &bp_manager);
+  ~PageReader();
+
+  RC start(int thread_num = DEFAULT_THREAD_NUM);
+
+  /**
+   * @brief 停止后台线程，还没有处理的请求会被丢弃
+   */
+  void stop();
+
+  /**
+   * @brief 提交一个预读请求
+   * @details 预读只是一种优化，请求太多或者失败时都可以直接忽略
+   * @param bp 要读的文件
+   * @param start_page 第一个页面
+   * @param page_count 连续读多少个页面
+   */
+  void submit(FileBufferPool *bp, PageNum start_page, int page_count);
+
+private:
+  struct Request
+  {
+    FileBufferPool *bp;
+    PageNum         start_page;
+    int             page_count;
+  };
+
+  void run();
+
+private:
+  BufferPoolManager &bp_manager_;
+
+  std::vector<std::thread> threads_;
+  std::mutex               lock_;
+  std::condition_variable  cond_;
+  std::deque<Request>      requests_;
+  bool                     running_ = false;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "include/common/rc.h"
+
+class BufferPoolManager;
+
+/**
+ * @brief 后台刷脏页线程
+ * @details 原来只有在分配页帧时由当前线程驱逐脏页，或者在 flush_all_pages/Db::sync 时才会写出脏页，
+ * 前台线程经常要等待磁盘写。后台线程周期性地检查缓冲池，当干净页帧的比例低于目标值时，
+ * 从最冷的脏页开始刷盘，使得驱逐时大多只需要丢弃干净页帧。
+ * 正在被使用(pin count不为0)的页帧会被跳过。
+ * 当前记录的修改还不写数据日志，刷盘前没有按照页面LSN刷日志，见 FileBufferPool::flush_page_internal。
+ *
+ * 只有在 CONCURRENCY 编译模式下才会启动线程，否则页面锁都是空操作，后台线程与前台线程并发访问并不安全。
+ */
+class PageWriter
+{
+public:
+  static constexpr int    DEFAULT_INTERVAL_MS        = 100;   // 默认每隔多久检查一次
+  static constexpr double DEFAULT_TARGET_CLEAN_RATIO = 0.25;  // 默认希望保留的干净页帧比例
+
+public:
+  explicit PageWriter(BufferPoolManager &bp_manager);
+  ~PageWriter();
+
+  /**
+   * @brief 启动后台线程
+   * @param interval_ms 两轮刷盘之间的间隔
+   * @param target_clean_ratio 干净页帧（包括还没有分配出去的页帧）占缓冲池容量的目标比例
+   */
+  RC start(int interval_ms = DEFAULT_INTERVAL_MS, double target_clean_ratio = DEFAULT_TARGET_CLEAN_RATIO);
+
+  /**
+   * @brief 停止后台线程，会等待正在进行的一轮刷盘结束
+   */
+  void stop();
+
+  /**
+   * @brief 执行一轮刷盘
+   * @details 后台线程周期性地调用，也可以直接调用
+   * @return 本轮写出了多少个页面
+   */
+  int run_once();
+
+  void set_target_clean_ratio(double ratio) { target_clean_ratio_ = ratio; }
+
+private:
+  void run();
+
+private:
+  BufferPoolManager &bp_manager_;
+
+  std::thread             thread_;
+  std::mutex              lock_;
+  std::condition_variable cond_;
+  bool                    running_ = false;
+
+  int                 interval_ms_ = DEFAULT_INTERVAL_MS;
+  std::atomic<double> target_clean_ratio_{DEFAULT_TARGET_CLEAN_RATIO};
+};
@@ -4,9 +4,12 @@
 #include <sstream>
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "include/storage_engine/recorder/record_manager.h"
 #include "include/storage_engine/buffer/buffer_pool.h"
+#include "include/storage_engine/index/latch_memo.h"
+#include "include/query_engine/structor/external_sorter.h"
 #include "include/query_engine/parser/parse_defs.h"
 #include "common/lang/comparator.h"
 #include "common/log/log.h"
@@ -205,6 +208,7 @@ struct IndexFileHeader
   int32_t key_length;         // 索引键的总长度，attrs length + sizeof(RID)
   AttrType attrs_type;        // 索引字段的整体类型：如果是多列索引，则统一视为CHAR类型
   bool is_unique_;            // 是否是唯一索引
+  bool key_compressed;        // 节点中的键是否使用前缀压缩的格式，参考 CompressedKeyHeader
 
   const std::string to_string()
   {
@@ -220,6 +224,7 @@ struct IndexFileHeader
       ss << "|" << multi_attr_types[i];
     }
     ss << "is unique:" << is_unique_ << ","
+       << "key compressed:" << key_compressed << ","
        << "root_page:" << root_page << ","
        << "internal_max_size:" << internal_max_size << ","
        << "leaf_max_size:" << leaf_max_size << ";";
@@ -284,6 +289,27 @@ struct InternalIndexNode : public IndexNode
   char array[0];
 };
 
+/**
+ * @brief 压缩格式的节点中键值数组的头部
+ * @code
+ * storage format:
+ * | common header | (next page id) | prefix length | attr end | prefix |
+ * | key0 stored part, value0 | ... | keyn stored part, valuen |
+ * @endcode
+ * 节点中所有的键前 prefix_len 个字节都相同，只保存一份；属性部分从 attr_end 开始到属性末尾都是0，也不保存。
+ * 每一项只保存键中剩下的部分(包括RID)和值，所以每个节点中项的大小可能不同。
+ * 字符串和多字段的键通常有较长的公共前缀，字符串末尾补齐的0也比较多，内部节点的分隔键还会截短(参考
+ * BplusTreeHandler::make_separator)，一个页面可以放下更多的项，树的高度更低。
+ */
+struct CompressedKeyHeader
+{
+  static constexpr int HEADER_SIZE = 4;
+
+  int16_t prefix_len;
+  int16_t attr_end;
+  char    prefix[0];
+};
+
 /**
  * @brief IndexNode 仅作为数据在内存或磁盘中的表示；IndexNodeHandler 负责对IndexNode做各种操作。
  * 作为一个类来说，虚函数会影响“结构体”真实的内存布局，所以将数据存储与操作分开
@@ -297,6 +323,7 @@ class IndexNodeHandler
   void init_empty(bool leaf);
 
   bool is_leaf() const;
+  bool compressed() const;
   int  key_size() const;
   int  value_size() const;
   int  item_size() const;
@@ -311,14 +338,78 @@ class IndexNodeHandler
 
   bool is_safe(BplusTreeOperationType op, bool is_root_node);
 
+  /**
+   * 插入 key 以后节点是否还放得下。压缩格式下除了项数，还要看压缩以后的大小是否超过页面的 fill_factor 比例
+   */
+  bool can_insert(const char *key, int fill_factor = 100) const;
+  /**
+   * other 中所有的项能否合并到当前节点中
+   */
+  bool can_merge(const IndexNodeHandler &other) const;
+
+  /**
+   * 按照不压缩的格式 | key | value | 复制第 [begin, end) 项
+   */
+  void read_items(int begin, int end, char *items) const;
+  /**
+   * 用不压缩格式的 num 项替换节点中所有的项，放不下时返回 false，节点不变
+   */
+  bool write_items(const char *items, int num);
+  bool fits(const char *items, int num) const;
+  /**
+   * num 项不压缩格式的数据分到两个节点中，返回左边节点的项数，两边都放得下并且尽量平均
+   */
+  int  split_point(const char *items, int num) const;
+
   bool validate() const;
 
   friend std::string to_string(const IndexNodeHandler &handler);
 
+ protected:
+  /**
+   * 第 index 项的键，压缩格式下解压到 buffer 中
+   */
+  const char *read_key(int index, char *buffer) const;
+  char *value_ptr(int index) const;
+  /**
+   * 二分查找 [begin, size) 中第一个不小于 key 的位置
+   */
+  int  lower_bound_key(const KeyComparator &comparator, const char *key, int begin, bool *found) const;
+
+  void insert_item(int index, const char *key, const char *value);
+  void remove_item(int index);
+  bool can_set_key(int index, const char *key) const;
+  void set_key(int index, const char *key);
+
+  char *key_buffer() const;
+  char *probe_buffer() const;
+
+ private:
+  char *array() const;
+  int   array_capacity() const;
+  int   uncompressed_capacity() const;
+  CompressedKeyHeader *compressed_header() const;
+
+  char *item_at(int index) const;
+  int   stored_item_size() const;
+  bool  key_in_window(const char *key) const;
+  int   stored_key_size() const;
+  int   stored_key_size(int prefix_len, int attr_end) const;
+  int   gap_end(int prefix_len) const;
+  void  encode_key(const char *key, char *item) const;
+  void  decode_key(const char *item, char *key) const;
+  int   packed_size(int num, int prefix_len, int attr_end) const;
+  void  key_window(const char *items, int num, int &prefix_len, int &attr_end) const;
+
  protected:
   const IndexFileHeader &header_;  // 索引文件的头部信息
   PageNum page_num_;  // 当前索引节点在磁盘中的页号
   IndexNode *node_;  // 当前索引节点的数据
+
+ private:
+  // 压缩格式下解压出来的键。key_at 返回的指针在同一个 handler 下次调用 key_at 之前有效
+  mutable std::vector<char> key_buffer_;
+  mutable std::vector<char> probe_buffer_;
 };
 
 /**
@@ -346,7 +437,6 @@ class LeafIndexNodeHandler : public IndexNodeHandler
   void insert(int index, const char *key, const char *value);
   void remove(int index);
   int  remove(const char *key, const KeyComparator &comparator);
-  RC move_half_to(LeafIndexNodeHandler &other, FileBufferPool *bp);
   /**
    * move the first item of current leaf node to the end of the left leaf node
    */
@@ -364,17 +454,6 @@ class LeafIndexNodeHandler : public IndexNodeHandler
 
   friend std::string to_string(const LeafIndexNodeHandler &handler, const KeyPrinter &printer);
 
- private:
-  char *__item_at(int index) const;
-  char *__key_at(int index) const;
-  char *__value_at(int index) const;
-
-  void append(const char *item);
-  /**
-   * insert one item to the first slot
-   */
-  void preappend(const char *item);
-
  private:
   LeafIndexNode *leaf_node_;
 };
@@ -392,6 +471,10 @@ class InternalIndexNodeHandler : public IndexNodeHandler
   void create_new_root(PageNum first_page_num, const char *key, PageNum page_num);
 
   char *key_at(int index);
+  /**
+   * 压缩格式下替换以后可能放不下，需要先用 can_set_key_at 检查
+   */
+  bool can_set_key_at(int index, const char *key) const;
   void set_key_at(int index, const char *key);
   PageNum value_at(int index);
   /**
@@ -411,31 +494,25 @@ class InternalIndexNodeHandler : public IndexNodeHandler
   int lookup(const KeyComparator &comparator, const char *key, bool *found = nullptr, int *insert_position = nullptr) const;
 
   void insert(const char *key, PageNum page_num, const KeyComparator &comparator);
+  /**
+   * 在最后追加一个子节点，批量构建时使用。不会修改子节点中记录的父节点
+   */
+  void append(const char *key, PageNum page_num);
   void remove(int index);
 
-  RC move_half_to(LeafIndexNodeHandler &other, FileBufferPool *bp);
-  RC move_half_to(InternalIndexNodeHandler &other, FileBufferPool *bp);
   RC move_first_to_end(InternalIndexNodeHandler &other, FileBufferPool *bp);
   RC move_last_to_front(InternalIndexNodeHandler &other, FileBufferPool *bp);
   RC move_to(InternalIndexNodeHandler &other, FileBufferPool *bp);
 
+  /**
+   * 把第 [begin, end) 个子节点记录的父节点修改为当前节点
+   */
+  RC adopt_children(int begin, int end, FileBufferPool *bp);
+
   bool validate(const KeyComparator &comparator, FileBufferPool *bp) const;
 
   friend std::string to_string(const InternalIndexNodeHandler &handler, const KeyPrinter &printer);
 
- private:
-  RC copy_from(const char *items, int num, FileBufferPool *disk_buffer_pool);
-  RC append(const char *item, FileBufferPool *bp);
-  RC preappend(const char *item, FileBufferPool *bp);
-
- private:
-  char *__item_at(int index) const;
-  char *__key_at(int index) const;
-  char *__value_at(int index) const;
-
-  int value_size() const;
-  int item_size() const;
-
  private:
   InternalIndexNode *internal_node_ = nullptr;
 };
@@ -454,13 +531,15 @@ class BplusTreeHandler
    * @param multi_attr_length 每个索引字段的长度
    * @param internal_max_size 内部节点最大的键值对数
    * @param leaf_max_size 叶子节点最大的键值对数
+   * @param key_compressed 节点中的键是否使用前缀压缩的格式
    */
   RC create(const char *file_name,
             bool is_unique,
             std::vector<AttrType> multi_attr_types,
             std::vector<int> multi_attr_length,
             int internal_max_size = -1,
-            int leaf_max_size = -1);
+            int leaf_max_size = -1,
+            bool key_compressed = false);
 
   /**
    * 打开名为fileName的索引文件。
@@ -489,6 +568,11 @@ class BplusTreeHandler
 
   bool is_empty() const;
 
+  /**
+   * @brief 节点中的键是否使用前缀压缩的格式
+   */
+  bool key_compressed() const { return file_header_.key_compressed; }
+
   /**
    * 获取指定值的record对应的RID
    * @param multi_keys 索引字段的属性值数组（之所以是数组，因为可能是多字段索引）
@@ -496,6 +580,15 @@ class BplusTreeHandler
    */
   RC get_entry(const char *multi_keys[], std::list<RID> &rids, int multi_keys_amount = 1);
 
+  /**
+   * 批量获取多个值对应的RID
+   * @details 先把要查找的值排序，再沿着叶子节点的兄弟指针从左向右查找，
+   * 只有下一个值不在当前叶子节点(和它右边的兄弟节点)中时才从根节点重新查找。适合索引嵌套循环连接和 IN 列表这类一次查很多值的场景
+   * @param user_keys 要查找的值，每一项是所有索引字段拼接在一起的值，长度为 attrs_length，可以无序、可以重复
+   * @param rids 返回值，rids[i] 是 user_keys[i] 对应的所有RID，按照索引中的顺序排列
+   */
+  RC get_entries(const std::vector<const char *> &user_keys, std::vector<std::vector<RID>> &rids);
+
   RC sync();
 
   /**
@@ -521,38 +614,59 @@ class BplusTreeHandler
 
   bool validate_leaf_link();
   bool validate_node_recursive(Frame *frame);
+  RC   fetch_left_most_page(Frame *&frame);
 
  protected:
-  RC find_leaf(BplusTreeOperationType op, const char *key, Frame *&frame);
-  RC left_most_page(Frame *&frame);
-  RC find_leaf_internal(BplusTreeOperationType op,
+  /**
+   * @brief 查找 key 所在的叶子节点
+   * @details 按照螃蟹协议从根节点向下加锁，子节点安全时释放祖先节点的锁。
+   * optimistic 为 true 时，写操作也只对内部节点加读锁，只对叶子节点加写锁，
+   * 调用者需要检查叶子节点是否安全，不安全时放弃所有锁，再用悲观的方式重新查找。
+   * 获取的页面和锁都记录在 latch_memo 中，由调用者释放。
+   */
+  RC find_leaf(LatchMemo &latch_memo, BplusTreeOperationType op, const char *key, Frame *&frame,
+               bool optimistic = false);
+  RC left_most_page(LatchMemo &latch_memo, Frame *&frame);
+  /**
+   * @brief get_entries 使用，定位到 key 所在的叶子节点，index 是其中第一个不小于 key 的位置
+   * @details frame 不为空时是当前持有读锁的叶子节点，key 不在这个节点中时先尝试右边的兄弟节点，
+   * 还不在的话放弃所有的锁，从根节点重新查找
+   */
+  RC seek_leaf(LatchMemo &latch_memo, const char *key, Frame *&frame, int &index);
+  RC find_leaf_internal(LatchMemo &latch_memo, BplusTreeOperationType op,
                         const std::function<PageNum(InternalIndexNodeHandler &)> &child_page_getter,
-                        Frame *&frame);
-  RC crabing_protocal_fetch_page(BplusTreeOperationType op, PageNum page_num, bool is_root_page,
-                                 Frame *&frame);
-
-  RC insert_into_parent(PageNum parent_page, Frame *left_frame, const char *pkey,
-                        Frame &right_frame);
+                        Frame *&frame, bool optimistic);
+  RC crabing_protocal_fetch_page(LatchMemo &latch_memo, BplusTreeOperationType op, PageNum page_num,
+                                 bool is_root_node, bool optimistic, Frame *&frame);
 
-  RC delete_entry_internal(Frame *leaf_frame, const char *key);
+  RC delete_entry_internal(LatchMemo &latch_memo, Frame *leaf_frame, const char *key);
 
+  /**
+   * @brief 把 (key, value) 插入到已经放不下的节点的 index 位置，并分裂成两个节点
+   */
   template <typename IndexNodeHandlerType>
-  RC split(Frame *frame, Frame *&new_frame);
+  RC split(LatchMemo &latch_memo, Frame *frame, int index, const char *key, const char *value, Frame *&new_frame);
   template <typename IndexNodeHandlerType>
-  RC coalesce_or_redistribute(Frame *frame);
+  RC coalesce_or_redistribute(LatchMemo &latch_memo, Frame *frame);
   template <typename IndexNodeHandlerType>
-  RC coalesce(Frame *neighbor_frame, Frame *frame, Frame *parent_frame, int index);
+  RC coalesce(LatchMemo &latch_memo, Frame *neighbor_frame, Frame *frame, Frame *parent_frame, int index);
   template <typename IndexNodeHandlerType>
   RC redistribute(Frame *neighbor_frame, Frame *frame, Frame *parent_frame, int index);
 
-  RC insert_entry_into_parent(Frame *frame, Frame *new_frame, const char *key);
-  RC insert_entry_into_leaf_node(Frame *frame, const char *pkey, const RID *rid);
-  RC create_new_tree(const char *key, const RID *rid);
+  RC insert_entry_into_parent(LatchMemo &latch_memo, Frame *frame, Frame *new_frame, const char *key);
+  RC insert_entry_into_leaf_node(LatchMemo &latch_memo, Frame *frame, const char *pkey, const RID *rid);
+  RC create_new_tree(LatchMemo &latch_memo, const char *key, const RID *rid);
 
-  void update_root_page_num(PageNum root_page_num);
   void update_root_page_num_locked(PageNum root_page_num);
 
-  RC adjust_root(Frame *root_frame);
+  RC adjust_root(LatchMemo &latch_memo, Frame *root_frame);
+
+  /**
+   * @brief 生成相邻两个叶子节点在父节点中的分隔键，满足 left_key < separator <= right_key
+   * @details 不压缩时就是 right_key。压缩格式下尽量截短：属性不同时 RID 置0，
+   * 字符串和多字段的键只保留到第一个不同的字节，后面都置0，这些0在内部节点中不需要保存
+   */
+  void make_separator(const char *left_key, const char *right_key, char *separator) const;
 
  private:
   common::MemPoolItem::unique_ptr make_key(const char *multi_keys[], const RID &rid, int multi_keys_num = 1, int left_or_right = 0, bool all_in_one_input_key = false);
@@ -566,10 +680,13 @@ class BplusTreeHandler
   KeyComparator   key_comparator_;
   KeyPrinter      key_printer_;
 
+  common::SharedMutex root_lock_;  // 保护根节点的页号，修改根节点时需要加写锁
+
   std::unique_ptr<common::MemPoolItem> mem_pool_item_;
 
  private:
   friend class BplusTreeScanner;
+  friend class BplusTreeBulkLoader;
   friend class BplusTreeTester;
 };
 
@@ -595,7 +712,15 @@ class BplusTreeScanner
   RC open(const char *left_user_key, int left_len, bool left_inclusive,
           const char *right_user_key, int right_len, bool right_inclusive);
 
+  /**
+   * @brief 获取下一个数据
+   * @details 数据是从叶子节点复制出来的，调用者删除已经输出的数据不影响后续的输出，isdelete 仅为兼容保留
+   */
   RC next_entry(RID &rid, bool isdelete);
+  /**
+   * @brief 获取下一个数据和它的键(不含RID)，key 指向扫描器中的副本，下次调用之前有效
+   */
+  RC next_entry(RID &rid, const char *&key);
 
   RC close();
 
@@ -605,6 +730,12 @@ class BplusTreeScanner
    */
   RC fix_user_key(const char *user_key, int key_len, bool want_greater, char **fixed_key, bool *should_inclusive);
 
+  /**
+   * @brief 定位到第一个大于 key 的数据，key 为空时定位到最左边的数据，并复制所在叶子节点中剩余的数据
+   */
+  RC seek(const char *key);
+  void load_items(Frame *frame, int index);
+
   void fetch_item(RID &rid);
   bool touch_end();
 
@@ -612,11 +743,90 @@ class BplusTreeScanner
   bool inited_ = false;
   BplusTreeHandler &tree_handler_;
 
-  /// 使用左右叶子节点和位置来表示扫描的起始位置和终止位置
-  /// 起始位置和终止位置都是有效的数据
-  Frame *current_frame_ = nullptr;
+  /// 当前叶子节点中还没有输出的数据的副本，每一项是 | key | rid |。
+  /// 复制以后就释放页面的锁，不会在两次调用之间持有锁
+  std::vector<char> items_;
+  int item_num_ = 0;
+  int iter_index_ = 0;
+  PageNum next_page_ = BP_INVALID_PAGE_NUM;  // 复制时这个叶子节点的下一个节点
 
   common::MemPoolItem::unique_ptr right_key_;
-  int iter_index_ = 0;
-  bool first_emitted_ = false;
+};
+
+/**
+ * @brief 自底向上批量构建B+树
+ * @ingroup BPlusTree
+ * @details 用于在已有数据的表上创建索引，只能作用于一棵空树。
+ * add 把每个键值编码成可以直接用 memcmp 比较的排序键，交给外部排序；finish 时按顺序从左到右写叶子节点，
+ * 每个节点写到 fill_factor 比例(压缩格式下还要看压缩以后的字节数)就换下一个页面。
+ * 每一层保留最右边的两个节点，开始第三个节点时才把最左边的节点追加到上一层中。
+ * 数据写完以后，每一层最后一个节点不足 min_size 时与前一个节点合并，合并不下就重新平分，
+ * 所以除了根节点，每个节点都不会少于 min_size。叶子节点在上一层中的分隔键由 make_separator 生成。
+ *
+ * 浮点数的比较有误差范围，排序结果与 KeyComparator 的顺序可能不完全一致。
+ * 没有严格大于前一个键的数据先记下来，树建好以后再用 insert_entry 逐个插入。
+ */
+class BplusTreeBulkLoader
+{
+ public:
+  static constexpr int DEFAULT_FILL_FACTOR = 90;
+
+ public:
+  /**
+   * @param fill_factor  每个节点写满的百分比，不低于 50
+   * @param memory_limit 排序时内存中最多缓存多少字节的数据
+   */
+  BplusTreeBulkLoader(BplusTreeHandler &tree_handler, int fill_factor = DEFAULT_FILL_FACTOR,
+                      size_t memory_limit = ExternalSorter::DEFAULT_MEMORY_LIMIT);
+  ~BplusTreeBulkLoader();
+
+  /**
+   * @brief 添加一个索引项，参数与 BplusTreeHandler::insert_entry 相同
+   */
+  RC add(const char *multi_keys[], const RID &rid, int multi_keys_amount = 1);
+
+  /**
+   * @brief 所有数据添加完毕，构建B+树
+   */
+  RC finish();
+
+ private:
+  /**
+   * @brief 正在构建的一层节点，只记录最右边的两个节点，写满以前一直持有引用
+   */
+  struct Level
+  {
+    Frame *prev = nullptr;
+    Frame *cur = nullptr;
+  };
+
+  void make_sort_key(const char *key, std::string &sort_key) const;
+
+  bool node_full(Frame *frame, const char *key) const;
+  RC append_to_leaf(const char *key);
+  RC append_to_internal(int level, const char *key, Frame *child_frame);
+  RC start_node(int level);
+  RC push_node(int level, Frame *frame);
+  RC balance_last_nodes(int level);
+  RC build_upper_levels(PageNum &root_page);
+  RC set_root(PageNum root_page);
+  RC insert_stragglers();
+  void release();
+
+ private:
+  BplusTreeHandler &tree_handler_;
+  const IndexFileHeader &file_header_;
+  FileBufferPool *file_buffer_pool_ = nullptr;
+  int fill_factor_ = DEFAULT_FILL_FACTOR;
+
+  ExternalSorter sorter_;
+  int64_t entry_num_ = 0;
+  std::string sort_key_;
+  std::string payload_;
+
+  std::vector<Level> levels_;  // levels_[0] 是叶子节点
+  std::vector<char> last_key_;
+  std::vector<char> last_pushed_key_;  // 已经追加到上一层的叶子节点中最大的键，用来生成分隔键
+  std::vector<char> stragglers_;  // 没有按顺序出现的键，每一项是 | key | rid |
+  std::vector<PageNum> disposed_pages_;  // 合并掉的节点
 };
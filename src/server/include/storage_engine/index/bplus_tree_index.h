@@ -15,13 +15,29 @@ class BplusTreeIndex : public Index
     table_ = table;
   }
 
-  RC create(const char *file_name, const IndexMeta &index_meta, const std::vector<FieldMeta> &multi_field_metas);
+  /**
+   * @param key_compressed 节点中的键是否使用前缀压缩，为false时由 -K 参数决定
+   */
+  RC create(const char *file_name, const IndexMeta &index_meta, const std::vector<FieldMeta> &multi_field_metas,
+            bool key_compressed = false);
   RC open(const char *file_name, const IndexMeta &index_meta, const std::vector<FieldMeta> &multi_field_metas);
   RC close();
 
   RC insert_entry(const char *record, const RID *rid) override;
   RC delete_entry(const char *record, const RID *rid) override;
 
+  /**
+   * @brief 把表中已有的数据批量加载到刚创建的空索引中
+   * @details 先对所有索引项排序，再自底向上构建B+树，比逐条插入快，节点也更满
+   */
+  RC bulk_load(RecordFileScanner &scanner);
+
+  /**
+   * @brief 为已经写入表中的一批记录插入索引项，导入数据时在最后统一调用
+   * @details 索引是空的时候与 bulk_load 一样自底向上构建，否则逐条插入
+   */
+  RC insert_entries(const std::vector<RID> &rids);
+
   /**
    * 扫描指定范围的数据
    */
@@ -52,6 +68,7 @@ class BplusTreeIndexScanner : public IndexScanner
   ~BplusTreeIndexScanner() noexcept override;
 
   RC next_entry(RID *rid, bool isdelete) override;
+  RC next_entry(RID *rid, const char **key) override;
   RC destroy() override;
 
   RC open(const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len,
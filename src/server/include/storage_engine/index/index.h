@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include "include/storage_engine/index/index_meta.h"
@@ -48,6 +49,15 @@ public:
    */
   virtual RC delete_entry(const char *record, const RID *rid) = 0;
 
+  /**
+   * @brief 删除一条数据，按照第一个索引字段和 rid 查找索引项
+   * @details 索引项中的事务字段是插入记录时的值，事务提交以后记录中的值会变化，
+   * 这时不能用 delete_entry 直接定位，需要先扫描出索引中保存的完整的键
+   * @param record 删除的记录
+   * @param[in] rid 删除的记录的位置
+   */
+  RC delete_entry_by_rid(const char *record, const RID *rid);
+
   /**
    * @brief 创建一个索引数据的扫描器
    * @param left_key 要扫描的左边界
@@ -65,6 +75,13 @@ public:
    */
   virtual RC sync() = 0;
 
+  /**
+   * @brief 把每个索引字段的值按照字段的类型和长度拼接成扫描用的键
+   * @details 与 Table::change_record_value 写入记录的方式相同，字符串不足字段长度的部分补0，
+   * 数值按照字段的类型转换，得到的键与索引中保存的字段值可以直接比较
+   */
+  void make_user_key(const std::vector<Value> &values, std::string &key) const;
+
 protected:
   RC init(const IndexMeta &index_meta, const std::vector<FieldMeta> &multi_field_metas);
 
@@ -88,5 +105,11 @@ public:
    * 如果没有更多的元素，返回RECORD_EOF
    */
   virtual RC next_entry(RID *rid, bool isdelete) = 0;
+
+  /**
+   * @brief 遍历元素数据，同时返回索引中保存的字段值
+   * @details key 指向扫描器内部的数据，是所有索引字段按顺序拼接在一起的值，下次调用之前有效
+   */
+  virtual RC next_entry(RID *rid, const char **key) { return RC::UNIMPLENMENT; }
   virtual RC destroy() = 0;
 };
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "include/common/rc.h"
+#include "include/common/setting.h"
+#include "common/lang/mutex.h"
+
+class Frame;
+class FileBufferPool;
+
+/**
+ * @brief LatchMemo 中记录的资源类型
+ * @ingroup BPlusTree
+ */
+enum class LatchMemoType
+{
+  NONE,
+  SHARED,     // 读锁
+  EXCLUSIVE,  // 写锁
+  PIN,        // 页面的引用计数
+};
+
+struct LatchMemoItem
+{
+  LatchMemoItem() = default;
+  LatchMemoItem(LatchMemoType type, Frame *frame) : type(type), frame(frame) {}
+  LatchMemoItem(LatchMemoType type, common::SharedMutex *lock) : type(type), lock(lock) {}
+
+  LatchMemoType        type = LatchMemoType::NONE;
+  Frame               *frame = nullptr;
+  common::SharedMutex *lock = nullptr;
+};
+
+/**
+ * @brief 记录B+树一次操作过程中获取的页面引用和锁
+ * @ingroup BPlusTree
+ * @details 按照获取的顺序记录，操作结束(析构)时统一释放。
+ * release_to 可以提前释放某个位置之前的所有资源，用来实现螃蟹协议：子节点安全时，祖先节点的锁就可以释放了。
+ * 删除的页面要等到所有的锁和引用都释放以后才真正删除。
+ */
+class LatchMemo final
+{
+public:
+  explicit LatchMemo(FileBufferPool *buffer_pool);
+  ~LatchMemo();
+
+  LatchMemo(const LatchMemo &) = delete;
+  LatchMemo &operator=(const LatchMemo &) = delete;
+
+  /**
+   * @brief 获取页面并记录一次引用，不加锁
+   */
+  RC get_page(PageNum page_num, Frame *&frame);
+  RC allocate_page(Frame *&frame);
+  void dispose_page(PageNum page_num);
+
+  void latch(Frame *frame, LatchMemoType type);
+  void xlatch(Frame *frame);
+  void slatch(Frame *frame);
+  bool try_slatch(Frame *frame);
+
+  void xlatch(common::SharedMutex *lock);
+  void slatch(common::SharedMutex *lock);
+
+  /**
+   * @brief 释放所有资源，并删除 dispose_page 记录的页面
+   */
+  void release();
+
+  /**
+   * @brief 释放前 point 个资源，point 通常是之前调用 memo_point 的返回值
+   */
+  void release_to(int point);
+
+  int memo_point() const { return static_cast<int>(items_.size()); }
+
+private:
+  void release_item(LatchMemoItem &item);
+
+private:
+  FileBufferPool           *buffer_pool_ = nullptr;
+  std::deque<LatchMemoItem> items_;
+  std::vector<PageNum>      disposed_pages_;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "include/query_engine/parser/parse_defs.h"
+
+/**
+ * @brief 定长数值的批量比较
+ * @defgroup CompareKernel
+ * @details INTS/DATES 按 int32_t 存储，FLOATS 按 float 存储，都是4个字节。
+ * 这里把一批这样的值与同一个常量做比较，结果按位写到 bitmap 中：第i个值满足条件时第i位为1，
+ * 位的排列与 common::Bitmap 相同。值可以是连续存放的（Chunk 中的列，stride 为4），
+ * 也可以是页面中每条记录的同一个字段（stride 为记录的长度），这样不需要先把数据复制出来。
+ *
+ * 在x86_64上，运行时检测CPU是否支持AVX2，支持时一次比较8个值，否则使用SSE2一次比较4个值，
+ * 其它平台使用普通的循环。浮点数的比较与 common::compare_float 一致，差值在EPSILON以内认为相等。
+ * bitmap 的长度至少为 (count + 7) / 8 个字节，最后一个字节中多余的位会被清零。
+ */
+
+/**
+ * @brief 是否支持用比较内核来计算
+ * @details 只支持 =、<>、<、<=、>、>= 六种比较
+ */
+bool compare_kernel_supported(CompOp comp_op);
+
+/**
+ * @brief 比较 count 个 int32_t 与 constant
+ * @param data   第一个值的地址，不要求对齐
+ * @param stride 相邻两个值之间的字节数
+ * @param bitmap 比较结果
+ */
+void compare_int32(const char *data, int stride, int count, CompOp comp_op, int32_t constant, char *bitmap);
+
+/**
+ * @brief 比较 count 个 float 与 constant
+ * @details 参数的含义与 compare_int32 相同
+ */
+void compare_float(const char *data, int stride, int count, CompOp comp_op, float constant, char *bitmap);
+
+/**
+ * @brief 返回当前使用的实现，avx2、sse2或scalar
+ */
+const char *compare_kernel_name();
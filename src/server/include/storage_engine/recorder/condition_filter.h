@@ -14,6 +14,8 @@ struct ConDesc
   int attr_length;  // 如果是属性，表示属性值长度
   int attr_offset;  // 如果是属性，表示在记录中的偏移量
   Value value;      // 如果是值类型，这里记录值的数据
+  int null_bitmap_offset = -1;  // 如果是可以为null的属性，表示记录中null位图的偏移量，否则是-1
+  int null_bit = 0;             // 如果是可以为null的属性，表示属性在null位图中的位置
 };
 
 class ConditionFilter 
@@ -27,6 +29,13 @@ public:
    * @return true means match condition, false means failed to match.
    */
   virtual bool filter(const Record &rec) const = 0;
+
+  /**
+   * @brief 批量过滤一个页面上的记录
+   * @details records 是第一条记录的地址，相邻两条记录相隔 record_size 个字节，共 record_num 个槽位。
+   * 第i条记录满足条件时 bitmap 的第i位为1。不支持批量过滤时返回false，需要逐条调用 filter
+   */
+  virtual bool filter_page(const char *records, int record_size, int record_num, char *bitmap) const { return false; }
 };
 
 class DefaultConditionFilter : public ConditionFilter 
@@ -40,6 +49,11 @@ public:
 
   virtual bool filter(const Record &rec) const;
 
+  /**
+   * @brief 一边是INTS/DATES/FLOATS字段，另一边是同类型的值时，用比较内核批量过滤
+   */
+  bool filter_page(const char *records, int record_size, int record_num, char *bitmap) const override;
+
 public:
   const ConDesc &left() const
   {
@@ -78,6 +92,11 @@ public:
   RC init(Table &table, const ConditionSqlNode *conditions, int condition_num);
   virtual bool filter(const Record &rec) const;
 
+  /**
+   * @brief 所有条件都支持批量过滤时，把各个条件的结果按位与起来
+   */
+  bool filter_page(const char *records, int record_size, int record_num, char *bitmap) const override;
+
 public:
   int filter_num() const
   {
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "include/common/rc.h"
+#include "include/storage_engine/buffer/page.h"
+
+/**
+ * @brief 记录文件的空闲空间表(free space map)
+ * @ingroup RecordManager
+ * @details 每个页面用一个位表示是否还能插入记录，位图按64位分组，全部用原子操作访问，查找时不加锁。
+ * 插入记录的线程通过 claim 把找到的位清零，这样同一时刻一个未满的页面只会交给一个插入线程，
+ * 用完以后通过 release 把没有满的页面还回来。不同线程按照线程ID从位图中不同的位置开始查找，
+ * 并发插入时会落到不同的页面上，不会都去抢同一个页面的写锁。
+ *
+ * 位图保存在单独的文件中(表名.fsm)，文件头记录了数据文件的页面个数和是否正常关闭。
+ * 打开时文件存在、正常关闭并且页面个数与数据文件一致，就直接加载位图，不需要遍历所有的数据页面；
+ * 否则(比如数据库异常退出)由调用者重新扫描数据文件来构造。
+ * 这里的信息只是一个提示：标记为空闲的页面可能已经满了，插入前仍然要检查页面本身。
+ */
+class FreeSpaceMap
+{
+public:
+  FreeSpaceMap();
+  ~FreeSpaceMap();
+
+  /**
+   * @brief 打开空闲空间表文件
+   * @param file_name  文件名，为空时只在内存中维护
+   * @param page_count 数据文件当前的页面个数
+   * @param loaded     返回是否从文件中加载了有效的位图，没有加载时需要调用者逐个 set_free
+   */
+  RC open(const char *file_name, int page_count, bool &loaded);
+
+  /**
+   * @brief 把位图写回文件，并标记为正常关闭
+   */
+  RC close();
+
+  /**
+   * @brief 找到一个有空闲空间的页面并占用它
+   * @details 在 [begin, end) 中查找，找到的页面在 release 之前不会再交给其它线程
+   * @return 没有找到时返回 BP_INVALID_PAGE_NUM
+   */
+  PageNum claim(PageNum begin, PageNum end);
+
+  /**
+   * @brief 释放 claim 到的页面
+   * @param has_free_space 页面上是否还有空闲位置
+   */
+  void release(PageNum page_num, bool has_free_space);
+
+  /**
+   * @brief 标记页面有空闲空间，比如删除了记录
+   */
+  void set_free(PageNum page_num);
+
+  /**
+   * @brief 文件中新增了页面
+   */
+  void extend(PageNum page_num);
+
+  /**
+   * @brief 当前线程开始查找的位置。不同线程从不同的位置开始，减少冲突
+   */
+  PageNum start_page() const;
+
+  int page_count() const { return page_count_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief 有空闲空间的页面个数，用于日志和测试
+   */
+  int free_page_count() const;
+
+private:
+  RC write_header(bool clean);
+
+private:
+  static constexpr int WORD_BITS = 64;
+  static constexpr int WORD_NUM  = (FileHeader::MAX_PAGE_NUM + WORD_BITS - 1) / WORD_BITS;
+
+  std::string file_name_;
+  int         file_desc_ = -1;
+
+  std::unique_ptr<std::atomic<uint64_t>[]> words_;           // 每个位表示一个页面是否有空闲空间
+  std::atomic<int>                         page_count_{0};   // 数据文件的页面个数，超过的位都是0
+};
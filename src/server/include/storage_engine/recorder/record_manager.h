@@ -1,6 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <vector>
+
 #include "include/storage_engine/buffer/buffer_pool.h"
+#include "include/storage_engine/recorder/free_space_map.h"
 #include "include/storage_engine/recorder/record.h"
 #include "include/storage_engine/recorder/condition_filter.h"
 #include "common/lang/bitmap.h"
@@ -26,9 +30,11 @@ class Table;
  * 如何标识一个记录，或者定位一个记录？
  * 使用RID，即record identifier。使用 page num 表示所在的页面，slot num 表示当前在页面中的位置。
  * 因为这里的记录都是定长的，所以根据slot num 可以直接计算出记录的起始位置。
- * 问题1：那么如果记录不是定长的，还能使用 slot num 吗？
- * 问题2：如何更有效地存放不定长数据呢？
- * 问题3：如果一个页面不能存放一个记录，那么怎么组织记录存放效果更好呢？
+ * 不定长的记录(比如有TEXTS字段的表)使用另一种页面格式(slotted page)：页头后面是槽位目录，
+ * 每个槽位记录一条记录在页面中的偏移和长度，记录从页面末尾向前存放。slot num 仍然是槽位的编号，
+ * 记录在页面内移动(压缩空洞)时只需要修改槽位，RID 不变。
+ * 一个页面放不下的长数据存放在溢出页面(overflow page)上，多个溢出页面组成一个链表。
+ * 页面类型记录在页头的同一个位置，参考 SlottedPageHeader。
  *
  * 按照上面的描述，这里提供了几个类，分别是：
  * - RecordFileHandler：管理整个文件/表的记录增删改查
@@ -36,13 +42,14 @@ class Table;
  * - RecordFileScanner：可以用来遍历整个文件上的所有记录
  * - RecordPageIterator：可以用来遍历指定页面上的所有记录
  * - PageHeader：每个页面上都会记录的页面头信息
+ * - SlottedPageHeader：变长记录页面的页面头信息
+ * - OverflowPageHeader：溢出页面的页面头信息
  */
 
 /**
  * @brief 数据文件，按照页面来组织，每一页都存放一些记录/数据行
  * @details 每一页都有一个这样的页头，虽然看起来浪费，但是现在就简单的这么做
- * 从这个页头描述的信息来看，当前仅支持定长行/记录。
- * 如果要支持变长记录，或者超长（超出一页）的记录，这么做是不合适的。
+ * 这个页头只用于定长行/记录，变长记录使用 SlottedPageHeader，超长（超出一页）的数据使用 OverflowPageHeader。
  */
 struct PageHeader
 {
@@ -53,6 +60,49 @@ struct PageHeader
   int32_t first_record_offset;  // 第一条记录的偏移量
 };
 
+/**
+ * @brief 页面类型。定长记录页面在这个位置上是 PageHeader::record_size，总是正数
+ */
+static constexpr int32_t SLOTTED_PAGE  = -1;  // 变长记录页面
+static constexpr int32_t OVERFLOW_PAGE = -2;  // 溢出页面
+
+/**
+ * @brief 变长记录页面的页头
+ * @details 页面的组织：
+ * @code
+ * | SlottedPageHeader | slot0 | slot1 | ... | slotN | -> 空闲空间 <- | recordN | ... | record1 | record0 |
+ * @endcode
+ * 删除记录只把槽位清空，留下的空洞记在 garbage_size 中，插入时剩余的连续空间不够才压缩整个页面。
+ */
+struct SlottedPageHeader
+{
+  int32_t record_num;       // 当前页面记录的个数
+  int32_t slot_num;         // 槽位目录的长度，包括已经删除的空槽位
+  int32_t page_type;        // 总是 SLOTTED_PAGE，与 PageHeader::record_size 位置相同
+  int32_t min_record_size;  // 记录的最小长度(定长部分)，剩余空间放不下这么大的记录时认为页面已满
+  int32_t free_end;         // 记录区的起始偏移，也就是空闲空间的结尾
+  int32_t garbage_size;     // 删除记录留下的空洞大小
+};
+
+/**
+ * @brief 变长记录页面上的槽位
+ */
+struct RecordSlot
+{
+  uint16_t offset;  // 记录在页面中的偏移，0表示空槽位
+  uint16_t length;  // 记录的实际长度
+};
+
+/**
+ * @brief 溢出页面的页头，后面紧跟着数据
+ */
+struct OverflowPageHeader
+{
+  int32_t data_len;   // 当前页面上的数据长度
+  PageNum next_page;  // 下一个溢出页面，最后一个是 BP_INVALID_PAGE_NUM
+  int32_t page_type;  // 总是 OVERFLOW_PAGE，与 PageHeader::record_size 位置相同
+};
+
 /**
  * @brief 遍历一个页面中每条记录的iterator
  * @ingroup RecordManager
@@ -91,19 +141,19 @@ public:
 private:
   RecordPageHandler *record_page_handler_ = nullptr;
   PageNum            page_num_            = BP_INVALID_PAGE_NUM;
-  common::Bitmap     bitmap_;             // bitmap 的相关信息可以参考 RecordPageHandler 的说明
   SlotNum            next_slot_num_ = 0;  // 当前遍历到了哪一个slot
 };
 
 /**
  * @brief 负责处理一个页面中各种操作，比如插入记录、删除记录或者查找记录
  * @ingroup RecordManager
- * @details 当前定长记录模式下每个页面的组织大概是这样的：
+ * @details 定长记录模式下每个页面的组织大概是这样的：
  * @code
  * | PageHeader | record allocate bitmap |
  * |------------|------------------------|
  * | record1 | record2 | ..... | recordN |
  * @endcode
+ * 变长记录页面参考 SlottedPageHeader。溢出页面上没有记录，遍历时直接跳过，不能插入。
  */
 class RecordPageHandler
 {
@@ -116,9 +166,10 @@ public:
    *
    * @param buffer_pool 关联某个文件时，都通过buffer pool来做读写文件
    * @param page_num    当前处理哪个页面
-   * @param readonly    是否只读。在访问页面时，需要对页面加锁
+   * @param readonly    是否只读。只读时对页面加读锁，否则加写锁，cleanup 时释放
+   * @param wait        页面锁被其它线程持有时是否等待。不等待时返回 LOCKED_CONCURRENCY_CONFLICT，只用于加写锁
    */
-  RC init(FileBufferPool &buffer_pool, PageNum page_num, bool readonly);
+  RC init(FileBufferPool &buffer_pool, PageNum page_num, bool readonly, bool wait = true);
 
   /**
    * @brief 数据库恢复时，与普通的运行场景有所不同，不做任何并发操作，也不需要加锁
@@ -137,6 +188,13 @@ public:
    */
   RC init_empty_page(FileBufferPool &buffer_pool, PageNum page_num, int record_size);
 
+  /**
+   * @brief 把一个新的页面初始化成变长记录页面
+   *
+   * @param min_record_size 记录的最小长度
+   */
+  RC init_empty_slotted_page(FileBufferPool &buffer_pool, PageNum page_num, int min_record_size);
+
   /**
    * @brief 操作结束后做的清理工作，比如释放页面、解锁
    */
@@ -150,13 +208,21 @@ public:
    */
   RC insert_record(const char *data, RID *rid);
 
+  /**
+   * @brief 插入一条记录，变长记录页面使用
+   * @details 定长记录页面忽略 record_len。剩余空间不够时返回 RC::RECORD_NOMEM
+   * @param record_len 记录的长度
+   */
+  RC insert_record(const char *data, int record_len, RID *rid);
+
   /**
    * @brief 数据库恢复时，在指定位置插入数据
    * 
-   * @param data 要插入的数据行
-   * @param rid  插入的位置
+   * @param data       要插入的数据行
+   * @param record_len 数据行的长度，定长记录页面忽略
+   * @param rid        插入的位置
    */
-  RC recover_insert_record(const char *data, const RID &rid);
+  RC recover_insert_record(const char *data, int record_len, const RID &rid);
 
   /**
    * @brief 删除指定的记录
@@ -183,6 +249,38 @@ public:
    */
   bool is_full() const;
 
+  /**
+   * @brief 当前页面是否还能插入一条长度为 record_len 的记录，必要时需要压缩页面
+   */
+  bool has_space(int record_len) const;
+
+  /**
+   * @brief 页面上最多可以存放多少条记录。变长记录页面返回当前槽位的个数
+   */
+  int record_capacity() const;
+
+  /**
+   * @brief 页面上当前的记录个数，溢出页面上没有记录
+   */
+  int record_num() const;
+
+  /**
+   * @brief 从 slot_num 开始找到下一个有记录的槽位，没有时返回-1
+   */
+  SlotNum next_record_slot(SlotNum slot_num) const;
+
+  bool is_slotted() const { return page_header_->record_size == SLOTTED_PAGE; }
+  bool is_overflow() const { return page_header_->record_size == OVERFLOW_PAGE; }
+
+  /**
+   * @brief 直接在页面内存上批量过滤所有的槽位
+   * @details 结果写到 bitmap 中，长度至少是 (record_capacity + 7) / 8，槽位上有记录并且满足条件时对应的位为1。
+   * 过滤条件不支持批量过滤时返回 RC::UNIMPLENMENT，需要逐条过滤
+   * @param filter 过滤条件
+   * @param bitmap 过滤结果
+   */
+  RC filter_records(const ConditionFilter &filter, char *bitmap) const;
+
 protected:
   /**
    * @details 
@@ -206,13 +304,38 @@ protected:
    */
   char *get_record_data(SlotNum slot_num)
   {
+    if (is_slotted()) {
+      return frame_->data() + slots()[slot_num].offset;
+    }
     return frame_->data() + page_header_->first_record_offset + (page_header_->record_size * slot_num);
   }
 
+  /**
+   * @brief 获取指定槽位的记录长度
+   */
+  int get_record_len(SlotNum slot_num) const
+  {
+    return is_slotted() ? slots()[slot_num].length : page_header_->record_real_size;
+  }
+
+  SlottedPageHeader *slotted_header() const { return reinterpret_cast<SlottedPageHeader *>(page_header_); }
+  RecordSlot *slots() const { return reinterpret_cast<RecordSlot *>(frame_->data() + sizeof(SlottedPageHeader)); }
+
+  /**
+   * @brief 把变长记录页面上所有的记录移动到页面末尾，合并删除记录留下的空洞
+   */
+  void compact();
+
+  /**
+   * @brief 在变长记录页面的指定槽位上写入记录，调用前需要保证空间足够并且槽位是空的
+   */
+  void insert_slotted_record(SlotNum slot_num, const char *data, int record_len);
+
 protected:
   FileBufferPool *file_buffer_pool_ = nullptr;  // 当前操作的buffer pool(文件)
   Frame          *frame_            = nullptr;  // 当前操作页面关联的frame
   bool            readonly_         = false;    // 当前的操作是否都是只读的
+  bool            latched_          = false;    // 是否对页面加了锁，恢复时不加锁
   PageHeader     *page_header_      = nullptr;  // 当前页面上页面头
   char           *bitmap_           = nullptr;  // 当前页面上record分配状态信息bitmap内存起始位置
 
@@ -234,8 +357,10 @@ public:
    * @brief 初始化
    *
    * @param buffer_pool 当前操作的是哪个文件
+   * @param fsm_file    空闲空间表文件，为空时每次打开都要扫描所有页面
+   * @param min_record_size 大于0时记录是变长的，表示记录的最小长度，新页面都是变长记录页面
    */
-  RC init(FileBufferPool *buffer_pool);
+  RC init(FileBufferPool *buffer_pool, const char *fsm_file = nullptr, int min_record_size = 0);
 
   /**
    * @brief 关闭，做一些资源清理的工作
@@ -258,6 +383,16 @@ public:
    */
   RC insert_record(const char *data, int record_size, RID *rid);
 
+  /**
+   * @brief 批量插入记录，拿到一个页面的写锁以后一直插入到页面满，再换下一个页面
+   *
+   * @param data        紧密排列的 record_num 条记录
+   * @param record_num  记录条数
+   * @param record_size 记录大小
+   * @param rids        返回每条记录的标识符，至少有 record_num 个元素
+   */
+  RC insert_records(const char *data, int record_num, int record_size, RID *rids);
+
    /**
    * @brief 数据库恢复时，在指定文件指定位置插入数据
    * 
@@ -288,24 +423,97 @@ public:
    */
   RC visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor);
 
+  /**
+   * @brief 有空闲空间的页面个数
+   */
+  int free_page_count() const { return free_space_map_.free_page_count(); }
+
+  /**
+   * @brief 文件中所有记录的个数
+   * @details 只读取每个页面头中的记录个数，不访问记录本身
+   */
+  RC record_count(int64_t &count);
+
+  /**
+   * @brief 把一段数据写到新分配的溢出页面链表上
+   * @details 一个页面放不下的数据(比如长文本)使用，每个溢出页面只属于一个数据
+   * @param first_page 返回链表的第一个页面
+   */
+  RC insert_overflow(const char *data, int len, PageNum *first_page);
+
+  /**
+   * @brief 读取溢出页面链表上的数据
+   * @param len  数据的长度，data 至少有这么大
+   */
+  RC read_overflow(PageNum first_page, int len, char *data);
+
+  /**
+   * @brief 释放溢出页面链表
+   * @details 释放的页面变成空的变长记录页面，可以用来插入记录
+   */
+  RC delete_overflow(PageNum first_page);
+
 private:
   /**
-   * @brief 初始化当前没有填满记录的页面，初始化free_pages_成员
-   * 遍历当前文件上所有页面，找到没有满的页面 这个效率很低，会降低启动速度
+   * @brief 空闲空间表文件不可用时，遍历当前文件上所有页面，找到没有满的页面
+   * 这个效率很低，会降低启动速度
    * NOTE: 由于是初始化时的动作，所以不需要加锁控制并发
    */
   RC init_free_pages();
 
+  /**
+   * @brief 找到一个没有填满的页面，没有就分配一个新页面，返回时 record_page_handler 持有该页面的写锁
+   * @details 页面同时在空闲空间表中被占用，用完以后要调用 release_insert_page
+   */
+  RC get_insert_page(RecordPageHandler &record_page_handler, int record_size);
+
+  /**
+   * @brief 释放页面锁，并把还有空闲位置的页面还给空闲空间表
+   */
+  void release_insert_page(RecordPageHandler &record_page_handler);
+
 private:
-  FileBufferPool             *file_buffer_pool_ = nullptr;
-  std::unordered_set<PageNum> free_pages_;  // 没有填充满的页面集合
-  common::Mutex               lock_;        // 未满page集合free_pages_的锁。当编译时增加-DCONCURRENCY=ON 选项时，才会真正的支持并发
+  FileBufferPool *file_buffer_pool_ = nullptr;
+  FreeSpaceMap    free_space_map_;       // 没有填充满的页面，查找时不加锁
+  int             min_record_size_ = 0;  // 变长记录的最小长度，0表示定长记录
+};
+
+/**
+ * @brief 把一个文件的页面切分成固定大小的页面范围(morsel)，分给多个扫描线程
+ * @ingroup RecordManager
+ * @details 多个 RecordFileScanner 共享一个分配器，每个扫描器扫描完一个范围就来领取下一个，
+ * 扫描快的线程自然会多领取一些，不需要事先把页面平均分给各个线程
+ */
+class PageRangeDispenser
+{
+public:
+  static constexpr int DEFAULT_RANGE_PAGES = 16;
+
+public:
+  PageRangeDispenser() = default;
+
+  /**
+   * @brief 准备分配[1, page_count)的页面，第0页是文件头
+   */
+  void init(PageNum page_count, int range_pages = DEFAULT_RANGE_PAGES);
+
+  /**
+   * @brief 领取下一个页面范围[begin, end)，页面都已经分配完时返回false
+   * @details 多个线程可以同时调用
+   */
+  bool next(PageNum &begin, PageNum &end);
+
+private:
+  PageNum              page_count_  = 0;
+  int                  range_pages_ = DEFAULT_RANGE_PAGES;
+  std::atomic<PageNum> next_page_{1};
 };
 
 /**
  * @brief 遍历某个文件中所有记录
  * @ingroup RecordManager
- * @details 遍历所有的页面，同时访问这些页面中所有的记录
+ * @details 遍历所有的页面，同时访问这些页面中所有的记录。
+ * 指定了 PageRangeDispenser 时只遍历从中领取到的页面范围，多个扫描器一起遍历整个文件
  */
 class RecordFileScanner
 {
@@ -321,8 +529,10 @@ public:
    * @param readonly         当前是否只读操作。访问数据时，需要对页面加锁。比如
    *                         删除时也需要遍历找到数据，然后删除，这时就需要加写锁
    * @param condition_filter 做一些初步过滤操作
+   * @param page_ranges      与其它扫描器共享的页面范围分配器，为空时遍历所有页面
    */
-  RC open_scan(Table *table, FileBufferPool &buffer_pool, Trx *trx, bool readonly, ConditionFilter *condition_filter);
+  RC open_scan(Table *table, FileBufferPool &buffer_pool, Trx *trx, bool readonly, ConditionFilter *condition_filter,
+      PageRangeDispenser *page_ranges = nullptr);
 
   /**
    * @brief 关闭一个文件扫描，释放相应的资源
@@ -355,6 +565,22 @@ private:
    */
   RC fetch_next_record_in_page();
 
+  /**
+   * @brief 扫描到page_num时，根据需要提交后面页面的预读请求
+   * @details 扫描推进到上一个预读窗口的一半时就提交下一个窗口，窗口从READ_AHEAD_MIN_PAGES开始
+   * 每次翻倍，直到READ_AHEAD_MAX_PAGES。这样扫描线程访问到的页面大多已经在缓冲池中了
+   */
+  void read_ahead(PageNum page_num);
+
+  /**
+   * @brief 从 page_ranges_ 领取下一个页面范围，重新开始遍历页面
+   */
+  bool next_page_range();
+
+private:
+  static constexpr int READ_AHEAD_MIN_PAGES = 4;
+  static constexpr int READ_AHEAD_MAX_PAGES = 32;
+
 private:
   // TODO 对于一个纯粹的record遍历器来说，不应该关心表和事务
   Table             *table_            = nullptr;  // 当前遍历的是哪张表。这个字段仅供事务函数使用，如果设计合适，可以去掉
@@ -363,8 +589,17 @@ private:
   bool               readonly_         = false;    // 遍历出来的数据，是否可能对它做修改
 
   BufferPoolIterator bp_iterator_;                 // 遍历buffer pool的所有页面
+  PageRangeDispenser *page_ranges_     = nullptr;  // 多个扫描器共享的页面范围，为空时遍历所有页面
+  PageNum            range_end_        = -1;       // 当前页面范围的结尾，预读不超过这里
   ConditionFilter   *condition_filter_ = nullptr;  // 过滤record
   RecordPageHandler  record_page_handler_;         // 处理文件某页面的记录
   RecordPageIterator record_page_iterator_;        // 遍历某个页面上的所有record
   Record             next_record_;                 // 获取的记录放在这里缓存起来
+
+  std::vector<char>  page_filter_bitmap_;          // 当前页面批量过滤的结果
+  bool               page_filtered_ = false;       // 当前页面是否已经批量过滤过，否则要逐条过滤
+
+  int                read_ahead_window_  = 0;      // 当前预读窗口的大小
+  PageNum            read_ahead_next_    = 0;      // 下一个还没有提交预读的页面
+  PageNum            read_ahead_trigger_ = 0;      // 扫描到这个页面时提交下一次预读
 };
\ No newline at end of file
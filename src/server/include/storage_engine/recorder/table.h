@@ -9,9 +9,27 @@
 #include "include/storage_engine/recorder/record.h"
 
 class RecordFileScanner;
+class PageRangeDispenser;
+class ConditionFilter;
 class RecordFileHandler;
 class Index;
 
+/**
+ * @brief 变长记录中 TEXTS 字段的内容
+ * @details 记录的定长部分只保存这个结构。短文本放在记录的末尾，长文本放在单独的TOAST文件中，
+ * 在TOAST文件中是一条记录或者一个溢出页面链表。
+ */
+struct TextRef
+{
+  int32_t length;      // 文本的长度
+  int32_t offset;      // 文本在记录中的偏移，放在TOAST文件中时无效
+  PageNum toast_page;  // 文本在TOAST文件中的位置，文本在记录中时是 BP_INVALID_PAGE_NUM
+  SlotNum toast_slot;  // 文本在TOAST文件中的槽位，-1表示toast_page是溢出页面链表的第一个页面
+
+  bool toasted() const { return toast_page != BP_INVALID_PAGE_NUM; }
+};
+static_assert(sizeof(TextRef) == MAX_TEXT_VALUE_LENGTH_IN_RECORD, "text field length mismatch");
+
 /**
  * @brief 表
  */
@@ -68,27 +86,82 @@ public:
   /**
    * @brief 根据给定的字段生成一个记录/行
    * @details 通常是由用户传过来的字段，按照schema信息组装成一个record。
+   * 有TEXTS字段时生成变长记录，文本依次放在定长部分的后面。
    * @param value_num 字段的个数
    * @param values    每个字段的值
    * @param record    生成的记录数据
    */
   RC make_record(int value_num, const Value *values, Record &record);
 
+  /**
+   * @brief 与上面的 make_record 相同，但是把记录写到调用者提供的内存中，不申请内存
+   * @param record_data 至少有 record_size 字节，并且已经清零
+   * @note 不处理TEXTS字段的内容，变长记录要使用上面的版本
+   */
+  RC make_record(int value_num, const Value *values, char *record_data) const;
+
   /**
    * @brief 在当前的表中插入一条记录
    * @details 在表文件和索引中插入关联数据。这里只管在表中插入数据，不关心事务相关操作。
    * @param record[in/out] 传入的数据包含具体的数据，插入成功会通过此字段返回RID
    */
   RC insert_record(Record &record);
-  RC delete_record(const Record &record);
+
+  /**
+   * @brief 在当前的表中删除一条记录，同时删除它的索引项
+   * @param stale_index_key 索引项中的事务字段可能与记录中的不同(比如回收已提交删除的记录时)，这时按照RID查找索引项
+   */
+  RC delete_record(const Record &record, bool stale_index_key = false);
   RC visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor);
   RC get_record(const RID &rid, Record &record);
 
+  /**
+   * @brief 读取记录中 TEXTS 字段的内容，文本在TOAST文件中时从TOAST文件读取
+   * @param field 非空的TEXTS字段
+   */
+  RC get_text(const Record &record, const FieldMeta &field, Value &value) const;
+
   RC recover_insert_record(Record &record);
 
-  RC create_index(Trx *trx, std::vector<const FieldMeta *> &multi_field_metas, const char *index_name, bool is_unique);
+  /**
+   * @brief 批量插入多条记录，导入数据时使用
+   * @details 只写数据页面，一个页面写满以后再换下一个页面。不插入索引项，全部数据写完以后
+   * 由调用者用 insert_entries_of_indexes 统一处理。
+   * @param data 紧密排列的 record_num 条记录
+   * @param rids[out] 返回每条记录的位置
+   */
+  RC insert_records(const char *data, int record_num, RID *rids);
 
-  RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly);
+  /**
+   * @brief 与上面的 insert_records 相同，用于变长记录，逐条写入数据页面
+   */
+  RC insert_records(std::vector<Record> &records, RID *rids);
+
+  /**
+   * @brief 为已经插入到数据页面中的记录批量插入索引项
+   * @details 空索引按照记录自底向上构建，非空索引逐条插入
+   */
+  RC insert_entries_of_indexes(const std::vector<RID> &rids);
+
+  RC create_index(Trx *trx, std::vector<const FieldMeta *> &multi_field_metas, const char *index_name, bool is_unique,
+                  bool key_compressed = false);
+
+  /**
+   * @param page_ranges 多个扫描器并行扫描时共享的页面范围分配器，为空时扫描所有页面
+   * @param condition_filter 扫描器在页面上直接过滤记录的条件，为空时返回所有记录
+   */
+  RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly, PageRangeDispenser *page_ranges = nullptr,
+                        ConditionFilter *condition_filter = nullptr);
+
+  /**
+   * @brief 数据文件的页面个数，包括文件头和没有分配的页面
+   */
+  int data_page_count() const;
+
+  /**
+   * @brief 表中所有记录的个数，不考虑事务的可见性
+   */
+  RC count_records(int64_t &count);
 
   RecordFileHandler *record_handler() const
   {
@@ -110,12 +183,35 @@ public:
 
 private:
   RC insert_entry_of_indexes(const char *record, const RID &rid);
-  RC delete_entry_of_indexes(const char *record, const RID &rid, bool error_on_not_exists);
+  RC delete_entry_of_indexes(const char *record, const RID &rid, bool error_on_not_exists, bool by_rid = false);
 
 private:
   RC init_record_handler(const char *base_dir);
   RC change_record_value(char *&record, int idx, const Value &value) const;
 
+  RC init_toast_handler(const char *base_dir);
+
+  /**
+   * @brief 把记录中的长文本放到TOAST文件中
+   * @details 超过 MAX_INLINE_TEXT_SIZE 的文本都放到TOAST文件中。记录仍然超过 MAX_INLINE_RECORD_SIZE 时，
+   * 再从最长的文本开始移走，直到记录足够短
+   */
+  RC toast_texts(Record &record);
+
+  /**
+   * @brief 记录中放在TOAST文件中的文本
+   */
+  void toasted_texts_of(const Record &record, std::vector<TextRef> &refs) const;
+  RC delete_toasted_texts(const std::vector<TextRef> &refs);
+
+private:
+  // 变长记录在页面内的最大长度，保证一个页面至少能放下几条记录
+  static constexpr int MAX_INLINE_RECORD_SIZE = BP_PAGE_DATA_SIZE / 4;
+  // 更长的文本放到TOAST文件中，只访问其它字段时不需要读取
+  static constexpr int MAX_INLINE_TEXT_SIZE = 128;
+  // TOAST文件中不超过这个长度的文本作为一条记录存放，更长的文本使用溢出页面
+  static constexpr int MAX_TOAST_RECORD_SIZE = BP_PAGE_DATA_SIZE / 2;
+
 public:
   Index *find_index(const char *index_name) const;
   Index *find_index_by_field(const char *field_name) const;
@@ -125,5 +221,7 @@ private:
   TableMeta   table_meta_;
   FileBufferPool *data_buffer_pool_ = nullptr;   /// 数据文件关联的buffer pool
   RecordFileHandler *record_handler_ = nullptr;  /// 记录操作
+  FileBufferPool *toast_buffer_pool_ = nullptr;  /// TOAST文件关联的buffer pool，只有变长记录的表才有
+  RecordFileHandler *toast_handler_ = nullptr;   /// TOAST文件中长文本的存取
   std::vector<Index *> indexes_;
 };
@@ -54,6 +54,11 @@ public:
 
   int record_size() const;
 
+  /**
+   * @brief 记录是否是变长的。有TEXTS字段时，record_size 只是记录定长部分的大小
+   */
+  bool variable_length() const;
+
   const bool is_view() const { return is_view_; }
   const char *origin_table_name() const { return origin_table_name_.c_str(); }
   SelectStmt *select_stmt() { return select_stmt_; }
@@ -6,6 +6,7 @@
 #include <string>
 #include <fcntl.h>
 
+#include "include/common/setting.h"
 #include "include/storage_engine/recover/log_entry.h"
 #include "common/io/io.h"
 #include "common/lang/mutex.h"
@@ -16,6 +17,9 @@ class LogFile;
  * @brief 缓存运行时产生的日志项
  * @details 当前的实现非常简单，没有像其它数据库一样，将日志序列化成二进制buffer，
  * 这里仅仅把日志项存储到到链表中。如果日志数量超过某个阈值，就会调用flush_buffer将日志刷新到磁盘中。
+ *
+ * 每条日志项的LSN是它写入日志文件后结束位置的文件偏移量，所以LSN小于等于flushed_lsn的日志都已经落盘，
+ * 也可以直接用LSN定位日志文件中的位置。
  */
 class LogBuffer
 {
@@ -23,16 +27,37 @@ public:
   LogBuffer() {}
   ~LogBuffer() {}
 
+  /**
+   * @brief 设置起始LSN，也就是日志文件当前的大小
+   */
+  void init(LSN start_lsn);
+
   /**
    * @brief 在缓存中增加一条日志项
+   * @param lsn 返回这条日志项的LSN
    */
-  RC append_log_entry(LogEntry *log_entry);
+  RC append_log_entry(LogEntry *log_entry, LSN *lsn = nullptr);
 
   /**
    * @brief 将当前缓存的日志项都刷新到日志文件中
    */
   RC flush_buffer(LogFile &log_file);
 
+  /**
+   * @brief 最后一条日志项的LSN，不管是否落盘
+   */
+  LSN current_lsn() const { return current_lsn_.load(); }
+
+  /**
+   * @brief 已经落盘的日志的LSN
+   */
+  LSN flushed_lsn() const { return flushed_lsn_.load(); }
+
+  /**
+   * @brief 一条日志项写入到日志文件中占用的长度
+   */
+  static int32_t entry_size(const LogEntry &log_entry) { return sizeof(LogEntryHeader) + log_entry.log_entry_len(); }
+
 private:
   /**
    * @brief 将日志记录写入到日志文件中
@@ -45,6 +70,9 @@ private:
   common::Mutex lock_;  // 加锁支持多线程并发写入
   std::deque<std::unique_ptr<LogEntry>> log_entrys_;  // 当前等待刷盘的日志项
   std::atomic_int32_t total_size_;  // 当前缓存中的日志项的总大小
+  std::atomic<LSN> current_lsn_{0};  // 最后一条进入缓存的日志项的LSN
+  LSN written_lsn_ = 0;  // 已经写入日志文件但还没有sync的位置，在lock_的保护下修改
+  std::atomic<LSN> flushed_lsn_{0};  // 已经sync到磁盘的位置
 };
 
 /**
@@ -88,6 +116,16 @@ public:
    */
   RC offset(int64_t &off) const;
 
+  /**
+   * @brief 设置读取的位置，恢复时从checkpoint的位置开始读
+   */
+  RC seek(int64_t off);
+
+  /**
+   * @brief 获取日志文件的大小
+   */
+  RC size(int64_t &file_size) const;
+
   /**
    * @brief 当前是否已经读取到文件尾
    */
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
 #include "include/storage_engine/recover/log_file.h"
 #include "include/common/global_context.h"
 
@@ -52,6 +58,7 @@ public:
   RC append_rollback_trx_log(int32_t trx_id);
   /**
    * @brief 提交一个事务
+   * @details 提交日志落盘后才返回。并发提交的事务通过组提交共享一次刷盘，见 group_sync
    */
   RC append_commit_trx_log(int32_t trx_id, int32_t commit_xid);
 
@@ -69,13 +76,64 @@ public:
    */
   RC sync();
 
+  /**
+   * @brief 保证LSN小于等于lsn的日志都已经落盘
+   */
+  RC sync_to(LSN lsn);
+
+  /**
+   * @brief 设置组提交的等待时间
+   * @details 有其它事务也在提交时，负责刷盘的线程先等待这么长时间，让更多的提交日志进入同一批。
+   * 增加单个事务的提交延迟，换取更少的fsync次数。默认为0，即不等待
+   */
+  void set_group_commit_delay(std::chrono::microseconds delay) { group_commit_delay_us_ = delay.count(); }
+  LSN current_lsn() const { return log_buffer_->current_lsn(); }
+  LSN flushed_lsn() const { return log_buffer_->flushed_lsn(); }
+
+  /**
+   * @brief 计算checkpoint之后恢复时需要从哪里开始重做
+   * @details 当前活跃事务中最早的开始日志的位置；没有活跃事务时就是当前日志的结束位置。
+   * 在这之前的日志所属的事务都已经结束，只要在这之后把所有脏页刷盘，恢复时就不再需要它们。
+   * 需要在刷脏页之前调用
+   */
+  LSN checkpoint_lsn();
+
+  /**
+   * @brief 记录checkpoint的位置
+   * @details 写入到日志目录下的checkpoint文件中，先写临时文件再rename，保证不会读到写了一半的文件
+   */
+  RC write_checkpoint(LSN lsn);
+
+  /**
+   * @brief 读取最近一次checkpoint的位置，没有checkpoint时返回0
+   */
+  RC read_checkpoint(LSN &lsn);
+
   /**
    * @brief 重做
-   * @details 当前会重做所有日志。也就是说，所有buffer pool页面都不会写入到磁盘中，
-   * 否则可能无法恢复成功。
+   * @details 从最近一次checkpoint记录的位置开始重做日志。
+   * checkpoint之前所有的脏页都已经刷盘，它们对应的日志不再需要重做。
    */
   RC recover(Db *db);
+private:
+  /**
+   * @brief 组提交，等待LSN小于等于lsn的日志落盘
+   * @details 同一时间只有一个线程（leader）在刷日志，它会把缓存中所有的日志都写入文件并sync一次。
+   * 其它线程等待leader完成，如果自己的日志已经包含在这一批中就直接返回，否则再选出新的leader刷下一批。
+   */
+  RC group_sync(LSN lsn);
+
 private:
   LogBuffer *log_buffer_ = nullptr;  // 日志缓存。新增日志时先放到这个buffer中
   LogFile *log_file_ = nullptr;  // 管理日志，比如读写日志
+  std::string checkpoint_file_;  // 记录checkpoint位置的文件
+
+  common::Mutex active_trx_lock_;
+  std::map<int32_t, LSN> active_trx_begin_lsn_;  // 活跃事务的开始日志在日志文件中的起始位置
+
+  std::mutex              group_lock_;
+  std::condition_variable group_cond_;  // 一批日志刷盘完成时通知等待的线程
+  bool                    group_flushing_ = false;  // 是否已经有线程在刷日志
+  std::atomic_int32_t     committing_num_{0};  // 正在提交的事务个数，只有一个时没有必要等待
+  std::atomic_int64_t     group_commit_delay_us_{0};
 };
\ No newline at end of file
@@ -3,8 +3,11 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -56,13 +59,45 @@ public:
 
   RC sync();
 
+  /**
+   * @brief 做一次checkpoint
+   * @details 先记下恢复时需要开始重做的位置，然后刷日志、把缓冲池中所有的脏页刷盘，最后记录checkpoint位置。
+   * 之后恢复时只需要从这个位置开始重做
+   */
+  RC checkpoint();
+
   RC recover();
 
+  /**
+   * @brief 回收表中已经被删除、并且所有活跃事务都不会再看到的记录
+   * @param table      要回收的表，为空时回收所有的表
+   * @param record_num 返回一共回收了多少条记录
+   */
+  RC vacuum(Table *table, int &record_num);
+
   LogManager *log_manager();
 
 private:
   RC open_all_tables();
 
+  /**
+   * @brief 后台线程周期性地做checkpoint，只有在CONCURRENCY编译模式下才会启动
+   */
+  void start_checkpointer();
+  void stop_checkpointer();
+  void checkpoint_loop();
+
+  /**
+   * @brief 后台线程周期性地回收所有表中的已删除记录，只有在CONCURRENCY编译模式下才会启动
+   */
+  void start_vacuumer();
+  void stop_vacuumer();
+  void vacuum_loop();
+
+private:
+  static constexpr int CHECKPOINT_INTERVAL_SEC = 30;  // 两次checkpoint之间的间隔
+  static constexpr int VACUUM_INTERVAL_SEC     = 10;  // 两次后台回收之间的间隔
+
 private:
   std::string name_;
   std::string path_;
@@ -71,4 +106,16 @@ private:
 
   /// 给每个table都分配一个ID，用来记录日志。这里假设所有的DDL都不会并发操作，所以相关的数据都不上锁
   int32_t next_table_id_ = 0;
+
+  std::thread             checkpoint_thread_;
+  std::mutex              checkpoint_lock_;
+  std::condition_variable checkpoint_cond_;
+  bool                    checkpoint_running_ = false;
+
+  /// 后台回收线程会遍历所有的表，与建表、删表互斥
+  std::mutex              vacuum_lock_;
+  std::thread             vacuum_thread_;
+  std::mutex              vacuum_thread_lock_;
+  std::condition_variable vacuum_cond_;
+  bool                    vacuum_running_ = false;
 };
@@ -7,7 +7,12 @@ static constexpr const char *TABLE_META_SUFFIX = ".table";
 static constexpr const char *TABLE_META_FILE_PATTERN = ".*\\.table$";
 static constexpr const char *TABLE_DATA_SUFFIX = ".data";
 static constexpr const char *TABLE_INDEX_SUFFIX = ".index";
+static constexpr const char *TABLE_FSM_SUFFIX = ".fsm";
+static constexpr const char *TABLE_TOAST_SUFFIX = ".toast";
 
 std::string table_meta_file(const char *base_dir, const char *table_name);
 std::string table_data_file(const char *base_dir, const char *table_name);
 std::string table_index_file(const char *base_dir, const char *table_name, const char *index_name);
+std::string table_fsm_file(const char *base_dir, const char *table_name);
+std::string table_toast_file(const char *base_dir, const char *table_name);
+std::string table_toast_fsm_file(const char *base_dir, const char *table_name);
@@ -1,7 +1,47 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
 #include "include/storage_engine/transaction/trx.h"
 
+class MvccTrx;
+
+/**
+ * @brief 事务开始时的快照，判断某个事务号的修改对持有快照的事务是否可见
+ * @details 记录上的事务号是已提交事务的提交号，快照中记录了开始时已经分配出去但还没有结束的事务号和提交号。
+ * 小于 xmin 的都已经结束，不小于 xmax 的在快照之后才分配，中间的在 active_xids 中二分查找。
+ * 快照创建以后不再修改，判断可见性时不需要加锁
+ */
+class MvccSnapshot
+{
+public:
+  /**
+   * @brief 提交号为 xid 的修改是否在快照创建之前就已经完整提交
+   */
+  bool committed(int32_t xid) const
+  {
+    if (xid < xmin_) {
+      return true;
+    }
+    if (xid >= xmax_) {
+      return false;
+    }
+    return !std::binary_search(active_xids_.begin(), active_xids_.end(), xid);
+  }
+
+  int32_t xmin() const { return xmin_; }
+  int32_t xmax() const { return xmax_; }
+
+private:
+  friend class MvccTrxManager;
+
+  int32_t              xmin_ = std::numeric_limits<int32_t>::max();
+  int32_t              xmax_ = std::numeric_limits<int32_t>::max();
+  std::vector<int32_t> active_xids_;  // 有序
+};
+
 /**
 * @brief MVCC(多版本并发控制)事务管理器
  */
@@ -20,17 +60,49 @@ public:
   void all_trxes(std::vector<Trx *> &trxes) override;
   void destroy_trx(Trx *trx) override;
 
+  /**
+   * @brief 回收 end xid 小于 oldest_snapshot_xmin 的已提交删除的记录
+   * @details 先在不加写锁的情况下扫描出可以回收的记录，再逐条删除，删除前会重新检查
+   */
+  RC vacuum(Table *table, int &record_num) override;
+
   int32_t next_trx_id();
   int32_t max_trx_id() const;
 
+  /**
+   * @brief 开始一个事务：分配事务号、登记为活跃事务并创建快照
+   */
+  void start_trx(MvccTrx *trx);
+
+  /**
+   * @brief 分配提交号，在事务修改完所有记录之前，提交号一直是活跃的，其它事务的快照看不到这次提交
+   */
+  int32_t start_commit();
+
+  /**
+   * @brief 事务提交或回滚完成，从活跃事务中移除事务号和提交号
+   * @param commit_xid 回滚时没有提交号，传入 -1
+   */
+  void finish_trx(int32_t trx_id, int32_t commit_xid);
+
+  /**
+   * @brief 所有活跃事务的快照中最小的 xmin，没有活跃事务时是下一个要分配的事务号
+   * @details 提交号小于它的删除，对当前以及将来的所有快照都是已提交的，这样的记录可以回收
+   */
+  int32_t oldest_snapshot_xmin();
+
   // 在 recover 场景下使用，确保当前事务 id 不小于 trx_id
   void update_trx_id(int32_t trx_id);
 
+private:
+  void remove_active_xid(int32_t xid);
+
 private:
   std::vector<FieldMeta> fields_; // 存储事务数据需要用到的字段元数据，所有表结构都需要带
   std::atomic<int32_t> current_trx_id_{0};
   common::Mutex      lock_;
   std::vector<Trx *> trxes_;
+  std::vector<int32_t> active_xids_;  // 已经分配还没有结束的事务号和提交号，在 lock_ 保护下按顺序分配，所以是有序的
 };
 
 class MvccTrx : public Trx
@@ -64,6 +136,13 @@ class MvccTrx : public Trx
 
   int32_t id() const override { return trx_id_; }
 
+  /**
+   * @brief 事务是否已经开始并且还没有结束
+   */
+  bool started() const { return started_.load(); }
+
+  const MvccSnapshot &snapshot() const { return snapshot_; }
+
  private:
   /**
    * @brief 获取指定表上的与版本号相关的字段
@@ -83,12 +162,15 @@ class MvccTrx : public Trx
  private:
   static const int32_t MAX_TRX_ID = std::numeric_limits<int32_t>::max();
 
+  friend class MvccTrxManager;
+
  private:
   using OperationSet = std::unordered_set<Operation, OperationHasher, OperationEqualer>;
   MvccTrxManager & trx_kit_;
   LogManager *log_manager_ = nullptr;
   int32_t      trx_id_ = -1;
-  bool         started_ = false;
+  std::atomic<bool> started_{false};  // 后台回收线程也会读取
   bool         recovering_ = false;
+  MvccSnapshot snapshot_;  // 事务开始时创建，恢复时的事务认为所有提交都可见
   OperationSet operations_;
 };
@@ -129,6 +129,14 @@ public:
   virtual void all_trxes(std::vector<Trx *> &trxes) = 0;
   virtual void destroy_trx(Trx *trx) = 0;
 
+  /**
+   * @brief 回收表中已经被删除、并且所有活跃事务都不会再看到的记录
+   * @details 会同时删除这些记录的索引项，释放记录占用的空间
+   * @param table      要回收的表
+   * @param record_num 返回回收了多少条记录
+   */
+  virtual RC vacuum(Table *table, int &record_num) = 0;
+
 public:
   static TrxManager *create(const char *name);
   static RC init_global(const char *name);
@@ -18,6 +18,7 @@ public:
  Trx *find_trx(int32_t trx_id) override;
  void all_trxes(std::vector<Trx *> &trxes) override;
  void destroy_trx(Trx *trx) override;
+ RC vacuum(Table *table, int &record_num) override;
 };
 
 class VacuousTrx : public Trx
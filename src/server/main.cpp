@@ -1,6 +1,7 @@
 #include <netinet/in.h>
 #include <unistd.h>
 #include <iostream>
+#include <thread>
 
 #include "include/common/init.h"
 #include "include/common/setting.h"
@@ -25,6 +26,15 @@ void usage()
   std::cout << "-P: protocol. {plain(default), mysql, cli}." << std::endl;
   std::cout << "-t: transaction model. {vacuous(default), mvcc}." << std::endl;
   std::cout << "-n: buffer pool memory size in byte" << std::endl;
+  std::cout << "-T: number of worker threads handling requests. default is the number of cpu cores" << std::endl;
+  std::cout << "-S: memory size in byte used by a sort before spilling to temporary files" << std::endl;
+  std::cout << "-J: memory size in byte used by a hash join before spilling to temporary files" << std::endl;
+  std::cout << "-G: memory size in byte used by a GROUP BY before spilling to temporary files" << std::endl;
+  std::cout << "-F: percent of each page filled when CREATE INDEX builds an index from existing rows" << std::endl;
+  std::cout << "-K: compress keys of new indexes with common prefixes, as if every CREATE INDEX ended with COMPRESSED" << std::endl;
+  std::cout << "-L: number of threads parsing the file of LOAD DATA. default is the number of cpu cores" << std::endl;
+  std::cout << "-Q: number of threads scanning a table in parallel for an aggregation. default is the number of cpu cores"
+            << std::endl;
 }
 
 void parse_parameter(int argc, char **argv)
@@ -38,7 +48,7 @@ void parse_parameter(int argc, char **argv)
   // Process args
   int opt;
   extern char *optarg;
-  while ((opt = getopt(argc, argv, "dp:P:s:t:f:o:e:hn:")) > 0) {
+  while ((opt = getopt(argc, argv, "dp:P:s:t:f:o:e:hn:T:S:J:G:F:KL:Q:")) > 0) {
     switch (opt) {
       case 's':
         process_param->set_unix_socket_path(optarg);
@@ -64,6 +74,30 @@ void parse_parameter(int argc, char **argv)
       case 'n':
         process_param->set_buffer_pool_memory_size(atoi(optarg));
         break;
+      case 'T':
+        process_param->set_worker_thread_num(atoi(optarg));
+        break;
+      case 'S':
+        process_param->set_sort_memory_size(atoi(optarg));
+        break;
+      case 'J':
+        process_param->set_join_memory_size(atoi(optarg));
+        break;
+      case 'G':
+        process_param->set_group_memory_size(atoi(optarg));
+        break;
+      case 'F':
+        process_param->set_index_fill_factor(atoi(optarg));
+        break;
+      case 'K':
+        process_param->set_index_key_compressed(true);
+        break;
+      case 'L':
+        process_param->set_load_thread_num(atoi(optarg));
+        break;
+      case 'Q':
+        process_param->set_scan_thread_num(atoi(optarg));
+        break;
       case 'h':
         usage();
         exit(0);
@@ -126,6 +160,21 @@ Server *init_server()
     server_param.unix_socket_path = process_param->get_unix_socket_path();
   }
 
+#ifdef CONCURRENCY
+  if (process_param->worker_thread_num() > 0) {
+    server_param.worker_thread_num = process_param->worker_thread_num();
+  } else {
+    server_param.worker_thread_num = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+#else
+  // 没有开启 CONCURRENCY 时存储层的锁都是空操作，只能用一个工作线程
+  if (process_param->worker_thread_num() > 1) {
+    LOG_WARN("Multiple worker threads require CONCURRENCY, use 1 worker thread");
+  }
+  server_param.worker_thread_num = 1;
+#endif
+  LOG_INFO("Worker thread num: %d", server_param.worker_thread_num);
+
   Server *server = new Server(server_param);
   return server;
 }
@@ -33,6 +33,12 @@ RC CreateIndexStmt::create(Db *db, const CreateIndexSqlNode &create_index, Stmt
              db->name(), table_name, create_index.multi_attribute_names[i].c_str());
       return RC::SCHEMA_FIELD_NOT_EXIST;
     }
+    if (field_meta->type() == TEXTS) {
+      // 记录中只有文本的位置，不能作为索引的键值
+      LOG_WARN("cannot create index on text field. db=%s, table=%s, field name=%s",
+             db->name(), table_name, field_meta->name());
+      return RC::SCHEMA_FIELD_TYPE_MISMATCH;
+    }
     multi_field_metas.emplace_back(field_meta);
   }
 
@@ -46,7 +52,8 @@ RC CreateIndexStmt::create(Db *db, const CreateIndexSqlNode &create_index, Stmt
     return RC::SCHEMA_INDEX_NAME_REPEAT;
   }
 
-  stmt = new CreateIndexStmt(table, multi_field_metas, create_index.index_name, create_index.is_unique_);
+  stmt = new CreateIndexStmt(
+      table, multi_field_metas, create_index.index_name, create_index.is_unique_, create_index.key_compressed);
 
   return RC::SUCCESS;
 }
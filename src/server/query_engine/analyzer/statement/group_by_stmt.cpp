@@ -69,7 +69,9 @@ RC GroupByStmt::create_group_by_unit(
   }
 
   res_expr = new FieldExpr(table, field);
-  ((FieldExpr *) res_expr)->set_field_table_alias(table->name());
+  // 写了表名或者别名时与查询中的字段一致，否则就是表名
+  ((FieldExpr *) res_expr)->set_field_table_alias(
+      common::is_blank(unit.relation_name.c_str()) ? table->name() : unit.relation_name.c_str());
   res_expr->set_name(unit.attribute_name.c_str());
   res_expr->set_alias(unit.attribute_name.c_str());
   return RC::SUCCESS;
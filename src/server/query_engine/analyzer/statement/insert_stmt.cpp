@@ -97,21 +97,10 @@ RC InsertStmt::create(Db *db, const InsertSqlNode &inserts, Stmt *&stmt)
         continue;
       }
       if (field_type == TEXTS && value_type == CHARS) {
-        if (values[i].get_string().size() > 65535) {
+        if (values[i].get_string().size() > MAX_TEXT_LENGTH) {
           return RC::INVALID_ARGUMENT;
         }
-        std::hash<std::string> hashFunction;
-        std::size_t hashValue = hashFunction(values[i].get_string());
-        std::string value_search_for_text = std::string(table->dir()) + "/" + std::string(table_name) + std::to_string(hashValue) + ".text";
-        std::string value_stored_in_file = values[i].get_string();
-        std::ofstream outputFile(value_search_for_text);
-        if (outputFile.is_open()) {
-          outputFile << value_stored_in_file;
-          outputFile.close();
-        } else {
-          LOG_ERROR(" failed to write text value to file!");
-        }
-        values[i].set_text(value_search_for_text.c_str(), value_search_for_text.size());
+        values[i].set_text(values[i].get_string().c_str(), values[i].get_string().size());
         continue;
       }
       if (field_type != value_type) {  // TODO try to convert the value type to field type
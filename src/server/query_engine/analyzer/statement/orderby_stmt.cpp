@@ -20,7 +20,7 @@ RC OrderByStmt::create_order_unit(Db *db, Table *default_table, std::unordered_m
   return rc;
 }
 RC OrderByStmt::create(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
-    const std::vector<OrderByNode>& order_by_list, int order_by_num, OrderByStmt *&stmt)
+    const std::vector<OrderByNode>& order_by_list, int order_by_num, int limit, OrderByStmt *&stmt)
 {
   RC rc = RC::SUCCESS;
   stmt = nullptr;
@@ -36,6 +36,7 @@ RC OrderByStmt::create(Db *db, Table *default_table, std::unordered_map<std::str
     }
     tmp_stmt->order_units_.push_back(order_unit);
   }
+  tmp_stmt->limit_ = limit;
 
   stmt = tmp_stmt;
   return rc;
@@ -315,6 +315,7 @@ RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt)
       &table_map,
       select_sql.order_lists,
       static_cast<int>(select_sql.order_lists.size()),
+      select_sql.limit,
       order_stmt);
   if (rc != RC::SUCCESS) {
     LOG_WARN("cannot construct order by stmt");
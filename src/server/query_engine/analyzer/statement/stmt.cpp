@@ -15,6 +15,7 @@
 #include "include/query_engine/analyzer/statement/load_data_stmt.h"
 #include "include/query_engine/analyzer/statement/trx_begin_stmt.h"
 #include "include/query_engine/analyzer/statement/trx_end_stmt.h"
+#include "include/query_engine/analyzer/statement/vacuum_stmt.h"
 
 RC Stmt::create_stmt(Db *db, ParsedSqlNode &sql_node, Stmt *&stmt)
 {
@@ -73,6 +74,10 @@ RC Stmt::create_stmt(Db *db, ParsedSqlNode &sql_node, Stmt *&stmt)
       return TrxEndStmt::create(sql_node.flag, stmt);
     }
 
+    case SCF_VACUUM: {
+      return VacuumStmt::create(db, sql_node.vacuum, stmt);
+    }
+
     default: {
       LOG_INFO("Command::type %d doesn't need to create statement.", sql_node.flag);
     } break;
@@ -0,0 +1,18 @@
+#include "include/query_engine/analyzer/statement/vacuum_stmt.h"
+#include "common/log/log.h"
+#include "include/storage_engine/schema/database.h"
+
+RC VacuumStmt::create(Db *db, const VacuumSqlNode &vacuum, Stmt *&stmt)
+{
+  Table *table = nullptr;
+  if (!vacuum.relation_name.empty()) {
+    table = db->find_table(vacuum.relation_name.c_str());
+    if (nullptr == table) {
+      LOG_WARN("no such table. db=%s, table_name=%s", db->name(), vacuum.relation_name.c_str());
+      return RC::SCHEMA_TABLE_NOT_EXIST;
+    }
+  }
+
+  stmt = new VacuumStmt(table);
+  return RC::SUCCESS;
+}
@@ -11,6 +11,7 @@
 #include "include/query_engine/executor/load_data_executor.h"
 #include "include/query_engine/executor/trx_begin_executor.h"
 #include "include/query_engine/executor/trx_end_executor.h"
+#include "include/query_engine/executor/vacuum_executor.h"
 
 RC CommandExecutor::execute(QueryInfo *query_info)
 {
@@ -63,6 +64,11 @@ RC CommandExecutor::execute(QueryInfo *query_info)
       return executor.execute(query_info);
     }
 
+    case StmtType::VACUUM: {
+      VacuumExecutor executor;
+      return executor.execute(query_info);
+    }
+
     case StmtType::EXIT: {
       return RC::SUCCESS;
     }
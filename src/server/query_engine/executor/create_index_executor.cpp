@@ -15,5 +15,6 @@ RC CreateIndexExecutor::execute(QueryInfo *query_info)
   
   Trx *trx = session->current_trx();
   Table *table = create_index_stmt->table();
-  return table->create_index(trx, create_index_stmt->multi_field_metas(), create_index_stmt->index_name().c_str(), create_index_stmt->is_unique());
+  return table->create_index(trx, create_index_stmt->multi_field_metas(), create_index_stmt->index_name().c_str(),
+                             create_index_stmt->is_unique(), create_index_stmt->key_compressed());
 }
\ No newline at end of file
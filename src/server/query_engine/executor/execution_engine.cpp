@@ -102,28 +102,7 @@ RC send_schema(TupleSchema schema, int cell_num, Communicator* communicator, con
 }
 
 RC value_to_string(Value &value, std::string &cell_str){
-  if (value.attr_type() == TEXTS) {
-    std::string text_file_name = value.to_string();
-    std::ifstream inputFile(text_file_name);
-    if (!inputFile.is_open()) {
-        LOG_WARN("failed to init file named %s", text_file_name.c_str());
-        return RC::RECORD_NOT_EXIST;
-    }
-    // 获取文件大小
-    inputFile.seekg(0, std::ios::end);
-    std::streampos fileSize = inputFile.tellg();
-    inputFile.seekg(0, std::ios::beg);
-    // 分配足够的内存来存储文件数据
-    std::vector<char> fileData(fileSize);
-    // 一次性读取整个文件数据
-    inputFile.read(fileData.data(), fileSize);
-    // 关闭文件
-    inputFile.close();
-    fileData.push_back('\0');
-    cell_str = std::string(fileData.data());
-  } else {
-    cell_str = value.to_string();
-  }
+  cell_str = value.to_string();
   return RC::SUCCESS;
 }
 
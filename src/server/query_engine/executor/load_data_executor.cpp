@@ -4,6 +4,17 @@
 #include "include/query_engine/executor/sql_result.h"
 #include "common/lang/string.h"
 #include "include/query_engine/analyzer/statement/load_data_stmt.h"
+#include "include/storage_engine/recorder/table.h"
+#include "common/os/process_param.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 using namespace common;
 
@@ -18,146 +29,358 @@ RC LoadDataExecutor::execute(QueryInfo *query_info)
   return rc;
 }
 
+namespace {
+
+/**
+ * @brief 文件中按行对齐的一段数据
+ * @details 解析线程把其中的每一行转换成记录，按照表中记录的格式紧密排列在 records 中，
+ * 写入数据页面时不需要再做任何转换。遇到第一个错误的行就停止解析。
+ * 有TEXTS字段的表记录是变长的，每条记录单独放在 variable_records 中。
+ */
+struct LoadChunk
+{
+  const char *begin = nullptr;
+  const char *end = nullptr;
+
+  std::vector<char> records;  ///< 解析好的记录
+  std::vector<Record> variable_records;  ///< 解析好的变长记录
+  int record_num = 0;
+  int line_num = 0;           ///< 处理过的行数，出错时包含出错的这一行
+  RC rc = RC::SUCCESS;
+  std::string errmsg;         ///< 出错时的错误信息
+  bool parsed = false;
+};
+
+constexpr size_t LOAD_CHUNK_SIZE = 1024 * 1024;
+
+void strip(const char *&begin, const char *&end)
+{
+  while (begin < end && isspace(static_cast<unsigned char>(*begin))) {
+    begin++;
+  }
+  while (end > begin && isspace(static_cast<unsigned char>(*(end - 1)))) {
+    end--;
+  }
+}
+
 /**
- * 从文件中导入数据时使用。尝试向表中插入解析后的一行数据。
+ * 从文件中导入数据时使用。把一行数据解析成字段值。
  * @param table  要导入的表
- * @param file_values 从文件中读取到的一行数据，使用分隔符拆分后的几个字段值
- * @param record_values Table::insert_record使用的参数，为了防止频繁的申请内存
+ * @param line_begin 一行数据的开始位置
+ * @param line_end 一行数据的结束位置，不包含换行符
+ * @param record_values 解析出来的字段值，为了防止频繁的申请内存，由调用者提供
  * @param errmsg 如果出现错误，通过这个参数返回错误信息
  * @return 成功返回RC::SUCCESS
  */
-RC insert_record_from_file(Table *table, 
-    std::vector<std::string> &file_values,
+RC parse_line(Table *table,
+    const char *line_begin,
+    const char *line_end,
     std::vector<Value> &record_values,
     std::stringstream &errmsg)
 {
-
   const int field_num = record_values.size();
   const int sys_field_num = table->table_meta().sys_field_num();
 
-  if (file_values.size() < record_values.size()) {
-    return RC::SCHEMA_FIELD_MISSING;
-  }
-
   RC rc = RC::SUCCESS;
-
-  std::stringstream deserialize_stream;
+  const char *value_begin = line_begin;
+  std::string tmp;
   for (int i = 0; i < field_num && RC::SUCCESS == rc; i++) {
-    const FieldMeta *field = table->table_meta().field(i + sys_field_num);
-
-    std::string &file_value = file_values[i];
-    if (field->type() != CHARS || field->type() != TEXTS) {
-      common::strip(file_value);
+    if (value_begin > line_end) {
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    const char *value_end = static_cast<const char *>(memchr(value_begin, '|', line_end - value_begin));
+    if (value_end == nullptr) {
+      value_end = line_end;
     }
+    const char *next_begin = value_end + 1;
+
+    const FieldMeta *field = table->table_meta().field(i + sys_field_num);
+    strip(value_begin, value_end);
+    const int value_len = static_cast<int>(value_end - value_begin);
 
     switch (field->type()) {
       case INTS:
       case DATES: {
-        deserialize_stream.clear();  // 清理stream的状态，防止多次解析出现异常
-        deserialize_stream.str(file_value);
-
-        int int_value;
-        deserialize_stream >> int_value;
-        if (!deserialize_stream || !deserialize_stream.eof()) {
-          errmsg << "need an integer but got '" << file_values[i] << "' (field index:" << i << ")";
-
+        tmp.assign(value_begin, value_len);
+        char *parse_end = nullptr;
+        errno = 0;
+        long int_value = strtol(tmp.c_str(), &parse_end, 10);
+        if (tmp.empty() || *parse_end != '\0' || errno == ERANGE || int_value < INT32_MIN || int_value > INT32_MAX) {
+          errmsg << "need an integer but got '" << tmp << "' (field index:" << i << ")";
           rc = RC::SCHEMA_FIELD_TYPE_MISMATCH;
         } else {
-          record_values[i].set_int(int_value);
+          record_values[i].set_int(static_cast<int>(int_value));
         }
-      }
-
-      break;
+      } break;
       case FLOATS: {
-        deserialize_stream.clear();
-        deserialize_stream.str(file_value);
-
-        float float_value;
-        deserialize_stream >> float_value;
-        if (!deserialize_stream || !deserialize_stream.eof()) {
-          errmsg << "need a float number but got '" << file_values[i] << "'(field index:" << i << ")";
+        tmp.assign(value_begin, value_len);
+        char *parse_end = nullptr;
+        errno = 0;
+        float float_value = strtof(tmp.c_str(), &parse_end);
+        if (tmp.empty() || *parse_end != '\0' || errno == ERANGE) {
+          errmsg << "need a float number but got '" << tmp << "'(field index:" << i << ")";
           rc = RC::SCHEMA_FIELD_TYPE_MISMATCH;
         } else {
           record_values[i].set_float(float_value);
         }
       } break;
       case CHARS: {
-        record_values[i].set_string(file_value.c_str());
+        // 文件内容没有以0结尾，长度为0时不能交给 set_string
+        if (value_len > 0) {
+          record_values[i].set_string(value_begin, value_len);
+        } else {
+          record_values[i].set_string("");
+        }
       } break;
       case TEXTS: {
-        record_values[i].set_text(file_value.c_str(), file_value.size());
+        if (value_len > 0) {
+          record_values[i].set_text(value_begin, value_len);
+        } else {
+          record_values[i].set_text("", 0);
+        }
       } break;
       default: {
         errmsg << "Unsupported field type to loading: " << field->type();
         rc = RC::SCHEMA_FIELD_TYPE_MISMATCH;
       } break;
     }
+    value_begin = next_begin;
   }
+  return rc;
+}
 
-  if (RC::SUCCESS == rc) {
-    Record record;
-    rc = table->make_record(field_num, record_values.data(), record);
-    if (rc != RC::SUCCESS) {
-      errmsg << "insert failed.";
-    } else if (RC::SUCCESS != (rc = table->insert_record(record))) {
-      errmsg << "insert failed.";
+/**
+ * @brief 解析一段数据中的所有行，生成记录
+ */
+void parse_chunk(Table *table, int field_num, LoadChunk &chunk)
+{
+  const int record_size = table->table_meta().record_size();
+  std::vector<Value> record_values(field_num);
+
+  const char *line_begin = chunk.begin;
+  while (line_begin < chunk.end) {
+    const char *line_end = static_cast<const char *>(memchr(line_begin, '\n', chunk.end - line_begin));
+    if (line_end == nullptr) {
+      line_end = chunk.end;
+    }
+    chunk.line_num++;
+
+    const char *value_begin = line_begin;
+    const char *value_end = line_end;
+    strip(value_begin, value_end);
+    if (value_begin != value_end) {
+      std::stringstream errmsg;
+      RC rc = parse_line(table, line_begin, line_end, record_values, errmsg);
+      if (rc == RC::SUCCESS && table->table_meta().variable_length()) {
+        chunk.variable_records.emplace_back();
+        rc = table->make_record(field_num, record_values.data(), chunk.variable_records.back());
+        if (rc != RC::SUCCESS) {
+          chunk.variable_records.pop_back();
+          errmsg << "insert failed.";
+        }
+      } else if (rc == RC::SUCCESS) {
+        // resize 会把新增的部分清零，make_record 要求记录中没有写到的部分都是0
+        chunk.records.resize(static_cast<size_t>(chunk.record_num + 1) * record_size);
+        rc = table->make_record(field_num,
+                                record_values.data(),
+                                chunk.records.data() + static_cast<size_t>(chunk.record_num) * record_size);
+        if (rc != RC::SUCCESS) {
+          chunk.records.resize(static_cast<size_t>(chunk.record_num) * record_size);
+          errmsg << "insert failed.";
+        }
+      }
+      if (rc != RC::SUCCESS) {
+        chunk.rc = rc;
+        chunk.errmsg = errmsg.str();
+        return;
+      }
+      chunk.record_num++;
     }
+    line_begin = line_end + 1;
+  }
+}
+
+/**
+ * @brief 把文件内容按照 LOAD_CHUNK_SIZE 切分成多段，每一段都以完整的行结束
+ */
+void split_chunks(const char *data, size_t size, std::vector<LoadChunk> &chunks)
+{
+  const char *begin = data;
+  const char *data_end = data + size;
+  while (begin < data_end) {
+    const char *end = begin + std::min(LOAD_CHUNK_SIZE, static_cast<size_t>(data_end - begin));
+    if (end < data_end) {
+      const char *newline = static_cast<const char *>(memchr(end, '\n', data_end - end));
+      end = (newline == nullptr) ? data_end : newline + 1;
+    }
+    LoadChunk &chunk = chunks.emplace_back();
+    chunk.begin = begin;
+    chunk.end = end;
+    begin = end;
   }
-  return rc;
 }
 
+}  // namespace
+
+/**
+ * 导入数据分成三步流水线执行：
+ * 1. 使用 mmap 映射整个文件，按行对齐切分成多段；
+ * 2. 多个线程并行解析，把每一行直接转换成表中记录的格式；
+ * 3. 当前线程按照文件中的顺序，一次写满一个数据页面地插入解析好的记录。解析线程最多比插入提前 2 倍线程数的段，
+ *    控制内存的使用。
+ * 所有数据写入以后再统一插入索引项，空索引直接自底向上构建。与逐行导入相同，遇到第一个错误的行就停止导入，
+ * 之前的行仍然保留。
+ */
 void LoadDataExecutor::load_data(Table *table, const char *file_name, SqlResult *sql_result)
 {
   std::stringstream result_string;
 
-  std::fstream fs;
-  fs.open(file_name, std::ios_base::in | std::ios_base::binary);
-  if (!fs.is_open()) {
+  int fd = ::open(file_name, O_RDONLY);
+  struct stat file_stat;
+  if (fd < 0 || fstat(fd, &file_stat) != 0) {
     result_string << "Failed to init file: " << file_name << ". system error=" << strerror(errno) << std::endl;
+    if (fd >= 0) {
+      ::close(fd);
+    }
     sql_result->set_return_code(RC::FILE_NOT_EXIST);
     sql_result->set_state_string(result_string.str());
     return;
   }
 
+  const size_t file_size = static_cast<size_t>(file_stat.st_size);
+  const char *file_data = nullptr;
+  if (file_size > 0) {
+    void *addr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      result_string << "Failed to map file: " << file_name << ". system error=" << strerror(errno) << std::endl;
+      ::close(fd);
+      sql_result->set_return_code(RC::IOERR_READ);
+      sql_result->set_state_string(result_string.str());
+      return;
+    }
+    madvise(addr, file_size, MADV_SEQUENTIAL);
+    file_data = static_cast<const char *>(addr);
+  }
+
   struct timespec begin_time;
   clock_gettime(CLOCK_MONOTONIC, &begin_time);
   const int sys_field_num = table->table_meta().sys_field_num();
   const int null_field_num = table->table_meta().null_filed_num();
   const int field_num = table->table_meta().field_num() - sys_field_num - null_field_num;
 
-  std::vector<Value> record_values(field_num);
-  std::string line;
-  std::vector<std::string> file_values;
-  const std::string delim("|");
+  std::vector<LoadChunk> chunks;
+  split_chunks(file_data, file_size, chunks);
+
+  int thread_num = common::the_process_param()->load_thread_num();
+  if (thread_num <= 0) {
+    thread_num = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  thread_num = std::max(1, std::min(thread_num, static_cast<int>(chunks.size())));
+  const int window = thread_num * 2;
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  int next_chunk = 0;
+  int inserted_chunks = 0;
+  bool stop = false;
+
+  auto parser = [&]() {
+    while (true) {
+      int index = 0;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&]() {
+          return stop || next_chunk >= static_cast<int>(chunks.size()) || next_chunk < inserted_chunks + window;
+        });
+        if (stop || next_chunk >= static_cast<int>(chunks.size())) {
+          return;
+        }
+        index = next_chunk++;
+      }
+
+      parse_chunk(table, field_num, chunks[index]);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      chunks[index].parsed = true;
+      cond.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_num && !chunks.empty(); i++) {
+    threads.emplace_back(parser);
+  }
+
   int line_num = 0;
   int insertion_count = 0;
+  std::vector<RID> rids;
   RC rc = RC::SUCCESS;
-  while (!fs.eof() && RC::SUCCESS == rc) {
-    std::getline(fs, line);
-    line_num++;
-    if (common::is_blank(line.c_str())) {
-      continue;
+  for (size_t i = 0; i < chunks.size() && RC::SUCCESS == rc; i++) {
+    LoadChunk &chunk = chunks[i];
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cond.wait(lock, [&chunk]() { return chunk.parsed; });
     }
 
-    file_values.clear();
-    common::split_string(line, delim, file_values);
-    std::stringstream errmsg;
-    rc = insert_record_from_file(table, file_values, record_values, errmsg);
-    if (rc != RC::SUCCESS) {
-      result_string << "Line:" << line_num << " insert record failed:" << errmsg.str() << ". error:" << strrc(rc)
-                    << std::endl;
-    } else {
-      insertion_count++;
+    if (chunk.record_num > 0) {
+      rids.resize(insertion_count + chunk.record_num);
+      if (table->table_meta().variable_length()) {
+        rc = table->insert_records(chunk.variable_records, rids.data() + insertion_count);
+      } else {
+        rc = table->insert_records(chunk.records.data(), chunk.record_num, rids.data() + insertion_count);
+      }
+      if (rc != RC::SUCCESS) {
+        result_string << "Line:" << line_num + 1 << " insert record failed:insert failed. error:" << strrc(rc)
+                      << std::endl;
+        rids.resize(insertion_count);
+      } else {
+        insertion_count += chunk.record_num;
+      }
+    }
+    if (RC::SUCCESS == rc && RC::SUCCESS != chunk.rc) {
+      rc = chunk.rc;
+      result_string << "Line:" << line_num + chunk.line_num << " insert record failed:" << chunk.errmsg
+                    << ". error:" << strrc(rc) << std::endl;
     }
+    line_num += chunk.line_num;
+    std::vector<char>().swap(chunk.records);
+    std::vector<Record>().swap(chunk.variable_records);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    inserted_chunks = static_cast<int>(i) + 1;
+    stop = (rc != RC::SUCCESS);
+    cond.notify_all();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+    cond.notify_all();
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  if (file_data != nullptr) {
+    munmap(const_cast<char *>(file_data), file_size);
+  }
+  ::close(fd);
+
+  // 已经写入的数据都要有索引项，出错时也一样
+  RC index_rc = table->insert_entries_of_indexes(rids);
+  if (index_rc != RC::SUCCESS) {
+    result_string << "Failed to insert index entries of loaded records. error:" << strrc(index_rc) << std::endl;
+    rc = index_rc;
   }
-  fs.close();
 
   struct timespec end_time;
   clock_gettime(CLOCK_MONOTONIC, &end_time);
   long cost_nano = (end_time.tv_sec - begin_time.tv_sec) * 1000000000L + (end_time.tv_nsec - begin_time.tv_nsec);
   if (RC::SUCCESS == rc) {
+    const double cost_seconds = cost_nano / 1000000000.0;
+    const long rows_per_second = cost_nano > 0 ? static_cast<long>(insertion_count / cost_seconds) : insertion_count;
     result_string << strrc(rc) << ". total " << line_num << " line(s) handled and " << insertion_count
-                  << " record(s) loaded, total cost " << cost_nano / 1000000000.0 << " second(s)" << std::endl;
+                  << " record(s) loaded, total cost " << cost_seconds << " second(s), " << rows_per_second
+                  << " row(s) per second" << std::endl;
   }
   sql_result->set_return_code(RC::SUCCESS);
   sql_result->set_state_string(result_string.str());
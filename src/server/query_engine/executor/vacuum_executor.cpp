@@ -0,0 +1,32 @@
+#include <sstream>
+
+#include "include/query_engine/executor/vacuum_executor.h"
+#include "include/query_engine/structor/query_info.h"
+#include "include/query_engine/executor/sql_result.h"
+#include "include/query_engine/analyzer/statement/vacuum_stmt.h"
+#include "include/session/session.h"
+#include "include/storage_engine/schema/database.h"
+
+RC VacuumExecutor::execute(QueryInfo *query_info)
+{
+  Stmt *stmt = query_info->stmt();
+  SessionRequest *session_event = query_info->session_event();
+  Session *session = session_event->session();
+  ASSERT(stmt->type() == StmtType::VACUUM,
+         "vacuum executor can not run this command: %d", static_cast<int>(stmt->type()));
+
+  VacuumStmt *vacuum_stmt = static_cast<VacuumStmt *>(stmt);
+  SqlResult *sql_result = session_event->sql_result();
+
+  int record_num = 0;
+  Db *db = session->get_current_db();
+  RC rc = db->vacuum(vacuum_stmt->table(), record_num);
+  if (RC_FAIL(rc)) {
+    return rc;
+  }
+
+  std::stringstream result_string;
+  result_string << strrc(rc) << ". " << record_num << " record(s) removed" << std::endl;
+  sql_result->set_state_string(result_string.str());
+  return rc;
+}
@@ -80,11 +80,16 @@ RC PredicatePushdownRewriter::get_exprs_can_pushdown(
       }
 
       if (!*iter) {
-        child_exprs.erase(iter);
+        iter = child_exprs.erase(iter);
       } else {
         ++iter;
       }
     }
+
+    // 所有的子表达式都下推了，这个与操作恒为真，也当作已经下推
+    if (child_exprs.empty()) {
+      expr.reset();
+    }
   } else if (expr->type() == ExprType::COMPARISON) {
     // 如果是比较操作，并且比较的左边或右边是表某个列值，那么就下推下去
     auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
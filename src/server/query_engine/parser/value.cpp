@@ -193,7 +193,7 @@ void Value::set_value(const Value &value)
     } break;
     case TEXTS: {
       set_text(value.get_string().c_str(), value.get_string().size());
-    }
+    } break;
     case CHARS: {
       set_string(value.get_string().c_str());
     } break;
@@ -304,6 +304,12 @@ int Value::compare(const Value &other) const
         LOG_WARN("unsupported type: %d", this->attr_type_);
       }
     }
+  } else if ((this->attr_type_ == CHARS || this->attr_type_ == TEXTS) &&
+             (other.attr_type_ == CHARS || other.attr_type_ == TEXTS)) {
+    const std::string &this_str  = this->attr_type_ == TEXTS ? this->text_value_ : this->str_value_;
+    const std::string &other_str = other.attr_type_ == TEXTS ? other.text_value_ : other.str_value_;
+    return common::compare_string(
+        (void *)this_str.c_str(), this_str.length(), (void *)other_str.c_str(), other_str.length());
   } else if (this->attr_type_ == INTS && other.attr_type_ == FLOATS) {
     float this_data = this->num_value_.int_value_;
     return common::compare_float((void *)&this_data, (void *)&other.num_value_.float_value_);
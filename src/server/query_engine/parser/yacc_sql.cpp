@@ -230,59 +230,61 @@ enum yysymbol_kind_t
   YYSYMBOL_exit_stmt = 82,                 /* exit_stmt  */
   YYSYMBOL_help_stmt = 83,                 /* help_stmt  */
   YYSYMBOL_sync_stmt = 84,                 /* sync_stmt  */
-  YYSYMBOL_begin_stmt = 85,                /* begin_stmt  */
-  YYSYMBOL_commit_stmt = 86,               /* commit_stmt  */
-  YYSYMBOL_rollback_stmt = 87,             /* rollback_stmt  */
-  YYSYMBOL_drop_table_stmt = 88,           /* drop_table_stmt  */
-  YYSYMBOL_show_tables_stmt = 89,          /* show_tables_stmt  */
-  YYSYMBOL_desc_table_stmt = 90,           /* desc_table_stmt  */
-  YYSYMBOL_create_index_stmt = 91,         /* create_index_stmt  */
-  YYSYMBOL_multi_attribute_names = 92,     /* multi_attribute_names  */
-  YYSYMBOL_drop_index_stmt = 93,           /* drop_index_stmt  */
-  YYSYMBOL_create_table_stmt = 94,         /* create_table_stmt  */
-  YYSYMBOL_create_view_stmt = 95,          /* create_view_stmt  */
-  YYSYMBOL_attr_def_list = 96,             /* attr_def_list  */
-  YYSYMBOL_attr_def = 97,                  /* attr_def  */
-  YYSYMBOL_number = 98,                    /* number  */
-  YYSYMBOL_type = 99,                      /* type  */
-  YYSYMBOL_aggr_type = 100,                /* aggr_type  */
-  YYSYMBOL_insert_stmt = 101,              /* insert_stmt  */
-  YYSYMBOL_multi_value_list = 102,         /* multi_value_list  */
-  YYSYMBOL_value_list = 103,               /* value_list  */
-  YYSYMBOL_value_list_body = 104,          /* value_list_body  */
-  YYSYMBOL_value = 105,                    /* value  */
-  YYSYMBOL_delete_stmt = 106,              /* delete_stmt  */
-  YYSYMBOL_update_stmt = 107,              /* update_stmt  */
-  YYSYMBOL_update_def_list = 108,          /* update_def_list  */
-  YYSYMBOL_update_def = 109,               /* update_def  */
-  YYSYMBOL_select_stmt = 110,              /* select_stmt  */
-  YYSYMBOL_opt_group_by = 111,             /* opt_group_by  */
-  YYSYMBOL_opt_having = 112,               /* opt_having  */
-  YYSYMBOL_opt_order_by = 113,             /* opt_order_by  */
-  YYSYMBOL_sort_def_list = 114,            /* sort_def_list  */
-  YYSYMBOL_sort_def = 115,                 /* sort_def  */
-  YYSYMBOL_calc_stmt = 116,                /* calc_stmt  */
-  YYSYMBOL_aggr_expr = 117,                /* aggr_expr  */
-  YYSYMBOL_base_expr = 118,                /* base_expr  */
-  YYSYMBOL_mul_expr = 119,                 /* mul_expr  */
-  YYSYMBOL_add_expr = 120,                 /* add_expr  */
-  YYSYMBOL_select_attr = 121,              /* select_attr  */
-  YYSYMBOL_expression_list = 122,          /* expression_list  */
-  YYSYMBOL_rel_attr = 123,                 /* rel_attr  */
-  YYSYMBOL_rel_attr_list = 124,            /* rel_attr_list  */
-  YYSYMBOL_relation_list = 125,            /* relation_list  */
-  YYSYMBOL_rel_list = 126,                 /* rel_list  */
-  YYSYMBOL_rel_alias = 127,                /* rel_alias  */
-  YYSYMBOL_join_list = 128,                /* join_list  */
-  YYSYMBOL_join_conditions = 129,          /* join_conditions  */
-  YYSYMBOL_where_conditions = 130,         /* where_conditions  */
-  YYSYMBOL_condition_list = 131,           /* condition_list  */
-  YYSYMBOL_condition = 132,                /* condition  */
-  YYSYMBOL_comp_op = 133,                  /* comp_op  */
-  YYSYMBOL_load_data_stmt = 134,           /* load_data_stmt  */
-  YYSYMBOL_explain_stmt = 135,             /* explain_stmt  */
-  YYSYMBOL_set_variable_stmt = 136,        /* set_variable_stmt  */
-  YYSYMBOL_opt_semicolon = 137             /* opt_semicolon  */
+  YYSYMBOL_vacuum_stmt = 85,               /* vacuum_stmt  */
+  YYSYMBOL_begin_stmt = 86,                /* begin_stmt  */
+  YYSYMBOL_commit_stmt = 87,               /* commit_stmt  */
+  YYSYMBOL_rollback_stmt = 88,             /* rollback_stmt  */
+  YYSYMBOL_drop_table_stmt = 89,           /* drop_table_stmt  */
+  YYSYMBOL_show_tables_stmt = 90,          /* show_tables_stmt  */
+  YYSYMBOL_desc_table_stmt = 91,           /* desc_table_stmt  */
+  YYSYMBOL_create_index_stmt = 92,         /* create_index_stmt  */
+  YYSYMBOL_opt_key_compressed = 93,        /* opt_key_compressed  */
+  YYSYMBOL_multi_attribute_names = 94,     /* multi_attribute_names  */
+  YYSYMBOL_drop_index_stmt = 95,           /* drop_index_stmt  */
+  YYSYMBOL_create_table_stmt = 96,         /* create_table_stmt  */
+  YYSYMBOL_create_view_stmt = 97,          /* create_view_stmt  */
+  YYSYMBOL_attr_def_list = 98,             /* attr_def_list  */
+  YYSYMBOL_attr_def = 99,                  /* attr_def  */
+  YYSYMBOL_number = 100,                   /* number  */
+  YYSYMBOL_type = 101,                     /* type  */
+  YYSYMBOL_aggr_type = 102,                /* aggr_type  */
+  YYSYMBOL_insert_stmt = 103,              /* insert_stmt  */
+  YYSYMBOL_multi_value_list = 104,         /* multi_value_list  */
+  YYSYMBOL_value_list = 105,               /* value_list  */
+  YYSYMBOL_value_list_body = 106,          /* value_list_body  */
+  YYSYMBOL_value = 107,                    /* value  */
+  YYSYMBOL_delete_stmt = 108,              /* delete_stmt  */
+  YYSYMBOL_update_stmt = 109,              /* update_stmt  */
+  YYSYMBOL_update_def_list = 110,          /* update_def_list  */
+  YYSYMBOL_update_def = 111,               /* update_def  */
+  YYSYMBOL_select_stmt = 112,              /* select_stmt  */
+  YYSYMBOL_opt_group_by = 113,             /* opt_group_by  */
+  YYSYMBOL_opt_having = 114,               /* opt_having  */
+  YYSYMBOL_opt_order_by = 115,             /* opt_order_by  */
+  YYSYMBOL_sort_def_list = 116,            /* sort_def_list  */
+  YYSYMBOL_sort_def = 117,                 /* sort_def  */
+  YYSYMBOL_calc_stmt = 118,                /* calc_stmt  */
+  YYSYMBOL_aggr_expr = 119,                /* aggr_expr  */
+  YYSYMBOL_base_expr = 120,                /* base_expr  */
+  YYSYMBOL_mul_expr = 121,                 /* mul_expr  */
+  YYSYMBOL_add_expr = 122,                 /* add_expr  */
+  YYSYMBOL_select_attr = 123,              /* select_attr  */
+  YYSYMBOL_expression_list = 124,          /* expression_list  */
+  YYSYMBOL_rel_attr = 125,                 /* rel_attr  */
+  YYSYMBOL_rel_attr_list = 126,            /* rel_attr_list  */
+  YYSYMBOL_relation_list = 127,            /* relation_list  */
+  YYSYMBOL_rel_list = 128,                 /* rel_list  */
+  YYSYMBOL_rel_alias = 129,                /* rel_alias  */
+  YYSYMBOL_join_list = 130,                /* join_list  */
+  YYSYMBOL_join_conditions = 131,          /* join_conditions  */
+  YYSYMBOL_where_conditions = 132,         /* where_conditions  */
+  YYSYMBOL_condition_list = 133,           /* condition_list  */
+  YYSYMBOL_condition = 134,                /* condition  */
+  YYSYMBOL_comp_op = 135,                  /* comp_op  */
+  YYSYMBOL_load_data_stmt = 136,           /* load_data_stmt  */
+  YYSYMBOL_explain_stmt = 137,             /* explain_stmt  */
+  YYSYMBOL_set_variable_stmt = 138,        /* set_variable_stmt  */
+  YYSYMBOL_opt_semicolon = 139             /* opt_semicolon  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -611,18 +613,18 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  80
+#define YYFINAL  83
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   321
+#define YYLAST   327
 
 /* YYNTOKENS -- Number of terminals.  */
 #define YYNTOKENS  79
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  59
+#define YYNNTS  61
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  156
+#define YYNRULES  162
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  294
+#define YYNSTATES  302
 
 /* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   329
@@ -678,22 +680,23 @@ static const yytype_int8 yytranslate[] =
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   232,   232,   240,   241,   242,   243,   244,   245,   246,
-     247,   248,   249,   250,   251,   252,   253,   254,   255,   256,
-     257,   258,   259,   260,   264,   270,   275,   281,   287,   293,
-     299,   306,   312,   320,   336,   356,   359,   371,   382,   401,
-     408,   419,   422,   435,   444,   453,   462,   471,   480,   492,
-     496,   497,   498,   499,   500,   505,   506,   507,   508,   509,
-     513,   529,   532,   545,   560,   563,   576,   579,   582,   585,
-     588,   592,   596,   604,   617,   639,   642,   655,   665,   707,
-     710,   715,   718,   725,   728,   735,   740,   752,   758,   765,
-     774,   784,   790,   793,   804,   808,   812,   815,   818,   829,
-     831,   833,   835,   841,   843,   845,   851,   862,   873,   880,
-     893,   895,   905,   916,   923,   932,   941,   955,   960,   970,
-     974,   985,   997,   999,  1011,  1016,  1022,  1033,  1036,  1057,
-    1060,  1068,  1071,  1077,  1079,  1083,  1088,  1098,  1103,  1109,
-    1113,  1118,  1124,  1129,  1137,  1138,  1139,  1140,  1141,  1142,
-    1143,  1144,  1148,  1161,  1169,  1179,  1180
+       0,   235,   235,   243,   244,   245,   246,   247,   248,   249,
+     250,   251,   252,   253,   254,   255,   256,   257,   258,   259,
+     260,   261,   262,   263,   264,   268,   274,   279,   286,   290,
+     299,   305,   311,   317,   324,   330,   338,   355,   377,   380,
+     394,   397,   409,   420,   439,   446,   457,   460,   473,   482,
+     491,   500,   509,   518,   530,   534,   535,   536,   537,   538,
+     543,   544,   545,   546,   547,   551,   567,   570,   583,   598,
+     601,   614,   617,   620,   623,   626,   630,   634,   642,   655,
+     677,   680,   693,   703,   746,   749,   754,   757,   764,   767,
+     774,   791,   796,   808,   814,   821,   830,   840,   846,   849,
+     860,   864,   868,   871,   874,   885,   887,   889,   891,   897,
+     899,   901,   907,   918,   929,   936,   949,   951,   961,   972,
+     979,   988,   997,  1011,  1016,  1026,  1030,  1041,  1053,  1055,
+    1067,  1072,  1078,  1089,  1092,  1113,  1116,  1124,  1127,  1133,
+    1135,  1139,  1144,  1154,  1159,  1165,  1169,  1174,  1180,  1185,
+    1193,  1194,  1195,  1196,  1197,  1198,  1199,  1200,  1204,  1217,
+    1225,  1235,  1236
 };
 #endif
 
@@ -720,12 +723,13 @@ static const char *const yytname[] =
   "GROUP", "HAVING", "AS", "IN_T", "EXISTS_T", "EQ", "LT", "GT", "LE",
   "GE", "NE", "NUMBER", "FLOAT", "ID", "SSS", "DATE_STR", "'+'", "'-'",
   "'*'", "'/'", "$accept", "commands", "command_wrapper", "exit_stmt",
-  "help_stmt", "sync_stmt", "begin_stmt", "commit_stmt", "rollback_stmt",
-  "drop_table_stmt", "show_tables_stmt", "desc_table_stmt",
-  "create_index_stmt", "multi_attribute_names", "drop_index_stmt",
-  "create_table_stmt", "create_view_stmt", "attr_def_list", "attr_def",
-  "number", "type", "aggr_type", "insert_stmt", "multi_value_list",
-  "value_list", "value_list_body", "value", "delete_stmt", "update_stmt",
+  "help_stmt", "sync_stmt", "vacuum_stmt", "begin_stmt", "commit_stmt",
+  "rollback_stmt", "drop_table_stmt", "show_tables_stmt",
+  "desc_table_stmt", "create_index_stmt", "opt_key_compressed",
+  "multi_attribute_names", "drop_index_stmt", "create_table_stmt",
+  "create_view_stmt", "attr_def_list", "attr_def", "number", "type",
+  "aggr_type", "insert_stmt", "multi_value_list", "value_list",
+  "value_list_body", "value", "delete_stmt", "update_stmt",
   "update_def_list", "update_def", "select_stmt", "opt_group_by",
   "opt_having", "opt_order_by", "sort_def_list", "sort_def", "calc_stmt",
   "aggr_expr", "base_expr", "mul_expr", "add_expr", "select_attr",
@@ -742,12 +746,12 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#define YYPACT_NINF (-249)
+#define YYPACT_NINF (-181)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF (-65)
+#define YYTABLE_NINF (-70)
 
 #define yytable_value_is_error(Yyn) \
   0
@@ -756,36 +760,37 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-       6,   115,   102,    42,    42,   -56,    11,  -249,   -22,    31,
-     -30,  -249,  -249,  -249,  -249,  -249,    14,    39,     6,   101,
-     107,  -249,  -249,  -249,  -249,  -249,  -249,  -249,  -249,  -249,
-    -249,  -249,  -249,  -249,  -249,  -249,  -249,  -249,  -249,  -249,
-    -249,  -249,    45,    51,    69,   138,    82,    97,  -249,   162,
-    -249,  -249,  -249,  -249,  -249,  -249,  -249,   128,  -249,  -249,
-     188,   163,   166,  -249,  -249,  -249,  -249,    53,    24,  -249,
-    -249,   144,  -249,  -249,   120,   132,   156,   147,   151,  -249,
-    -249,  -249,  -249,   -16,   185,   159,   142,  -249,   168,   176,
-     119,    16,    21,  -249,  -249,    94,  -249,    66,  -249,   -34,
-     213,   213,   152,   162,   162,  -249,   158,   177,   191,   169,
-     145,   167,   170,   231,   172,   174,   193,   183,   184,   145,
-     223,  -249,  -249,   163,  -249,  -249,   205,   163,    -5,   232,
-     238,   240,  -249,  -249,   163,    53,    53,   -17,   214,   241,
-     244,   111,  -249,   206,   243,  -249,   226,   246,   248,  -249,
-     164,   249,   250,   204,  -249,   251,  -249,  -249,    25,  -249,
-       3,   163,  -249,  -249,  -249,  -249,  -249,   207,  -249,   225,
-     191,   158,  -249,   145,   254,   218,   162,    91,  -249,   112,
-     162,   169,   191,   275,   170,   227,  -249,  -249,  -249,  -249,
-    -249,    12,   172,   265,   219,   268,  -249,   163,   163,   163,
-    -249,  -249,   158,   234,   241,   251,   244,  -249,   162,    95,
-      19,   -23,  -249,   162,  -249,  -249,  -249,  -249,  -249,  -249,
-     162,   111,   111,    95,   243,  -249,   222,  -249,   231,  -249,
-     228,   277,   249,  -249,   270,   229,  -249,  -249,  -249,   245,
-     281,   242,  -249,   254,    95,  -249,   282,  -249,   162,    95,
-      95,  -249,  -249,  -249,  -249,  -249,  -249,   278,  -249,  -249,
-     233,   279,   270,   111,   214,   170,   111,   291,  -249,  -249,
-      95,    33,   270,  -249,   283,  -249,  -249,  -249,  -249,   293,
-    -249,  -249,   289,  -249,  -249,   170,  -249,  -249,   284,   165,
-     170,  -249,  -249,  -249
+       8,    93,    16,    55,    55,   -55,    38,  -181,   -21,     6,
+     -23,  -181,  -181,  -181,  -181,  -181,     9,    28,     8,    45,
+     121,   151,  -181,  -181,  -181,  -181,  -181,  -181,  -181,  -181,
+    -181,  -181,  -181,  -181,  -181,  -181,  -181,  -181,  -181,  -181,
+    -181,  -181,  -181,  -181,    99,   103,   105,   147,   111,   112,
+    -181,   161,  -181,  -181,  -181,  -181,  -181,  -181,  -181,   142,
+    -181,  -181,   205,   162,   163,  -181,  -181,  -181,  -181,     0,
+       7,  -181,  -181,   149,  -181,  -181,   133,   134,   152,   140,
+     150,  -181,  -181,  -181,  -181,  -181,   -16,   185,   156,   139,
+    -181,   158,   170,   132,   -14,   -25,  -181,  -181,    53,  -181,
+      67,  -181,   -38,   223,   223,   143,   161,   161,  -181,   144,
+     172,   171,   164,    39,   148,   166,   210,   167,   168,   195,
+     178,   179,    39,   227,  -181,  -181,   162,  -181,  -181,   209,
+     162,    14,   229,   230,   231,  -181,  -181,   162,     0,     0,
+     -18,   206,   233,   241,   154,  -181,   193,   240,  -181,   222,
+     242,   244,  -181,   131,   245,   246,   200,  -181,   247,  -181,
+    -181,    70,  -181,     2,   162,  -181,  -181,  -181,  -181,  -181,
+     202,  -181,   232,   171,   144,  -181,    39,   254,   219,   161,
+      84,  -181,   117,   161,   164,   171,   276,   166,   225,  -181,
+    -181,  -181,  -181,  -181,    98,   167,   259,   215,   264,  -181,
+     162,   162,   162,  -181,  -181,   144,   239,   233,   247,   241,
+    -181,   161,    94,    -9,   -20,  -181,   161,  -181,  -181,  -181,
+    -181,  -181,  -181,   161,   154,   154,    94,   240,  -181,   217,
+    -181,   210,  -181,   220,   273,   245,  -181,   266,   228,  -181,
+    -181,  -181,   248,   285,   243,  -181,   254,    94,  -181,   286,
+    -181,   161,    94,    94,  -181,  -181,  -181,  -181,  -181,  -181,
+     280,  -181,  -181,   234,   282,   266,   154,   206,   166,   154,
+     293,  -181,  -181,    94,     3,   266,   237,   287,  -181,  -181,
+    -181,  -181,   294,  -181,  -181,   295,  -181,  -181,  -181,   237,
+     166,  -181,  -181,   249,   288,   160,   250,   166,  -181,  -181,
+    -181,  -181
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -793,58 +798,61 @@ static const yytype_int16 yypact[] =
    means the default is an error.  */
 static const yytype_uint8 yydefact[] =
 {
-       0,     0,     0,     0,     0,     0,     0,    26,     0,     0,
-       0,    27,    28,    29,    25,    24,     0,     0,     0,     0,
-     155,    23,    22,    15,    16,    17,    18,    10,    11,    12,
-      13,    14,     8,     9,     5,     7,     6,     4,     3,    19,
-      20,    21,     0,     0,     0,     0,     0,     0,    72,     0,
-      55,    56,    57,    58,    59,    66,    68,   117,    70,    71,
-       0,   110,     0,    98,    94,    97,    99,   103,   110,    90,
-      95,     0,    32,    31,     0,     0,     0,     0,     0,   153,
-       1,   156,     2,     0,     0,     0,     0,    30,     0,   117,
-      94,     0,     0,    66,    68,     0,   100,     0,   106,     0,
-       0,     0,     0,     0,     0,   108,     0,     0,   131,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,    96,   118,   110,    67,    69,   117,   110,   110,     0,
-       0,     0,   101,   102,   110,   104,   105,   124,   127,   122,
-       0,   133,    73,     0,    75,   154,     0,   119,     0,    39,
-       0,    41,     0,     0,    37,    64,    63,   107,     0,   111,
-       0,   110,   113,    93,    91,    92,   109,     0,   125,     0,
-     131,     0,   121,     0,    61,     0,     0,     0,   132,   134,
-       0,     0,   131,     0,     0,     0,    50,    51,    52,    53,
-      54,    44,     0,     0,     0,     0,    65,   110,   110,   110,
-     114,   126,     0,    79,   122,    64,     0,    60,     0,   142,
-       0,     0,   150,     0,   144,   145,   146,   147,   148,   149,
-       0,   133,   133,    77,    75,    74,     0,   120,     0,    48,
-       0,     0,    41,    38,    35,     0,   112,   116,   115,   129,
-       0,    81,   123,    61,   143,   138,     0,   151,     0,   140,
-     137,   135,   136,    76,   152,    40,    49,     0,    46,    42,
-       0,     0,    35,   133,   127,     0,   133,    83,    62,   139,
-     141,    43,    35,    34,     0,   130,   128,    80,    82,     0,
-      78,    47,     0,    36,    33,     0,    45,    84,    85,    87,
-       0,    89,    88,    86
+       0,     0,     0,     0,     0,     0,     0,    27,     0,     0,
+       0,    30,    31,    32,    26,    25,     0,     0,     0,    28,
+       0,   161,    23,    22,    15,    24,    16,    17,    18,    10,
+      11,    12,    13,    14,     8,     9,     5,     7,     6,     4,
+       3,    19,    20,    21,     0,     0,     0,     0,     0,     0,
+      77,     0,    60,    61,    62,    63,    64,    71,    73,   123,
+      75,    76,     0,   116,     0,   104,   100,   103,   105,   109,
+     116,    96,   101,     0,    35,    34,     0,     0,     0,     0,
+       0,   159,    29,     1,   162,     2,     0,     0,     0,     0,
+      33,     0,   123,   100,     0,     0,    71,    73,     0,   106,
+       0,   112,     0,     0,     0,     0,     0,     0,   114,     0,
+       0,   137,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,   102,   124,   116,    72,    74,   123,
+     116,   116,     0,     0,     0,   107,   108,   116,   110,   111,
+     130,   133,   128,     0,   139,    78,     0,    80,   160,     0,
+     125,     0,    44,     0,    46,     0,     0,    42,    69,    68,
+     113,     0,   117,     0,   116,   119,    99,    97,    98,   115,
+       0,   131,     0,   137,     0,   127,     0,    66,     0,     0,
+       0,   138,   140,     0,     0,   137,     0,     0,     0,    55,
+      56,    57,    58,    59,    49,     0,     0,     0,     0,    70,
+     116,   116,   116,   120,   132,     0,    84,   128,    69,     0,
+      65,     0,   148,     0,     0,   156,     0,   150,   151,   152,
+     153,   154,   155,     0,   139,   139,    82,    80,    79,     0,
+     126,     0,    53,     0,     0,    46,    43,    40,     0,   118,
+     122,   121,   135,     0,    86,   129,    66,   149,   144,     0,
+     157,     0,   146,   143,   141,   142,    81,   158,    45,    54,
+       0,    51,    47,     0,     0,    40,   139,   133,     0,   139,
+      88,    67,   145,   147,    48,    40,    38,     0,   136,   134,
+      85,    87,     0,    83,    52,     0,    41,    39,    37,    38,
+       0,    50,    36,    89,    91,    93,     0,     0,    95,    94,
+      90,    92
 };
 
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -249,  -249,   294,  -249,  -249,  -249,  -249,  -249,  -249,  -249,
-    -249,  -249,  -249,  -248,  -249,  -249,  -249,    79,   121,  -249,
-    -249,  -249,  -249,    71,  -134,   160,   -45,  -249,  -249,    92,
-     136,  -108,  -249,  -249,  -249,    28,  -249,  -249,  -249,   -48,
-      72,    -3,   315,   -65,   -97,  -177,  -249,   116,  -162,    57,
-    -249,   -93,  -190,  -249,  -249,  -249,  -249,  -249,  -249
+    -181,  -181,   297,  -181,  -181,  -181,  -181,  -181,  -181,  -181,
+    -181,  -181,  -181,  -181,    22,  -120,  -181,  -181,  -181,    81,
+     122,  -181,  -181,  -181,  -181,    72,  -137,   165,   -46,  -181,
+    -181,    92,   138,  -113,  -181,  -181,  -181,    27,  -181,  -181,
+    -181,   -48,    75,    -3,   321,   -66,  -100,  -180,  -181,   119,
+    -164,    60,  -181,  -141,  -155,  -181,  -181,  -181,  -181,  -181,
+    -181
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int16 yydefgoto[] =
 {
-       0,    19,    20,    21,    22,    23,    24,    25,    26,    27,
-      28,    29,    30,   261,    31,    32,    33,   193,   151,   257,
-     191,    62,    34,   207,    63,   120,    64,    35,    36,   182,
-     144,    37,   241,   267,   280,   287,   288,    38,    65,    66,
-      67,   177,    69,    98,    70,   148,   138,   172,   139,   170,
-     264,   142,   178,   179,   220,    39,    40,    41,    82
+       0,    20,    21,    22,    23,    24,    25,    26,    27,    28,
+      29,    30,    31,    32,   288,   264,    33,    34,    35,   196,
+     154,   260,   194,    64,    36,   210,    65,   123,    66,    37,
+      38,   185,   147,    39,   244,   270,   283,   293,   294,    40,
+      67,    68,    69,   180,    71,   101,    72,   151,   141,   175,
+     142,   173,   267,   145,   181,   182,   223,    41,    42,    43,
+      85
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -852,76 +860,76 @@ static const yytype_int16 yydefgoto[] =
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-      68,    68,   131,   105,    90,   149,   174,   227,   112,   204,
-       1,     2,    96,   247,   274,   147,    72,     3,     4,    73,
-       5,    97,   129,    74,   283,     6,     7,     8,     9,    10,
-     229,   251,   252,    11,    12,    13,   230,   245,    89,   248,
-     239,   121,    76,   130,   167,   113,    91,   231,    14,    15,
-      97,   281,   132,   133,   246,   168,   160,    16,   157,   198,
-      48,    17,   159,   162,    18,   145,    49,   161,   282,   166,
-     103,   104,   243,   275,   155,   199,   278,   203,    75,    50,
-      51,    52,    53,    54,    48,   102,    77,   147,   277,   225,
-      49,   103,   104,   122,   128,    78,   200,   122,   123,   103,
-     104,    80,   197,    50,    51,    52,    53,    54,   210,    46,
-      81,    47,    55,    56,    57,    58,    59,    83,    60,    61,
-     255,    42,    43,    84,    44,    45,   211,   212,   205,    48,
-     100,   101,   236,   237,   238,    49,    55,    56,   126,    58,
-      59,    85,    60,   127,   -64,   119,   175,    86,    50,    51,
-      52,    53,    54,   213,    87,   214,   215,   216,   217,   218,
-     219,   221,   222,    48,   124,   125,   103,   104,   147,    88,
-     103,   104,    92,   209,   176,   135,   136,   223,   291,   292,
-      48,    55,    56,    89,    58,    59,    49,    60,   289,    97,
-      99,   106,   107,   289,   186,   187,   188,   189,   190,    50,
-      51,    52,    53,    54,   108,   244,    48,   109,   111,   114,
-     249,   110,    49,   115,   116,    55,    56,   250,    58,    59,
-     118,    95,   117,   140,   134,    50,    51,    52,    53,    54,
-     137,    48,    55,    56,    89,    58,    59,    49,    60,   141,
-     146,   143,    89,     4,   150,   270,   152,   153,   156,   158,
-      50,    51,    52,    53,    54,   154,   122,   163,    93,    94,
-      89,    58,    59,   164,    95,   165,   169,   171,   173,   181,
-     180,   183,   184,   185,   194,   192,   195,   119,   202,   201,
-     206,   208,   226,    55,    56,    89,    58,    59,   228,    95,
-     233,   234,   235,   240,   254,   258,   260,   265,   256,   263,
-     269,   262,   266,   271,   273,   272,   279,   286,   284,   285,
-     290,   259,    79,   232,   268,   196,   253,   224,   293,    71,
-     242,   276
+      70,    70,   134,   152,   108,    93,   177,   230,   115,   248,
+     207,   124,     1,     2,    99,   150,   250,    74,   132,     3,
+       4,   284,     5,    48,    76,    49,   249,     6,     7,     8,
+       9,    10,   206,   100,    92,    11,    12,    13,   285,   133,
+     100,   242,   251,   170,   228,   116,    75,   125,    94,    78,
+      14,    15,   126,    77,   171,   135,   136,    50,   201,    16,
+     160,   106,   107,    17,   162,   165,    18,   148,   105,   254,
+     255,   169,   246,    50,   202,   163,   158,   103,   104,    51,
+      19,    79,   106,   107,    80,    50,   164,   150,   280,   106,
+     107,    51,    52,    53,    54,    55,    56,   131,   203,    44,
+      45,   213,    46,    47,    52,    53,    54,    55,    56,    57,
+      58,   278,    60,    61,   281,    98,   232,    82,   258,   214,
+     215,    83,   233,   127,   128,    57,    58,    59,    60,    61,
+     208,    62,    63,   234,   239,   240,   241,    57,    58,   129,
+      60,    61,   125,    62,   130,   277,   216,   200,   217,   218,
+     219,   220,   221,   222,    84,   286,    89,   -69,   122,   106,
+     107,   189,   190,   191,   192,   193,   224,   225,   150,   106,
+     107,    86,    50,   298,   299,    87,   212,    88,    51,    50,
+     226,   138,   139,    90,    91,    51,    95,   102,   100,   178,
+     295,    52,    53,    54,    55,    56,   109,   295,    52,    53,
+      54,    55,    56,   112,   113,   110,   111,   114,   247,   117,
+     118,   119,   120,   252,   121,   137,   140,   179,   143,   144,
+     253,   149,     4,    50,    57,    58,    92,    60,    61,    51,
+      62,    57,    58,    92,    60,    61,   146,    62,    92,   153,
+     155,    50,    52,    53,    54,    55,    56,    51,   273,   156,
+     157,   125,   159,   161,   166,   167,   168,   183,   172,   174,
+      52,    53,    54,    55,    56,   176,   184,   186,   187,   188,
+     197,   195,   198,   122,   204,    96,    97,    92,    60,    61,
+     209,    98,   211,   229,   236,   205,   231,   237,   238,   257,
+     259,   261,   263,    57,    58,    92,    60,    61,   243,    98,
+     265,   268,   266,   269,   272,   274,   275,   276,   282,   287,
+     290,   292,   289,   291,   297,    81,   262,   235,   271,   256,
+     300,   296,   227,   199,   301,    73,   245,   279
 };
 
 static const yytype_int16 yycheck[] =
 {
-       3,     4,    99,    68,    49,   113,   140,   184,    24,   171,
-       4,     5,    60,    36,   262,   112,    72,    11,    12,     8,
-      14,    26,    56,    45,   272,    19,    20,    21,    22,    23,
-      18,   221,   222,    27,    28,    29,    24,    18,    72,    62,
-     202,    25,    72,    77,    61,    61,    49,    35,    42,    43,
-      26,    18,   100,   101,    35,    72,    61,    51,   123,    56,
-      18,    55,   127,   128,    58,   110,    24,    72,    35,   134,
-      75,    76,   206,   263,   119,    72,   266,   170,    47,    37,
-      38,    39,    40,    41,    18,    61,    72,   184,   265,   182,
-      24,    75,    76,    72,    97,    56,   161,    72,    77,    75,
-      76,     0,    77,    37,    38,    39,    40,    41,    17,     7,
-       3,     9,    70,    71,    72,    73,    74,    72,    76,    77,
-     228,     6,     7,    72,     9,    10,    35,    36,   173,    18,
-      77,    78,   197,   198,   199,    24,    70,    71,    72,    73,
-      74,    72,    76,    77,    25,    26,    35,     9,    37,    38,
-      39,    40,    41,    62,    72,    64,    65,    66,    67,    68,
-      69,    49,    50,    18,    70,    71,    75,    76,   265,    72,
-      75,    76,    44,   176,    63,   103,   104,   180,    13,    14,
-      18,    70,    71,    72,    73,    74,    24,    76,   285,    26,
-      24,    47,    72,   290,    30,    31,    32,    33,    34,    37,
-      38,    39,    40,    41,    72,   208,    18,    51,    57,    24,
-     213,    64,    24,    54,    72,    70,    71,   220,    73,    74,
-      44,    76,    54,    46,    72,    37,    38,    39,    40,    41,
-      72,    18,    70,    71,    72,    73,    74,    24,    76,    48,
-      73,    72,    72,    12,    72,   248,    72,    54,    25,    44,
-      37,    38,    39,    40,    41,    72,    72,    25,    70,    71,
-      72,    73,    74,    25,    76,    25,    52,    26,    24,    26,
-      64,    45,    26,    25,    24,    26,    72,    26,    53,    72,
-      26,    63,     7,    70,    71,    72,    73,    74,    61,    76,
-      25,    72,    24,    59,    72,    18,    26,    16,    70,    54,
-      18,    72,    60,    25,    25,    72,    15,    18,    25,    16,
-      26,   232,    18,   192,   243,   155,   224,   181,   290,     4,
-     204,   264
+       3,     4,   102,   116,    70,    51,   143,   187,    24,    18,
+     174,    25,     4,     5,    62,   115,    36,    72,    56,    11,
+      12,    18,    14,     7,    45,     9,    35,    19,    20,    21,
+      22,    23,   173,    26,    72,    27,    28,    29,    35,    77,
+      26,   205,    62,    61,   185,    61,     8,    72,    51,    72,
+      42,    43,    77,    47,    72,   103,   104,    18,    56,    51,
+     126,    75,    76,    55,   130,   131,    58,   113,    61,   224,
+     225,   137,   209,    18,    72,    61,   122,    77,    78,    24,
+      72,    72,    75,    76,    56,    18,    72,   187,   268,    75,
+      76,    24,    37,    38,    39,    40,    41,   100,   164,     6,
+       7,    17,     9,    10,    37,    38,    39,    40,    41,    70,
+      71,   266,    73,    74,   269,    76,    18,    72,   231,    35,
+      36,     0,    24,    70,    71,    70,    71,    72,    73,    74,
+     176,    76,    77,    35,   200,   201,   202,    70,    71,    72,
+      73,    74,    72,    76,    77,   265,    62,    77,    64,    65,
+      66,    67,    68,    69,     3,   275,     9,    25,    26,    75,
+      76,    30,    31,    32,    33,    34,    49,    50,   268,    75,
+      76,    72,    18,    13,    14,    72,   179,    72,    24,    18,
+     183,   106,   107,    72,    72,    24,    44,    24,    26,    35,
+     290,    37,    38,    39,    40,    41,    47,   297,    37,    38,
+      39,    40,    41,    51,    64,    72,    72,    57,   211,    24,
+      54,    72,    54,   216,    44,    72,    72,    63,    46,    48,
+     223,    73,    12,    18,    70,    71,    72,    73,    74,    24,
+      76,    70,    71,    72,    73,    74,    72,    76,    72,    72,
+      72,    18,    37,    38,    39,    40,    41,    24,   251,    54,
+      72,    72,    25,    44,    25,    25,    25,    64,    52,    26,
+      37,    38,    39,    40,    41,    24,    26,    45,    26,    25,
+      24,    26,    72,    26,    72,    70,    71,    72,    73,    74,
+      26,    76,    63,     7,    25,    53,    61,    72,    24,    72,
+      70,    18,    26,    70,    71,    72,    73,    74,    59,    76,
+      72,    16,    54,    60,    18,    25,    72,    25,    15,    72,
+      16,   289,    25,    18,    26,    18,   235,   195,   246,   227,
+      70,    72,   184,   158,   297,     4,   207,   267
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
@@ -929,35 +937,36 @@ static const yytype_int16 yycheck[] =
 static const yytype_uint8 yystos[] =
 {
        0,     4,     5,    11,    12,    14,    19,    20,    21,    22,
-      23,    27,    28,    29,    42,    43,    51,    55,    58,    80,
-      81,    82,    83,    84,    85,    86,    87,    88,    89,    90,
-      91,    93,    94,    95,   101,   106,   107,   110,   116,   134,
-     135,   136,     6,     7,     9,    10,     7,     9,    18,    24,
-      37,    38,    39,    40,    41,    70,    71,    72,    73,    74,
-      76,    77,   100,   103,   105,   117,   118,   119,   120,   121,
-     123,   121,    72,     8,    45,    47,    72,    72,    56,    81,
-       0,     3,   137,    72,    72,    72,     9,    72,    72,    72,
-     105,   120,    44,    70,    71,    76,   118,    26,   122,    24,
-      77,    78,    61,    75,    76,   122,    47,    72,    72,    51,
-      64,    57,    24,    61,    24,    54,    72,    54,    44,    26,
-     104,    25,    72,    77,    70,    71,    72,    77,   120,    56,
-      77,   123,   118,   118,    72,   119,   119,    72,   125,   127,
-      46,    48,   130,    72,   109,   105,    73,   123,   124,   110,
-      72,    97,    72,    54,    72,   105,    25,   122,    44,   122,
-      61,    72,   122,    25,    25,    25,   122,    61,    72,    52,
-     128,    26,   126,    24,   103,    35,    63,   120,   131,   132,
-      64,    26,   108,    45,    26,    25,    30,    31,    32,    33,
-      34,    99,    26,    96,    24,    72,   104,    77,    56,    72,
-     122,    72,    53,   130,   127,   105,    26,   102,    63,   120,
-      17,    35,    36,    62,    64,    65,    66,    67,    68,    69,
-     133,    49,    50,   120,   109,   130,     7,   124,    61,    18,
-      24,    35,    97,    25,    72,    24,   122,   122,   122,   127,
-      59,   111,   126,   103,   120,    18,    35,    36,    62,   120,
-     120,   131,   131,   108,    72,   110,    70,    98,    18,    96,
-      26,    92,    72,    54,   129,    16,    60,   112,   102,    18,
-     120,    25,    72,    25,    92,   131,   128,   124,   131,    15,
-     113,    18,    35,    92,    25,    16,    18,   114,   115,   123,
-      26,    13,    14,   114
+      23,    27,    28,    29,    42,    43,    51,    55,    58,    72,
+      80,    81,    82,    83,    84,    85,    86,    87,    88,    89,
+      90,    91,    92,    95,    96,    97,   103,   108,   109,   112,
+     118,   136,   137,   138,     6,     7,     9,    10,     7,     9,
+      18,    24,    37,    38,    39,    40,    41,    70,    71,    72,
+      73,    74,    76,    77,   102,   105,   107,   119,   120,   121,
+     122,   123,   125,   123,    72,     8,    45,    47,    72,    72,
+      56,    81,    72,     0,     3,   139,    72,    72,    72,     9,
+      72,    72,    72,   107,   122,    44,    70,    71,    76,   120,
+      26,   124,    24,    77,    78,    61,    75,    76,   124,    47,
+      72,    72,    51,    64,    57,    24,    61,    24,    54,    72,
+      54,    44,    26,   106,    25,    72,    77,    70,    71,    72,
+      77,   122,    56,    77,   125,   120,   120,    72,   121,   121,
+      72,   127,   129,    46,    48,   132,    72,   111,   107,    73,
+     125,   126,   112,    72,    99,    72,    54,    72,   107,    25,
+     124,    44,   124,    61,    72,   124,    25,    25,    25,   124,
+      61,    72,    52,   130,    26,   128,    24,   105,    35,    63,
+     122,   133,   134,    64,    26,   110,    45,    26,    25,    30,
+      31,    32,    33,    34,   101,    26,    98,    24,    72,   106,
+      77,    56,    72,   124,    72,    53,   132,   129,   107,    26,
+     104,    63,   122,    17,    35,    36,    62,    64,    65,    66,
+      67,    68,    69,   135,    49,    50,   122,   111,   132,     7,
+     126,    61,    18,    24,    35,    99,    25,    72,    24,   124,
+     124,   124,   129,    59,   113,   128,   105,   122,    18,    35,
+      36,    62,   122,   122,   133,   133,   110,    72,   112,    70,
+     100,    18,    98,    26,    94,    72,    54,   131,    16,    60,
+     114,   104,    18,   122,    25,    72,    25,    94,   133,   130,
+     126,   133,    15,   115,    18,    35,    94,    72,    93,    25,
+      16,    18,    93,   116,   117,   125,    72,    26,    13,    14,
+      70,   116
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
@@ -965,20 +974,21 @@ static const yytype_uint8 yyr1[] =
 {
        0,    79,    80,    81,    81,    81,    81,    81,    81,    81,
       81,    81,    81,    81,    81,    81,    81,    81,    81,    81,
-      81,    81,    81,    81,    82,    83,    84,    85,    86,    87,
-      88,    89,    90,    91,    91,    92,    92,    93,    94,    95,
-      95,    96,    96,    97,    97,    97,    97,    97,    97,    98,
-      99,    99,    99,    99,    99,   100,   100,   100,   100,   100,
-     101,   102,   102,   103,   104,   104,   105,   105,   105,   105,
-     105,   105,   105,   106,   107,   108,   108,   109,   110,   111,
-     111,   112,   112,   113,   113,   114,   114,   115,   115,   115,
-     116,   117,   117,   117,   118,   118,   118,   118,   118,   119,
-     119,   119,   119,   120,   120,   120,   121,   121,   121,   121,
-     122,   122,   122,   122,   122,   122,   122,   123,   123,   124,
-     124,   125,   126,   126,   127,   127,   127,   128,   128,   129,
-     129,   130,   130,   131,   131,   131,   131,   132,   132,   132,
-     132,   132,   132,   132,   133,   133,   133,   133,   133,   133,
-     133,   133,   134,   135,   136,   137,   137
+      81,    81,    81,    81,    81,    82,    83,    84,    85,    85,
+      86,    87,    88,    89,    90,    91,    92,    92,    93,    93,
+      94,    94,    95,    96,    97,    97,    98,    98,    99,    99,
+      99,    99,    99,    99,   100,   101,   101,   101,   101,   101,
+     102,   102,   102,   102,   102,   103,   104,   104,   105,   106,
+     106,   107,   107,   107,   107,   107,   107,   107,   108,   109,
+     110,   110,   111,   112,   113,   113,   114,   114,   115,   115,
+     115,   116,   116,   117,   117,   117,   118,   119,   119,   119,
+     120,   120,   120,   120,   120,   121,   121,   121,   121,   122,
+     122,   122,   123,   123,   123,   123,   124,   124,   124,   124,
+     124,   124,   124,   125,   125,   126,   126,   127,   128,   128,
+     129,   129,   129,   130,   130,   131,   131,   132,   132,   133,
+     133,   133,   133,   134,   134,   134,   134,   134,   134,   134,
+     135,   135,   135,   135,   135,   135,   135,   135,   136,   137,
+     138,   139,   139
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
@@ -986,20 +996,21 @@ static const yytype_int8 yyr2[] =
 {
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       3,     2,     2,    10,     9,     0,     3,     5,     7,     5,
-       8,     0,     3,     5,     2,     7,     4,     6,     3,     1,
-       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       6,     0,     3,     4,     0,     3,     1,     2,     1,     2,
-       1,     1,     1,     4,     6,     0,     3,     3,     9,     0,
-       3,     0,     2,     0,     3,     1,     3,     1,     2,     2,
-       2,     4,     4,     4,     1,     1,     3,     1,     1,     1,
-       2,     3,     3,     1,     3,     3,     2,     4,     2,     4,
-       0,     3,     5,     3,     4,     5,     5,     1,     3,     1,
-       3,     2,     0,     3,     1,     2,     3,     0,     5,     0,
-       2,     0,     2,     0,     1,     3,     3,     3,     3,     4,
-       3,     4,     2,     3,     1,     1,     1,     1,     1,     1,
-       1,     2,     7,     2,     4,     0,     1
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     2,
+       1,     1,     1,     3,     2,     2,    11,    10,     0,     1,
+       0,     3,     5,     7,     5,     8,     0,     3,     5,     2,
+       7,     4,     6,     3,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     6,     0,     3,     4,     0,
+       3,     1,     2,     1,     2,     1,     1,     1,     4,     6,
+       0,     3,     3,     9,     0,     3,     0,     2,     0,     3,
+       5,     1,     3,     1,     2,     2,     2,     4,     4,     4,
+       1,     1,     3,     1,     1,     1,     2,     3,     3,     1,
+       3,     3,     2,     4,     2,     4,     0,     3,     5,     3,
+       4,     5,     5,     1,     3,     1,     3,     2,     0,     3,
+       1,     2,     3,     0,     5,     0,     2,     0,     2,     0,
+       1,     3,     3,     3,     3,     4,     3,     4,     2,     3,
+       1,     1,     1,     1,     1,     1,     1,     2,     7,     2,
+       4,     0,     1
 };
 
 
@@ -1861,141 +1872,185 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* commands: command_wrapper opt_semicolon  */
-#line 233 "yacc_sql.y"
+#line 236 "yacc_sql.y"
   {
     std::unique_ptr<ParsedSqlNode> sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[-1].sql_node));
     sql_result->add_sql_node(std::move(sql_node));
   }
-#line 1870 "yacc_sql.cpp"
+#line 1881 "yacc_sql.cpp"
     break;
 
-  case 24: /* exit_stmt: EXIT  */
-#line 264 "yacc_sql.y"
+  case 25: /* exit_stmt: EXIT  */
+#line 268 "yacc_sql.y"
          {
       (void)yynerrs;  // 这么写为了消除yynerrs未使用的告警。如果你有更好的方法欢迎提PR
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXIT);
     }
-#line 1879 "yacc_sql.cpp"
+#line 1890 "yacc_sql.cpp"
     break;
 
-  case 25: /* help_stmt: HELP  */
-#line 270 "yacc_sql.y"
+  case 26: /* help_stmt: HELP  */
+#line 274 "yacc_sql.y"
          {
       (yyval.sql_node) = new ParsedSqlNode(SCF_HELP);
     }
-#line 1887 "yacc_sql.cpp"
+#line 1898 "yacc_sql.cpp"
     break;
 
-  case 26: /* sync_stmt: SYNC  */
-#line 275 "yacc_sql.y"
+  case 27: /* sync_stmt: SYNC  */
+#line 279 "yacc_sql.y"
          {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SYNC);
     }
-#line 1895 "yacc_sql.cpp"
+#line 1906 "yacc_sql.cpp"
+    break;
+
+  case 28: /* vacuum_stmt: ID  */
+#line 286 "yacc_sql.y"
+       {
+      (yyval.sql_node) = new ParsedSqlNode(strcasecmp((yyvsp[0].string), "vacuum") == 0 ? SCF_VACUUM : SCF_ERROR);
+      free((yyvsp[0].string));
+    }
+#line 1915 "yacc_sql.cpp"
     break;
 
-  case 27: /* begin_stmt: TRX_BEGIN  */
-#line 281 "yacc_sql.y"
+  case 29: /* vacuum_stmt: ID ID  */
+#line 290 "yacc_sql.y"
+            {
+      (yyval.sql_node) = new ParsedSqlNode(strcasecmp((yyvsp[-1].string), "vacuum") == 0 ? SCF_VACUUM : SCF_ERROR);
+      (yyval.sql_node)->vacuum.relation_name = (yyvsp[0].string);
+      free((yyvsp[-1].string));
+      free((yyvsp[0].string));
+    }
+#line 1926 "yacc_sql.cpp"
+    break;
+
+  case 30: /* begin_stmt: TRX_BEGIN  */
+#line 299 "yacc_sql.y"
                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_BEGIN);
     }
-#line 1903 "yacc_sql.cpp"
+#line 1934 "yacc_sql.cpp"
     break;
 
-  case 28: /* commit_stmt: TRX_COMMIT  */
-#line 287 "yacc_sql.y"
+  case 31: /* commit_stmt: TRX_COMMIT  */
+#line 305 "yacc_sql.y"
                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_COMMIT);
     }
-#line 1911 "yacc_sql.cpp"
+#line 1942 "yacc_sql.cpp"
     break;
 
-  case 29: /* rollback_stmt: TRX_ROLLBACK  */
-#line 293 "yacc_sql.y"
+  case 32: /* rollback_stmt: TRX_ROLLBACK  */
+#line 311 "yacc_sql.y"
                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_ROLLBACK);
     }
-#line 1919 "yacc_sql.cpp"
+#line 1950 "yacc_sql.cpp"
     break;
 
-  case 30: /* drop_table_stmt: DROP TABLE ID  */
-#line 299 "yacc_sql.y"
+  case 33: /* drop_table_stmt: DROP TABLE ID  */
+#line 317 "yacc_sql.y"
                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_TABLE);
       (yyval.sql_node)->drop_table.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 1929 "yacc_sql.cpp"
+#line 1960 "yacc_sql.cpp"
     break;
 
-  case 31: /* show_tables_stmt: SHOW TABLES  */
-#line 306 "yacc_sql.y"
+  case 34: /* show_tables_stmt: SHOW TABLES  */
+#line 324 "yacc_sql.y"
                 {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SHOW_TABLES);
     }
-#line 1937 "yacc_sql.cpp"
+#line 1968 "yacc_sql.cpp"
     break;
 
-  case 32: /* desc_table_stmt: DESC ID  */
-#line 312 "yacc_sql.y"
+  case 35: /* desc_table_stmt: DESC ID  */
+#line 330 "yacc_sql.y"
              {
 	(yyval.sql_node) = new ParsedSqlNode(SCF_DESC_TABLE);
 	(yyval.sql_node)->desc_table.relation_name = (yyvsp[0].string);
 	free((yyvsp[0].string));
     }
-#line 1947 "yacc_sql.cpp"
+#line 1978 "yacc_sql.cpp"
     break;
 
-  case 33: /* create_index_stmt: CREATE UNIQUE INDEX ID ON ID LBRACE ID multi_attribute_names RBRACE  */
-#line 321 "yacc_sql.y"
+  case 36: /* create_index_stmt: CREATE UNIQUE INDEX ID ON ID LBRACE ID multi_attribute_names RBRACE opt_key_compressed  */
+#line 339 "yacc_sql.y"
   {
 	(yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_INDEX);
 	CreateIndexSqlNode &create_index = (yyval.sql_node)->create_index;
-	create_index.index_name = (yyvsp[-6].string);
-	create_index.relation_name = (yyvsp[-4].string);
+	create_index.index_name = (yyvsp[-7].string);
+	create_index.relation_name = (yyvsp[-5].string);
 	create_index.is_unique_ = true;
-	if ((yyvsp[-1].multi_attribute_names) != nullptr) {
-	create_index.multi_attribute_names.swap(*(yyvsp[-1].multi_attribute_names));
+	create_index.key_compressed = (yyvsp[0].number);
+	if ((yyvsp[-2].multi_attribute_names) != nullptr) {
+	create_index.multi_attribute_names.swap(*(yyvsp[-2].multi_attribute_names));
 	}
-	create_index.multi_attribute_names.emplace_back((yyvsp[-2].string));
+	create_index.multi_attribute_names.emplace_back((yyvsp[-3].string));
 	std::reverse(create_index.multi_attribute_names.begin(), create_index.multi_attribute_names.end());
-	free((yyvsp[-6].string));
-	free((yyvsp[-4].string));
-	free((yyvsp[-2].string));
+	free((yyvsp[-7].string));
+	free((yyvsp[-5].string));
+	free((yyvsp[-3].string));
   }
-#line 1967 "yacc_sql.cpp"
+#line 1999 "yacc_sql.cpp"
     break;
 
-  case 34: /* create_index_stmt: CREATE INDEX ID ON ID LBRACE ID multi_attribute_names RBRACE  */
-#line 337 "yacc_sql.y"
+  case 37: /* create_index_stmt: CREATE INDEX ID ON ID LBRACE ID multi_attribute_names RBRACE opt_key_compressed  */
+#line 356 "yacc_sql.y"
   {
 	(yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_INDEX);
 	CreateIndexSqlNode &create_index = (yyval.sql_node)->create_index;
-	create_index.index_name = (yyvsp[-6].string);
-	create_index.relation_name = (yyvsp[-4].string);
+	create_index.index_name = (yyvsp[-7].string);
+	create_index.relation_name = (yyvsp[-5].string);
 	create_index.is_unique_ = false;
-	if ((yyvsp[-1].multi_attribute_names) != nullptr) {
-	create_index.multi_attribute_names.swap(*(yyvsp[-1].multi_attribute_names));
+	create_index.key_compressed = (yyvsp[0].number);
+	if ((yyvsp[-2].multi_attribute_names) != nullptr) {
+	create_index.multi_attribute_names.swap(*(yyvsp[-2].multi_attribute_names));
 	}
-	create_index.multi_attribute_names.emplace_back((yyvsp[-2].string));
+	create_index.multi_attribute_names.emplace_back((yyvsp[-3].string));
 	std::reverse(create_index.multi_attribute_names.begin(), create_index.multi_attribute_names.end());
-	free((yyvsp[-6].string));
-	free((yyvsp[-4].string));
-	free((yyvsp[-2].string));
+	free((yyvsp[-7].string));
+	free((yyvsp[-5].string));
+	free((yyvsp[-3].string));
   }
-#line 1987 "yacc_sql.cpp"
+#line 2020 "yacc_sql.cpp"
     break;
 
-  case 35: /* multi_attribute_names: %empty  */
-#line 356 "yacc_sql.y"
+  case 38: /* opt_key_compressed: %empty  */
+#line 377 "yacc_sql.y"
+  {
+	(yyval.number) = 0;
+  }
+#line 2028 "yacc_sql.cpp"
+    break;
+
+  case 39: /* opt_key_compressed: ID  */
+#line 381 "yacc_sql.y"
+  {
+	const bool is_compressed = strcasecmp((yyvsp[0].string), "compressed") == 0;
+	free((yyvsp[0].string));
+	if (!is_compressed) {
+	  yyerror(&(yylsp[0]), sql_string, sql_result, scanner, "syntax error, unexpected identifier after CREATE INDEX");
+	  YYABORT;
+	}
+	(yyval.number) = 1;
+  }
+#line 2042 "yacc_sql.cpp"
+    break;
+
+  case 40: /* multi_attribute_names: %empty  */
+#line 394 "yacc_sql.y"
   {
 	(yyval.multi_attribute_names) = nullptr;
   }
-#line 1995 "yacc_sql.cpp"
+#line 2050 "yacc_sql.cpp"
     break;
 
-  case 36: /* multi_attribute_names: COMMA ID multi_attribute_names  */
-#line 359 "yacc_sql.y"
+  case 41: /* multi_attribute_names: COMMA ID multi_attribute_names  */
+#line 397 "yacc_sql.y"
                                     {
 	if ((yyvsp[0].multi_attribute_names) != nullptr) {
 		(yyval.multi_attribute_names) = (yyvsp[0].multi_attribute_names);
@@ -2005,11 +2060,11 @@ yyreduce:
 	(yyval.multi_attribute_names)->emplace_back((yyvsp[-1].string));
 	free((yyvsp[-1].string));
   }
-#line 2009 "yacc_sql.cpp"
+#line 2064 "yacc_sql.cpp"
     break;
 
-  case 37: /* drop_index_stmt: DROP INDEX ID ON ID  */
-#line 372 "yacc_sql.y"
+  case 42: /* drop_index_stmt: DROP INDEX ID ON ID  */
+#line 410 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_INDEX);
       (yyval.sql_node)->drop_index.index_name = (yyvsp[-2].string);
@@ -2017,11 +2072,11 @@ yyreduce:
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 2021 "yacc_sql.cpp"
+#line 2076 "yacc_sql.cpp"
     break;
 
-  case 38: /* create_table_stmt: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE  */
-#line 383 "yacc_sql.y"
+  case 43: /* create_table_stmt: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE  */
+#line 421 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_TABLE);
       CreateTableSqlNode &create_table = (yyval.sql_node)->create_table;
@@ -2037,11 +2092,11 @@ yyreduce:
       std::reverse(create_table.attr_infos.begin(), create_table.attr_infos.end());
       delete (yyvsp[-2].attr_info);
     }
-#line 2041 "yacc_sql.cpp"
+#line 2096 "yacc_sql.cpp"
     break;
 
-  case 39: /* create_view_stmt: CREATE VIEW ID AS select_stmt  */
-#line 401 "yacc_sql.y"
+  case 44: /* create_view_stmt: CREATE VIEW ID AS select_stmt  */
+#line 439 "yacc_sql.y"
                                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_VIEW);
       CreateViewSqlNode &create_view = (yyval.sql_node)->create_view;
@@ -2050,11 +2105,11 @@ yyreduce:
       free((yyvsp[-2].string));
 
     }
-#line 2054 "yacc_sql.cpp"
+#line 2109 "yacc_sql.cpp"
     break;
 
-  case 40: /* create_view_stmt: CREATE VIEW ID LBRACE rel_attr_list RBRACE AS select_stmt  */
-#line 408 "yacc_sql.y"
+  case 45: /* create_view_stmt: CREATE VIEW ID LBRACE rel_attr_list RBRACE AS select_stmt  */
+#line 446 "yacc_sql.y"
                                                                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_VIEW);
       CreateViewSqlNode &create_view = (yyval.sql_node)->create_view;
@@ -2062,19 +2117,19 @@ yyreduce:
       create_view.select_sql_node = (yyvsp[0].sql_node)->selection;
       free((yyvsp[-5].string));
     }
-#line 2066 "yacc_sql.cpp"
+#line 2121 "yacc_sql.cpp"
     break;
 
-  case 41: /* attr_def_list: %empty  */
-#line 419 "yacc_sql.y"
+  case 46: /* attr_def_list: %empty  */
+#line 457 "yacc_sql.y"
     {
       (yyval.attr_infos) = nullptr;
     }
-#line 2074 "yacc_sql.cpp"
+#line 2129 "yacc_sql.cpp"
     break;
 
-  case 42: /* attr_def_list: COMMA attr_def attr_def_list  */
-#line 423 "yacc_sql.y"
+  case 47: /* attr_def_list: COMMA attr_def attr_def_list  */
+#line 461 "yacc_sql.y"
     {
       if ((yyvsp[0].attr_infos) != nullptr) {
         (yyval.attr_infos) = (yyvsp[0].attr_infos);
@@ -2084,11 +2139,11 @@ yyreduce:
       (yyval.attr_infos)->emplace_back(*(yyvsp[-1].attr_info));
       delete (yyvsp[-1].attr_info);
     }
-#line 2088 "yacc_sql.cpp"
+#line 2143 "yacc_sql.cpp"
     break;
 
-  case 43: /* attr_def: ID type LBRACE number RBRACE  */
-#line 436 "yacc_sql.y"
+  case 48: /* attr_def: ID type LBRACE number RBRACE  */
+#line 474 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[-3].number);
@@ -2097,11 +2152,11 @@ yyreduce:
       (yyval.attr_info)->nullable = true;
       free((yyvsp[-4].string));
     }
-#line 2101 "yacc_sql.cpp"
+#line 2156 "yacc_sql.cpp"
     break;
 
-  case 44: /* attr_def: ID type  */
-#line 445 "yacc_sql.y"
+  case 49: /* attr_def: ID type  */
+#line 483 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[0].number);
@@ -2110,11 +2165,11 @@ yyreduce:
       (yyval.attr_info)->nullable = true;
       free((yyvsp[-1].string));
     }
-#line 2114 "yacc_sql.cpp"
+#line 2169 "yacc_sql.cpp"
     break;
 
-  case 45: /* attr_def: ID type LBRACE number RBRACE NOT_T NULL_T  */
-#line 454 "yacc_sql.y"
+  case 50: /* attr_def: ID type LBRACE number RBRACE NOT_T NULL_T  */
+#line 492 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[-5].number);
@@ -2123,11 +2178,11 @@ yyreduce:
       (yyval.attr_info)->nullable = false;
       free((yyvsp[-6].string));
     }
-#line 2127 "yacc_sql.cpp"
+#line 2182 "yacc_sql.cpp"
     break;
 
-  case 46: /* attr_def: ID type NOT_T NULL_T  */
-#line 463 "yacc_sql.y"
+  case 51: /* attr_def: ID type NOT_T NULL_T  */
+#line 501 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[-2].number);
@@ -2136,11 +2191,11 @@ yyreduce:
       (yyval.attr_info)->nullable = false;
       free((yyvsp[-3].string));
     }
-#line 2140 "yacc_sql.cpp"
+#line 2195 "yacc_sql.cpp"
     break;
 
-  case 47: /* attr_def: ID type LBRACE number RBRACE NULL_T  */
-#line 472 "yacc_sql.y"
+  case 52: /* attr_def: ID type LBRACE number RBRACE NULL_T  */
+#line 510 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[-4].number);
@@ -2149,11 +2204,11 @@ yyreduce:
       (yyval.attr_info)->nullable = true;
       free((yyvsp[-5].string));
     }
-#line 2153 "yacc_sql.cpp"
+#line 2208 "yacc_sql.cpp"
     break;
 
-  case 48: /* attr_def: ID type NULL_T  */
-#line 481 "yacc_sql.y"
+  case 53: /* attr_def: ID type NULL_T  */
+#line 519 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[-1].number);
@@ -2162,77 +2217,77 @@ yyreduce:
       (yyval.attr_info)->nullable = true;
       free((yyvsp[-2].string));
     }
-#line 2166 "yacc_sql.cpp"
+#line 2221 "yacc_sql.cpp"
     break;
 
-  case 49: /* number: NUMBER  */
-#line 492 "yacc_sql.y"
+  case 54: /* number: NUMBER  */
+#line 530 "yacc_sql.y"
            {(yyval.number) = (yyvsp[0].number);}
-#line 2172 "yacc_sql.cpp"
+#line 2227 "yacc_sql.cpp"
     break;
 
-  case 50: /* type: INT_T  */
-#line 496 "yacc_sql.y"
+  case 55: /* type: INT_T  */
+#line 534 "yacc_sql.y"
                { (yyval.number)=INTS; }
-#line 2178 "yacc_sql.cpp"
+#line 2233 "yacc_sql.cpp"
     break;
 
-  case 51: /* type: STRING_T  */
-#line 497 "yacc_sql.y"
+  case 56: /* type: STRING_T  */
+#line 535 "yacc_sql.y"
                { (yyval.number)=CHARS; }
-#line 2184 "yacc_sql.cpp"
+#line 2239 "yacc_sql.cpp"
     break;
 
-  case 52: /* type: FLOAT_T  */
-#line 498 "yacc_sql.y"
+  case 57: /* type: FLOAT_T  */
+#line 536 "yacc_sql.y"
                { (yyval.number)=FLOATS; }
-#line 2190 "yacc_sql.cpp"
+#line 2245 "yacc_sql.cpp"
     break;
 
-  case 53: /* type: DATE_T  */
-#line 499 "yacc_sql.y"
+  case 58: /* type: DATE_T  */
+#line 537 "yacc_sql.y"
                { (yyval.number)=DATES; }
-#line 2196 "yacc_sql.cpp"
+#line 2251 "yacc_sql.cpp"
     break;
 
-  case 54: /* type: TEXT_T  */
-#line 500 "yacc_sql.y"
+  case 59: /* type: TEXT_T  */
+#line 538 "yacc_sql.y"
                { (yyval.number)=TEXTS; }
-#line 2202 "yacc_sql.cpp"
+#line 2257 "yacc_sql.cpp"
     break;
 
-  case 55: /* aggr_type: COUNT_T  */
-#line 505 "yacc_sql.y"
+  case 60: /* aggr_type: COUNT_T  */
+#line 543 "yacc_sql.y"
                { (yyval.number)=AGGR_COUNT; }
-#line 2208 "yacc_sql.cpp"
+#line 2263 "yacc_sql.cpp"
     break;
 
-  case 56: /* aggr_type: MIN_T  */
-#line 506 "yacc_sql.y"
+  case 61: /* aggr_type: MIN_T  */
+#line 544 "yacc_sql.y"
                { (yyval.number)=AGGR_MIN;   }
-#line 2214 "yacc_sql.cpp"
+#line 2269 "yacc_sql.cpp"
     break;
 
-  case 57: /* aggr_type: MAX_T  */
-#line 507 "yacc_sql.y"
+  case 62: /* aggr_type: MAX_T  */
+#line 545 "yacc_sql.y"
                { (yyval.number)=AGGR_MAX;   }
-#line 2220 "yacc_sql.cpp"
+#line 2275 "yacc_sql.cpp"
     break;
 
-  case 58: /* aggr_type: AVG_T  */
-#line 508 "yacc_sql.y"
+  case 63: /* aggr_type: AVG_T  */
+#line 546 "yacc_sql.y"
                { (yyval.number)=AGGR_AVG;   }
-#line 2226 "yacc_sql.cpp"
+#line 2281 "yacc_sql.cpp"
     break;
 
-  case 59: /* aggr_type: SUM_T  */
-#line 509 "yacc_sql.y"
+  case 64: /* aggr_type: SUM_T  */
+#line 547 "yacc_sql.y"
                { (yyval.number)=AGGR_SUM;   }
-#line 2232 "yacc_sql.cpp"
+#line 2287 "yacc_sql.cpp"
     break;
 
-  case 60: /* insert_stmt: INSERT INTO ID VALUES value_list multi_value_list  */
-#line 514 "yacc_sql.y"
+  case 65: /* insert_stmt: INSERT INTO ID VALUES value_list multi_value_list  */
+#line 552 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_INSERT);
       (yyval.sql_node)->insertion.relation_name = (yyvsp[-3].string);
@@ -2244,19 +2299,19 @@ yyreduce:
       delete (yyvsp[-1].value_list);
       free((yyvsp[-3].string));
     }
-#line 2248 "yacc_sql.cpp"
+#line 2303 "yacc_sql.cpp"
     break;
 
-  case 61: /* multi_value_list: %empty  */
-#line 529 "yacc_sql.y"
+  case 66: /* multi_value_list: %empty  */
+#line 567 "yacc_sql.y"
     {
       (yyval.multi_value_list) = nullptr;
     }
-#line 2256 "yacc_sql.cpp"
+#line 2311 "yacc_sql.cpp"
     break;
 
-  case 62: /* multi_value_list: COMMA value_list multi_value_list  */
-#line 533 "yacc_sql.y"
+  case 67: /* multi_value_list: COMMA value_list multi_value_list  */
+#line 571 "yacc_sql.y"
     {
       if ((yyvsp[0].multi_value_list) != nullptr) {
         (yyval.multi_value_list) = (yyvsp[0].multi_value_list);
@@ -2266,11 +2321,11 @@ yyreduce:
       (yyval.multi_value_list)->emplace_back(*(yyvsp[-1].value_list));
       delete (yyvsp[-1].value_list);
     }
-#line 2270 "yacc_sql.cpp"
+#line 2325 "yacc_sql.cpp"
     break;
 
-  case 63: /* value_list: LBRACE value value_list_body RBRACE  */
-#line 546 "yacc_sql.y"
+  case 68: /* value_list: LBRACE value value_list_body RBRACE  */
+#line 584 "yacc_sql.y"
     {
       if ((yyvsp[-1].value_list_body) != nullptr) {
         (yyval.value_list) = (yyvsp[-1].value_list_body);
@@ -2281,19 +2336,19 @@ yyreduce:
       std::reverse((yyval.value_list)->begin(), (yyval.value_list)->end());
       delete (yyvsp[-2].value);
     }
-#line 2285 "yacc_sql.cpp"
+#line 2340 "yacc_sql.cpp"
     break;
 
-  case 64: /* value_list_body: %empty  */
-#line 560 "yacc_sql.y"
+  case 69: /* value_list_body: %empty  */
+#line 598 "yacc_sql.y"
     {
       (yyval.value_list_body) = nullptr;
     }
-#line 2293 "yacc_sql.cpp"
+#line 2348 "yacc_sql.cpp"
     break;
 
-  case 65: /* value_list_body: COMMA value value_list_body  */
-#line 564 "yacc_sql.y"
+  case 70: /* value_list_body: COMMA value value_list_body  */
+#line 602 "yacc_sql.y"
     {
       if ((yyvsp[0].value_list_body) != nullptr) {
         (yyval.value_list_body) = (yyvsp[0].value_list_body);
@@ -2303,77 +2358,77 @@ yyreduce:
       (yyval.value_list_body)->emplace_back(*(yyvsp[-1].value));
       delete (yyvsp[-1].value);
     }
-#line 2307 "yacc_sql.cpp"
+#line 2362 "yacc_sql.cpp"
     break;
 
-  case 66: /* value: NUMBER  */
-#line 576 "yacc_sql.y"
+  case 71: /* value: NUMBER  */
+#line 614 "yacc_sql.y"
            {
       (yyval.value) = new Value((int)(yyvsp[0].number));
       (yyloc) = (yylsp[0]);
     }
-#line 2316 "yacc_sql.cpp"
+#line 2371 "yacc_sql.cpp"
     break;
 
-  case 67: /* value: '-' NUMBER  */
-#line 579 "yacc_sql.y"
+  case 72: /* value: '-' NUMBER  */
+#line 617 "yacc_sql.y"
                    {
       (yyval.value) = new Value(-(int)(yyvsp[0].number));
       (yyloc) = (yylsp[0]);
     }
-#line 2325 "yacc_sql.cpp"
+#line 2380 "yacc_sql.cpp"
     break;
 
-  case 68: /* value: FLOAT  */
-#line 582 "yacc_sql.y"
+  case 73: /* value: FLOAT  */
+#line 620 "yacc_sql.y"
               {
       (yyval.value) = new Value((float)(yyvsp[0].floats));
       (yyloc) = (yylsp[0]);
     }
-#line 2334 "yacc_sql.cpp"
+#line 2389 "yacc_sql.cpp"
     break;
 
-  case 69: /* value: '-' FLOAT  */
-#line 585 "yacc_sql.y"
+  case 74: /* value: '-' FLOAT  */
+#line 623 "yacc_sql.y"
                   {
       (yyval.value) = new Value(-(float)(yyvsp[0].floats));
       (yyloc) = (yylsp[0]);
     }
-#line 2343 "yacc_sql.cpp"
+#line 2398 "yacc_sql.cpp"
     break;
 
-  case 70: /* value: SSS  */
-#line 588 "yacc_sql.y"
+  case 75: /* value: SSS  */
+#line 626 "yacc_sql.y"
             {
       char *tmp = common::substr((yyvsp[0].string),1,strlen((yyvsp[0].string))-2);
       (yyval.value) = new Value(tmp);
       free(tmp);
     }
-#line 2353 "yacc_sql.cpp"
+#line 2408 "yacc_sql.cpp"
     break;
 
-  case 71: /* value: DATE_STR  */
-#line 592 "yacc_sql.y"
+  case 76: /* value: DATE_STR  */
+#line 630 "yacc_sql.y"
                  {
       char *tmp = common::substr((yyvsp[0].string),1,strlen((yyvsp[0].string))-2);
       (yyval.value) = new Value(DATES, tmp, 4, true);
       free(tmp);
     }
-#line 2363 "yacc_sql.cpp"
+#line 2418 "yacc_sql.cpp"
     break;
 
-  case 72: /* value: NULL_T  */
-#line 596 "yacc_sql.y"
+  case 77: /* value: NULL_T  */
+#line 634 "yacc_sql.y"
                {
       (yyval.value) = new Value(0);
       (yyval.value)->set_null();
       (yyloc) = (yylsp[0]);
     }
-#line 2373 "yacc_sql.cpp"
+#line 2428 "yacc_sql.cpp"
     break;
 
-  case 73: /* delete_stmt: DELETE FROM ID where_conditions  */
-#line 605 "yacc_sql.y"
+  case 78: /* delete_stmt: DELETE FROM ID where_conditions  */
+#line 643 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DELETE);
       (yyval.sql_node)->deletion.relation_name = (yyvsp[-1].string);
@@ -2383,11 +2438,11 @@ yyreduce:
       }
       free((yyvsp[-1].string));
     }
-#line 2387 "yacc_sql.cpp"
+#line 2442 "yacc_sql.cpp"
     break;
 
-  case 74: /* update_stmt: UPDATE ID SET update_def update_def_list where_conditions  */
-#line 618 "yacc_sql.y"
+  case 79: /* update_stmt: UPDATE ID SET update_def update_def_list where_conditions  */
+#line 656 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_UPDATE);
       (yyval.sql_node)->update.relation_name = (yyvsp[-4].string);
@@ -2405,19 +2460,19 @@ yyreduce:
       }
       free((yyvsp[-4].string));
     }
-#line 2409 "yacc_sql.cpp"
+#line 2464 "yacc_sql.cpp"
     break;
 
-  case 75: /* update_def_list: %empty  */
-#line 639 "yacc_sql.y"
+  case 80: /* update_def_list: %empty  */
+#line 677 "yacc_sql.y"
     {
       (yyval.update_infos) = nullptr;
     }
-#line 2417 "yacc_sql.cpp"
+#line 2472 "yacc_sql.cpp"
     break;
 
-  case 76: /* update_def_list: COMMA update_def update_def_list  */
-#line 643 "yacc_sql.y"
+  case 81: /* update_def_list: COMMA update_def update_def_list  */
+#line 681 "yacc_sql.y"
     {
       if ((yyvsp[0].update_infos) != nullptr) {
         (yyval.update_infos) = (yyvsp[0].update_infos);
@@ -2427,22 +2482,22 @@ yyreduce:
       (yyval.update_infos)->emplace_back(*(yyvsp[-1].update_info));
       delete (yyvsp[-1].update_info);
     }
-#line 2431 "yacc_sql.cpp"
+#line 2486 "yacc_sql.cpp"
     break;
 
-  case 77: /* update_def: ID EQ add_expr  */
-#line 656 "yacc_sql.y"
+  case 82: /* update_def: ID EQ add_expr  */
+#line 694 "yacc_sql.y"
     {
       (yyval.update_info) = new UpdateUnit;
       (yyval.update_info)->attribute_name = (yyvsp[-2].string);
       (yyval.update_info)->value = (yyvsp[0].expression);
       free((yyvsp[-2].string));
     }
-#line 2442 "yacc_sql.cpp"
+#line 2497 "yacc_sql.cpp"
     break;
 
-  case 78: /* select_stmt: SELECT select_attr FROM relation_list join_list where_conditions opt_group_by opt_having opt_order_by  */
-#line 665 "yacc_sql.y"
+  case 83: /* select_stmt: SELECT select_attr FROM relation_list join_list where_conditions opt_group_by opt_having opt_order_by  */
+#line 703 "yacc_sql.y"
                                                                                                           {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SELECT);
 
@@ -2476,76 +2531,97 @@ yyreduce:
 	(yyval.sql_node)->selection.having_conditions.conditions.swap((yyvsp[-1].condition_list)->conditions);
 	delete (yyvsp[-1].condition_list);
       }
-      if ((yyvsp[0].order_infos) != nullptr) {
-        (yyval.sql_node)->selection.order_lists.swap(*(yyvsp[0].order_infos));
+      if ((yyvsp[0].order_by) != nullptr) {
+        (yyval.sql_node)->selection.order_lists.swap((yyvsp[0].order_by)->order_lists);
         std::reverse((yyval.sql_node)->selection.order_lists.begin(), (yyval.sql_node)->selection.order_lists.end());
-        delete (yyvsp[0].order_infos);
+        (yyval.sql_node)->selection.limit = (yyvsp[0].order_by)->limit;
+        delete (yyvsp[0].order_by);
       }
     }
-#line 2486 "yacc_sql.cpp"
+#line 2542 "yacc_sql.cpp"
     break;
 
-  case 79: /* opt_group_by: %empty  */
-#line 707 "yacc_sql.y"
+  case 84: /* opt_group_by: %empty  */
+#line 746 "yacc_sql.y"
                 {
       (yyval.rel_attr_list) = nullptr;
 
     }
-#line 2495 "yacc_sql.cpp"
+#line 2551 "yacc_sql.cpp"
     break;
 
-  case 80: /* opt_group_by: GROUP BY rel_attr_list  */
-#line 710 "yacc_sql.y"
+  case 85: /* opt_group_by: GROUP BY rel_attr_list  */
+#line 749 "yacc_sql.y"
                                {
       (yyval.rel_attr_list) = (yyvsp[0].rel_attr_list);
     }
-#line 2503 "yacc_sql.cpp"
+#line 2559 "yacc_sql.cpp"
     break;
 
-  case 81: /* opt_having: %empty  */
-#line 715 "yacc_sql.y"
+  case 86: /* opt_having: %empty  */
+#line 754 "yacc_sql.y"
                 {
       (yyval.condition_list) = nullptr;
 
     }
-#line 2512 "yacc_sql.cpp"
+#line 2568 "yacc_sql.cpp"
     break;
 
-  case 82: /* opt_having: HAVING condition_list  */
-#line 718 "yacc_sql.y"
+  case 87: /* opt_having: HAVING condition_list  */
+#line 757 "yacc_sql.y"
                               {
       (yyval.condition_list) = (yyvsp[0].condition_list);
     }
-#line 2520 "yacc_sql.cpp"
+#line 2576 "yacc_sql.cpp"
     break;
 
-  case 83: /* opt_order_by: %empty  */
-#line 725 "yacc_sql.y"
+  case 88: /* opt_order_by: %empty  */
+#line 764 "yacc_sql.y"
         {
-      (yyval.order_infos) = nullptr;
+      (yyval.order_by) = nullptr;
     }
-#line 2528 "yacc_sql.cpp"
+#line 2584 "yacc_sql.cpp"
     break;
 
-  case 84: /* opt_order_by: ORDER BY sort_def_list  */
-#line 729 "yacc_sql.y"
+  case 89: /* opt_order_by: ORDER BY sort_def_list  */
+#line 768 "yacc_sql.y"
         {
-      (yyval.order_infos) = (yyvsp[0].order_infos);
+      (yyval.order_by) = new OrderBySqlNode;
+      (yyval.order_by)->order_lists.swap(*(yyvsp[0].order_infos));
+      delete (yyvsp[0].order_infos);
 	}
-#line 2536 "yacc_sql.cpp"
+#line 2594 "yacc_sql.cpp"
     break;
 
-  case 85: /* sort_def_list: sort_def  */
-#line 736 "yacc_sql.y"
+  case 90: /* opt_order_by: ORDER BY sort_def_list ID NUMBER  */
+#line 775 "yacc_sql.y"
+        {
+      const bool is_limit = strcasecmp((yyvsp[-1].string), "limit") == 0;
+      free((yyvsp[-1].string));
+      if (!is_limit) {
+        delete (yyvsp[-2].order_infos);
+        yyerror(&(yylsp[-1]), sql_string, sql_result, scanner, "syntax error, unexpected identifier after ORDER BY");
+        YYABORT;
+      }
+      (yyval.order_by) = new OrderBySqlNode;
+      (yyval.order_by)->order_lists.swap(*(yyvsp[-2].order_infos));
+      (yyval.order_by)->limit = (yyvsp[0].number);
+      delete (yyvsp[-2].order_infos);
+	}
+#line 2612 "yacc_sql.cpp"
+    break;
+
+  case 91: /* sort_def_list: sort_def  */
+#line 792 "yacc_sql.y"
         {
       (yyval.order_infos) = new std::vector<OrderByNode>;
       (yyval.order_infos)->emplace_back(*(yyvsp[0].order_info));
 	}
-#line 2545 "yacc_sql.cpp"
+#line 2621 "yacc_sql.cpp"
     break;
 
-  case 86: /* sort_def_list: sort_def COMMA sort_def_list  */
-#line 741 "yacc_sql.y"
+  case 92: /* sort_def_list: sort_def COMMA sort_def_list  */
+#line 797 "yacc_sql.y"
         {
       if ((yyvsp[0].order_infos) != nullptr) {
         (yyval.order_infos) = (yyvsp[0].order_infos);
@@ -2554,53 +2630,53 @@ yyreduce:
       }
       (yyval.order_infos)->emplace_back(*(yyvsp[-2].order_info));
 	}
-#line 2558 "yacc_sql.cpp"
+#line 2634 "yacc_sql.cpp"
     break;
 
-  case 87: /* sort_def: rel_attr  */
-#line 753 "yacc_sql.y"
+  case 93: /* sort_def: rel_attr  */
+#line 809 "yacc_sql.y"
     {
       (yyval.order_info) = new OrderByNode;
       (yyval.order_info)->sort_attr = *(yyvsp[0].rel_attr);
       delete((yyvsp[0].rel_attr));
     }
-#line 2568 "yacc_sql.cpp"
+#line 2644 "yacc_sql.cpp"
     break;
 
-  case 88: /* sort_def: rel_attr DESC  */
-#line 759 "yacc_sql.y"
+  case 94: /* sort_def: rel_attr DESC  */
+#line 815 "yacc_sql.y"
     {
       (yyval.order_info) = new OrderByNode;
       (yyval.order_info)->sort_attr = *(yyvsp[-1].rel_attr);
       (yyval.order_info)->is_asc = 0;
       delete((yyvsp[-1].rel_attr));
     }
-#line 2579 "yacc_sql.cpp"
+#line 2655 "yacc_sql.cpp"
     break;
 
-  case 89: /* sort_def: rel_attr ASC  */
-#line 766 "yacc_sql.y"
+  case 95: /* sort_def: rel_attr ASC  */
+#line 822 "yacc_sql.y"
     {
       (yyval.order_info) = new OrderByNode;
       (yyval.order_info)->sort_attr = *(yyvsp[-1].rel_attr);
       delete((yyvsp[-1].rel_attr));
     }
-#line 2589 "yacc_sql.cpp"
+#line 2665 "yacc_sql.cpp"
     break;
 
-  case 90: /* calc_stmt: CALC select_attr  */
-#line 775 "yacc_sql.y"
+  case 96: /* calc_stmt: CALC select_attr  */
+#line 831 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CALC);
       std::reverse((yyvsp[0].expression_list)->begin(), (yyvsp[0].expression_list)->end());
       (yyval.sql_node)->calc.expressions.swap(*(yyvsp[0].expression_list));
       delete (yyvsp[0].expression_list);
     }
-#line 2600 "yacc_sql.cpp"
+#line 2676 "yacc_sql.cpp"
     break;
 
-  case 91: /* aggr_expr: aggr_type LBRACE '*' RBRACE  */
-#line 784 "yacc_sql.y"
+  case 97: /* aggr_expr: aggr_type LBRACE '*' RBRACE  */
+#line 840 "yacc_sql.y"
                                 {
       RelAttrSqlNode *rel_attr_sql_node = new RelAttrSqlNode;
       rel_attr_sql_node->relation_name = "";
@@ -2608,20 +2684,20 @@ yyreduce:
       RelAttrExpr *relExpr = new RelAttrExpr(*rel_attr_sql_node);
       (yyval.expression) = new AggrExpr((AggrType)(yyvsp[-3].number), relExpr);
     }
-#line 2612 "yacc_sql.cpp"
+#line 2688 "yacc_sql.cpp"
     break;
 
-  case 92: /* aggr_expr: aggr_type LBRACE rel_attr RBRACE  */
-#line 790 "yacc_sql.y"
+  case 98: /* aggr_expr: aggr_type LBRACE rel_attr RBRACE  */
+#line 846 "yacc_sql.y"
                                          {
       RelAttrExpr *relExpr = new RelAttrExpr(*(yyvsp[-1].rel_attr));
       (yyval.expression) = new AggrExpr((AggrType)(yyvsp[-3].number), relExpr);
     }
-#line 2621 "yacc_sql.cpp"
+#line 2697 "yacc_sql.cpp"
     break;
 
-  case 93: /* aggr_expr: aggr_type LBRACE DATA RBRACE  */
-#line 793 "yacc_sql.y"
+  case 99: /* aggr_expr: aggr_type LBRACE DATA RBRACE  */
+#line 849 "yacc_sql.y"
                                      {
       // These shit is added due to a fucking test case
       RelAttrSqlNode *rel_attr_sql_node = new RelAttrSqlNode;
@@ -2630,49 +2706,49 @@ yyreduce:
       RelAttrExpr *relExpr = new RelAttrExpr(*rel_attr_sql_node);
       (yyval.expression) = new AggrExpr((AggrType)(yyvsp[-3].number), relExpr);
     }
-#line 2634 "yacc_sql.cpp"
+#line 2710 "yacc_sql.cpp"
     break;
 
-  case 94: /* base_expr: value  */
-#line 804 "yacc_sql.y"
+  case 100: /* base_expr: value  */
+#line 860 "yacc_sql.y"
           {
       (yyval.expression) = new ValueExpr(*(yyvsp[0].value));
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
       delete (yyvsp[0].value);
     }
-#line 2644 "yacc_sql.cpp"
+#line 2720 "yacc_sql.cpp"
     break;
 
-  case 95: /* base_expr: rel_attr  */
-#line 808 "yacc_sql.y"
+  case 101: /* base_expr: rel_attr  */
+#line 864 "yacc_sql.y"
                  {
       (yyval.expression) = new RelAttrExpr(*(yyvsp[0].rel_attr));
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
       delete (yyvsp[0].rel_attr);
     }
-#line 2654 "yacc_sql.cpp"
+#line 2730 "yacc_sql.cpp"
     break;
 
-  case 96: /* base_expr: LBRACE add_expr RBRACE  */
-#line 812 "yacc_sql.y"
+  case 102: /* base_expr: LBRACE add_expr RBRACE  */
+#line 868 "yacc_sql.y"
                                {
       (yyval.expression) = (yyvsp[-1].expression);
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
     }
-#line 2663 "yacc_sql.cpp"
+#line 2739 "yacc_sql.cpp"
     break;
 
-  case 97: /* base_expr: aggr_expr  */
-#line 815 "yacc_sql.y"
+  case 103: /* base_expr: aggr_expr  */
+#line 871 "yacc_sql.y"
                   {
       (yyval.expression) = (yyvsp[0].expression);
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
     }
-#line 2672 "yacc_sql.cpp"
+#line 2748 "yacc_sql.cpp"
     break;
 
-  case 98: /* base_expr: value_list  */
-#line 818 "yacc_sql.y"
+  case 104: /* base_expr: value_list  */
+#line 874 "yacc_sql.y"
                    {
       (yyval.expression) = new ValuesExpr();
       for (auto &value : *(yyvsp[0].value_list)) {
@@ -2681,67 +2757,67 @@ yyreduce:
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
       delete (yyvsp[0].value_list);
     }
-#line 2685 "yacc_sql.cpp"
+#line 2761 "yacc_sql.cpp"
     break;
 
-  case 99: /* mul_expr: base_expr  */
-#line 829 "yacc_sql.y"
+  case 105: /* mul_expr: base_expr  */
+#line 885 "yacc_sql.y"
               {
       (yyval.expression) = (yyvsp[0].expression);
     }
-#line 2693 "yacc_sql.cpp"
+#line 2769 "yacc_sql.cpp"
     break;
 
-  case 100: /* mul_expr: '-' base_expr  */
-#line 831 "yacc_sql.y"
+  case 106: /* mul_expr: '-' base_expr  */
+#line 887 "yacc_sql.y"
                       {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::NEGATIVE, (yyvsp[0].expression), nullptr, sql_string, &(yyloc));
     }
-#line 2701 "yacc_sql.cpp"
+#line 2777 "yacc_sql.cpp"
     break;
 
-  case 101: /* mul_expr: mul_expr '*' base_expr  */
-#line 833 "yacc_sql.y"
+  case 107: /* mul_expr: mul_expr '*' base_expr  */
+#line 889 "yacc_sql.y"
                                {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::MUL, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2709 "yacc_sql.cpp"
+#line 2785 "yacc_sql.cpp"
     break;
 
-  case 102: /* mul_expr: mul_expr '/' base_expr  */
-#line 835 "yacc_sql.y"
+  case 108: /* mul_expr: mul_expr '/' base_expr  */
+#line 891 "yacc_sql.y"
                                {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::DIV, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2717 "yacc_sql.cpp"
+#line 2793 "yacc_sql.cpp"
     break;
 
-  case 103: /* add_expr: mul_expr  */
-#line 841 "yacc_sql.y"
+  case 109: /* add_expr: mul_expr  */
+#line 897 "yacc_sql.y"
              {
       (yyval.expression) = (yyvsp[0].expression);
     }
-#line 2725 "yacc_sql.cpp"
+#line 2801 "yacc_sql.cpp"
     break;
 
-  case 104: /* add_expr: add_expr '+' mul_expr  */
-#line 843 "yacc_sql.y"
+  case 110: /* add_expr: add_expr '+' mul_expr  */
+#line 899 "yacc_sql.y"
                               {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::ADD, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2733 "yacc_sql.cpp"
+#line 2809 "yacc_sql.cpp"
     break;
 
-  case 105: /* add_expr: add_expr '-' mul_expr  */
-#line 845 "yacc_sql.y"
+  case 111: /* add_expr: add_expr '-' mul_expr  */
+#line 901 "yacc_sql.y"
                               {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::SUB, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2741 "yacc_sql.cpp"
+#line 2817 "yacc_sql.cpp"
     break;
 
-  case 106: /* select_attr: '*' expression_list  */
-#line 851 "yacc_sql.y"
+  case 112: /* select_attr: '*' expression_list  */
+#line 907 "yacc_sql.y"
                         {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2753,11 +2829,11 @@ yyreduce:
       relAttrSqlNode->attribute_name = "*";
       (yyval.expression_list)->emplace_back(new RelAttrExpr(*relAttrSqlNode));
     }
-#line 2757 "yacc_sql.cpp"
+#line 2833 "yacc_sql.cpp"
     break;
 
-  case 107: /* select_attr: ID DOT '*' expression_list  */
-#line 862 "yacc_sql.y"
+  case 113: /* select_attr: ID DOT '*' expression_list  */
+#line 918 "yacc_sql.y"
                                  {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2770,11 +2846,11 @@ yyreduce:
       (yyval.expression_list)->emplace_back(new RelAttrExpr(*relAttrSqlNode));
       free((yyvsp[-3].string));
     }
-#line 2774 "yacc_sql.cpp"
+#line 2850 "yacc_sql.cpp"
     break;
 
-  case 108: /* select_attr: add_expr expression_list  */
-#line 873 "yacc_sql.y"
+  case 114: /* select_attr: add_expr expression_list  */
+#line 929 "yacc_sql.y"
                                  {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2783,11 +2859,11 @@ yyreduce:
       }
       (yyval.expression_list)->emplace_back((yyvsp[-1].expression));
     }
-#line 2787 "yacc_sql.cpp"
+#line 2863 "yacc_sql.cpp"
     break;
 
-  case 109: /* select_attr: add_expr AS ID expression_list  */
-#line 880 "yacc_sql.y"
+  case 115: /* select_attr: add_expr AS ID expression_list  */
+#line 936 "yacc_sql.y"
                                        {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2798,19 +2874,19 @@ yyreduce:
       expr->set_alias((yyvsp[-1].string));
       (yyval.expression_list)->emplace_back(expr);
     }
-#line 2802 "yacc_sql.cpp"
+#line 2878 "yacc_sql.cpp"
     break;
 
-  case 110: /* expression_list: %empty  */
-#line 893 "yacc_sql.y"
+  case 116: /* expression_list: %empty  */
+#line 949 "yacc_sql.y"
                 {
       (yyval.expression_list) = nullptr;
     }
-#line 2810 "yacc_sql.cpp"
+#line 2886 "yacc_sql.cpp"
     break;
 
-  case 111: /* expression_list: COMMA '*' expression_list  */
-#line 895 "yacc_sql.y"
+  case 117: /* expression_list: COMMA '*' expression_list  */
+#line 951 "yacc_sql.y"
                                   {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2822,11 +2898,11 @@ yyreduce:
       relAttrSqlNode->attribute_name = "*";
       (yyval.expression_list)->emplace_back(new RelAttrExpr(*relAttrSqlNode));
     }
-#line 2826 "yacc_sql.cpp"
+#line 2902 "yacc_sql.cpp"
     break;
 
-  case 112: /* expression_list: COMMA ID DOT '*' expression_list  */
-#line 905 "yacc_sql.y"
+  case 118: /* expression_list: COMMA ID DOT '*' expression_list  */
+#line 961 "yacc_sql.y"
                                          {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2839,11 +2915,11 @@ yyreduce:
       (yyval.expression_list)->emplace_back(new RelAttrExpr(*relAttrSqlNode));
       free((yyvsp[-3].string));
     }
-#line 2843 "yacc_sql.cpp"
+#line 2919 "yacc_sql.cpp"
     break;
 
-  case 113: /* expression_list: COMMA add_expr expression_list  */
-#line 916 "yacc_sql.y"
+  case 119: /* expression_list: COMMA add_expr expression_list  */
+#line 972 "yacc_sql.y"
                                        {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2852,11 +2928,11 @@ yyreduce:
       }
       (yyval.expression_list)->emplace_back((yyvsp[-1].expression));
     }
-#line 2856 "yacc_sql.cpp"
+#line 2932 "yacc_sql.cpp"
     break;
 
-  case 114: /* expression_list: COMMA add_expr ID expression_list  */
-#line 923 "yacc_sql.y"
+  case 120: /* expression_list: COMMA add_expr ID expression_list  */
+#line 979 "yacc_sql.y"
                                           {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2867,11 +2943,11 @@ yyreduce:
       expr->set_alias((yyvsp[-1].string));
       (yyval.expression_list)->emplace_back(expr);
     }
-#line 2871 "yacc_sql.cpp"
+#line 2947 "yacc_sql.cpp"
     break;
 
-  case 115: /* expression_list: COMMA add_expr AS ID expression_list  */
-#line 932 "yacc_sql.y"
+  case 121: /* expression_list: COMMA add_expr AS ID expression_list  */
+#line 988 "yacc_sql.y"
                                              {
       if ((yyvsp[0].expression_list) != nullptr) {
 	(yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2882,11 +2958,11 @@ yyreduce:
       expr->set_alias((yyvsp[-1].string));
       (yyval.expression_list)->emplace_back(expr);
     }
-#line 2886 "yacc_sql.cpp"
+#line 2962 "yacc_sql.cpp"
     break;
 
-  case 116: /* expression_list: COMMA add_expr AS DATA expression_list  */
-#line 941 "yacc_sql.y"
+  case 122: /* expression_list: COMMA add_expr AS DATA expression_list  */
+#line 997 "yacc_sql.y"
                                                {
       // These shit is added due to a fucking test case
       if ((yyvsp[0].expression_list) != nullptr) {
@@ -2898,22 +2974,22 @@ yyreduce:
       expr->set_alias("data");
       (yyval.expression_list)->emplace_back(expr);
     }
-#line 2902 "yacc_sql.cpp"
+#line 2978 "yacc_sql.cpp"
     break;
 
-  case 117: /* rel_attr: ID  */
-#line 955 "yacc_sql.y"
+  case 123: /* rel_attr: ID  */
+#line 1011 "yacc_sql.y"
        {
       (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->relation_name = "";
       (yyval.rel_attr)->attribute_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 2913 "yacc_sql.cpp"
+#line 2989 "yacc_sql.cpp"
     break;
 
-  case 118: /* rel_attr: ID DOT ID  */
-#line 960 "yacc_sql.y"
+  case 124: /* rel_attr: ID DOT ID  */
+#line 1016 "yacc_sql.y"
                   {
       (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->relation_name  = (yyvsp[-2].string);
@@ -2921,21 +2997,21 @@ yyreduce:
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 2925 "yacc_sql.cpp"
+#line 3001 "yacc_sql.cpp"
     break;
 
-  case 119: /* rel_attr_list: rel_attr  */
-#line 970 "yacc_sql.y"
+  case 125: /* rel_attr_list: rel_attr  */
+#line 1026 "yacc_sql.y"
              {
       (yyval.rel_attr_list) = new std::vector<RelAttrSqlNode>;
       (yyval.rel_attr_list)->emplace_back(*(yyvsp[0].rel_attr));
       delete (yyvsp[0].rel_attr);
     }
-#line 2935 "yacc_sql.cpp"
+#line 3011 "yacc_sql.cpp"
     break;
 
-  case 120: /* rel_attr_list: rel_attr COMMA rel_attr_list  */
-#line 974 "yacc_sql.y"
+  case 126: /* rel_attr_list: rel_attr COMMA rel_attr_list  */
+#line 1030 "yacc_sql.y"
                                      {
       if ((yyvsp[0].rel_attr_list) != nullptr) {
 	(yyval.rel_attr_list) = (yyvsp[0].rel_attr_list);
@@ -2945,11 +3021,11 @@ yyreduce:
       (yyval.rel_attr_list)->emplace_back(*(yyvsp[-2].rel_attr));
       delete (yyvsp[-2].rel_attr);
     }
-#line 2949 "yacc_sql.cpp"
+#line 3025 "yacc_sql.cpp"
     break;
 
-  case 121: /* relation_list: rel_alias rel_list  */
-#line 985 "yacc_sql.y"
+  case 127: /* relation_list: rel_alias rel_list  */
+#line 1041 "yacc_sql.y"
                        {
       if ((yyvsp[0].relation_list) != nullptr) {
         (yyval.relation_list) = (yyvsp[0].relation_list);
@@ -2959,19 +3035,19 @@ yyreduce:
       (yyval.relation_list)->push_back(*(yyvsp[-1].relation));
       delete (yyvsp[-1].relation);
     }
-#line 2963 "yacc_sql.cpp"
+#line 3039 "yacc_sql.cpp"
     break;
 
-  case 122: /* rel_list: %empty  */
-#line 997 "yacc_sql.y"
+  case 128: /* rel_list: %empty  */
+#line 1053 "yacc_sql.y"
                 {
       (yyval.relation_list) = nullptr;
     }
-#line 2971 "yacc_sql.cpp"
+#line 3047 "yacc_sql.cpp"
     break;
 
-  case 123: /* rel_list: COMMA rel_alias rel_list  */
-#line 999 "yacc_sql.y"
+  case 129: /* rel_list: COMMA rel_alias rel_list  */
+#line 1055 "yacc_sql.y"
                                  {
       if ((yyvsp[0].relation_list) != nullptr) {
         (yyval.relation_list) = (yyvsp[0].relation_list);
@@ -2981,22 +3057,22 @@ yyreduce:
       (yyval.relation_list)->push_back(*(yyvsp[-1].relation));
       delete (yyvsp[-1].relation);
     }
-#line 2985 "yacc_sql.cpp"
+#line 3061 "yacc_sql.cpp"
     break;
 
-  case 124: /* rel_alias: ID  */
-#line 1011 "yacc_sql.y"
+  case 130: /* rel_alias: ID  */
+#line 1067 "yacc_sql.y"
        {
       (yyval.relation) = new RelationSqlNode;
       (yyval.relation)->relation_name = (yyvsp[0].string);
       (yyval.relation)->alias = "";
       free((yyvsp[0].string));
     }
-#line 2996 "yacc_sql.cpp"
+#line 3072 "yacc_sql.cpp"
     break;
 
-  case 125: /* rel_alias: ID ID  */
-#line 1016 "yacc_sql.y"
+  case 131: /* rel_alias: ID ID  */
+#line 1072 "yacc_sql.y"
               {
       (yyval.relation) = new RelationSqlNode;
       (yyval.relation)->relation_name = (yyvsp[-1].string);
@@ -3004,11 +3080,11 @@ yyreduce:
       free((yyvsp[-1].string));
       free((yyvsp[0].string));
     }
-#line 3008 "yacc_sql.cpp"
+#line 3084 "yacc_sql.cpp"
     break;
 
-  case 126: /* rel_alias: ID AS ID  */
-#line 1022 "yacc_sql.y"
+  case 132: /* rel_alias: ID AS ID  */
+#line 1078 "yacc_sql.y"
                  {
       (yyval.relation) = new RelationSqlNode;
       (yyval.relation)->relation_name = (yyvsp[-2].string);
@@ -3016,19 +3092,19 @@ yyreduce:
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 3020 "yacc_sql.cpp"
+#line 3096 "yacc_sql.cpp"
     break;
 
-  case 127: /* join_list: %empty  */
-#line 1033 "yacc_sql.y"
+  case 133: /* join_list: %empty  */
+#line 1089 "yacc_sql.y"
     {
       (yyval.join_list) = nullptr;
     }
-#line 3028 "yacc_sql.cpp"
+#line 3104 "yacc_sql.cpp"
     break;
 
-  case 128: /* join_list: INNER JOIN rel_alias join_conditions join_list  */
-#line 1036 "yacc_sql.y"
+  case 134: /* join_list: INNER JOIN rel_alias join_conditions join_list  */
+#line 1092 "yacc_sql.y"
                                                     {
       if ((yyvsp[0].join_list) != nullptr) {
         (yyval.join_list) = (yyvsp[0].join_list);
@@ -3046,72 +3122,72 @@ yyreduce:
       delete joinSqlNode;
       delete (yyvsp[-2].relation);
     }
-#line 3050 "yacc_sql.cpp"
+#line 3126 "yacc_sql.cpp"
     break;
 
-  case 129: /* join_conditions: %empty  */
-#line 1057 "yacc_sql.y"
+  case 135: /* join_conditions: %empty  */
+#line 1113 "yacc_sql.y"
     {
       (yyval.condition_list) = nullptr;
     }
-#line 3058 "yacc_sql.cpp"
+#line 3134 "yacc_sql.cpp"
     break;
 
-  case 130: /* join_conditions: ON condition_list  */
-#line 1061 "yacc_sql.y"
+  case 136: /* join_conditions: ON condition_list  */
+#line 1117 "yacc_sql.y"
         {
 	  (yyval.condition_list) = (yyvsp[0].condition_list);
 	}
-#line 3066 "yacc_sql.cpp"
+#line 3142 "yacc_sql.cpp"
     break;
 
-  case 131: /* where_conditions: %empty  */
-#line 1068 "yacc_sql.y"
+  case 137: /* where_conditions: %empty  */
+#line 1124 "yacc_sql.y"
     {
       (yyval.condition_list) = nullptr;
     }
-#line 3074 "yacc_sql.cpp"
+#line 3150 "yacc_sql.cpp"
     break;
 
-  case 132: /* where_conditions: WHERE condition_list  */
-#line 1071 "yacc_sql.y"
+  case 138: /* where_conditions: WHERE condition_list  */
+#line 1127 "yacc_sql.y"
                            {
       (yyval.condition_list) = (yyvsp[0].condition_list);  
     }
-#line 3082 "yacc_sql.cpp"
+#line 3158 "yacc_sql.cpp"
     break;
 
-  case 133: /* condition_list: %empty  */
-#line 1077 "yacc_sql.y"
+  case 139: /* condition_list: %empty  */
+#line 1133 "yacc_sql.y"
                 {
       (yyval.condition_list) = nullptr;
     }
-#line 3090 "yacc_sql.cpp"
+#line 3166 "yacc_sql.cpp"
     break;
 
-  case 134: /* condition_list: condition  */
-#line 1079 "yacc_sql.y"
+  case 140: /* condition_list: condition  */
+#line 1135 "yacc_sql.y"
                   {
       (yyval.condition_list) = new WhereConditions;
       (yyval.condition_list)->conditions.emplace_back(*(yyvsp[0].condition));
       delete (yyvsp[0].condition);
     }
-#line 3100 "yacc_sql.cpp"
+#line 3176 "yacc_sql.cpp"
     break;
 
-  case 135: /* condition_list: condition AND condition_list  */
-#line 1083 "yacc_sql.y"
+  case 141: /* condition_list: condition AND condition_list  */
+#line 1139 "yacc_sql.y"
                                      {
       (yyval.condition_list) = (yyvsp[0].condition_list);
       (yyval.condition_list)->type = ConjunctionType::AND;
       (yyval.condition_list)->conditions.emplace_back(*(yyvsp[-2].condition));
       delete (yyvsp[-2].condition);
     }
-#line 3111 "yacc_sql.cpp"
+#line 3187 "yacc_sql.cpp"
     break;
 
-  case 136: /* condition_list: condition OR condition_list  */
-#line 1088 "yacc_sql.y"
+  case 142: /* condition_list: condition OR condition_list  */
+#line 1144 "yacc_sql.y"
                                     {
       (yyval.condition_list) = (yyvsp[0].condition_list);
       (yyval.condition_list)->type = ConjunctionType::OR;
@@ -3119,132 +3195,132 @@ yyreduce:
       delete (yyvsp[-2].condition);
 
     }
-#line 3123 "yacc_sql.cpp"
+#line 3199 "yacc_sql.cpp"
     break;
 
-  case 137: /* condition: add_expr comp_op add_expr  */
-#line 1098 "yacc_sql.y"
+  case 143: /* condition: add_expr comp_op add_expr  */
+#line 1154 "yacc_sql.y"
                               {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_expr = (yyvsp[-2].expression);
       (yyval.condition)->right_expr = (yyvsp[0].expression);
       (yyval.condition)->comp = (yyvsp[-1].comp);
     }
-#line 3134 "yacc_sql.cpp"
+#line 3210 "yacc_sql.cpp"
     break;
 
-  case 138: /* condition: add_expr IS NULL_T  */
-#line 1103 "yacc_sql.y"
+  case 144: /* condition: add_expr IS NULL_T  */
+#line 1159 "yacc_sql.y"
                            {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_expr = (yyvsp[-2].expression);
       (yyval.condition)->comp = IS_NULL;
     }
-#line 3144 "yacc_sql.cpp"
+#line 3220 "yacc_sql.cpp"
     break;
 
-  case 139: /* condition: add_expr IS NOT_T NULL_T  */
-#line 1109 "yacc_sql.y"
+  case 145: /* condition: add_expr IS NOT_T NULL_T  */
+#line 1165 "yacc_sql.y"
                              {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_expr = (yyvsp[-3].expression);
       (yyval.condition)->comp = IS_NOT_NULL;
     }
-#line 3154 "yacc_sql.cpp"
+#line 3230 "yacc_sql.cpp"
     break;
 
-  case 140: /* condition: add_expr IN_T add_expr  */
-#line 1113 "yacc_sql.y"
+  case 146: /* condition: add_expr IN_T add_expr  */
+#line 1169 "yacc_sql.y"
                                {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_expr = (yyvsp[-2].expression);
       (yyval.condition)->right_expr = (yyvsp[0].expression);
       (yyval.condition)->comp = IN;
     }
-#line 3165 "yacc_sql.cpp"
+#line 3241 "yacc_sql.cpp"
     break;
 
-  case 141: /* condition: add_expr NOT_T IN_T add_expr  */
-#line 1118 "yacc_sql.y"
+  case 147: /* condition: add_expr NOT_T IN_T add_expr  */
+#line 1174 "yacc_sql.y"
                                      {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_expr = (yyvsp[-3].expression);
       (yyval.condition)->right_expr = (yyvsp[0].expression);
       (yyval.condition)->comp = NOT_IN;
     }
-#line 3176 "yacc_sql.cpp"
+#line 3252 "yacc_sql.cpp"
     break;
 
-  case 142: /* condition: EXISTS_T add_expr  */
-#line 1124 "yacc_sql.y"
+  case 148: /* condition: EXISTS_T add_expr  */
+#line 1180 "yacc_sql.y"
                         {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_expr = (yyvsp[0].expression);
       (yyval.condition)->comp = EXISTS;
     }
-#line 3186 "yacc_sql.cpp"
+#line 3262 "yacc_sql.cpp"
     break;
 
-  case 143: /* condition: NOT_T EXISTS_T add_expr  */
-#line 1129 "yacc_sql.y"
+  case 149: /* condition: NOT_T EXISTS_T add_expr  */
+#line 1185 "yacc_sql.y"
                               {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_expr = (yyvsp[0].expression);
       (yyval.condition)->comp = NOT_EXISTS;
     }
-#line 3196 "yacc_sql.cpp"
+#line 3272 "yacc_sql.cpp"
     break;
 
-  case 144: /* comp_op: EQ  */
-#line 1137 "yacc_sql.y"
+  case 150: /* comp_op: EQ  */
+#line 1193 "yacc_sql.y"
          { (yyval.comp) = EQUAL_TO; }
-#line 3202 "yacc_sql.cpp"
+#line 3278 "yacc_sql.cpp"
     break;
 
-  case 145: /* comp_op: LT  */
-#line 1138 "yacc_sql.y"
+  case 151: /* comp_op: LT  */
+#line 1194 "yacc_sql.y"
          { (yyval.comp) = LESS_THAN; }
-#line 3208 "yacc_sql.cpp"
+#line 3284 "yacc_sql.cpp"
     break;
 
-  case 146: /* comp_op: GT  */
-#line 1139 "yacc_sql.y"
+  case 152: /* comp_op: GT  */
+#line 1195 "yacc_sql.y"
          { (yyval.comp) = GREAT_THAN; }
-#line 3214 "yacc_sql.cpp"
+#line 3290 "yacc_sql.cpp"
     break;
 
-  case 147: /* comp_op: LE  */
-#line 1140 "yacc_sql.y"
+  case 153: /* comp_op: LE  */
+#line 1196 "yacc_sql.y"
          { (yyval.comp) = LESS_EQUAL; }
-#line 3220 "yacc_sql.cpp"
+#line 3296 "yacc_sql.cpp"
     break;
 
-  case 148: /* comp_op: GE  */
-#line 1141 "yacc_sql.y"
+  case 154: /* comp_op: GE  */
+#line 1197 "yacc_sql.y"
          { (yyval.comp) = GREAT_EQUAL; }
-#line 3226 "yacc_sql.cpp"
+#line 3302 "yacc_sql.cpp"
     break;
 
-  case 149: /* comp_op: NE  */
-#line 1142 "yacc_sql.y"
+  case 155: /* comp_op: NE  */
+#line 1198 "yacc_sql.y"
          { (yyval.comp) = NOT_EQUAL; }
-#line 3232 "yacc_sql.cpp"
+#line 3308 "yacc_sql.cpp"
     break;
 
-  case 150: /* comp_op: LIKE_T  */
-#line 1143 "yacc_sql.y"
+  case 156: /* comp_op: LIKE_T  */
+#line 1199 "yacc_sql.y"
              { (yyval.comp) = LIKE_OP; }
-#line 3238 "yacc_sql.cpp"
+#line 3314 "yacc_sql.cpp"
     break;
 
-  case 151: /* comp_op: NOT_T LIKE_T  */
-#line 1144 "yacc_sql.y"
+  case 157: /* comp_op: NOT_T LIKE_T  */
+#line 1200 "yacc_sql.y"
                    { (yyval.comp) = NOT_LIKE_OP; }
-#line 3244 "yacc_sql.cpp"
+#line 3320 "yacc_sql.cpp"
     break;
 
-  case 152: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE ID  */
-#line 1149 "yacc_sql.y"
+  case 158: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE ID  */
+#line 1205 "yacc_sql.y"
     {
       char *tmp_file_name = common::substr((yyvsp[-3].string), 1, strlen((yyvsp[-3].string)) - 2);
       
@@ -3254,20 +3330,20 @@ yyreduce:
       free((yyvsp[0].string));
       free(tmp_file_name);
     }
-#line 3258 "yacc_sql.cpp"
+#line 3334 "yacc_sql.cpp"
     break;
 
-  case 153: /* explain_stmt: EXPLAIN command_wrapper  */
-#line 1162 "yacc_sql.y"
+  case 159: /* explain_stmt: EXPLAIN command_wrapper  */
+#line 1218 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXPLAIN);
       (yyval.sql_node)->explain.sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[0].sql_node));
     }
-#line 3267 "yacc_sql.cpp"
+#line 3343 "yacc_sql.cpp"
     break;
 
-  case 154: /* set_variable_stmt: SET ID EQ value  */
-#line 1170 "yacc_sql.y"
+  case 160: /* set_variable_stmt: SET ID EQ value  */
+#line 1226 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SET_VARIABLE);
       (yyval.sql_node)->set_variable.name  = (yyvsp[-2].string);
@@ -3275,11 +3351,11 @@ yyreduce:
       free((yyvsp[-2].string));
       delete (yyvsp[0].value);
     }
-#line 3279 "yacc_sql.cpp"
+#line 3355 "yacc_sql.cpp"
     break;
 
 
-#line 3283 "yacc_sql.cpp"
+#line 3359 "yacc_sql.cpp"
 
       default: break;
     }
@@ -3508,7 +3584,7 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 1182 "yacc_sql.y"
+#line 1238 "yacc_sql.y"
 
 
 //_____________________________________________________________________
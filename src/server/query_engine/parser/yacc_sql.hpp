@@ -147,6 +147,7 @@ union YYSTYPE
   AttrInfoSqlNode *                 attr_info;
   std::vector<UpdateUnit> *         update_infos;
   UpdateUnit *                      update_info;
+  OrderBySqlNode *                  order_by;
   std::vector<OrderByNode> *        order_infos;
   OrderByNode *                     order_info;
   Expression *                      expression;
@@ -162,7 +163,7 @@ union YYSTYPE
   int                               number;
   float                             floats;
 
-#line 166 "yacc_sql.hpp"
+#line 167 "yacc_sql.hpp"
 
 };
 typedef union YYSTYPE YYSTYPE;
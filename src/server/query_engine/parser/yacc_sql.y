@@ -141,6 +141,7 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
   AttrInfoSqlNode *                 attr_info;
   std::vector<UpdateUnit> *         update_infos;
   UpdateUnit *                      update_info;
+  OrderBySqlNode *                  order_by;
   std::vector<OrderByNode> *        order_infos;
   OrderByNode *                     order_info;
   Expression *                      expression;
@@ -170,6 +171,7 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
 %type <condition>           condition
 %type <value>               value
 %type <number>              number
+%type <number>              opt_key_compressed
 %type <comp>                comp_op
 %type <rel_attr>            rel_attr
 %type <rel_attr_list>	    rel_attr_list
@@ -178,7 +180,7 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
 %type <attr_info>           attr_def
 %type <update_infos>        update_def_list
 %type <update_info>         update_def
-%type <order_infos>         opt_order_by
+%type <order_by>            opt_order_by
 %type <order_infos>         sort_def_list
 %type <order_info>          sort_def
 %type <value_list>          value_list
@@ -219,6 +221,7 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
 %type <sql_node>            explain_stmt
 %type <sql_node>            set_variable_stmt
 %type <sql_node>            help_stmt
+%type <sql_node>            vacuum_stmt
 %type <sql_node>            exit_stmt
 %type <sql_node>            command_wrapper
 // commands should be a list but I use a single command instead
@@ -258,6 +261,7 @@ command_wrapper:
   | set_variable_stmt
   | help_stmt
   | exit_stmt
+  | vacuum_stmt
     ;
 
 exit_stmt:
@@ -277,6 +281,20 @@ sync_stmt:
     }
     ;
 
+/* VACUUM 不是保留字，按照标识符识别，不影响把 vacuum 用作表名或列名 */
+vacuum_stmt:
+    ID {
+      $$ = new ParsedSqlNode(strcasecmp($1, "vacuum") == 0 ? SCF_VACUUM : SCF_ERROR);
+      free($1);
+    }
+    | ID ID {
+      $$ = new ParsedSqlNode(strcasecmp($1, "vacuum") == 0 ? SCF_VACUUM : SCF_ERROR);
+      $$->vacuum.relation_name = $2;
+      free($1);
+      free($2);
+    }
+    ;
+
 begin_stmt:
     TRX_BEGIN  {
       $$ = new ParsedSqlNode(SCF_BEGIN);
@@ -317,13 +335,14 @@ desc_table_stmt:
     ;
 
 create_index_stmt:    /*create index 语句的语法解析树*/
-  CREATE UNIQUE INDEX ID ON ID LBRACE ID multi_attribute_names RBRACE
+  CREATE UNIQUE INDEX ID ON ID LBRACE ID multi_attribute_names RBRACE opt_key_compressed
   {
 	$$ = new ParsedSqlNode(SCF_CREATE_INDEX);
 	CreateIndexSqlNode &create_index = $$->create_index;
 	create_index.index_name = $4;
 	create_index.relation_name = $6;
 	create_index.is_unique_ = true;
+	create_index.key_compressed = $11;
 	if ($9 != nullptr) {
 	create_index.multi_attribute_names.swap(*$9);
 	}
@@ -333,13 +352,14 @@ create_index_stmt:    /*create index 语句的语法解析树*/
 	free($6);
 	free($8);
   }
-  | CREATE INDEX ID ON ID LBRACE ID multi_attribute_names RBRACE
+  | CREATE INDEX ID ON ID LBRACE ID multi_attribute_names RBRACE opt_key_compressed
   {
 	$$ = new ParsedSqlNode(SCF_CREATE_INDEX);
 	CreateIndexSqlNode &create_index = $$->create_index;
 	create_index.index_name = $3;
 	create_index.relation_name = $5;
 	create_index.is_unique_ = false;
+	create_index.key_compressed = $10;
 	if ($8 != nullptr) {
 	create_index.multi_attribute_names.swap(*$8);
 	}
@@ -351,6 +371,24 @@ create_index_stmt:    /*create index 语句的语法解析树*/
   }
   ;
 
+/* COMPRESSED 不是保留字，按照标识符识别 */
+opt_key_compressed:
+  /* empty */
+  {
+	$$ = 0;
+  }
+  | ID
+  {
+	const bool is_compressed = strcasecmp($1, "compressed") == 0;
+	free($1);
+	if (!is_compressed) {
+	  yyerror(&@1, sql_string, sql_result, scanner, "syntax error, unexpected identifier after CREATE INDEX");
+	  YYABORT;
+	}
+	$$ = 1;
+  }
+  ;
+
 multi_attribute_names:
   /* empty */
   {
@@ -696,8 +734,9 @@ select_stmt:        /*  select 语句的语法解析树*/
 	delete $8;
       }
       if ($9 != nullptr) {
-        $$->selection.order_lists.swap(*$9);
+        $$->selection.order_lists.swap($9->order_lists);
         std::reverse($$->selection.order_lists.begin(), $$->selection.order_lists.end());
+        $$->selection.limit = $9->limit;
         delete $9;
       }
     }
@@ -727,7 +766,24 @@ opt_order_by:
     }
 	| ORDER BY sort_def_list
 	{
-      $$ = $3;
+      $$ = new OrderBySqlNode;
+      $$->order_lists.swap(*$3);
+      delete $3;
+	}
+	/* LIMIT 不是保留字，按照标识符识别 */
+	| ORDER BY sort_def_list ID NUMBER
+	{
+      const bool is_limit = strcasecmp($4, "limit") == 0;
+      free($4);
+      if (!is_limit) {
+        delete $3;
+        yyerror(&@4, sql_string, sql_result, scanner, "syntax error, unexpected identifier after ORDER BY");
+        YYABORT;
+      }
+      $$ = new OrderBySqlNode;
+      $$->order_lists.swap(*$3);
+      $$->limit = $5;
+      delete $3;
 	}
 	;
 
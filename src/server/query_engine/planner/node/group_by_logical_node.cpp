@@ -1,7 +1,12 @@
 #include "include/query_engine/planner/node/group_by_logical_node.h"
+#include "include/query_engine/structor/expression/field_expression.h"
 
-// TODO 添加你自己的GroupBy节点实现
 GroupByLogicalNode::GroupByLogicalNode(
     const std::vector<Expression *> &field_exprs,
     const std::vector<AggrExpr *> &aggr_exprs)
-    : AggrLogicalNode(aggr_exprs) {}
\ No newline at end of file
+    : AggrLogicalNode(aggr_exprs)
+{
+  for (Expression *expr : field_exprs) {
+    group_fields_.emplace_back(static_cast<FieldExpr *>(expr)->field());
+  }
+}
@@ -90,11 +90,53 @@ unique_ptr<ConjunctionExpr> _transfer_filter_stmt_to_expr(FilterStmt *filter_stm
   return nullptr;
 }
 
+static void _collect_filter_fields(FilterStmt *filter_stmt, std::vector<Field *> &fields)
+{
+  if (filter_stmt == nullptr) {
+    return;
+  }
+  for (FilterUnit *filter_unit : filter_stmt->filter_units()) {
+    if (filter_unit->left_expr() != nullptr) {
+      filter_unit->left_expr()->getFields(fields);
+    }
+    if (filter_unit->right_expr() != nullptr) {
+      filter_unit->right_expr()->getFields(fields);
+    }
+  }
+}
+
+/**
+ * @brief 收集查询中用到的所有字段，不只是投影中的字段，过滤、连接、分组和排序中用到的字段也包含在内。
+ * 物理计划根据这些字段判断能否只扫描索引
+ */
+static void _collect_query_fields(SelectStmt *select_stmt, std::vector<Field *> &fields)
+{
+  for (Expression *project : select_stmt->projects()) {
+    project->getFields(fields);
+  }
+  _collect_filter_fields(select_stmt->filter_stmt(), fields);
+  for (FilterStmt *join_filter_stmt : select_stmt->join_filter_stmts()) {
+    _collect_filter_fields(join_filter_stmt, fields);
+  }
+  _collect_filter_fields(select_stmt->having_stmt(), fields);
+  if (select_stmt->group_by_stmt() != nullptr) {
+    for (Expression *expr : select_stmt->group_by_stmt()->group_by_exprs()) {
+      expr->getFields(fields);
+    }
+  }
+  if (select_stmt->order_stmt() != nullptr) {
+    for (OrderByUnit *order_unit : select_stmt->order_stmt()->order_units()) {
+      order_unit->expr()->getFields(fields);
+    }
+  }
+}
+
 RC LogicalPlanGenerator::plan_node(
     SelectStmt *select_stmt, unique_ptr<LogicalNode> &logical_node)
 {
   const std::vector<Table *> &tables     = select_stmt->tables();
-  const std::vector<Field *> &all_fields = select_stmt->query_fields();
+  std::vector<Field *> all_fields;
+  _collect_query_fields(select_stmt, all_fields);
   RC rc;
 
   std::unique_ptr<LogicalNode> root;
@@ -133,6 +175,9 @@ RC LogicalPlanGenerator::plan_node(
         new TableGetLogicalNode(table, table_alias, fields, true/*readonly*/));
     table_get_nodes.push_back(std::move(table_get_node));
   }
+  for (Field *field : all_fields) {
+    delete field;
+  }
 
   // 2. inner join node
   // TODO [Lab3] 完善Join节点的逻辑计划生成, 需要解析并设置Join涉及的表,以及Join使用到的连接条件
@@ -178,19 +223,25 @@ RC LogicalPlanGenerator::plan_node(
   for (auto *expr : select_stmt->projects()) {
     AggrExpr::getAggrExprs(expr, aggr_exprs);
   }
-  if(!aggr_exprs.empty()){
-    unique_ptr<LogicalNode> aggr_node = unique_ptr<LogicalNode>(new AggrLogicalNode(aggr_exprs));
-    aggr_node->add_child(std::move(root));
-    root = std::move(aggr_node);
-  }
-
-  // 5. Having filter node
+  // HAVING 中的聚合函数也在聚合节点中计算
   if (select_stmt->having_stmt() != nullptr) {
     for (auto *filter_unit : select_stmt->having_stmt()->filter_units()) {
       AggrExpr::getAggrExprs(filter_unit->left_expr(), aggr_exprs);
       AggrExpr::getAggrExprs(filter_unit->right_expr(), aggr_exprs);
     }
   }
+  if (select_stmt->group_by_stmt() != nullptr) {
+    unique_ptr<LogicalNode> group_by_node = unique_ptr<LogicalNode>(
+        new GroupByLogicalNode(select_stmt->group_by_stmt()->group_by_exprs(), aggr_exprs));
+    group_by_node->add_child(std::move(root));
+    root = std::move(group_by_node);
+  } else if(!aggr_exprs.empty()){
+    unique_ptr<LogicalNode> aggr_node = unique_ptr<LogicalNode>(new AggrLogicalNode(aggr_exprs));
+    aggr_node->add_child(std::move(root));
+    root = std::move(aggr_node);
+  }
+
+  // 5. Having filter node
   if (select_stmt->having_stmt() != nullptr &&
       !select_stmt->having_stmt()->filter_units().empty()) {
     unique_ptr<LogicalNode> having_node;
@@ -201,7 +252,8 @@ RC LogicalPlanGenerator::plan_node(
 
   // 6. Sort node
   if (select_stmt->order_stmt() != nullptr && !select_stmt->order_stmt()->order_units().empty()) {
-    unique_ptr<LogicalNode> order_node = unique_ptr<LogicalNode>(new OrderByLogicalNode(select_stmt->order_stmt()->order_units()));
+    auto order_node = unique_ptr<OrderByLogicalNode>(new OrderByLogicalNode(select_stmt->order_stmt()->order_units()));
+    order_node->set_limit(select_stmt->order_stmt()->limit());
     order_node->add_child(std::move(root));
     root = std::move(order_node);
   }
@@ -1,5 +1,9 @@
+#include <type_traits>
+
 #include "common/log/log.h"
 #include "include/query_engine/planner/operator/aggr_physical_operator.h"
+#include "include/query_engine/planner/operator/gather_physical_operator.h"
+#include "include/query_engine/planner/operator/table_scan_physical_operator.h"
 #include "include/storage_engine/recorder/table.h"
 
 RC AggrPhysicalOperator::open(Trx *trx)
@@ -15,59 +19,79 @@ RC AggrPhysicalOperator::open(Trx *trx)
     return rc;
   }
 
-  aggr_init();
+  aggr_init(partial_);
+  finished_ = false;
+  // 下层算子的元组对象在整个执行过程中不变，打开以后就可以确定字段的下标
+  bind_cells(child->current_tuple());
 
   return RC::SUCCESS;
 }
 
 RC AggrPhysicalOperator::next()
 {
-  RC rc;
-  if (children_.empty()) {
+  RC rc = RC::SUCCESS;
+  if (children_.empty() || finished_) {
     return RC::RECORD_EOF;
   }
+  finished_ = true;
 
   PhysicalOperator *child = children_[0].get();
-  bool aggr_flag = false;
-  while (RC::SUCCESS == (rc = child->next())) {
-    aggr_flag = true;
-    Tuple *tuple = child->current_tuple();
-    if (nullptr == tuple) {
-      LOG_WARN("failed to get current record: %s", strrc(rc));
+  bool counted = false;
+  rc = count_records(counted);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  if (counted) {
+    aggr_done();
+    return RC::SUCCESS;
+  }
+
+  // 并行扫描时每个线程分别聚合；子算子支持时按批聚合，否则逐行聚合
+  if (child->type() == PhysicalOperatorType::GATHER && child->support_batch()) {
+    rc = aggr_parallel(*static_cast<GatherPhysicalOperator *>(child));
+    if (rc != RC::SUCCESS) {
       return rc;
     }
-
-    for (int i = 0; i < aggr_fields_.size(); i ++) {
-      const auto& aggr_field = aggr_fields_[i];
-      if (0 == strcmp(aggr_field.field_name(), "*")) {
-        all_null_[i] = false;
-        counts_[i] ++;
-        continue;
-      }
-      Value value;
-      const TupleCellSpec *spec =
-          new TupleCellSpec(aggr_field.table_name(), aggr_field.field_name(), aggr_field.table_alias());
-      rc = tuple->find_cell(*spec, value);
-      if(rc != RC::SUCCESS) {
+    rc = RC::RECORD_EOF;
+  } else if (child->support_batch()) {
+    while (RC::SUCCESS == (rc = child->next_batch(chunk_))) {
+      rc = aggr_batch(partial_, chunk_);
+      if (rc != RC::SUCCESS) {
         return rc;
       }
-      if (value.is_null()) {
-        continue;
+    }
+  } else {
+    while (RC::SUCCESS == (rc = child->next())) {
+      Tuple *tuple = child->current_tuple();
+      if (nullptr == tuple) {
+        LOG_WARN("failed to get current record: %s", strrc(rc));
+        return RC::INTERNAL;
+      }
+
+      for (size_t i = 0; i < aggr_fields_.size(); i++) {
+        const int index = cell_indexes_[i];
+        if (index == -2) {
+          partial_.accumulators[i].count++;
+          continue;
+        }
+        Value &value = partial_.value;
+        rc = index >= 0 ? tuple->cell_at(index, value) : tuple->find_cell(specs_[i], value);
+        if (rc != RC::SUCCESS) {
+          return rc;
+        }
+        if (!value.is_null()) {
+          aggr_value(partial_, i, value);
+        }
       }
-      all_null_[i] = false;
-      counts_[i] ++;
-      aggr_update(aggr_types_[i], aggr_results_[i], value);
     }
-    is_first_called_ = false;
   }
-  if (aggr_flag || is_first_called_) {
-    aggr_done();
-    is_first_called_ = false;
-    return RC::SUCCESS;
-  } else {
-    return RC::RECORD_EOF;
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to read child operator of aggregation. rc=%s", strrc(rc));
+    return rc;
   }
 
+  aggr_done();
+  return RC::SUCCESS;
 }
 
 RC AggrPhysicalOperator::close()
@@ -83,76 +107,339 @@ Tuple *AggrPhysicalOperator::current_tuple()
   return &tuple_;
 }
 
-void AggrPhysicalOperator::aggr_init() {
-  is_first_called_ = true;
-  counts_.resize(aggr_fields_.size());
-  all_null_.resize(aggr_fields_.size());
-  aggr_results_.resize(aggr_fields_.size());
-  for (size_t i = 0; i < all_null_.size(); ++i) {
-    all_null_[i] = true;
-    counts_[i]   = 0;
-    aggr_results_[i].set_null();
+void AggrPhysicalOperator::bind_cells(const Tuple *tuple)
+{
+  cell_indexes_.clear();
+  specs_.clear();
+  for (const Field &aggr_field : aggr_fields_) {
+    specs_.emplace_back(aggr_field.table_name(), aggr_field.field_name(), aggr_field.table_alias());
+    int index = -2;
+    if (0 != strcmp(aggr_field.field_name(), "*") &&
+        (tuple == nullptr || tuple->find_cell_index(specs_.back(), index) != RC::SUCCESS)) {
+      index = -1;
+    }
+    cell_indexes_.push_back(index);
   }
 }
-void AggrPhysicalOperator::aggr_update(AggrType aggr_type, Value& aggr_result, Value& value) {
-  if(aggr_result.is_null()) {
-    aggr_result = value;
-    return;
+
+RC AggrPhysicalOperator::count_records(bool &counted)
+{
+  counted = false;
+  PhysicalOperator *child = children_[0].get();
+  if (child->type() == PhysicalOperatorType::GATHER) {
+    // 每个并行扫描的子算子都是整张表上的扫描，任取一个即可
+    child = child->children().front().get();
+  }
+  if (child->type() != PhysicalOperatorType::TABLE_SCAN) {
+    return RC::SUCCESS;
+  }
+  for (int index : cell_indexes_) {
+    if (index != -2) {
+      return RC::SUCCESS;
+    }
   }
+
+  int64_t count = 0;
+  RC rc = static_cast<TableScanPhysicalOperator *>(child)->count_records(count);
+  if (rc == RC::UNIMPLENMENT) {
+    return RC::SUCCESS;
+  }
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to count records of table scan. rc=%s", strrc(rc));
+    return rc;
+  }
+  for (Accumulator &accumulator : partial_.accumulators) {
+    accumulator.count = count;
+  }
+  counted = true;
+  return RC::SUCCESS;
+}
+
+RC AggrPhysicalOperator::aggr_batch(PartialAggr &partial, Chunk &chunk)
+{
+  std::vector<int> &columns = partial.columns;
+  if (columns.size() != aggr_fields_.size()) {
+    columns.clear();
+    for (const Field &aggr_field : aggr_fields_) {
+      int index = -1;
+      if (0 != strcmp(aggr_field.field_name(), "*")) {
+        index = chunk.find_column(aggr_field.table_name(), aggr_field.field_name(), aggr_field.table_alias());
+        if (index < 0) {
+          LOG_WARN("failed to find column of aggregation field. field=%s.%s", aggr_field.table_name(), aggr_field.field_name());
+          return RC::NOTFOUND;
+        }
+      }
+      columns.push_back(index);
+    }
+  }
+
+  const std::vector<int> &selection = chunk.selection();
+  for (size_t i = 0; i < aggr_fields_.size(); i++) {
+    if (columns[i] < 0) {
+      partial.accumulators[i].count += chunk.select_num();
+      continue;
+    }
+
+    const Column &column = chunk.column(columns[i]);
+    switch (column.attr_type()) {
+      case INTS:
+      case DATES: {
+        aggr_numeric_column<int32_t>(partial, i, column, selection);
+      } break;
+      case FLOATS: {
+        aggr_numeric_column<float>(partial, i, column, selection);
+      } break;
+      default: {
+        aggr_column(partial, i, column, selection);
+      } break;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+template <typename T>
+void AggrPhysicalOperator::aggr_numeric_column(
+    PartialAggr &partial, int index, const Column &column, const std::vector<int> &selection)
+{
+  using SumType = typename std::conditional<std::is_same<T, float>::value, double, int64_t>::type;
+
+  const T *values = column.values<T>();
+  const AggrType aggr_type = aggr_types_[index];
+  int count = 0;
+  SumType sum = 0;
+  int best_row = -1;
   switch (aggr_type) {
+    case AGGR_SUM:
+    case AGGR_AVG: {
+      for (int row : selection) {
+        if (!column.is_null(row)) {
+          sum += values[row];
+          count++;
+        }
+      }
+    } break;
     case AGGR_MIN: {
-      int cmp_result = aggr_result.compare(value);
-      if (cmp_result > 0) {
-        aggr_result = value;
+      for (int row : selection) {
+        if (!column.is_null(row) && (best_row < 0 || values[row] < values[best_row])) {
+          best_row = row;
+        }
+        count += column.is_null(row) ? 0 : 1;
       }
-      break;
-    }
+    } break;
     case AGGR_MAX: {
-      int cmp_result = aggr_result.compare(value);
-      if (cmp_result < 0) {
-        aggr_result = value;
+      for (int row : selection) {
+        if (!column.is_null(row) && (best_row < 0 || values[row] > values[best_row])) {
+          best_row = row;
+        }
+        count += column.is_null(row) ? 0 : 1;
       }
-      break;
+    } break;
+    default: {
+      for (int row : selection) {
+        count += column.is_null(row) ? 0 : 1;
+      }
+    } break;
+  }
+
+  if (count == 0) {
+    return;
+  }
+
+  const SumType value = best_row >= 0 ? static_cast<SumType>(values[best_row]) : sum;
+  if (std::is_same<T, float>::value) {
+    aggr_float(partial, index, column.attr_type(), count, value);
+  } else {
+    aggr_int(partial, index, column.attr_type(), count, value);
+  }
+}
+
+void AggrPhysicalOperator::aggr_column(
+    PartialAggr &partial, int index, const Column &column, const std::vector<int> &selection)
+{
+  for (int row : selection) {
+    if (column.is_null(row)) {
+      continue;
     }
-    case AGGR_AVG:
-    case AGGR_SUM:{
-      switch (value.attr_type()) {
-        case INTS: {
-          aggr_result.set_int(aggr_result.get_int() + value.get_int());
-          break;
-        }
-        case FLOATS: {
-          aggr_result.set_float(aggr_result.get_float() + value.get_float());
-          break;
-        }
-        default: break;
+    if (aggr_types_[index] == AGGR_COUNT) {
+      partial.accumulators[index].count++;
+    } else {
+      column.get_value(row, partial.value);
+      aggr_value(partial, index, partial.value);
+    }
+  }
+}
+
+void AggrPhysicalOperator::aggr_init(PartialAggr &partial) const {
+  partial.accumulators.assign(aggr_fields_.size(), Accumulator());
+  partial.columns.clear();
+}
+
+void AggrPhysicalOperator::aggr_int(PartialAggr &partial, int index, AttrType type, int64_t count, int64_t value)
+{
+  Accumulator &accumulator = partial.accumulators[index];
+  const bool first = (accumulator.count == 0);
+  if (first) {
+    accumulator.type = type;
+  }
+  accumulator.count += count;
+  switch (aggr_types_[index]) {
+    case AGGR_SUM:
+    case AGGR_AVG: {
+      accumulator.int_value += value;
+    } break;
+    case AGGR_MIN: {
+      if (first || value < accumulator.int_value) {
+        accumulator.int_value = value;
+      }
+    } break;
+    case AGGR_MAX: {
+      if (first || value > accumulator.int_value) {
+        accumulator.int_value = value;
+      }
+    } break;
+    default: break;
+  }
+}
+
+void AggrPhysicalOperator::aggr_float(PartialAggr &partial, int index, AttrType type, int64_t count, double value)
+{
+  Accumulator &accumulator = partial.accumulators[index];
+  const bool first = (accumulator.count == 0);
+  if (first) {
+    accumulator.type = type;
+  }
+  accumulator.count += count;
+  switch (aggr_types_[index]) {
+    case AGGR_SUM:
+    case AGGR_AVG: {
+      accumulator.float_value += value;
+    } break;
+    case AGGR_MIN: {
+      if (first || value < accumulator.float_value) {
+        accumulator.float_value = value;
+      }
+    } break;
+    case AGGR_MAX: {
+      if (first || value > accumulator.float_value) {
+        accumulator.float_value = value;
+      }
+    } break;
+    default: break;
+  }
+}
+
+void AggrPhysicalOperator::aggr_string(
+    PartialAggr &partial, int index, AttrType type, int64_t count, const std::string &value)
+{
+  Accumulator &accumulator = partial.accumulators[index];
+  const AggrType aggr_type = aggr_types_[index];
+  if (accumulator.count == 0 ||
+      (aggr_type == AGGR_MIN ? value < accumulator.string_value : value > accumulator.string_value)) {
+    accumulator.string_value = value;
+  }
+  accumulator.type = type;
+  accumulator.count += count;
+}
+
+void AggrPhysicalOperator::aggr_value(PartialAggr &partial, int index, const Value &value)
+{
+  switch (value.attr_type()) {
+    case INTS:
+    case DATES: {
+      aggr_int(partial, index, value.attr_type(), 1, value.get_int());
+    } break;
+    case FLOATS: {
+      aggr_float(partial, index, value.attr_type(), 1, value.get_float());
+    } break;
+    default: {
+      // 字符串求和时按数值处理，最值按字符串比较
+      const AggrType aggr_type = aggr_types_[index];
+      if (aggr_type != AGGR_MIN && aggr_type != AGGR_MAX) {
+        aggr_float(partial, index, value.attr_type(), 1, aggr_type == AGGR_COUNT ? 0 : value.get_float());
+      } else {
+        aggr_string(partial, index, value.attr_type(), 1, value.get_string());
       }
     } break;
-    default:
-      LOG_ERROR("Unsupported AggrFuncType");
+  }
+}
+
+RC AggrPhysicalOperator::aggr_parallel(GatherPhysicalOperator &gather)
+{
+  std::vector<PartialAggr> partials(gather.children().size());
+  for (PartialAggr &partial : partials) {
+    aggr_init(partial);
+  }
+
+  RC rc = gather.execute([this, &partials](int worker, Chunk &chunk) { return aggr_batch(partials[worker], chunk); });
+  if (rc != RC::SUCCESS) {
+    return rc;
   }
 
+  for (const PartialAggr &partial : partials) {
+    merge(partial);
+  }
+  return RC::SUCCESS;
+}
+
+void AggrPhysicalOperator::merge(const PartialAggr &other)
+{
+  for (size_t i = 0; i < aggr_fields_.size(); i++) {
+    const Accumulator &accumulator = other.accumulators[i];
+    if (accumulator.count == 0) {
+      continue;
+    }
+    const AggrType aggr_type = aggr_types_[i];
+    if (accumulator.type == INTS || accumulator.type == DATES) {
+      aggr_int(partial_, i, accumulator.type, accumulator.count, accumulator.int_value);
+    } else if (accumulator.type == FLOATS || (aggr_type != AGGR_MIN && aggr_type != AGGR_MAX)) {
+      aggr_float(partial_, i, accumulator.type, accumulator.count, accumulator.float_value);
+    } else {
+      aggr_string(partial_, i, accumulator.type, accumulator.count, accumulator.string_value);
+    }
+  }
 }
+
 void AggrPhysicalOperator::aggr_done() {
-  for (int i = 0; i < aggr_fields_.size(); i ++) {
-    if (all_null_[i] && AGGR_COUNT != aggr_types_[i]) {
-      aggr_results_[i].set_null();
+  std::vector<Value> aggr_results(aggr_fields_.size());
+  for (size_t i = 0; i < aggr_fields_.size(); i++) {
+    const Accumulator &accumulator = partial_.accumulators[i];
+    Value &result = aggr_results[i];
+    if (aggr_types_[i] == AGGR_COUNT) {
+      result.set_int(static_cast<int>(accumulator.count));
+      continue;
+    }
+    if (accumulator.count == 0) {
+      result.set_null();
       continue;
     }
+
+    const bool is_int = accumulator.type == INTS || accumulator.type == DATES;
     switch (aggr_types_[i]) {
-      case AGGR_COUNT:{
-        aggr_results_[i].set_type(AttrType::INTS);
-        aggr_results_[i].set_int(counts_[i]);
+      case AGGR_SUM: {
+        if (is_int) {
+          result.set_int(static_cast<int>(accumulator.int_value));
+        } else {
+          result.set_float(static_cast<float>(accumulator.float_value));
+        }
       } break;
       case AGGR_AVG: {
-        float sum = aggr_results_[i].get_float();
-        if (counts_[i] != 0) {
-          aggr_results_[i].set_float(sum / (float)counts_[i]);
+        const double sum = is_int ? static_cast<double>(accumulator.int_value) : accumulator.float_value;
+        result.set_float(static_cast<float>(sum / accumulator.count));
+      } break;
+      default: {
+        if (accumulator.type == INTS) {
+          result.set_int(static_cast<int>(accumulator.int_value));
+        } else if (accumulator.type == DATES) {
+          result.set_date(static_cast<int>(accumulator.int_value));
+        } else if (accumulator.type == FLOATS) {
+          result.set_float(static_cast<float>(accumulator.float_value));
+        } else if (accumulator.type == TEXTS) {
+          result.set_text(accumulator.string_value.c_str(), accumulator.string_value.size());
+        } else {
+          result.set_string(accumulator.string_value.c_str(), accumulator.string_value.size());
         }
-        break;
-      }
-      default: break;
+      } break;
     }
   }
-  tuple_.set_tuple(alias_, aggr_results_);
-}
\ No newline at end of file
+  tuple_.set_tuple(alias_, aggr_results);
+}
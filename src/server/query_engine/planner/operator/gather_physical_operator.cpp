@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "common/log/log.h"
+#include "common/os/process_param.h"
+#include "include/query_engine/planner/operator/gather_physical_operator.h"
+#include "include/query_engine/structor/chunk.h"
+#include "include/storage_engine/recorder/table.h"
+
+GatherPhysicalOperator::GatherPhysicalOperator(std::unique_ptr<TableScanPhysicalOperator> scan, int worker_num)
+    : table_(scan->table())
+{
+  for (int i = 1; i < worker_num; i++) {
+    std::unique_ptr<TableScanPhysicalOperator> worker = scan->copy();
+    worker->set_page_ranges(&page_ranges_);
+    add_child(std::move(worker));
+  }
+  scan->set_page_ranges(&page_ranges_);
+  add_child(std::move(scan));
+}
+
+std::string GatherPhysicalOperator::param() const
+{
+  return std::string(table_->name()) + " workers=" + std::to_string(children_.size());
+}
+
+int GatherPhysicalOperator::thread_num()
+{
+#ifdef CONCURRENCY
+  int thread_num = common::the_process_param()->scan_thread_num();
+  if (thread_num <= 0) {
+    thread_num = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  return std::max(thread_num, 1);
+#else
+  return 1;
+#endif
+}
+
+int GatherPhysicalOperator::worker_num_of(const TableScanPhysicalOperator &scan)
+{
+  if (!scan.support_batch()) {
+    return 1;
+  }
+  const int range_num = scan.table()->data_page_count() / PageRangeDispenser::DEFAULT_RANGE_PAGES;
+  return std::max(1, std::min(thread_num(), range_num / 2));
+}
+
+RC GatherPhysicalOperator::open(Trx *trx)
+{
+  // 每次执行都从头分配页面，执行期间新分配的页面不一定能扫描到，与单线程扫描相同
+  page_ranges_.init(table_->data_page_count());
+  current_ = 0;
+  for (std::unique_ptr<PhysicalOperator> &child : children_) {
+    RC rc = child->open(trx);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to open table scan of gather. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC GatherPhysicalOperator::next()
+{
+  while (current_ < children_.size()) {
+    RC rc = children_[current_]->next();
+    if (rc != RC::RECORD_EOF) {
+      return rc;
+    }
+    current_++;
+  }
+  return RC::RECORD_EOF;
+}
+
+RC GatherPhysicalOperator::next_batch(Chunk &chunk)
+{
+  while (current_ < children_.size()) {
+    RC rc = children_[current_]->next_batch(chunk);
+    if (rc != RC::RECORD_EOF) {
+      return rc;
+    }
+    current_++;
+  }
+  return RC::RECORD_EOF;
+}
+
+Tuple *GatherPhysicalOperator::current_tuple()
+{
+  return children_[std::min(current_, children_.size() - 1)]->current_tuple();
+}
+
+RC GatherPhysicalOperator::execute(const Consumer &consumer)
+{
+  std::atomic<bool> stop(false);
+  std::vector<RC> results(children_.size(), RC::SUCCESS);
+
+  auto worker = [&](int index) {
+    PhysicalOperator *child = children_[index].get();
+    Chunk chunk;
+    RC rc = RC::SUCCESS;
+    while (!stop.load() && RC::SUCCESS == (rc = child->next_batch(chunk))) {
+      rc = consumer(index, chunk);
+      if (rc != RC::SUCCESS) {
+        break;
+      }
+    }
+    if (rc != RC::SUCCESS && rc != RC::RECORD_EOF) {
+      results[index] = rc;
+      stop.store(true);
+    }
+  };
+
+  // 当前线程也作为一个扫描线程
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < children_.size(); i++) {
+    threads.emplace_back(worker, static_cast<int>(i));
+  }
+  worker(0);
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  for (RC rc : results) {
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to scan table in parallel. table=%s, rc=%s", table_->name(), strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC GatherPhysicalOperator::close()
+{
+  for (std::unique_ptr<PhysicalOperator> &child : children_) {
+    child->close();
+  }
+  return RC::SUCCESS;
+}
@@ -1,3 +1,626 @@
+#include <cstring>
+#include <functional>
+#include <string_view>
+
 #include "include/query_engine/planner/operator/group_by_physical_operator.h"
+#include "common/os/process_param.h"
+
+GroupByPhysicalOperator::GroupByPhysicalOperator(GroupByLogicalNode *logical_oper)
+    : alias_(logical_oper->_alias_()),
+      aggr_types_(logical_oper->_aggr_types_()),
+      aggr_fields_(logical_oper->_aggr_fields_()),
+      group_fields_(logical_oper->group_fields())
+{}
+
+size_t GroupByPhysicalOperator::memory_limit()
+{
+  const int memory_size = common::the_process_param()->group_memory_size();
+  return memory_size > 0 ? static_cast<size_t>(memory_size) : DEFAULT_MEMORY_LIMIT;
+}
+
+size_t GroupByPhysicalOperator::HashTable::memory() const
+{
+  return keys.size() + groups.size() * sizeof(Group) + states.size() * sizeof(AggrState) +
+         buckets.size() * sizeof(int32_t) + string_memory;
+}
+
+void GroupByPhysicalOperator::HashTable::clear()
+{
+  // 溢出以后要真正释放内存，不能只是清空
+  *this = HashTable();
+}
+
+uint64_t GroupByPhysicalOperator::hash_of(const char *key, int key_len)
+{
+  uint64_t h = std::hash<std::string_view>()(std::string_view(key, key_len));
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// 不同层使用不同的种子，这样重新分区时同一个分区的数据可以分散开
+int GroupByPhysicalOperator::partition_of(uint64_t hash, int level)
+{
+  uint64_t h = hash + 0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(level + 1);
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  return static_cast<int>(h % PARTITION_NUM);
+}
+
+RC GroupByPhysicalOperator::open(Trx *trx)
+{
+  if (children_.size() != 1) {
+    LOG_WARN("group by operator must has one child");
+    return RC::INTERNAL;
+  }
+
+  RC rc = children_[0]->open(trx);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open child operator of group by. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  bound_ = false;
+  aggregated_ = false;
+  value_types_.assign(aggr_fields_.size(), AttrType::UNDEFINED);
+  group_values_.resize(group_fields_.size());
+  table_.clear();
+  output_pos_ = 0;
+  pending_.clear();
+  return RC::SUCCESS;
+}
+
+RC GroupByPhysicalOperator::next()
+{
+  RC rc = RC::SUCCESS;
+  if (!aggregated_) {
+    aggregated_ = true;
+    rc = aggregate();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
+  while (output_pos_ >= table_.groups.size()) {
+    table_.clear();
+    output_pos_ = 0;
+    if (pending_.empty()) {
+      return RC::RECORD_EOF;
+    }
+    std::unique_ptr<Partition> partition = std::move(pending_.back());
+    pending_.pop_back();
+    rc = process_partition(std::move(partition));
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
+  const Group &group = table_.groups[output_pos_];
+  std::vector<Value> group_values;
+  decode_group_key(table_.keys.data() + group.key_offset, group.key_len, group_values);
+
+  const size_t aggr_num = aggr_fields_.size();
+  std::vector<Value> aggr_results(aggr_num);
+  for (size_t i = 0; i < aggr_num; i++) {
+    aggr_result(table_, table_.states[output_pos_ * aggr_num + i], i, aggr_results[i]);
+  }
+  tuple_.set_group(group_fields_, group_values);
+  tuple_.set_tuple(alias_, aggr_results);
+  output_pos_++;
+  return RC::SUCCESS;
+}
+
+RC GroupByPhysicalOperator::close()
+{
+  table_.clear();
+  pending_.clear();
+  if (!children_.empty()) {
+    children_[0]->close();
+  }
+  return RC::SUCCESS;
+}
+
+Tuple *GroupByPhysicalOperator::current_tuple()
+{
+  return &tuple_;
+}
+
+RC GroupByPhysicalOperator::bind_cells(const Tuple &tuple)
+{
+  group_specs_.clear();
+  group_indexes_.clear();
+  for (const Field &field : group_fields_) {
+    group_specs_.emplace_back(field.table_name(), field.field_name(), field.table_alias());
+    int index = -1;
+    if (tuple.find_cell_index(group_specs_.back(), index) != RC::SUCCESS) {
+      index = -1;
+    }
+    group_indexes_.push_back(index);
+  }
+
+  aggr_specs_.clear();
+  aggr_indexes_.clear();
+  for (const Field &field : aggr_fields_) {
+    aggr_specs_.emplace_back(field.table_name(), field.field_name(), field.table_alias());
+    int index = -2;
+    if (0 != strcmp(field.field_name(), "*") && tuple.find_cell_index(aggr_specs_.back(), index) != RC::SUCCESS) {
+      index = -1;
+    }
+    aggr_indexes_.push_back(index);
+  }
+  bound_ = true;
+  return RC::SUCCESS;
+}
+
+RC GroupByPhysicalOperator::cell_of(const Tuple &tuple, int index, const TupleCellSpec &spec, Value &value) const
+{
+  RC rc = index >= 0 ? tuple.cell_at(index, value) : tuple.find_cell(spec, value);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to get cell of group by. field=%s.%s, rc=%s", spec.table_name(), spec.field_name(), strrc(rc));
+  }
+  return rc;
+}
+
+// 每个值是 | 类型 | 数据 |，null 只有类型。同一列的类型相同，编码相同就是同一个分组
+void GroupByPhysicalOperator::encode_group_key(const std::vector<Value> &values, std::string &key) const
+{
+  key.clear();
+  for (const Value &value : values) {
+    if (value.is_null()) {
+      key.push_back(static_cast<char>(AttrType::NULLS));
+      continue;
+    }
+    key.push_back(static_cast<char>(value.attr_type()));
+    switch (value.attr_type()) {
+      case INTS:
+      case DATES: {
+        const int32_t v = value.get_int();
+        key.append(reinterpret_cast<const char *>(&v), sizeof(v));
+      } break;
+      case FLOATS: {
+        const float v = value.get_float() + 0.0f;  // -0.0 与 0.0 相同
+        key.append(reinterpret_cast<const char *>(&v), sizeof(v));
+      } break;
+      case BOOLEANS: {
+        key.push_back(value.get_boolean() ? 1 : 0);
+      } break;
+      default: {
+        const std::string str = value.get_string();
+        const int32_t len = static_cast<int32_t>(str.size());
+        key.append(reinterpret_cast<const char *>(&len), sizeof(len));
+        key.append(str);
+      } break;
+    }
+  }
+}
+
+void GroupByPhysicalOperator::decode_group_key(const char *key, int key_len, std::vector<Value> &values) const
+{
+  values.clear();
+  const char *end = key + key_len;
+  while (key < end) {
+    const AttrType type = static_cast<AttrType>(*key++);
+    values.emplace_back();
+    Value &value = values.back();
+    switch (type) {
+      case NULLS: {
+        value.set_null();
+      } break;
+      case INTS:
+      case DATES: {
+        int32_t v;
+        memcpy(&v, key, sizeof(v));
+        key += sizeof(v);
+        if (type == INTS) {
+          value.set_int(v);
+        } else {
+          value.set_date(v);
+        }
+      } break;
+      case FLOATS: {
+        float v;
+        memcpy(&v, key, sizeof(v));
+        key += sizeof(v);
+        value.set_float(v);
+      } break;
+      case BOOLEANS: {
+        value.set_boolean(*key++ != 0);
+      } break;
+      default: {
+        int32_t len;
+        memcpy(&len, key, sizeof(len));
+        key += sizeof(len);
+        const char *str = len > 0 ? key : "";
+        if (type == TEXTS) {
+          value.set_text(str, len);
+        } else {
+          value.set_string(str, len);
+        }
+        key += len;
+      } break;
+    }
+  }
+}
+
+int GroupByPhysicalOperator::find_or_insert(HashTable &table, const std::string &key, uint64_t hash)
+{
+  if ((table.groups.size() + 1) * 2 > table.buckets.size()) {
+    grow(table);
+  }
+
+  const size_t mask = table.buckets.size() - 1;
+  for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+    const int32_t index = table.buckets[pos];
+    if (index < 0) {
+      Group group;
+      group.hash = hash;
+      group.key_offset = static_cast<uint32_t>(table.keys.size());
+      group.key_len = static_cast<uint32_t>(key.size());
+      table.keys.insert(table.keys.end(), key.begin(), key.end());
+      table.groups.push_back(group);
+
+      AggrState state;
+      state.count = 0;
+      state.int_value = 0;
+      state.string_index = -1;
+      table.states.resize(table.states.size() + aggr_fields_.size(), state);
+      table.buckets[pos] = static_cast<int32_t>(table.groups.size() - 1);
+      return table.buckets[pos];
+    }
+
+    const Group &group = table.groups[index];
+    if (group.hash == hash && group.key_len == key.size() &&
+        0 == memcmp(table.keys.data() + group.key_offset, key.data(), key.size())) {
+      return index;
+    }
+  }
+}
+
+void GroupByPhysicalOperator::grow(HashTable &table)
+{
+  const size_t bucket_num = table.buckets.empty() ? 1024 : table.buckets.size() * 2;
+  table.buckets.assign(bucket_num, -1);
+  const size_t mask = bucket_num - 1;
+  for (size_t i = 0; i < table.groups.size(); i++) {
+    size_t pos = table.groups[i].hash & mask;
+    while (table.buckets[pos] >= 0) {
+      pos = (pos + 1) & mask;
+    }
+    table.buckets[pos] = static_cast<int32_t>(i);
+  }
+}
+
+void GroupByPhysicalOperator::accumulate(HashTable &table, AggrState &state, int index, const Value &value)
+{
+  if (value_types_[index] == AttrType::UNDEFINED) {
+    value_types_[index] = value.attr_type();
+  }
+  const AttrType type = value_types_[index];
+  const bool first = (state.count == 0);
+  state.count++;
+
+  switch (aggr_types_[index]) {
+    case AGGR_SUM:
+    case AGGR_AVG: {
+      if (type == INTS) {
+        state.int_value += value.get_int();
+      } else {
+        state.float_value += value.get_float();
+      }
+    } break;
+    case AGGR_MIN:
+    case AGGR_MAX: {
+      const bool is_min = aggr_types_[index] == AGGR_MIN;
+      if (type == INTS || type == DATES) {
+        const int64_t v = value.get_int();
+        if (first || (is_min ? v < state.int_value : v > state.int_value)) {
+          state.int_value = v;
+        }
+      } else if (type == FLOATS) {
+        const double v = value.get_float();
+        if (first || (is_min ? v < state.float_value : v > state.float_value)) {
+          state.float_value = v;
+        }
+      } else {
+        std::string v = value.get_string();
+        if (first) {
+          state.string_index = static_cast<int32_t>(table.strings.size());
+          table.string_memory += v.size() + sizeof(std::string);
+          table.strings.emplace_back(std::move(v));
+        } else {
+          std::string &best = table.strings[state.string_index];
+          if (is_min ? v < best : v > best) {
+            table.string_memory += v.size();
+            table.string_memory -= best.size();
+            best = std::move(v);
+          }
+        }
+      }
+    } break;
+    default: break;
+  }
+}
+
+void GroupByPhysicalOperator::merge(
+    HashTable &table, AggrState &state, int index, const AggrState &other, const std::string *other_string)
+{
+  if (other.count == 0) {
+    return;
+  }
+  const AttrType type = value_types_[index];
+  const bool first = (state.count == 0);
+  state.count += other.count;
+
+  switch (aggr_types_[index]) {
+    case AGGR_SUM:
+    case AGGR_AVG: {
+      if (type == INTS) {
+        state.int_value += other.int_value;
+      } else {
+        state.float_value += other.float_value;
+      }
+    } break;
+    case AGGR_MIN:
+    case AGGR_MAX: {
+      const bool is_min = aggr_types_[index] == AGGR_MIN;
+      if (type == INTS || type == DATES) {
+        if (first || (is_min ? other.int_value < state.int_value : other.int_value > state.int_value)) {
+          state.int_value = other.int_value;
+        }
+      } else if (type == FLOATS) {
+        if (first || (is_min ? other.float_value < state.float_value : other.float_value > state.float_value)) {
+          state.float_value = other.float_value;
+        }
+      } else if (other_string != nullptr) {
+        if (first) {
+          state.string_index = static_cast<int32_t>(table.strings.size());
+          table.string_memory += other_string->size() + sizeof(std::string);
+          table.strings.push_back(*other_string);
+        } else {
+          std::string &best = table.strings[state.string_index];
+          if (is_min ? *other_string < best : *other_string > best) {
+            table.string_memory += other_string->size();
+            table.string_memory -= best.size();
+            best = *other_string;
+          }
+        }
+      }
+    } break;
+    default: break;
+  }
+}
+
+void GroupByPhysicalOperator::aggr_result(const HashTable &table, const AggrState &state, int index, Value &value) const
+{
+  const AggrType aggr_type = aggr_types_[index];
+  if (aggr_type == AGGR_COUNT) {
+    value.set_int(static_cast<int>(state.count));
+    return;
+  }
+  if (state.count == 0) {
+    value.set_null();
+    return;
+  }
+
+  const AttrType type = value_types_[index];
+  switch (aggr_type) {
+    case AGGR_SUM: {
+      if (type == INTS) {
+        value.set_int(static_cast<int>(state.int_value));
+      } else {
+        value.set_float(static_cast<float>(state.float_value));
+      }
+    } break;
+    case AGGR_AVG: {
+      const double sum = type == INTS ? static_cast<double>(state.int_value) : state.float_value;
+      value.set_float(static_cast<float>(sum / state.count));
+    } break;
+    default: {
+      if (type == INTS) {
+        value.set_int(static_cast<int>(state.int_value));
+      } else if (type == DATES) {
+        value.set_date(static_cast<int>(state.int_value));
+      } else if (type == FLOATS) {
+        value.set_float(static_cast<float>(state.float_value));
+      } else {
+        const std::string &str = table.strings[state.string_index];
+        if (type == TEXTS) {
+          value.set_text(str.c_str(), str.size());
+        } else {
+          value.set_string(str.c_str(), str.size());
+        }
+      }
+    } break;
+  }
+}
+
+// 读取下层算子的所有数据做聚合，内存不够时把部分聚合的结果写到各个分区的临时文件中
+RC GroupByPhysicalOperator::aggregate()
+{
+  PhysicalOperator *child = children_[0].get();
+  const size_t aggr_num = aggr_fields_.size();
+  const size_t limit = memory_limit();
+  std::vector<std::unique_ptr<Partition>> partitions;
+
+  RC rc = RC::SUCCESS;
+  while ((rc = child->next()) == RC::SUCCESS) {
+    Tuple *tuple = child->current_tuple();
+    if (!bound_) {
+      rc = bind_cells(*tuple);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+
+    for (size_t i = 0; i < group_fields_.size(); i++) {
+      rc = cell_of(*tuple, group_indexes_[i], group_specs_[i], group_values_[i]);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+    encode_group_key(group_values_, key_);
+    const int group = find_or_insert(table_, key_, hash_of(key_.data(), key_.size()));
+
+    AggrState *states = table_.states.data() + group * aggr_num;
+    for (size_t i = 0; i < aggr_num; i++) {
+      if (aggr_indexes_[i] == -2) {
+        states[i].count++;
+        continue;
+      }
+      rc = cell_of(*tuple, aggr_indexes_[i], aggr_specs_[i], value_);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      if (!value_.is_null()) {
+        accumulate(table_, states[i], i, value_);
+      }
+    }
+
+    if (table_.memory() > limit) {
+      rc = spill(table_, partitions, 0);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to read child operator of group by. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (partitions.empty()) {
+    return RC::SUCCESS;
+  }
+
+  // 已经溢出过，同一个分组的中间状态可能分散在内存和临时文件中，全部写出去以后按分区重新聚合
+  rc = spill(table_, partitions, 0);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  for (auto &partition : partitions) {
+    if (partition->file != nullptr) {
+      pending_.emplace_back(std::move(partition));
+    }
+  }
+  LOG_TRACE("group by spilled to temporary files. partitions=%d", static_cast<int>(pending_.size()));
+  return RC::SUCCESS;
+}
+
+// 每行是 | key_len | key | 所有聚合函数的 AggrState | 字符串最值的 | len | data | ... |
+RC GroupByPhysicalOperator::spill(HashTable &table, std::vector<std::unique_ptr<Partition>> &partitions, int level)
+{
+  if (partitions.empty()) {
+    for (int i = 0; i < PARTITION_NUM; i++) {
+      partitions.emplace_back(std::make_unique<Partition>());
+      partitions.back()->level = level;
+    }
+  }
+
+  const size_t aggr_num = aggr_fields_.size();
+  std::string row;
+  for (size_t i = 0; i < table.groups.size(); i++) {
+    const Group &group = table.groups[i];
+    const int32_t key_len = static_cast<int32_t>(group.key_len);
+    row.assign(reinterpret_cast<const char *>(&key_len), sizeof(key_len));
+    row.append(table.keys.data() + group.key_offset, group.key_len);
+
+    const AggrState *states = table.states.data() + i * aggr_num;
+    row.append(reinterpret_cast<const char *>(states), aggr_num * sizeof(AggrState));
+    for (size_t j = 0; j < aggr_num; j++) {
+      if (states[j].string_index >= 0) {
+        const std::string &str = table.strings[states[j].string_index];
+        const int32_t len = static_cast<int32_t>(str.size());
+        row.append(reinterpret_cast<const char *>(&len), sizeof(len));
+        row.append(str);
+      }
+    }
+
+    Partition &partition = *partitions[partition_of(group.hash, level)];
+    if (partition.file == nullptr) {
+      partition.file = std::make_unique<SpillFile>();
+      RC rc = partition.file->open();
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+    RC rc = partition.file->write_block(row);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
+  table.clear();
+  return RC::SUCCESS;
+}
+
+// 把一个分区的中间状态读到 table_ 中合并，仍然放不进内存时用下一层的种子继续分区
+RC GroupByPhysicalOperator::process_partition(std::unique_ptr<Partition> partition)
+{
+  RC rc = partition->file->rewind();
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  const size_t aggr_num = aggr_fields_.size();
+  const size_t limit = memory_limit();
+  const bool can_split = partition->level < MAX_PARTITION_LEVEL;
+  std::vector<std::unique_ptr<Partition>> children;
+  std::vector<AggrState> states(aggr_num);
+  std::vector<std::string> strings(aggr_num);
+
+  std::string row;
+  bool eof = false;
+  while ((rc = partition->file->read_block(row, eof)) == RC::SUCCESS && !eof) {
+    const char *data = row.data();
+    int32_t key_len;
+    memcpy(&key_len, data, sizeof(key_len));
+    data += sizeof(key_len);
+    key_.assign(data, key_len);
+    data += key_len;
+    memcpy(states.data(), data, aggr_num * sizeof(AggrState));
+    data += aggr_num * sizeof(AggrState);
+    for (size_t i = 0; i < aggr_num; i++) {
+      if (states[i].string_index >= 0) {
+        int32_t len;
+        memcpy(&len, data, sizeof(len));
+        data += sizeof(len);
+        strings[i].assign(data, len);
+        data += len;
+      }
+    }
+
+    const int group = find_or_insert(table_, key_, hash_of(key_.data(), key_.size()));
+    for (size_t i = 0; i < aggr_num; i++) {
+      merge(table_, table_.states[group * aggr_num + i], i, states[i],
+            states[i].string_index >= 0 ? &strings[i] : nullptr);
+    }
+
+    if (can_split && table_.memory() > limit) {
+      rc = spill(table_, children, partition->level + 1);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+  }
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to read spilled partition of group by. level=%d, rc=%s", partition->level, strrc(rc));
+    return rc;
+  }
 
-// TODO
\ No newline at end of file
+  if (!children.empty()) {
+    rc = spill(table_, children, partition->level + 1);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    for (auto &child : children) {
+      if (child->file != nullptr) {
+        pending_.emplace_back(std::move(child));
+      }
+    }
+  }
+  return RC::SUCCESS;
+}
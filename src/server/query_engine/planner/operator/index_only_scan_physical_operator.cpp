@@ -0,0 +1,187 @@
+#include "include/query_engine/planner/operator/index_only_scan_physical_operator.h"
+
+#include "common/lang/bitmap.h"
+#include "include/storage_engine/index/index.h"
+#include "include/storage_engine/transaction/trx.h"
+
+IndexOnlyScanPhysicalOperator::IndexOnlyScanPhysicalOperator(Table *table, Index *index,
+    const std::vector<Value> *left_values, bool left_inclusive,
+    const std::vector<Value> *right_values, bool right_inclusive)
+    : table_(table), index_(index), left_inclusive_(left_inclusive), right_inclusive_(right_inclusive)
+{
+  if (left_values != nullptr) {
+    left_values_ = *left_values;
+    left_null_ = false;
+  }
+  if (right_values != nullptr) {
+    right_values_ = *right_values;
+    right_null_ = false;
+  }
+}
+
+RC IndexOnlyScanPhysicalOperator::open(Trx *trx)
+{
+  if (table_ == nullptr || index_ == nullptr) {
+    return RC::INTERNAL;
+  }
+
+  const TableMeta &table_meta = table_->table_meta();
+  const IndexMeta &index_meta = index_->index_meta();
+  index_fields_.clear();
+  for (int i = 0; i < index_meta.field_amount(); i++) {
+    const FieldMeta *field_meta = table_meta.field(index_meta.field(i));
+    if (field_meta == nullptr) {
+      LOG_WARN("no such field in table. table=%s, field=%s", table_->name(), index_meta.field(i));
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    index_fields_.push_back(field_meta);
+  }
+
+  std::string left_key;
+  std::string right_key;
+  if (!left_null_) {
+    index_->make_user_key(left_values_, left_key);
+  }
+  if (!right_null_) {
+    index_->make_user_key(right_values_, right_key);
+  }
+  index_scanner_ = index_->create_scanner(left_null_ ? nullptr : left_key.data(),
+                                          static_cast<int>(left_key.size()),
+                                          left_inclusive_,
+                                          right_null_ ? nullptr : right_key.data(),
+                                          static_cast<int>(right_key.size()),
+                                          right_inclusive_);
+  if (index_scanner_ == nullptr) {
+    return RC::INTERNAL;
+  }
+
+  trx_ = trx;
+  check_heap_ = table_meta.trx_fields().second > 0;
+
+  // 不在索引中的字段都是0，NULL 位图也是0
+  record_data_.assign(table_meta.record_size(), 0);
+  current_record_.set_data(record_data_.data(), static_cast<int>(record_data_.size()));
+
+  if (table_alias_.empty()) {
+    table_alias_ = table_->name();
+  }
+  tuple_.set_schema(table_, table_alias_, table_meta.field_metas());
+  tuple_._set_record(&current_record_);
+  return RC::SUCCESS;
+}
+
+RC IndexOnlyScanPhysicalOperator::next()
+{
+  RID rid;
+  const char *key = nullptr;
+  while (true) {
+    RC rc = index_scanner_->next_entry(&rid, &key);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    if (check_heap_) {
+      bool visible = false;
+      rc = check_heap(rid, visible);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      if (!visible) {
+        continue;
+      }
+    }
+
+    for (const FieldMeta *field_meta : index_fields_) {
+      memcpy(record_data_.data() + field_meta->offset(), key, field_meta->len());
+      key += field_meta->len();
+    }
+    current_record_.set_rid(rid);
+    tuple_._set_record(&current_record_);
+
+    bool filter_result = false;
+    rc = filter(tuple_, filter_result);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("Failed to filter record, rc=%s", strrc(rc));
+      return rc;
+    }
+    if (filter_result) {
+      return RC::SUCCESS;
+    }
+  }
+}
+
+RC IndexOnlyScanPhysicalOperator::check_heap(const RID &rid, bool &visible)
+{
+  RC visit_rc = RC::SUCCESS;
+  bool has_null = false;
+  const FieldMeta *null_field = table_->table_meta().null_bitmap_field();
+  const std::vector<FieldMeta> *field_metas = table_->table_meta().field_metas();
+  auto checker = [&](Record &record) {
+    visit_rc = trx_->visit_record(table_, record, true /*readonly*/);
+    if (null_field == nullptr) {
+      return;
+    }
+    common::Bitmap bitmap(record.data() + null_field->offset(), null_field->len());
+    for (const FieldMeta *field_meta : index_fields_) {
+      if (bitmap.get_bit(static_cast<int>(field_meta - field_metas->data()))) {
+        has_null = true;
+      }
+    }
+  };
+
+  RC rc = table_->visit_record(rid, true /*readonly*/, checker);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to visit record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+  if (visit_rc == RC::RECORD_INVISIBLE) {
+    visible = false;
+    return RC::SUCCESS;
+  }
+  if (visit_rc != RC::SUCCESS) {
+    return visit_rc;
+  }
+  visible = !has_null;
+  return RC::SUCCESS;
+}
+
+RC IndexOnlyScanPhysicalOperator::close()
+{
+  if (index_scanner_ != nullptr) {
+    index_scanner_->destroy();
+    index_scanner_ = nullptr;
+  }
+  return RC::SUCCESS;
+}
+
+Tuple *IndexOnlyScanPhysicalOperator::current_tuple()
+{
+  tuple_._set_record(&current_record_);
+  return &tuple_;
+}
+
+std::string IndexOnlyScanPhysicalOperator::param() const
+{
+  return std::string(index_->index_meta().name()) + " ON " + table_->name();
+}
+
+RC IndexOnlyScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
+{
+  RC rc = RC::SUCCESS;
+  Value value;
+  for (std::unique_ptr<Expression> &expr : predicates_) {
+    rc = expr->get_value(tuple, value);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    bool tmp_result = value.get_boolean();
+    if (!tmp_result) {
+      result = false;
+      return rc;
+    }
+  }
+
+  result = true;
+  return rc;
+}
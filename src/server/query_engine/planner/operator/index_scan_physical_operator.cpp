@@ -16,15 +16,11 @@ RC IndexScanPhysicalOperator::open(Trx *trx)
   std::string right_key;
   if(!left_null_)
   {
-    for (const auto &value : left_values_) {
-      left_key.append(value.data(), value.length());
-    }
+    index_->make_user_key(left_values_, left_key);
   }
   if(!right_null_)
   {
-    for (const auto &value : right_values_) {
-      right_key.append(value.data(), value.length());
-    }
+    index_->make_user_key(right_values_, right_key);
   }
   IndexScanner *index_scanner = index_->create_scanner(left_key.c_str(),
                                                        left_key.length(), 
@@ -75,6 +71,8 @@ RC IndexScanPhysicalOperator::next()
       return rc;
     }
 
+    // 上一条记录没有通过过滤时页面还没有释放
+    record_page_handler_.cleanup();
     rc = record_handler_->get_record(record_page_handler_,&rid,readonly_,&current_record_);
     if(rc != RC::SUCCESS)
     {
@@ -1,5 +1,11 @@
+#include <cstring>
+#include <functional>
+
 #include "include/query_engine/planner/operator/join_physical_operator.h"
 #include "include/query_engine/structor/expression/comparison_expression.h"
+#include "include/query_engine/structor/expression/conjunction_expression.h"
+#include "include/query_engine/structor/expression/field_expression.h"
+#include "common/os/process_param.h"
 
 /* TODO [Lab3] join的算子实现，需要根据join_condition实现Join的具体逻辑，
   最后将结果传递给JoinTuple, 并由current_tuple向上返回
@@ -13,93 +19,139 @@
 
 JoinPhysicalOperator::JoinPhysicalOperator() = default;
 
-RC JoinPhysicalOperator::get_join_keys()
+size_t JoinPhysicalOperator::memory_limit()
 {
-  // 只处理简单的等值连接条件
-  if (condition_ == nullptr || condition_->type() != ExprType::COMPARISON) {
-    LOG_WARN("Hash join requires a comparison condition");
-    return RC::INVALID_ARGUMENT;
-  }
-  
-  auto* comp_expr = dynamic_cast<ComparisonExpr*>(condition_.get());
-  if (comp_expr == nullptr || comp_expr->comp() != EQUAL_TO) {
-    LOG_WARN("Hash join requires an equality comparison");
-    return RC::INVALID_ARGUMENT;
-  }
-  
-  // 字段表达式
-  Expression* left_side = comp_expr->left().get();
-  Expression* right_side = comp_expr->right().get();
-  
-  if (left_side->type() != ExprType::FIELD || right_side->type() != ExprType::FIELD) {
-    LOG_WARN("Hash join requires field expressions on both sides");
-    return RC::INVALID_ARGUMENT;
-  }
-  
-  auto* left_field = dynamic_cast<FieldExpr*>(left_side);
-  auto* right_field = dynamic_cast<FieldExpr*>(right_side);
-  
-
-  left_table_name_ = left_field->table_name();
-  right_table_name_ = right_field->table_name();
-  left_key_field_ = left_field->field_name();
-  right_key_field_ = right_field->field_name();
-  
-  return RC::SUCCESS;
+  const int memory_size = common::the_process_param()->join_memory_size();
+  return memory_size > 0 ? static_cast<size_t>(memory_size) : DEFAULT_MEMORY_LIMIT;
 }
 
-// 从元组中获取字段值
-RC JoinPhysicalOperator::get_value_from_tuple(Tuple* tuple, const std::string& table_name, const std::string& field_name, Value& value)
+// 连接键的哈希值，不同层使用不同的种子，这样重新分区时同一个分区的数据可以分散开
+int JoinPhysicalOperator::partition_of(const std::string &key, int level)
 {
-  TupleCellSpec spec(table_name.c_str(), field_name.c_str());
-  // 查找字段
-  RC rc = tuple->find_cell(spec, value);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("Field %s.%s not found in tuple", table_name.c_str(), field_name.c_str());
+  uint64_t h = std::hash<std::string>()(key) + 0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(level + 1);
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+  return static_cast<int>(h % PARTITION_NUM);
+}
+
+void JoinPhysicalOperator::add_row(HashTable &table, std::string &&row)
+{
+  table.memory += row.size() + sizeof(std::string);
+  table.rows.emplace_back(std::move(row));
+}
+
+void JoinPhysicalOperator::build_index(HashTable &table)
+{
+  for (size_t i = 0; i < table.rows.size(); i++) {
+    const std::string &row = table.rows[i];
+    int32_t key_len;
+    memcpy(&key_len, row.data(), sizeof(key_len));
+    table.index[row.substr(sizeof(key_len), key_len)].push_back(i);
   }
-  return rc;
 }
 
-// 构建哈希表
-RC JoinPhysicalOperator::build_hash_table()
+// 返回false表示这个等值条件不能按照连接键的字节做比较，整个连接要退回到嵌套循环
+bool JoinPhysicalOperator::add_join_key(Expression *left, Expression *right)
 {
-  if (hash_table_built_) {
-    return RC::SUCCESS;
+  if (left->type() != ExprType::FIELD || right->type() != ExprType::FIELD) {
+    return true;
   }
-  
-  // 提取连接键
-  RC rc = get_join_keys();
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("Failed to extract join keys");
-    return rc;
+  auto *left_field = static_cast<FieldExpr *>(left);
+  auto *right_field = static_cast<FieldExpr *>(right);
+  TupleCellSpec left_spec(left_field->table_name(), left_field->field_name(), left_field->field().table_alias());
+  TupleCellSpec right_spec(right_field->table_name(), right_field->field_name(), right_field->field().table_alias());
+
+  // 条件中的两个字段可能以任意顺序出现，两边都是同一个孩子的字段时不能作为连接键
+  int left_index;
+  int right_index;
+  if (!(left_tuple_->find_cell_index(left_spec, left_index) == RC::SUCCESS &&
+          right_tuple_->find_cell_index(right_spec, right_index) == RC::SUCCESS) &&
+      !(left_tuple_->find_cell_index(right_spec, left_index) == RC::SUCCESS &&
+          right_tuple_->find_cell_index(left_spec, right_index) == RC::SUCCESS)) {
+    return true;
   }
-  
-  PhysicalOperator *left_child = children_[0].get();
-  
-  // 从左表构建哈希表
-  while ((rc = left_child->next()) == RC::SUCCESS) {
-    Tuple* left_tuple = left_child->current_tuple();
-    
-    // 获取连接键值
-    Value key_value;
-    rc = get_value_from_tuple(left_tuple,left_table_name_, left_key_field_, key_value);
+
+  // 浮点数按照 EPSILON 比较相等，类型不同的值比较前会做转换，都与连接键的字节是否相同不一致
+  if (left->value_type() == FLOATS || right->value_type() == FLOATS || left->value_type() != right->value_type()) {
+    return false;
+  }
+  left_key_indexes_.push_back(left_index);
+  right_key_indexes_.push_back(right_index);
+  return true;
+}
+
+void JoinPhysicalOperator::resolve_join_keys()
+{
+  left_key_indexes_.clear();
+  right_key_indexes_.clear();
+  if (condition_ == nullptr) {
+    return;
+  }
+
+  std::vector<Expression *> conditions;
+  if (condition_->type() == ExprType::CONJUNCTION) {
+    auto *conjunction = static_cast<ConjunctionExpr *>(condition_.get());
+    if (conjunction->conjunction_type() == ConjunctionType::AND) {
+      for (auto &child : conjunction->children()) {
+        conditions.push_back(child.get());
+      }
+    }
+  } else {
+    conditions.push_back(condition_.get());
+  }
+
+  for (Expression *expr : conditions) {
+    if (expr->type() != ExprType::COMPARISON) {
+      continue;
+    }
+    auto *comparison = static_cast<ComparisonExpr *>(expr);
+    if (comparison->comp() == EQUAL_TO && !add_join_key(comparison->left().get(), comparison->right().get())) {
+      left_key_indexes_.clear();
+      right_key_indexes_.clear();
+      return;
+    }
+  }
+}
+
+RC JoinPhysicalOperator::make_join_key(
+    const Tuple &tuple, const std::vector<int> &indexes, std::string &key, bool &has_null) const
+{
+  key.clear();
+  has_null = false;
+  Value value;
+  for (int index : indexes) {
+    RC rc = tuple.cell_at(index, value);
     if (rc != RC::SUCCESS) {
-      LOG_WARN("Failed to get join key value from left tuple");
+      LOG_WARN("failed to get join key from tuple. index=%d, rc=%s", index, strrc(rc));
       return rc;
     }
-    
-    // 字符串表示作为哈希表键
-    std::string key_str = key_value.to_string();
-    hash_table_[key_str].push_back(left_tuple);
+    // null 与任何值都不相等，这一行不会有连接结果
+    if (value.is_null()) {
+      has_null = true;
+      return RC::SUCCESS;
+    }
+    append_value_key(value, true, key);
   }
-  
-  // 正常EOF检测
-  if (rc != RC::RECORD_EOF) {
-    LOG_WARN("Error occurred while reading left table: %s", strrc(rc));
+  return RC::SUCCESS;
+}
+
+RC JoinPhysicalOperator::check_condition(bool &matched)
+{
+  matched = true;
+  if (condition_ == nullptr) {
+    return RC::SUCCESS;
+  }
+
+  Value condition_val;
+  RC rc = condition_->get_value(joined_tuple_, condition_val);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("Failed to evaluate join condition. rc=%s", strrc(rc));
     return rc;
   }
-  
-  hash_table_built_ = true;
+  matched = condition_val.get_boolean();
   return RC::SUCCESS;
 }
 
@@ -121,146 +173,415 @@ RC JoinPhysicalOperator::open(Trx *trx)
 
   left_ready_ = false;
   started_ = false;
-  hash_table_built_ = false;
-  has_current_matches_ = false;
-  
-  // 如果启用哈希连接且有连接条件，构建哈希表
-  if (use_hash_join_ && condition_ != nullptr) {
-    rc = build_hash_table();
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("Failed to build hash table. rc=%s", strrc(rc));
-      children_[1]->close();
-      children_[0]->close();
-      return rc;
+
+  // 孩子的元组对象在整个执行过程中不变，哈希连接时把缓存的记录还原到这两个元组中
+  left_tuple_ = children_[0]->current_tuple();
+  right_tuple_ = children_[1]->current_tuple();
+  joined_tuple_.set_left(left_tuple_);
+  joined_tuple_.set_right(right_tuple_);
+
+  left_key_indexes_.clear();
+  right_key_indexes_.clear();
+  if (use_hash_join_) {
+    resolve_join_keys();
+    LOG_TRACE("join operator uses %s join", left_key_indexes_.empty() ? "nested loop" : "hash");
+  }
+
+  built_ = false;
+  probe_child_done_ = false;
+  memory_ = 0;
+  matches_ = nullptr;
+  current_table_ = nullptr;
+  return RC::SUCCESS;
+}
+
+RC JoinPhysicalOperator::spill_largest_partition()
+{
+  Partition *largest = nullptr;
+  for (auto &partition : partitions_) {
+    if (!partition->spilled() && (largest == nullptr || partition->table.memory > largest->table.memory)) {
+      largest = partition.get();
     }
-    
-    // 重置左表
-    children_[0]->close();
-    rc = children_[0]->open(trx);
+  }
+  if (largest == nullptr || largest->table.rows.empty()) {
+    return RC::SUCCESS;
+  }
+
+  largest->build_file = std::make_unique<SpillFile>();
+  RC rc = largest->build_file->open();
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  for (const std::string &row : largest->table.rows) {
+    rc = largest->build_file->write_block(row);
     if (rc != RC::SUCCESS) {
-      LOG_WARN("Failed to reopen left child after building hash table. rc=%s", strrc(rc));
       return rc;
     }
   }
-  
-  
+
+  memory_ -= largest->table.memory;
+  largest->table = HashTable();
   return RC::SUCCESS;
 }
 
-// 计算出接下来需要输出的数据，并将结果set到join_tuple中
-// 如果没有更多数据，返回RC::RECORD_EOF
-RC JoinPhysicalOperator::next()
+// 读取左孩子的所有数据，构建内存中的哈希表，放不下的分区写到临时文件中
+RC JoinPhysicalOperator::build()
 {
-  if (use_hash_join_ && hash_table_built_) {
-    // Hash Join
-    
-    // 如果当前右表元组有更多匹配的左表元组
-    if (has_current_matches_) {
-      ++current_matches_iter_;
-      if (current_matches_iter_ != current_matches_end_) {
-        // 返回下一个匹配
-        joined_tuple_.set_left(*current_matches_iter_);
-        joined_tuple_.set_right(current_right_tuple_);
-        return RC::SUCCESS;
+  partitions_.clear();
+  pending_.clear();
+  current_partition_.reset();
+  for (int i = 0; i < PARTITION_NUM; i++) {
+    partitions_.emplace_back(std::make_unique<Partition>());
+  }
+
+  const size_t limit = memory_limit();
+  std::string key;
+  bool has_null = false;
+  RC rc = RC::SUCCESS;
+  while ((rc = children_[0]->next()) == RC::SUCCESS) {
+    rc = make_join_key(*left_tuple_, left_key_indexes_, key, has_null);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    if (has_null) {
+      continue;
+    }
+
+    const int32_t key_len = static_cast<int32_t>(key.size());
+    std::string row(reinterpret_cast<const char *>(&key_len), sizeof(key_len));
+    row.append(key);
+    append_tuple_records(*left_tuple_, row);
+
+    Partition &partition = *partitions_[partition_of(key, 0)];
+    if (partition.spilled()) {
+      rc = partition.build_file->write_block(row);
+      if (rc != RC::SUCCESS) {
+        return rc;
       }
-      has_current_matches_ = false;
-    }
-    
-    // 获取下一个右表元组
-    PhysicalOperator *right_child = children_[1].get();
-    RC rc;
-    
-    while ((rc = right_child->next()) == RC::SUCCESS) {
-      current_right_tuple_ = right_child->current_tuple();
-      
-      // 右键值
-      Value key_value;
-      rc = get_value_from_tuple(current_right_tuple_, right_table_name_, right_key_field_, key_value);
+      continue;
+    }
+
+    const size_t old_memory = partition.table.memory;
+    add_row(partition.table, std::move(row));
+    memory_ += partition.table.memory - old_memory;
+    while (memory_ > limit) {
+      const size_t old_total = memory_;
+      rc = spill_largest_partition();
       if (rc != RC::SUCCESS) {
-        LOG_WARN("Failed to get join key value from right tuple");
         return rc;
       }
-      
-      // 查找
-      std::string key_str = key_value.to_string();
-      auto it = hash_table_.find(key_str);
-      
-      if (it != hash_table_.end() && !it->second.empty()) {
-        // 找到匹配
-        current_matches_iter_ = it->second.begin();
-        current_matches_end_ = it->second.end();
-        has_current_matches_ = true;
-        
-        // 返回第一个匹配
-        joined_tuple_.set_left(*current_matches_iter_);
-        joined_tuple_.set_right(current_right_tuple_);
+      if (memory_ == old_total) {
+        break;
+      }
+    }
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to read left child of join operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  for (auto &partition : partitions_) {
+    if (!partition->spilled()) {
+      build_index(partition->table);
+    }
+  }
+  built_ = true;
+  return RC::SUCCESS;
+}
+
+// 读取右孩子的下一行并在内存分区中查找，属于溢出分区的行先写到临时文件中
+RC JoinPhysicalOperator::next_probe_row()
+{
+  std::string key;
+  bool has_null = false;
+  RC rc = RC::SUCCESS;
+  while ((rc = children_[1]->next()) == RC::SUCCESS) {
+    rc = make_join_key(*right_tuple_, right_key_indexes_, key, has_null);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    if (has_null) {
+      continue;
+    }
+
+    Partition &partition = *partitions_[partition_of(key, 0)];
+    if (!partition.spilled()) {
+      auto iter = partition.table.index.find(key);
+      if (iter != partition.table.index.end()) {
+        current_table_ = &partition.table;
+        matches_ = &iter->second;
+        match_pos_ = 0;
         return RC::SUCCESS;
       }
-    }    
-  }
-  else {
-    // Nested Loop Join
-    PhysicalOperator *left_child = children_[0].get();
-    PhysicalOperator *right_child = children_[1].get();
-    if (!started_) {
-      started_ = true;
-      // 先从左表中取出第一个tuple
-      RC rc = left_child->next();
+      continue;
+    }
+
+    if (partition.probe_file == nullptr) {
+      partition.probe_file = std::make_unique<SpillFile>();
+      rc = partition.probe_file->open();
       if (rc != RC::SUCCESS) {
-        LOG_TRACE("No tuples in left child of join operator. rc=%s", strrc(rc));
         return rc;
       }
-      left_ready_ = true;
     }
-    if (!left_ready_) {
-      return RC::RECORD_EOF;
+    const int32_t key_len = static_cast<int32_t>(key.size());
+    probe_row_.assign(reinterpret_cast<const char *>(&key_len), sizeof(key_len));
+    probe_row_.append(key);
+    append_tuple_records(*right_tuple_, probe_row_);
+    rc = partition.probe_file->write_block(probe_row_);
+    if (rc != RC::SUCCESS) {
+      return rc;
     }
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to read right child of join operator. rc=%s", strrc(rc));
+    return rc;
+  }
 
-    while (left_ready_) {
-      // 先从右表中取出第一个tuple
-      RC rc = right_child->next();
-      if (rc == RC::SUCCESS) {
-        // 右表中有数据
-        joined_tuple_.set_left(left_child->current_tuple());
-        joined_tuple_.set_right(right_child->current_tuple());
+  // 内存中的分区已经处理完，只保留没有探测数据的分区之外的溢出分区
+  probe_child_done_ = true;
+  current_table_ = nullptr;
+  for (auto &partition : partitions_) {
+    if (partition->spilled() && partition->probe_file != nullptr) {
+      pending_.emplace_back(std::move(partition));
+    }
+  }
+  partitions_.clear();
+  memory_ = 0;
+  return RC::RECORD_EOF;
+}
 
-        // 没有连接条件
-        if (condition_ == nullptr) {
-          return RC::SUCCESS;
-        }
+RC JoinPhysicalOperator::repartition(Partition &partition)
+{
+  std::vector<std::unique_ptr<Partition>> children;
+  for (int i = 0; i < PARTITION_NUM; i++) {
+    children.emplace_back(std::make_unique<Partition>());
+    children.back()->level = partition.level + 1;
+  }
 
-        // 有连接条件
-        Value condition_val;
-        rc = condition_->get_value(joined_tuple_,condition_val);
+  // 同一个文件中的数据依次写到下一层的分区中，先构建侧再探测侧
+  auto split = [&children](SpillFile &file, bool build_side) {
+    RC rc = file.rewind();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    std::string row;
+    bool eof = false;
+    while ((rc = file.read_block(row, eof)) == RC::SUCCESS && !eof) {
+      int32_t key_len;
+      memcpy(&key_len, row.data(), sizeof(key_len));
+      Partition &child = *children[partition_of(row.substr(sizeof(key_len), key_len), children[0]->level)];
+      std::unique_ptr<SpillFile> &target = build_side ? child.build_file : child.probe_file;
+      if (target == nullptr) {
+        target = std::make_unique<SpillFile>();
+        rc = target->open();
         if (rc != RC::SUCCESS) {
-          LOG_WARN("Failed to evaluate join condition. rc=%s", strrc(rc));
           return rc;
         }
-        if(condition_val.get_boolean()){
-          //满足，返回结果
+      }
+      rc = target->write_block(row);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+    return rc;
+  };
+
+  RC rc = split(*partition.build_file, true);
+  if (rc == RC::SUCCESS) {
+    rc = split(*partition.probe_file, false);
+  }
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to repartition spilled partition of join operator. level=%d, rc=%s", partition.level, strrc(rc));
+    return rc;
+  }
+
+  for (auto &child : children) {
+    if (child->build_file != nullptr && child->probe_file != nullptr) {
+      pending_.emplace_back(std::move(child));
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC JoinPhysicalOperator::process_partition(std::unique_ptr<Partition> partition)
+{
+  if (partition->build_file->size() > memory_limit() && partition->level < MAX_PARTITION_LEVEL) {
+    return repartition(*partition);
+  }
+
+  RC rc = partition->build_file->rewind();
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  std::string row;
+  bool eof = false;
+  while ((rc = partition->build_file->read_block(row, eof)) == RC::SUCCESS && !eof) {
+    add_row(partition->table, std::move(row));
+  }
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  build_index(partition->table);
+  partition->build_file.reset();
+
+  rc = partition->probe_file->rewind();
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  current_partition_ = std::move(partition);
+  current_table_ = &current_partition_->table;
+  return RC::SUCCESS;
+}
+
+// 逐个处理溢出的分区，从临时文件中读取探测行并还原到右孩子的元组中
+RC JoinPhysicalOperator::next_spilled_probe_row()
+{
+  RC rc = RC::SUCCESS;
+  while (true) {
+    if (current_partition_ != nullptr) {
+      bool eof = false;
+      rc = current_partition_->probe_file->read_block(probe_row_, eof);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      if (!eof) {
+        int32_t key_len;
+        memcpy(&key_len, probe_row_.data(), sizeof(key_len));
+        auto iter = current_table_->index.find(probe_row_.substr(sizeof(key_len), key_len));
+        if (iter != current_table_->index.end()) {
+          const int offset = sizeof(key_len) + key_len;
+          right_records_.restore(probe_row_.data() + offset, static_cast<int>(probe_row_.size()) - offset, *right_tuple_);
+          matches_ = &iter->second;
+          match_pos_ = 0;
           return RC::SUCCESS;
         }
         continue;
       }
-      // 右表中没有数据，从左表中取出下一个tuple
-      rc= left_child->next();
-      if(rc!= RC::SUCCESS){
-        // 左表中也没有数据
-        left_ready_ = false;
+      current_table_ = nullptr;
+      current_partition_.reset();
+    }
+
+    if (pending_.empty()) {
+      return RC::RECORD_EOF;
+    }
+    std::unique_ptr<Partition> partition = std::move(pending_.back());
+    pending_.pop_back();
+    rc = process_partition(std::move(partition));
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+}
+
+RC JoinPhysicalOperator::hash_join_next()
+{
+  RC rc = RC::SUCCESS;
+  if (!built_) {
+    rc = build();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
+  while (true) {
+    while (matches_ != nullptr && match_pos_ < matches_->size()) {
+      const std::string &row = current_table_->rows[(*matches_)[match_pos_++]];
+      int32_t key_len;
+      memcpy(&key_len, row.data(), sizeof(key_len));
+      const int offset = sizeof(key_len) + key_len;
+      left_records_.restore(row.data() + offset, static_cast<int>(row.size()) - offset, *left_tuple_);
+
+      bool matched = false;
+      rc = check_condition(matched);
+      if (rc != RC::SUCCESS) {
         return rc;
       }
-      // 左表中有数据，重置右表
-      rc = right_child->close();
-      rc = right_child->open(trx_);
+      if (matched) {
+        return RC::SUCCESS;
+      }
+    }
+    matches_ = nullptr;
+
+    if (!probe_child_done_) {
+      rc = next_probe_row();
+      // 右孩子读完以后接着处理溢出的分区
+      if (rc == RC::RECORD_EOF) {
+        continue;
+      }
+    } else {
+      rc = next_spilled_probe_row();
+    }
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+}
+
+RC JoinPhysicalOperator::nested_loop_next()
+{
+  PhysicalOperator *left_child = children_[0].get();
+  PhysicalOperator *right_child = children_[1].get();
+  if (!started_) {
+    started_ = true;
+    // 先从左表中取出第一个tuple
+    RC rc = left_child->next();
+    if (rc != RC::SUCCESS) {
+      LOG_TRACE("No tuples in left child of join operator. rc=%s", strrc(rc));
+      return rc;
+    }
+    left_ready_ = true;
+  }
+  if (!left_ready_) {
+    return RC::RECORD_EOF;
+  }
+
+  while (left_ready_) {
+    // 先从右表中取出第一个tuple
+    RC rc = right_child->next();
+    if (rc == RC::SUCCESS) {
+      // 右表中有数据
+      joined_tuple_.set_left(left_child->current_tuple());
+      joined_tuple_.set_right(right_child->current_tuple());
+
+      bool matched = false;
+      rc = check_condition(matched);
       if (rc != RC::SUCCESS) {
-        LOG_WARN("Failed to open right child of join operator. rc=%s", strrc(rc));
         return rc;
-      }  
+      }
+      if (matched) {
+        //满足，返回结果
+        return RC::SUCCESS;
+      }
+      continue;
+    }
+    // 右表中没有数据，从左表中取出下一个tuple
+    rc = left_child->next();
+    if (rc != RC::SUCCESS) {
+      // 左表中也没有数据
+      left_ready_ = false;
+      return rc;
+    }
+    // 左表中有数据，重置右表
+    rc = right_child->close();
+    rc = right_child->open(trx_);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("Failed to open right child of join operator. rc=%s", strrc(rc));
+      return rc;
     }
   }
   return RC::RECORD_EOF;
 }
 
+// 计算出接下来需要输出的数据，并将结果set到join_tuple中
+// 如果没有更多数据，返回RC::RECORD_EOF
+RC JoinPhysicalOperator::next()
+{
+  if (!left_key_indexes_.empty()) {
+    return hash_join_next();
+  }
+  return nested_loop_next();
+}
+
 // 节点执行完成，清理左右子算子
 RC JoinPhysicalOperator::close()
 {
@@ -280,13 +601,14 @@ RC JoinPhysicalOperator::close()
       rc = rc_left;
     }
   }
-  // if (condition_ != nullptr) {
-  //   condition_.reset();
-  // }
-  // 清理哈希表
-  hash_table_.clear();
-  hash_table_built_ = false;
-  has_current_matches_ = false;
+  // 清理哈希表和临时文件
+  partitions_.clear();
+  pending_.clear();
+  current_partition_.reset();
+  current_table_ = nullptr;
+  matches_ = nullptr;
+  built_ = false;
+  memory_ = 0;
   return rc;
 }
 
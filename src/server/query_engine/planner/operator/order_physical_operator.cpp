@@ -3,11 +3,20 @@
 #include "include/storage_engine/recorder/record.h"
 #include "include/query_engine/analyzer/statement/filter_stmt.h"
 #include "include/storage_engine/recorder/field.h"
+#include "include/query_engine/structor/tuple/tuple_codec.h"
+#include "common/os/process_param.h"
 #include <algorithm>
 
-OrderPhysicalOperator::OrderPhysicalOperator(std::vector<OrderByUnit *> order_units) : order_units_(std::move(order_units))
+OrderPhysicalOperator::OrderPhysicalOperator(std::vector<OrderByUnit *> order_units, int64_t limit)
+    : order_units_(std::move(order_units)), limit_(limit)
 {}
 
+size_t OrderPhysicalOperator::memory_limit()
+{
+  const int memory_size = common::the_process_param()->sort_memory_size();
+  return memory_size > 0 ? static_cast<size_t>(memory_size) : ExternalSorter::DEFAULT_MEMORY_LIMIT;
+}
+
 RC OrderPhysicalOperator::open(Trx *trx)
 {
   if (children_.size() != 1) {
@@ -29,16 +38,20 @@ RC OrderPhysicalOperator::next()
     }
   }
 
-  if (it_ != st_idx_.end()) {
-    children_[0]->current_tuple()->set_record(st_[*it_]);
-    it_ ++;
-    return RC::SUCCESS;
+  const char *payload = nullptr;
+  int payload_len = 0;
+  rc = sorter_->next(payload, payload_len);
+  if (rc != RC::SUCCESS) {
+    return rc;
   }
-  return RC::RECORD_EOF;
+
+  restored_records_.restore(payload, payload_len, *children_[0]->current_tuple());
+  return RC::SUCCESS;
 }
 
 RC OrderPhysicalOperator::close()
 {
+  sorter_.reset();
   children_[0]->close();
   return RC::SUCCESS;
 }
@@ -48,67 +61,54 @@ Tuple *OrderPhysicalOperator::current_tuple()
   return children_[0]->current_tuple();
 }
 
-RC OrderPhysicalOperator::sort_table() {
-  RC rc = RC::SUCCESS;
+RC OrderPhysicalOperator::make_sort_key(Tuple &tuple, std::string &key)
+{
+  key.clear();
+  for (const OrderByUnit *unit : order_units_) {
+    Value value;
+    RC rc = unit->expr()->get_value(tuple, value);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to get value of order by expression. rc=%s", strrc(rc));
+      return rc;
+    }
+    append_value_key(value, unit->sort_type(), key);
+  }
+  return RC::SUCCESS;
+}
 
-  std::vector<std::pair<std::vector<Value>, int>> tuple_table;
-  std::vector<Value> tuple_values;
+RC OrderPhysicalOperator::sort_table()
+{
+  RC rc = RC::SUCCESS;
+  sorter_.reset(new ExternalSorter(memory_limit(), limit_));
 
-  int index = 0;
+  std::string key;
+  std::string payload;
   while (RC::SUCCESS == (rc = children_[0]->next())) {
-    tuple_values.clear();
-    for (const OrderByUnit *unit : order_units_) {
-      Expression *expr = unit->expr();
-      Value value;
-      expr->get_value(*children_[0]->current_tuple(), value);
-      tuple_values.emplace_back(value);
+    Tuple *tuple = children_[0]->current_tuple();
+    rc = make_sort_key(*tuple, key);
+    if (rc != RC::SUCCESS) {
+      return rc;
     }
-    tuple_table.emplace_back(tuple_values, index ++);
-    std::vector<Record *> records;
-    children_[0]->current_tuple()->get_record(records);
-    for (auto &rcd_ptr : records) {
-      rcd_ptr = new Record(*rcd_ptr);
+
+    payload.clear();
+    append_tuple_records(*tuple, payload);
+
+    rc = sorter_->add(key, payload);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to add row to sorter. rc=%s", strrc(rc));
+      return rc;
     }
-    st_.emplace_back(records);
   }
   if (RC::RECORD_EOF != rc) {
     LOG_ERROR("Fetch Table Error In SortOperator. RC: %d", rc);
     return rc;
   }
 
-  bool is_asc[order_units_.size()];
-  for (int i = 0; i < order_units_.size(); ++i) {
-    is_asc[i] = order_units_[i]->sort_type();
-  }
-
-  auto cmp = [&is_asc](const std::pair<std::vector<Value>, int> &a, const std::pair<std::vector<Value>, int> &b) {
-    auto &cells_a = a.first;
-    auto &cells_b = b.first;
-    assert(cells_a.size() == cells_b.size());
-    for (int i = 0; i < cells_a.size(); i ++) {
-      auto &cell_a = cells_a[i];
-      auto &cell_b = cells_b[i];
-      if (cell_a.is_null() && cell_b.is_null()) {
-        continue;
-      }
-      if (cell_a.is_null()) {
-        return is_asc[i];
-      }
-      if (cell_b.is_null()) {
-        return !is_asc[i];
-      }
-      int cmp = cell_a.compare(cell_b);
-      if (cmp != 0) {
-        return is_asc[i] ? cmp < 0: cmp > 0;
-      }
-    }
-    return false;  // completely same
-  };
-  std::sort(tuple_table.begin(), tuple_table.end(), cmp);
-
-  for (auto & i : tuple_table) {
-    st_idx_.emplace_back(i.second);
+  rc = sorter_->finish();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to finish sorting. rc=%s", strrc(rc));
+    return rc;
   }
-  it_ = st_idx_.begin();
+  LOG_TRACE("sort finished. runs=%d", sorter_->run_num());
   return RC::SUCCESS;
 }
@@ -7,6 +7,8 @@ std::string physical_operator_type_name(PhysicalOperatorType type)
       return "TABLE_SCAN";
     case PhysicalOperatorType::INDEX_SCAN:
       return "INDEX_SCAN";
+    case PhysicalOperatorType::INDEX_ONLY_SCAN:
+      return "INDEX_ONLY_SCAN";
     case PhysicalOperatorType::JOIN:
       return "JOIN";
     case PhysicalOperatorType::EXPLAIN:
@@ -27,6 +29,8 @@ std::string physical_operator_type_name(PhysicalOperatorType type)
       return "GROUP_BY";
     case PhysicalOperatorType::ORDER_BY:
       return "ORDER_BY";
+    case PhysicalOperatorType::GATHER:
+      return "GATHER";
     default:
       return "UNKNOWN";
   }
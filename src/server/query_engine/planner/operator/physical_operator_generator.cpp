@@ -26,8 +26,10 @@
 #include "include/query_engine/planner/operator/join_physical_operator.h"
 #include "include/query_engine/planner/node/group_by_logical_node.h"
 #include "include/query_engine/planner/operator/group_by_physical_operator.h"
+#include "include/query_engine/planner/operator/gather_physical_operator.h"
 
 #include "include/query_engine/planner/operator/index_scan_physical_operator.h"
+#include "include/query_engine/planner/operator/index_only_scan_physical_operator.h"
 
 
 #include "include/query_engine/structor/expression/comparison_expression.h"
@@ -82,7 +84,7 @@ RC PhysicalOperatorGenerator::create(LogicalNode &logical_operator, unique_ptr<P
       return create_plan(static_cast<JoinLogicalNode &>(logical_operator), oper);
     }
     case LogicalNodeType::GROUP_BY: {
-      return RC::UNIMPLENMENT;
+      return create_plan(static_cast<GroupByLogicalNode &>(logical_operator), oper);
     }
 
     default: {
@@ -194,12 +196,40 @@ RC PhysicalOperatorGenerator::create_plan(
   //   }
   // }
 
+  // 只读的查询用到的字段都在索引中时，只扫描索引，不读取数据页面
+  bool index_only = false;
+  if (index != nullptr && table_get_oper.readonly() && !is_delete) {
+    index_only = true;
+    for (const Field &field : table_get_oper.fields()) {
+      if (0 == strcmp(field.field_name(), "*")) {
+        continue;  // count(*)
+      }
+      bool covered = false;
+      for (int i = 0; i < best_fit_index_meta->field_amount(); i++) {
+        if (0 == strcmp(field.field_name(), best_fit_index_meta->field(i))) {
+          covered = true;
+          break;
+        }
+      }
+      if (!covered) {
+        index_only = false;
+        break;
+      }
+    }
+  }
+
   if(index == nullptr){
     auto table_scan_oper = new TableScanPhysicalOperator(table, table_get_oper.table_alias(), table_get_oper.readonly());
     table_scan_oper->isdelete_ = is_delete;
     table_scan_oper->set_predicates(std::move(predicates));
     oper = unique_ptr<PhysicalOperator>(table_scan_oper);
     LOG_TRACE("use table scan");
+  } else if (index_only) {
+    auto index_only_scan_oper = new IndexOnlyScanPhysicalOperator(table, index, &values, true, &values, true);
+    index_only_scan_oper->set_table_alias(table_get_oper.table_alias());
+    index_only_scan_oper->set_predicates(std::move(predicates));
+    oper = unique_ptr<PhysicalOperator>(index_only_scan_oper);
+    LOG_TRACE("use index only scan on table %s", table->name());
   }else{
     // TODO [Lab2] 生成IndexScanOperator, 并放置在算子树上，下面是一个实现参考，具体实现可以根据需要进行修改
     // IndexScanner 在设计时，考虑了范围查找索引的情况，但此处我们只需要考虑单个键的情况
@@ -238,6 +268,12 @@ RC PhysicalOperatorGenerator::create_plan(
 
   unique_ptr<Expression> expression = std::move(expressions.front());
 
+  // 条件都下推到表扫描以后只剩下恒为真的表达式，不需要过滤，上层算子可以直接看到表扫描
+  if (expression->type() == ExprType::VALUE && static_cast<ValueExpr *>(expression.get())->get_value().get_boolean()) {
+    oper = std::move(child_phy_oper);
+    return rc;
+  }
+
   oper = unique_ptr<PhysicalOperator>(new PredicatePhysicalOperator(std::move(expression)));
   oper->add_child(std::move(child_phy_oper));
   oper->isdelete_ = is_delete;
@@ -260,6 +296,17 @@ RC PhysicalOperatorGenerator::create_plan(AggrLogicalNode &aggr_oper, unique_ptr
     }
   }
 
+  // 表比较大时多个线程并行扫描，各自做部分聚合
+  if (child_phy_oper && child_phy_oper->type() == PhysicalOperatorType::TABLE_SCAN) {
+    auto *scan_oper = static_cast<TableScanPhysicalOperator *>(child_phy_oper.get());
+    const int worker_num = GatherPhysicalOperator::worker_num_of(*scan_oper);
+    if (worker_num > 1) {
+      child_phy_oper.release();
+      child_phy_oper = make_unique<GatherPhysicalOperator>(unique_ptr<TableScanPhysicalOperator>(scan_oper), worker_num);
+      LOG_TRACE("scan table %s with %d threads", scan_oper->table()->name(), worker_num);
+    }
+  }
+
   auto *aggr_operator = new AggrPhysicalOperator(&aggr_oper);
 
   if (child_phy_oper) {
@@ -272,6 +319,28 @@ RC PhysicalOperatorGenerator::create_plan(AggrLogicalNode &aggr_oper, unique_ptr
   return rc;
 }
 
+RC PhysicalOperatorGenerator::create_plan(GroupByLogicalNode &group_by_oper, unique_ptr<PhysicalOperator> &oper)
+{
+  vector<unique_ptr<LogicalNode>> &child_opers = group_by_oper.children();
+  if (child_opers.size() != 1) {
+    LOG_WARN("group by operator should have 1 child, but have %d", static_cast<int>(child_opers.size()));
+    return RC::INTERNAL;
+  }
+
+  unique_ptr<PhysicalOperator> child_phy_oper;
+  RC rc = create(*child_opers.front(), child_phy_oper);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to create group by logical operator's child physical operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  oper = unique_ptr<PhysicalOperator>(new GroupByPhysicalOperator(&group_by_oper));
+  oper->add_child(std::move(child_phy_oper));
+
+  LOG_TRACE("create a group by physical operator");
+  return rc;
+}
+
 RC PhysicalOperatorGenerator::create_plan(OrderByLogicalNode &order_oper, unique_ptr<PhysicalOperator> &oper)
 {
   vector<unique_ptr<LogicalNode>> &child_opers = order_oper.children();
@@ -288,7 +357,7 @@ RC PhysicalOperatorGenerator::create_plan(OrderByLogicalNode &order_oper, unique
     }
   }
 
-  OrderPhysicalOperator* order_operator = new OrderPhysicalOperator(std::move(order_oper.order_units()));
+  OrderPhysicalOperator* order_operator = new OrderPhysicalOperator(std::move(order_oper.order_units()), order_oper.limit());
 
   if (child_phy_oper) {
     order_operator->add_child(std::move(child_phy_oper));
@@ -443,18 +512,11 @@ RC PhysicalOperatorGenerator::create_plan(
 
   auto *join_operator = new JoinPhysicalOperator();
 
-  join_operator->set_condition(std::move(join_oper.condition()));
-
-  // 等值连接时启用哈希连接
+  // 有连接条件时尝试使用哈希连接，算子在 open 时找不到等值连接的字段会退回到嵌套循环连接
   if (join_oper.condition() != nullptr) {
-    if (join_oper.condition()->type() == ExprType::COMPARISON) {
-      auto *comp_expr = dynamic_cast<ComparisonExpr*>(join_oper.condition().get());
-      if (comp_expr != nullptr && comp_expr->comp() == EQUAL_TO) {
-        join_operator->enable_hash_join();
-        LOG_TRACE("Hash join enabled for equi-join operation");
-      }
-    }
+    join_operator->enable_hash_join();
   }
+  join_operator->set_condition(std::move(join_oper.condition()));
 
   join_operator->add_child(std::move(left_oper));
   join_operator->add_child(std::move(right_oper));
@@ -4,6 +4,7 @@
 #include "include/query_engine/structor/expression/conjunction_expression.h"
 #include "include/query_engine/structor/expression/comparison_expression.h"
 #include "include/query_engine/structor/tuple/join_tuple.h"
+#include "include/query_engine/structor/chunk.h"
 
 PredicatePhysicalOperator::PredicatePhysicalOperator(std::unique_ptr<Expression> expr) : expression_(std::move(expr))
 {
@@ -65,6 +66,22 @@ RC PredicatePhysicalOperator::next()
   return rc;
 }
 
+RC PredicatePhysicalOperator::next_batch(Chunk &chunk)
+{
+  RC rc;
+  PhysicalOperator *oper = children_.front().get();
+  while (RC::SUCCESS == (rc = oper->next_batch(chunk))) {
+    rc = expression_->filter(chunk);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    if (chunk.select_num() > 0) {
+      return rc;
+    }
+  }
+  return rc;
+}
+
 RC PredicatePhysicalOperator::close()
 {
   children_[0]->close();
@@ -2,6 +2,7 @@
 #include "include/query_engine/planner/operator/project_physical_operator.h"
 #include "include/storage_engine/recorder/record.h"
 #include "include/storage_engine/recorder/table.h"
+#include "include/query_engine/structor/tuple/chunk_tuple.h"
 
 RC ProjectPhysicalOperator::open(Trx *trx)
 {
@@ -41,6 +42,87 @@ Tuple *ProjectPhysicalOperator::current_tuple()
   return &tuple_;
 }
 
+bool ProjectPhysicalOperator::support_batch() const
+{
+  if (children_.empty() || !children_[0]->support_batch()) {
+    return false;
+  }
+  for (const TupleCellSpec *spec : tuple_.get_species()) {
+    const Expression *expr = spec->expression();
+    if (expr->type() == ExprType::FIELD) {
+      continue;
+    }
+    const AttrType value_type = expr->value_type();
+    if (value_type != INTS && value_type != FLOATS && value_type != DATES) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC ProjectPhysicalOperator::next_batch(Chunk &chunk)
+{
+  if (children_.empty()) {
+    return RC::RECORD_EOF;
+  }
+  RC rc = children_[0]->next_batch(child_chunk_);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  const std::vector<TupleCellSpec *> species = tuple_.get_species();
+  if (chunk.column_num() == 0) {
+    field_columns_.clear();
+    for (const TupleCellSpec *spec : species) {
+      const Expression *expr = spec->expression();
+      int index = -1;
+      if (expr->type() == ExprType::FIELD) {
+        const auto *field_expr = static_cast<const FieldExpr *>(expr);
+        index = child_chunk_.find_column(field_expr->table_name(), field_expr->field_name(), field_expr->field().table_alias());
+        if (index < 0) {
+          LOG_WARN("failed to find column of field. field=%s.%s", field_expr->table_name(), field_expr->field_name());
+          return RC::NOTFOUND;
+        }
+        const Column &child_column = child_chunk_.column(index);
+        Column &column = chunk.add_column(child_column.attr_type(), child_column.attr_len());
+        column.set_name(field_expr->table_name(), field_expr->field_name(), field_expr->field().table_alias());
+      } else {
+        Column &column = chunk.add_column(expr->value_type(), sizeof(int32_t));
+        column.set_name("", expr->name().c_str(), "");
+      }
+      field_columns_.push_back(index);
+    }
+  }
+
+  chunk.reset();
+  ChunkTuple child_tuple;
+  child_tuple.set_chunk(&child_chunk_);
+  Value value;
+  for (size_t i = 0; i < species.size(); i++) {
+    Column &column = chunk.column(i);
+    if (field_columns_[i] >= 0) {
+      const Column &child_column = child_chunk_.column(field_columns_[i]);
+      for (int row : child_chunk_.selection()) {
+        column.append_from(child_column, row);
+      }
+      continue;
+    }
+
+    const Expression *expr = species[i]->expression();
+    for (int row : child_chunk_.selection()) {
+      child_tuple.set_row(row);
+      rc = expr->get_value(child_tuple, value);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to get value of expression. rc=%s", strrc(rc));
+        return rc;
+      }
+      column.append_value(value);
+    }
+  }
+  chunk.select_all();
+  return RC::SUCCESS;
+}
+
 void ProjectPhysicalOperator::add_projector(const Expression *expr) {
   auto *spec = new TupleCellSpec(expr);
   tuple_.add_cell_spec(spec);
@@ -1,11 +1,19 @@
 #include "include/query_engine/planner/operator/table_scan_physical_operator.h"
 #include "include/storage_engine/recorder/table.h"
+#include "include/query_engine/structor/chunk.h"
+#include "include/query_engine/structor/expression/comparison_expression.h"
+#include "include/query_engine/structor/expression/field_expression.h"
+#include "include/query_engine/structor/expression/value_expression.h"
+#include "include/storage_engine/recorder/compare_kernel.h"
+#include "include/storage_engine/transaction/trx.h"
 
 using namespace std;
 
 RC TableScanPhysicalOperator::open(Trx *trx)
 {
-  RC rc = table_->get_record_scanner(record_scanner_, trx, readonly_);
+  init_condition_filter();
+  RC rc = table_->get_record_scanner(record_scanner_, trx, readonly_, page_ranges_,
+                                     page_filters_.empty() ? nullptr : &condition_filter_);
   if (rc == RC::SUCCESS) {
     tuple_.set_schema(table_, table_alias_, table_->table_meta().field_metas());
   }
@@ -42,6 +50,59 @@ RC TableScanPhysicalOperator::next()
   return rc;
 }
 
+bool TableScanPhysicalOperator::support_batch() const
+{
+  // 变长记录的文本不在记录中固定的位置上，不能按列批量复制
+  return !table_->table_meta().variable_length();
+}
+
+RC TableScanPhysicalOperator::next_batch(Chunk &chunk)
+{
+  const std::vector<FieldMeta> *field_metas = table_->table_meta().field_metas();
+  if (chunk.column_num() == 0) {
+    for (const FieldMeta &field_meta : *field_metas) {
+      Column &column = chunk.add_column(field_meta.type(), field_meta.len());
+      column.set_name(table_->name(), field_meta.name(), table_alias_.c_str());
+    }
+  }
+
+  RC rc = RC::SUCCESS;
+  while (record_scanner_.has_next()) {
+    chunk.reset();
+    while (!chunk.full() && record_scanner_.has_next()) {
+      rc = record_scanner_.next(current_record_);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      append_record(chunk);
+    }
+
+    chunk.select_all();
+    for (Expression *expr : residual_predicates_) {
+      rc = expr->filter(chunk);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+    if (chunk.select_num() > 0) {
+      return RC::SUCCESS;
+    }
+  }
+  return RC::RECORD_EOF;
+}
+
+void TableScanPhysicalOperator::append_record(Chunk &chunk)
+{
+  const std::vector<FieldMeta> *field_metas = table_->table_meta().field_metas();
+  // 与 RowTuple 相同，最后一个字段是记录各个字段是否为null的位图
+  const FieldMeta &null_field_meta = field_metas->back();
+  common::Bitmap null_bitmap(current_record_.data() + null_field_meta.offset(), null_field_meta.len());
+  for (size_t i = 0; i < field_metas->size(); i++) {
+    const FieldMeta &field_meta = (*field_metas)[i];
+    chunk.column(i).append(current_record_.data() + field_meta.offset(), null_bitmap.get_bit(i));
+  }
+}
+
 RC TableScanPhysicalOperator::close()
 {
   return record_scanner_.close_scan();
@@ -62,16 +123,95 @@ string TableScanPhysicalOperator::param() const
   return table_->name();
 }
 
+RC TableScanPhysicalOperator::count_records(int64_t &count)
+{
+  if (!predicates_.empty() || (trx_ != nullptr && trx_->type() != TrxType::VACUOUS)) {
+    return RC::UNIMPLENMENT;
+  }
+  return table_->count_records(count);
+}
+
 void TableScanPhysicalOperator::set_predicates(vector<unique_ptr<Expression>> &&exprs)
 {
   predicates_ = std::move(exprs);
 }
 
+unique_ptr<TableScanPhysicalOperator> TableScanPhysicalOperator::copy() const
+{
+  auto oper = make_unique<TableScanPhysicalOperator>(table_, table_alias_, readonly_);
+  oper->isdelete_ = isdelete_;
+  for (const unique_ptr<Expression> &expr : predicates_) {
+    oper->predicates_.emplace_back(expr->copy());
+  }
+  return oper;
+}
+
+void TableScanPhysicalOperator::init_condition_filter()
+{
+  page_filters_.clear();
+  page_filter_ptrs_.clear();
+  residual_predicates_.clear();
+  for (unique_ptr<Expression> &expr : predicates_) {
+    const FieldExpr *field_expr = nullptr;
+    const ValueExpr *value_expr = nullptr;
+    CompOp comp = NO_OP;
+    bool field_on_left = true;
+    if (expr->type() == ExprType::COMPARISON) {
+      auto *comparison = static_cast<ComparisonExpr *>(expr.get());
+      comp = comparison->comp();
+      Expression *left = comparison->left().get();
+      Expression *right = comparison->right().get();
+      if (left != nullptr && right != nullptr && left->type() == ExprType::FIELD && right->type() == ExprType::VALUE) {
+        field_expr = static_cast<const FieldExpr *>(left);
+        value_expr = static_cast<const ValueExpr *>(right);
+      } else if (left != nullptr && right != nullptr && left->type() == ExprType::VALUE &&
+                 right->type() == ExprType::FIELD) {
+        field_expr = static_cast<const FieldExpr *>(right);
+        value_expr = static_cast<const ValueExpr *>(left);
+        field_on_left = false;
+      }
+    }
+
+    const FieldMeta *field_meta = field_expr == nullptr ? nullptr : field_expr->field().meta();
+    const AttrType attr_type = field_meta == nullptr ? UNDEFINED : field_meta->type();
+    if (field_meta == nullptr || field_expr->field().table() != table_ ||
+        !compare_kernel_supported(comp) || (attr_type != INTS && attr_type != DATES && attr_type != FLOATS) ||
+        value_expr->get_value().is_null() || value_expr->get_value().attr_type() != attr_type) {
+      residual_predicates_.push_back(expr.get());
+      continue;
+    }
+
+    ConDesc attr;
+    attr.is_attr = true;
+    attr.attr_length = field_meta->len();
+    attr.attr_offset = field_meta->offset();
+    if (field_meta->nullable()) {
+      const std::vector<FieldMeta> &field_metas = *table_->table_meta().field_metas();
+      attr.null_bitmap_offset = table_->table_meta().null_bitmap_field()->offset();
+      attr.null_bit = static_cast<int>(field_meta - field_metas.data());
+    }
+    ConDesc value;
+    value.is_attr = false;
+    value.attr_length = 0;
+    value.attr_offset = 0;
+    value.value = value_expr->get_value();
+    auto page_filter = make_unique<DefaultConditionFilter>();
+    RC rc = field_on_left ? page_filter->init(attr, value, attr_type, comp) : page_filter->init(value, attr, attr_type, comp);
+    if (rc != RC::SUCCESS) {
+      residual_predicates_.push_back(expr.get());
+      continue;
+    }
+    page_filter_ptrs_.push_back(page_filter.get());
+    page_filters_.emplace_back(std::move(page_filter));
+  }
+  condition_filter_.init(page_filter_ptrs_.data(), static_cast<int>(page_filter_ptrs_.size()));
+}
+
 RC TableScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
 {
   RC rc = RC::SUCCESS;
   Value value;
-  for (unique_ptr<Expression> &expr : predicates_) {
+  for (Expression *expr : residual_predicates_) {
     rc = expr->get_value(tuple, value);
     if (rc != RC::SUCCESS) {
       return rc;
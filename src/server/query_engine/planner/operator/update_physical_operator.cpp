@@ -48,21 +48,10 @@ RC UpdatePhysicalOperator::open(Trx *trx)
         const AttrType field_type = field_meta->type();
         const AttrType value_type = value.attr_type();
         if (field_type == TEXTS && value_type == CHARS) {
-          if (value.get_string().size() > 65535) {
+          if (value.get_string().size() > MAX_TEXT_LENGTH) {
             return RC::INVALID_ARGUMENT;
           }
-          std::hash<std::string> hashFunction;
-          std::size_t hashValue = hashFunction(value.get_string());
-          std::string value_search_for_text = std::string(table_->dir()) + "/" + std::string(table_->name()) + std::to_string(hashValue) + ".text";
-          std::string value_stored_in_file = value.get_string();
-          std::ofstream outputFile(value_search_for_text);
-          if (outputFile.is_open()) {
-            outputFile << value_stored_in_file;
-            outputFile.close();
-          } else {
-            LOG_ERROR(" failed to write text value to file!");
-          }
-          value.set_text(value_search_for_text.c_str(), value_search_for_text.size());
+          value.set_text(value.get_string().c_str(), value.get_string().size());
           check = true;
           break;
         }
@@ -107,6 +96,8 @@ RC UpdatePhysicalOperator::next()
     return RC::RECORD_EOF;
   }
 
+  // 先找出所有要更新的记录再逐条修改。新记录可能插入到扫描还没有访问的页面上，边扫描边修改会重复更新
+  std::vector<std::pair<Record, std::vector<Value>>> updates;
   PhysicalOperator *child = children_[0].get();
   while (RC::SUCCESS == (rc = child->next())) {
     Tuple *tuple = child->current_tuple();
@@ -145,7 +136,14 @@ RC UpdatePhysicalOperator::next()
     ASSERT(nullptr != tmp, "failed to allocate memory. size=%d", row_tuple->record().len());
     memcpy(tmp, row_tuple->record().data(), row_tuple->record().len());
     oldRecord.set_data_owner(tmp, row_tuple->record().len());
-    // Record oldRecord = row_tuple->record();
+    updates.emplace_back(std::move(oldRecord), std::move(values));
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to get next record to update: %s", strrc(rc));
+    return rc;
+  }
+
+  for (auto &[oldRecord, values] : updates) {
     rc = trx_->delete_record(table_, oldRecord);
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to delete record: %s", strrc(rc));
@@ -0,0 +1,106 @@
+#include <cstring>
+
+#include "include/query_engine/structor/chunk.h"
+
+Column::Column(AttrType attr_type, int attr_len, int capacity) : attr_type_(attr_type), attr_len_(attr_len)
+{
+  data_.resize(static_cast<size_t>(capacity) * attr_len_);
+  nulls_.resize(capacity);
+}
+
+void Column::set_name(const char *table_name, const char *field_name, const char *table_alias)
+{
+  table_name_  = table_name == nullptr ? "" : table_name;
+  field_name_  = field_name == nullptr ? "" : field_name;
+  table_alias_ = table_alias == nullptr ? "" : table_alias;
+}
+
+bool Column::match(const char *table_name, const char *field_name, const char *table_alias) const
+{
+  return 0 == strcmp(table_name, table_name_.c_str()) && 0 == strcmp(field_name, field_name_.c_str()) &&
+         0 == strcmp(table_alias, table_alias_.c_str());
+}
+
+void Column::append(const char *data, bool is_null)
+{
+  if (count_ >= static_cast<int>(nulls_.size())) {
+    nulls_.resize(nulls_.size() * 2 + 1);
+    data_.resize(nulls_.size() * attr_len_);
+  }
+  memcpy(data_.data() + static_cast<size_t>(count_) * attr_len_, data, attr_len_);
+  nulls_[count_] = is_null ? 1 : 0;
+  count_++;
+}
+
+void Column::append_value(const Value &value)
+{
+  if (value.is_null()) {
+    if (count_ >= static_cast<int>(nulls_.size())) {
+      nulls_.resize(nulls_.size() * 2 + 1);
+      data_.resize(nulls_.size() * attr_len_);
+    }
+    nulls_[count_++] = 1;
+    return;
+  }
+
+  // 表达式的值类型可能与列不同，比如整数之间的除法，数值类型之间需要转换
+  if (attr_type_ == INTS && value.attr_type() != INTS) {
+    int32_t int_value = value.get_int();
+    append(reinterpret_cast<const char *>(&int_value), false);
+    return;
+  }
+  if (attr_type_ == FLOATS && value.attr_type() != FLOATS) {
+    float float_value = value.get_float();
+    append(reinterpret_cast<const char *>(&float_value), false);
+    return;
+  }
+
+  std::vector<char> buf(attr_len_, 0);
+  memcpy(buf.data(), value.data(), std::min(attr_len_, value.length()));
+  append(buf.data(), false);
+}
+
+void Column::get_value(int row, Value &value) const
+{
+  if (is_null(row)) {
+    value.set_null();
+    return;
+  }
+  value.set_type(attr_type_);
+  value.set_data(data_at(row), attr_len_);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Column &Chunk::add_column(AttrType attr_type, int attr_len)
+{
+  columns_.emplace_back(new Column(attr_type, attr_len, capacity_));
+  return *columns_.back();
+}
+
+int Chunk::find_column(const char *table_name, const char *field_name, const char *table_alias) const
+{
+  for (size_t i = 0; i < columns_.size(); i++) {
+    if (columns_[i]->match(table_name, field_name, table_alias)) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+void Chunk::reset()
+{
+  for (std::unique_ptr<Column> &column : columns_) {
+    column->clear();
+  }
+  selection_.clear();
+}
+
+void Chunk::select_all()
+{
+  const int rows = row_num();
+  selection_.resize(rows);
+  for (int i = 0; i < rows; i++) {
+    selection_[i] = i;
+  }
+}
@@ -2,6 +2,10 @@
 
 #include "include/query_engine/structor/expression/comparison_expression.h"
 #include "include/query_engine/structor/expression/value_expression.h"
+#include "include/query_engine/structor/expression/field_expression.h"
+#include "include/query_engine/structor/chunk.h"
+#include "include/storage_engine/recorder/compare_kernel.h"
+#include "common/lang/bitmap.h"
 
 static void replace_all(std::string &str, const std::string &from, const std::string &to)
 {
@@ -15,10 +19,111 @@ static void replace_all(std::string &str, const std::string &from, const std::st
   }
 }
 
+/**
+ * @brief 在列上做比较，只保留满足条件的行
+ * @details 先用比较内核对整列计算出结果位图，再按位图和null标记缩小选择向量。
+ * 整列计算会多比较一些已经被过滤掉的行，但是没有分支，比逐行比较要快。
+ */
+static void filter_column(const Column &column, CompOp comp, const Value &value, std::vector<int> &selection)
+{
+  const int rows = column.count();
+  std::vector<char> bitmap((rows + 7) / 8);
+  if (column.attr_type() == FLOATS) {
+    compare_float(column.data_at(0), sizeof(float), rows, comp, value.get_float(), bitmap.data());
+  } else {
+    const int32_t constant = *reinterpret_cast<const int32_t *>(value.data());
+    compare_int32(column.data_at(0), sizeof(int32_t), rows, comp, constant, bitmap.data());
+  }
+
+  common::Bitmap result(bitmap.data(), rows);
+  int selected = 0;
+  for (int row : selection) {
+    if (result.get_bit(row) && !column.is_null(row)) {
+      selection[selected++] = row;
+    }
+  }
+  selection.resize(selected);
+}
+
+/**
+ * @brief 交换比较的左右两边时，对应的比较操作
+ */
+static CompOp swap_comp_op(CompOp comp)
+{
+  switch (comp) {
+    case LESS_EQUAL: return GREAT_EQUAL;
+    case LESS_THAN: return GREAT_THAN;
+    case GREAT_EQUAL: return LESS_EQUAL;
+    case GREAT_THAN: return LESS_THAN;
+    default: return comp;
+  }
+}
+
+RC ComparisonExpr::filter(Chunk &chunk) const
+{
+  if (!compare_kernel_supported(comp_)) {
+    return Expression::filter(chunk);
+  }
+  if (right_ == nullptr) {
+    return Expression::filter(chunk);
+  }
+
+  const FieldExpr *field_expr = nullptr;
+  const ValueExpr *value_expr = nullptr;
+  CompOp comp = comp_;
+  if (left_->type() == ExprType::FIELD && right_->type() == ExprType::VALUE) {
+    field_expr = static_cast<const FieldExpr *>(left_.get());
+    value_expr = static_cast<const ValueExpr *>(right_.get());
+  } else if (left_->type() == ExprType::VALUE && right_->type() == ExprType::FIELD) {
+    field_expr = static_cast<const FieldExpr *>(right_.get());
+    value_expr = static_cast<const ValueExpr *>(left_.get());
+    comp = swap_comp_op(comp_);
+  } else {
+    return Expression::filter(chunk);
+  }
+
+  const int index = chunk.find_column(field_expr->table_name(), field_expr->field_name(), field_expr->field().table_alias());
+  if (index < 0) {
+    return Expression::filter(chunk);
+  }
+
+  const Column &column = chunk.column(index);
+  const Value &value = value_expr->get_value();
+  if (value.is_null()) {
+    // 与null比较的结果总是false
+    chunk.selection().clear();
+    return RC::SUCCESS;
+  }
+  if (value.attr_type() != column.attr_type()) {
+    return Expression::filter(chunk);
+  }
+
+  switch (column.attr_type()) {
+    case INTS:
+    case DATES:
+    case FLOATS: {
+      filter_column(column, comp, value, chunk.selection());
+    } break;
+    default: {
+      return Expression::filter(chunk);
+    }
+  }
+  return RC::SUCCESS;
+}
+
 RC ComparisonExpr::set_trx(Trx *trx) const {
   return RC::SUCCESS;
 }
 
+void ComparisonExpr::getFields(std::vector<Field *> &query_fields) const {
+  if (left_ != nullptr) {
+    left_->getFields(query_fields);
+  }
+  if (right_ != nullptr) {
+    right_->getFields(query_fields);
+  }
+}
+
 RC ComparisonExpr::compare_value(const Value &left, const Value &right, bool &result) const
 {
   RC rc = RC::SUCCESS;
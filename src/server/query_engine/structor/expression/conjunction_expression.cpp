@@ -1,5 +1,6 @@
 #include "include/query_engine/structor/expression/conjunction_expression.h"
 #include "include/query_engine/structor/expression/comparison_expression.h"
+#include "include/query_engine/structor/chunk.h"
 
 RC ConjunctionExpr::get_value(const Tuple &tuple, Value &value) const
 {
@@ -28,10 +29,35 @@ RC ConjunctionExpr::get_value(const Tuple &tuple, Value &value) const
   return rc;
 }
 
+RC ConjunctionExpr::filter(Chunk &chunk) const
+{
+  if (conjunction_type_ != ConjunctionType::AND) {
+    return Expression::filter(chunk);
+  }
+
+  for (const std::unique_ptr<Expression> &expr : children_) {
+    RC rc = expr->filter(chunk);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to filter by child expression. rc=%s", strrc(rc));
+      return rc;
+    }
+    if (chunk.select_num() == 0) {
+      break;
+    }
+  }
+  return RC::SUCCESS;
+}
+
 RC ConjunctionExpr::set_trx(Trx *trx) const {
   for (const std::unique_ptr<Expression> &expr : children_) {
     const auto *compare_expr = dynamic_cast<const ComparisonExpr *>(expr.get());
     compare_expr->set_trx(trx);
   }
   return RC::SUCCESS;
-}
\ No newline at end of file
+}
+
+void ConjunctionExpr::getFields(std::vector<Field *> &query_fields) const {
+  for (const std::unique_ptr<Expression> &expr : children_) {
+    expr->getFields(query_fields);
+  }
+}
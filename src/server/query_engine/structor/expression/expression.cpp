@@ -0,0 +1,25 @@
+#include "include/query_engine/structor/expression/expression.h"
+#include "include/query_engine/structor/chunk.h"
+#include "include/query_engine/structor/tuple/chunk_tuple.h"
+
+RC Expression::filter(Chunk &chunk) const
+{
+  ChunkTuple tuple;
+  tuple.set_chunk(&chunk);
+
+  std::vector<int> &selection = chunk.selection();
+  int selected = 0;
+  Value value;
+  for (int row : selection) {
+    tuple.set_row(row);
+    RC rc = get_value(tuple, value);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    if (value.get_boolean()) {
+      selection[selected++] = row;
+    }
+  }
+  selection.resize(selected);
+  return RC::SUCCESS;
+}
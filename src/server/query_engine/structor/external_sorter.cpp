@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <cstring>
+
+#include "include/query_engine/structor/external_sorter.h"
+#include "include/query_engine/structor/spill_file.h"
+#include "common/log/log.h"
+
+/**
+ * @brief 比较两个规范化的排序键，一个是另一个的前缀时短的更小
+ */
+static int compare_key(const char *a, int a_len, const char *b, int b_len)
+{
+  int result = memcmp(a, b, std::min(a_len, b_len));
+  if (result != 0) {
+    return result;
+  }
+  return a_len - b_len;
+}
+
+/**
+ * @brief 写到临时文件中的一个有序段
+ * @details 每行的格式是 | key_len | payload_len | key | payload |
+ */
+class ExternalSorter::SortRun
+{
+public:
+  RC open() { return file_.open(); }
+
+  RC write(const char *key, int key_len, const char *payload, int payload_len)
+  {
+    int32_t lens[2] = {key_len, payload_len};
+    RC rc = file_.write(lens, sizeof(lens));
+    if (rc == RC::SUCCESS) {
+      rc = file_.write(key, key_len);
+    }
+    if (rc == RC::SUCCESS) {
+      rc = file_.write(payload, payload_len);
+    }
+    return rc;
+  }
+
+  /**
+   * @brief 写完以后从头开始读，并读出第一行
+   */
+  RC start_read()
+  {
+    RC rc = file_.rewind();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    return read_next();
+  }
+
+  RC read_next()
+  {
+    int32_t lens[2];
+    RC rc = file_.read(lens, sizeof(lens), eof_);
+    if (rc != RC::SUCCESS || eof_) {
+      return rc;
+    }
+    key_len_     = lens[0];
+    payload_len_ = lens[1];
+    row_.resize(static_cast<size_t>(key_len_) + payload_len_);
+    bool eof = false;
+    rc = file_.read(row_.data(), row_.size(), eof);
+    if (rc == RC::SUCCESS && eof) {
+      LOG_WARN("sort run is truncated");
+      return RC::IOERR_READ;
+    }
+    return rc;
+  }
+
+  bool        eof() const { return eof_; }
+  const char *key() const { return row_.data(); }
+  int         key_len() const { return key_len_; }
+  const char *payload() const { return row_.data() + key_len_; }
+  int         payload_len() const { return payload_len_; }
+
+private:
+  SpillFile         file_;
+  bool              eof_         = false;
+  int               key_len_     = 0;
+  int               payload_len_ = 0;
+  std::vector<char> row_;  // 当前行
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+ExternalSorter::ExternalSorter(size_t memory_limit, int64_t limit) : memory_limit_(memory_limit), limit_(limit)
+{
+  use_heap_ = limit_ >= 0;
+}
+
+ExternalSorter::~ExternalSorter() = default;
+
+bool ExternalSorter::heap_less(const HeapRow &a, const HeapRow &b) const
+{
+  int result = compare_key(a.key.data(), static_cast<int>(a.key.size()), b.key.data(), static_cast<int>(b.key.size()));
+  return result != 0 ? result < 0 : a.seq < b.seq;
+}
+
+RC ExternalSorter::add(const std::string &key, const std::string &payload)
+{
+  if (finished_) {
+    return RC::INTERNAL;
+  }
+
+  if (use_heap_) {
+    auto less = [this](const HeapRow &a, const HeapRow &b) { return heap_less(a, b); };
+    HeapRow row{key, payload, seq_++};
+    if (static_cast<int64_t>(heap_.size()) < limit_) {
+      heap_memory_ += sizeof(HeapRow) + key.size() + payload.size();
+      heap_.emplace_back(std::move(row));
+      std::push_heap(heap_.begin(), heap_.end(), less);
+    } else if (!heap_.empty() && less(row, heap_.front())) {
+      // 比堆中最大的一行小，替换掉它
+      std::pop_heap(heap_.begin(), heap_.end(), less);
+      heap_memory_ += key.size() + payload.size();
+      heap_memory_ -= heap_.back().key.size() + heap_.back().payload.size();
+      heap_.back() = std::move(row);
+      std::push_heap(heap_.begin(), heap_.end(), less);
+    }
+
+    if (heap_memory_ > memory_limit_) {
+      return switch_from_heap();
+    }
+    return RC::SUCCESS;
+  }
+
+  append_row(key.data(), static_cast<int>(key.size()), payload.data(), static_cast<int>(payload.size()));
+  if (buffer_.size() + rows_.size() * sizeof(RowRef) >= memory_limit_) {
+    return spill();
+  }
+  return RC::SUCCESS;
+}
+
+/**
+ * @brief 堆占用的内存超过了限制，把堆中的数据按照添加的顺序放到普通的缓存中，后面按外部排序处理
+ */
+RC ExternalSorter::switch_from_heap()
+{
+  std::sort(heap_.begin(), heap_.end(), [](const HeapRow &a, const HeapRow &b) { return a.seq < b.seq; });
+  use_heap_ = false;
+  for (const HeapRow &row : heap_) {
+    append_row(row.key.data(), static_cast<int>(row.key.size()), row.payload.data(), static_cast<int>(row.payload.size()));
+  }
+  heap_.clear();
+  heap_.shrink_to_fit();
+  heap_memory_ = 0;
+  return spill();
+}
+
+void ExternalSorter::append_row(const char *key, int key_len, const char *payload, int payload_len)
+{
+  rows_.push_back(RowRef{buffer_.size(), key_len, payload_len});
+  buffer_.insert(buffer_.end(), key, key + key_len);
+  buffer_.insert(buffer_.end(), payload, payload + payload_len);
+}
+
+void ExternalSorter::sort_rows()
+{
+  const char *data = buffer_.data();
+  std::stable_sort(rows_.begin(), rows_.end(), [data](const RowRef &a, const RowRef &b) {
+    return compare_key(data + a.offset, a.key_len, data + b.offset, b.key_len) < 0;
+  });
+}
+
+/**
+ * @brief 把内存中的数据排序后写成一个有序段。只需要前 limit 行时，每个有序段也只需要写前 limit 行
+ */
+RC ExternalSorter::spill()
+{
+  sort_rows();
+
+  std::unique_ptr<SortRun> run(new SortRun());
+  RC rc = run->open();
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+
+  size_t row_num = rows_.size();
+  if (limit_ >= 0) {
+    row_num = std::min(row_num, static_cast<size_t>(limit_));
+  }
+  for (size_t i = 0; i < row_num; i++) {
+    const RowRef &row = rows_[i];
+    const char *key = buffer_.data() + row.offset;
+    rc = run->write(key, row.key_len, key + row.key_len, row.payload_len);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  runs_.emplace_back(std::move(run));
+
+  buffer_.clear();
+  rows_.clear();
+  LOG_TRACE("external sort spilled a run. rows=%lu, runs=%lu", row_num, runs_.size());
+  return RC::SUCCESS;
+}
+
+RC ExternalSorter::finish()
+{
+  if (finished_) {
+    return RC::SUCCESS;
+  }
+  finished_ = true;
+
+  if (use_heap_) {
+    std::sort(heap_.begin(), heap_.end(), [this](const HeapRow &a, const HeapRow &b) { return heap_less(a, b); });
+    return RC::SUCCESS;
+  }
+
+  if (runs_.empty()) {
+    sort_rows();
+    return RC::SUCCESS;
+  }
+
+  RC rc = RC::SUCCESS;
+  if (!rows_.empty()) {
+    rc = spill();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  buffer_.shrink_to_fit();
+  rows_.shrink_to_fit();
+
+  for (std::unique_ptr<SortRun> &run : runs_) {
+    rc = run->start_read();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
+  // 初始时所有节点都指向一个比任何有序段都小的虚拟段，然后依次调整每个有序段
+  const int k = static_cast<int>(runs_.size());
+  tree_.assign(k, k);
+  for (int i = k - 1; i >= 0; i--) {
+    adjust(i);
+  }
+  return RC::SUCCESS;
+}
+
+/**
+ * @brief 败者树中 a 是否比 b 小
+ * @details 下标 run_num() 是初始化时使用的虚拟段，比所有段都小；读完的段比所有段都大。
+ * 排序键相同时，先产生的有序段更小，这样多路归并也是稳定的
+ */
+bool ExternalSorter::run_less(int a, int b) const
+{
+  const int k = static_cast<int>(runs_.size());
+  if (a == k || b == k) {
+    return a == k && b != k;
+  }
+  const SortRun &run_a = *runs_[a];
+  const SortRun &run_b = *runs_[b];
+  if (run_a.eof() || run_b.eof()) {
+    return run_a.eof() && run_b.eof() ? a < b : run_b.eof();
+  }
+  int result = compare_key(run_a.key(), run_a.key_len(), run_b.key(), run_b.key_len());
+  return result != 0 ? result < 0 : a < b;
+}
+
+/**
+ * @brief 有序段 run 的当前行变化以后，从叶子到根重新比较，败者留在节点中，胜者继续向上
+ */
+void ExternalSorter::adjust(int run)
+{
+  const int k = static_cast<int>(runs_.size());
+  int winner = run;
+  for (int t = (run + k) / 2; t > 0; t /= 2) {
+    if (run_less(tree_[t], winner)) {
+      std::swap(winner, tree_[t]);
+    }
+  }
+  tree_[0] = winner;
+}
+
+RC ExternalSorter::next(const char *&payload, int &payload_len)
+{
+  if (!finished_) {
+    return RC::INTERNAL;
+  }
+  if (limit_ >= 0 && output_num_ >= limit_) {
+    return RC::RECORD_EOF;
+  }
+
+  if (use_heap_) {
+    if (read_pos_ >= heap_.size()) {
+      return RC::RECORD_EOF;
+    }
+    const HeapRow &row = heap_[read_pos_++];
+    payload = row.payload.data();
+    payload_len = static_cast<int>(row.payload.size());
+    output_num_++;
+    return RC::SUCCESS;
+  }
+
+  if (runs_.empty()) {
+    if (read_pos_ >= rows_.size()) {
+      return RC::RECORD_EOF;
+    }
+    const RowRef &row = rows_[read_pos_++];
+    payload = buffer_.data() + row.offset + row.key_len;
+    payload_len = row.payload_len;
+    output_num_++;
+    return RC::SUCCESS;
+  }
+
+  // 上一次输出的段前进到下一行
+  if (output_num_ > 0) {
+    const int last = tree_[0];
+    RC rc = runs_[last]->read_next();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    adjust(last);
+  }
+
+  const SortRun &winner = *runs_[tree_[0]];
+  if (winner.eof()) {
+    return RC::RECORD_EOF;
+  }
+  payload = winner.payload();
+  payload_len = winner.payload_len();
+  output_num_++;
+  return RC::SUCCESS;
+}
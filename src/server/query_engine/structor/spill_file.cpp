@@ -0,0 +1,87 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include "include/query_engine/structor/spill_file.h"
+#include "common/log/log.h"
+
+SpillFile::~SpillFile()
+{
+  if (file_ != nullptr) {
+    fclose(file_);
+    file_ = nullptr;
+  }
+}
+
+RC SpillFile::open()
+{
+  file_ = tmpfile();
+  if (file_ == nullptr) {
+    LOG_WARN("failed to create temporary file. errno=%d:%s", errno, strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+  setvbuf(file_, nullptr, _IOFBF, IO_BUFFER_SIZE);
+  return RC::SUCCESS;
+}
+
+RC SpillFile::write(const void *data, size_t len)
+{
+  if (len > 0 && fwrite(data, len, 1, file_) != 1) {
+    LOG_WARN("failed to write temporary file. errno=%d:%s", errno, strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+  size_ += len;
+  return RC::SUCCESS;
+}
+
+RC SpillFile::rewind()
+{
+  if (fflush(file_) != 0 || fseek(file_, 0, SEEK_SET) != 0) {
+    LOG_WARN("failed to rewind temporary file. errno=%d:%s", errno, strerror(errno));
+    return RC::IOERR_SEEK;
+  }
+  return RC::SUCCESS;
+}
+
+RC SpillFile::read(void *data, size_t len, bool &eof)
+{
+  eof = false;
+  if (len == 0) {
+    return RC::SUCCESS;
+  }
+  if (fread(data, len, 1, file_) != 1) {
+    if (feof(file_)) {
+      eof = true;
+      return RC::SUCCESS;
+    }
+    LOG_WARN("failed to read temporary file. errno=%d:%s", errno, strerror(errno));
+    return RC::IOERR_READ;
+  }
+  return RC::SUCCESS;
+}
+
+RC SpillFile::write_block(const std::string &block)
+{
+  const int32_t len = static_cast<int32_t>(block.size());
+  RC rc = write(&len, sizeof(len));
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  return write(block.data(), block.size());
+}
+
+RC SpillFile::read_block(std::string &block, bool &eof)
+{
+  int32_t len = 0;
+  RC rc = read(&len, sizeof(len), eof);
+  if (rc != RC::SUCCESS || eof) {
+    return rc;
+  }
+  block.resize(len);
+  rc = read(block.data(), len, eof);
+  if (rc == RC::SUCCESS && eof) {
+    LOG_WARN("temporary file is truncated. block len=%d", len);
+    return RC::IOERR_READ;
+  }
+  return rc;
+}
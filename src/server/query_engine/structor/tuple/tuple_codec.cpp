@@ -0,0 +1,96 @@
+#include <cstring>
+
+#include "include/query_engine/structor/tuple/tuple_codec.h"
+
+void append_value_key(const Value &value, bool asc, std::string &key)
+{
+  const size_t begin = key.size();
+  auto append_uint = [&key](uint64_t v, int bytes) {
+    for (int i = bytes - 1; i >= 0; i--) {
+      key.push_back(static_cast<char>((v >> (i * 8)) & 0xFF));
+    }
+  };
+
+  if (value.is_null()) {
+    key.push_back(0);
+  } else {
+    key.push_back(1);
+    switch (value.attr_type()) {
+      case INTS:
+      case FLOATS: {
+        double d = value.attr_type() == INTS ? static_cast<double>(value.get_int()) : value.get_float();
+        d += 0.0;  // -0.0 与 0.0 相同
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+        bits = (bits & (1ULL << 63)) ? ~bits : (bits | (1ULL << 63));
+        append_uint(bits, 8);
+      } break;
+      case DATES: {
+        int32_t v;
+        memcpy(&v, value.data(), sizeof(v));
+        append_uint(static_cast<uint32_t>(v) ^ 0x80000000U, 4);
+      } break;
+      case BOOLEANS: {
+        key.push_back(value.get_boolean() ? 1 : 0);
+      } break;
+      default: {
+        const std::string str = value.get_string();
+        for (char c : str) {
+          key.push_back(c);
+          if (c == 0) {
+            key.push_back(static_cast<char>(0xFF));
+          }
+        }
+        key.push_back(0);
+        key.push_back(0);
+      } break;
+    }
+  }
+
+  if (!asc) {
+    for (size_t i = begin; i < key.size(); i++) {
+      key[i] = static_cast<char>(~key[i]);
+    }
+  }
+}
+
+void append_tuple_records(const Tuple &tuple, std::string &data)
+{
+  std::vector<Record *> records;
+  tuple.get_record(records);
+  for (const Record *record : records) {
+    int32_t header[3] = {record->rid().page_num, record->rid().slot_num, record->len()};
+    data.append(reinterpret_cast<const char *>(header), sizeof(header));
+    data.append(record->data(), record->len());
+  }
+}
+
+void RestoredRecords::restore(const char *data, int len, Tuple &tuple)
+{
+  const char *end = data + len;
+  size_t index = 0;
+  while (data < end) {
+    int32_t header[3];
+    memcpy(header, data, sizeof(header));
+    data += sizeof(header);
+
+    if (index >= records_.size()) {
+      records_.emplace_back();
+      buffers_.emplace_back();
+    }
+    std::vector<char> &buffer = buffers_[index];
+    buffer.assign(data, data + header[2]);
+    data += header[2];
+
+    Record &record = records_[index++];
+    record.set_rid(header[0], header[1]);
+    record.set_data(buffer.data(), header[2]);
+  }
+
+  // set_record 会消耗传入的数组，每次重新填充
+  record_ptrs_.clear();
+  for (size_t i = 0; i < index; i++) {
+    record_ptrs_.push_back(&records_[i]);
+  }
+  tuple.set_record(record_ptrs_);
+}
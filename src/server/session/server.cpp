@@ -2,6 +2,7 @@
 #include "include/query_engine/query_engine.h"
 
 QueryEngine Server::query_engine_ = QueryEngine();
+WorkerPool Server::worker_pool_;
 
 ServerParam::ServerParam()
 {
@@ -53,6 +54,13 @@ void Server::recv(int fd, short ev, void *arg)
 {
   Communicator *comm = (Communicator *)arg;
 
+  // 请求处理完之前不再监听这个连接，保证同一个会话的请求按顺序执行
+  event_del(&comm->read_event());
+  worker_pool_.submit(comm);
+}
+
+void Server::process(Communicator *comm)
+{
   SessionRequest *event = nullptr;
   RC rc = comm->read_event(event);
   if (rc != RC::SUCCESS) {
@@ -62,13 +70,22 @@ void Server::recv(int fd, short ev, void *arg)
 
   if (event == nullptr) {
     LOG_WARN("event is null while read event return success");
+    event_add(&comm->read_event(), nullptr);
     return;
   }
   bool need_disconnect = query_engine_.process_session_request(event);
+  // event 对象在 read_event 中创建，需要在这里释放
+  delete event;
   if(need_disconnect){
     close_connection(comm);
     return;
   }
+
+  // 重新监听这个连接。serve 中调用了 evthread_use_pthreads，可以在工作线程中操作事件
+  if (event_add(&comm->read_event(), nullptr) < 0) {
+    LOG_ERROR("Failed to event_add for read event of %s into libevent, %s", comm->addr(), strerror(errno));
+    close_connection(comm);
+  }
 }
 
 void Server::accept(int fd, short ev, void *arg)
@@ -333,7 +350,10 @@ int Server::serve()
   }
 
   if (!server_param_.use_std_io) {
+    worker_pool_.start(server_param_.worker_thread_num, Server::process);
     event_base_dispatch(event_base_);
+    // 工作线程会向 event_base_ 中添加事件，需要在释放 event_base_ 之前停止
+    worker_pool_.stop();
   }
 
   if (listen_ev_ != nullptr) {
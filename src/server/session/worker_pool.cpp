@@ -0,0 +1,84 @@
+#include "include/session/worker_pool.h"
+#include "include/session/communicator.h"
+#include "include/session/session.h"
+#include "include/session/thread_data.h"
+#include "common/log/log.h"
+
+WorkerPool::~WorkerPool()
+{
+  stop();
+}
+
+void WorkerPool::start(int thread_num, Handler handler)
+{
+  std::lock_guard<std::mutex> lock_guard(lock_);
+  if (running_) {
+    LOG_WARN("worker pool has been started");
+    return;
+  }
+
+  handler_ = std::move(handler);
+  running_ = true;
+  for (int i = 0; i < std::max(thread_num, 1); i++) {
+    threads_.emplace_back(&WorkerPool::run, this);
+  }
+  LOG_INFO("worker pool started. thread num=%d", threads_.size());
+}
+
+void WorkerPool::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock_guard(lock_);
+    if (!running_) {
+      return;
+    }
+    running_ = false;
+    tasks_.clear();
+  }
+  cond_.notify_all();
+  for (std::thread &thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+  LOG_INFO("worker pool stopped");
+}
+
+void WorkerPool::submit(Communicator *communicator)
+{
+  {
+    std::lock_guard<std::mutex> lock_guard(lock_);
+    tasks_.push_back(communicator);
+  }
+  cond_.notify_one();
+}
+
+void WorkerPool::run()
+{
+  ThreadData thread_data;
+  ThreadData::setup(&thread_data);
+
+  std::unique_lock<std::mutex> lock_guard(lock_);
+  while (true) {
+    cond_.wait(lock_guard, [this]() { return !running_ || !tasks_.empty(); });
+    if (!running_) {
+      break;
+    }
+
+    Communicator *communicator = tasks_.front();
+    tasks_.pop_front();
+    lock_guard.unlock();
+
+    thread_data.set_session(communicator->session());
+    Session::set_current_session(communicator->session());
+
+    // handler 可能会关闭连接并释放 communicator，之后不能再访问它
+    handler_(communicator);
+
+    Session::set_current_session(nullptr);
+    thread_data.set_session(nullptr);
+
+    lock_guard.lock();
+  }
+
+  ThreadData::setup(nullptr);
+}
@@ -103,6 +103,9 @@ RC FileBufferPool::get_this_page(PageNum page_num, Frame **frame)
   RC rc = RC::SUCCESS;
   *frame = nullptr;
 
+  // 只锁住页面所在的分区。命中时也需要加锁，否则可能拿到其它线程刚分配、还没有加载完数据的frame
+  std::scoped_lock lock_guard(page_lock(page_num));
+
   Frame *used_match_frame = frame_manager_.get(file_desc_, page_num);
   if (used_match_frame != nullptr) {
     used_match_frame->access();
@@ -110,8 +113,6 @@ RC FileBufferPool::get_this_page(PageNum page_num, Frame **frame)
     return RC::SUCCESS;
   }
 
-  std::scoped_lock lock_guard(lock_); // 直接加了一把大锁，其实可以根据访问的页面来细化提高并行度
-
   // Allocate one page and load the data into this page
   Frame *allocated_frame = nullptr;
   rc = allocate_frame(page_num, &allocated_frame);
@@ -126,7 +127,8 @@ RC FileBufferPool::get_this_page(PageNum page_num, Frame **frame)
 
   if ((rc = load_page(page_num, allocated_frame)) != RC::SUCCESS) {
     LOG_ERROR("Failed to load page %s:%d", file_name_.c_str(), page_num);
-    evict_page(page_num, allocated_frame);
+    // 刚分配的frame不会是脏页，直接释放即可（evict_page 会再次加分区锁）
+    frame_manager_.free(file_desc_, page_num, allocated_frame);
     return rc;
   }
 
@@ -138,37 +140,37 @@ RC FileBufferPool::allocate_page(Frame **frame)
 {
   RC rc = RC::SUCCESS;
 
-  lock_.lock();
+  hdr_lock_.lock();
 
-  int byte = 0, bit = 0;
+  // 优先复用已经释放的页面。释放的页面不一定写到过磁盘上，所以与新页面一样直接使用空白的页帧，不从磁盘加载
+  PageNum page_num = BP_INVALID_PAGE_NUM;
   if ((file_header_->allocated_pages) < (file_header_->page_count)) {
     // There is one free page
     for (int i = 0; i < file_header_->page_count; i++) {
-      byte = i / 8;
-      bit = i % 8;
-      if (((file_header_->bitmap[byte]) & (1 << bit)) == 0) {
-        (file_header_->allocated_pages)++;
-        file_header_->bitmap[byte] |= (1 << bit);
-        hdr_frame_->mark_dirty();
-
-        lock_.unlock();
-        return get_this_page(i, frame);
+      if (((file_header_->bitmap[i / 8]) & (1 << (i % 8))) == 0) {
+        page_num = i;
+        break;
       }
     }
   }
 
-  if (file_header_->page_count >= FileHeader::MAX_PAGE_NUM) {
-    LOG_WARN("file buffer pool is full. page count %d, max page count %d",
-        file_header_->page_count, FileHeader::MAX_PAGE_NUM);
-    lock_.unlock();
-    return RC::BUFFERPOOL_NOBUF;
+  if (page_num == BP_INVALID_PAGE_NUM) {
+    if (file_header_->page_count >= FileHeader::MAX_PAGE_NUM) {
+      LOG_WARN("file buffer pool is full. page count %d, max page count %d",
+          file_header_->page_count, FileHeader::MAX_PAGE_NUM);
+      hdr_lock_.unlock();
+      return RC::BUFFERPOOL_NOBUF;
+    }
+    page_num = file_header_->page_count;
   }
 
-  PageNum page_num = file_header_->page_count;
+  common::Mutex &page_lock = this->page_lock(page_num);
+  page_lock.lock();
   Frame *allocated_frame = nullptr;
   if ((rc = allocate_frame(page_num, &allocated_frame)) != RC::SUCCESS) {
     LOG_ERROR("Failed to allocate frame %s, due to no free page.", file_name_.c_str());
-    lock_.unlock();
+    page_lock.unlock();
+    hdr_lock_.unlock();
     return rc;
   }
 
@@ -176,19 +178,21 @@ RC FileBufferPool::allocate_page(Frame **frame)
            file_name_.c_str(), page_num, allocated_frame->pin_count());
 
   file_header_->allocated_pages++;
-  file_header_->page_count++;
+  if (page_num == file_header_->page_count) {
+    file_header_->page_count++;
+  }
 
-  byte = page_num / 8;
-  bit = page_num % 8;
-  file_header_->bitmap[byte] |= (1 << bit);
+  file_header_->bitmap[page_num / 8] |= (1 << (page_num % 8));
   hdr_frame_->mark_dirty();
 
   allocated_frame->set_file_desc(file_desc_);
   allocated_frame->access();
   allocated_frame->clear_page();
-  allocated_frame->set_page_num(file_header_->page_count - 1);
+  allocated_frame->set_page_num(page_num);
+  allocated_frame->mark_dirty();
 
-  lock_.unlock();
+  page_lock.unlock();
+  hdr_lock_.unlock();
 
   *frame = allocated_frame;
   return RC::SUCCESS;
@@ -200,12 +204,64 @@ RC FileBufferPool::unpin_page(Frame *frame)
   return RC::SUCCESS;
 }
 
+RC FileBufferPool::get_this_page_shared(PageNum page_num, Frame **frame)
+{
+  RC rc = get_this_page(page_num, frame);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  // 页面已经被pin住，等待锁的时候不会被淘汰
+  (*frame)->read_latch();
+  return RC::SUCCESS;
+}
+
+RC FileBufferPool::get_this_page_exclusive(PageNum page_num, Frame **frame)
+{
+  RC rc = get_this_page(page_num, frame);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  (*frame)->write_latch();
+  return RC::SUCCESS;
+}
+
+RC FileBufferPool::try_get_this_page_exclusive(PageNum page_num, Frame **frame)
+{
+  RC rc = get_this_page(page_num, frame);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  if (!(*frame)->try_write_latch()) {
+    unpin_page(*frame);
+    *frame = nullptr;
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  }
+  return RC::SUCCESS;
+}
+
+RC FileBufferPool::unpin_page_shared(Frame *frame)
+{
+  frame->read_unlatch();
+  return unpin_page(frame);
+}
+
+RC FileBufferPool::unpin_page_exclusive(Frame *frame)
+{
+  frame->write_unlatch();
+  return unpin_page(frame);
+}
+
 /**
  * TODO [Lab1] 需要同学们实现页面刷盘，下面是可参考的思路
  */
 RC FileBufferPool::flush_page(Frame &frame)
 {
-  std::scoped_lock lock_guard(lock_);
+  if (&frame == hdr_frame_) {
+    // 文件头的修改都是在 hdr_lock_ 保护下进行的，刷盘时也需要拿住它，避免写出修改了一半的位图
+    std::scoped_lock lock_guard(hdr_lock_, page_lock(BP_HEADER_PAGE));
+    return flush_page_internal(frame);
+  }
+  std::scoped_lock lock_guard(page_lock(frame.page_num()));
   return flush_page_internal(frame);
 }
 /**
@@ -224,17 +280,16 @@ RC FileBufferPool::flush_page_internal(Frame &frame)
 //2.
   int64_t offset = static_cast<int64_t>(frame.page_num()) * BP_PAGE_SIZE;
   int fd = file_desc_;
-  if (lseek(fd, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to flush page %s:%d, due to failed to lseek:%s.", file_name_.c_str(), frame.page_num(), strerror(errno));
-    return RC::IOERR_SEEK;
-  }
-//3.
-  if (writen(fd, &page, BP_PAGE_SIZE) != 0) {
+// 这里还没有保证WAL(修改页面的日志先于页面落盘)：记录的修改当前不写数据日志(LogManager::append_record_log
+// 没有调用者)，页面LSN也没有设置，等到写数据日志时再在这里按照页面LSN刷日志
+//4. 先清除脏标记再写数据，写的过程中如果有其它线程修改了页面，会重新设置脏标记，不会丢失
+  frame.clear_dirty();
+//3. 多个线程可能同时刷不同的页面，所以使用pwrite，不依赖文件描述符上共享的读写位置
+  if (pwriten(fd, &page, BP_PAGE_SIZE, offset) != 0) {
     LOG_ERROR("Failed to flush page %s:%d, due to failed to write data:%s.", file_name_.c_str(), frame.page_num(), strerror(errno));
+    frame.mark_dirty();
     return RC::IOERR_WRITE;
   }
-//4.
-  frame.clear_dirty();
 //5.
   LOG_DEBUG("Successfully flush page %s:%d.", file_name_.c_str(), frame.page_num());
   return RC::SUCCESS;
@@ -245,27 +300,176 @@ RC FileBufferPool::flush_page_internal(Frame &frame)
  */
 RC FileBufferPool::flush_all_pages()
 {
-  std::scoped_lock lock_guard(lock_);
   RC rc = RC::SUCCESS;
-  for (Frame *frame : frame_manager_.find_list(file_desc_)) {
-    if (frame->dirty()) {
-      RC _rc = flush_page_internal(*frame);
-      if (_rc != RC::SUCCESS) {
-        LOG_ERROR("Failed to flush page %s:%d, rc=%s", file_name_.c_str(), frame->page_num(), strrc(_rc));
-        rc = _rc;
-      }
+  for (const FrameId &frame_id : frame_manager_.find_dirty_list(file_desc_)) {
+    bool written = false;
+    RC _rc = write_page(frame_id.page_num(), false /*skip_pinned*/, written);
+    if (_rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to flush page %s:%d, rc=%s", file_name_.c_str(), frame_id.page_num(), strrc(_rc));
+      rc = _rc;
+    }
+  }
+  return rc;
+}
+
+/**
+ * @brief 在页面锁的保护下重新获取页帧再刷盘
+ * @details 获取页帧和驱逐、释放页帧都要加页面锁，所以这里pin住的页帧不会被其它线程释放，
+ * 也不会拿到还没有加载完数据的页帧。
+ * 页面内容是在页帧锁的保护下修改的，checkpoint不能跳过正在使用的页面，需要先加页帧读锁再写，
+ * 否则可能写出修改了一半的页面。等待页帧锁之前要先放开页面锁：持有页帧写锁的线程可能还在等待
+ * 同一个分区上其它页面的页面锁。
+ */
+RC FileBufferPool::write_page(PageNum page_num, bool skip_pinned, bool &written)
+{
+  written = false;
+
+  if (page_num == BP_HEADER_PAGE) {
+    // 与 flush_page 一样，文件头的修改在 hdr_lock_ 的保护下进行，不使用页帧锁。
+    // 文件头一直被pin住，后台刷盘时总是跳过
+    std::scoped_lock lock_guard(hdr_lock_, page_lock(page_num));
+    if (!skip_pinned && hdr_frame_->dirty()) {
+      RC rc = flush_page_internal(*hdr_frame_);
+      written = (rc == RC::SUCCESS);
+      return rc;
+    }
+    return RC::SUCCESS;
+  }
+
+  Frame *frame = nullptr;
+  {
+    std::scoped_lock lock_guard(page_lock(page_num));
+    frame = frame_manager_.get(file_desc_, page_num, false /*touch*/);
+    if (frame == nullptr) {
+      return RC::SUCCESS;
+    }
+
+    // 自己pin了一次，pin count大于1说明其它线程正在使用
+    if (!frame->dirty() || (skip_pinned && frame->pin_count() > 1)) {
+      frame->unpin();
+      return RC::SUCCESS;
     }
-    frame->unpin();
   }
+
+  RC rc = RC::SUCCESS;
+  frame->read_latch();
+  if (frame->dirty()) {
+    rc = flush_page_internal(*frame);
+    written = (rc == RC::SUCCESS);
+  }
+  unpin_page_shared(frame);
   return rc;
 }
 
+void FileBufferPool::read_ahead(PageNum start_page, int page_count)
+{
+  bp_manager_.page_reader().submit(this, start_page, page_count);
+}
+
+RC FileBufferPool::load_pages(PageNum start_page, int page_count)
+{
+  page_count = std::min(page_count, MAX_LOAD_PAGE_NUM);
+
+  // 只加载已经分配的页面
+  std::vector<bool> allocated;
+  {
+    std::scoped_lock lock_guard(hdr_lock_);
+    const PageNum end_page = std::min(start_page + page_count, file_header_->page_count);
+    for (PageNum page_num = start_page; page_num < end_page; page_num++) {
+      allocated.push_back((file_header_->bitmap[page_num / 8] & (1 << (page_num % 8))) != 0);
+    }
+  }
+  if (allocated.empty()) {
+    return RC::SUCCESS;
+  }
+
+  // 同时持有多个分区的锁，按照分区下标的顺序加锁，避免多个线程同时批量加载时死锁
+  std::vector<int> partitions;
+  for (size_t i = 0; i < allocated.size(); i++) {
+    partitions.push_back((start_page + i) % PAGE_LOCK_PARTITION_NUM);
+  }
+  std::sort(partitions.begin(), partitions.end());
+  for (int partition : partitions) {
+    page_locks_[partition].lock();
+  }
+
+  RC rc = RC::SUCCESS;
+  PageNum run_start = start_page;
+  std::vector<Frame *> run_frames;  // 当前连续的、需要从磁盘读取的页面
+  for (size_t i = 0; i < allocated.size() && RC_SUCC(rc); i++) {
+    const PageNum page_num = start_page + i;
+    Frame *frame = allocated[i] ? frame_manager_.get(file_desc_, page_num, false /*touch*/) : nullptr;
+    if (!allocated[i] || frame != nullptr) {
+      if (frame != nullptr) {
+        frame->unpin();
+      }
+      rc = load_frames(run_start, run_frames);
+      continue;
+    }
+
+    rc = allocate_frame(page_num, &frame, false /*wait*/);
+    if (RC_FAIL(rc)) {
+      // 预读不应该和正常的访问抢frame
+      LOG_TRACE("stop loading pages due to no free frame. file=%s, page_num=%d", file_name_.c_str(), page_num);
+      break;
+    }
+    frame->set_file_desc(file_desc_);
+    if (run_frames.empty()) {
+      run_start = page_num;
+    }
+    run_frames.push_back(frame);
+  }
+  RC rc2 = load_frames(run_start, run_frames);
+  if (RC_SUCC(rc)) {
+    rc = rc2;
+  }
+
+  for (int partition : partitions) {
+    page_locks_[partition].unlock();
+  }
+  return rc == RC::BUFFERPOOL_NOBUF ? RC::SUCCESS : rc;
+}
+
+RC FileBufferPool::load_frames(PageNum start_page, std::vector<Frame *> &frames)
+{
+  if (frames.empty()) {
+    return RC::SUCCESS;
+  }
+
+  std::vector<struct iovec> iov(frames.size());
+  for (size_t i = 0; i < frames.size(); i++) {
+    iov[i].iov_base = &frames[i]->page();
+    iov[i].iov_len = BP_PAGE_SIZE;
+  }
+
+  int64_t read_size = 0;
+  int ret = preadvn(file_desc_, iov.data(), iov.size(), static_cast<off_t>(start_page) * BP_PAGE_SIZE, read_size);
+  if (ret != 0 && ret != -1) {
+    LOG_WARN("Failed to load pages %s:%d, count=%d, error=%s", file_name_.c_str(), start_page, frames.size(), strerror(ret));
+  }
+
+  // 新分配的页面可能还没有刷到磁盘上，文件比page_count短，只保留完整读到的页面
+  const size_t loaded = static_cast<size_t>(read_size / BP_PAGE_SIZE);
+  for (size_t i = 0; i < frames.size(); i++) {
+    Frame *frame = frames[i];
+    if (i < loaded) {
+      frame->set_prefetched();
+      frame->unpin();
+    } else {
+      frame_manager_.free(file_desc_, start_page + i, frame);
+    }
+  }
+  LOG_TRACE("load pages %s:%d, count=%d, loaded=%d", file_name_.c_str(), start_page, frames.size(), loaded);
+  frames.clear();
+  return (ret == 0 || ret == -1) ? RC::SUCCESS : RC::IOERR_READ;
+}
+
 /**
  * TODO [Lab1] 需要同学们实现某个指定页面的驱逐
  */
 RC FileBufferPool::evict_page(PageNum page_num, Frame *buf)
 {
-  std::scoped_lock lock_guard(lock_);
+  std::scoped_lock lock_guard(page_lock(page_num));
   if(buf->dirty()) {
     RC rc = flush_page_internal(*buf);
     if(rc != RC::SUCCESS) {
@@ -280,10 +484,10 @@ RC FileBufferPool::evict_page(PageNum page_num, Frame *buf)
  */
 RC FileBufferPool::evict_all_pages()
 {
-  std::scoped_lock lock_guard(lock_);
   RC rc = RC::SUCCESS;
   auto frames_to_evict = frame_manager_.find_list(file_desc_);
   for (Frame *frame : frames_to_evict) {
+    std::scoped_lock lock_guard(page_lock(frame->page_num()));
     RC rc_tmp;
     if (frame->dirty()) {
       rc_tmp = flush_page_internal(*frame);
@@ -305,8 +509,10 @@ RC FileBufferPool::evict_all_pages()
 /**
  * @brief 申请一个frame，如果没有空闲的frame，则驱逐一些frame
  */
-RC FileBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
+RC FileBufferPool::allocate_frame(PageNum page_num, Frame **buffer, bool wait /* = true */)
 {
+  // 被驱逐的frame pin count为0，并且在frame manager的锁保护下，其它线程无法再访问它，
+  // 所以刷盘时不需要加页面锁。如果在这里加其它页面的锁，反而可能与正在分配frame的线程形成死锁
   auto evict_action = [this](Frame *frame) {
     if (!frame->dirty()) {
       return RC::SUCCESS;
@@ -330,7 +536,9 @@ RC FileBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
       return RC::SUCCESS;
     }
     LOG_TRACE("frames are all allocated, so we should evict some frames to get one free frame");
-    (void)frame_manager_.evict_frames(1, evict_action);
+    if (frame_manager_.evict_frames(1, evict_action) == 0 && !wait) {
+      break;
+    }
   }
   return RC::BUFFERPOOL_NOBUF;
 }
@@ -343,14 +551,9 @@ RC FileBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
 RC FileBufferPool::load_page(PageNum page_num, Frame *frame)
 {
   int64_t offset = ((int64_t)page_num) * BP_PAGE_SIZE;
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to load page %s:%d, due to failed to lseek:%s.", file_name_.c_str(), page_num, strerror(errno));
-
-    return RC::IOERR_SEEK;
-  }
 
   Page &page = frame->page();
-  int ret = readn(file_desc_, &page, BP_PAGE_SIZE);
+  int ret = preadn(file_desc_, &page, BP_PAGE_SIZE, offset);
   if (ret != 0) {
     LOG_ERROR("Failed to load page %s, file_desc:%d, page num:%d, due to failed to read data:%s, ret=%d, page count=%d",
               file_name_.c_str(), file_desc_, page_num, strerror(errno), ret, file_header_->allocated_pages);
@@ -364,13 +567,18 @@ int FileBufferPool::file_desc() const
   return file_desc_;
 }
 
+int FileBufferPool::page_count() const
+{
+  return file_header_->page_count;
+}
+
 RC FileBufferPool::recover_page(PageNum page_num)
 {
   int byte = 0, bit = 0;
   byte = page_num / 8;
   bit = page_num % 8;
 
-  std::scoped_lock lock_guard(lock_);
+  std::scoped_lock lock_guard(hdr_lock_);
   if (!(file_header_->bitmap[byte] & (1 << bit))) {
     file_header_->bitmap[byte] |= (1 << bit);
     file_header_->allocated_pages++;
@@ -382,7 +590,7 @@ RC FileBufferPool::recover_page(PageNum page_num)
 
 RC FileBufferPool::dispose_page(PageNum page_num)
 {
-  std::scoped_lock lock_guard(lock_);
+  std::scoped_lock lock_guard(hdr_lock_, page_lock(page_num));
   Frame *used_frame = frame_manager_.get(file_desc_, page_num);
   if (used_frame != nullptr) {
     ASSERT("the page try to dispose is in use. frame:%s", to_string(*used_frame).c_str());
@@ -413,17 +621,31 @@ RC BufferPoolIterator::init(FileBufferPool &bp, PageNum start_page /* = 0 */)
   } else {
     current_page_num_ = start_page;
   }
+  end_page_num_ = -1;
+  return RC::SUCCESS;
+}
+
+RC BufferPoolIterator::init_range(FileBufferPool &bp, PageNum begin_page, PageNum end_page)
+{
+  bitmap_.init(bp.file_header_->bitmap, bp.file_header_->page_count);
+  // 第0页是文件头，不是数据页面
+  current_page_num_ = std::max(begin_page, 1) - 1;
+  end_page_num_ = end_page;
   return RC::SUCCESS;
 }
 
 bool BufferPoolIterator::has_next()
 {
-  return bitmap_.next_setted_bit(current_page_num_ + 1) != -1;
+  PageNum next_page = bitmap_.next_setted_bit(current_page_num_ + 1);
+  return next_page != -1 && (end_page_num_ < 0 || next_page < end_page_num_);
 }
 
 PageNum BufferPoolIterator::next()
 {
   PageNum next_page = bitmap_.next_setted_bit(current_page_num_ + 1);
+  if (next_page != -1 && end_page_num_ >= 0 && next_page >= end_page_num_) {
+    next_page = -1;
+  }
   if (next_page != -1) {
     current_page_num_ = next_page;
   }
@@ -451,6 +673,9 @@ BufferPoolManager::BufferPoolManager(int memory_size /* = 0 */)
 
 BufferPoolManager::~BufferPoolManager()
 {
+  page_writer_.stop();
+  page_reader_.stop();
+
   std::unordered_map<std::string, FileBufferPool *> tmp_bps;
   tmp_bps.swap(buffer_pools_);
   for (auto &iter : tmp_bps) {
@@ -554,6 +779,8 @@ RC BufferPoolManager::close_file(const char *_file_name)
   buffer_pools_.erase(iter);
   lock_.unlock();
 
+  // 等待后台刷盘线程不再使用这个buffer pool
+  std::unique_lock<std::shared_mutex> pools_guard(pools_lock_);
   delete bp;
   return RC::SUCCESS;
 }
@@ -572,10 +799,97 @@ RC BufferPoolManager::flush_page(Frame &frame)
   auto iter = fd_buffer_pools_.find(fd);
   if (iter == fd_buffer_pools_.end()) {
     LOG_ERROR("Failed to flush page, due to not found buffer pool for file desc %d", fd);
+    lock_.unlock();
     return RC::NOTFOUND;
   }
+  FileBufferPool *bp = iter->second;
+  lock_.unlock();
+  return bp->flush_page_internal(frame);
+}
+
+RC BufferPoolManager::flush_all_pages()
+{
+  RC rc = RC::SUCCESS;
+  std::shared_lock<std::shared_mutex> pools_guard(pools_lock_);
+  for (FileBufferPool *bp : opened_buffer_pools()) {
+    RC _rc = bp->flush_all_pages();
+    if (_rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to flush all pages of %s, rc=%s", bp->file_name_.c_str(), strrc(_rc));
+      rc = _rc;
+    }
+  }
+  return rc;
+}
+
+int BufferPoolManager::write_dirty_pages(double target_clean_ratio)
+{
+  const size_t capacity = frame_manager_.capacity();
+  const size_t dirty_limit = capacity - static_cast<size_t>(capacity * target_clean_ratio);
+  std::vector<FrameId> dirty_frames = frame_manager_.find_dirty_list();
+  if (dirty_frames.size() <= dirty_limit) {
+    return 0;
+  }
+
+  const size_t need = dirty_frames.size() - dirty_limit;
+  size_t written_num = 0;
+  std::shared_lock<std::shared_mutex> pools_guard(pools_lock_);
+  for (const FrameId &frame_id : dirty_frames) {
+    if (written_num >= need) {
+      break;
+    }
+
+    FileBufferPool *bp = nullptr;
+    lock_.lock();
+    auto iter = fd_buffer_pools_.find(frame_id.file_desc());
+    if (iter != fd_buffer_pools_.end()) {
+      bp = iter->second;
+    }
+    lock_.unlock();
+    if (bp == nullptr) {
+      continue;
+    }
+
+    bool written = false;
+    RC rc = bp->write_page(frame_id.page_num(), true /*skip_pinned*/, written);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("Failed to write dirty page %s, rc=%s", to_string(frame_id).c_str(), strrc(rc));
+      continue;
+    }
+    if (written) {
+      written_num++;
+    }
+  }
+  LOG_TRACE("write dirty pages done. dirty=%d, need=%d, written=%d", dirty_frames.size(), need, written_num);
+  return static_cast<int>(written_num);
+}
+
+RC BufferPoolManager::load_pages(FileBufferPool *bp, PageNum start_page, int page_count)
+{
+  std::shared_lock<std::shared_mutex> pools_guard(pools_lock_);
+  bool opened = false;
+  lock_.lock();
+  for (auto &iter : fd_buffer_pools_) {
+    if (iter.second == bp) {
+      opened = true;
+      break;
+    }
+  }
   lock_.unlock();
-  return iter->second->flush_page(frame);
+  if (!opened) {
+    return RC::NOTFOUND;
+  }
+  return bp->load_pages(start_page, page_count);
+}
+
+std::vector<FileBufferPool *> BufferPoolManager::opened_buffer_pools()
+{
+  std::vector<FileBufferPool *> bps;
+  std::scoped_lock lock_guard(lock_);
+  bps.reserve(buffer_pools_.size());
+  for (auto &iter : buffer_pools_) {
+    bps.push_back(iter.second);
+  }
+  return bps;
 }
 
 static BufferPoolManager *default_bpm = nullptr;
@@ -1,5 +1,10 @@
 #include "include/storage_engine/buffer/frame.h"
 
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
 using namespace std;
 
 FrameId::FrameId(int file_desc, PageNum page_num) : file_desc_(file_desc), page_num_(page_num) {}
@@ -50,6 +55,238 @@ int Frame::unpin()
   return pin_count;
 }
 
+#ifdef DEBUG_LATCH
+namespace {
+
+/**
+ * @brief 记录每个线程持有和等待的页帧锁，用来检查死锁
+ * @details 只在 DEBUG_LATCH 编译选项下使用。线程在等待页帧锁之前，沿着"等待的页帧 -> 持有这个页帧的线程
+ * -> 这个线程正在等待的页帧"查找，如果回到了自己，就是死锁。所有操作都加一把全局锁，只用于调试。
+ */
+class LatchTracer
+{
+public:
+  static LatchTracer &instance()
+  {
+    static LatchTracer tracer;
+    return tracer;
+  }
+
+  void wait(const Frame *frame, bool exclusive)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    const thread::id me = this_thread::get_id();
+    std::set<thread::id> visited;
+    std::stringstream path;
+    if (find_cycle(me, frame, exclusive, visited, path)) {
+      LOG_PANIC("found frame latch deadlock. thread %s waits for %s latch of %s. wait path: %s",
+                thread_name(me).c_str(), exclusive ? "write" : "read", to_string(*frame).c_str(), path.str().c_str());
+      abort();
+    }
+    waiting_[me] = Waiting{frame, exclusive};
+  }
+
+  void acquired(const Frame *frame, bool exclusive)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    const thread::id me = this_thread::get_id();
+    waiting_.erase(me);
+    Holders &holders = holders_[frame];
+    if (exclusive) {
+      holders.writer = me;
+    } else {
+      holders.readers[me]++;
+    }
+  }
+
+  void released(const Frame *frame, bool exclusive)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto iter = holders_.find(frame);
+    if (iter == holders_.end()) {
+      return;
+    }
+    Holders &holders = iter->second;
+    if (exclusive) {
+      holders.writer = thread::id();
+    } else {
+      auto reader = holders.readers.find(this_thread::get_id());
+      if (reader != holders.readers.end() && --reader->second == 0) {
+        holders.readers.erase(reader);
+      }
+    }
+    if (holders.writer == thread::id() && holders.readers.empty()) {
+      holders_.erase(iter);
+    }
+  }
+
+private:
+  struct Holders
+  {
+    thread::id writer;
+    std::map<thread::id, int> readers;
+  };
+
+  struct Waiting
+  {
+    const Frame *frame = nullptr;
+    bool exclusive = false;
+  };
+
+  static std::string thread_name(thread::id id)
+  {
+    std::stringstream ss;
+    ss << id;
+    return ss.str();
+  }
+
+  /**
+   * @brief 查找阻塞了当前请求的线程中，是否有线程直接或者间接地在等待 me
+   */
+  bool find_cycle(thread::id me, const Frame *frame, bool exclusive, std::set<thread::id> &visited,
+                  std::stringstream &path)
+  {
+    auto iter = holders_.find(frame);
+    if (iter == holders_.end()) {
+      return false;
+    }
+
+    std::vector<thread::id> blockers;
+    if (iter->second.writer != thread::id()) {
+      blockers.push_back(iter->second.writer);
+    }
+    if (exclusive) {
+      for (const auto &reader : iter->second.readers) {
+        blockers.push_back(reader.first);
+      }
+    }
+
+    for (thread::id blocker : blockers) {
+      if (blocker == me) {
+        path << "[" << to_string(*frame) << " held by thread " << blocker << "]";
+        return true;
+      }
+      if (!visited.insert(blocker).second) {
+        continue;
+      }
+      auto waiting = waiting_.find(blocker);
+      if (waiting == waiting_.end()) {
+        continue;
+      }
+      if (find_cycle(me, waiting->second.frame, waiting->second.exclusive, visited, path)) {
+        path << " <- [" << to_string(*frame) << " held by thread " << blocker << "]";
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  std::mutex mutex_;
+  std::unordered_map<const Frame *, Holders> holders_;
+  std::unordered_map<thread::id, Waiting> waiting_;
+};
+
+}  // namespace
+#endif  // DEBUG_LATCH
+
+void Frame::write_latch()
+{
+  if (write_locker_.load() == this_thread::get_id()) {
+    write_recursive_count_++;
+    return;
+  }
+
+#ifdef DEBUG_LATCH
+  LatchTracer::instance().wait(this, true /*exclusive*/);
+#endif
+  lock_.lock();
+  write_locker_.store(this_thread::get_id());
+  write_recursive_count_ = 1;
+#ifdef DEBUG_LATCH
+  LatchTracer::instance().acquired(this, true /*exclusive*/);
+#endif
+}
+
+bool Frame::try_write_latch()
+{
+  if (write_locker_.load() == this_thread::get_id()) {
+    write_recursive_count_++;
+    return true;
+  }
+
+  if (!lock_.try_lock()) {
+    return false;
+  }
+  write_locker_.store(this_thread::get_id());
+  write_recursive_count_ = 1;
+#ifdef DEBUG_LATCH
+  LatchTracer::instance().acquired(this, true /*exclusive*/);
+#endif
+  return true;
+}
+
+void Frame::write_unlatch()
+{
+  ASSERT(write_locker_.load() == this_thread::get_id(), "frame is not write latched by this thread. frame=%s",
+         to_string(*this).c_str());
+  if (--write_recursive_count_ > 0) {
+    return;
+  }
+
+#ifdef DEBUG_LATCH
+  LatchTracer::instance().released(this, true /*exclusive*/);
+#endif
+  write_locker_.store(thread::id());
+  lock_.unlock();
+}
+
+void Frame::read_latch()
+{
+  // 已经持有写锁时不需要再加读锁
+  if (write_locker_.load() == this_thread::get_id()) {
+    write_recursive_count_++;
+    return;
+  }
+
+#ifdef DEBUG_LATCH
+  LatchTracer::instance().wait(this, false /*exclusive*/);
+#endif
+  lock_.lock_shared();
+#ifdef DEBUG_LATCH
+  LatchTracer::instance().acquired(this, false /*exclusive*/);
+#endif
+}
+
+bool Frame::try_read_latch()
+{
+  if (write_locker_.load() == this_thread::get_id()) {
+    write_recursive_count_++;
+    return true;
+  }
+
+  if (!lock_.try_lock_shared()) {
+    return false;
+  }
+#ifdef DEBUG_LATCH
+  LatchTracer::instance().acquired(this, false /*exclusive*/);
+#endif
+  return true;
+}
+
+void Frame::read_unlatch()
+{
+  if (write_locker_.load() == this_thread::get_id()) {
+    write_unlatch();
+    return;
+  }
+
+#ifdef DEBUG_LATCH
+  LatchTracer::instance().released(this, false /*exclusive*/);
+#endif
+  lock_.unlock_shared();
+}
+
 void Frame::access()
 {
   struct timespec tp;
@@ -7,6 +7,8 @@ RC FrameManager::init(int pool_num)
 {
   int ret = allocator_.init(false, pool_num);
   if (ret == 0) {
+    // 试用队列最多占用每个分片平均容量的1/4
+    probation_limit_ = std::max(allocator_.get_size() / SHARD_NUM / 4, 1);
     return RC::SUCCESS;
   }
   return RC::NOMEM;
@@ -14,18 +16,24 @@ RC FrameManager::init(int pool_num)
 
 RC FrameManager::cleanup()
 {
-  if (frames_.count() > 0) {
+  if (frame_num_.load() > 0) {
     return RC::INTERNAL;
   }
-  frames_.destroy();
+  for (Shard &shard : shards_) {
+    std::unique_lock<std::shared_mutex> lock_guard(shard.lock);
+    shard.frames.clear();
+    shard.probation.clear();
+    shard.protected_.clear();
+  }
   return RC::SUCCESS;
 }
 
 Frame *FrameManager::alloc(int file_desc, PageNum page_num)
 {
   FrameId frame_id(file_desc, page_num);
-  std::lock_guard<std::mutex> lock_guard(lock_);
-  Frame *frame = get_internal(frame_id);
+  Shard &shard = shard_of(frame_id);
+  std::unique_lock<std::shared_mutex> lock_guard(shard.lock);
+  Frame *frame = get_internal(shard, frame_id);
   if (frame != nullptr) {
     return frame;
   }
@@ -34,18 +42,27 @@ Frame *FrameManager::alloc(int file_desc, PageNum page_num)
   if (frame != nullptr) {
     ASSERT(frame->pin_count() == 0, "got an invalid frame that pin count is not 0. frame=%s",
         to_string(*frame).c_str());
+    frame->set_file_desc(file_desc);
     frame->set_page_num(page_num);
     frame->pin();
-    frames_.put(frame_id, frame);
+
+    // 新加载的页面先放到试用队列中
+    FrameEntry entry;
+    entry.frame = frame;
+    entry.in_protected = false;
+    entry.pos = shard.probation.insert(shard.probation.end(), frame);
+    shard.frames.emplace(frame_id, entry);
+    ++frame_num_;
   }
   return frame;
 }
 
-Frame *FrameManager::get(int file_desc, PageNum page_num)
+Frame *FrameManager::get(int file_desc, PageNum page_num, bool touch /* = true */)
 {
   FrameId frame_id(file_desc, page_num);
-  std::lock_guard<std::mutex> lock_guard(lock_);
-  return get_internal(frame_id);
+  Shard &shard = shard_of(frame_id);
+  std::shared_lock<std::shared_mutex> lock_guard(shard.lock);
+  return get_internal(shard, frame_id, touch);
 }
 
 /**
@@ -54,77 +71,170 @@ Frame *FrameManager::get(int file_desc, PageNum page_num)
 int FrameManager::evict_frames(int count, std::function<RC(Frame *frame)> evict_action)
 {
   int evicted = 0;
-  std::lock_guard<std::mutex> lock_guard(lock_);
-  std::vector<std::pair<FrameId, Frame *>> evictable_frames;
-  frames_.foreach_reverse([&evictable_frames,count](const FrameId &frame_id, Frame *frame) -> bool {
-    if (frame->can_evict()) {
-      evictable_frames.push_back(std::make_pair(frame_id, frame));
+  // 每次从不同的分片开始，避免总是驱逐同一个分片上的页帧
+  const unsigned int start = static_cast<unsigned int>(evict_cursor_.fetch_add(1));
+  // 所有的分片共用一个allocator，所以要在所有分片上按照同样的优先级来挑选：
+  // 第0轮只从超过长度限制的试用队列中驱逐；
+  // 第1、2轮在保护队列上执行CLOCK，每轮时钟指针最多转一圈，第二轮时第一轮清除过引用标记的页帧就可以被驱逐了；
+  // 第3轮不管试用队列的长度，只要能驱逐就驱逐。
+  for (int round = 0; round < 4 && evicted < count; round++) {
+    for (int i = 0; i < SHARD_NUM && evicted < count; i++) {
+      Shard &shard = shards_[(start + i) % SHARD_NUM];
+      std::unique_lock<std::shared_mutex> lock_guard(shard.lock);
+      if (round == 0) {
+        if (shard.probation.size() >= probation_limit_) {
+          evicted += evict_from_probation(shard, count - evicted, evict_action);
+        }
+      } else if (round < 3) {
+        evicted += evict_from_protected(shard, count - evicted, evict_action);
+      } else {
+        evicted += evict_from_probation(shard, count - evicted, evict_action);
+      }
     }
-    return evictable_frames.size() < count;
-  });
-  for (auto &[frame_id, frame] : evictable_frames) {
-    RC rc = evict_action(frame);
-    if (rc == RC::SUCCESS) {
-      frames_.remove(frame_id);
-      allocator_.free(frame);
+  }
+  return evicted;
+}
+
+/**
+ * @brief 按照FIFO的顺序从试用队列中驱逐页帧
+ * @details 在试用队列期间被再次访问过的页帧不会被驱逐，而是提升到保护队列
+ */
+int FrameManager::evict_from_probation(Shard &shard, int count, std::function<RC(Frame *frame)> &evict_action)
+{
+  int evicted = 0;
+  auto iter = shard.probation.begin();
+  while (iter != shard.probation.end() && evicted < count) {
+    Frame *frame = *iter;
+    auto next = std::next(iter);
+    if (!frame->can_evict()) {
+      // 正在使用中
+    } else if (frame->referenced()) {
+      frame->clear_referenced();
+      shard.frames.at(frame->frame_id()).in_protected = true;
+      // splice 不会使迭代器失效，FrameEntry::pos 仍然有效
+      shard.protected_.splice(shard.protected_.end(), shard.probation, iter);
+    } else if (evict_one(shard, frame, evict_action)) {
       evicted++;
     }
-    else
-    {
-      LOG_ERROR("Failed to execute evict action on frame %s, rc=%s", to_string(frame_id).c_str(), strrc(rc));
+    iter = next;
+  }
+  return evicted;
+}
+
+/**
+ * @brief 使用CLOCK算法从保护队列中驱逐页帧
+ * @details 队列头就是时钟指针的位置，指针经过的页帧会被挪到队尾。
+ * 有引用标记的页帧会清除标记，得到第二次机会。
+ */
+int FrameManager::evict_from_protected(Shard &shard, int count, std::function<RC(Frame *frame)> &evict_action)
+{
+  int evicted = 0;
+  size_t steps = shard.protected_.size();
+  while (steps-- > 0 && evicted < count && !shard.protected_.empty()) {
+    auto iter = shard.protected_.begin();
+    Frame *frame = *iter;
+    if (frame->can_evict() && !frame->referenced() && evict_one(shard, frame, evict_action)) {
+      evicted++;
+      continue;
     }
+    frame->clear_referenced();
+    shard.protected_.splice(shard.protected_.end(), shard.protected_, iter);
   }
   return evicted;
 }
 
-Frame *FrameManager::get_internal(const FrameId &frame_id)
+bool FrameManager::evict_one(Shard &shard, Frame *frame, std::function<RC(Frame *frame)> &evict_action)
 {
-  Frame *frame = nullptr;
-  (void)frames_.get(frame_id, frame);
-  if (frame != nullptr) {
-    frame->pin();
+  const FrameId frame_id = frame->frame_id();
+  RC rc = evict_action(frame);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to execute evict action on frame %s, rc=%s", to_string(frame_id).c_str(), strrc(rc));
+    return false;
+  }
+
+  auto iter = shard.frames.find(frame_id);
+  ASSERT(iter != shard.frames.end() && iter->second.frame == frame,
+         "failed to find the frame to evict. frame=%s", to_string(*frame).c_str());
+  FrameList &list = iter->second.in_protected ? shard.protected_ : shard.probation;
+  list.erase(iter->second.pos);
+  shard.frames.erase(iter);
+  --frame_num_;
+  allocator_.free(frame);
+  return true;
+}
+
+Frame *FrameManager::get_internal(Shard &shard, const FrameId &frame_id, bool touch /* = true */)
+{
+  auto iter = shard.frames.find(frame_id);
+  if (iter == shard.frames.end()) {
+    return nullptr;
+  }
+  Frame *frame = iter->second.frame;
+  frame->pin();
+  if (touch && !frame->clear_prefetched()) {
+    frame->mark_referenced();
   }
   return frame;
 }
 
 /**
  * @brief 查找目标文件的frame
- * FramesCache中选出所有与给定文件描述符(file_desc)相匹配的Frame对象，并将它们添加到列表中
+ * 从所有分片中选出所有与给定文件描述符(file_desc)相匹配的Frame对象，并将它们添加到列表中
  */
 std::list<Frame *> FrameManager::find_list(int file_desc)
 {
-  std::lock_guard<std::mutex> lock_guard(lock_);
-
   std::list<Frame *> frames;
-  auto fetcher = [&frames, file_desc](const FrameId &frame_id, Frame *const frame) -> bool {
-    if (file_desc == frame_id.file_desc()) {
-      frame->pin();
-      frames.push_back(frame);
+  for (Shard &shard : shards_) {
+    std::shared_lock<std::shared_mutex> lock_guard(shard.lock);
+    for (auto &[frame_id, entry] : shard.frames) {
+      if (file_desc == frame_id.file_desc()) {
+        entry.frame->pin();
+        frames.push_back(entry.frame);
+      }
     }
-    return true;
-  };
-  frames_.foreach (fetcher);
+  }
   return frames;
 }
 
+std::vector<FrameId> FrameManager::find_dirty_list(int file_desc /* = -1 */)
+{
+  std::vector<FrameId> frame_ids;
+  for (Shard &shard : shards_) {
+    std::shared_lock<std::shared_mutex> lock_guard(shard.lock);
+    for (const FrameList *list : {&shard.probation, &shard.protected_}) {
+      for (Frame *frame : *list) {
+        if (frame->dirty() && (file_desc < 0 || frame->file_desc() == file_desc)) {
+          frame_ids.push_back(frame->frame_id());
+        }
+      }
+    }
+  }
+  return frame_ids;
+}
+
 RC FrameManager::free(int file_desc, PageNum page_num, Frame *frame)
 {
   FrameId frame_id(file_desc, page_num);
+  Shard &shard = shard_of(frame_id);
 
-  std::lock_guard<std::mutex> lock_guard(lock_);
-  return free_internal(frame_id, frame);
+  std::unique_lock<std::shared_mutex> lock_guard(shard.lock);
+  return free_internal(shard, frame_id, frame);
 }
 
-RC FrameManager::free_internal(const FrameId &frame_id, Frame *frame)
+RC FrameManager::free_internal(Shard &shard, const FrameId &frame_id, Frame *frame)
 {
-  Frame *frame_source = nullptr;
-  [[maybe_unused]] bool found = frames_.get(frame_id, frame_source);
+  auto iter = shard.frames.find(frame_id);
+  [[maybe_unused]] bool found = iter != shard.frames.end();
+  [[maybe_unused]] Frame *frame_source = found ? iter->second.frame : nullptr;
   ASSERT(found && frame == frame_source && frame->pin_count() == 1,
          "failed to free frame. found=%d, frameId=%s, frame_source=%p, frame=%p, pinCount=%d, lbt=%s",
          found, to_string(frame_id).c_str(), frame_source, frame, frame->pin_count(), lbt());
 
   frame->unpin();
-  frames_.remove(frame_id);
+  FrameList &list = iter->second.in_protected ? shard.protected_ : shard.probation;
+  list.erase(iter->second.pos);
+  shard.frames.erase(iter);
+  --frame_num_;
   allocator_.free(frame);
   return RC::SUCCESS;
-}
\ No newline at end of file
+}
@@ -0,0 +1,84 @@
+#include "include/storage_engine/buffer/page_reader.h"
+#include "include/storage_engine/buffer/buffer_pool.h"
+
+PageReader::PageReader(BufferPoolManager &bp_manager) : bp_manager_(bp_manager)
+{}
+
+PageReader::~PageReader()
+{
+  stop();
+}
+
+RC PageReader::start(int thread_num /* = DEFAULT_THREAD_NUM */)
+{
+#ifndef CONCURRENCY
+  LOG_INFO("page reader threads are disabled without CONCURRENCY, read ahead synchronously");
+  return RC::SUCCESS;
+#endif
+
+  std::lock_guard<std::mutex> lock_guard(lock_);
+  if (running_) {
+    LOG_WARN("page reader has been started");
+    return RC::INTERNAL;
+  }
+
+  running_ = true;
+  for (int i = 0; i < std::max(thread_num, 1); i++) {
+    threads_.emplace_back(&PageReader::run, this);
+  }
+  LOG_INFO("page reader started. thread num=%d", threads_.size());
+  return RC::SUCCESS;
+}
+
+void PageReader::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock_guard(lock_);
+    if (!running_) {
+      return;
+    }
+    running_ = false;
+    requests_.clear();
+  }
+  cond_.notify_all();
+  for (std::thread &thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+  LOG_INFO("page reader stopped");
+}
+
+void PageReader::submit(FileBufferPool *bp, PageNum start_page, int page_count)
+{
+  {
+    std::lock_guard<std::mutex> lock_guard(lock_);
+    if (running_) {
+      if (static_cast<int>(requests_.size()) < MAX_PENDING_NUM) {
+        requests_.push_back(Request{bp, start_page, page_count});
+        cond_.notify_one();
+      }
+      return;
+    }
+  }
+
+  // 没有后台线程时直接读，至少可以把多次读合并成一次
+  bp_manager_.load_pages(bp, start_page, page_count);
+}
+
+void PageReader::run()
+{
+  std::unique_lock<std::mutex> lock_guard(lock_);
+  while (true) {
+    cond_.wait(lock_guard, [this]() { return !running_ || !requests_.empty(); });
+    if (!running_) {
+      break;
+    }
+
+    Request request = requests_.front();
+    requests_.pop_front();
+
+    lock_guard.unlock();
+    bp_manager_.load_pages(request.bp, request.start_page, request.page_count);
+    lock_guard.lock();
+  }
+}
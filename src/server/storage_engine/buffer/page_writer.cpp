@@ -0,0 +1,71 @@
+#include "include/storage_engine/buffer/page_writer.h"
+#include "include/storage_engine/buffer/buffer_pool.h"
+
+PageWriter::PageWriter(BufferPoolManager &bp_manager) : bp_manager_(bp_manager)
+{}
+
+PageWriter::~PageWriter()
+{
+  stop();
+}
+
+RC PageWriter::start(int interval_ms /* = DEFAULT_INTERVAL_MS */,
+                     double target_clean_ratio /* = DEFAULT_TARGET_CLEAN_RATIO */)
+{
+#ifndef CONCURRENCY
+  LOG_INFO("page writer is disabled without CONCURRENCY");
+  return RC::SUCCESS;
+#endif
+
+  std::lock_guard<std::mutex> lock_guard(lock_);
+  if (running_) {
+    LOG_WARN("page writer has been started");
+    return RC::INTERNAL;
+  }
+
+  interval_ms_ = std::max(interval_ms, 1);
+  target_clean_ratio_ = target_clean_ratio;
+  running_ = true;
+  thread_ = std::thread(&PageWriter::run, this);
+  LOG_INFO("page writer started. interval=%dms, target clean ratio=%f", interval_ms_, target_clean_ratio);
+  return RC::SUCCESS;
+}
+
+void PageWriter::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock_guard(lock_);
+    if (!running_) {
+      return;
+    }
+    running_ = false;
+  }
+  cond_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  LOG_INFO("page writer stopped");
+}
+
+int PageWriter::run_once()
+{
+  return bp_manager_.write_dirty_pages(target_clean_ratio_.load());
+}
+
+void PageWriter::run()
+{
+  std::unique_lock<std::mutex> lock_guard(lock_);
+  while (running_) {
+    cond_.wait_for(lock_guard, std::chrono::milliseconds(interval_ms_), [this]() { return !running_; });
+    if (!running_) {
+      break;
+    }
+
+    lock_guard.unlock();
+    int written = run_once();
+    if (written > 0) {
+      LOG_DEBUG("page writer wrote %d dirty pages", written);
+    }
+    lock_guard.lock();
+  }
+}
@@ -3,6 +3,10 @@
 #include "common/log/log.h"
 #include "common/lang/lower_bound.h"
 
+#include <numeric>
+#include <thread>
+#include <type_traits>
+
 using namespace std;
 using namespace common;
 
@@ -23,6 +27,34 @@ int calc_leaf_page_capacity(int attr_length)
   return capacity;
 }
 
+/**
+ * 压缩格式下每一项至少保存一个字节的键，按照这个计算项数的上限，实际能放下多少项由压缩以后的大小决定
+ */
+int calc_compressed_page_capacity(int header_size, int value_size)
+{
+  return ((int)BP_PAGE_DATA_SIZE - header_size - CompressedKeyHeader::HEADER_SIZE) / (value_size + 1);
+}
+
+/**
+ * 键中最后一个非0字节之后的位置，后面的0在压缩格式中不需要保存
+ */
+static int key_significant_length(const char *key, int length)
+{
+  while (length > 0 && key[length - 1] == 0) {
+    length--;
+  }
+  return length;
+}
+
+static int common_prefix_length(const char *key1, const char *key2, int length)
+{
+  int i = 0;
+  while (i < length && key1[i] == key2[i]) {
+    i++;
+  }
+  return i;
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 IndexNodeHandler::IndexNodeHandler(const IndexFileHeader &header, Frame *frame)
     : header_(header), page_num_(frame->page_num()), node_((IndexNode *)frame->data())
@@ -32,6 +64,10 @@ bool IndexNodeHandler::is_leaf() const
 {
   return node_->is_leaf;
 }
+bool IndexNodeHandler::compressed() const
+{
+  return header_.key_compressed;
+}
 void IndexNodeHandler::init_empty(bool leaf)
 {
   node_->is_leaf = leaf;
@@ -50,7 +86,7 @@ int IndexNodeHandler::key_size() const
 
 int IndexNodeHandler::value_size() const
 {
-  return sizeof(RID);
+  return is_leaf() ? sizeof(RID) : sizeof(PageNum);
 }
 
 int IndexNodeHandler::item_size() const
@@ -71,7 +107,13 @@ int IndexNodeHandler::max_size() const
 int IndexNodeHandler::min_size() const
 {
   const int max = this->max_size();
-  return max - max/2;
+  int min = max - max/2;
+  if (compressed()) {
+    // 压缩格式下项数的上限很大，按照不压缩时的容量计算，保证不足 min_size 的节点总能合并或者从兄弟节点借一项
+    const int capacity = uncompressed_capacity();
+    min = std::min(min, capacity - capacity / 2);
+  }
+  return min;
 }
 
 void IndexNodeHandler::increase_size(int n)
@@ -101,6 +143,10 @@ bool IndexNodeHandler::is_safe(BplusTreeOperationType op, bool is_root_node)
       return true;
     } break;
     case BplusTreeOperationType::INSERT: {
+      if (compressed()) {
+        // 不知道会插入什么键，按照完全不能压缩的情况估计
+        return size() < max_size() && size() < uncompressed_capacity();
+      }
       return size() < max_size();
     } break;
     case BplusTreeOperationType::DELETE: {
@@ -122,6 +168,373 @@ bool IndexNodeHandler::is_safe(BplusTreeOperationType op, bool is_root_node)
   return false;
 }
 
+bool IndexNodeHandler::can_insert(const char *key, int fill_factor /* = 100 */) const
+{
+  if (size() >= max_size()) {
+    return false;
+  }
+  if (!compressed() || size() == 0) {
+    return true;
+  }
+
+  const int capacity = array_capacity() * fill_factor / 100;
+  const CompressedKeyHeader *header = compressed_header();
+  if (key_in_window(key) && packed_size(size() + 1, header->prefix_len, header->attr_end) <= capacity) {
+    return true;
+  }
+
+  // 公共前缀变短或者有效长度变长，按照重新压缩以后的大小计算
+  std::vector<char> items(static_cast<size_t>(size() + 1) * item_size(), 0);
+  read_items(0, size(), items.data());
+  memcpy(items.data() + static_cast<size_t>(size()) * item_size(), key, key_size());
+  int prefix_len = 0;
+  int attr_end = 0;
+  key_window(items.data(), size() + 1, prefix_len, attr_end);
+  return packed_size(size() + 1, prefix_len, attr_end) <= capacity;
+}
+
+bool IndexNodeHandler::can_merge(const IndexNodeHandler &other) const
+{
+  const int num = size() + other.size();
+  if (num > max_size()) {
+    return false;
+  }
+  if (!compressed()) {
+    return true;
+  }
+
+  std::vector<char> items(static_cast<size_t>(num) * item_size());
+  read_items(0, size(), items.data());
+  other.read_items(0, other.size(), items.data() + static_cast<size_t>(size()) * item_size());
+  return fits(items.data(), num);
+}
+
+void IndexNodeHandler::read_items(int begin, int end, char *items) const
+{
+  if (end <= begin) {
+    return;
+  }
+  if (!compressed()) {
+    memcpy(items, item_at(begin), static_cast<size_t>(end - begin) * item_size());
+    return;
+  }
+
+  for (int i = begin; i < end; i++, items += item_size()) {
+    read_key(i, items);
+    memcpy(items + key_size(), value_ptr(i), value_size());
+  }
+}
+
+bool IndexNodeHandler::fits(const char *items, int num) const
+{
+  if (num > max_size()) {
+    return false;
+  }
+  if (!compressed()) {
+    return true;
+  }
+
+  int prefix_len = 0;
+  int attr_end = 0;
+  key_window(items, num, prefix_len, attr_end);
+  return packed_size(num, prefix_len, attr_end) <= array_capacity();
+}
+
+bool IndexNodeHandler::write_items(const char *items, int num)
+{
+  if (!fits(items, num)) {
+    return false;
+  }
+
+  node_->key_num = num;
+  if (!compressed()) {
+    if (num > 0) {
+      memcpy(array(), items, static_cast<size_t>(num) * item_size());
+    }
+    return true;
+  }
+
+  CompressedKeyHeader *header = compressed_header();
+  int prefix_len = 0;
+  int attr_end = 0;
+  key_window(items, num, prefix_len, attr_end);
+  header->prefix_len = static_cast<int16_t>(prefix_len);
+  header->attr_end = static_cast<int16_t>(attr_end);
+  if (num > 0) {
+    memcpy(header->prefix, items, prefix_len);
+  }
+
+  const int stored_key_size = this->stored_key_size();
+  for (int i = 0; i < num; i++) {
+    const char *src = items + static_cast<size_t>(i) * item_size();
+    char *item = item_at(i);
+    encode_key(src, item);
+    memcpy(item + stored_key_size, src + key_size(), value_size());
+  }
+  return true;
+}
+
+int IndexNodeHandler::split_point(const char *items, int num) const
+{
+  const int middle = num / 2;
+  for (int distance = 0; distance < num; distance++) {
+    for (int split : {middle - distance, middle + distance}) {
+      if (split < 1 || split >= num) {
+        continue;
+      }
+      if (fits(items, split) && fits(items + static_cast<size_t>(split) * item_size(), num - split)) {
+        return split;
+      }
+    }
+  }
+  return -1;
+}
+
+const char *IndexNodeHandler::read_key(int index, char *buffer) const
+{
+  if (!compressed()) {
+    return item_at(index);
+  }
+
+  const CompressedKeyHeader *header = compressed_header();
+  memcpy(buffer, header->prefix, header->prefix_len);
+  memset(buffer + header->attr_end, 0, gap_end(header->prefix_len) - header->attr_end);
+  decode_key(item_at(index), buffer);
+  return buffer;
+}
+
+char *IndexNodeHandler::value_ptr(int index) const
+{
+  return item_at(index) + stored_item_size() - value_size();
+}
+
+int IndexNodeHandler::lower_bound_key(const KeyComparator &comparator, const char *key, int begin, bool *found) const
+{
+  if (!compressed()) {
+    common::BinaryIterator<char> iter_begin(item_size(), item_at(begin));
+    common::BinaryIterator<char> iter_end(item_size(), item_at(size()));
+    common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
+    return begin + static_cast<int>(iter - iter_begin);
+  }
+
+  // 前缀和属性末尾的0对所有项都相同，每次比较只需要复制保存的部分
+  const CompressedKeyHeader *header = compressed_header();
+  char *probe = probe_buffer();
+  memcpy(probe, header->prefix, header->prefix_len);
+  memset(probe + header->attr_end, 0, gap_end(header->prefix_len) - header->attr_end);
+
+  int left = begin;
+  int right = size();
+  while (left < right) {
+    const int middle = left + (right - left) / 2;
+    decode_key(item_at(middle), probe);
+    if (comparator(probe, key) < 0) {
+      left = middle + 1;
+    } else {
+      right = middle;
+    }
+  }
+
+  if (found != nullptr) {
+    *found = false;
+    if (left < size()) {
+      decode_key(item_at(left), probe);
+      *found = comparator(probe, key) == 0;
+    }
+  }
+  return left;
+}
+
+void IndexNodeHandler::insert_item(int index, const char *key, const char *value)
+{
+  if (compressed()) {
+    const CompressedKeyHeader *header = compressed_header();
+    if (size() == 0 || !key_in_window(key) ||
+        packed_size(size() + 1, header->prefix_len, header->attr_end) > array_capacity()) {
+      // 需要重新计算公共前缀和有效长度，调用者已经用 can_insert 检查过能放得下
+      std::vector<char> items(static_cast<size_t>(size() + 1) * item_size());
+      read_items(0, index, items.data());
+      char *item = items.data() + static_cast<size_t>(index) * item_size();
+      memcpy(item, key, key_size());
+      memcpy(item + key_size(), value, value_size());
+      read_items(index, size(), item + item_size());
+      bool ok = write_items(items.data(), size() + 1);
+      ASSERT(ok, "no space to insert item. page num=%d, size=%d", page_num(), size());
+      return;
+    }
+  }
+
+  const int stored_item_size = this->stored_item_size();
+  const int stored_key_size = stored_item_size - value_size();
+  if (index < size()) {
+    memmove(item_at(index + 1), item_at(index), (static_cast<size_t>(size()) - index) * stored_item_size);
+  }
+  if (compressed()) {
+    encode_key(key, item_at(index));
+  } else {
+    memcpy(item_at(index), key, stored_key_size);
+  }
+  memcpy(item_at(index) + stored_key_size, value, value_size());
+  increase_size(1);
+}
+
+void IndexNodeHandler::remove_item(int index)
+{
+  assert(index >= 0 && index < size());
+  if (index < size() - 1) {
+    memmove(item_at(index), item_at(index + 1), (static_cast<size_t>(size()) - index - 1) * stored_item_size());
+  }
+  increase_size(-1);
+}
+
+bool IndexNodeHandler::can_set_key(int index, const char *key) const
+{
+  if (!compressed() || key_in_window(key)) {
+    return true;
+  }
+
+  std::vector<char> items(static_cast<size_t>(size()) * item_size());
+  read_items(0, size(), items.data());
+  memcpy(items.data() + static_cast<size_t>(index) * item_size(), key, key_size());
+  return fits(items.data(), size());
+}
+
+void IndexNodeHandler::set_key(int index, const char *key)
+{
+  if (!compressed()) {
+    memcpy(item_at(index), key, key_size());
+    return;
+  }
+
+  if (key_in_window(key)) {
+    encode_key(key, item_at(index));
+    return;
+  }
+
+  std::vector<char> items(static_cast<size_t>(size()) * item_size());
+  read_items(0, size(), items.data());
+  memcpy(items.data() + static_cast<size_t>(index) * item_size(), key, key_size());
+  bool ok = write_items(items.data(), size());
+  ASSERT(ok, "no space to set key. page num=%d, index=%d", page_num(), index);
+}
+
+char *IndexNodeHandler::key_buffer() const
+{
+  key_buffer_.resize(key_size());
+  return key_buffer_.data();
+}
+
+char *IndexNodeHandler::probe_buffer() const
+{
+  probe_buffer_.resize(key_size());
+  return probe_buffer_.data();
+}
+
+char *IndexNodeHandler::array() const
+{
+  const int header_size = is_leaf() ? LeafIndexNode::HEADER_SIZE : InternalIndexNode::HEADER_SIZE;
+  return reinterpret_cast<char *>(node_) + header_size;
+}
+
+int IndexNodeHandler::array_capacity() const
+{
+  const int header_size = is_leaf() ? LeafIndexNode::HEADER_SIZE : InternalIndexNode::HEADER_SIZE;
+  return static_cast<int>(BP_PAGE_DATA_SIZE) - header_size;
+}
+
+int IndexNodeHandler::uncompressed_capacity() const
+{
+  return (array_capacity() - CompressedKeyHeader::HEADER_SIZE) / item_size();
+}
+
+CompressedKeyHeader *IndexNodeHandler::compressed_header() const
+{
+  return reinterpret_cast<CompressedKeyHeader *>(array());
+}
+
+char *IndexNodeHandler::item_at(int index) const
+{
+  if (!compressed()) {
+    return array() + static_cast<size_t>(index) * item_size();
+  }
+  const CompressedKeyHeader *header = compressed_header();
+  return array() + CompressedKeyHeader::HEADER_SIZE + header->prefix_len +
+         static_cast<size_t>(index) * stored_item_size();
+}
+
+int IndexNodeHandler::stored_item_size() const
+{
+  if (!compressed()) {
+    return item_size();
+  }
+  return stored_key_size() + value_size();
+}
+
+int IndexNodeHandler::stored_key_size() const
+{
+  const CompressedKeyHeader *header = compressed_header();
+  return stored_key_size(header->prefix_len, header->attr_end);
+}
+
+int IndexNodeHandler::stored_key_size(int prefix_len, int attr_end) const
+{
+  return attr_end - prefix_len + key_size() - gap_end(prefix_len);
+}
+
+int IndexNodeHandler::gap_end(int prefix_len) const
+{
+  return std::max(header_.attrs_length, prefix_len);
+}
+
+void IndexNodeHandler::encode_key(const char *key, char *item) const
+{
+  const CompressedKeyHeader *header = compressed_header();
+  const int attr_part = header->attr_end - header->prefix_len;
+  const int gap_end = this->gap_end(header->prefix_len);
+  memcpy(item, key + header->prefix_len, attr_part);
+  memcpy(item + attr_part, key + gap_end, key_size() - gap_end);
+}
+
+void IndexNodeHandler::decode_key(const char *item, char *key) const
+{
+  const CompressedKeyHeader *header = compressed_header();
+  const int attr_part = header->attr_end - header->prefix_len;
+  const int gap_end = this->gap_end(header->prefix_len);
+  memcpy(key + header->prefix_len, item, attr_part);
+  memcpy(key + gap_end, item + attr_part, key_size() - gap_end);
+}
+
+bool IndexNodeHandler::key_in_window(const char *key) const
+{
+  const CompressedKeyHeader *header = compressed_header();
+  return memcmp(key, header->prefix, header->prefix_len) == 0 &&
+         key_significant_length(key, gap_end(header->prefix_len)) <= header->attr_end;
+}
+
+int IndexNodeHandler::packed_size(int num, int prefix_len, int attr_end) const
+{
+  return CompressedKeyHeader::HEADER_SIZE + prefix_len + num * (stored_key_size(prefix_len, attr_end) + value_size());
+}
+
+void IndexNodeHandler::key_window(const char *items, int num, int &prefix_len, int &attr_end) const
+{
+  prefix_len = 0;
+  attr_end = 0;
+  if (num <= 0) {
+    return;
+  }
+
+  prefix_len = key_size();
+  for (int i = 0; i < num; i++) {
+    const char *key = items + static_cast<size_t>(i) * item_size();
+    if (i > 0) {
+      prefix_len = common_prefix_length(items, key, prefix_len);
+    }
+    attr_end = std::max(attr_end, key_significant_length(key, header_.attrs_length));
+  }
+  attr_end = std::max(attr_end, prefix_len);
+}
+
 std::string to_string(const IndexNodeHandler &handler)
 {
   std::stringstream ss;
@@ -174,40 +587,27 @@ PageNum LeafIndexNodeHandler::next_page() const
 char *LeafIndexNodeHandler::key_at(int index)
 {
   assert(index >= 0 && index < size());
-  return __key_at(index);
+  return const_cast<char *>(read_key(index, key_buffer()));
 }
 
 char *LeafIndexNodeHandler::value_at(int index)
 {
   assert(index >= 0 && index < size());
-  return __value_at(index);
+  return value_ptr(index);
 }
 
 int LeafIndexNodeHandler::lookup(const KeyComparator &comparator, const char *key, bool *found /* = nullptr */) const
 {
-  const int size = this->size();
-  common::BinaryIterator<char> iter_begin(item_size(), __key_at(0));
-  common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
-  common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
-  return iter - iter_begin;
+  return lower_bound_key(comparator, key, 0, found);
 }
 
 void LeafIndexNodeHandler::insert(int index, const char *key, const char *value)
 {
-  if (index < size()) {
-    memmove(__item_at(index + 1), __item_at(index), (static_cast<size_t>(size()) - index) * item_size());
-  }
-  memcpy(__item_at(index), key, key_size());
-  memcpy(__item_at(index) + key_size(), value, value_size());
-  increase_size(1);
+  insert_item(index, key, value);
 }
 void LeafIndexNodeHandler::remove(int index)
 {
-  assert(index >= 0 && index < size());
-  if (index < size() - 1) {
-    memmove(__item_at(index), __item_at(index + 1), (static_cast<size_t>(size()) - index - 1) * item_size());
-  }
-  increase_size(-1);
+  remove_item(index);
 }
 
 int LeafIndexNodeHandler::remove(const char *key, const KeyComparator &comparator)
@@ -221,82 +621,50 @@ int LeafIndexNodeHandler::remove(const char *key, const KeyComparator &comparato
   return 0;
 }
 
-RC LeafIndexNodeHandler::move_half_to(LeafIndexNodeHandler &other, FileBufferPool *bp)
-{
-  const int size = this->size();
-  const int move_index = size / 2;
-
-  memcpy(other.__item_at(0), this->__item_at(move_index), static_cast<size_t>(item_size()) * (size - move_index));
-  other.increase_size(size - move_index);
-  this->increase_size(-(size - move_index));
-  return RC::SUCCESS;
-}
-
 RC LeafIndexNodeHandler::move_first_to_end(LeafIndexNodeHandler &other, FileBufferPool *bp)
 {
-  other.append(__item_at(0));
-
-  if (size() >= 1) {
-    memmove(__item_at(0), __item_at(1), (static_cast<size_t>(size()) - 1) * item_size());
-  }
-  increase_size(-1);
+  std::vector<char> item(item_size());
+  read_items(0, 1, item.data());
+  other.insert_item(other.size(), item.data(), item.data() + key_size());
+  remove_item(0);
   return RC::SUCCESS;
 }
 
 RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other, FileBufferPool *bp)
 {
-  other.preappend(__item_at(size() - 1));
-
-  increase_size(-1);
+  std::vector<char> item(item_size());
+  read_items(size() - 1, size(), item.data());
+  other.insert_item(0, item.data(), item.data() + key_size());
+  remove_item(size() - 1);
   return RC::SUCCESS;
 }
 
 RC LeafIndexNodeHandler::move_to(LeafIndexNodeHandler &other, FileBufferPool *bp)
 {
-  memcpy(other.__item_at(other.size()), this->__item_at(0), static_cast<size_t>(this->size()) * item_size());
-  other.increase_size(this->size());
+  const int num = other.size() + this->size();
+  std::vector<char> items(static_cast<size_t>(num) * item_size());
+  other.read_items(0, other.size(), items.data());
+  this->read_items(0, this->size(), items.data() + static_cast<size_t>(other.size()) * item_size());
+  if (!other.write_items(items.data(), num)) {
+    LOG_WARN("no space to move items to other node. this page num=%d, other page num=%d",
+             this->page_num(), other.page_num());
+    return RC::INTERNAL;
+  }
   this->increase_size(-this->size());
 
   other.set_next_page(this->next_page());
   return RC::SUCCESS;
 }
 
-void LeafIndexNodeHandler::append(const char *item)
-{
-  memcpy(__item_at(size()), item, item_size());
-  increase_size(1);
-}
-
-void LeafIndexNodeHandler::preappend(const char *item)
-{
-  if (size() > 0) {
-    memmove(__item_at(1), __item_at(0), static_cast<size_t>(size()) * item_size());
-  }
-  memcpy(__item_at(0), item, item_size());
-  increase_size(1);
-}
-
-char *LeafIndexNodeHandler::__item_at(int index) const
-{
-  return leaf_node_->array + (index * item_size());
-}
-char *LeafIndexNodeHandler::__key_at(int index) const
-{
-  return __item_at(index);
-}
-char *LeafIndexNodeHandler::__value_at(int index) const
-{
-  return __item_at(index) + key_size();
-}
-
 std::string to_string(const LeafIndexNodeHandler &handler, const KeyPrinter &printer)
 {
+  std::vector<char> key(handler.key_size());
   std::stringstream ss;
   ss << to_string((const IndexNodeHandler &)handler)
      << ",next page:" << handler.next_page();
-  ss << ",values=[" << printer(handler.__key_at(0));
-  for (int i = 1; i < handler.size(); i++) {
-    ss << "," << printer(handler.__key_at(i));
+  ss << ",values=[";
+  for (int i = 0; i < handler.size(); i++) {
+    ss << (i == 0 ? "" : ",") << printer(handler.read_key(i, key.data()));
   }
   ss << "]";
   return ss.str();
@@ -309,9 +677,11 @@ bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, FileBufferP
     return false;
   }
 
+  std::vector<char> prev_key(key_size());
+  std::vector<char> key(key_size());
   const int node_size = size();
   for (int i = 1; i < node_size; i++) {
-    if (comparator(__key_at(i - 1), __key_at(i)) >= 0) {
+    if (comparator(read_key(i - 1, prev_key.data()), read_key(i, key.data())) >= 0) {
       LOG_WARN("page number = %d, invalid key order. id1=%d,id2=%d, this=%s",
                page_num(), i - 1, i, to_string(*this).c_str());
       return false;
@@ -340,7 +710,7 @@ bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, FileBufferP
   }
 
   if (0 != index_in_parent) {
-    int cmp_result = comparator(__key_at(0), parent_node.key_at(index_in_parent));
+    int cmp_result = comparator(read_key(0, key.data()), parent_node.key_at(index_in_parent));
     if (cmp_result < 0) {
       LOG_WARN("invalid leaf node. first item should be greate than or equal to parent item. "
           "this page num=%d, parent page num=%d, index in parent=%d",
@@ -351,7 +721,7 @@ bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, FileBufferP
   }
 
   if (index_in_parent < parent_node.size() - 1) {
-    int cmp_result = comparator(__key_at(size() - 1), parent_node.key_at(index_in_parent + 1));
+    int cmp_result = comparator(read_key(size() - 1, key.data()), parent_node.key_at(index_in_parent + 1));
     if (cmp_result >= 0) {
       LOG_WARN("invalid leaf node. last item should be less than the item at the first after item in parent."
           "this page num=%d, parent page num=%d, parent item to compare=%d",
@@ -371,14 +741,14 @@ InternalIndexNodeHandler::InternalIndexNodeHandler(const IndexFileHeader &header
 
 std::string to_string(const InternalIndexNodeHandler &node, const KeyPrinter &printer)
 {
+  std::vector<char> key(node.key_size());
   std::stringstream ss;
   ss << to_string((const IndexNodeHandler &)node);
-  ss << ",children:["
-     << "{key:" << printer(node.__key_at(0)) << ","
-     << "value:" << *(PageNum *)node.__value_at(0) << "}";
-
-  for (int i = 1; i < node.size(); i++) {
-    ss << ",{key:" << printer(node.__key_at(i)) << ",value:" << *(PageNum *)node.__value_at(i) << "}";
+  ss << ",children:[";
+  for (int i = 0; i < node.size(); i++) {
+    PageNum page_num;
+    memcpy(&page_num, node.value_ptr(i), sizeof(page_num));
+    ss << (i == 0 ? "" : ",") << "{key:" << printer(node.read_key(i, key.data())) << ",value:" << page_num << "}";
   }
   ss << "]";
   return ss.str();
@@ -390,11 +760,15 @@ void InternalIndexNodeHandler::init_empty()
 }
 void InternalIndexNodeHandler::create_new_root(PageNum first_page_num, const char *key, PageNum page_num)
 {
-  memset(__key_at(0), 0, key_size());
-  memcpy(__value_at(0), &first_page_num, value_size());
-  memcpy(__item_at(1), key, key_size());
-  memcpy(__value_at(1), &page_num, value_size());
-  increase_size(2);
+  // 第一个键不会被使用。压缩格式下与第二个键相同，不影响公共前缀
+  std::vector<char> items(static_cast<size_t>(2) * item_size(), 0);
+  if (compressed()) {
+    memcpy(items.data(), key, key_size());
+  }
+  memcpy(items.data() + key_size(), &first_page_num, value_size());
+  memcpy(items.data() + item_size(), key, key_size());
+  memcpy(items.data() + item_size() + key_size(), &page_num, value_size());
+  write_items(items.data(), 2);
 }
 
 /**
@@ -406,26 +780,12 @@ void InternalIndexNodeHandler::insert(const char *key, PageNum page_num, const K
 {
   int insert_position = -1;
   lookup(comparator, key, nullptr, &insert_position);
-  if (insert_position < size()) {
-    memmove(__item_at(insert_position + 1), __item_at(insert_position), (static_cast<size_t>(size()) - insert_position) * item_size());
-  }
-  memcpy(__item_at(insert_position), key, key_size());
-  memcpy(__value_at(insert_position), &page_num, value_size());
-  increase_size(1);
+  insert_item(insert_position, key, reinterpret_cast<const char *>(&page_num));
 }
 
-RC InternalIndexNodeHandler::move_half_to(InternalIndexNodeHandler &other, FileBufferPool *bp)
+void InternalIndexNodeHandler::append(const char *key, PageNum page_num)
 {
-  const int size = this->size();
-  const int move_index = size / 2;
-  RC rc = other.copy_from(this->__item_at(move_index), size - move_index, bp);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to copy item to new node. rc=%d:%s", rc, strrc(rc));
-    return rc;
-  }
-
-  increase_size(-(size - move_index));
-  return rc;
+  insert_item(size(), key, reinterpret_cast<const char *>(&page_num));
 }
 
 /**
@@ -447,15 +807,12 @@ int InternalIndexNodeHandler::lookup(const KeyComparator &comparator, const char
     return 0;
   }
 
-  common::BinaryIterator<char> iter_begin(item_size(), __key_at(1));
-  common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
-  common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
-  int ret = static_cast<int>(iter - iter_begin) + 1;
+  int ret = lower_bound_key(comparator, key, 1, found);
   if (insert_position) {
     *insert_position = ret;
   }
 
-  if (ret >= size || comparator(key, __key_at(ret)) < 0) {
+  if (ret >= size || comparator(key, read_key(ret, probe_buffer())) < 0) {
     return ret - 1;
   }
   return ret;
@@ -464,25 +821,33 @@ int InternalIndexNodeHandler::lookup(const KeyComparator &comparator, const char
 char *InternalIndexNodeHandler::key_at(int index)
 {
   assert(index >= 0 && index < size());
-  return __key_at(index);
+  return const_cast<char *>(read_key(index, key_buffer()));
+}
+
+bool InternalIndexNodeHandler::can_set_key_at(int index, const char *key) const
+{
+  assert(index >= 0 && index < size());
+  return can_set_key(index, key);
 }
 
 void InternalIndexNodeHandler::set_key_at(int index, const char *key)
 {
   assert(index >= 0 && index < size());
-  memcpy(__key_at(index), key, key_size());
+  set_key(index, key);
 }
 
 PageNum InternalIndexNodeHandler::value_at(int index)
 {
   assert(index >= 0 && index < size());
-  return *(PageNum *)__value_at(index);
+  PageNum page_num;
+  memcpy(&page_num, value_ptr(index), sizeof(page_num));
+  return page_num;
 }
 
 int InternalIndexNodeHandler::value_index(PageNum page_num)
 {
   for (int i = 0; i < size(); i++) {
-    if (page_num == *(PageNum *)__value_at(i)) {
+    if (page_num == value_at(i)) {
       return i;
     }
   }
@@ -491,16 +856,23 @@ int InternalIndexNodeHandler::value_index(PageNum page_num)
 
 void InternalIndexNodeHandler::remove(int index)
 {
-  assert(index >= 0 && index < size());
-  if (index < size() - 1) {
-    memmove(__item_at(index), __item_at(index + 1), (static_cast<size_t>(size()) - index - 1) * item_size());
-  }
-  increase_size(-1);
+  remove_item(index);
 }
 
 RC InternalIndexNodeHandler::move_to(InternalIndexNodeHandler &other, FileBufferPool *disk_buffer_pool)
 {
-  RC rc = other.copy_from(__item_at(0), size(), disk_buffer_pool);
+  const int other_size = other.size();
+  const int num = other_size + this->size();
+  std::vector<char> items(static_cast<size_t>(num) * item_size());
+  other.read_items(0, other_size, items.data());
+  this->read_items(0, this->size(), items.data() + static_cast<size_t>(other_size) * item_size());
+  if (!other.write_items(items.data(), num)) {
+    LOG_WARN("no space to move items to other node. this page num=%d, other page num=%d",
+             this->page_num(), other.page_num());
+    return RC::INTERNAL;
+  }
+
+  RC rc = other.adopt_children(other_size, num, disk_buffer_pool);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to copy items to other node. rc=%d:%s", rc, strrc(rc));
     return rc;
@@ -512,43 +884,41 @@ RC InternalIndexNodeHandler::move_to(InternalIndexNodeHandler &other, FileBuffer
 
 RC InternalIndexNodeHandler::move_first_to_end(InternalIndexNodeHandler &other, FileBufferPool *disk_buffer_pool)
 {
-  RC rc = other.append(__item_at(0), disk_buffer_pool);
+  std::vector<char> item(item_size());
+  read_items(0, 1, item.data());
+  other.insert_item(other.size(), item.data(), item.data() + key_size());
+  RC rc = other.adopt_children(other.size() - 1, other.size(), disk_buffer_pool);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to append item to others.");
     return rc;
   }
 
-  if (size() >= 1) {
-    memmove(__item_at(0), __item_at(1), (static_cast<size_t>(size()) - 1) * item_size());
-  }
-  increase_size(-1);
+  remove_item(0);
   return rc;
 }
 
 RC InternalIndexNodeHandler::move_last_to_front(InternalIndexNodeHandler &other, FileBufferPool *bp)
 {
-  RC rc = other.preappend(__item_at(size() - 1), bp);
+  std::vector<char> item(item_size());
+  read_items(size() - 1, size(), item.data());
+  other.insert_item(0, item.data(), item.data() + key_size());
+  RC rc = other.adopt_children(0, 1, bp);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to preappend to others");
     return rc;
   }
 
-  increase_size(-1);
+  remove_item(size() - 1);
   return rc;
 }
-/**
- * copy items from other node to self's right
- */
-RC InternalIndexNodeHandler::copy_from(const char *items, int num, FileBufferPool *disk_buffer_pool)
-{
-  memcpy(__item_at(this->size()), items, static_cast<size_t>(num) * item_size());
 
-  RC rc = RC::SUCCESS;
-  PageNum this_page_num = this->page_num();
-  Frame *frame = nullptr;
-  for (int i = 0; i < num; i++) {
-    const PageNum page_num = *(const PageNum *)((items + i * item_size()) + key_size());
-    rc = disk_buffer_pool->get_this_page(page_num, &frame);
+RC InternalIndexNodeHandler::adopt_children(int begin, int end, FileBufferPool *bp)
+{
+  const PageNum this_page_num = this->page_num();
+  for (int i = begin; i < end; i++) {
+    const PageNum page_num = value_at(i);
+    Frame *frame = nullptr;
+    RC rc = bp->get_this_page(page_num, &frame);
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to set child's page num. child page num:%d, this page num=%d, rc=%d:%s",
                page_num, this_page_num, rc, strrc(rc));
@@ -557,77 +927,23 @@ RC InternalIndexNodeHandler::copy_from(const char *items, int num, FileBufferPoo
     IndexNodeHandler child_node(header_, frame);
     child_node.set_parent_page_num(this_page_num);
     frame->mark_dirty();
-    disk_buffer_pool->unpin_page(frame);
+    bp->unpin_page(frame);
   }
-  increase_size(num);
-  return rc;
-}
-
-RC InternalIndexNodeHandler::append(const char *item, FileBufferPool *bp)
-{
-  return this->copy_from(item, 1, bp);
+  return RC::SUCCESS;
 }
 
-RC InternalIndexNodeHandler::preappend(const char *item, FileBufferPool *bp)
-{
-  PageNum child_page_num = *(PageNum *)(item + key_size());
-  Frame *frame = nullptr;
-  RC rc = bp->get_this_page(child_page_num, &frame);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to fetch child page. rc=%d:%s", rc, strrc(rc));
-    return rc;
-  }
-
-  IndexNodeHandler child_node(header_, frame);
-  child_node.set_parent_page_num(this->page_num());
-
-  frame->mark_dirty();
-  bp->unpin_page(frame);
-
-  if (this->size() > 0) {
-    memmove(__item_at(1), __item_at(0), static_cast<size_t>(this->size()) * item_size());
-  }
-
-  memcpy(__item_at(0), item, item_size());
-  increase_size(1);
-  return RC::SUCCESS;
-}
-
-char *InternalIndexNodeHandler::__item_at(int index) const
-{
-  return internal_node_->array + (index * item_size());
-}
-
-char *InternalIndexNodeHandler::__key_at(int index) const
-{
-  return __item_at(index);
-}
-
-char *InternalIndexNodeHandler::__value_at(int index) const
-{
-  return __item_at(index) + key_size();
-}
-
-int InternalIndexNodeHandler::value_size() const
-{
-  return sizeof(PageNum);
-}
-
-int InternalIndexNodeHandler::item_size() const
-{
-  return key_size() + this->value_size();
-}
-
-bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, FileBufferPool *bp) const
+bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, FileBufferPool *bp) const
 {
   bool result = IndexNodeHandler::validate();
   if (false == result) {
     return false;
   }
 
+  std::vector<char> prev_key(key_size());
+  std::vector<char> key(key_size());
   const int node_size = size();
   for (int i = 2; i < node_size; i++) {
-    if (comparator(__key_at(i - 1), __key_at(i)) >= 0) {
+    if (comparator(read_key(i - 1, prev_key.data()), read_key(i, key.data())) >= 0) {
       LOG_WARN("page number = %d, invalid key order. id1=%d,id2=%d, this=%s",
                page_num(), i - 1, i, to_string(*this).c_str());
       return false;
@@ -635,7 +951,8 @@ bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, FileBuf
   }
 
   for (int i = 0; result && i < node_size; i++) {
-    PageNum page_num = *(PageNum *)__value_at(i);
+    PageNum page_num;
+    memcpy(&page_num, value_ptr(i), sizeof(page_num));
     if (page_num < 0) {
       LOG_WARN("this page num=%d, got invalid child page. page num=%d", this->page_num(), page_num);
     } else {
@@ -682,7 +999,7 @@ bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, FileBuf
   }
 
   if (0 != index_in_parent) {
-    int cmp_result = comparator(__key_at(1), parent_node.key_at(index_in_parent));
+    int cmp_result = comparator(read_key(1, key.data()), parent_node.key_at(index_in_parent));
     if (cmp_result < 0) {
       LOG_WARN("invalid internal node. the second item should be greate than or equal to parent item. "
           "this page num=%d, parent page num=%d, index in parent=%d",
@@ -693,7 +1010,7 @@ bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, FileBuf
   }
 
   if (index_in_parent < parent_node.size() - 1) {
-    int cmp_result = comparator(__key_at(size() - 1), parent_node.key_at(index_in_parent + 1));
+    int cmp_result = comparator(read_key(size() - 1, key.data()), parent_node.key_at(index_in_parent + 1));
     if (cmp_result >= 0) {
       LOG_WARN("invalid internal node. last item should be less than the item at the first after item in parent."
           "this page num=%d, parent page num=%d, parent item to compare=%d",
@@ -728,7 +1045,7 @@ RC BplusTreeHandler::sync()
 }
 
 RC BplusTreeHandler::create(const char *file_name, bool is_unique, std::vector<AttrType> multi_attr_types, std::vector<int> multi_attr_length, int internal_max_size /* = -1*/,
-                            int leaf_max_size /* = -1 */)
+                            int leaf_max_size /* = -1 */, bool key_compressed /* = false */)
 {
   BufferPoolManager &bpm = BufferPoolManager::instance();
   RC rc = bpm.create_file(file_name);
@@ -766,15 +1083,18 @@ RC BplusTreeHandler::create(const char *file_name, bool is_unique, std::vector<A
     total_attr_length += length;
   }
   if (internal_max_size < 0) {
-    internal_max_size = calc_internal_page_capacity(total_attr_length);
+    internal_max_size = key_compressed ? calc_compressed_page_capacity(InternalIndexNode::HEADER_SIZE, sizeof(PageNum))
+                                       : calc_internal_page_capacity(total_attr_length);
   }
   if (leaf_max_size < 0) {
-    leaf_max_size = calc_leaf_page_capacity(total_attr_length);
+    leaf_max_size = key_compressed ? calc_compressed_page_capacity(LeafIndexNode::HEADER_SIZE, sizeof(RID))
+                                   : calc_leaf_page_capacity(total_attr_length);
   }
 
   char *pdata = header_frame->data();
   IndexFileHeader *file_header = (IndexFileHeader *)pdata;
   file_header->is_unique_ = is_unique;
+  file_header->key_compressed = key_compressed;
   file_header->attr_amount = multi_attr_length.size();
   file_header->attrs_length = total_attr_length;
   for (int i = 0; i < multi_attr_length.size(); i++) {
@@ -958,6 +1278,17 @@ RC BplusTreeHandler::print_tree()
   return rc;
 }
 
+RC BplusTreeHandler::fetch_left_most_page(Frame *&frame)
+{
+  LatchMemo latch_memo(file_buffer_pool_);
+  RC rc = left_most_page(latch_memo, frame);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  // 再获取一次引用，latch_memo 释放以后调用者仍然可以使用，最后由调用者 unpin
+  return file_buffer_pool_->get_this_page(frame->page_num(), &frame);
+}
+
 RC BplusTreeHandler::print_leafs()
 {
   if (is_empty()) {
@@ -967,8 +1298,7 @@ RC BplusTreeHandler::print_leafs()
   }
 
   Frame *frame = nullptr;
-
-  RC rc = left_most_page(frame);
+  RC rc = fetch_left_most_page(frame);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to get left most page. rc=%d:%s", rc, strrc(rc));
     return rc;
@@ -1027,7 +1357,7 @@ bool BplusTreeHandler::validate_leaf_link()
   }
 
   Frame *frame = nullptr;
-  RC rc = left_most_page(frame);
+  RC rc = fetch_left_most_page(frame);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to fetch left most page. rc=%d:%s", rc, strrc(rc));
     return false;
@@ -1091,29 +1421,37 @@ bool BplusTreeHandler::is_empty() const
   return file_header_.root_page == BP_INVALID_PAGE_NUM;
 }
 
-RC BplusTreeHandler::find_leaf(BplusTreeOperationType op, const char *key, Frame *&frame)
+RC BplusTreeHandler::find_leaf(LatchMemo &latch_memo, BplusTreeOperationType op, const char *key, Frame *&frame,
+                               bool optimistic /* = false */)
 {
   auto child_page_getter = [this, key](InternalIndexNodeHandler &internal_node) {
     return internal_node.value_at(internal_node.lookup(key_comparator_, key));
   };
-  return find_leaf_internal(op, child_page_getter, frame);
+  return find_leaf_internal(latch_memo, op, child_page_getter, frame, optimistic);
 }
 
-RC BplusTreeHandler::left_most_page( Frame *&frame)
+RC BplusTreeHandler::left_most_page(LatchMemo &latch_memo, Frame *&frame)
 {
   auto child_page_getter = [](InternalIndexNodeHandler &internal_node) { return internal_node.value_at(0); };
-  return find_leaf_internal(BplusTreeOperationType::READ, child_page_getter, frame);
+  return find_leaf_internal(latch_memo, BplusTreeOperationType::READ, child_page_getter, frame, false);
 }
 
-RC BplusTreeHandler::find_leaf_internal(BplusTreeOperationType op,
+RC BplusTreeHandler::find_leaf_internal(LatchMemo &latch_memo, BplusTreeOperationType op,
     const std::function<PageNum(InternalIndexNodeHandler &)> &child_page_getter,
-    Frame *&frame)
+    Frame *&frame, bool optimistic)
 {
+  // 可能修改根节点的操作需要加 root_lock_ 的写锁，与页面的锁一样，在根节点安全时释放
+  if (op != BplusTreeOperationType::READ && !optimistic) {
+    latch_memo.xlatch(&root_lock_);
+  } else {
+    latch_memo.slatch(&root_lock_);
+  }
+
   if (is_empty()) {
     return RC::EMPTY;
   }
 
-  RC rc = crabing_protocal_fetch_page(op, file_header_.root_page, true/* is_root_node */, frame);
+  RC rc = crabing_protocal_fetch_page(latch_memo, op, file_header_.root_page, true/* is_root_node */, optimistic, frame);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to fetch root page. page id=%d, rc=%d:%s", file_header_.root_page, rc, strrc(rc));
     return rc;
@@ -1125,11 +1463,7 @@ RC BplusTreeHandler::find_leaf_internal(BplusTreeOperationType op,
     InternalIndexNodeHandler internal_node(file_header_, frame);
     next_page_id = child_page_getter(internal_node);
 
-    // 这里不再持有原来 frame 的引用，转而获取子节点的 frame，需要 unpin 原来的 frame
-    file_buffer_pool_->unpin_page(frame);
-    frame = nullptr;
-
-    rc = crabing_protocal_fetch_page(op, next_page_id, false /* is_root_node */, frame);
+    rc = crabing_protocal_fetch_page(latch_memo, op, next_page_id, false /* is_root_node */, optimistic, frame);
     if (rc != RC::SUCCESS) {
       LOG_WARN("Failed to load page page_num:%d. rc=%s", next_page_id, strrc(rc));
       return rc;
@@ -1140,22 +1474,39 @@ RC BplusTreeHandler::find_leaf_internal(BplusTreeOperationType op,
   return RC::SUCCESS;
 }
 
-RC BplusTreeHandler::crabing_protocal_fetch_page(BplusTreeOperationType op,
+RC BplusTreeHandler::crabing_protocal_fetch_page(LatchMemo &latch_memo,
+                                                 BplusTreeOperationType op,
                                                  PageNum page_num,
                                                  bool is_root_node,
+                                                 bool optimistic,
                                                  Frame *&frame)
 {
-  bool readonly = (op == BplusTreeOperationType::READ);
-  RC rc = file_buffer_pool_->get_this_page(page_num, &frame);
+  const int memo_point = latch_memo.memo_point();
+  RC rc = latch_memo.get_page(page_num, frame);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to get frame. pageNum=%d, rc=%s", page_num, strrc(rc));
     return rc;
   }
+
+  // 乐观的写操作只对叶子节点加写锁。这时还持有父节点(或 root_lock_)的读锁，页面不会被删除，
+  // 而节点类型在页面的生命周期内不会改变，所以加锁之前就可以读取
+  LatchMemoType latch_type = LatchMemoType::EXCLUSIVE;
+  if (op == BplusTreeOperationType::READ) {
+    latch_type = LatchMemoType::SHARED;
+  } else if (optimistic && !((IndexNode *)frame->data())->is_leaf) {
+    latch_type = LatchMemoType::SHARED;
+  }
+  latch_memo.latch(frame, latch_type);
+
+  // 当前节点是安全的，不会因为这次操作分裂或者合并，那么祖先节点的锁都可以释放了
   IndexNodeHandler index_node(file_header_, frame);
+  if (latch_type == LatchMemoType::SHARED || optimistic || index_node.is_safe(op, is_root_node)) {
+    latch_memo.release_to(memo_point);
+  }
   return rc;
 }
 
-RC BplusTreeHandler::insert_entry_into_leaf_node(Frame *frame, const char *key, const RID *rid)
+RC BplusTreeHandler::insert_entry_into_leaf_node(LatchMemo &latch_memo, Frame *frame, const char *key, const RID *rid)
 {
   LeafIndexNodeHandler leaf_node(file_header_, frame);
   bool exists = false; // 该数据是否已经存在指定的叶子节点中了
@@ -1165,15 +1516,14 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(Frame *frame, const char *key,
     return RC::RECORD_DUPLICATE_KEY;
   }
 
-  if (leaf_node.size() < leaf_node.max_size()) {
+  if (leaf_node.can_insert(key)) {
     leaf_node.insert(insert_position, key, (const char *)rid);
     frame->mark_dirty();
-    file_buffer_pool_->unpin_page(frame);
     return RC::SUCCESS;
   }
 
   Frame *new_frame = nullptr;
-  RC rc = split<LeafIndexNodeHandler>(frame, new_frame);
+  RC rc = split<LeafIndexNodeHandler>(latch_memo, frame, insert_position, key, (const char *)rid, new_frame);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to split leaf node. rc=%d:%s", rc, strrc(rc));
     return rc;
@@ -1181,19 +1531,14 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(Frame *frame, const char *key,
 
   LeafIndexNodeHandler new_index_node(file_header_, new_frame);
   new_index_node.set_next_page(leaf_node.next_page());
-  new_index_node.set_parent_page_num(leaf_node.parent_page_num());
   leaf_node.set_next_page(new_frame->page_num());
 
-  if (insert_position < leaf_node.size()) {
-    leaf_node.insert(insert_position, key, (const char *)rid);
-  } else {
-    new_index_node.insert(insert_position - leaf_node.size(), key, (const char *)rid);
-  }
-
-  return insert_entry_into_parent(frame, new_frame, new_index_node.key_at(0));
+  std::vector<char> separator(file_header_.key_length);
+  make_separator(leaf_node.key_at(leaf_node.size() - 1), new_index_node.key_at(0), separator.data());
+  return insert_entry_into_parent(latch_memo, frame, new_frame, separator.data());
 }
 
-RC BplusTreeHandler::insert_entry_into_parent(Frame *frame, Frame *new_frame, const char *key)
+RC BplusTreeHandler::insert_entry_into_parent(LatchMemo &latch_memo, Frame *frame, Frame *new_frame, const char *key)
 {
   RC rc = RC::SUCCESS;
 
@@ -1203,12 +1548,14 @@ RC BplusTreeHandler::insert_entry_into_parent(Frame *frame, Frame *new_frame, co
 
   if (parent_page_num == BP_INVALID_PAGE_NUM) {
     // create new root page
+    // 根节点不安全，所以 find_leaf 一直持有 root_lock_ 的写锁
     Frame *root_frame;
-    rc = file_buffer_pool_->allocate_page(&root_frame);
+    rc = latch_memo.allocate_page(root_frame);
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to allocate new root page. rc=%d:%s", rc, strrc(rc));
       return rc;
     }
+    latch_memo.xlatch(root_frame);
 
     InternalIndexNodeHandler root_node(file_header_, root_frame);
     root_node.init_empty();
@@ -1218,17 +1565,15 @@ RC BplusTreeHandler::insert_entry_into_parent(Frame *frame, Frame *new_frame, co
 
     frame->mark_dirty();
     new_frame->mark_dirty();
-    file_buffer_pool_->unpin_page(frame);
-    file_buffer_pool_->unpin_page(new_frame);
 
     update_root_page_num_locked(root_frame->page_num());
     root_frame->mark_dirty();
-    file_buffer_pool_->unpin_page(root_frame);
 
     return RC::SUCCESS;
   } else {
+    // 子节点不安全，父节点的写锁在查找叶子节点时已经加上了
     Frame *parent_frame = nullptr;
-    rc = file_buffer_pool_->get_this_page(parent_page_num, &parent_frame);
+    rc = latch_memo.get_page(parent_page_num, parent_frame);
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to insert entry into leaf. rc=%d:%s", rc, strrc(rc));
       // we should do some things to recover
@@ -1238,42 +1583,37 @@ RC BplusTreeHandler::insert_entry_into_parent(Frame *frame, Frame *new_frame, co
     InternalIndexNodeHandler parent_node(file_header_, parent_frame);
 
     /// 当前这个父节点还没有满，直接将新节点数据插进入就行了
-    if (parent_node.size() < parent_node.max_size()) {
+    if (parent_node.can_insert(key)) {
       parent_node.insert(key, new_frame->page_num(), key_comparator_);
       new_node_handler.set_parent_page_num(parent_page_num);
 
       frame->mark_dirty();
       new_frame->mark_dirty();
       parent_frame->mark_dirty();
-      file_buffer_pool_->unpin_page(frame);
-      file_buffer_pool_->unpin_page(new_frame);
-      file_buffer_pool_->unpin_page(parent_frame);
 
     } else {
       // 当前父节点即将装满了，那只能再将父节点执行分裂操作
+      int insert_position = -1;
+      parent_node.lookup(key_comparator_, key, nullptr, &insert_position);
+      const PageNum new_page_num = new_frame->page_num();
+
       Frame *new_parent_frame = nullptr;
-      rc = split<InternalIndexNodeHandler>(parent_frame, new_parent_frame);
+      rc = split<InternalIndexNodeHandler>(latch_memo, parent_frame, insert_position, key,
+                                           reinterpret_cast<const char *>(&new_page_num), new_parent_frame);
       if (rc != RC::SUCCESS) {
         LOG_WARN("failed to split internal node. rc=%d:%s", rc, strrc(rc));
-        file_buffer_pool_->unpin_page(frame);
-        file_buffer_pool_->unpin_page(new_frame);
-        file_buffer_pool_->unpin_page(parent_frame);
       } else {
-        // insert into left or right ? decide by key compare result
+        // 新节点分到了哪一边，就以哪一边为父节点
         InternalIndexNodeHandler new_node(file_header_, new_parent_frame);
-        if (key_comparator_(key, new_node.key_at(0)) > 0) {
-          new_node.insert(key, new_frame->page_num(), key_comparator_);
+        if (new_node.value_index(new_page_num) >= 0) {
           new_node_handler.set_parent_page_num(new_node.page_num());
         } else {
-          parent_node.insert(key, new_frame->page_num(), key_comparator_);
           new_node_handler.set_parent_page_num(parent_node.page_num());
         }
-
-        file_buffer_pool_->unpin_page(frame);
-        file_buffer_pool_->unpin_page(new_frame);
+        new_frame->mark_dirty();
 
         // 虽然这里是递归调用，但是通常B+ Tree 的层高比较低（3层已经可以容纳很多数据），所以没有栈溢出风险。
-        rc = insert_entry_into_parent(parent_frame, new_parent_frame, new_node.key_at(0));
+        rc = insert_entry_into_parent(latch_memo, parent_frame, new_parent_frame, new_node.key_at(0));
       }
     }
   }
@@ -1281,31 +1621,80 @@ RC BplusTreeHandler::insert_entry_into_parent(Frame *frame, Frame *new_frame, co
 }
 
 /**
- * split one full node into two
+ * 把新的一项和已满节点中所有的项一起分到两个节点中。
+ * 压缩格式下每个节点能放下多少项与键的内容有关，所以先合在一起再选择两边都放得下的分裂位置
  */
 template <typename IndexNodeHandlerType>
-RC BplusTreeHandler::split(Frame *frame, Frame *&new_frame)
+RC BplusTreeHandler::split(LatchMemo &latch_memo, Frame *frame, int index, const char *key, const char *value,
+                           Frame *&new_frame)
 {
   IndexNodeHandlerType old_node(file_header_, frame);
 
+  const int item_size = old_node.item_size();
+  const int num = old_node.size() + 1;
+  std::vector<char> items(static_cast<size_t>(num) * item_size);
+  old_node.read_items(0, index, items.data());
+  char *item = items.data() + static_cast<size_t>(index) * item_size;
+  memcpy(item, key, old_node.key_size());
+  memcpy(item + old_node.key_size(), value, old_node.value_size());
+  old_node.read_items(index, old_node.size(), item + item_size);
+
+  const int split_index = old_node.split_point(items.data(), num);
+  if (split_index < 0) {
+    LOG_WARN("cannot find split point. page num=%d, item num=%d", frame->page_num(), num);
+    return RC::INTERNAL;
+  }
+
   // add a new node
-  RC rc = file_buffer_pool_->allocate_page(&new_frame);
+  RC rc = latch_memo.allocate_page(new_frame);
   if (rc != RC::SUCCESS) {
     LOG_WARN("Failed to split index page due to failed to allocate page, rc=%d:%s", rc, strrc(rc));
     return rc;
   }
+  latch_memo.xlatch(new_frame);
 
   IndexNodeHandlerType new_node(file_header_, new_frame);
   new_node.init_empty();
   new_node.set_parent_page_num(old_node.parent_page_num());
 
-  old_node.move_half_to(new_node, file_buffer_pool_);
+  old_node.write_items(items.data(), split_index);
+  new_node.write_items(items.data() + static_cast<size_t>(split_index) * item_size, num - split_index);
+
+  if constexpr (std::is_same_v<IndexNodeHandlerType, InternalIndexNodeHandler>) {
+    rc = new_node.adopt_children(0, new_node.size(), file_buffer_pool_);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to update parent of children. rc=%d:%s", rc, strrc(rc));
+      return rc;
+    }
+  }
 
   frame->mark_dirty();
   new_frame->mark_dirty();
   return RC::SUCCESS;
 }
 
+void BplusTreeHandler::make_separator(const char *left_key, const char *right_key, char *separator) const
+{
+  const int key_length = file_header_.key_length;
+  const int attrs_length = file_header_.attrs_length;
+  memcpy(separator, right_key, key_length);
+  if (!file_header_.key_compressed || key_comparator_.attr_comparator()(left_key, right_key) == 0) {
+    return;
+  }
+
+  memset(separator + attrs_length, 0, sizeof(RID));
+  if (file_header_.attrs_type == CHARS) {
+    const int prefix_len = common_prefix_length(left_key, right_key, attrs_length);
+    if (prefix_len + 1 < attrs_length) {
+      memset(separator + prefix_len + 1, 0, attrs_length - prefix_len - 1);
+    }
+  }
+
+  if (key_comparator_(left_key, separator) >= 0 || key_comparator_(separator, right_key) > 0) {
+    memcpy(separator, right_key, key_length);
+  }
+}
+
 void BplusTreeHandler::update_root_page_num_locked(PageNum root_page_num)
 {
   file_header_.root_page = root_page_num;
@@ -1313,7 +1702,7 @@ void BplusTreeHandler::update_root_page_num_locked(PageNum root_page_num)
   LOG_DEBUG("set root page to %d", root_page_num);
 }
 
-RC BplusTreeHandler::create_new_tree(const char *key, const RID *rid)
+RC BplusTreeHandler::create_new_tree(LatchMemo &latch_memo, const char *key, const RID *rid)
 {
   RC rc = RC::SUCCESS;
   if (file_header_.root_page != BP_INVALID_PAGE_NUM) {
@@ -1323,18 +1712,18 @@ RC BplusTreeHandler::create_new_tree(const char *key, const RID *rid)
   }
 
   Frame *frame = nullptr;
-  rc = file_buffer_pool_->allocate_page(&frame);
+  rc = latch_memo.allocate_page(frame);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to allocate root page. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
+  latch_memo.xlatch(frame);
 
   LeafIndexNodeHandler leaf_node(file_header_, frame);
   leaf_node.init_empty();
   leaf_node.insert(0, key, (const char *)rid);
   update_root_page_num_locked(frame->page_num());
   frame->mark_dirty();
-  file_buffer_pool_->unpin_page(frame);
 
   return rc;
 }
@@ -1415,18 +1804,36 @@ RC BplusTreeHandler::insert_entry(const char *multi_keys[], const RID *rid, int
 
   char *key = static_cast<char *>(pkey.get());
 
-  if (is_empty()) {
-    return create_new_tree(key, rid);
+  // 大部分插入不会导致叶子节点分裂，先只对叶子节点加写锁尝试插入
+  {
+    LatchMemo latch_memo(file_buffer_pool_);
+    Frame *frame = nullptr;
+    RC rc = find_leaf(latch_memo, BplusTreeOperationType::INSERT, key, frame, true /* optimistic */);
+    if (rc == RC::SUCCESS) {
+      LeafIndexNodeHandler leaf_node(file_header_, frame);
+      if (leaf_node.can_insert(key)) {
+        return insert_entry_into_leaf_node(latch_memo, frame, key, rid);
+      }
+    } else if (rc != RC::EMPTY) {
+      LOG_WARN("Failed to find leaf %s. rc=%d:%s", rid->to_string().c_str(), rc, strrc(rc));
+      return rc;
+    }
   }
 
+  // 叶子节点需要分裂或者是一棵空树，从根节点开始加写锁重新查找
+  LatchMemo latch_memo(file_buffer_pool_);
   Frame *frame = nullptr;
-  RC rc = find_leaf(BplusTreeOperationType::INSERT, key, frame);
+  RC rc = find_leaf(latch_memo, BplusTreeOperationType::INSERT, key, frame);
+  if (rc == RC::EMPTY) {
+    // 这时持有 root_lock_ 的写锁
+    return create_new_tree(latch_memo, key, rid);
+  }
   if (rc != RC::SUCCESS) {
     LOG_WARN("Failed to find leaf %s. rc=%d:%s", rid->to_string().c_str(), rc, strrc(rc));
     return rc;
   }
 
-  rc = insert_entry_into_leaf_node(frame, key, rid);
+  rc = insert_entry_into_leaf_node(latch_memo, frame, key, rid);
   if (rc != RC::SUCCESS) {
     LOG_TRACE("Failed to insert into leaf of index, rid:%s. rc=%s", rid->to_string().c_str(), strrc(rc));
     return rc;
@@ -1465,15 +1872,142 @@ RC BplusTreeHandler::get_entry(const char *multi_keys[], std::list<RID> &rids, i
   return rc;
 }
 
-RC BplusTreeHandler::adjust_root(Frame *root_frame)
+RC BplusTreeHandler::get_entries(const std::vector<const char *> &user_keys, std::vector<std::vector<RID>> &rids)
+{
+  rids.clear();
+  rids.resize(user_keys.size());
+
+  const AttrComparator &attr_comparator = key_comparator_.attr_comparator();
+  std::vector<int> order(user_keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](int left, int right) {
+    return attr_comparator(user_keys[left], user_keys[right]) < 0;
+  });
+
+  // 查找的键使用最小的 RID，定位到的就是这个值的第一项
+  const int attrs_length = file_header_.attrs_length;
+  std::vector<char> search_key(file_header_.key_length);
+  memcpy(search_key.data() + attrs_length, RID::min(), sizeof(RID));
+
+  LatchMemo latch_memo(file_buffer_pool_);
+  Frame *frame = nullptr;
+  for (size_t i = 0; i < order.size(); i++) {
+    const char *user_key = user_keys[order[i]];
+    std::vector<RID> &result = rids[order[i]];
+    if (i > 0 && attr_comparator(user_key, user_keys[order[i - 1]]) == 0) {
+      result = rids[order[i - 1]];
+      continue;
+    }
+
+    memcpy(search_key.data(), user_key, attrs_length);
+    while (true) {
+      int index = 0;
+      RC rc = seek_leaf(latch_memo, search_key.data(), frame, index);
+      if (rc == RC::EMPTY) {
+        return RC::SUCCESS;
+      }
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to find leaf page. rc=%s", strrc(rc));
+        return rc;
+      }
+
+      // 相同的值可能延续到后面的叶子节点中。与 BplusTreeScanner::seek 一样，向右只尝试加锁，失败时从根节点重新查找
+      result.clear();
+      bool retry = false;
+      bool done = false;
+      while (!done) {
+        LeafIndexNodeHandler node(file_header_, frame);
+        for (; index < node.size(); index++) {
+          if (attr_comparator(node.key_at(index), user_key) != 0) {
+            done = true;
+            break;
+          }
+          RID rid;
+          memcpy(&rid, node.value_at(index), sizeof(rid));
+          result.push_back(rid);
+        }
+        if (done || node.next_page() == BP_INVALID_PAGE_NUM) {
+          break;
+        }
+
+        const int memo_point = latch_memo.memo_point();
+        Frame *next_frame = nullptr;
+        rc = latch_memo.get_page(node.next_page(), next_frame);
+        if (rc != RC::SUCCESS) {
+          LOG_WARN("failed to fetch next page. page num=%d, rc=%s", node.next_page(), strrc(rc));
+          return rc;
+        }
+        if (!latch_memo.try_slatch(next_frame)) {
+          retry = true;
+          break;
+        }
+        latch_memo.release_to(memo_point);
+        frame = next_frame;
+        index = 0;
+      }
+
+      if (!retry) {
+        break;
+      }
+      latch_memo.release();
+      frame = nullptr;
+      std::this_thread::yield();
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC BplusTreeHandler::seek_leaf(LatchMemo &latch_memo, const char *key, Frame *&frame, int &index)
+{
+  if (frame != nullptr) {
+    LeafIndexNodeHandler node(file_header_, frame);
+    index = node.lookup(key_comparator_, key);
+    if (index < node.size()) {
+      return RC::SUCCESS;
+    }
+
+    if (node.next_page() != BP_INVALID_PAGE_NUM) {
+      const int memo_point = latch_memo.memo_point();
+      Frame *next_frame = nullptr;
+      RC rc = latch_memo.get_page(node.next_page(), next_frame);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to fetch next page. page num=%d, rc=%s", node.next_page(), strrc(rc));
+        return rc;
+      }
+      if (latch_memo.try_slatch(next_frame)) {
+        LeafIndexNodeHandler next_node(file_header_, next_frame);
+        index = next_node.lookup(key_comparator_, key);
+        if (index < next_node.size()) {
+          latch_memo.release_to(memo_point);
+          frame = next_frame;
+          return RC::SUCCESS;
+        }
+      }
+    }
+
+    latch_memo.release();
+    frame = nullptr;
+  }
+
+  RC rc = find_leaf(latch_memo, BplusTreeOperationType::READ, key, frame);
+  if (rc != RC::SUCCESS) {
+    frame = nullptr;
+    return rc;
+  }
+  LeafIndexNodeHandler node(file_header_, frame);
+  index = node.lookup(key_comparator_, key);
+  return RC::SUCCESS;
+}
+
+RC BplusTreeHandler::adjust_root(LatchMemo &latch_memo, Frame *root_frame)
 {
   IndexNodeHandler root_node(file_header_, root_frame);
   if (root_node.is_leaf() && root_node.size() > 0) {
     root_frame->mark_dirty();
-    file_buffer_pool_->unpin_page(root_frame);
     return RC::SUCCESS;
   }
 
+  // 根节点不安全，所以 find_leaf 一直持有 root_lock_ 的写锁
   PageNum new_root_page_num = BP_INVALID_PAGE_NUM;
   if (root_node.is_leaf()) {
     ASSERT(root_node.size() == 0, "");
@@ -1485,16 +2019,15 @@ RC BplusTreeHandler::adjust_root(Frame *root_frame)
 
     const PageNum child_page_num = internal_node.value_at(0);
     Frame *child_frame = nullptr;
-    RC rc = file_buffer_pool_->get_this_page(child_page_num, &child_frame);
+    RC rc = latch_memo.get_page(child_page_num, child_frame);
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to fetch child page. page num=%d, rc=%d:%s", child_page_num, rc, strrc(rc));
-      file_buffer_pool_->unpin_page(root_frame);
       return rc;
     }
 
     IndexNodeHandler child_node(file_header_, child_frame);
     child_node.set_parent_page_num(BP_INVALID_PAGE_NUM);
-    file_buffer_pool_->unpin_page(child_frame);
+    child_frame->mark_dirty();
 
     // file_header_.root_page = child_page_num;
     new_root_page_num = child_page_num;
@@ -1502,19 +2035,15 @@ RC BplusTreeHandler::adjust_root(Frame *root_frame)
 
   update_root_page_num_locked(new_root_page_num);
 
-  PageNum old_root_page_num = root_frame->page_num();
-  file_buffer_pool_->unpin_page(root_frame);
-  file_buffer_pool_->dispose_page(old_root_page_num);
-
+  latch_memo.dispose_page(root_frame->page_num());
   return RC::SUCCESS;
 }
 
 template <typename IndexNodeHandlerType>
-RC BplusTreeHandler::coalesce_or_redistribute(Frame *frame)
+RC BplusTreeHandler::coalesce_or_redistribute(LatchMemo &latch_memo, Frame *frame)
 {
   IndexNodeHandlerType index_node(file_header_, frame);
   if (index_node.size() >= index_node.min_size()) {
-    file_buffer_pool_->unpin_page(frame);
     return RC::SUCCESS;
   }
 
@@ -1523,19 +2052,18 @@ RC BplusTreeHandler::coalesce_or_redistribute(Frame *frame)
     // this is the root page
     if (index_node.size() > 1) {
       // root page has more than one child, no need to adjust
-      file_buffer_pool_->unpin_page(frame);
       return RC::SUCCESS;
     } else {
       // adjust the root node
-      return adjust_root(frame);
+      return adjust_root(latch_memo, frame);
     }
   }
 
+  // 当前节点不安全，父节点的写锁在查找叶子节点时已经加上了
   Frame *parent_frame = nullptr;
-  RC rc = file_buffer_pool_->get_this_page(parent_page_num, &parent_frame);
+  RC rc = latch_memo.get_page(parent_page_num, parent_frame);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to fetch parent page. page id=%d, rc=%d:%s", parent_page_num, rc, strrc(rc));
-    file_buffer_pool_->unpin_page(frame);
     return rc;
   }
 
@@ -1552,27 +2080,27 @@ RC BplusTreeHandler::coalesce_or_redistribute(Frame *frame)
     neighbor_page_num = parent_index_node.value_at(index - 1);
   }
 
+  // 持有父节点的写锁，其它写操作不会访问兄弟节点，只可能有读操作持有兄弟节点的读锁
   Frame *neighbor_frame = nullptr;
-  rc = file_buffer_pool_->get_this_page(neighbor_page_num, &neighbor_frame);
+  rc = latch_memo.get_page(neighbor_page_num, neighbor_frame);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to fetch neighbor page. page id=%d, rc=%d:%s", neighbor_page_num, rc, strrc(rc));
-    file_buffer_pool_->unpin_page(frame);
-    file_buffer_pool_->unpin_page(parent_frame);
     return rc;
   }
+  latch_memo.xlatch(neighbor_frame);
 
   IndexNodeHandlerType neighbor_node(file_header_, neighbor_frame);
-  if (index_node.size() + neighbor_node.size() > index_node.max_size()) {
+  if (!neighbor_node.can_merge(index_node)) {
     rc = redistribute<IndexNodeHandlerType>(neighbor_frame, frame, parent_frame, index);
   } else {
-    rc = coalesce<IndexNodeHandlerType>(neighbor_frame, frame, parent_frame, index);
+    rc = coalesce<IndexNodeHandlerType>(latch_memo, neighbor_frame, frame, parent_frame, index);
   }
 
   return rc;
 }
 
 template <typename IndexNodeHandlerType>
-RC BplusTreeHandler::coalesce(Frame *neighbor_frame, Frame *frame, Frame *parent_frame, int index)
+RC BplusTreeHandler::coalesce(LatchMemo &latch_memo, Frame *neighbor_frame, Frame *frame, Frame *parent_frame, int index)
 {
   InternalIndexNodeHandler parent_node(file_header_, parent_frame);
 
@@ -1597,9 +2125,6 @@ RC BplusTreeHandler::coalesce(Frame *neighbor_frame, Frame *frame, Frame *parent
   RC rc = right_node.move_to(left_node, file_buffer_pool_);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to move right node to left. rc=%d:%s", rc, strrc(rc));
-    file_buffer_pool_->unpin_page(left_frame);
-    file_buffer_pool_->unpin_page(right_frame);
-    file_buffer_pool_->unpin_page(parent_frame);
     return rc;
   }
   // left_node.validate(key_comparator_);
@@ -1613,12 +2138,15 @@ RC BplusTreeHandler::coalesce(Frame *neighbor_frame, Frame *frame, Frame *parent
   left_frame->mark_dirty();
   parent_frame->mark_dirty();
 
-  file_buffer_pool_->unpin_page(left_frame);
-  file_buffer_pool_->unpin_page(right_frame);
-  file_buffer_pool_->dispose_page(right_frame->page_num());
-  return coalesce_or_redistribute<InternalIndexNodeHandler>(parent_frame);
+  // 等到所有的锁都释放以后再删除页面
+  latch_memo.dispose_page(right_frame->page_num());
+  return coalesce_or_redistribute<InternalIndexNodeHandler>(latch_memo, parent_frame);
 }
 
+/**
+ * 从兄弟节点借一项。先算出父节点中新的分隔键，压缩格式下父节点放不下这个键时不做调整，
+ * 当前节点仍然少于 min_size，但是树的结构是正确的
+ */
 template <typename IndexNodeHandlerType>
 RC BplusTreeHandler::redistribute(Frame *neighbor_frame, Frame *frame, Frame *parent_frame, int index)
 {
@@ -1628,41 +2156,56 @@ RC BplusTreeHandler::redistribute(Frame *neighbor_frame, Frame *frame, Frame *pa
   if (neighbor_node.size() < node.size()) {
     LOG_ERROR("got invalid nodes. neighbor node size %d, this node size %d", neighbor_node.size(), node.size());
   }
+  if (neighbor_node.size() < 2) {
+    return RC::SUCCESS;
+  }
+
+  // 移动的那一项，以及移动以后右边节点的第一项
+  const int moved_index = (index == 0) ? 0 : neighbor_node.size() - 1;
+  const int key_length = file_header_.key_length;
+  std::vector<char> moved_key(neighbor_node.key_at(moved_index), neighbor_node.key_at(moved_index) + key_length);
+  std::vector<char> separator(key_length);
   if (index == 0) {
     // the neighbor is at right
-    neighbor_node.move_first_to_end(node, file_buffer_pool_);
-    // neighbor_node.validate(key_comparator_, file_buffer_pool_, file_id_);
-    // node.validate(key_comparator_, file_buffer_pool_, file_id_);
-    parent_node.set_key_at(index + 1, neighbor_node.key_at(0));
-    // parent_node.validate(key_comparator_, file_buffer_pool_, file_id_);
+    memcpy(separator.data(), neighbor_node.key_at(1), key_length);
+    if (node.is_leaf()) {
+      make_separator(moved_key.data(), neighbor_node.key_at(1), separator.data());
+    }
   } else {
     // the neighbor is at left
+    memcpy(separator.data(), moved_key.data(), key_length);
+    if (node.is_leaf()) {
+      make_separator(neighbor_node.key_at(moved_index - 1), moved_key.data(), separator.data());
+    }
+  }
+
+  const int separator_index = (index == 0) ? index + 1 : index;
+  if (!node.can_insert(moved_key.data()) || !parent_node.can_set_key_at(separator_index, separator.data())) {
+    LOG_TRACE("skip redistribute. no space for moved item or separator. page num=%d", frame->page_num());
+    return RC::SUCCESS;
+  }
+
+  if (index == 0) {
+    neighbor_node.move_first_to_end(node, file_buffer_pool_);
+  } else {
     neighbor_node.move_last_to_front(node, file_buffer_pool_);
-    // neighbor_node.validate(key_comparator_, file_buffer_pool_, file_id_);
-    // node.validate(key_comparator_, file_buffer_pool_, file_id_);
-    parent_node.set_key_at(index, node.key_at(0));
-    // parent_node.validate(key_comparator_, file_buffer_pool_, file_id_);
   }
+  parent_node.set_key_at(separator_index, separator.data());
 
   neighbor_frame->mark_dirty();
   frame->mark_dirty();
   parent_frame->mark_dirty();
 
-  file_buffer_pool_->unpin_page(neighbor_frame);
-  file_buffer_pool_->unpin_page(frame);
-  file_buffer_pool_->unpin_page(parent_frame);
-
   return RC::SUCCESS;
 }
 
-RC BplusTreeHandler::delete_entry_internal(Frame *leaf_frame, const char *key)
+RC BplusTreeHandler::delete_entry_internal(LatchMemo &latch_memo, Frame *leaf_frame, const char *key)
 {
   LeafIndexNodeHandler leaf_index_node(file_header_, leaf_frame);
 
   const int remove_count = leaf_index_node.remove(key, key_comparator_);
   if (remove_count == 0) {
     LOG_TRACE("no data need to remove");
-    file_buffer_pool_->unpin_page(leaf_frame);
     return RC::RECORD_NOT_EXIST;
   }
   // leaf_index_node.validate(key_comparator_, file_buffer_pool_, file_id_);
@@ -1670,11 +2213,10 @@ RC BplusTreeHandler::delete_entry_internal(Frame *leaf_frame, const char *key)
   leaf_frame->mark_dirty();
 
   if (leaf_index_node.size() >= leaf_index_node.min_size()) {
-    file_buffer_pool_->unpin_page(leaf_frame);
     return RC::SUCCESS;
   }
 
-  return coalesce_or_redistribute<LeafIndexNodeHandler>(leaf_frame);
+  return coalesce_or_redistribute<LeafIndexNodeHandler>(latch_memo, leaf_frame);
 }
 
 RC BplusTreeHandler::delete_entry(const char *multi_keys[], const RID *rid, int multi_keys_amount)
@@ -1689,8 +2231,28 @@ RC BplusTreeHandler::delete_entry(const char *multi_keys[], const RID *rid, int
 
   BplusTreeOperationType op = BplusTreeOperationType::DELETE;
 
+  // 与插入一样，先只对叶子节点加写锁，删除以后不需要合并时直接完成
+  {
+    LatchMemo latch_memo(file_buffer_pool_);
+    Frame *leaf_frame = nullptr;
+    RC rc = find_leaf(latch_memo, op, key, leaf_frame, true /* optimistic */);
+    if (rc == RC::EMPTY) {
+      return RC::RECORD_NOT_EXIST;
+    }
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to find leaf page. rc =%s", strrc(rc));
+      return rc;
+    }
+
+    LeafIndexNodeHandler leaf_node(file_header_, leaf_frame);
+    if (leaf_node.is_safe(op, leaf_node.parent_page_num() == BP_INVALID_PAGE_NUM)) {
+      return delete_entry_internal(latch_memo, leaf_frame, key);
+    }
+  }
+
+  LatchMemo latch_memo(file_buffer_pool_);
   Frame *leaf_frame = nullptr;
-  RC rc = find_leaf(op, key, leaf_frame);
+  RC rc = find_leaf(latch_memo, op, key, leaf_frame);
   if (rc == RC::EMPTY) {
     rc = RC::RECORD_NOT_EXIST;
     return rc;
@@ -1701,7 +2263,7 @@ RC BplusTreeHandler::delete_entry(const char *multi_keys[], const RID *rid, int
     return rc;
   }
 
-  return delete_entry_internal(leaf_frame, key);
+  return delete_entry_internal(latch_memo, leaf_frame, key);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1724,7 +2286,9 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
   }
 
   inited_ = true;
-  first_emitted_ = false;
+  item_num_ = 0;
+  iter_index_ = 0;
+  next_page_ = BP_INVALID_PAGE_NUM;
 
   // 校验输入的键值是否是合法范围
   if (left_user_key && right_user_key) {
@@ -1740,74 +2304,6 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
   bool all_in_one_key_left = left_len == tree_handler_.file_header_.attrs_length;
   bool all_in_one_key_right = right_len == tree_handler_.file_header_.attrs_length;
 
-  if (nullptr == left_user_key) {
-    rc = tree_handler_.left_most_page(current_frame_);
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to find left most page. rc=%s", strrc(rc));
-      return rc;
-    }
-    iter_index_ = 0;
-  } else {
-    char *fixed_left_key = const_cast<char *>(left_user_key);
-    if (tree_handler_.file_header_.attrs_type == CHARS) {
-      bool should_inclusive_after_fix = false;
-      rc = fix_user_key(left_user_key, left_len, true /*greater*/, &fixed_left_key, &should_inclusive_after_fix);
-      if (rc != RC::SUCCESS) {
-        LOG_WARN("failed to fix left user key. rc=%s", strrc(rc));
-        return rc;
-      }
-      if (should_inclusive_after_fix) {
-        left_inclusive = true;
-      }
-    }
-
-    MemPoolItem::unique_ptr left_pkey;
-    const char *multi_fixed_left_key[1] = {fixed_left_key};
-    if (left_inclusive) {
-      left_pkey = tree_handler_.make_key(multi_fixed_left_key, *RID::min(), tree_handler_.file_header_.attr_amount, 1, all_in_one_key_left);
-    } else {
-      left_pkey = tree_handler_.make_key(multi_fixed_left_key, *RID::max(), tree_handler_.file_header_.attr_amount, 2, all_in_one_key_left);
-    }
-
-    const char *left_key = (const char *)left_pkey.get();
-
-    if (fixed_left_key != left_user_key) {
-      delete[] fixed_left_key;
-      fixed_left_key = nullptr;
-    }
-
-    rc = tree_handler_.find_leaf(BplusTreeOperationType::READ, left_key, current_frame_);
-    if (rc == RC::EMPTY) {
-      rc = RC::SUCCESS;
-      current_frame_ = nullptr;
-      return rc;
-    } else if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to find left page. rc=%s", strrc(rc));
-      return rc;
-    }
-
-
-    LeafIndexNodeHandler left_node(tree_handler_.file_header_, current_frame_);
-    int left_index = left_node.lookup(tree_handler_.key_comparator_, left_key);
-    // lookup 返回的是适合插入的位置，还需要判断一下是否在合适的边界范围内
-    if (left_index >= left_node.size()) {  // 超出了当前页，就需要向后移动一个位置
-      const PageNum next_page_num = left_node.next_page();
-      if (next_page_num == BP_INVALID_PAGE_NUM) {  // 这里已经是最后一页，说明当前扫描，没有数据
-        // 释放 current_frame_ 的引用前需要先 unpin
-        tree_handler_.file_buffer_pool_->unpin_page(current_frame_);
-        current_frame_ = nullptr;
-        return RC::SUCCESS;
-      }
-      rc = tree_handler_.file_buffer_pool_->get_this_page(next_page_num, &current_frame_);
-      if (rc != RC::SUCCESS) {
-        LOG_WARN("failed to fetch next page. page num=%d, rc=%s", next_page_num, strrc(rc));
-        return rc;
-      }
-      left_index = 0;
-    }
-    iter_index_ = left_index;
-  }
-
   // 没有指定右边界范围，那么就返回右边界最大值
   if (nullptr == right_user_key) {
     right_key_ = nullptr;
@@ -1838,19 +2334,129 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
     }
   }
 
-  if (touch_end()) {
-    // 释放 current_frame_ 的引用前需要先 unpin
-    tree_handler_.file_buffer_pool_->unpin_page(current_frame_);
-    current_frame_ = nullptr;
+  if (nullptr == left_user_key) {
+    rc = seek(nullptr);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to find left most page. rc=%s", strrc(rc));
+    }
+    return rc;
   }
 
-  return RC::SUCCESS;
+  char *fixed_left_key = const_cast<char *>(left_user_key);
+  if (tree_handler_.file_header_.attrs_type == CHARS) {
+    bool should_inclusive_after_fix = false;
+    rc = fix_user_key(left_user_key, left_len, true /*greater*/, &fixed_left_key, &should_inclusive_after_fix);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to fix left user key. rc=%s", strrc(rc));
+      return rc;
+    }
+    if (should_inclusive_after_fix) {
+      left_inclusive = true;
+    }
+  }
+
+  // 左边界使用最小或最大的 RID，这个键在树中一定不存在，定位到第一个比它大的数据就是扫描的起点
+  MemPoolItem::unique_ptr left_pkey;
+  const char *multi_fixed_left_key[1] = {fixed_left_key};
+  if (left_inclusive) {
+    left_pkey = tree_handler_.make_key(multi_fixed_left_key, *RID::min(), tree_handler_.file_header_.attr_amount, 1, all_in_one_key_left);
+  } else {
+    left_pkey = tree_handler_.make_key(multi_fixed_left_key, *RID::max(), tree_handler_.file_header_.attr_amount, 2, all_in_one_key_left);
+  }
+
+  if (fixed_left_key != left_user_key) {
+    delete[] fixed_left_key;
+    fixed_left_key = nullptr;
+  }
+
+  rc = seek((const char *)left_pkey.get());
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to find left page. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
+RC BplusTreeScanner::seek(const char *key)
+{
+  while (true) {
+    LatchMemo latch_memo(tree_handler_.file_buffer_pool_);
+    Frame *frame = nullptr;
+    RC rc = RC::SUCCESS;
+    if (key == nullptr) {
+      rc = tree_handler_.left_most_page(latch_memo, frame);
+    } else {
+      rc = tree_handler_.find_leaf(latch_memo, BplusTreeOperationType::READ, key, frame);
+    }
+    if (rc == RC::EMPTY) {
+      item_num_ = 0;
+      iter_index_ = 0;
+      next_page_ = BP_INVALID_PAGE_NUM;
+      return RC::SUCCESS;
+    }
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    int index = 0;
+    if (key != nullptr) {
+      LeafIndexNodeHandler node(tree_handler_.file_header_, frame);
+      bool found = false;
+      index = node.lookup(tree_handler_.key_comparator_, key, &found);
+      if (found) {
+        index++;
+      }
+    }
+
+    // 当前叶子节点中没有更大的数据了，沿着兄弟指针向右查找。
+    // 合并节点时会在持有右边节点的锁时给左边的节点加锁，向右加锁可能会死锁，
+    // 所以这里只尝试加锁，失败时放弃所有的锁，重新从根节点查找
+    bool retry = false;
+    while (true) {
+      LeafIndexNodeHandler node(tree_handler_.file_header_, frame);
+      if (index < node.size() || node.next_page() == BP_INVALID_PAGE_NUM) {
+        break;
+      }
+
+      Frame *next_frame = nullptr;
+      rc = latch_memo.get_page(node.next_page(), next_frame);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to fetch next page. page num=%d, rc=%s", node.next_page(), strrc(rc));
+        return rc;
+      }
+      if (!latch_memo.try_slatch(next_frame)) {
+        retry = true;
+        break;
+      }
+      frame = next_frame;
+      index = 0;
+    }
+
+    if (retry) {
+      latch_memo.release();
+      std::this_thread::yield();
+      continue;
+    }
+
+    load_items(frame, index);
+    return RC::SUCCESS;
+  }
+}
+
+void BplusTreeScanner::load_items(Frame *frame, int index)
+{
+  LeafIndexNodeHandler node(tree_handler_.file_header_, frame);
+  const int item_size = tree_handler_.file_header_.key_length + sizeof(RID);
+  item_num_ = node.size() - index;
+  iter_index_ = 0;
+  next_page_ = node.next_page();
+  items_.resize(static_cast<size_t>(item_num_) * item_size);
+  node.read_items(index, node.size(), items_.data());
 }
 
 void BplusTreeScanner::fetch_item(RID &rid)
 {
-  LeafIndexNodeHandler node(tree_handler_.file_header_, current_frame_);
-  memcpy(&rid, node.value_at(iter_index_), sizeof(rid));
+  const int key_length = tree_handler_.file_header_.key_length;
+  memcpy(&rid, items_.data() + static_cast<size_t>(iter_index_) * (key_length + sizeof(RID)) + key_length, sizeof(rid));
 }
 
 bool BplusTreeScanner::touch_end()
@@ -1859,68 +2465,57 @@ bool BplusTreeScanner::touch_end()
     return false;
   }
 
-  LeafIndexNodeHandler node(tree_handler_.file_header_, current_frame_);
-  const char *this_key = node.key_at(iter_index_);
+  const int key_length = tree_handler_.file_header_.key_length;
+  const char *this_key = items_.data() + static_cast<size_t>(iter_index_) * (key_length + sizeof(RID));
   int compare_result = tree_handler_.key_comparator_(this_key, static_cast<char *>(right_key_.get()));
   return compare_result > 0;
 }
 
 RC BplusTreeScanner::next_entry(RID &rid, bool isdelete)
 {
-  if (nullptr == current_frame_) {
+  const char *key = nullptr;
+  return next_entry(rid, key);
+}
+
+RC BplusTreeScanner::next_entry(RID &rid, const char *&key)
+{
+  if (!inited_) {
     return RC::RECORD_EOF;
   }
 
-  if (!first_emitted_) {
-    fetch_item(rid);
-    first_emitted_ = true;
-
-    if (!isdelete) {
-      iter_index_++;
+  if (iter_index_ >= item_num_) {
+    if (item_num_ == 0 || next_page_ == BP_INVALID_PAGE_NUM) {
+      return RC::RECORD_EOF;
     }
-    return RC::SUCCESS;
-  }
 
-  LeafIndexNodeHandler node(tree_handler_.file_header_, current_frame_);
-  if (iter_index_ < node.size()) {
-    if (touch_end()) {
-      return RC::RECORD_EOF;
+    // 复制数据以后叶子节点可能已经分裂或者合并，用已经输出的最后一个键重新定位
+    const int item_size = tree_handler_.file_header_.key_length + sizeof(RID);
+    std::vector<char> last_key(items_.end() - item_size, items_.end() - sizeof(RID));
+    RC rc = seek(last_key.data());
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to fetch next leaf page. rc=%s", strrc(rc));
+      return rc;
     }
-    fetch_item(rid);
-    if (!isdelete) {
-      iter_index_++;
+    if (item_num_ == 0) {
+      return RC::RECORD_EOF;
     }
-    return RC::SUCCESS;
   }
 
-  RC rc = RC::SUCCESS;
-  PageNum next_page_num = node.next_page();
-  if (BP_INVALID_PAGE_NUM == next_page_num) {
+  if (touch_end()) {
     return RC::RECORD_EOF;
   }
 
-  // 准备获取下一页的数据，先释放当前页
-  tree_handler_.file_buffer_pool_->unpin_page(current_frame_);
-  current_frame_ = nullptr;
-
-  rc = tree_handler_.file_buffer_pool_->get_this_page(next_page_num, &current_frame_);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to get next page. page num=%d, rc=%s", next_page_num, strrc(rc));
-    return rc;
-  }
-
-  //  iter_index_ = -1; // `next` will add 1
-  iter_index_ = 0;
-  return next_entry(rid, isdelete);
+  fetch_item(rid);
+  key = items_.data() + static_cast<size_t>(iter_index_) * (tree_handler_.file_header_.key_length + sizeof(RID));
+  iter_index_++;
+  return RC::SUCCESS;
 }
 
 RC BplusTreeScanner::close()
 {
-  if (current_frame_ != nullptr) {
-    // 在 scanner 关闭时释放 current_frame_ 的引用
-    tree_handler_.file_buffer_pool_->unpin_page(current_frame_);
-    current_frame_ = nullptr;
-  }
+  items_.clear();
+  item_num_ = 0;
+  iter_index_ = 0;
   inited_ = false;
   LOG_TRACE("bplus tree scanner closed");
   return RC::SUCCESS;
@@ -1975,3 +2570,392 @@ RC BplusTreeScanner::fix_user_key(const char *user_key, int key_len, bool want_g
   *fixed_key = key_buf;
   return RC::SUCCESS;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+BplusTreeBulkLoader::BplusTreeBulkLoader(BplusTreeHandler &tree_handler, int fill_factor, size_t memory_limit)
+    : tree_handler_(tree_handler),
+      file_header_(tree_handler.file_header_),
+      file_buffer_pool_(tree_handler.file_buffer_pool_),
+      sorter_(memory_limit)
+{
+  // 低于一半时节点会少于 min_size
+  fill_factor_ = (fill_factor > 0 && fill_factor <= 100) ? std::max(fill_factor, 50) : DEFAULT_FILL_FACTOR;
+}
+
+BplusTreeBulkLoader::~BplusTreeBulkLoader()
+{
+  release();
+}
+
+void BplusTreeBulkLoader::release()
+{
+  for (Level &level : levels_) {
+    for (Frame **frame : {&level.prev, &level.cur}) {
+      if (*frame != nullptr) {
+        file_buffer_pool_->unpin_page(*frame);
+        *frame = nullptr;
+      }
+    }
+  }
+}
+
+void BplusTreeBulkLoader::make_sort_key(const char *key, std::string &sort_key) const
+{
+  auto append_uint32 = [&sort_key](uint32_t v) {
+    for (int i = 3; i >= 0; i--) {
+      sort_key.push_back(static_cast<char>((v >> (i * 8)) & 0xFF));
+    }
+  };
+
+  sort_key.clear();
+  switch (file_header_.attrs_type) {
+    case INTS:
+    case DATES: {
+      int32_t v;
+      memcpy(&v, key, sizeof(v));
+      append_uint32(static_cast<uint32_t>(v) ^ 0x80000000U);
+    } break;
+    case FLOATS: {
+      float f;
+      memcpy(&f, key, sizeof(f));
+      f += 0.0f;  // -0.0 与 0.0 相同
+      uint32_t bits;
+      memcpy(&bits, &f, sizeof(bits));
+      bits = (bits & 0x80000000U) ? ~bits : (bits | 0x80000000U);
+      append_uint32(bits);
+    } break;
+    default: {
+      // 字符串和多个字段的索引都是按字节比较
+      sort_key.append(key, file_header_.attrs_length);
+    } break;
+  }
+
+  RID rid;
+  memcpy(&rid, key + file_header_.attrs_length, sizeof(rid));
+  append_uint32(static_cast<uint32_t>(rid.page_num) ^ 0x80000000U);
+  append_uint32(static_cast<uint32_t>(rid.slot_num) ^ 0x80000000U);
+}
+
+RC BplusTreeBulkLoader::add(const char *multi_keys[], const RID &rid, int multi_keys_amount)
+{
+  MemPoolItem::unique_ptr pkey = tree_handler_.make_key(multi_keys, rid, multi_keys_amount);
+  if (pkey == nullptr) {
+    LOG_WARN("Failed to alloc memory for key.");
+    return RC::NOMEM;
+  }
+
+  const char *key = static_cast<const char *>(pkey.get());
+  make_sort_key(key, sort_key_);
+  payload_.assign(key, file_header_.key_length);
+  RC rc = sorter_.add(sort_key_, payload_);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to add key into sorter. rc=%s", strrc(rc));
+    return rc;
+  }
+  entry_num_++;
+  return RC::SUCCESS;
+}
+
+RC BplusTreeBulkLoader::finish()
+{
+  if (file_header_.root_page != BP_INVALID_PAGE_NUM) {
+    LOG_WARN("cannot bulk load a non-empty tree. root page=%d", file_header_.root_page);
+    return RC::INTERNAL;
+  }
+
+  RC rc = sorter_.finish();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to sort keys. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  const char *key = nullptr;
+  int key_len = 0;
+  while ((rc = sorter_.next(key, key_len)) == RC::SUCCESS) {
+    if (!last_key_.empty() && tree_handler_.key_comparator_(key, last_key_.data()) <= 0) {
+      stragglers_.insert(stragglers_.end(), key, key + key_len);
+      continue;
+    }
+
+    rc = append_to_leaf(key);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    last_key_.assign(key, key + key_len);
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to fetch sorted keys. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (!levels_.empty()) {
+    PageNum root_page = BP_INVALID_PAGE_NUM;
+    rc = build_upper_levels(root_page);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    rc = set_root(root_page);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
+  LOG_INFO("bulk load bplus tree done. entries=%ld, levels=%d, stragglers=%d, sort runs=%d",
+           entry_num_, static_cast<int>(levels_.size()),
+           static_cast<int>(stragglers_.size() / file_header_.key_length), sorter_.run_num());
+  return insert_stragglers();
+}
+
+bool BplusTreeBulkLoader::node_full(Frame *frame, const char *key) const
+{
+  IndexNodeHandler node(file_header_, frame);
+  const int max_size = node.max_size();
+  const int min_size = node.min_size();
+  const int fill_size = std::min(std::max(max_size * fill_factor_ / 100, min_size), max_size);
+  if (node.size() >= fill_size) {
+    return true;
+  }
+  // 压缩格式下还要看压缩以后的大小，不足 min_size 时尽量放满整个页面
+  if (node.size() >= min_size && !node.can_insert(key, fill_factor_)) {
+    return true;
+  }
+  return !node.can_insert(key);
+}
+
+RC BplusTreeBulkLoader::append_to_leaf(const char *key)
+{
+  if (levels_.empty()) {
+    levels_.emplace_back();
+  }
+  if (levels_[0].cur == nullptr || node_full(levels_[0].cur, key)) {
+    RC rc = start_node(0);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
+  Frame *frame = levels_[0].cur;
+  LeafIndexNodeHandler leaf_node(file_header_, frame);
+  leaf_node.insert(leaf_node.size(), key, key + file_header_.attrs_length);
+  frame->mark_dirty();
+  return RC::SUCCESS;
+}
+
+RC BplusTreeBulkLoader::append_to_internal(int level_index, const char *key, Frame *child_frame)
+{
+  if (level_index >= static_cast<int>(levels_.size())) {
+    levels_.emplace_back();
+  }
+  if (levels_[level_index].cur == nullptr || node_full(levels_[level_index].cur, key)) {
+    RC rc = start_node(level_index);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
+  Frame *frame = levels_[level_index].cur;
+  InternalIndexNodeHandler internal_node(file_header_, frame);
+  internal_node.append(key, child_frame->page_num());
+  frame->mark_dirty();
+
+  IndexNodeHandler child_node(file_header_, child_frame);
+  child_node.set_parent_page_num(frame->page_num());
+  child_frame->mark_dirty();
+  return RC::SUCCESS;
+}
+
+RC BplusTreeBulkLoader::start_node(int level_index)
+{
+  Frame *frame = nullptr;
+  RC rc = file_buffer_pool_->allocate_page(&frame);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to allocate page. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  Level &level = levels_[level_index];
+  if (level_index == 0) {
+    LeafIndexNodeHandler leaf_node(file_header_, frame);
+    leaf_node.init_empty();
+    if (level.cur != nullptr) {
+      LeafIndexNodeHandler old_leaf_node(file_header_, level.cur);
+      old_leaf_node.set_next_page(frame->page_num());
+      level.cur->mark_dirty();
+    }
+  } else {
+    InternalIndexNodeHandler internal_node(file_header_, frame);
+    internal_node.init_empty();
+  }
+  frame->mark_dirty();
+
+  // 倒数第三个节点不会再调整，可以追加到上一层中了
+  Frame *finished_frame = level.prev;
+  level.prev = level.cur;
+  level.cur = frame;
+  if (finished_frame != nullptr) {
+    return push_node(level_index, finished_frame);
+  }
+  return RC::SUCCESS;
+}
+
+/**
+ * 把写完的节点追加到上一层中，并释放页面的引用
+ */
+RC BplusTreeBulkLoader::push_node(int level_index, Frame *frame)
+{
+  std::vector<char> separator(file_header_.key_length);
+  if (level_index == 0) {
+    LeafIndexNodeHandler leaf_node(file_header_, frame);
+    if (last_pushed_key_.empty()) {
+      memcpy(separator.data(), leaf_node.key_at(0), file_header_.key_length);
+    } else {
+      tree_handler_.make_separator(last_pushed_key_.data(), leaf_node.key_at(0), separator.data());
+    }
+    const char *last_key = leaf_node.key_at(leaf_node.size() - 1);
+    last_pushed_key_.assign(last_key, last_key + file_header_.key_length);
+  } else {
+    // 内部节点的第一个键就是它在上一层中的分隔键
+    InternalIndexNodeHandler internal_node(file_header_, frame);
+    memcpy(separator.data(), internal_node.key_at(0), file_header_.key_length);
+  }
+
+  RC rc = append_to_internal(level_index + 1, separator.data(), frame);
+  file_buffer_pool_->unpin_page(frame);
+  return rc;
+}
+
+/**
+ * 最后一个节点不足 min_size 时与前一个节点合并，合并不下就两个节点重新平分
+ */
+RC BplusTreeBulkLoader::balance_last_nodes(int level_index)
+{
+  Level &level = levels_[level_index];
+  if (level.prev == nullptr) {
+    return RC::SUCCESS;
+  }
+
+  IndexNodeHandler prev_node(file_header_, level.prev);
+  IndexNodeHandler cur_node(file_header_, level.cur);
+  if (cur_node.size() >= cur_node.min_size()) {
+    return RC::SUCCESS;
+  }
+
+  const int item_size = prev_node.item_size();
+  const int prev_size = prev_node.size();
+  const int num = prev_size + cur_node.size();
+  std::vector<char> items(static_cast<size_t>(num) * item_size);
+  prev_node.read_items(0, prev_size, items.data());
+  cur_node.read_items(0, cur_node.size(), items.data() + static_cast<size_t>(prev_size) * item_size);
+
+  RC rc = RC::SUCCESS;
+  level.prev->mark_dirty();
+  level.cur->mark_dirty();
+  if (prev_node.write_items(items.data(), num)) {
+    if (level_index == 0) {
+      LeafIndexNodeHandler(file_header_, level.prev).set_next_page(BP_INVALID_PAGE_NUM);
+    } else {
+      rc = InternalIndexNodeHandler(file_header_, level.prev).adopt_children(prev_size, num, file_buffer_pool_);
+    }
+
+    disposed_pages_.push_back(level.cur->page_num());
+    file_buffer_pool_->unpin_page(level.cur);
+    level.cur = level.prev;
+    level.prev = nullptr;
+    return rc;
+  }
+
+  const int split_index = prev_node.split_point(items.data(), num);
+  if (split_index < 0) {
+    LOG_WARN("cannot find split point. item num=%d", num);
+    return RC::INTERNAL;
+  }
+  prev_node.write_items(items.data(), split_index);
+  cur_node.write_items(items.data() + static_cast<size_t>(split_index) * item_size, num - split_index);
+  if (level_index > 0) {
+    rc = InternalIndexNodeHandler(file_header_, level.cur).adopt_children(0, cur_node.size(), file_buffer_pool_);
+  }
+  return rc;
+}
+
+/**
+ * 从叶子节点开始逐层把剩下的节点追加到上一层中，直到某一层只剩一个节点，就是根节点
+ */
+RC BplusTreeBulkLoader::build_upper_levels(PageNum &root_page)
+{
+  for (int i = 0; i < static_cast<int>(levels_.size()); i++) {
+    RC rc = balance_last_nodes(i);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to balance last nodes. level=%d, rc=%s", i, strrc(rc));
+      return rc;
+    }
+
+    if (i + 1 == static_cast<int>(levels_.size()) && levels_[i].prev == nullptr) {
+      root_page = levels_[i].cur->page_num();
+      return RC::SUCCESS;
+    }
+
+    // push_node 可能会在 levels_ 中增加新的一层，不能持有 levels_ 中元素的引用
+    Frame *frames[] = {levels_[i].prev, levels_[i].cur};
+    levels_[i].prev = nullptr;
+    levels_[i].cur = nullptr;
+    for (Frame *frame : frames) {
+      if (frame == nullptr) {
+        continue;
+      }
+      if (rc == RC::SUCCESS) {
+        rc = push_node(i, frame);
+      } else {
+        file_buffer_pool_->unpin_page(frame);
+      }
+    }
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to append node to upper level. level=%d, rc=%s", i, strrc(rc));
+      return rc;
+    }
+  }
+  return RC::INTERNAL;
+}
+
+RC BplusTreeBulkLoader::set_root(PageNum root_page)
+{
+  release();
+  for (PageNum page_num : disposed_pages_) {
+    RC rc = file_buffer_pool_->dispose_page(page_num);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to dispose page. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+  }
+  disposed_pages_.clear();
+
+  tree_handler_.root_lock_.lock();
+  tree_handler_.update_root_page_num_locked(root_page);
+  tree_handler_.root_lock_.unlock();
+  return RC::SUCCESS;
+}
+
+RC BplusTreeBulkLoader::insert_stragglers()
+{
+  const int key_length = file_header_.key_length;
+  for (size_t offset = 0; offset < stragglers_.size(); offset += key_length) {
+    const char *key = stragglers_.data() + offset;
+
+    const char *multi_keys[MAX_FIELD_AMOUNT];
+    int attr_offset = 0;
+    for (int i = 0; i < file_header_.attr_amount; i++) {
+      multi_keys[i] = key + attr_offset;
+      attr_offset += file_header_.multi_attr_lengths[i];
+    }
+    RID rid;
+    memcpy(&rid, key + file_header_.attrs_length, sizeof(rid));
+
+    RC rc = tree_handler_.insert_entry(multi_keys, &rid, file_header_.attr_amount);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to insert entry. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+  }
+  stragglers_.clear();
+  return RC::SUCCESS;
+}
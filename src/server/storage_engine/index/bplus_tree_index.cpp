@@ -1,11 +1,13 @@
 #include "include/storage_engine/index/bplus_tree_index.h"
+#include "common/os/process_param.h"
 
 BplusTreeIndex::~BplusTreeIndex() noexcept
 {
   close();
 }
 
-RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, const std::vector<FieldMeta> &multi_field_metas)
+RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, const std::vector<FieldMeta> &multi_field_metas,
+                          bool key_compressed)
 {
   if (inited_) {
     LOG_WARN("Failed to create index due to the index has been inited before. file_name:%s, index:%s, field_amount:%d, field_names:%s",
@@ -25,7 +27,10 @@ RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, co
     multi_attr_length.emplace_back(multi_field_metas[i].len());
   }
 
-  RC rc = index_handler_.create(file_name, index_meta.is_unique(), multi_attr_types, multi_attr_length);
+  // 是否压缩记录在索引文件中，打开已有的索引时不受这个参数影响
+  key_compressed = key_compressed || common::the_process_param()->index_key_compressed();
+  RC rc = index_handler_.create(file_name, index_meta.is_unique(), multi_attr_types, multi_attr_length,
+                                -1 /*internal_max_size*/, -1 /*leaf_max_size*/, key_compressed);
   if (RC::SUCCESS != rc) {
     LOG_WARN("Failed to create index_handler, file_name:%s, index:%s, field_amount:%d, field_names:%s rc:%s",
              file_name,
@@ -148,6 +153,92 @@ RC BplusTreeIndex::delete_entry(const char *record, const RID *rid)
   return rc;
 }
 
+RC BplusTreeIndex::bulk_load(RecordFileScanner &scanner)
+{
+  const int memory_size = common::the_process_param()->sort_memory_size();
+  const int fill_factor = common::the_process_param()->index_fill_factor();
+  BplusTreeBulkLoader loader(index_handler_,
+                             fill_factor > 0 ? fill_factor : BplusTreeBulkLoader::DEFAULT_FILL_FACTOR,
+                             memory_size > 0 ? static_cast<size_t>(memory_size) : ExternalSorter::DEFAULT_MEMORY_LIMIT);
+
+  RC rc = RC::SUCCESS;
+  Record record;
+  const char *field_values[index_meta_.field_amount()];
+  while (scanner.has_next()) {
+    rc = scanner.next(record);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to scan records while loading index. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    for (int i = 0; i < index_meta_.field_amount(); i++) {
+      field_values[i] = record.data() + multi_field_metas_[i].offset();
+    }
+    rc = loader.add(field_values, record.rid(), index_meta_.field_amount());
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to add index entry. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  rc = loader.finish();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to build index. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
+RC BplusTreeIndex::insert_entries(const std::vector<RID> &rids)
+{
+  if (rids.empty()) {
+    return RC::SUCCESS;
+  }
+
+  std::unique_ptr<BplusTreeBulkLoader> loader;
+  if (index_handler_.is_empty()) {
+    const int memory_size = common::the_process_param()->sort_memory_size();
+    const int fill_factor = common::the_process_param()->index_fill_factor();
+    loader = std::make_unique<BplusTreeBulkLoader>(
+        index_handler_,
+        fill_factor > 0 ? fill_factor : BplusTreeBulkLoader::DEFAULT_FILL_FACTOR,
+        memory_size > 0 ? static_cast<size_t>(memory_size) : ExternalSorter::DEFAULT_MEMORY_LIMIT);
+  }
+
+  RC rc = RC::SUCCESS;
+  const char *field_values[index_meta_.field_amount()];
+  auto adder = [&](Record &record) {
+    for (int i = 0; i < index_meta_.field_amount(); i++) {
+      field_values[i] = record.data() + multi_field_metas_[i].offset();
+    }
+    if (loader != nullptr) {
+      rc = loader->add(field_values, record.rid(), index_meta_.field_amount());
+    } else {
+      rc = index_handler_.insert_entry(field_values, &record.rid(), index_meta_.field_amount());
+    }
+  };
+
+  for (const RID &rid : rids) {
+    RC visit_rc = table_->visit_record(rid, true /*readonly*/, adder);
+    if (visit_rc != RC::SUCCESS) {
+      LOG_WARN("failed to visit record while inserting index entries. rid=%s, rc=%s",
+               rid.to_string().c_str(), strrc(visit_rc));
+      return visit_rc;
+    }
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to add index entry. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+  }
+
+  if (loader != nullptr) {
+    rc = loader->finish();
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to build index. rc=%s", strrc(rc));
+    }
+  }
+  return rc;
+}
+
 IndexScanner *BplusTreeIndex::create_scanner(
     const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len, bool right_inclusive)
 {
@@ -187,6 +278,11 @@ RC BplusTreeIndexScanner::next_entry(RID *rid, bool isdelete)
   return tree_scanner_.next_entry(*rid, isdelete);
 }
 
+RC BplusTreeIndexScanner::next_entry(RID *rid, const char **key)
+{
+  return tree_scanner_.next_entry(*rid, *key);
+}
+
 RC BplusTreeIndexScanner::destroy()
 {
   delete this;
@@ -1,9 +1,87 @@
 #include "include/storage_engine/index/index.h"
 #include "include/storage_engine/recorder/table.h"
 
+#include <algorithm>
+#include <cstring>
+
 RC Index::init(const IndexMeta &index_meta, const std::vector<FieldMeta> &multi_field_metas)
 {
   index_meta_ = index_meta;
   multi_field_metas_ = multi_field_metas;
   return  RC::SUCCESS;
-}
\ No newline at end of file
+}
+void Index::make_user_key(const std::vector<Value> &values, std::string &key) const
+{
+  key.clear();
+  for (size_t i = 0; i < values.size() && i < multi_field_metas_.size(); i++) {
+    const FieldMeta &field = multi_field_metas_[i];
+    const Value &value = values[i];
+    const size_t offset = key.size();
+    key.resize(offset + field.len(), 0);
+    char *data = &key[offset];
+
+    if (field.type() == CHARS || field.type() == TEXTS) {
+      const std::string str = value.attr_type() == CHARS ? std::string(value.data(), value.length()) : value.get_string();
+      memcpy(data, str.data(), std::min(str.size(), static_cast<size_t>(field.len())));
+    } else if (field.type() == INTS || field.type() == DATES || field.type() == BOOLEANS) {
+      int tmp = value.get_int();
+      memcpy(data, &tmp, std::min(sizeof(tmp), static_cast<size_t>(field.len())));
+    } else if (field.type() == FLOATS) {
+      float tmp = value.get_float();
+      memcpy(data, &tmp, std::min(sizeof(tmp), static_cast<size_t>(field.len())));
+    } else {
+      memcpy(data, value.data(), std::min(static_cast<size_t>(value.length()), static_cast<size_t>(field.len())));
+    }
+  }
+}
+
+RC Index::delete_entry_by_rid(const char *record, const RID *rid)
+{
+  // 第一个字段等于记录中的值，其它字段取最小值和最大值，作为完整的键扫描。多字段索引的键按字节比较
+  int key_len = 0;
+  int record_len = 0;
+  for (const FieldMeta &field : multi_field_metas_) {
+    key_len += field.len();
+    record_len = std::max(record_len, field.offset() + field.len());
+  }
+  const FieldMeta &first_field = multi_field_metas_.front();
+  std::string left_key(key_len, 0);
+  std::string right_key(key_len, static_cast<char>(0xff));
+  memcpy(&left_key[0], record + first_field.offset(), first_field.len());
+  memcpy(&right_key[0], record + first_field.offset(), first_field.len());
+
+  IndexScanner *scanner = create_scanner(left_key.data(), key_len, true /*left_inclusive*/,
+                                         right_key.data(), key_len, true /*right_inclusive*/);
+  if (scanner == nullptr) {
+    return RC::INTERNAL;
+  }
+
+  // 用索引中保存的字段值替换记录中的值，再按照完整的键删除
+  std::vector<char> index_record(record, record + record_len);
+  RC rc = RC::SUCCESS;
+  while (true) {
+    RID entry_rid;
+    const char *key = nullptr;
+    rc = scanner->next_entry(&entry_rid, &key);
+    if (rc != RC::SUCCESS) {
+      break;
+    }
+    if (RID::compare(&entry_rid, rid) != 0) {
+      continue;
+    }
+    for (const FieldMeta &field : multi_field_metas_) {
+      memcpy(index_record.data() + field.offset(), key, field.len());
+      key += field.len();
+    }
+    break;
+  }
+  scanner->destroy();
+
+  if (rc == RC::RECORD_EOF) {
+    return RC::RECORD_INVALID_KEY;
+  }
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  return delete_entry(index_record.data(), rid);
+}
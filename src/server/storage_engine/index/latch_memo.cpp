@@ -0,0 +1,135 @@
+#include "include/storage_engine/index/latch_memo.h"
+#include "include/storage_engine/buffer/buffer_pool.h"
+#include "common/log/log.h"
+
+LatchMemo::LatchMemo(FileBufferPool *buffer_pool) : buffer_pool_(buffer_pool)
+{}
+
+LatchMemo::~LatchMemo()
+{
+  release();
+}
+
+RC LatchMemo::get_page(PageNum page_num, Frame *&frame)
+{
+  frame = nullptr;
+  RC rc = buffer_pool_->get_this_page(page_num, &frame);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to get page. page num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+  items_.emplace_back(LatchMemoType::PIN, frame);
+  return RC::SUCCESS;
+}
+
+RC LatchMemo::allocate_page(Frame *&frame)
+{
+  frame = nullptr;
+  RC rc = buffer_pool_->allocate_page(&frame);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to allocate page. rc=%s", strrc(rc));
+    return rc;
+  }
+  items_.emplace_back(LatchMemoType::PIN, frame);
+  return RC::SUCCESS;
+}
+
+void LatchMemo::dispose_page(PageNum page_num)
+{
+  disposed_pages_.emplace_back(page_num);
+}
+
+void LatchMemo::latch(Frame *frame, LatchMemoType type)
+{
+  switch (type) {
+    case LatchMemoType::EXCLUSIVE: {
+      frame->write_latch();
+    } break;
+    case LatchMemoType::SHARED: {
+      frame->read_latch();
+    } break;
+    default: {
+      ASSERT(false, "invalid latch type: %d", static_cast<int>(type));
+    }
+  }
+  items_.emplace_back(type, frame);
+}
+
+void LatchMemo::xlatch(Frame *frame)
+{
+  latch(frame, LatchMemoType::EXCLUSIVE);
+}
+
+void LatchMemo::slatch(Frame *frame)
+{
+  latch(frame, LatchMemoType::SHARED);
+}
+
+bool LatchMemo::try_slatch(Frame *frame)
+{
+  if (!frame->try_read_latch()) {
+    return false;
+  }
+  items_.emplace_back(LatchMemoType::SHARED, frame);
+  return true;
+}
+
+void LatchMemo::xlatch(common::SharedMutex *lock)
+{
+  lock->lock();
+  items_.emplace_back(LatchMemoType::EXCLUSIVE, lock);
+}
+
+void LatchMemo::slatch(common::SharedMutex *lock)
+{
+  lock->lock_shared();
+  items_.emplace_back(LatchMemoType::SHARED, lock);
+}
+
+void LatchMemo::release_item(LatchMemoItem &item)
+{
+  switch (item.type) {
+    case LatchMemoType::EXCLUSIVE: {
+      if (item.frame != nullptr) {
+        item.frame->write_unlatch();
+      } else {
+        item.lock->unlock();
+      }
+    } break;
+    case LatchMemoType::SHARED: {
+      if (item.frame != nullptr) {
+        item.frame->read_unlatch();
+      } else {
+        item.lock->unlock_shared();
+      }
+    } break;
+    case LatchMemoType::PIN: {
+      buffer_pool_->unpin_page(item.frame);
+    } break;
+    default: {
+      ASSERT(false, "invalid latch memo type: %d", static_cast<int>(item.type));
+    }
+  }
+}
+
+void LatchMemo::release_to(int point)
+{
+  ASSERT(point >= 0 && point <= static_cast<int>(items_.size()),
+         "invalid memo point. point=%d, items=%d", point, static_cast<int>(items_.size()));
+
+  // 逆序释放，同一个页面先解锁再释放引用
+  for (int i = point - 1; i >= 0; i--) {
+    release_item(items_[i]);
+  }
+  items_.erase(items_.begin(), items_.begin() + point);
+}
+
+void LatchMemo::release()
+{
+  release_to(memo_point());
+
+  for (PageNum page_num : disposed_pages_) {
+    buffer_pool_->dispose_page(page_num);
+  }
+  disposed_pages_.clear();
+}
@@ -0,0 +1,238 @@
+#include <string.h>
+
+#include "include/storage_engine/recorder/compare_kernel.h"
+#include "common/defs.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define COMPARE_KERNEL_X86 1
+#endif
+
+static const float FLOAT_EPSILON = static_cast<float>(EPSILON);
+
+bool compare_kernel_supported(CompOp comp_op)
+{
+  switch (comp_op) {
+    case EQUAL_TO:
+    case LESS_EQUAL:
+    case NOT_EQUAL:
+    case LESS_THAN:
+    case GREAT_EQUAL:
+    case GREAT_THAN: return true;
+    default: return false;
+  }
+}
+
+/**
+ * @brief 由大于和小于两组比较结果得到最终的结果
+ * @details 每组8个值，gt 的第i位表示第i个值大于常量，lt 表示小于常量，都不是就是相等
+ */
+static inline uint8_t combine_masks(CompOp comp_op, uint32_t gt, uint32_t lt)
+{
+  switch (comp_op) {
+    case EQUAL_TO: return static_cast<uint8_t>(~(gt | lt));
+    case LESS_EQUAL: return static_cast<uint8_t>(~gt);
+    case NOT_EQUAL: return static_cast<uint8_t>(gt | lt);
+    case LESS_THAN: return static_cast<uint8_t>(lt);
+    case GREAT_EQUAL: return static_cast<uint8_t>(~lt);
+    case GREAT_THAN: return static_cast<uint8_t>(gt);
+    default: return 0;
+  }
+}
+
+static inline void compare_one(int32_t value, int32_t constant, bool &gt, bool &lt)
+{
+  gt = value > constant;
+  lt = value < constant;
+}
+
+static inline void compare_one(float value, float constant, bool &gt, bool &lt)
+{
+  const float cmp = value - constant;
+  gt = cmp > FLOAT_EPSILON;
+  lt = cmp < -FLOAT_EPSILON;
+}
+
+/**
+ * @brief 逐个比较从第 start 个开始的剩余的值，SIMD 实现用它处理最后不足一组的部分
+ */
+template <typename T>
+static void compare_scalar(const char *data, int stride, int start, int count, CompOp comp_op, T constant, char *bitmap)
+{
+  for (int byte_start = start; byte_start < count; byte_start += 8) {
+    const int n = count - byte_start < 8 ? count - byte_start : 8;
+    uint32_t gt = 0;
+    uint32_t lt = 0;
+    for (int i = 0; i < n; i++) {
+      T value;
+      memcpy(&value, data + static_cast<size_t>(byte_start + i) * stride, sizeof(value));
+      bool value_gt = false;
+      bool value_lt = false;
+      compare_one(value, constant, value_gt, value_lt);
+      gt |= static_cast<uint32_t>(value_gt) << i;
+      lt |= static_cast<uint32_t>(value_lt) << i;
+    }
+    const uint8_t valid = static_cast<uint8_t>((1u << n) - 1);
+    bitmap[byte_start / 8] = static_cast<char>(combine_masks(comp_op, gt, lt) & valid);
+  }
+}
+
+#ifndef COMPARE_KERNEL_X86
+static void compare_int32_scalar(const char *data, int stride, int count, CompOp comp_op, int32_t constant, char *bitmap)
+{
+  compare_scalar<int32_t>(data, stride, 0, count, comp_op, constant, bitmap);
+}
+
+static void compare_float_scalar(const char *data, int stride, int count, CompOp comp_op, float constant, char *bitmap)
+{
+  compare_scalar<float>(data, stride, 0, count, comp_op, constant, bitmap);
+}
+#endif
+
+#ifdef COMPARE_KERNEL_X86
+
+////////////////////////////////////////////////////////////////////////////////
+// SSE2，x86_64 上总是可用，一次比较4个值
+
+static inline __m128i load_int32x4(const char *data, int stride)
+{
+  if (stride == 4) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+  }
+  int32_t v[4];
+  for (int i = 0; i < 4; i++) {
+    memcpy(&v[i], data + i * stride, sizeof(int32_t));
+  }
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(v));
+}
+
+static inline __m128 load_floatx4(const char *data, int stride)
+{
+  if (stride == 4) {
+    return _mm_loadu_ps(reinterpret_cast<const float *>(data));
+  }
+  float v[4];
+  for (int i = 0; i < 4; i++) {
+    memcpy(&v[i], data + i * stride, sizeof(float));
+  }
+  return _mm_loadu_ps(v);
+}
+
+static void compare_int32_sse2(const char *data, int stride, int count, CompOp comp_op, int32_t constant, char *bitmap)
+{
+  const __m128i c = _mm_set1_epi32(constant);
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const char *p = data + static_cast<size_t>(i) * stride;
+    const __m128i v0 = load_int32x4(p, stride);
+    const __m128i v1 = load_int32x4(p + 4 * stride, stride);
+    const uint32_t gt = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(v0, c))) |
+                        (_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(v1, c))) << 4);
+    const uint32_t lt = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v0, c))) |
+                        (_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v1, c))) << 4);
+    bitmap[i / 8] = static_cast<char>(combine_masks(comp_op, gt, lt));
+  }
+  compare_scalar<int32_t>(data, stride, i, count, comp_op, constant, bitmap);
+}
+
+static void compare_float_sse2(const char *data, int stride, int count, CompOp comp_op, float constant, char *bitmap)
+{
+  const __m128 c = _mm_set1_ps(constant);
+  const __m128 eps = _mm_set1_ps(FLOAT_EPSILON);
+  const __m128 neg_eps = _mm_set1_ps(-FLOAT_EPSILON);
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const char *p = data + static_cast<size_t>(i) * stride;
+    const __m128 d0 = _mm_sub_ps(load_floatx4(p, stride), c);
+    const __m128 d1 = _mm_sub_ps(load_floatx4(p + 4 * stride, stride), c);
+    const uint32_t gt = _mm_movemask_ps(_mm_cmpgt_ps(d0, eps)) | (_mm_movemask_ps(_mm_cmpgt_ps(d1, eps)) << 4);
+    const uint32_t lt = _mm_movemask_ps(_mm_cmplt_ps(d0, neg_eps)) | (_mm_movemask_ps(_mm_cmplt_ps(d1, neg_eps)) << 4);
+    bitmap[i / 8] = static_cast<char>(combine_masks(comp_op, gt, lt));
+  }
+  compare_scalar<float>(data, stride, i, count, comp_op, constant, bitmap);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX2，运行时检测到CPU支持时使用，一次比较8个值。不在页面上连续存放时使用gather指令
+
+__attribute__((target("avx2"))) static void compare_int32_avx2(
+    const char *data, int stride, int count, CompOp comp_op, int32_t constant, char *bitmap)
+{
+  const __m256i c = _mm256_set1_epi32(constant);
+  const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride));
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const char *p = data + static_cast<size_t>(i) * stride;
+    const __m256i v = stride == 4 ? _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p))
+                                  : _mm256_i32gather_epi32(reinterpret_cast<const int *>(p), offsets, 1);
+    const uint32_t gt = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, c)));
+    const uint32_t lt = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(c, v)));
+    bitmap[i / 8] = static_cast<char>(combine_masks(comp_op, gt, lt));
+  }
+  compare_scalar<int32_t>(data, stride, i, count, comp_op, constant, bitmap);
+}
+
+__attribute__((target("avx2"))) static void compare_float_avx2(
+    const char *data, int stride, int count, CompOp comp_op, float constant, char *bitmap)
+{
+  const __m256 c = _mm256_set1_ps(constant);
+  const __m256 eps = _mm256_set1_ps(FLOAT_EPSILON);
+  const __m256 neg_eps = _mm256_set1_ps(-FLOAT_EPSILON);
+  const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride));
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const char *p = data + static_cast<size_t>(i) * stride;
+    const __m256 v = stride == 4 ? _mm256_loadu_ps(reinterpret_cast<const float *>(p))
+                                 : _mm256_i32gather_ps(reinterpret_cast<const float *>(p), offsets, 1);
+    const __m256 d = _mm256_sub_ps(v, c);
+    const uint32_t gt = _mm256_movemask_ps(_mm256_cmp_ps(d, eps, _CMP_GT_OQ));
+    const uint32_t lt = _mm256_movemask_ps(_mm256_cmp_ps(d, neg_eps, _CMP_LT_OQ));
+    bitmap[i / 8] = static_cast<char>(combine_masks(comp_op, gt, lt));
+  }
+  compare_scalar<float>(data, stride, i, count, comp_op, constant, bitmap);
+}
+
+#endif  // COMPARE_KERNEL_X86
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief 当前CPU上使用的一组实现，第一次使用时确定
+ */
+struct CompareKernels
+{
+  const char *name;
+  void (*int32_kernel)(const char *data, int stride, int count, CompOp comp_op, int32_t constant, char *bitmap);
+  void (*float_kernel)(const char *data, int stride, int count, CompOp comp_op, float constant, char *bitmap);
+};
+
+static CompareKernels select_kernels()
+{
+#ifdef COMPARE_KERNEL_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return CompareKernels{"avx2", compare_int32_avx2, compare_float_avx2};
+  }
+  return CompareKernels{"sse2", compare_int32_sse2, compare_float_sse2};
+#else
+  return CompareKernels{"scalar", compare_int32_scalar, compare_float_scalar};
+#endif
+}
+
+static const CompareKernels &kernels()
+{
+  static const CompareKernels instance = select_kernels();
+  return instance;
+}
+
+void compare_int32(const char *data, int stride, int count, CompOp comp_op, int32_t constant, char *bitmap)
+{
+  kernels().int32_kernel(data, stride, count, comp_op, constant, bitmap);
+}
+
+void compare_float(const char *data, int stride, int count, CompOp comp_op, float constant, char *bitmap)
+{
+  kernels().float_kernel(data, stride, count, comp_op, constant, bitmap);
+}
+
+const char *compare_kernel_name() { return kernels().name; }
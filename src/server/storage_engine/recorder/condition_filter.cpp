@@ -1,7 +1,22 @@
+#include <string.h>
+#include <vector>
+
 #include "include/storage_engine/recorder/condition_filter.h"
+#include "include/storage_engine/recorder/compare_kernel.h"
+#include "common/lang/bitmap.h"
 
 using namespace common;
 
+// 记录中这个属性的值是否为null
+static bool attr_is_null(const ConDesc &attr, const char *record)
+{
+  if (!attr.is_attr || attr.null_bitmap_offset < 0) {
+    return false;
+  }
+  Bitmap null_bitmap(const_cast<char *>(record) + attr.null_bitmap_offset, attr.null_bit + 1);
+  return null_bitmap.get_bit(attr.null_bit);
+}
+
 ConditionFilter::~ConditionFilter()
 {}
 
@@ -79,14 +94,19 @@ bool DefaultConditionFilter::filter(const Record &rec) const
     right_value.set_value(right_.value);
   }
 
+  const bool attr_null = attr_is_null(left_, rec.data()) || attr_is_null(right_, rec.data());
+  if (attr_null && comp_op_ != CompOp::IS_NULL && comp_op_ != CompOp::IS_NOT_NULL) {
+    return false;
+  }
+
   if (comp_op_ == CompOp::IS_NULL) {
     assert(right_value.is_null());
-    return left_value.is_null();
+    return attr_null || left_value.is_null();
   }
 
   if (comp_op_ == CompOp::IS_NOT_NULL) {
     assert(right_value.is_null());
-    return !left_value.is_null();
+    return !attr_null && !left_value.is_null();
   }
 
   if (left_value.is_null() || right_value.is_null()) {
@@ -117,6 +137,51 @@ bool DefaultConditionFilter::filter(const Record &rec) const
   return cmp_result;  // should not go here
 }
 
+bool DefaultConditionFilter::filter_page(const char *records, int record_size, int record_num, char *bitmap) const
+{
+  if (!compare_kernel_supported(comp_op_) || left_.is_attr == right_.is_attr) {
+    return false;
+  }
+  if (attr_type_ != INTS && attr_type_ != DATES && attr_type_ != FLOATS) {
+    return false;
+  }
+
+  // 统一成 字段 op 值 的形式，值在左边时交换比较的方向
+  const ConDesc &attr = left_.is_attr ? left_ : right_;
+  const Value &value = left_.is_attr ? right_.value : left_.value;
+  CompOp comp_op = comp_op_;
+  if (!left_.is_attr) {
+    switch (comp_op_) {
+      case LESS_EQUAL: comp_op = GREAT_EQUAL; break;
+      case LESS_THAN: comp_op = GREAT_THAN; break;
+      case GREAT_EQUAL: comp_op = LESS_EQUAL; break;
+      case GREAT_THAN: comp_op = LESS_THAN; break;
+      default: break;
+    }
+  }
+  if (attr.attr_length != 4 || value.is_null() || value.attr_type() != attr_type_) {
+    return false;
+  }
+
+  const char *data = records + attr.attr_offset;
+  if (attr_type_ == FLOATS) {
+    compare_float(data, record_size, record_num, comp_op, value.get_float(), bitmap);
+  } else {
+    compare_int32(data, record_size, record_num, comp_op, *reinterpret_cast<const int32_t *>(value.data()), bitmap);
+  }
+
+  // 为null的属性在记录中的数据是无效的，与null比较的结果总是false
+  if (attr.null_bitmap_offset >= 0) {
+    Bitmap result(bitmap, record_num);
+    for (int i = result.next_setted_bit(0); i >= 0 && i < record_num; i = result.next_setted_bit(i + 1)) {
+      if (attr_is_null(attr, records + static_cast<size_t>(i) * record_size)) {
+        result.clear_bit(i);
+      }
+    }
+  }
+  return true;
+}
+
 CompositeConditionFilter::~CompositeConditionFilter()
 {
   if (memory_owner_) {
@@ -175,3 +240,26 @@ bool CompositeConditionFilter::filter(const Record &rec) const
   }
   return true;
 }
+
+bool CompositeConditionFilter::filter_page(const char *records, int record_size, int record_num, char *bitmap) const
+{
+  const int bitmap_size = (record_num + 7) / 8;
+  if (filter_num_ == 0) {
+    memset(bitmap, 0xFF, bitmap_size);
+    return true;
+  }
+
+  if (!filters_[0]->filter_page(records, record_size, record_num, bitmap)) {
+    return false;
+  }
+  std::vector<char> child_bitmap(bitmap_size);
+  for (int i = 1; i < filter_num_; i++) {
+    if (!filters_[i]->filter_page(records, record_size, record_num, child_bitmap.data())) {
+      return false;
+    }
+    for (int j = 0; j < bitmap_size; j++) {
+      bitmap[j] &= child_bitmap[j];
+    }
+  }
+  return true;
+}
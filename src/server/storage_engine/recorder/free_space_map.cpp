@@ -0,0 +1,184 @@
+#include "include/storage_engine/recorder/free_space_map.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#include "common/io/io.h"
+#include "common/log/log.h"
+
+using namespace common;
+
+namespace {
+
+/**
+ * @brief 空闲空间表文件的文件头，后面紧跟着位图
+ */
+struct FsmFileHeader
+{
+  static constexpr int32_t MAGIC = 0x4653'4d31;  // "FSM1"
+
+  int32_t magic;
+  int32_t page_count;  // 写入位图时数据文件的页面个数
+  int32_t clean;       // 是否正常关闭。打开以后就设置为0，关闭时写完位图再设置为1
+  int32_t reserved;
+};
+
+int word_count(int page_count) { return (page_count + 63) / 64; }
+
+}  // namespace
+
+FreeSpaceMap::FreeSpaceMap() : words_(new std::atomic<uint64_t>[WORD_NUM]()) {}
+
+FreeSpaceMap::~FreeSpaceMap() { close(); }
+
+RC FreeSpaceMap::open(const char *file_name, int page_count, bool &loaded)
+{
+  loaded = false;
+  for (int i = 0; i < WORD_NUM; i++) {
+    words_[i].store(0, std::memory_order_relaxed);
+  }
+  page_count_.store(page_count, std::memory_order_release);
+  if (file_name == nullptr || file_name[0] == '\0') {
+    return RC::SUCCESS;
+  }
+
+  int fd = ::open(file_name, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    LOG_ERROR("Failed to open free space map file. file=%s, errmsg=%s", file_name, strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+  file_name_ = file_name;
+  file_desc_ = fd;
+
+  FsmFileHeader header;
+  if (preadn(fd, &header, sizeof(header), 0) == 0 && header.magic == FsmFileHeader::MAGIC && header.clean == 1 &&
+      header.page_count == page_count) {
+    const int words = word_count(page_count);
+    std::unique_ptr<uint64_t[]> buffer(new uint64_t[words]);
+    if (preadn(fd, buffer.get(), words * sizeof(uint64_t), sizeof(header)) == 0) {
+      for (int i = 0; i < words; i++) {
+        words_[i].store(buffer[i], std::memory_order_relaxed);
+      }
+      loaded = true;
+    }
+  }
+
+  // 运行期间位图只在内存中修改，文件中的位图是过期的，异常退出以后不能再使用
+  RC rc = write_header(false /*clean*/);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  LOG_INFO("open free space map. file=%s, page count=%d, loaded=%d", file_name, page_count, loaded);
+  return RC::SUCCESS;
+}
+
+RC FreeSpaceMap::close()
+{
+  if (file_desc_ < 0) {
+    return RC::SUCCESS;
+  }
+
+  const int words = word_count(page_count());
+  std::unique_ptr<uint64_t[]> buffer(new uint64_t[words]);
+  for (int i = 0; i < words; i++) {
+    buffer[i] = words_[i].load(std::memory_order_relaxed);
+  }
+
+  RC rc = RC::SUCCESS;
+  if (pwriten(file_desc_, buffer.get(), words * sizeof(uint64_t), sizeof(FsmFileHeader)) != 0) {
+    LOG_ERROR("Failed to write free space map. file=%s, errmsg=%s", file_name_.c_str(), strerror(errno));
+    rc = RC::IOERR_WRITE;
+  } else {
+    rc = write_header(true /*clean*/);
+  }
+
+  ::close(file_desc_);
+  file_desc_ = -1;
+  return rc;
+}
+
+RC FreeSpaceMap::write_header(bool clean)
+{
+  FsmFileHeader header;
+  header.magic      = FsmFileHeader::MAGIC;
+  header.page_count = page_count();
+  header.clean      = clean ? 1 : 0;
+  header.reserved   = 0;
+  if (pwriten(file_desc_, &header, sizeof(header), 0) != 0) {
+    LOG_ERROR("Failed to write free space map header. file=%s, errmsg=%s", file_name_.c_str(), strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+  return RC::SUCCESS;
+}
+
+PageNum FreeSpaceMap::claim(PageNum begin, PageNum end)
+{
+  end = std::min(end, page_count());
+  for (PageNum word_begin = begin / WORD_BITS * WORD_BITS; word_begin < end; word_begin += WORD_BITS) {
+    // 只看 [begin, end) 范围内的位
+    uint64_t range = ~0ULL;
+    if (word_begin < begin) {
+      range &= ~0ULL << (begin - word_begin);
+    }
+    if (end - word_begin < WORD_BITS) {
+      range &= (1ULL << (end - word_begin)) - 1;
+    }
+
+    std::atomic<uint64_t> &word = words_[word_begin / WORD_BITS];
+    uint64_t bits = word.load(std::memory_order_relaxed) & range;
+    while (bits != 0) {
+      const uint64_t mask = bits & (~bits + 1);  // 最低的一个1
+      const uint64_t old  = word.fetch_and(~mask, std::memory_order_acq_rel);
+      if (old & mask) {
+        return word_begin + __builtin_ctzll(mask);
+      }
+      // 被其它线程抢先占用了，继续找这个字中剩下的位
+      bits = old & range & ~mask;
+    }
+  }
+  return BP_INVALID_PAGE_NUM;
+}
+
+void FreeSpaceMap::release(PageNum page_num, bool has_free_space)
+{
+  if (has_free_space) {
+    set_free(page_num);
+  }
+}
+
+void FreeSpaceMap::set_free(PageNum page_num)
+{
+  words_[page_num / WORD_BITS].fetch_or(1ULL << (page_num % WORD_BITS), std::memory_order_acq_rel);
+}
+
+void FreeSpaceMap::extend(PageNum page_num)
+{
+  int count = page_count_.load(std::memory_order_acquire);
+  while (count <= page_num && !page_count_.compare_exchange_weak(count, page_num + 1, std::memory_order_acq_rel)) {
+  }
+}
+
+PageNum FreeSpaceMap::start_page() const
+{
+  const int count = page_count();
+  if (count <= 2) {
+    return 1;
+  }
+  // 线程ID的哈希值低位可能都是0，先打散再取模
+  uint64_t hash = std::hash<std::thread::id>()(std::this_thread::get_id()) * 0x9E37'79B9'7F4A'7C15ULL;
+  return 1 + static_cast<PageNum>((hash >> 32) % (count - 1));
+}
+
+int FreeSpaceMap::free_page_count() const
+{
+  int count = 0;
+  const int words = word_count(page_count());
+  for (int i = 0; i < words; i++) {
+    count += __builtin_popcountll(words_[i].load(std::memory_order_relaxed));
+  }
+  return count;
+}
@@ -36,6 +36,31 @@ int page_record_capacity(int page_size, int record_size)
  */
 int page_bitmap_size(int record_capacity) { return (record_capacity + 7) / 8; }
 
+static_assert(offsetof(SlottedPageHeader, page_type) == offsetof(PageHeader, record_size),
+              "page type must share the position with record size");
+static_assert(offsetof(OverflowPageHeader, page_type) == offsetof(PageHeader, record_size),
+              "page type must share the position with record size");
+static_assert(BP_PAGE_DATA_SIZE <= UINT16_MAX, "slot offset is 16 bits");
+
+/**
+ * @brief 溢出页面上可以存放的数据大小
+ */
+static constexpr int OVERFLOW_PAGE_CAPACITY = BP_PAGE_DATA_SIZE - sizeof(OverflowPageHeader);
+
+/**
+ * @brief 把页面内存初始化成空的变长记录页面
+ */
+static void init_slotted_page_header(char *data, int min_record_size)
+{
+  SlottedPageHeader *header = reinterpret_cast<SlottedPageHeader *>(data);
+  header->record_num      = 0;
+  header->slot_num        = 0;
+  header->page_type       = SLOTTED_PAGE;
+  header->min_record_size = min_record_size;
+  header->free_end        = BP_PAGE_DATA_SIZE;
+  header->garbage_size    = 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 RecordPageIterator::RecordPageIterator() {}
@@ -45,8 +70,7 @@ void RecordPageIterator::init(RecordPageHandler &record_page_handler, SlotNum st
 {
   record_page_handler_ = &record_page_handler;
   page_num_            = record_page_handler.get_page_num();
-  bitmap_.init(record_page_handler.bitmap_, record_page_handler.page_header_->record_capacity);
-  next_slot_num_ = bitmap_.next_setted_bit(start_slot_num);
+  next_slot_num_       = record_page_handler.next_record_slot(start_slot_num);
 }
 
 bool RecordPageIterator::has_next() { return -1 != next_slot_num_; }
@@ -54,10 +78,11 @@ bool RecordPageIterator::has_next() { return -1 != next_slot_num_; }
 RC RecordPageIterator::next(Record &record)
 {
   record.set_rid(page_num_, next_slot_num_);
-  record.set_data(record_page_handler_->get_record_data(record.rid().slot_num), record_page_handler_->page_header_->record_real_size);
+  record.set_data(record_page_handler_->get_record_data(next_slot_num_),
+                  record_page_handler_->get_record_len(next_slot_num_));
 
   if (next_slot_num_ >= 0) {
-    next_slot_num_ = bitmap_.next_setted_bit(next_slot_num_ + 1);
+    next_slot_num_ = record_page_handler_->next_record_slot(next_slot_num_ + 1);
   }
   return record.rid().slot_num != -1 ? RC::SUCCESS : RC::RECORD_EOF;
 }
@@ -66,15 +91,26 @@ RC RecordPageIterator::next(Record &record)
 
 RecordPageHandler::~RecordPageHandler() { cleanup(); }
 
-RC RecordPageHandler::init(FileBufferPool &buffer_pool, PageNum page_num, bool readonly)
+RC RecordPageHandler::init(FileBufferPool &buffer_pool, PageNum page_num, bool readonly, bool wait /* = true */)
 {
   if (file_buffer_pool_ != nullptr) {
     LOG_WARN("Disk buffer pool has been opened for page_num %d.", page_num);
     return RC::RECORD_OPENNED;
   }
 
+  ASSERT(wait || !readonly, "only write latch supports no wait");
   RC ret = RC::SUCCESS;
-  if ((ret = buffer_pool.get_this_page(page_num, &frame_)) != RC::SUCCESS) {
+  if (readonly) {
+    ret = buffer_pool.get_this_page_shared(page_num, &frame_);
+  } else if (wait) {
+    ret = buffer_pool.get_this_page_exclusive(page_num, &frame_);
+  } else {
+    ret = buffer_pool.try_get_this_page_exclusive(page_num, &frame_);
+  }
+  if (ret == RC::LOCKED_CONCURRENCY_CONFLICT) {
+    return ret;
+  }
+  if (ret != RC::SUCCESS) {
     LOG_ERROR("Failed to get page handle from disk buffer pool. ret=%d:%s", ret, strrc(ret));
     return ret;
   }
@@ -83,6 +119,7 @@ RC RecordPageHandler::init(FileBufferPool &buffer_pool, PageNum page_num, bool r
 
   file_buffer_pool_ = &buffer_pool;
   readonly_         = readonly;
+  latched_          = true;
   page_header_      = (PageHeader *)(data);
   bitmap_           = data + PAGE_HEADER_SIZE;
   
@@ -107,6 +144,7 @@ RC RecordPageHandler::recover_init(FileBufferPool &buffer_pool, PageNum page_num
 
   file_buffer_pool_ = &buffer_pool;
   readonly_         = false;
+  latched_          = false;
   page_header_      = (PageHeader *)(data);
   bitmap_           = data + PAGE_HEADER_SIZE;
 
@@ -144,11 +182,37 @@ RC RecordPageHandler::init_empty_page(FileBufferPool &buffer_pool, PageNum page_
   return RC::SUCCESS;
 }
 
+RC RecordPageHandler::init_empty_slotted_page(FileBufferPool &buffer_pool, PageNum page_num, int min_record_size)
+{
+  RC ret = init(buffer_pool, page_num, false /*readonly*/);
+  if (ret != RC::SUCCESS) {
+    LOG_ERROR("Failed to init empty slotted page page_num:min_record_size %d:%d.", page_num, min_record_size);
+    return ret;
+  }
+
+  init_slotted_page_header(frame_->data(), min_record_size);
+  bitmap_ = nullptr;
+
+  if ((ret = buffer_pool.flush_page(*frame_)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to flush page header %d:%d.", buffer_pool.file_desc(), page_num);
+    return ret;
+  }
+
+  return RC::SUCCESS;
+}
+
 RC RecordPageHandler::cleanup()
 {
   if (file_buffer_pool_ != nullptr) {
-    file_buffer_pool_->unpin_page(frame_);
+    if (!latched_) {
+      file_buffer_pool_->unpin_page(frame_);
+    } else if (readonly_) {
+      file_buffer_pool_->unpin_page_shared(frame_);
+    } else {
+      file_buffer_pool_->unpin_page_exclusive(frame_);
+    }
     file_buffer_pool_ = nullptr;
+    latched_ = false;
   }
 
   return RC::SUCCESS;
@@ -184,8 +248,106 @@ RC RecordPageHandler::insert_record(const char *data, RID *rid)
   return RC::SUCCESS;
 }
 
-RC RecordPageHandler::recover_insert_record(const char *data, const RID &rid)
+RC RecordPageHandler::insert_record(const char *data, int record_len, RID *rid)
+{
+  if (!is_slotted()) {
+    return insert_record(data, rid);
+  }
+  ASSERT(readonly_ == false, "cannot insert record into page while the page is readonly");
+
+  if (!has_space(record_len)) {
+    LOG_WARN("Page is full, page_num %d:%d, record len=%d.", file_buffer_pool_->file_desc(), frame_->page_num(), record_len);
+    return RC::RECORD_NOMEM;
+  }
+
+  // 优先使用删除记录留下的空槽位
+  SlottedPageHeader *header = slotted_header();
+  RecordSlot *slot_dir = slots();
+  SlotNum slot_num = header->slot_num;
+  if (header->record_num < header->slot_num) {
+    for (slot_num = 0; slot_dir[slot_num].offset != 0; slot_num++) {
+    }
+  }
+  insert_slotted_record(slot_num, data, record_len);
+
+  if (rid) {
+    rid->page_num = get_page_num();
+    rid->slot_num = slot_num;
+  }
+  return RC::SUCCESS;
+}
+
+void RecordPageHandler::insert_slotted_record(SlotNum slot_num, const char *data, int record_len)
+{
+  SlottedPageHeader *header = slotted_header();
+  const int slot_end = sizeof(SlottedPageHeader) + sizeof(RecordSlot) * std::max(header->slot_num, slot_num + 1);
+  const int size     = align8(record_len);
+  if (header->free_end - size < slot_end) {
+    compact();
+  }
+  ASSERT(header->free_end - size >= slot_end, "no space for record. page_num=%d, record len=%d", get_page_num(), record_len);
+
+  RecordSlot *slot_dir = slots();
+  for (SlotNum i = header->slot_num; i <= slot_num; i++) {
+    slot_dir[i].offset = 0;
+    slot_dir[i].length = 0;
+  }
+  header->slot_num = std::max(header->slot_num, slot_num + 1);
+
+  header->free_end -= size;
+  memcpy(frame_->data() + header->free_end, data, record_len);
+  slot_dir[slot_num].offset = static_cast<uint16_t>(header->free_end);
+  slot_dir[slot_num].length = static_cast<uint16_t>(record_len);
+  header->record_num++;
+
+  frame_->mark_dirty();
+}
+
+void RecordPageHandler::compact()
+{
+  SlottedPageHeader *header = slotted_header();
+  RecordSlot *slot_dir = slots();
+  char *data = frame_->data();
+
+  // 按照槽位顺序把记录紧密地放到临时缓冲区的末尾，再一次复制回来
+  char buffer[BP_PAGE_DATA_SIZE];
+  int free_end = BP_PAGE_DATA_SIZE;
+  for (SlotNum i = 0; i < header->slot_num; i++) {
+    if (slot_dir[i].offset == 0) {
+      continue;
+    }
+    free_end -= align8(slot_dir[i].length);
+    memcpy(buffer + free_end, data + slot_dir[i].offset, slot_dir[i].length);
+    slot_dir[i].offset = static_cast<uint16_t>(free_end);
+  }
+  memcpy(data + free_end, buffer + free_end, BP_PAGE_DATA_SIZE - free_end);
+
+  header->free_end     = free_end;
+  header->garbage_size = 0;
+  frame_->mark_dirty();
+}
+
+RC RecordPageHandler::recover_insert_record(const char *data, int record_len, const RID &rid)
 {
+  if (is_slotted()) {
+    SlottedPageHeader *header = slotted_header();
+    RecordSlot *slot_dir = slots();
+    if (rid.slot_num < header->slot_num && slot_dir[rid.slot_num].offset != 0) {
+      header->garbage_size += align8(slot_dir[rid.slot_num].length);
+      slot_dir[rid.slot_num].offset = 0;
+      header->record_num--;
+    }
+
+    const int slot_bytes = sizeof(RecordSlot) * std::max(0, rid.slot_num + 1 - header->slot_num);
+    const int used = sizeof(SlottedPageHeader) + sizeof(RecordSlot) * header->slot_num + slot_bytes;
+    if (header->free_end - used + header->garbage_size < align8(record_len)) {
+      LOG_WARN("no space to recover record. page_num=%d, slot_num=%d, record len=%d", get_page_num(), rid.slot_num, record_len);
+      return RC::RECORD_NOMEM;
+    }
+    insert_slotted_record(rid.slot_num, data, record_len);
+    return RC::SUCCESS;
+  }
+
   if (rid.slot_num >= page_header_->record_capacity) {
     LOG_WARN("slot_num illegal, slot_num(%d) > record_capacity(%d).", rid.slot_num, page_header_->record_capacity);
     return RC::RECORD_INVALID_RID;
@@ -211,6 +373,26 @@ RC RecordPageHandler::delete_record(const RID *rid)
 {
   ASSERT(readonly_ == false, "cannot delete record from page while the page is readonly");
 
+  if (is_slotted()) {
+    SlottedPageHeader *header = slotted_header();
+    RecordSlot *slot_dir = slots();
+    if (rid->slot_num >= header->slot_num || slot_dir[rid->slot_num].offset == 0) {
+      LOG_DEBUG("Invalid slot_num %d, slot is empty, page_num %d.", rid->slot_num, frame_->page_num());
+      return RC::RECORD_NOT_EXIST;
+    }
+
+    header->garbage_size += align8(slot_dir[rid->slot_num].length);
+    slot_dir[rid->slot_num].offset = 0;
+    slot_dir[rid->slot_num].length = 0;
+    header->record_num--;
+    // 末尾的空槽位直接回收
+    while (header->slot_num > 0 && slot_dir[header->slot_num - 1].offset == 0) {
+      header->slot_num--;
+    }
+    frame_->mark_dirty();
+    return RC::SUCCESS;
+  }
+
   if (rid->slot_num >= page_header_->record_capacity) {
     LOG_ERROR("Invalid slot_num %d, exceed page's record capacity, page_num %d.", rid->slot_num, frame_->page_num());
     return RC::INVALID_ARGUMENT;
@@ -235,6 +417,16 @@ RC RecordPageHandler::delete_record(const RID *rid)
 
 RC RecordPageHandler::get_record(const RID *rid, Record *rec)
 {
+  if (is_slotted()) {
+    if (rid->slot_num >= slotted_header()->slot_num || slots()[rid->slot_num].offset == 0) {
+      LOG_ERROR("Invalid slot_num:%d, slot is empty, page_num %d.", rid->slot_num, frame_->page_num());
+      return RC::RECORD_NOT_EXIST;
+    }
+    rec->set_rid(*rid);
+    rec->set_data(get_record_data(rid->slot_num), get_record_len(rid->slot_num));
+    return RC::SUCCESS;
+  }
+
   if (rid->slot_num >= page_header_->record_capacity) {
     LOG_ERROR("Invalid slot_num:%d, exceed page's record capacity, page_num %d.", rid->slot_num, frame_->page_num());
     return RC::RECORD_INVALID_RID;
@@ -259,28 +451,121 @@ PageNum RecordPageHandler::get_page_num() const
   return frame_->page_num();
 }
 
-bool RecordPageHandler::is_full() const { return page_header_->record_num >= page_header_->record_capacity; }
+bool RecordPageHandler::is_full() const
+{
+  if (is_slotted()) {
+    return !has_space(slotted_header()->min_record_size);
+  }
+  if (is_overflow()) {
+    return true;
+  }
+  return page_header_->record_num >= page_header_->record_capacity;
+}
+
+bool RecordPageHandler::has_space(int record_len) const
+{
+  if (!is_slotted()) {
+    return !is_full();
+  }
+
+  // 没有空槽位时还要在槽位目录中增加一个槽位。删除记录留下的空洞压缩以后可以使用
+  const SlottedPageHeader *header = slotted_header();
+  const int slot_bytes = header->record_num < header->slot_num ? 0 : sizeof(RecordSlot);
+  const int used = sizeof(SlottedPageHeader) + sizeof(RecordSlot) * header->slot_num + slot_bytes;
+  return header->free_end - used + header->garbage_size >= align8(record_len);
+}
+
+int RecordPageHandler::record_capacity() const
+{
+  if (is_slotted()) {
+    return slotted_header()->slot_num;
+  }
+  if (is_overflow()) {
+    return 0;
+  }
+  return page_header_->record_capacity;
+}
+
+int RecordPageHandler::record_num() const
+{
+  // 变长记录页面的头中记录个数在同样的位置上
+  return is_overflow() ? 0 : page_header_->record_num;
+}
+
+SlotNum RecordPageHandler::next_record_slot(SlotNum slot_num) const
+{
+  if (is_slotted()) {
+    const SlottedPageHeader *header = slotted_header();
+    const RecordSlot *slot_dir = slots();
+    for (SlotNum i = slot_num; i < header->slot_num; i++) {
+      if (slot_dir[i].offset != 0) {
+        return i;
+      }
+    }
+    return -1;
+  }
+  if (is_overflow()) {
+    return -1;
+  }
+
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  return bitmap.next_setted_bit(slot_num);
+}
+
+RC RecordPageHandler::filter_records(const ConditionFilter &filter, char *bitmap) const
+{
+  // 变长记录的字段不在固定的位置上，只能逐条过滤
+  if (page_header_->record_size <= 0) {
+    return RC::UNIMPLENMENT;
+  }
+
+  const int capacity = page_header_->record_capacity;
+  const char *records = frame_->data() + page_header_->first_record_offset;
+  if (!filter.filter_page(records, page_header_->record_size, capacity, bitmap)) {
+    return RC::UNIMPLENMENT;
+  }
+
+  // 空闲槽位上的数据是无效的，与记录分配状态的bitmap按位与
+  const int bitmap_size = page_bitmap_size(capacity);
+  for (int i = 0; i < bitmap_size; i++) {
+    bitmap[i] &= bitmap_[i];
+  }
+  return RC::SUCCESS;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
 RecordFileHandler::~RecordFileHandler() { this->close(); }
 
-RC RecordFileHandler::init(FileBufferPool *buffer_pool)
+RC RecordFileHandler::init(FileBufferPool *buffer_pool, const char *fsm_file /* = nullptr */,
+    int min_record_size /* = 0 */)
 {
   if (file_buffer_pool_ != nullptr) {
     LOG_ERROR("record file handler has been openned.");
     return RC::RECORD_OPENNED;
   }
   file_buffer_pool_ = buffer_pool;
-  RC rc = init_free_pages();
-  LOG_INFO("open record file handle done. rc=%s", strrc(rc));
+  min_record_size_  = min_record_size;
+
+  bool loaded = false;
+  RC rc = free_space_map_.open(fsm_file, buffer_pool->page_count(), loaded);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open free space map, scan all pages instead. file=%s, rc=%s", fsm_file, strrc(rc));
+  }
+  if (!loaded) {
+    rc = init_free_pages();
+  }
+  LOG_INFO("open record file handle done. free page num=%d, rc=%s", free_space_map_.free_page_count(), strrc(rc));
   return RC::SUCCESS;
 }
 
 void RecordFileHandler::close()
 {
   if (file_buffer_pool_ != nullptr) {
-    free_pages_.clear();
+    RC rc = free_space_map_.close();
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to close free space map. rc=%s", strrc(rc));
+    }
     file_buffer_pool_ = nullptr;
   }
 }
@@ -302,72 +587,158 @@ RC RecordFileHandler::init_free_pages()
       return rc;
     }
     if (!record_page_handler.is_full()) {
-      free_pages_.insert(current_page_num);
+      free_space_map_.set_free(current_page_num);
     }
     record_page_handler.cleanup();
   }
-  LOG_INFO("record file handler init free pages done. free page num=%d, rc=%s", free_pages_.size(), strrc(rc));
+  LOG_INFO("record file handler init free pages done. free page num=%d, rc=%s",
+           free_space_map_.free_page_count(), strrc(rc));
   return rc;
 }
 
-RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
+RC RecordFileHandler::record_count(int64_t &count)
 {
-  RC ret = RC::SUCCESS;
+  count = 0;
+  BufferPoolIterator bp_iterator;
+  RC rc = bp_iterator.init(*file_buffer_pool_);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to init bp iterator. rc=%s", strrc(rc));
+    return rc;
+  }
 
   RecordPageHandler record_page_handler;
-  bool              page_found       = false;
-  PageNum           current_page_num = 0;
-
-  // 当前要访问free_pages对象，所以需要加锁。在非并发编译模式下，不需要考虑这个锁
-  lock_.lock();
-
-  // 找到没有填满的页面
-  while (!free_pages_.empty()) {
-    current_page_num = *free_pages_.begin();
-
-    ret = record_page_handler.init(*file_buffer_pool_, current_page_num, false /*readonly*/);
-    if (ret != RC::SUCCESS) {
-      lock_.unlock();
-      LOG_WARN("failed to init record page handler. page num=%d, rc=%d:%s", current_page_num, ret, strrc(ret));
-      return ret;
+  while (bp_iterator.has_next()) {
+    const PageNum page_num = bp_iterator.next();
+    rc = record_page_handler.init(*file_buffer_pool_, page_num, true /*readonly*/);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to init record page handler. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
     }
+    count += record_page_handler.record_num();
+    record_page_handler.cleanup();
+  }
+  return RC::SUCCESS;
+}
 
-    if (!record_page_handler.is_full()) {
-      page_found = true;
-      break;
+RC RecordFileHandler::get_insert_page(RecordPageHandler &record_page_handler, int record_size)
+{
+  RC ret = RC::SUCCESS;
+
+  // 从当前线程的起始位置找到文件末尾，再从头找到起始位置
+  const PageNum start_page = free_space_map_.start_page();
+  const PageNum ranges[2][2] = {{start_page, free_space_map_.page_count()}, {1, start_page}};
+  for (const auto &range : ranges) {
+    PageNum begin = range[0];
+    while (begin < range[1]) {
+      PageNum current_page_num = free_space_map_.claim(begin, range[1]);
+      if (current_page_num == BP_INVALID_PAGE_NUM) {
+        break;
+      }
+      begin = current_page_num + 1;
+
+      // 页面在空闲空间表中已经被当前线程占用，写锁一般是其它线程在删除记录或者扫描，不等待它，换一个页面
+      ret = record_page_handler.init(*file_buffer_pool_, current_page_num, false /*readonly*/, false /*wait*/);
+      if (ret == RC::LOCKED_CONCURRENCY_CONFLICT) {
+        free_space_map_.release(current_page_num, true /*has_free_space*/);
+        continue;
+      }
+      if (ret != RC::SUCCESS) {
+        free_space_map_.release(current_page_num, true /*has_free_space*/);
+        LOG_WARN("failed to init record page handler. page num=%d, rc=%d:%s", current_page_num, ret, strrc(ret));
+        return ret;
+      }
+
+      if (record_page_handler.has_space(record_size)) {
+        return RC::SUCCESS;
+      }
+      if (!record_page_handler.is_full()) {
+        // 变长记录页面放不下当前记录，但是还能放下更短的记录
+        release_insert_page(record_page_handler);
+        continue;
+      }
+      // 已经满了的页面不再放回空闲空间表
+      record_page_handler.cleanup();
     }
-    record_page_handler.cleanup();
-    free_pages_.erase(free_pages_.begin());
   }
-  lock_.unlock();  // 如果找到了一个有效的页面，那么此时已经拿到了页面的写锁
 
   // 找不到就分配一个新的页面
-  if (!page_found) {
-    Frame *frame = nullptr;
-    if ((ret = file_buffer_pool_->allocate_page(&frame)) != RC::SUCCESS) {
-      LOG_ERROR("Failed to allocate page while inserting record. ret:%d", ret);
-      return ret;
-    }
-    current_page_num = frame->page_num();
+  Frame *frame = nullptr;
+  if ((ret = file_buffer_pool_->allocate_page(&frame)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to allocate page while inserting record. ret:%d", ret);
+    return ret;
+  }
+  PageNum current_page_num = frame->page_num();
+  // 新页面在空闲空间表中对应的位是0，相当于已经被当前线程占用
+  free_space_map_.extend(current_page_num);
+  if (min_record_size_ > 0) {
+    ret = record_page_handler.init_empty_slotted_page(*file_buffer_pool_, current_page_num, min_record_size_);
+  } else {
     ret = record_page_handler.init_empty_page(*file_buffer_pool_, current_page_num, record_size);
+  }
+  if (ret != RC::SUCCESS) {
+    frame->unpin();  // this is for allocate_page
+    LOG_ERROR("Failed to init empty page. ret:%d", ret);
+    return ret;
+  }
+  // frame 在allocate_page的时候，是有一个pin的，在init_empty_page时又会增加一个，所以这里手动释放一个
+  frame->unpin();
+
+  if (!record_page_handler.has_space(record_size)) {
+    LOG_WARN("record is too large to fit in a page. record size=%d", record_size);
+    release_insert_page(record_page_handler);
+    return RC::RECORD_NOMEM;
+  }
+  return RC::SUCCESS;
+}
+
+void RecordFileHandler::release_insert_page(RecordPageHandler &record_page_handler)
+{
+  const PageNum page_num       = record_page_handler.get_page_num();
+  const bool    has_free_space = !record_page_handler.is_full();
+  record_page_handler.cleanup();
+  free_space_map_.release(page_num, has_free_space);
+}
+
+RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
+{
+  RecordPageHandler record_page_handler;
+  RC ret = get_insert_page(record_page_handler, record_size);
+  if (ret != RC::SUCCESS) {
+    return ret;
+  }
+
+  // 找到空闲位置
+  ret = record_page_handler.insert_record(data, record_size, rid);
+  release_insert_page(record_page_handler);
+  return ret;
+}
+
+RC RecordFileHandler::insert_records(const char *data, int record_num, int record_size, RID *rids)
+{
+  ASSERT(min_record_size_ == 0, "batch insert only supports fixed length records");
+  RC ret = RC::SUCCESS;
+  int inserted = 0;
+  while (inserted < record_num) {
+    RecordPageHandler record_page_handler;
+    ret = get_insert_page(record_page_handler, record_size);
     if (ret != RC::SUCCESS) {
-      frame->unpin();  // this is for allocate_page
-      LOG_ERROR("Failed to init empty page. ret:%d", ret);
       return ret;
     }
-    // frame 在allocate_page的时候，是有一个pin的，在init_empty_page时又会增加一个，所以这里手动释放一个
-    frame->unpin();
 
-    // 这里的加锁顺序看起来与上面是相反的，但是不会出现死锁。
-    // 上面的逻辑是先加未满page集合的锁（第334行），然后加页面写锁（第340行），接着释放页面写锁（第351行），最后释放未满page集合的锁（第354行）；
-    // 而这里是先加页面写锁（第364行），然后加未满page集合的锁（第376行），最后释放未满page集合的锁（第378行），直到函数返回都还没有释放页面写锁。
-    lock_.lock();
-    free_pages_.insert(current_page_num);
-    lock_.unlock();
+    // 拿着页面的写锁，一直插入到页面满为止
+    while (inserted < record_num && !record_page_handler.is_full()) {
+      ret = record_page_handler.insert_record(data + static_cast<size_t>(inserted) * record_size, &rids[inserted]);
+      if (ret != RC::SUCCESS) {
+        LOG_WARN("failed to insert record into page. page num=%d, rc=%s",
+                 record_page_handler.get_page_num(), strrc(ret));
+        release_insert_page(record_page_handler);
+        return ret;
+      }
+      inserted++;
+    }
+    release_insert_page(record_page_handler);
   }
-
-  // 找到空闲位置
-  return record_page_handler.insert_record(data, rid);
+  return ret;
 }
 
 RC RecordFileHandler::recover_insert_record(const char *data, int record_size, const RID &rid)
@@ -379,7 +750,7 @@ RC RecordFileHandler::recover_insert_record(const char *data, int record_size, c
     LOG_WARN("failed to init record page handler. page num=%d, rc=%s", rid.page_num, strrc(ret));
     return ret;
   }
-  return record_page_handler.recover_insert_record(data, rid);
+  return record_page_handler.recover_insert_record(data, record_size, rid);
 }
 
 RC RecordFileHandler::delete_record(const RID *rid)
@@ -393,21 +764,125 @@ RC RecordFileHandler::delete_record(const RID *rid)
   }
 
   rc = page_handler.delete_record(rid);
-  // 📢 这里注意要清理掉资源，否则会与insert_record中的加锁顺序冲突而可能出现死锁
-  // delete record的加锁逻辑是拿到页面锁，删除指定记录，然后加上和释放未满page集合的锁
-  // insert record是加上未满page集合的锁，然后拿到指定页面锁再释放未满page集合的锁
   page_handler.cleanup();
   if (RC_SUCC(rc)) {
-    // 因为这里已经释放了页面锁，并发时，其它线程可能又把该页面填满了，那就不应该再放入free_pages_中。
+    // 因为这里已经释放了页面锁，并发时，其它线程可能又把该页面填满了，那就不应该再放入空闲空间表。
     // 但是这里可以不关心，因为在查找空闲页面时，会自动过滤掉已经满的页面。
-    lock_.lock();
-    free_pages_.insert(rid->page_num);
-    LOG_TRACE("add free page %d to free page list", rid->page_num);
-    lock_.unlock();
+    free_space_map_.set_free(rid->page_num);
+    LOG_TRACE("add free page %d to free space map", rid->page_num);
   }
   return rc;
 }
 
+RC RecordFileHandler::insert_overflow(const char *data, int len, PageNum *first_page)
+{
+  // 从最后一段数据开始写，写每个页面时就已经知道了下一个页面
+  const int page_count = std::max(1, (len + OVERFLOW_PAGE_CAPACITY - 1) / OVERFLOW_PAGE_CAPACITY);
+  PageNum next_page = BP_INVALID_PAGE_NUM;
+  for (int i = page_count - 1; i >= 0; i--) {
+    Frame *frame = nullptr;
+    RC rc = file_buffer_pool_->allocate_page(&frame);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to allocate overflow page. rc=%s", strrc(rc));
+      if (next_page != BP_INVALID_PAGE_NUM) {
+        delete_overflow(next_page);
+      }
+      return rc;
+    }
+    const PageNum page_num = frame->page_num();
+    // 新页面在空闲空间表中对应的位是0，不会用来插入记录
+    free_space_map_.extend(page_num);
+
+    // 扫描线程可能已经看到了这个页面，写数据时要加写锁
+    Frame *latched_frame = nullptr;
+    rc = file_buffer_pool_->get_this_page_exclusive(page_num, &latched_frame);
+    frame->unpin();  // this is for allocate_page
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to latch overflow page. page_num=%d, rc=%s", page_num, strrc(rc));
+      if (next_page != BP_INVALID_PAGE_NUM) {
+        delete_overflow(next_page);
+      }
+      return rc;
+    }
+
+    const int offset = i * OVERFLOW_PAGE_CAPACITY;
+    OverflowPageHeader *header = reinterpret_cast<OverflowPageHeader *>(latched_frame->data());
+    header->data_len  = std::min(OVERFLOW_PAGE_CAPACITY, len - offset);
+    header->next_page = next_page;
+    header->page_type = OVERFLOW_PAGE;
+    memcpy(latched_frame->data() + sizeof(OverflowPageHeader), data + offset, header->data_len);
+    latched_frame->mark_dirty();
+    file_buffer_pool_->unpin_page_exclusive(latched_frame);
+
+    next_page = page_num;
+  }
+
+  *first_page = next_page;
+  return RC::SUCCESS;
+}
+
+RC RecordFileHandler::read_overflow(PageNum first_page, int len, char *data)
+{
+  int read_len = 0;
+  PageNum page_num = first_page;
+  while (read_len < len) {
+    if (page_num == BP_INVALID_PAGE_NUM) {
+      LOG_WARN("overflow data is shorter than expected. first page=%d, len=%d, read=%d", first_page, len, read_len);
+      return RC::RECORD_NOT_EXIST;
+    }
+
+    Frame *frame = nullptr;
+    RC rc = file_buffer_pool_->get_this_page_shared(page_num, &frame);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to get overflow page. page_num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    const OverflowPageHeader *header = reinterpret_cast<const OverflowPageHeader *>(frame->data());
+    if (header->page_type != OVERFLOW_PAGE) {
+      LOG_WARN("page is not an overflow page. page_num=%d", page_num);
+      file_buffer_pool_->unpin_page_shared(frame);
+      return RC::RECORD_NOT_EXIST;
+    }
+    const int copy_len = std::min(header->data_len, len - read_len);
+    memcpy(data + read_len, frame->data() + sizeof(OverflowPageHeader), copy_len);
+    read_len += copy_len;
+    page_num = header->next_page;
+    file_buffer_pool_->unpin_page_shared(frame);
+  }
+  return RC::SUCCESS;
+}
+
+RC RecordFileHandler::delete_overflow(PageNum first_page)
+{
+  PageNum page_num = first_page;
+  while (page_num != BP_INVALID_PAGE_NUM) {
+    Frame *frame = nullptr;
+    RC rc = file_buffer_pool_->get_this_page_exclusive(page_num, &frame);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to get overflow page. page_num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    const OverflowPageHeader *header = reinterpret_cast<const OverflowPageHeader *>(frame->data());
+    if (header->page_type != OVERFLOW_PAGE) {
+      LOG_WARN("page is not an overflow page. page_num=%d", page_num);
+      file_buffer_pool_->unpin_page_exclusive(frame);
+      return RC::RECORD_NOT_EXIST;
+    }
+    const PageNum next_page = header->next_page;
+
+    // 扫描线程可能正在访问这个页面，不能直接释放，变成空的变长记录页面给插入记录使用
+    init_slotted_page_header(frame->data(), min_record_size_);
+    frame->mark_dirty();
+    file_buffer_pool_->unpin_page_exclusive(frame);
+    free_space_map_.set_free(page_num);
+
+    page_num = next_page;
+  }
+  return RC::SUCCESS;
+}
+
 RC RecordFileHandler::get_record(RecordPageHandler &page_handler, const RID *rid, bool readonly, Record *rec)
 {
   if (nullptr == rid || nullptr == rec) {
@@ -447,10 +922,31 @@ RC RecordFileHandler::visit_record(const RID &rid, bool readonly, std::function<
 
 ////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////
+
+void PageRangeDispenser::init(PageNum page_count, int range_pages /* = DEFAULT_RANGE_PAGES */)
+{
+  page_count_  = page_count;
+  range_pages_ = std::max(range_pages, 1);
+  next_page_.store(1);
+}
+
+bool PageRangeDispenser::next(PageNum &begin, PageNum &end)
+{
+  begin = next_page_.fetch_add(range_pages_);
+  if (begin >= page_count_) {
+    return false;
+  }
+  end = std::min(begin + range_pages_, page_count_);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 RecordFileScanner::~RecordFileScanner() { close_scan(); }
 
-RC RecordFileScanner::open_scan(
-    Table *table, FileBufferPool &buffer_pool, Trx *trx, bool readonly, ConditionFilter *condition_filter)
+RC RecordFileScanner::open_scan(Table *table, FileBufferPool &buffer_pool, Trx *trx, bool readonly,
+    ConditionFilter *condition_filter, PageRangeDispenser *page_ranges /* = nullptr */)
 {
   close_scan();
 
@@ -458,8 +954,20 @@ RC RecordFileScanner::open_scan(
   file_buffer_pool_ = &buffer_pool;
   trx_              = trx;
   readonly_         = readonly;
+  page_ranges_      = page_ranges;
+  range_end_        = -1;
 
-  RC rc = bp_iterator_.init(buffer_pool);
+  read_ahead_window_  = 0;
+  read_ahead_next_    = 0;
+  read_ahead_trigger_ = 0;
+
+  RC rc = RC::SUCCESS;
+  if (page_ranges_ == nullptr) {
+    rc = bp_iterator_.init(buffer_pool);
+  } else if (!next_page_range()) {
+    // 页面都被其它扫描器领取走了，没有需要遍历的页面
+    rc = bp_iterator_.init_range(buffer_pool, 0, 0);
+  }
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to init bp iterator. rc=%d:%s", rc, strrc(rc));
     return rc;
@@ -494,8 +1002,13 @@ RC RecordFileScanner::fetch_next_record()
   }
 
   // 上个页面遍历完了，或者还没有开始遍历某个页面，那么就从一个新的页面开始遍历查找
-  while (bp_iterator_.has_next()) {
+  // 当前的页面范围遍历完了，再领取下一个页面范围
+  while (bp_iterator_.has_next() || (page_ranges_ != nullptr && next_page_range())) {
+    if (!bp_iterator_.has_next()) {
+      continue;  // 领取到的范围内没有分配的页面
+    }
     PageNum page_num = bp_iterator_.next();
+    read_ahead(page_num);
     record_page_handler_.cleanup();
     rc = record_page_handler_.init(*file_buffer_pool_, page_num, readonly_);
     if (RC_FAIL(rc)) {
@@ -504,6 +1017,12 @@ RC RecordFileScanner::fetch_next_record()
     }
 
     record_page_iterator_.init(record_page_handler_);
+    page_filtered_ = false;
+    if (condition_filter_ != nullptr) {
+      // 能批量过滤的条件，先在整个页面上算出结果，遍历时只需要检查对应的位
+      page_filter_bitmap_.resize(page_bitmap_size(record_page_handler_.record_capacity()));
+      page_filtered_ = record_page_handler_.filter_records(*condition_filter_, page_filter_bitmap_.data()) == RC::SUCCESS;
+    }
     rc = fetch_next_record_in_page();
     if (rc == RC::SUCCESS || rc != RC::RECORD_EOF) {
       // 有有效记录：RC::SUCCESS
@@ -534,8 +1053,15 @@ RC RecordFileScanner::fetch_next_record_in_page()
     }
 
     // 如果有过滤条件，就用过滤条件过滤一下
-    if (condition_filter_ != nullptr && !condition_filter_->filter(next_record_)) {
-      continue;
+    if (condition_filter_ != nullptr) {
+      if (page_filtered_) {
+        Bitmap page_filter(page_filter_bitmap_.data(), record_page_handler_.record_capacity());
+        if (!page_filter.get_bit(next_record_.rid().slot_num)) {
+          continue;
+        }
+      } else if (!condition_filter_->filter(next_record_)) {
+        continue;
+      }
     }
 
     // 如果是某个事务上遍历数据，还要看看事务访问是否有冲突
@@ -557,6 +1083,44 @@ RC RecordFileScanner::fetch_next_record_in_page()
   return RC::RECORD_EOF;
 }
 
+void RecordFileScanner::read_ahead(PageNum page_num)
+{
+  if (page_num < read_ahead_trigger_) {
+    return;
+  }
+
+  read_ahead_window_ = read_ahead_window_ == 0 ? READ_AHEAD_MIN_PAGES
+                                               : std::min(read_ahead_window_ * 2, READ_AHEAD_MAX_PAGES);
+  const PageNum start_page = std::max(page_num + 1, read_ahead_next_);
+  int page_count = read_ahead_window_;
+  if (range_end_ >= 0) {
+    // 后面的页面由其它扫描器领取，不替它们预读
+    page_count = std::min(page_count, range_end_ - start_page);
+  }
+  if (page_count > 0) {
+    file_buffer_pool_->read_ahead(start_page, page_count);
+  }
+  read_ahead_next_    = start_page + read_ahead_window_;
+  read_ahead_trigger_ = start_page + read_ahead_window_ / 2;
+}
+
+bool RecordFileScanner::next_page_range()
+{
+  PageNum begin = 0;
+  PageNum end = 0;
+  if (!page_ranges_->next(begin, end)) {
+    return false;
+  }
+  bp_iterator_.init_range(*file_buffer_pool_, begin, end);
+  range_end_ = end;
+
+  // 新的范围与上一个范围通常不连续，预读窗口重新开始
+  read_ahead_window_  = 0;
+  read_ahead_next_    = 0;
+  read_ahead_trigger_ = 0;
+  return true;
+}
+
 RC RecordFileScanner::close_scan()
 {
   if (file_buffer_pool_ != nullptr) {
@@ -566,6 +1130,8 @@ RC RecordFileScanner::close_scan()
   if (condition_filter_ != nullptr) {
     condition_filter_ = nullptr;
   }
+  page_filtered_ = false;
+  page_ranges_   = nullptr;
 
   record_page_handler_.cleanup();
 
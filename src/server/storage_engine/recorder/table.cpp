@@ -2,6 +2,8 @@
 #include "include/storage_engine/recorder/record_manager.h"
 #include "include/storage_engine/schema/schema_util.h"
 #include "include/storage_engine/index/bplus_tree_index.h"
+#include <unistd.h>
+#include <algorithm>
 #include <random>
 
 
@@ -17,6 +19,16 @@ Table::~Table()
     data_buffer_pool_ = nullptr;
   }
 
+  if (toast_handler_ != nullptr) {
+    delete toast_handler_;
+    toast_handler_ = nullptr;
+  }
+
+  if (toast_buffer_pool_ != nullptr) {
+    toast_buffer_pool_->close_file();
+    toast_buffer_pool_ = nullptr;
+  }
+
   for (std::vector<Index *>::iterator it = indexes_.begin(); it != indexes_.end(); ++it) {
     Index *index = *it;
     delete index;
@@ -159,6 +171,31 @@ RC Table::drop(int32_t table_id,
     return RC::FILE_REMOVE;
   }
 
+  // 先关闭，否则关闭时会重新写出空闲空间表文件
+  if (record_handler_ != nullptr) {
+    record_handler_->close();
+  }
+  std::string fsm_file = table_fsm_file(base_dir, name);
+  if(unlink(fsm_file.c_str()) != 0 && errno != ENOENT) {
+    LOG_ERROR("Failed to remove free space map file=%s, errno=%d", fsm_file.c_str(), errno);
+    return RC::FILE_REMOVE;
+  }
+
+  // 只有变长记录的表才有TOAST文件
+  if (toast_handler_ != nullptr) {
+    toast_handler_->close();
+  }
+  std::string toast_file = table_toast_file(base_dir, name);
+  if(unlink(toast_file.c_str()) != 0 && errno != ENOENT) {
+    LOG_ERROR("Failed to remove toast file=%s, errno=%d", toast_file.c_str(), errno);
+    return RC::FILE_REMOVE;
+  }
+  std::string toast_fsm_file = table_toast_fsm_file(base_dir, name);
+  if(unlink(toast_fsm_file.c_str()) != 0 && errno != ENOENT) {
+    LOG_ERROR("Failed to remove toast free space map file=%s, errno=%d", toast_fsm_file.c_str(), errno);
+    return RC::FILE_REMOVE;
+  }
+
   const int index_num = table_meta_.index_num();
   for (int i = 0; i < index_num; i ++) {
     ((BplusTreeIndex*)indexes_[i])->close();
@@ -234,13 +271,14 @@ RC Table::open(const char *meta_file, const char *base_dir)
 }
 
 /**
- * 创建索引，然后遍历所有数据，插入索引, 最后将索引放到表的元数据中, 并且将元数据写入文件
+ * 创建索引，然后遍历所有数据，批量构建索引, 最后将索引放到表的元数据中, 并且将元数据写入文件
  * @param trx 事务
  * @param multi_field_metas 多个字段的元数据
  * @param index_name 索引名称
  * @param is_unique 是否是唯一索引
  */
-RC Table::create_index(Trx *trx, std::vector<const FieldMeta *> &multi_field_metas, const char *index_name, bool is_unique)
+RC Table::create_index(
+    Trx *trx, std::vector<const FieldMeta *> &multi_field_metas, const char *index_name, bool is_unique, bool key_compressed)
 {
   if (common::is_blank(index_name) || multi_field_metas.empty()) {
     LOG_INFO("Invalid input arguments, table name is %s, index_name is blank or attribute_name is blank", name());
@@ -262,14 +300,14 @@ RC Table::create_index(Trx *trx, std::vector<const FieldMeta *> &multi_field_met
   for (int i = 0; i < multi_field_metas.size(); i++) {
     new_multi_field_metas.emplace_back(*(multi_field_metas[i]));
   }
-  rc = index->create(index_file.c_str(), new_index_meta, new_multi_field_metas);
+  rc = index->create(index_file.c_str(), new_index_meta, new_multi_field_metas, key_compressed);
   if (rc != RC::SUCCESS) {
     delete index;
     LOG_ERROR("Failed to create bplus tree index. file name=%s, rc=%d:%s", index_file.c_str(), rc, strrc(rc));
     return rc;
   }
 
-  // 遍历当前的所有数据，插入这个索引
+  // 遍历当前的所有数据，排序后批量构建这个索引
   RecordFileScanner scanner;
   rc = get_record_scanner(scanner, trx, true/*readonly*/);
   if (rc != RC::SUCCESS) {
@@ -278,20 +316,11 @@ RC Table::create_index(Trx *trx, std::vector<const FieldMeta *> &multi_field_met
     return rc;
   }
 
-  Record record;
-  while (scanner.has_next()) {
-    rc = scanner.next(record);
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to scan records while creating index. table=%s, index=%s, rc=%s",
-               name(), index_name, strrc(rc));
-      return rc;
-    }
-    rc = index->insert_entry(record.data(), &record.rid());
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to insert record into index while creating index. table=%s, index=%s, rc=%s",
-               name(), index_name, strrc(rc));
-      return rc;
-    }
+  rc = index->bulk_load(scanner);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to load records into index while creating index. table=%s, index=%s, rc=%s",
+             name(), index_name, strrc(rc));
+    return rc;
   }
   scanner.close_scan();
   LOG_INFO("inserted all records into new index. table=%s, index=%s", name(), index_name);
@@ -350,11 +379,11 @@ RC Table::insert_entry_of_indexes(const char *record, const RID &rid)
   return rc;
 }
 
-RC Table::delete_entry_of_indexes(const char *record, const RID &rid, bool error_on_not_exists)
+RC Table::delete_entry_of_indexes(const char *record, const RID &rid, bool error_on_not_exists, bool by_rid /* = false */)
 {
   RC rc = RC::SUCCESS;
   for (Index *index : indexes_) {
-    rc = index->delete_entry(record, &rid);
+    rc = by_rid ? index->delete_entry_by_rid(record, &rid) : index->delete_entry(record, &rid);
     if (rc != RC::SUCCESS) {
       if (rc != RC::RECORD_INVALID_KEY || error_on_not_exists) {
         break;
@@ -367,9 +396,21 @@ RC Table::delete_entry_of_indexes(const char *record, const RID &rid, bool error
 RC Table::insert_record(Record &record)
 {
   RC rc = RC::SUCCESS;
-  rc = record_handler_->insert_record(record.data(), table_meta_.record_size(), &record.rid());
+  std::vector<TextRef> toasted_texts;
+  if (table_meta_.variable_length()) {
+    rc = toast_texts(record);
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to move texts to toast file. table name=%s, rc=%s", table_meta_.name(), strrc(rc));
+      return rc;
+    }
+    toasted_texts_of(record, toasted_texts);
+    rc = record_handler_->insert_record(record.data(), record.len(), &record.rid());
+  } else {
+    rc = record_handler_->insert_record(record.data(), table_meta_.record_size(), &record.rid());
+  }
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Insert record failed. table name=%s, rc=%s", table_meta_.name(), strrc(rc));
+    delete_toasted_texts(toasted_texts);
     return rc;
   }
 
@@ -386,29 +427,234 @@ RC Table::insert_record(Record &record)
     if (rc2 != RC::SUCCESS) {
       LOG_ERROR("Failed to rollback record data when insert index entries failed. table name=%s, rc=%s", 
                 name(), strrc(rc2));
+    } else {
+      delete_toasted_texts(toasted_texts);
+    }
+  }
+
+  return rc;
+}
+
+RC Table::toast_texts(Record &record)
+{
+  const FieldMeta *null_field = table_meta_.null_bitmap_field();
+  common::Bitmap null_bitmap(record.data() + null_field->offset(), null_field->len());
+  std::vector<std::pair<const FieldMeta *, TextRef>> texts;
+  for (int i = 0; i < table_meta_.field_num(); i++) {
+    const FieldMeta *field = table_meta_.field(i);
+    if (field->type() != TEXTS || null_bitmap.get_bit(i)) {
+      continue;
+    }
+    TextRef ref;
+    memcpy(&ref, record.data() + field->offset(), sizeof(ref));
+    if (!ref.toasted() && ref.length > 0) {
+      texts.emplace_back(field, ref);
+    }
+  }
+
+  // 先移走最长的文本，留在记录中的文本尽量多
+  std::sort(texts.begin(), texts.end(), [](const auto &left, const auto &right) {
+    return left.second.length > right.second.length;
+  });
+  int record_len = record.len();
+  bool toasted = false;
+  for (auto &[field, ref] : texts) {
+    if (ref.length <= MAX_INLINE_TEXT_SIZE && record_len <= MAX_INLINE_RECORD_SIZE) {
+      break;
+    }
+    RC rc = RC::SUCCESS;
+    const char *text = record.data() + ref.offset;
+    if (ref.length <= MAX_TOAST_RECORD_SIZE) {
+      RID rid;
+      rc = toast_handler_->insert_record(text, ref.length, &rid);
+      ref.toast_page = rid.page_num;
+      ref.toast_slot = rid.slot_num;
+    } else {
+      rc = toast_handler_->insert_overflow(text, ref.length, &ref.toast_page);
+      ref.toast_slot = -1;
+    }
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("Failed to insert text into toast file. table name=%s, field=%s, length=%d, rc=%s",
+               name(), field->name(), ref.length, strrc(rc));
+      std::vector<TextRef> toasted_texts;
+      toasted_texts_of(record, toasted_texts);
+      delete_toasted_texts(toasted_texts);
+      return rc;
+    }
+    memcpy(record.data() + field->offset(), &ref, sizeof(ref));
+    record_len -= ref.length;
+    toasted = true;
+  }
+  if (!toasted) {
+    return RC::SUCCESS;
+  }
+
+  // 留在记录中的文本重新紧密排列
+  char *record_data = (char *)malloc(record_len);
+  ASSERT(nullptr != record_data, "failed to malloc memory. record data size=%d", record_len);
+  memcpy(record_data, record.data(), table_meta_.record_size());
+  int offset = table_meta_.record_size();
+  for (const auto &[field, ref] : texts) {
+    TextRef new_ref;
+    memcpy(&new_ref, record.data() + field->offset(), sizeof(new_ref));
+    if (new_ref.toasted()) {
+      continue;
+    }
+    memcpy(record_data + offset, record.data() + new_ref.offset, new_ref.length);
+    new_ref.offset = offset;
+    memcpy(record_data + field->offset(), &new_ref, sizeof(new_ref));
+    offset += new_ref.length;
+  }
+  ASSERT(offset == record_len, "record length mismatch. offset=%d, record len=%d", offset, record_len);
+
+  record.set_data_owner(record_data, record_len);
+  return RC::SUCCESS;
+}
+
+void Table::toasted_texts_of(const Record &record, std::vector<TextRef> &refs) const
+{
+  if (!table_meta_.variable_length()) {
+    return;
+  }
+  const FieldMeta *null_field = table_meta_.null_bitmap_field();
+  common::Bitmap null_bitmap(const_cast<char *>(record.data()) + null_field->offset(), null_field->len());
+  for (int i = 0; i < table_meta_.field_num(); i++) {
+    const FieldMeta *field = table_meta_.field(i);
+    if (field->type() != TEXTS || null_bitmap.get_bit(i)) {
+      continue;
+    }
+    TextRef ref;
+    memcpy(&ref, record.data() + field->offset(), sizeof(ref));
+    if (ref.toasted()) {
+      refs.push_back(ref);
+    }
+  }
+}
+
+RC Table::delete_toasted_texts(const std::vector<TextRef> &refs)
+{
+  RC rc = RC::SUCCESS;
+  for (const TextRef &ref : refs) {
+    RC rc2 = RC::SUCCESS;
+    if (ref.toast_slot >= 0) {
+      RID rid(ref.toast_page, ref.toast_slot);
+      rc2 = toast_handler_->delete_record(&rid);
+    } else {
+      rc2 = toast_handler_->delete_overflow(ref.toast_page);
+    }
+    if (rc2 != RC::SUCCESS) {
+      LOG_WARN("Failed to delete toasted text. table name=%s, page num=%d, slot num=%d, rc=%s",
+               name(), ref.toast_page, ref.toast_slot, strrc(rc2));
+      rc = rc2;
+    }
+  }
+  return rc;
+}
+
+RC Table::get_text(const Record &record, const FieldMeta &field, Value &value) const
+{
+  TextRef ref;
+  memcpy(&ref, record.data() + field.offset(), sizeof(ref));
+  if (ref.length == 0) {
+    value.set_text("", 0);
+    return RC::SUCCESS;
+  }
+
+  if (!ref.toasted()) {
+    if (ref.offset < table_meta_.record_size() || ref.offset + ref.length > record.len()) {
+      LOG_WARN("Invalid text in record. table name=%s, field=%s, offset=%d, length=%d, record len=%d",
+               name(), field.name(), ref.offset, ref.length, record.len());
+      return RC::INTERNAL;
+    }
+    value.set_text(record.data() + ref.offset, ref.length);
+    return RC::SUCCESS;
+  }
+
+  RC rc = RC::SUCCESS;
+  if (ref.toast_slot >= 0) {
+    auto reader = [&value, &ref](Record &toast_record) {
+      value.set_text(toast_record.data(), std::min(ref.length, toast_record.len()));
+    };
+    rc = toast_handler_->visit_record(RID(ref.toast_page, ref.toast_slot), true /*readonly*/, reader);
+  } else {
+    std::string text(ref.length, '\0');
+    rc = toast_handler_->read_overflow(ref.toast_page, ref.length, text.data());
+    if (rc == RC::SUCCESS) {
+      value.set_text(text.data(), ref.length);
     }
   }
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("Failed to read text from toast file. table name=%s, field=%s, rc=%s", name(), field.name(), strrc(rc));
+  }
+  return rc;
+}
 
+RC Table::insert_records(const char *data, int record_num, RID *rids)
+{
+  RC rc = record_handler_->insert_records(data, record_num, table_meta_.record_size(), rids);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Insert records failed. table name=%s, record num=%d, rc=%s", table_meta_.name(), record_num, strrc(rc));
+  }
   return rc;
 }
 
-RC Table::delete_record(const Record &record)
+RC Table::insert_records(std::vector<Record> &records, RID *rids)
+{
+  for (size_t i = 0; i < records.size(); i++) {
+    Record &record = records[i];
+    RC rc = toast_texts(record);
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to move texts to toast file. table name=%s, rc=%s", table_meta_.name(), strrc(rc));
+      return rc;
+    }
+    rc = record_handler_->insert_record(record.data(), record.len(), &rids[i]);
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Insert records failed. table name=%s, record num=%d, rc=%s",
+                table_meta_.name(), static_cast<int>(records.size()), strrc(rc));
+      std::vector<TextRef> toasted_texts;
+      toasted_texts_of(record, toasted_texts);
+      delete_toasted_texts(toasted_texts);
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC Table::insert_entries_of_indexes(const std::vector<RID> &rids)
+{
+  RC rc = RC::SUCCESS;
+  for (Index *index : indexes_) {
+    rc = ((BplusTreeIndex *)index)->insert_entries(rids);
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to insert index entries. table name=%s, index=%s, rc=%s",
+                name(), index->index_meta().name(), strrc(rc));
+      break;
+    }
+  }
+  return rc;
+}
+
+RC Table::delete_record(const Record &record, bool stale_index_key /* = false */)
 {
   RC rc = RC::SUCCESS;
 
   // TODO [Lab2] 增加索引的处理逻辑
-  rc = delete_entry_of_indexes(record.data(), record.rid(), true/*error_on_not_exists*/);
+  rc = delete_entry_of_indexes(record.data(), record.rid(), true/*error_on_not_exists*/, stale_index_key);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to delete index data. table name=%s, rc=%s", name(), strrc(rc));
     return rc;
   }
 
+  // 删除以后记录所在的页面可能会被整理，先找到放在TOAST文件中的文本
+  std::vector<TextRef> toasted_texts;
+  toasted_texts_of(record, toasted_texts);
+
   rc = record_handler_->delete_record(&record.rid());
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Delete record failed. table name=%s, rc=%s", name(), strrc(rc));
     return rc;
   }
-  return rc;
+  return delete_toasted_texts(toasted_texts);
 }
 
 RC Table::visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor)
@@ -418,11 +664,13 @@ RC Table::visit_record(const RID &rid, bool readonly, std::function<void(Record
 
 RC Table::get_record(const RID &rid, Record &record)
 {
-  const int record_size = table_meta_.record_size();
-  char *record_data = (char *)malloc(record_size);
-  ASSERT(nullptr != record_data, "failed to malloc memory. record data size=%d", record_size);
-
-  auto copier = [&record, record_data, record_size](Record &record_src) {
+  // 变长记录的长度要拿到页面以后才知道
+  char *record_data = nullptr;
+  int   record_size = 0;
+  auto copier = [&record, &record_data, &record_size](Record &record_src) {
+    record_size = record_src.len();
+    record_data = (char *)malloc(record_size);
+    ASSERT(nullptr != record_data, "failed to malloc memory. record data size=%d", record_size);
     memcpy(record_data, record_src.data(), record_size);
     record.set_rid(record_src.rid());
   };
@@ -438,6 +686,53 @@ RC Table::get_record(const RID &rid, Record &record)
 }
 
 RC Table::make_record(int value_num, const Value *values, Record &record)
+{
+  // 变长记录的文本依次放在定长部分的后面
+  const int normal_field_start_index = table_meta_.sys_field_num();
+  std::vector<std::pair<const FieldMeta *, std::string>> texts;
+  int record_size = table_meta_.record_size();
+  if (table_meta_.variable_length() &&
+      value_num + table_meta_.sys_field_num() + table_meta_.null_filed_num() == table_meta_.field_num()) {
+    for (int i = 0; i < value_num; i++) {
+      const FieldMeta *field = table_meta_.field(i + normal_field_start_index);
+      if (field->type() != TEXTS || values[i].attr_type() == AttrType::NULLS) {
+        continue;
+      }
+      texts.emplace_back(field, values[i].get_string());
+      if (texts.back().second.size() > MAX_TEXT_LENGTH) {
+        LOG_WARN("text is too long. table name=%s, field name=%s, length=%d",
+                 table_meta_.name(), field->name(), static_cast<int>(texts.back().second.size()));
+        return RC::INVALID_ARGUMENT;
+      }
+      record_size += texts.back().second.size();
+    }
+  }
+
+  // 索引直接用字段的字节比较，字符串末尾没有用到的部分也要是0
+  char *record_data = (char *)calloc(1, record_size);
+
+  RC rc = make_record(value_num, values, record_data);
+  if (RC::SUCCESS != rc) {
+    free(record_data);
+    return rc;
+  }
+
+  int offset = table_meta_.record_size();
+  for (const auto &[field, text] : texts) {
+    TextRef ref;
+    ref.length        = static_cast<int32_t>(text.size());
+    ref.offset        = offset;
+    ref.toast_page    = BP_INVALID_PAGE_NUM;
+    ref.toast_slot    = -1;
+    memcpy(record_data + field->offset(), &ref, sizeof(ref));
+    memcpy(record_data + offset, text.data(), text.size());
+    offset += text.size();
+  }
+  record.set_data_owner(record_data, record_size);
+  return RC::SUCCESS;
+}
+
+RC Table::make_record(int value_num, const Value *values, char *record_data) const
 {
   // 检查字段类型是否一致
   if (value_num + table_meta_.sys_field_num() + table_meta_.null_filed_num() != table_meta_.field_num()) {
@@ -465,9 +760,6 @@ RC Table::make_record(int value_num, const Value *values, Record &record)
   }
 
   // 复制所有字段的值
-  int record_size = table_meta_.record_size();
-  char *record_data = (char *)malloc(record_size);
-
   RC rc = RC::SUCCESS;
   for (int i = 0; i < value_num; i++) {
     rc = change_record_value(record_data, i + normal_field_start_index, values[i]);
@@ -476,7 +768,6 @@ RC Table::make_record(int value_num, const Value *values, Record &record)
       return rc;
     }
   }
-  record.set_data_owner(record_data, record_size);
   return RC::SUCCESS;
 }
 
@@ -490,8 +781,10 @@ RC Table::init_record_handler(const char *base_dir)
     return rc;
   }
 
+  std::string fsm_file = table_fsm_file(base_dir, table_meta_.name());
+  const int min_record_size = table_meta_.variable_length() ? table_meta_.record_size() : 0;
   record_handler_ = new RecordFileHandler();
-  rc = record_handler_->init(data_buffer_pool_);
+  rc = record_handler_->init(data_buffer_pool_, fsm_file.c_str(), min_record_size);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to init record handler. rc=%s", strrc(rc));
     data_buffer_pool_->close_file();
@@ -501,18 +794,63 @@ RC Table::init_record_handler(const char *base_dir)
     return rc;
   }
 
+  if (table_meta_.variable_length()) {
+    rc = init_toast_handler(base_dir);
+  }
   return rc;
 }
 
-RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly)
+RC Table::init_toast_handler(const char *base_dir)
 {
-  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, readonly, nullptr);
+  std::string toast_file = table_toast_file(base_dir, table_meta_.name());
+  RC rc = RC::SUCCESS;
+  if (::access(toast_file.c_str(), F_OK) != 0) {
+    rc = BufferPoolManager::instance().create_file(toast_file.c_str());
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to create toast file. file name=%s, rc=%s", toast_file.c_str(), strrc(rc));
+      return rc;
+    }
+  }
+
+  rc = BufferPoolManager::instance().open_file(toast_file.c_str(), toast_buffer_pool_);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to open disk buffer pool for file:%s. rc=%d:%s", toast_file.c_str(), rc, strrc(rc));
+    return rc;
+  }
+
+  std::string toast_fsm_file = table_toast_fsm_file(base_dir, table_meta_.name());
+  toast_handler_ = new RecordFileHandler();
+  rc = toast_handler_->init(toast_buffer_pool_, toast_fsm_file.c_str(), MAX_INLINE_TEXT_SIZE);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to init toast handler. rc=%s", strrc(rc));
+    toast_buffer_pool_->close_file();
+    toast_buffer_pool_ = nullptr;
+    delete toast_handler_;
+    toast_handler_ = nullptr;
+    return rc;
+  }
+  return rc;
+}
+
+RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly,
+    PageRangeDispenser *page_ranges /* = nullptr */, ConditionFilter *condition_filter /* = nullptr */)
+{
+  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, readonly, condition_filter, page_ranges);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("failed to open scanner. rc=%s", strrc(rc));
   }
   return rc;
 }
 
+int Table::data_page_count() const
+{
+  return data_buffer_pool_->page_count();
+}
+
+RC Table::count_records(int64_t &count)
+{
+  return record_handler_->record_count(count);
+}
 
 Index *Table::find_index(const char *index_name) const
 {
@@ -580,13 +918,20 @@ RC Table::change_record_value(char *&record, int idx, const Value &value) const
     std::size_t combinedValue = now + randomValue;
     std::hash<std::size_t> hasher;
     std::size_t hashValue = hasher(combinedValue);
-    memcpy(record + field->offset(), &hashValue, field->len());
+    if (field->type() != TEXTS) {
+      memcpy(record + field->offset(), &hashValue, std::min(sizeof(hashValue), static_cast<size_t>(field->len())));
+    }
     return RC::SUCCESS;
   }
   bitmap.clear_bit(idx);
 
+  // TEXTS 字段的内容由 make_record 放在记录的末尾
+  if (field->type() == TEXTS) {
+    return RC::SUCCESS;
+  }
+
   size_t copy_len = field->len();
-  if (field->type() == CHARS  || field->type() == TEXTS) {
+  if (field->type() == CHARS) {
     Value tmp = value;
     if(value.attr_type() != CHARS && value.attr_type() != TEXTS) {
       tmp = Value(value.get_string().c_str());
@@ -595,6 +940,7 @@ RC Table::change_record_value(char *&record, int idx, const Value &value) const
     if (copy_len > data_len) {
       copy_len = data_len + 1;
     }
+    memset(record + field->offset(), 0, field->len());
     memcpy(record + field->offset(), tmp.data(), copy_len);
   } else if (field->type() == INTS || field->type() == DATES || field->type() == BOOLEANS) {
     int tmp = value.get_int();
@@ -613,7 +959,8 @@ RC Table::change_record_value(char *&record, int idx, const Value &value) const
 RC Table::recover_insert_record(Record &record)
 {
   RC rc = RC::SUCCESS;
-  rc = record_handler_->recover_insert_record(record.data(), table_meta_.record_size(), record.rid());
+  const int record_size = table_meta_.variable_length() ? record.len() : table_meta_.record_size();
+  rc = record_handler_->recover_insert_record(record.data(), record_size, record.rid());
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Insert record failed. table name=%s, rc=%s", table_meta_.name(), strrc(rc));
     return rc;
@@ -249,6 +249,16 @@ int TableMeta::record_size() const
   return record_size_;
 }
 
+bool TableMeta::variable_length() const
+{
+  for (const FieldMeta &field : fields_) {
+    if (field.type() == TEXTS) {
+      return true;
+    }
+  }
+  return false;
+}
+
 int TableMeta::serialize(std::ostream &ss) const
 {
 
@@ -1,3 +1,5 @@
+#include <sys/stat.h>
+
 #include "include/storage_engine/recover/log_file.h"
 
 using namespace std;
@@ -6,7 +8,14 @@ using namespace common;
 static const int LOG_BUFFER_SIZE = 4 * 1024 * 1024;
 static const char *LOG_FILE_NAME = "redo.log";
 
-RC LogBuffer::append_log_entry(LogEntry *log_entry)
+void LogBuffer::init(LSN start_lsn)
+{
+  current_lsn_ = start_lsn;
+  written_lsn_ = start_lsn;
+  flushed_lsn_ = start_lsn;
+}
+
+RC LogBuffer::append_log_entry(LogEntry *log_entry, LSN *lsn /* = nullptr */)
 {
   if (nullptr == log_entry) {
     return RC::INVALID_ARGUMENT;
@@ -20,6 +29,11 @@ RC LogBuffer::append_log_entry(LogEntry *log_entry)
   lock_guard<Mutex> lock_guard(lock_);
   log_entrys_.emplace_back(log_entry);
   total_size_ += log_entry->log_entry_len();
+  // 日志项按照进入缓存的顺序写入文件，所以在锁内累加就可以得到它在文件中的结束位置
+  current_lsn_ += entry_size(*log_entry);
+  if (lsn != nullptr) {
+    *lsn = current_lsn_.load();
+  }
   LOG_DEBUG("append log. log_entry={%s}", log_entry->to_string().c_str());
   return RC::SUCCESS;
 }
@@ -69,7 +83,7 @@ RC LogBuffer::flush_buffer(LogFile &log_file)
     lock_.lock();  // log buffer 需要支持并发，所以要考虑加锁
     if (log_entrys_.empty()) {
       lock_.unlock();
-      return RC::SUCCESS;
+      break;  // 其它线程取走了剩下的日志项，仍然需要sync，保证返回时它们也已经落盘
     }
 
     unique_ptr<LogEntry> log_entry = std::move(log_entrys_.front());  // 从队列中取出日志记录然后写入到文件中
@@ -78,6 +92,7 @@ RC LogBuffer::flush_buffer(LogFile &log_file)
     rc = write_log_entry(log_file, log_entry.get());
     // 当前无法处理日志写不完整的情况，所以直接粗暴退出
     ASSERT(rc == RC::SUCCESS, "failed to write log record. log_record=%s, rc=%s", log_entry->to_string().c_str(), strrc(rc));
+    written_lsn_ += entry_size(*log_entry);
 
     lock_.unlock();
     total_size_ -= log_entry->log_entry_len();
@@ -85,7 +100,19 @@ RC LogBuffer::flush_buffer(LogFile &log_file)
   }
 
   LOG_WARN("flush log buffer done. write log record number=%d", count);
-  return log_file.sync();
+
+  lock_.lock();
+  LSN written_lsn = written_lsn_;
+  lock_.unlock();
+
+  rc = log_file.sync();
+  if (rc == RC::SUCCESS) {
+    // 可能有多个线程同时刷日志，flushed_lsn_ 只能前进
+    LSN flushed_lsn = flushed_lsn_.load();
+    while (flushed_lsn < written_lsn && !flushed_lsn_.compare_exchange_weak(flushed_lsn, written_lsn)) {
+    }
+  }
+  return rc;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -150,6 +177,27 @@ RC LogFile::sync()
   return RC::SUCCESS;
 }
 
+RC LogFile::seek(int64_t off)
+{
+  if (lseek(fd_, static_cast<off_t>(off), SEEK_SET) == -1) {
+    LOG_WARN("failed to seek. offset=%ld, error=%s", off, strerror(errno));
+    return RC::IOERR_SEEK;
+  }
+  eof_ = false;
+  return RC::SUCCESS;
+}
+
+RC LogFile::size(int64_t &file_size) const
+{
+  struct stat st;
+  if (fstat(fd_, &st) != 0) {
+    LOG_WARN("failed to stat log file. file=%s, error=%s", filename_.c_str(), strerror(errno));
+    return RC::IOERR_ACCESS;
+  }
+  file_size = static_cast<int64_t>(st.st_size);
+  return RC::SUCCESS;
+}
+
 RC LogFile::offset(int64_t &off) const
 {
   off_t pos = lseek(fd_, 0, SEEK_CUR);
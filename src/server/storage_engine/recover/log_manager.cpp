@@ -1,6 +1,10 @@
+#include <thread>
+
 #include "include/storage_engine/recover/log_manager.h"
 #include "include/storage_engine/transaction/trx.h"
 
+static const char *CHECKPOINT_FILE_NAME = "redo.ckp";
+
 RC LogEntryIterator::init(LogFile &log_file)
 {
   log_file_ = &log_file;
@@ -70,27 +74,62 @@ RC LogManager::init(const char *path)
 {
   log_buffer_ = new LogBuffer();
   log_file_   = new LogFile();
-  return log_file_->init(path);
+  RC rc = log_file_->init(path);
+  if (RC_FAIL(rc)) {
+    return rc;
+  }
+
+  int64_t file_size = 0;
+  rc = log_file_->size(file_size);
+  if (RC_FAIL(rc)) {
+    return rc;
+  }
+  // LSN 就是日志文件中的偏移量，新的日志从文件末尾继续写
+  log_buffer_->init(static_cast<LSN>(file_size));
+  checkpoint_file_ = std::string(path) + common::FILE_PATH_SPLIT_STR + CHECKPOINT_FILE_NAME;
+  return rc;
 }
 
 RC LogManager::append_begin_trx_log(int32_t trx_id)
 {
-  return append_log(LogEntry::build_mtr_entry(LogEntryType::MTR_BEGIN, trx_id));
+  LogEntry *log_entry = LogEntry::build_mtr_entry(LogEntryType::MTR_BEGIN, trx_id);
+  const int32_t entry_size = LogBuffer::entry_size(*log_entry);
+  LSN lsn = 0;
+  RC rc = log_buffer_->append_log_entry(log_entry, &lsn);
+  if (RC_SUCC(rc)) {
+    std::lock_guard<common::Mutex> lock_guard(active_trx_lock_);
+    active_trx_begin_lsn_[trx_id] = lsn - entry_size;
+  }
+  return rc;
 }
 
 RC LogManager::append_rollback_trx_log(int32_t trx_id)
 {
+  {
+    std::lock_guard<common::Mutex> lock_guard(active_trx_lock_);
+    active_trx_begin_lsn_.erase(trx_id);
+  }
   return append_log(LogEntry::build_mtr_entry(LogEntryType::MTR_ROLLBACK, trx_id));
 }
 
 RC LogManager::append_commit_trx_log(int32_t trx_id, int32_t commit_xid)
 {
-  RC rc = append_log(LogEntry::build_commit_entry(trx_id, commit_xid));
+  {
+    std::lock_guard<common::Mutex> lock_guard(active_trx_lock_);
+    active_trx_begin_lsn_.erase(trx_id);
+  }
+
+  committing_num_++;
+  LSN lsn = 0;
+  RC rc = log_buffer_->append_log_entry(LogEntry::build_commit_entry(trx_id, commit_xid), &lsn);
   if (rc != RC::SUCCESS) {
+    committing_num_--;
     LOG_WARN("failed to append trx commit log. trx id=%d, rc=%s", trx_id, strrc(rc));
     return rc;
   }
-  rc = sync(); // 事务提交时需要把当前事务关联的日志项都写入到磁盘中，这样做是保证不丢数据
+  // 事务提交时需要把当前事务关联的日志项都写入到磁盘中，这样做是保证不丢数据
+  rc = group_sync(lsn);
+  committing_num_--;
   return rc;
 }
 
@@ -117,12 +156,127 @@ RC LogManager::sync()
   return log_buffer_->flush_buffer(*log_file_);
 }
 
+RC LogManager::sync_to(LSN lsn)
+{
+  if (lsn <= log_buffer_->flushed_lsn()) {
+    return RC::SUCCESS;
+  }
+  return group_sync(lsn);
+}
+
+RC LogManager::group_sync(LSN lsn)
+{
+  std::unique_lock<std::mutex> lock_guard(group_lock_);
+  while (lsn > log_buffer_->flushed_lsn()) {
+    if (!group_flushing_) {
+      break;
+    }
+    group_cond_.wait(lock_guard);
+  }
+  if (lsn <= log_buffer_->flushed_lsn()) {
+    return RC::SUCCESS;
+  }
+
+  // 当前线程作为leader刷日志，在此期间进入缓存的日志会被一起写入
+  group_flushing_ = true;
+  lock_guard.unlock();
+
+  const int64_t delay_us = group_commit_delay_us_.load();
+  if (delay_us > 0 && committing_num_.load() > 1) {
+    std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+  }
+
+  RC rc = sync();
+  if (RC_FAIL(rc)) {
+    LOG_WARN("failed to sync log. lsn=%d, rc=%s", lsn, strrc(rc));
+  }
+
+  lock_guard.lock();
+  group_flushing_ = false;
+  group_cond_.notify_all();
+  return rc;
+}
+
+LSN LogManager::checkpoint_lsn()
+{
+  // 先取当前的结束位置再看活跃事务：之后开始的事务，开始日志一定在这个位置之后
+  LSN lsn = log_buffer_->current_lsn();
+  std::lock_guard<common::Mutex> lock_guard(active_trx_lock_);
+  for (const auto &[trx_id, begin_lsn] : active_trx_begin_lsn_) {
+    lsn = std::min(lsn, begin_lsn);
+  }
+  return lsn;
+}
+
+RC LogManager::write_checkpoint(LSN lsn)
+{
+  const std::string tmp_file = checkpoint_file_ + ".tmp";
+  int fd = ::open(tmp_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    LOG_WARN("failed to open checkpoint file. file=%s, error=%s", tmp_file.c_str(), strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+
+  int ret = common::writen(fd, &lsn, sizeof(lsn));
+  if (ret == 0 && fsync(fd) != 0) {
+    ret = errno;
+  }
+  ::close(fd);
+  if (ret != 0) {
+    LOG_WARN("failed to write checkpoint file. file=%s, error=%s", tmp_file.c_str(), strerror(ret));
+    return RC::IOERR_WRITE;
+  }
+
+  if (::rename(tmp_file.c_str(), checkpoint_file_.c_str()) != 0) {
+    LOG_WARN("failed to rename checkpoint file. file=%s, error=%s", checkpoint_file_.c_str(), strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+  LOG_INFO("checkpoint done. lsn=%d", lsn);
+  return RC::SUCCESS;
+}
+
+RC LogManager::read_checkpoint(LSN &lsn)
+{
+  lsn = 0;
+  int fd = ::open(checkpoint_file_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return RC::SUCCESS;
+    }
+    LOG_WARN("failed to open checkpoint file. file=%s, error=%s", checkpoint_file_.c_str(), strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+
+  int ret = common::readn(fd, &lsn, sizeof(lsn));
+  ::close(fd);
+  if (ret != 0) {
+    LOG_WARN("failed to read checkpoint file. file=%s, ret=%d", checkpoint_file_.c_str(), ret);
+    lsn = 0;
+    return RC::IOERR_READ;
+  }
+  return RC::SUCCESS;
+}
+
 // TODO [Lab5] 需要同学们补充代码，相关提示见文档
 RC LogManager::recover(Db *db)
 {
   TrxManager *trx_manager = GCTX.trx_manager_;
   ASSERT(trx_manager != nullptr, "cannot do recover that trx_manager is null");
 
+  // checkpoint之前的日志对应的修改都已经在磁盘上了，从checkpoint的位置开始重做
+  LSN checkpoint_lsn = 0;
+  RC rc = read_checkpoint(checkpoint_lsn);
+  if (RC_FAIL(rc)) {
+    LOG_WARN("failed to read checkpoint, recover from the beginning. rc=%s", strrc(rc));
+    checkpoint_lsn = 0;
+  }
+  rc = log_file_->seek(checkpoint_lsn);
+  if (RC_FAIL(rc)) {
+    LOG_WARN("failed to seek log file to checkpoint. lsn=%d, rc=%s", checkpoint_lsn, strrc(rc));
+    return rc;
+  }
+  LOG_INFO("recover from checkpoint. lsn=%d", checkpoint_lsn);
+
   // TODO [Lab5] 需要同学们补充代码，相关提示见文档
 
   return RC::SUCCESS;
@@ -2,6 +2,9 @@
 
 Db::~Db()
 {
+  stop_vacuumer();
+  stop_checkpointer();
+
   for (auto &iter : opened_tables_) {
     delete iter.second;
   }
@@ -46,6 +49,9 @@ RC Db::init(const char *name, const char *dbpath)
     LOG_WARN("failed to recover db. dbpath=%s, rc=%s", dbpath, strrc(rc));
     return rc;
   }
+
+  start_checkpointer();
+  start_vacuumer();
   return rc;
 }
 
@@ -58,6 +64,8 @@ RC Db::create_table(const char *table_name, int attribute_count, const AttrInfoS
     return RC::SCHEMA_TABLE_EXIST;
   }
 
+  std::lock_guard<std::mutex> vacuum_guard(vacuum_lock_);
+
   // 文件路径可以移到Table模块
   std::string table_file_path = table_meta_file(path_.c_str(), table_name);
   Table *table = new Table();
@@ -82,6 +90,8 @@ RC Db::create_view(const char *view_name, const char *origin_table_name, SelectS
     return RC::SCHEMA_TABLE_EXIST;
   }
 
+  std::lock_guard<std::mutex> vacuum_guard(vacuum_lock_);
+
   // 文件路径可以移到Table模块
   std::string view_file_path = table_meta_file(path_.c_str(), view_name);
   auto *view = new Table();
@@ -107,6 +117,7 @@ RC Db::drop_table(const char *table_name)
     return RC::SCHEMA_TABLE_NOT_EXIST;
   }
 
+  std::lock_guard<std::mutex> vacuum_guard(vacuum_lock_);
   Table *table = opened_tables_[table_name];
   rc = table->drop(table->table_id(),table_name,path_.c_str());
   if (rc != RC::SUCCESS) {
@@ -201,10 +212,154 @@ RC Db::sync()
     }
     LOG_INFO("Successfully sync table db:%s, table:%s.", name_.c_str(), table->name());
   }
+
+  rc = checkpoint();
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to do checkpoint. db=%s, rc=%s", name_.c_str(), strrc(rc));
+    return rc;
+  }
   LOG_INFO("Successfully sync db. db=%s", name_.c_str());
   return rc;
 }
 
+RC Db::checkpoint()
+{
+  // 必须在刷脏页之前取，这之后产生的修改不一定能刷到磁盘上
+  LSN checkpoint_lsn = log_manager_->checkpoint_lsn();
+
+  RC rc = log_manager_->sync();
+  if (RC_FAIL(rc)) {
+    LOG_WARN("failed to sync log while doing checkpoint. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = BufferPoolManager::instance().flush_all_pages();
+  if (RC_FAIL(rc)) {
+    LOG_WARN("failed to flush dirty pages while doing checkpoint. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  return log_manager_->write_checkpoint(checkpoint_lsn);
+}
+
+void Db::start_checkpointer()
+{
+#ifdef CONCURRENCY
+  std::lock_guard<std::mutex> lock_guard(checkpoint_lock_);
+  checkpoint_running_ = true;
+  checkpoint_thread_ = std::thread(&Db::checkpoint_loop, this);
+  LOG_INFO("checkpointer started. db=%s, interval=%ds", name_.c_str(), CHECKPOINT_INTERVAL_SEC);
+#endif
+}
+
+void Db::stop_checkpointer()
+{
+  {
+    std::lock_guard<std::mutex> lock_guard(checkpoint_lock_);
+    if (!checkpoint_running_) {
+      return;
+    }
+    checkpoint_running_ = false;
+  }
+  checkpoint_cond_.notify_all();
+  if (checkpoint_thread_.joinable()) {
+    checkpoint_thread_.join();
+  }
+}
+
+void Db::checkpoint_loop()
+{
+  std::unique_lock<std::mutex> lock_guard(checkpoint_lock_);
+  while (checkpoint_running_) {
+    checkpoint_cond_.wait_for(lock_guard, std::chrono::seconds(CHECKPOINT_INTERVAL_SEC),
+                              [this]() { return !checkpoint_running_; });
+    if (!checkpoint_running_) {
+      break;
+    }
+
+    lock_guard.unlock();
+    RC rc = checkpoint();
+    if (RC_FAIL(rc)) {
+      LOG_WARN("failed to do checkpoint. db=%s, rc=%s", name_.c_str(), strrc(rc));
+    }
+    lock_guard.lock();
+  }
+}
+
+RC Db::vacuum(Table *table, int &record_num)
+{
+  std::lock_guard<std::mutex> vacuum_guard(vacuum_lock_);
+  record_num = 0;
+
+  std::vector<Table *> tables;
+  if (table != nullptr) {
+    tables.push_back(table);
+  } else {
+    for (const auto &table_pair : opened_tables_) {
+      tables.push_back(table_pair.second);
+    }
+  }
+
+  for (Table *vacuum_table : tables) {
+    if (vacuum_table->is_view()) {
+      continue;
+    }
+    int table_record_num = 0;
+    RC rc = TrxManager::instance()->vacuum(vacuum_table, table_record_num);
+    if (RC_FAIL(rc)) {
+      LOG_WARN("failed to vacuum table. db=%s, table=%s, rc=%s", name_.c_str(), vacuum_table->name(), strrc(rc));
+      return rc;
+    }
+    record_num += table_record_num;
+  }
+  return RC::SUCCESS;
+}
+
+void Db::start_vacuumer()
+{
+#ifdef CONCURRENCY
+  std::lock_guard<std::mutex> lock_guard(vacuum_thread_lock_);
+  vacuum_running_ = true;
+  vacuum_thread_ = std::thread(&Db::vacuum_loop, this);
+  LOG_INFO("vacuumer started. db=%s, interval=%ds", name_.c_str(), VACUUM_INTERVAL_SEC);
+#endif
+}
+
+void Db::stop_vacuumer()
+{
+  {
+    std::lock_guard<std::mutex> lock_guard(vacuum_thread_lock_);
+    if (!vacuum_running_) {
+      return;
+    }
+    vacuum_running_ = false;
+  }
+  vacuum_cond_.notify_all();
+  if (vacuum_thread_.joinable()) {
+    vacuum_thread_.join();
+  }
+}
+
+void Db::vacuum_loop()
+{
+  std::unique_lock<std::mutex> lock_guard(vacuum_thread_lock_);
+  while (vacuum_running_) {
+    vacuum_cond_.wait_for(lock_guard, std::chrono::seconds(VACUUM_INTERVAL_SEC),
+                          [this]() { return !vacuum_running_; });
+    if (!vacuum_running_) {
+      break;
+    }
+
+    lock_guard.unlock();
+    int record_num = 0;
+    RC rc = vacuum(nullptr, record_num);
+    if (RC_FAIL(rc)) {
+      LOG_WARN("failed to vacuum. db=%s, rc=%s", name_.c_str(), strrc(rc));
+    }
+    lock_guard.lock();
+  }
+}
+
 RC Db::recover()
 {
   return log_manager_->recover(this);
@@ -13,3 +13,18 @@ std::string table_index_file(const char *base_dir, const char *table_name, const
 {
   return std::string(base_dir) + common::FILE_PATH_SPLIT_STR + table_name + "-" + index_name + TABLE_INDEX_SUFFIX;
 }
+
+std::string table_fsm_file(const char *base_dir, const char *table_name)
+{
+  return std::string(base_dir) + common::FILE_PATH_SPLIT_STR + table_name + TABLE_FSM_SUFFIX;
+}
+
+std::string table_toast_file(const char *base_dir, const char *table_name)
+{
+  return std::string(base_dir) + common::FILE_PATH_SPLIT_STR + table_name + TABLE_TOAST_SUFFIX;
+}
+
+std::string table_toast_fsm_file(const char *base_dir, const char *table_name)
+{
+  return table_toast_file(base_dir, table_name) + TABLE_FSM_SUFFIX;
+}
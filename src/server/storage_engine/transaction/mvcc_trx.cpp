@@ -1,4 +1,5 @@
 #include "include/storage_engine/transaction/mvcc_trx.h"
+#include "include/storage_engine/recorder/record_manager.h"
 #include "include/storage_engine/schema/database.h"
 
 using namespace std;
@@ -101,6 +102,130 @@ void MvccTrxManager::update_trx_id(int32_t trx_id)
   while (old_trx_id < trx_id && !current_trx_id_.compare_exchange_weak(old_trx_id, trx_id));
 }
 
+void MvccTrxManager::start_trx(MvccTrx *trx)
+{
+  lock_.lock();
+  trx->trx_id_ = next_trx_id();
+  active_xids_.push_back(trx->trx_id_);
+
+  // 快照中包含自己的事务号，自己的修改在记录上是负数，不会用快照判断
+  MvccSnapshot &snapshot = trx->snapshot_;
+  snapshot.xmax_ = current_trx_id_ + 1;
+  snapshot.xmin_ = active_xids_.front();
+  snapshot.active_xids_ = active_xids_;
+  trx->started_ = true;
+  lock_.unlock();
+}
+
+int32_t MvccTrxManager::start_commit()
+{
+  lock_.lock();
+  int32_t commit_xid = next_trx_id();
+  active_xids_.push_back(commit_xid);
+  lock_.unlock();
+  return commit_xid;
+}
+
+void MvccTrxManager::finish_trx(int32_t trx_id, int32_t commit_xid)
+{
+  lock_.lock();
+  remove_active_xid(trx_id);
+  if (commit_xid > 0) {
+    remove_active_xid(commit_xid);
+  }
+  lock_.unlock();
+}
+
+void MvccTrxManager::remove_active_xid(int32_t xid)
+{
+  auto iter = std::lower_bound(active_xids_.begin(), active_xids_.end(), xid);
+  if (iter != active_xids_.end() && *iter == xid) {
+    active_xids_.erase(iter);
+  }
+}
+
+int32_t MvccTrxManager::oldest_snapshot_xmin()
+{
+  lock_.lock();
+  // 之后才开始的事务，xmin 不会小于当前最小的活跃事务号，也不会大于下一个要分配的事务号
+  int32_t oldest_xmin = active_xids_.empty() ? current_trx_id_ + 1 : active_xids_.front();
+  for (Trx *trx : trxes_) {
+    MvccTrx *mvcc_trx = static_cast<MvccTrx *>(trx);
+    if (mvcc_trx->started() && mvcc_trx->snapshot().xmin() < oldest_xmin) {
+      oldest_xmin = mvcc_trx->snapshot().xmin();
+    }
+  }
+  lock_.unlock();
+  return oldest_xmin;
+}
+
+RC MvccTrxManager::vacuum(Table *table, int &record_num)
+{
+  record_num = 0;
+
+  const std::pair<const FieldMeta *, int> table_trx_fields = table->table_meta().trx_fields();
+  if (table_trx_fields.second < 2) {
+    return RC::SUCCESS;
+  }
+  Field end_xid_field(table, &table_trx_fields.first[1]);
+
+  // 已提交的删除，end xid 是提交号。小于所有快照的 xmin 时，所有事务都认为删除已经提交，这条记录就不会再被看到了
+  const int32_t oldest_xmin = oldest_snapshot_xmin();
+  auto is_dead = [this, &end_xid_field, oldest_xmin](const Record &record) {
+    const int32_t end_xid = end_xid_field.get_int(record);
+    return end_xid > 0 && end_xid < max_trx_id() && end_xid < oldest_xmin;
+  };
+
+  // 先用只读的方式找出所有可以回收的记录，扫描时不能删除记录，否则需要一直持有页面的写锁
+  std::vector<RID> dead_rids;
+  RecordFileScanner scanner;
+  RC rc = table->get_record_scanner(scanner, nullptr/*trx*/, true/*readonly*/);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open scanner while vacuuming. table=%s, rc=%s", table->name(), strrc(rc));
+    return rc;
+  }
+  Record record;
+  while (scanner.has_next()) {
+    rc = scanner.next(record);
+    if (rc != RC::SUCCESS) {
+      break;
+    }
+    if (is_dead(record)) {
+      dead_rids.push_back(record.rid());
+    }
+  }
+  scanner.close_scan();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to scan table while vacuuming. table=%s, rc=%s", table->name(), strrc(rc));
+    return rc;
+  }
+
+  // 不可见的记录不会再被任何事务修改，这里重新读取是为了拿到完整的记录来删除索引项
+  for (const RID &rid : dead_rids) {
+    Record dead_record;
+    rc = table->get_record(rid, dead_record);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to get record while vacuuming. table=%s, rid=%s, rc=%s",
+               table->name(), rid.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+    if (!is_dead(dead_record)) {
+      continue;
+    }
+    // 索引项中保存的是插入时的事务号，提交时只修改了记录
+    rc = table->delete_record(dead_record, true/*stale_index_key*/);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to delete record while vacuuming. table=%s, rid=%s, rc=%s",
+               table->name(), rid.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+    record_num++;
+  }
+
+  LOG_INFO("vacuum table done. table=%s, oldest xmin=%d, removed records=%d", table->name(), oldest_xmin, record_num);
+  return RC::SUCCESS;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 MvccTrx::MvccTrx(MvccTrxManager &kit, LogManager *log_manager) : trx_kit_(kit), log_manager_(log_manager)
 {}
@@ -209,6 +334,10 @@ RC MvccTrx::visit_record(Table *table, Record &record, bool readonly)
       }
     }
   }
+  else if (!snapshot_.committed(begin_xid))// Committed after snapshot, or still updating other records
+  {
+    return RC::RECORD_INVISIBLE;
+  }
 
   if(end_xid < trx_kit_.max_trx_id())// Marked as deleted
   {
@@ -230,20 +359,16 @@ RC MvccTrx::visit_record(Table *table, Record &record, bool readonly)
     }
     else// Committed
     {
-      if (end_xid <= trx_id_) {// Committed before current trx
+      if (snapshot_.committed(end_xid)) {// Committed before snapshot
         return RC::RECORD_INVISIBLE;
+      } else if (readonly) {
+        return RC::SUCCESS;// Committed after snapshot
       } else {
-        return RC::SUCCESS;//Commited after current trx
+        return RC::LOCKED_CONCURRENCY_CONFLICT;
       }
     }
   }
 
-  //Timeline check
-  if (begin_xid>0 && begin_xid>trx_id_)// Inserted in future
-  {
-    return RC::RECORD_INVISIBLE;
-  }
-
   return RC::SUCCESS;
 }
 
@@ -251,19 +376,20 @@ RC MvccTrx::start_if_need()
 {
   if (!started_) {
     ASSERT(operations_.empty(), "try to start a new trx while operations is not empty");
-    trx_id_ = trx_kit_.next_trx_id();
+    trx_kit_.start_trx(this);
     LOG_DEBUG("current thread change to new trx with %d", trx_id_);
     RC rc = log_manager_->append_begin_trx_log(trx_id_);
     ASSERT(rc == RC::SUCCESS, "failed to append log to clog. rc=%s", strrc(rc));
-    started_ = true;
   }
   return RC::SUCCESS;
 }
 
 RC MvccTrx::commit()
 {
-  int32_t commit_id = trx_kit_.next_trx_id();
-  return commit_with_trx_id(commit_id);
+  int32_t commit_id = trx_kit_.start_commit();
+  RC rc = commit_with_trx_id(commit_id);
+  trx_kit_.finish_trx(trx_id_, commit_id);
+  return rc;
 }
 
 RC MvccTrx::commit_with_trx_id(int32_t commit_xid)
@@ -360,6 +486,7 @@ RC MvccTrx::rollback()
   }
 
   operations_.clear();
+  trx_kit_.finish_trx(trx_id_, -1);
 
   if (!recovering_) {
     rc = log_manager_->append_rollback_trx_log(trx_id_);
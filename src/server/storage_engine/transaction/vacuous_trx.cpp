@@ -37,6 +37,13 @@ void VacuousTrxManager::all_trxes(std::vector<Trx *> &trxes)
   return;
 }
 
+RC VacuousTrxManager::vacuum(Table * /*table*/, int &record_num)
+{
+  // 没有事务时删除就是物理删除，不会留下需要回收的记录
+  record_num = 0;
+  return RC::SUCCESS;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 RC VacuousTrx::insert_record(Table *table, Record &record)
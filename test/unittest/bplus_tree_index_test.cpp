@@ -1,3 +1,9 @@
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <random>
+#include <thread>
+
 #include "include/common/rc.h"
 #include "include/storage_engine/index/bplus_tree_index.h"
 #include "gtest/gtest.h"
@@ -90,6 +96,412 @@ TEST(test_bplus_tree_index, single_attribute)
   delete index;
 }
 
+/**
+ * 乱序添加大量重复的键，排序时会写临时文件，批量构建以后树是合法的，并且可以继续插入和删除
+ */
+TEST(test_bplus_tree_index, bulk_load)
+{
+  const char *index_file = "bulk_load-i_id.index";
+  ::remove(index_file);
+  BplusTreeHandler handler;
+  ASSERT_EQ(handler.create(index_file, false, {AttrType::INTS}, {4}, 8 /*internal_max_size*/, 8 /*leaf_max_size*/),
+            RC::SUCCESS);
+
+  const int entry_num = 5000;
+  const int value_num = 1000;
+  std::vector<int> slots(entry_num);
+  for (int i = 0; i < entry_num; i++) {
+    slots[i] = i;
+  }
+  std::shuffle(slots.begin(), slots.end(), std::mt19937(1));
+
+  {
+    BplusTreeBulkLoader loader(handler, 75 /*fill_factor*/, 4096 /*memory_limit*/);
+    for (int slot : slots) {
+      const int key = slot % value_num;
+      const char *keys[1] = {reinterpret_cast<const char *>(&key)};
+      ASSERT_EQ(loader.add(keys, RID(1, slot)), RC::SUCCESS);
+    }
+    ASSERT_EQ(loader.finish(), RC::SUCCESS);
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  for (int key = 0; key < value_num; key++) {
+    const char *keys[1] = {reinterpret_cast<const char *>(&key)};
+    std::list<RID> rids;
+    ASSERT_EQ(handler.get_entry(keys, rids), RC::SUCCESS);
+    ASSERT_EQ(rids.size(), entry_num / value_num) << "key=" << key;
+  }
+
+  // 删除一半的数据，再插入新的数据
+  for (int slot = 0; slot < entry_num; slot += 2) {
+    const int key = slot % value_num;
+    const char *keys[1] = {reinterpret_cast<const char *>(&key)};
+    const RID rid(1, slot);
+    ASSERT_EQ(handler.delete_entry(keys, &rid), RC::SUCCESS);
+  }
+  for (int slot = entry_num; slot < entry_num + 500; slot++) {
+    const int key = slot % value_num;
+    const char *keys[1] = {reinterpret_cast<const char *>(&key)};
+    const RID rid(1, slot);
+    ASSERT_EQ(handler.insert_entry(keys, &rid), RC::SUCCESS);
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  BplusTreeScanner scanner(handler);
+  ASSERT_EQ(scanner.open(nullptr, 0, false, nullptr, 0, false), RC::SUCCESS);
+  RID rid;
+  int count = 0;
+  while (scanner.next_entry(rid, false) == RC::SUCCESS) {
+    count++;
+  }
+  ASSERT_EQ(count, entry_num / 2 + 500);
+  scanner.close();
+
+  handler.close();
+  ::remove(index_file);
+}
+
+/**
+ * 误差范围内相等的浮点数按 RID 排序，与按数值排序的结果不同，这些数据在构建以后单独插入
+ */
+TEST(test_bplus_tree_index, bulk_load_float_epsilon)
+{
+  const char *index_file = "bulk_load-i_score.index";
+  ::remove(index_file);
+  BplusTreeHandler handler;
+  ASSERT_EQ(handler.create(index_file, false, {AttrType::FLOATS}, {4}, 8 /*internal_max_size*/, 8 /*leaf_max_size*/),
+            RC::SUCCESS);
+
+  const int entry_num = 200;
+  {
+    BplusTreeBulkLoader loader(handler);
+    for (int i = 0; i < entry_num; i++) {
+      // 数值越大 RID 越小
+      const float score = 1.0f + (i % 4) * 1e-7f + (i / 4);
+      const char *keys[1] = {reinterpret_cast<const char *>(&score)};
+      ASSERT_EQ(loader.add(keys, RID(1, entry_num - i)), RC::SUCCESS);
+    }
+    ASSERT_EQ(loader.finish(), RC::SUCCESS);
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  for (int i = 0; i < entry_num / 4; i++) {
+    const float score = 1.0f + i;
+    const char *keys[1] = {reinterpret_cast<const char *>(&score)};
+    std::list<RID> rids;
+    ASSERT_EQ(handler.get_entry(keys, rids), RC::SUCCESS);
+    ASSERT_EQ(rids.size(), 4) << "score=" << score;
+  }
+
+  handler.close();
+  ::remove(index_file);
+}
+
+/**
+ * 有很长公共前缀的字符串键，压缩以后文件更小，随机插入和删除以后树仍然是合法的
+ */
+TEST(test_bplus_tree_index, key_compression)
+{
+  const int attr_length = 48;
+  const int entry_num = 20000;
+  auto make_name = [](int i, char *name) {
+    memset(name, 0, attr_length);
+    snprintf(name, attr_length, "customer-account-%08d", i);
+  };
+
+  std::vector<int> ids(entry_num);
+  for (int i = 0; i < entry_num; i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(3));
+
+  long file_sizes[2] = {0, 0};
+  for (bool key_compressed : {false, true}) {
+    const char *index_file = key_compressed ? "compressed-i_name.index" : "uncompressed-i_name.index";
+    ::remove(index_file);
+    BplusTreeHandler handler;
+    ASSERT_EQ(handler.create(index_file, false, {AttrType::CHARS}, {attr_length}, -1, -1, key_compressed), RC::SUCCESS);
+
+    char name[attr_length];
+    const char *keys[1] = {name};
+    for (int id : ids) {
+      make_name(id, name);
+      const RID rid(1, id);
+      ASSERT_EQ(handler.insert_entry(keys, &rid), RC::SUCCESS);
+    }
+    ASSERT_TRUE(handler.validate_tree());
+    ASSERT_EQ(handler.sync(), RC::SUCCESS);
+    file_sizes[key_compressed] = static_cast<long>(std::filesystem::file_size(index_file));
+
+    // 删除一大半，节点会合并或者从兄弟节点借数据
+    for (int i = 0; i < entry_num; i++) {
+      if (ids[i] % 4 != 0) {
+        make_name(ids[i], name);
+        const RID rid(1, ids[i]);
+        ASSERT_EQ(handler.delete_entry(keys, &rid), RC::SUCCESS);
+      }
+    }
+    ASSERT_TRUE(handler.validate_tree());
+
+    for (int id = 0; id < entry_num; id += 7) {
+      make_name(id, name);
+      std::list<RID> rids;
+      ASSERT_EQ(handler.get_entry(keys, rids), RC::SUCCESS);
+      ASSERT_EQ(rids.size(), id % 4 == 0 ? 1 : 0) << "id=" << id;
+    }
+
+    BplusTreeScanner scanner(handler);
+    ASSERT_EQ(scanner.open(nullptr, 0, false, nullptr, 0, false), RC::SUCCESS);
+    RID rid;
+    int count = 0;
+    while (scanner.next_entry(rid, false) == RC::SUCCESS) {
+      count++;
+    }
+    ASSERT_EQ(count, entry_num / 4);
+    scanner.close();
+
+    handler.close();
+    ::remove(index_file);
+  }
+  ASSERT_LT(file_sizes[1] * 2, file_sizes[0]);
+}
+
+/**
+ * 多个字段的索引在压缩格式下批量构建
+ */
+TEST(test_bplus_tree_index, bulk_load_compressed)
+{
+  const char *index_file = "bulk_load-i_id_name.index";
+  ::remove(index_file);
+  BplusTreeHandler handler;
+  ASSERT_EQ(handler.create(index_file, false, {AttrType::INTS, AttrType::CHARS}, {4, 32}, -1, -1, true /*key_compressed*/),
+            RC::SUCCESS);
+
+  const int entry_num = 30000;
+  const int value_num = 300;
+  char name[32];
+  auto make_name = [&name](int value) {
+    memset(name, 0, sizeof(name));
+    snprintf(name, sizeof(name), "department-%d", value);
+  };
+
+  {
+    BplusTreeBulkLoader loader(handler, 80 /*fill_factor*/, 64 * 1024 /*memory_limit*/);
+    for (int i = 0; i < entry_num; i++) {
+      const int value = (i * 7919) % value_num;
+      const int group = value / 100;
+      make_name(value);
+      const char *keys[2] = {reinterpret_cast<const char *>(&group), name};
+      ASSERT_EQ(loader.add(keys, RID(i / 100 + 1, i % 100), 2), RC::SUCCESS);
+    }
+    ASSERT_EQ(loader.finish(), RC::SUCCESS);
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  for (int value = 0; value < value_num; value += 11) {
+    const int group = value / 100;
+    make_name(value);
+    const char *keys[2] = {reinterpret_cast<const char *>(&group), name};
+    std::list<RID> rids;
+    ASSERT_EQ(handler.get_entry(keys, rids, 2), RC::SUCCESS);
+    ASSERT_EQ(rids.size(), entry_num / value_num) << "value=" << value;
+  }
+
+  for (int i = 0; i < entry_num; i += 3) {
+    const int value = (i * 7919) % value_num;
+    const int group = value / 100;
+    make_name(value);
+    const char *keys[2] = {reinterpret_cast<const char *>(&group), name};
+    const RID rid(i / 100 + 1, i % 100);
+    ASSERT_EQ(handler.delete_entry(keys, &rid, 2), RC::SUCCESS);
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  handler.close();
+  ::remove(index_file);
+}
+
+/**
+ * 批量查找乱序、重复和不存在的值，结果与逐个调用 get_entry 相同，相同的值跨越多个叶子节点时也能全部找到
+ */
+TEST(test_bplus_tree_index, get_entries)
+{
+  const char *index_file = "get_entries-i_id.index";
+  ::remove(index_file);
+  BplusTreeHandler handler;
+  ASSERT_EQ(handler.create(index_file, false, {AttrType::INTS}, {4}, 8 /*internal_max_size*/, 8 /*leaf_max_size*/),
+            RC::SUCCESS);
+
+  // 偶数值各有3项，100 有30项
+  const int value_num = 2000;
+  for (int slot = 0; slot < value_num * 3; slot++) {
+    const int key = slot % value_num;
+    if (key % 2 != 0) {
+      continue;
+    }
+    const char *keys[1] = {reinterpret_cast<const char *>(&key)};
+    const RID rid(1, slot);
+    ASSERT_EQ(handler.insert_entry(keys, &rid), RC::SUCCESS);
+  }
+  for (int slot = 0; slot < 27; slot++) {
+    const int key = 100;
+    const char *keys[1] = {reinterpret_cast<const char *>(&key)};
+    const RID rid(2, slot);
+    ASSERT_EQ(handler.insert_entry(keys, &rid), RC::SUCCESS);
+  }
+
+  std::vector<int> values;
+  for (int value = -5; value < value_num + 5; value += 3) {
+    values.push_back(value);
+  }
+  values.push_back(100);
+  values.push_back(100);
+  values.push_back(4);
+  std::shuffle(values.begin(), values.end(), std::mt19937(5));
+
+  std::vector<const char *> user_keys;
+  for (const int &value : values) {
+    user_keys.push_back(reinterpret_cast<const char *>(&value));
+  }
+  std::vector<std::vector<RID>> results;
+  ASSERT_EQ(handler.get_entries(user_keys, results), RC::SUCCESS);
+  ASSERT_EQ(results.size(), values.size());
+
+  for (size_t i = 0; i < values.size(); i++) {
+    const char *keys[1] = {user_keys[i]};
+    std::list<RID> rids;
+    ASSERT_EQ(handler.get_entry(keys, rids), RC::SUCCESS);
+    ASSERT_EQ(std::vector<RID>(rids.begin(), rids.end()), results[i]) << "value=" << values[i];
+  }
+  std::vector<RID> &hundred = results[std::find(values.begin(), values.end(), 100) - values.begin()];
+  ASSERT_EQ(hundred.size(), 30);
+
+  // 空的输入和空的树
+  ASSERT_EQ(handler.get_entries({}, results), RC::SUCCESS);
+  ASSERT_TRUE(results.empty());
+  handler.close();
+  ::remove(index_file);
+
+  ASSERT_EQ(handler.create(index_file, false, {AttrType::INTS}, {4}), RC::SUCCESS);
+  ASSERT_EQ(handler.get_entries(user_keys, results), RC::SUCCESS);
+  ASSERT_EQ(results.size(), values.size());
+  ASSERT_TRUE(std::all_of(results.begin(), results.end(), [](const std::vector<RID> &rids) { return rids.empty(); }));
+  handler.close();
+  ::remove(index_file);
+}
+
+#ifdef CONCURRENCY
+/**
+ * 多个线程同时插入、删除和查找同一个索引，节点很小，会频繁地分裂和合并
+ */
+TEST(test_bplus_tree_index, concurrent_insert_delete_get)
+{
+  const char *index_file = "concurrent-i_id.index";
+  ::remove(index_file);
+  BplusTreeHandler handler;
+  ASSERT_EQ(handler.create(index_file, false, {AttrType::INTS}, {4}, 8 /*internal_max_size*/, 8 /*leaf_max_size*/),
+            RC::SUCCESS);
+
+  const int thread_num = 8;
+  const int key_num_per_thread = 2000;
+  std::atomic<int> errors{0};
+
+  auto make_rid = [](int key) { return RID(key / 100 + 1, key % 100); };
+
+  // 每个线程插入自己的一段键，删除其中的奇数键，每次修改后都能查到自己刚写入的数据
+  std::vector<std::thread> writers;
+  for (int t = 0; t < thread_num; t++) {
+    writers.emplace_back([&, t]() {
+      for (int i = 0; i < key_num_per_thread; i++) {
+        const int key = i * thread_num + t;
+        const char *keys[1] = {reinterpret_cast<const char *>(&key)};
+        const RID rid = make_rid(key);
+        if (handler.insert_entry(keys, &rid) != RC::SUCCESS) {
+          errors++;
+        }
+
+        std::list<RID> rids;
+        if (handler.get_entry(keys, rids) != RC::SUCCESS || rids.size() != 1 || !(rids.front() == rid)) {
+          errors++;
+        }
+
+        if (i > 0 && i % 2 == 0) {
+          const int deleted_key = (i - 1) * thread_num + t;
+          const char *deleted_keys[1] = {reinterpret_cast<const char *>(&deleted_key)};
+          const RID deleted_rid = make_rid(deleted_key);
+          if (handler.delete_entry(deleted_keys, &deleted_rid) != RC::SUCCESS) {
+            errors++;
+          }
+        }
+      }
+    });
+  }
+
+  // 同时从头到尾扫描整棵树，扫描到的键必须是有序的
+  std::atomic<bool> stop{false};
+  std::thread scanner_thread([&]() {
+    while (!stop.load()) {
+      BplusTreeScanner scanner(handler);
+      if (scanner.open(nullptr, 0, false, nullptr, 0, false) != RC::SUCCESS) {
+        errors++;
+        return;
+      }
+      RID rid;
+      int last_key = -1;
+      while (scanner.next_entry(rid, false) == RC::SUCCESS) {
+        const int key = (rid.page_num - 1) * 100 + rid.slot_num;
+        if (key <= last_key) {
+          errors++;
+        }
+        last_key = key;
+      }
+
+      // 批量查找时树也在变化，每个值最多找到一项，并且是这个值自己的 RID
+      std::vector<int> values;
+      for (int key = 0; key < thread_num * key_num_per_thread; key += 5) {
+        values.push_back(key);
+      }
+      std::vector<const char *> user_keys;
+      for (const int &value : values) {
+        user_keys.push_back(reinterpret_cast<const char *>(&value));
+      }
+      std::vector<std::vector<RID>> results;
+      if (handler.get_entries(user_keys, results) != RC::SUCCESS) {
+        errors++;
+        return;
+      }
+      for (size_t i = 0; i < values.size(); i++) {
+        if (results[i].size() > 1 || (results[i].size() == 1 && !(results[i][0] == make_rid(values[i])))) {
+          errors++;
+        }
+      }
+    }
+  });
+
+  for (std::thread &writer : writers) {
+    writer.join();
+  }
+  stop.store(true);
+  scanner_thread.join();
+
+  ASSERT_EQ(errors.load(), 0);
+  ASSERT_TRUE(handler.validate_tree());
+
+  for (int key = 0; key < thread_num * key_num_per_thread; key++) {
+    const int i = key / thread_num;
+    const bool deleted = (i % 2 == 1) && (i + 1 < key_num_per_thread);
+    const char *keys[1] = {reinterpret_cast<const char *>(&key)};
+    std::list<RID> rids;
+    ASSERT_EQ(handler.get_entry(keys, rids), RC::SUCCESS);
+    ASSERT_EQ(rids.size(), deleted ? 0 : 1) << "key=" << key;
+  }
+
+  handler.close();
+  ::remove(index_file);
+}
+#endif  // CONCURRENCY
+
 int main(int argc, char **argv)
 {
   // 分析gtest程序的命令行参数
@@ -1,5 +1,9 @@
+#include <atomic>
+#include <chrono>
 #include <cstring>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "include/storage_engine/buffer/buffer_pool.h"
@@ -93,6 +97,289 @@ TEST(test_buffer, test_buffer_pool)
   test2();  // 读取该文件，检验是否持久化成功
 }
 
+/**
+ * 多个线程并发读取缓冲池中的页面，输出不同线程数下 get_this_page/unpin_page 的吞吐量
+ * 每个线程只访问属于自己的页面，这些页面落在不同的页面锁分区上，相互之间不应该有竞争
+ */
+TEST(test_buffer, test_buffer_pool_concurrency)
+{
+  const char *data_file = "test_buffer_pool_concurrency.data";
+  ::remove(data_file);
+  BufferPoolManager *bpm = new BufferPoolManager();
+  FileBufferPool *bp = nullptr;
+  ASSERT_EQ(bpm->create_file(data_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(data_file, bp), RC::SUCCESS);
+
+  const int page_num = 64;
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(bp->allocate_page(&frame), RC::SUCCESS);
+    memcpy(frame->data(), &i, sizeof(i));
+    frame->mark_dirty();
+    bp->unpin_page(frame);
+  }
+
+  const int op_num_per_thread = 50000;
+  const int max_thread_num = std::max(4, (int)std::thread::hardware_concurrency());
+  for (int thread_num = 1; thread_num <= max_thread_num; thread_num *= 2) {
+    std::vector<std::thread> threads;
+    std::vector<int> errors(thread_num, 0);
+    auto begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < thread_num; t++) {
+      threads.emplace_back([bp, t, thread_num, op_num_per_thread, &errors]() {
+        for (int i = 0; i < op_num_per_thread; i++) {
+          // 页面0是文件头，数据页从1开始
+          PageNum page = 1 + (t + i * thread_num) % page_num;
+          Frame *frame = nullptr;
+          if (bp->get_this_page(page, &frame) != RC::SUCCESS || frame->page_num() != page) {
+            errors[t]++;
+            continue;
+          }
+          bp->unpin_page(frame);
+        }
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    printf("buffer pool concurrency: threads=%d, ops=%d, qps=%.0f\n",
+           thread_num, thread_num * op_num_per_thread, thread_num * op_num_per_thread / seconds);
+    for (int t = 0; t < thread_num; t++) {
+      ASSERT_EQ(errors[t], 0);
+    }
+  }
+
+  // 检查数据没有被并发访问破坏
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(bp->get_this_page(i + 1, &frame), RC::SUCCESS);
+    int value = -1;
+    memcpy(&value, frame->data(), sizeof(value));
+    ASSERT_EQ(value, i);
+    bp->unpin_page(frame);
+  }
+
+  bp->close_file();
+  delete bpm;
+}
+
+/**
+ * 后台刷盘：只写没有被使用的脏页，页面LSN随页面一起落盘
+ */
+TEST(test_buffer, test_page_writer)
+{
+  const char *data_file = "test_buffer_pool_page_writer.data";
+  ::remove(data_file);
+  BufferPoolManager *bpm = new BufferPoolManager();
+  FileBufferPool *bp = nullptr;
+  ASSERT_EQ(bpm->create_file(data_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(data_file, bp), RC::SUCCESS);
+
+  const int page_num = 32;
+  std::vector<Frame *> frames;
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(bp->allocate_page(&frame), RC::SUCCESS);
+    memcpy(frame->data(), &i, sizeof(i));
+    frame->set_lsn(i + 1);
+    frame->mark_dirty();
+    frames.push_back(frame);
+  }
+  // 第一个页面一直在使用中，其它页面都释放掉
+  for (int i = 1; i < page_num; i++) {
+    bp->unpin_page(frames[i]);
+  }
+
+  // 脏页很少，不需要刷盘
+  bpm->page_writer().set_target_clean_ratio(0.25);
+  ASSERT_EQ(bpm->page_writer().run_once(), 0);
+
+  // 要求所有页帧都是干净的：正在使用的数据页和文件头会被跳过
+  bpm->page_writer().set_target_clean_ratio(1.0);
+  ASSERT_EQ(bpm->page_writer().run_once(), page_num - 1);
+  ASSERT_TRUE(frames[0]->dirty());
+
+#ifdef CONCURRENCY
+  // 正在修改的页面，checkpoint 要等修改完成、放开页帧写锁之后再写
+  frames[0]->write_latch();
+  std::atomic<bool> flushed{false};
+  std::thread checkpointer([bpm, &flushed]() {
+    ASSERT_EQ(bpm->flush_all_pages(), RC::SUCCESS);
+    flushed.store(true);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(flushed.load());
+  ASSERT_TRUE(frames[0]->dirty());
+  frames[0]->write_unlatch();
+  checkpointer.join();
+  ASSERT_TRUE(flushed.load());
+#else
+  // checkpoint 时正在使用的页面也要刷盘
+  ASSERT_EQ(bpm->flush_all_pages(), RC::SUCCESS);
+#endif
+  ASSERT_FALSE(frames[0]->dirty());
+  bp->unpin_page(frames[0]);
+
+  bp->close_file();
+  delete bpm;
+
+  // 重新打开文件检查数据
+  bpm = new BufferPoolManager();
+  ASSERT_EQ(bpm->open_file(data_file, bp), RC::SUCCESS);
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(bp->get_this_page(i + 1, &frame), RC::SUCCESS);
+    int value = -1;
+    memcpy(&value, frame->data(), sizeof(value));
+    ASSERT_EQ(value, i);
+    ASSERT_EQ(frame->lsn(), i + 1);
+    bp->unpin_page(frame);
+  }
+  bp->close_file();
+  delete bpm;
+}
+
+/**
+ * 批量预读：连续的页面一次读入，跳过已经缓存的页面，不会超出文件范围
+ */
+TEST(test_buffer, test_load_pages)
+{
+  const char *data_file = "test_buffer_pool_load_pages.data";
+  ::remove(data_file);
+  BufferPoolManager *bpm = new BufferPoolManager();
+  FileBufferPool *bp = nullptr;
+  ASSERT_EQ(bpm->create_file(data_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(data_file, bp), RC::SUCCESS);
+
+  const int page_num = 100;
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(bp->allocate_page(&frame), RC::SUCCESS);
+    memcpy(frame->data(), &i, sizeof(i));
+    frame->mark_dirty();
+    bp->unpin_page(frame);
+  }
+  bp->close_file();
+  delete bpm;
+
+  bpm = new BufferPoolManager();
+  ASSERT_EQ(bpm->open_file(data_file, bp), RC::SUCCESS);
+
+  // 先单独读一个页面，批量加载时要跳过它
+  Frame *cached = nullptr;
+  ASSERT_EQ(bp->get_this_page(10, &cached), RC::SUCCESS);
+  bp->unpin_page(cached);
+
+  for (PageNum start = 1; start <= page_num; start += 32) {
+    ASSERT_EQ(bp->load_pages(start, 32), RC::SUCCESS);
+  }
+  // 超出文件范围的请求直接忽略
+  ASSERT_EQ(bp->load_pages(page_num + 10, 32), RC::SUCCESS);
+
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(bp->get_this_page(i + 1, &frame), RC::SUCCESS);
+    int value = -1;
+    memcpy(&value, frame->data(), sizeof(value));
+    ASSERT_EQ(value, i);
+    ASSERT_EQ(frame->page_num(), i + 1);
+    bp->unpin_page(frame);
+  }
+
+  bp->close_file();
+  delete bpm;
+}
+
+/**
+ * 页帧的读写锁：持有写锁的线程可以再次加锁，多个线程可以同时加读锁，写锁与其它线程互斥
+ */
+TEST(test_buffer, test_page_latch)
+{
+  const char *data_file = "test_buffer_pool_page_latch.data";
+  ::remove(data_file);
+  BufferPoolManager *bpm = new BufferPoolManager();
+  FileBufferPool *bp = nullptr;
+  ASSERT_EQ(bpm->create_file(data_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(data_file, bp), RC::SUCCESS);
+
+  Frame *frame = nullptr;
+  ASSERT_EQ(bp->allocate_page(&frame), RC::SUCCESS);
+  const PageNum page_num = frame->page_num();
+  bp->unpin_page(frame);
+
+  Frame *write_frame = nullptr;
+  Frame *read_frame = nullptr;
+  Frame *recursive_frame = nullptr;
+  ASSERT_EQ(bp->get_this_page_exclusive(page_num, &write_frame), RC::SUCCESS);
+  ASSERT_EQ(bp->get_this_page_shared(page_num, &read_frame), RC::SUCCESS);
+  ASSERT_EQ(bp->try_get_this_page_exclusive(page_num, &recursive_frame), RC::SUCCESS);
+  ASSERT_EQ(write_frame, read_frame);
+  ASSERT_EQ(write_frame, recursive_frame);
+  ASSERT_EQ(write_frame->pin_count(), 3);
+
+#ifdef CONCURRENCY
+  RC other_rc = RC::SUCCESS;
+  std::thread([bp, page_num, &other_rc]() {
+    Frame *other_frame = nullptr;
+    other_rc = bp->try_get_this_page_exclusive(page_num, &other_frame);
+  }).join();
+  ASSERT_EQ(other_rc, RC::LOCKED_CONCURRENCY_CONFLICT);
+  ASSERT_EQ(write_frame->pin_count(), 3);
+#endif
+
+  bp->unpin_page_exclusive(recursive_frame);
+  bp->unpin_page_shared(read_frame);
+  bp->unpin_page_exclusive(write_frame);
+  ASSERT_EQ(write_frame->pin_count(), 0);
+
+#ifdef CONCURRENCY
+  // 两个线程同时持有读锁，这时其它线程加写锁失败
+  std::atomic<int> readers{0};
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 2; i++) {
+    threads.emplace_back([bp, page_num, &readers, &done]() {
+      Frame *shared_frame = nullptr;
+      if (bp->get_this_page_shared(page_num, &shared_frame) != RC::SUCCESS) {
+        return;
+      }
+      readers++;
+      while (!done.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      bp->unpin_page_shared(shared_frame);
+    });
+  }
+  for (int i = 0; i < 5000 && readers.load() < 2; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(readers.load(), 2);
+  ASSERT_EQ(bp->try_get_this_page_exclusive(page_num, &frame), RC::LOCKED_CONCURRENCY_CONFLICT);
+  done.store(true);
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(bp->try_get_this_page_exclusive(page_num, &frame), RC::SUCCESS);
+  bp->unpin_page_exclusive(frame);
+#endif
+
+#ifdef DEBUG_LATCH
+  // 持有读锁的线程再加写锁会死锁
+  EXPECT_DEATH(
+      {
+        Frame *shared_frame = nullptr;
+        bp->get_this_page_shared(page_num, &shared_frame);
+        shared_frame->write_latch();
+      },
+      "");
+#endif
+
+  bp->close_file();
+  delete bpm;
+}
+
 int main(int argc, char **argv)
 {
   // 分析gtest程序的命令行参数
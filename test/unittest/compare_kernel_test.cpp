@@ -0,0 +1,220 @@
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/lang/bitmap.h"
+#include "include/storage_engine/buffer/buffer_pool.h"
+#include "include/storage_engine/recorder/compare_kernel.h"
+#include "include/storage_engine/recorder/condition_filter.h"
+#include "include/storage_engine/recorder/record_manager.h"
+
+static const CompOp COMP_OPS[] = {EQUAL_TO, LESS_EQUAL, NOT_EQUAL, LESS_THAN, GREAT_EQUAL, GREAT_THAN};
+
+/**
+ * 与 Value::compare 相同语义的逐个比较，作为比较内核结果的参照
+ */
+static bool expected_result(CompOp comp_op, int cmp)
+{
+  switch (comp_op) {
+    case EQUAL_TO: return cmp == 0;
+    case LESS_EQUAL: return cmp <= 0;
+    case NOT_EQUAL: return cmp != 0;
+    case LESS_THAN: return cmp < 0;
+    case GREAT_EQUAL: return cmp >= 0;
+    case GREAT_THAN: return cmp > 0;
+    default: return false;
+  }
+}
+
+static int compare_value(int32_t v, int32_t c) { return v < c ? -1 : (v > c ? 1 : 0); }
+static int compare_value(float v, float c)
+{
+  float cmp = v - c;
+  return cmp > EPSILON ? 1 : (cmp < -EPSILON ? -1 : 0);
+}
+
+/**
+ * 值在内存中按 stride 存放，覆盖连续存放、记录中的字段和不足8个的尾部
+ */
+template <typename T>
+static void check_kernel(const std::vector<T> &values, T constant, int stride)
+{
+  const int count = static_cast<int>(values.size());
+  std::vector<char> data(static_cast<size_t>(count) * stride + 1, 0x5A);
+  for (int i = 0; i < count; i++) {
+    memcpy(data.data() + 1 + static_cast<size_t>(i) * stride, &values[i], sizeof(T));  // 故意不对齐
+  }
+
+  for (CompOp comp_op : COMP_OPS) {
+    std::vector<char> bitmap_data((count + 7) / 8 + 1, 0x7F);
+    if (std::is_same<T, float>::value) {
+      compare_float(data.data() + 1, stride, count, comp_op, constant, bitmap_data.data());
+    } else {
+      compare_int32(data.data() + 1, stride, count, comp_op, constant, bitmap_data.data());
+    }
+    common::Bitmap bitmap(bitmap_data.data(), count);
+    for (int i = 0; i < count; i++) {
+      ASSERT_EQ(bitmap.get_bit(i), expected_result(comp_op, compare_value(values[i], constant)))
+          << "comp_op=" << comp_op << ", index=" << i << ", count=" << count << ", stride=" << stride;
+    }
+    // 最后一个字节中多余的位被清零，后面的内存没有被修改
+    for (int i = count; i < (count + 7) / 8 * 8; i++) {
+      ASSERT_FALSE(bitmap.get_bit(i));
+    }
+    ASSERT_EQ(bitmap_data[(count + 7) / 8], 0x7F);
+  }
+}
+
+TEST(test_compare_kernel, test_int32)
+{
+  printf("compare kernel: %s\n", compare_kernel_name());
+  std::mt19937 random(1);
+  for (int count : {0, 1, 7, 8, 9, 31, 64, 1000}) {
+    std::vector<int32_t> values(count);
+    for (int i = 0; i < count; i++) {
+      values[i] = static_cast<int32_t>(random() % 21) - 10;
+    }
+    if (count > 0) {
+      values[0] = INT32_MIN;
+      values[count - 1] = INT32_MAX;
+    }
+    for (int stride : {4, 12, 36}) {
+      check_kernel<int32_t>(values, 0, stride);
+      check_kernel<int32_t>(values, -10, stride);
+      check_kernel<int32_t>(values, INT32_MAX, stride);
+    }
+  }
+}
+
+TEST(test_compare_kernel, test_float)
+{
+  std::mt19937 random(2);
+  for (int count : {0, 1, 7, 8, 9, 31, 64, 1000}) {
+    std::vector<float> values(count);
+    for (int i = 0; i < count; i++) {
+      values[i] = static_cast<float>(static_cast<int>(random() % 21) - 10) / 4;
+    }
+    // 差值在EPSILON以内的认为相等
+    if (count > 2) {
+      values[1] = 0.5f + 1e-7f;
+      values[2] = 0.5f - 1e-5f;
+    }
+    for (int stride : {4, 12, 36}) {
+      check_kernel<float>(values, 0.5f, stride);
+      check_kernel<float>(values, -2.5f, stride);
+    }
+  }
+}
+
+/**
+ * 输出比较内核与逐个比较的吞吐
+ */
+TEST(test_compare_kernel, test_throughput)
+{
+  const int count = 1 << 16;
+  const int rounds = 200;
+  std::vector<int32_t> values(count);
+  std::mt19937 random(3);
+  for (int i = 0; i < count; i++) {
+    values[i] = static_cast<int32_t>(random() % 1000);
+  }
+  std::vector<char> bitmap((count + 7) / 8);
+
+  auto begin = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) {
+    compare_int32(reinterpret_cast<const char *>(values.data()), sizeof(int32_t), count, LESS_THAN, 500, bitmap.data());
+  }
+  double kernel_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+  int selected = 0;
+  begin = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < count; i++) {
+      selected += expected_result(LESS_THAN, compare_value(values[i], 500)) ? 1 : 0;
+    }
+  }
+  double scalar_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  printf("compare kernel: %s %.0f M values/sec, scalar %.0f M values/sec (selected %d)\n",
+         compare_kernel_name(), count * rounds / kernel_seconds / 1e6, count * rounds / scalar_seconds / 1e6, selected);
+}
+
+/**
+ * 扫描记录文件时，INTS/FLOATS 上的条件直接在页面内存上批量过滤，结果与逐条过滤相同
+ */
+TEST(test_compare_kernel, test_scan_page_filter)
+{
+  const char *data_file = "test_compare_kernel.data";
+  ::remove(data_file);
+  BufferPoolManager *bpm = new BufferPoolManager();
+  FileBufferPool *bp = nullptr;
+  ASSERT_EQ(bpm->create_file(data_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(data_file, bp), RC::SUCCESS);
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(file_handler.init(bp), RC::SUCCESS);
+
+  // 记录的格式：int id | float score | 4字节填充
+  const int record_size = 12;
+  const int record_num = 5000;
+  std::vector<RID> rids(record_num);
+  for (int i = 0; i < record_num; i++) {
+    char data[record_size] = {0};
+    int32_t id = i;
+    float score = static_cast<float>(i % 100) / 10;
+    memcpy(data, &id, sizeof(id));
+    memcpy(data + 4, &score, sizeof(score));
+    ASSERT_EQ(file_handler.insert_record(data, record_size, &rids[i]), RC::SUCCESS);
+  }
+  // 删除一部分记录，删除的槽位上的旧数据不能出现在结果中
+  for (int i = 0; i < record_num; i += 3) {
+    ASSERT_EQ(file_handler.delete_record(&rids[i]), RC::SUCCESS);
+  }
+
+  // 1000 < id and score <= 5.0
+  ConDesc id_value{false, 0, 0, Value(1000)};
+  ConDesc id_attr{true, 4, 0, Value()};
+  ConDesc score_attr{true, 4, 4, Value()};
+  ConDesc score_value{false, 0, 0, Value(5.0f)};
+  DefaultConditionFilter id_filter;
+  DefaultConditionFilter score_filter;
+  ASSERT_EQ(id_filter.init(id_value, id_attr, INTS, LESS_THAN), RC::SUCCESS);
+  ASSERT_EQ(score_filter.init(score_attr, score_value, FLOATS, LESS_EQUAL), RC::SUCCESS);
+  const ConditionFilter *filters[] = {&id_filter, &score_filter};
+  CompositeConditionFilter filter;
+  ASSERT_EQ(filter.init(filters, 2), RC::SUCCESS);
+
+  int expected = 0;
+  for (int i = 0; i < record_num; i++) {
+    if (i % 3 != 0 && i > 1000 && static_cast<float>(i % 100) / 10 <= 5.0f) {
+      expected++;
+    }
+  }
+
+  RecordFileScanner scanner;
+  ASSERT_EQ(scanner.open_scan(nullptr, *bp, nullptr, true, &filter), RC::SUCCESS);
+  int count = 0;
+  Record record;
+  while (scanner.has_next()) {
+    ASSERT_EQ(scanner.next(record), RC::SUCCESS);
+    ASSERT_TRUE(filter.filter(record));
+    count++;
+  }
+  ASSERT_EQ(count, expected);
+  scanner.close_scan();
+
+  file_handler.close();
+  bp->close_file();
+  delete bpm;
+}
+
+int main(int argc, char **argv)
+{
+  // 分析gtest程序的命令行参数
+  testing::InitGoogleTest(&argc, argv);
+
+  // 调用RUN_ALL_TESTS()运行所有测试用例
+  // main函数返回RUN_ALL_TESTS()的运行结果
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/query_engine/structor/external_sorter.h"
+
+struct TestRow
+{
+  std::string key;
+  std::string payload;
+};
+
+/**
+ * 生成 row_num 行数据，排序键有很多重复，用来检查排序是否稳定
+ */
+static std::vector<TestRow> make_rows(int row_num)
+{
+  std::mt19937 random(row_num);
+  std::vector<TestRow> rows;
+  for (int i = 0; i < row_num; i++) {
+    std::string key = std::to_string(random() % 500);
+    if (random() % 3 == 0) {
+      key.push_back('\0');  // 排序键是二进制串
+      key += std::to_string(i % 7);
+    }
+    rows.push_back(TestRow{key, "payload-" + std::to_string(i)});
+  }
+  return rows;
+}
+
+/**
+ * 把数据交给 ExternalSorter 排序，检查结果与 std::stable_sort 的前 limit 行相同
+ */
+static void check_sort(int row_num, size_t memory_limit, int64_t limit, int expected_min_runs)
+{
+  std::vector<TestRow> rows = make_rows(row_num);
+  ExternalSorter sorter(memory_limit, limit);
+  for (const TestRow &row : rows) {
+    ASSERT_EQ(sorter.add(row.key, row.payload), RC::SUCCESS);
+  }
+  ASSERT_EQ(sorter.finish(), RC::SUCCESS);
+  ASSERT_GE(sorter.run_num(), expected_min_runs);
+
+  std::stable_sort(rows.begin(), rows.end(), [](const TestRow &a, const TestRow &b) { return a.key < b.key; });
+  size_t expected_num = rows.size();
+  if (limit >= 0) {
+    expected_num = std::min(expected_num, static_cast<size_t>(limit));
+  }
+
+  const char *payload = nullptr;
+  int payload_len = 0;
+  for (size_t i = 0; i < expected_num; i++) {
+    ASSERT_EQ(sorter.next(payload, payload_len), RC::SUCCESS) << "index=" << i;
+    ASSERT_EQ(std::string(payload, payload_len), rows[i].payload) << "index=" << i;
+  }
+  ASSERT_EQ(sorter.next(payload, payload_len), RC::RECORD_EOF);
+}
+
+TEST(test_external_sorter, test_in_memory)
+{
+  check_sort(0, ExternalSorter::DEFAULT_MEMORY_LIMIT, -1, 0);
+  check_sort(1000, ExternalSorter::DEFAULT_MEMORY_LIMIT, -1, 0);
+}
+
+TEST(test_external_sorter, test_spill_and_merge)
+{
+  // 每个有序段大约100行，需要归并很多个有序段
+  check_sort(10000, 4096, -1, 50);
+  check_sort(3, 1, -1, 3);
+}
+
+TEST(test_external_sorter, test_top_k)
+{
+  check_sort(10000, ExternalSorter::DEFAULT_MEMORY_LIMIT, 10, 0);
+  check_sort(10000, ExternalSorter::DEFAULT_MEMORY_LIMIT, 0, 0);
+  check_sort(5, ExternalSorter::DEFAULT_MEMORY_LIMIT, 10, 0);
+  // 堆占用的内存超过限制以后退回到外部排序
+  check_sort(10000, 4096, 2000, 1);
+}
+
+int main(int argc, char **argv)
+{
+  // 分析gtest程序的命令行参数
+  testing::InitGoogleTest(&argc, argv);
+
+  // 调用RUN_ALL_TESTS()运行所有测试用例
+  // main函数返回RUN_ALL_TESTS()的运行结果
+  return RUN_ALL_TESTS();
+}
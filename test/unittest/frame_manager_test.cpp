@@ -1,3 +1,7 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "include/common/rc.h"
 #include "include/storage_engine/buffer/frame.h"
 #include "include/storage_engine/buffer/frame_manager.h"
@@ -68,6 +72,131 @@ TEST(test_buffer, test_frame_manager)
   frame_manager.cleanup();
 }
 
+/**
+ * 模拟buffer pool访问页面：先get，没有命中时再分配frame，必要时驱逐一个frame
+ * @return 是否命中
+ */
+static bool access_page(FrameManager &frame_manager, int file_desc, PageNum page_num)
+{
+  auto evict_action = [](Frame *frame) { return RC::SUCCESS; };
+  Frame *frame = frame_manager.get(file_desc, page_num);
+  bool hit = frame != nullptr;
+  while (frame == nullptr) {
+    frame = frame_manager.alloc(file_desc, page_num);
+    if (frame == nullptr) {
+      frame_manager.evict_frames(1, evict_action);
+    }
+  }
+  frame->unpin();
+  return hit;
+}
+
+/**
+ * 一次大的顺序扫描之后，之前反复访问的热点页面应该仍然在内存中
+ */
+TEST(test_buffer, test_frame_manager_scan_resistance)
+{
+  FrameManager frame_manager("Test");
+  frame_manager.init(2);
+
+  const int file_desc = 0;
+  const int hot_page_num = 32;
+  const int scan_page_num = 2000;
+
+  // 热点页面，比如B+树的内部节点，会被反复访问
+  for (int round = 0; round < 4; round++) {
+    for (int i = 0; i < hot_page_num; i++) {
+      access_page(frame_manager, file_desc, i);
+    }
+  }
+
+  // 全表扫描，每个页面只访问一次
+  int hit_count = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < scan_page_num; i++) {
+    hit_count += access_page(frame_manager, file_desc, hot_page_num + i) ? 1 : 0;
+  }
+  auto end = std::chrono::steady_clock::now();
+  ASSERT_EQ(hit_count, 0);
+  printf("frame manager scan: pages=%d, qps=%.0f\n",
+         scan_page_num, scan_page_num / std::chrono::duration<double>(end - begin).count());
+
+  int hot_hit_count = 0;
+  for (int i = 0; i < hot_page_num; i++) {
+    hot_hit_count += access_page(frame_manager, file_desc, i) ? 1 : 0;
+  }
+  printf("frame manager hot pages hit rate after scan: %.2f\n", (double)hot_hit_count / hot_page_num);
+  ASSERT_EQ(hot_hit_count, hot_page_num);
+
+  // 混合负载：大部分访问落在热点页面上，同时夹杂扫描
+  int total = 0;
+  hit_count = 0;
+  begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < 100000; i++, total++) {
+    PageNum page_num = (i % 4 == 0) ? hot_page_num + scan_page_num + i : i % hot_page_num;
+    hit_count += access_page(frame_manager, file_desc, page_num) ? 1 : 0;
+  }
+  end = std::chrono::steady_clock::now();
+  printf("frame manager mixed workload: hit rate=%.2f, qps=%.0f\n",
+         (double)hit_count / total, total / std::chrono::duration<double>(end - begin).count());
+  ASSERT_GE(hit_count, total * 3 / 4 - hot_page_num);
+
+  auto evict_action = [](Frame *frame) { return RC::SUCCESS; };
+  while (frame_manager.frame_num() > 0) {
+    frame_manager.evict_frames(frame_manager.frame_num(), evict_action);
+  }
+  frame_manager.cleanup();
+}
+
+/**
+ * 多个线程并发访问已经在内存中的页面，输出不同线程数下的吞吐量
+ */
+TEST(test_buffer, test_frame_manager_concurrency)
+{
+  FrameManager frame_manager("Test");
+  frame_manager.init(2);
+
+  const int file_desc = 0;
+  const int page_num = 128;
+  for (int i = 0; i < page_num; i++) {
+    access_page(frame_manager, file_desc, i);
+  }
+
+  const int op_num_per_thread = 100000;
+  const int max_thread_num = std::max(4, (int)std::thread::hardware_concurrency());
+  for (int thread_num = 1; thread_num <= max_thread_num; thread_num *= 2) {
+    std::vector<std::thread> threads;
+    std::vector<int> miss_counts(thread_num, 0);
+    auto begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < thread_num; t++) {
+      threads.emplace_back([&frame_manager, &miss_counts, t, thread_num, op_num_per_thread]() {
+        for (int i = 0; i < op_num_per_thread; i++) {
+          Frame *frame = frame_manager.get(file_desc, (t + i * thread_num) % page_num);
+          if (frame == nullptr) {
+            miss_counts[t]++;
+            continue;
+          }
+          frame->unpin();
+        }
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    printf("frame manager concurrency: threads=%d, qps=%.0f\n", thread_num,
+           thread_num * op_num_per_thread / std::chrono::duration<double>(end - begin).count());
+    for (int t = 0; t < thread_num; t++) {
+      ASSERT_EQ(miss_counts[t], 0);
+    }
+  }
+
+  auto evict_action = [](Frame *frame) { return RC::SUCCESS; };
+  frame_manager.evict_frames(page_num, evict_action);
+  ASSERT_EQ(frame_manager.frame_num(), 0);
+  frame_manager.cleanup();
+}
+
 int main(int argc, char **argv)
 {
   // 分析gtest程序的命令行参数
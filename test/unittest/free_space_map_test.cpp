@@ -0,0 +1,186 @@
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/storage_engine/buffer/buffer_pool.h"
+#include "include/storage_engine/recorder/free_space_map.h"
+#include "include/storage_engine/recorder/record_manager.h"
+
+/**
+ * 占用的页面在释放之前不会再交给别人，正常关闭以后可以直接加载，没有正常关闭或者页面个数不一致时需要重建
+ */
+TEST(test_free_space_map, test_claim_and_reload)
+{
+  const char *fsm_file = "test_free_space_map.fsm";
+  ::remove(fsm_file);
+
+  {
+    FreeSpaceMap fsm;
+    bool loaded = true;
+    ASSERT_EQ(fsm.open(fsm_file, 200, loaded), RC::SUCCESS);
+    ASSERT_FALSE(loaded);
+
+    fsm.set_free(3);
+    fsm.set_free(70);
+    fsm.set_free(150);
+    ASSERT_EQ(fsm.free_page_count(), 3);
+
+    ASSERT_EQ(fsm.claim(1, 200), 3);
+    ASSERT_EQ(fsm.claim(1, 200), 70);
+    ASSERT_EQ(fsm.claim(71, 150), BP_INVALID_PAGE_NUM);
+    fsm.release(3, true /*has_free_space*/);
+    fsm.release(70, false /*has_free_space*/);
+    ASSERT_EQ(fsm.claim(4, 200), 150);
+    fsm.release(150, true /*has_free_space*/);
+
+    fsm.extend(230);
+    ASSERT_EQ(fsm.page_count(), 231);
+    fsm.set_free(230);
+    ASSERT_EQ(fsm.close(), RC::SUCCESS);
+  }
+
+  {
+    FreeSpaceMap fsm;
+    bool loaded = false;
+    ASSERT_EQ(fsm.open(fsm_file, 231, loaded), RC::SUCCESS);
+    ASSERT_TRUE(loaded);
+    ASSERT_EQ(fsm.free_page_count(), 3);
+    ASSERT_EQ(fsm.claim(1, 231), 3);
+    ASSERT_EQ(fsm.claim(4, 231), 150);
+    ASSERT_EQ(fsm.claim(151, 231), 230);
+
+    // 没有关闭时文件中的位图是无效的
+    FreeSpaceMap other;
+    ASSERT_EQ(other.open(fsm_file, 231, loaded), RC::SUCCESS);
+    ASSERT_FALSE(loaded);
+    ASSERT_EQ(other.free_page_count(), 0);
+    ASSERT_EQ(other.close(), RC::SUCCESS);
+  }
+
+  {
+    // 数据文件的页面个数变了
+    FreeSpaceMap fsm;
+    bool loaded = true;
+    ASSERT_EQ(fsm.open(fsm_file, 240, loaded), RC::SUCCESS);
+    ASSERT_FALSE(loaded);
+  }
+  ::remove(fsm_file);
+}
+
+/**
+ * 表文件重新打开时从空闲空间表中找到删除过记录的页面，不需要扫描数据页面
+ */
+TEST(test_free_space_map, test_record_file_reopen)
+{
+  const char *data_file = "test_free_space_map.data";
+  const char *fsm_file = "test_free_space_map_record.fsm";
+  ::remove(data_file);
+  ::remove(fsm_file);
+  BufferPoolManager *bpm = new BufferPoolManager();
+  FileBufferPool *bp = nullptr;
+  ASSERT_EQ(bpm->create_file(data_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(data_file, bp), RC::SUCCESS);
+
+  const int record_size = 64;
+  const int record_num = 2000;
+  char data[record_size] = {0};
+  std::vector<RID> rids(record_num);
+  {
+    RecordFileHandler file_handler;
+    ASSERT_EQ(file_handler.init(bp, fsm_file), RC::SUCCESS);
+    for (int i = 0; i < record_num; i++) {
+      ASSERT_EQ(file_handler.insert_record(data, record_size, &rids[i]), RC::SUCCESS);
+    }
+    ASSERT_EQ(file_handler.free_page_count(), 1);
+    ASSERT_EQ(file_handler.delete_record(&rids[0]), RC::SUCCESS);
+    ASSERT_EQ(file_handler.free_page_count(), 2);
+    file_handler.close();
+  }
+
+  {
+    RecordFileHandler file_handler;
+    ASSERT_EQ(file_handler.init(bp, fsm_file), RC::SUCCESS);
+    ASSERT_EQ(file_handler.free_page_count(), 2);
+
+    // 从空闲空间表中找到的页面可以插入；插满以后就不再是空闲页面
+    RID rid;
+    std::set<PageNum> pages;
+    while (file_handler.free_page_count() > 0) {
+      ASSERT_EQ(file_handler.insert_record(data, record_size, &rid), RC::SUCCESS);
+      pages.insert(rid.page_num);
+    }
+    ASSERT_EQ(pages.count(rids[0].page_num), 1u);
+    ASSERT_EQ(pages.count(rids[record_num - 1].page_num), 1u);
+    file_handler.close();
+  }
+
+  bp->close_file();
+  delete bpm;
+  ::remove(data_file);
+  ::remove(fsm_file);
+}
+
+#ifdef CONCURRENCY
+/**
+ * 多个线程并发插入，每条记录的位置都不相同
+ */
+TEST(test_free_space_map, test_concurrent_insert)
+{
+  const char *data_file = "test_free_space_map_concurrent.data";
+  ::remove(data_file);
+  BufferPoolManager *bpm = new BufferPoolManager();
+  FileBufferPool *bp = nullptr;
+  ASSERT_EQ(bpm->create_file(data_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(data_file, bp), RC::SUCCESS);
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(file_handler.init(bp), RC::SUCCESS);
+
+  const int thread_num = 4;
+  const int record_num = 5000;
+  const int record_size = 32;
+  std::vector<std::vector<RID>> rids(thread_num, std::vector<RID>(record_num));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; t++) {
+    threads.emplace_back([&, t]() {
+      char data[record_size];
+      for (int i = 0; i < record_num; i++) {
+        memset(data, t * record_num + i, sizeof(data));
+        ASSERT_EQ(file_handler.insert_record(data, record_size, &rids[t][i]), RC::SUCCESS);
+        if (i % 4 == 0) {
+          ASSERT_EQ(file_handler.delete_record(&rids[t][i]), RC::SUCCESS);
+        }
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  std::set<std::pair<PageNum, SlotNum>> positions;
+  for (int t = 0; t < thread_num; t++) {
+    for (int i = 0; i < record_num; i++) {
+      if (i % 4 != 0) {
+        ASSERT_TRUE(positions.emplace(rids[t][i].page_num, rids[t][i].slot_num).second);
+      }
+    }
+  }
+
+  file_handler.close();
+  bp->close_file();
+  delete bpm;
+  ::remove(data_file);
+}
+#endif
+
+int main(int argc, char **argv)
+{
+  // 分析gtest程序的命令行参数
+  testing::InitGoogleTest(&argc, argv);
+
+  // 调用RUN_ALL_TESTS()运行所有测试用例
+  // main函数返回RUN_ALL_TESTS()的运行结果
+  return RUN_ALL_TESTS();
+}
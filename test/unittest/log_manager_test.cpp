@@ -0,0 +1,90 @@
+#include <chrono>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/storage_engine/recover/log_manager.h"
+
+/**
+ * 多个线程并发提交事务，输出不同线程数下每秒提交的事务数
+ * 每个事务写一条开始日志、一条数据日志和一条提交日志，提交时要等日志落盘
+ */
+void commit_benchmark(std::chrono::microseconds delay)
+{
+  const char *log_dir = "log_manager_test_dir";
+  system("rm -rf log_manager_test_dir");
+  ASSERT_EQ(mkdir(log_dir, S_IRWXU), 0);
+
+  LogManager log_manager;
+  ASSERT_EQ(log_manager.init(log_dir), RC::SUCCESS);
+  log_manager.set_group_commit_delay(delay);
+
+  const int commit_num_per_thread = 200;
+  const char data[16] = "0123456789abcde";
+  std::atomic_int32_t next_trx_id{1};
+#ifdef CONCURRENCY
+  const int max_thread_num = 16;
+#else
+  // 没有开启 CONCURRENCY 时日志缓存的锁是空操作，只能单线程写日志
+  const int max_thread_num = 1;
+#endif
+  for (int thread_num = 1; thread_num <= max_thread_num; thread_num *= 2) {
+    std::vector<std::thread> threads;
+    std::vector<int> errors(thread_num, 0);
+    auto begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < thread_num; t++) {
+      threads.emplace_back([&, t]() {
+        for (int i = 0; i < commit_num_per_thread; i++) {
+          int32_t trx_id = next_trx_id++;
+          RID rid(1, i);
+          if (log_manager.append_begin_trx_log(trx_id) != RC::SUCCESS ||
+              log_manager.append_record_log(LogEntryType::INSERT, trx_id, 0, rid, sizeof(data), 0, data) != RC::SUCCESS) {
+            errors[t]++;
+            continue;
+          }
+          LSN lsn = log_manager.current_lsn();
+          if (log_manager.append_commit_trx_log(trx_id, trx_id) != RC::SUCCESS || log_manager.flushed_lsn() < lsn) {
+            errors[t]++;
+          }
+        }
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    printf("group commit: delay=%ldus, threads=%d, commits=%d, commits/sec=%.0f\n",
+           delay.count(), thread_num, thread_num * commit_num_per_thread, thread_num * commit_num_per_thread / seconds);
+    for (int t = 0; t < thread_num; t++) {
+      ASSERT_EQ(errors[t], 0);
+    }
+  }
+
+  // 所有日志都已经写入文件
+  ASSERT_EQ(log_manager.flushed_lsn(), log_manager.current_lsn());
+  struct stat st;
+  ASSERT_EQ(stat("log_manager_test_dir/redo.log", &st), 0);
+  ASSERT_EQ(st.st_size, log_manager.current_lsn());
+}
+
+TEST(test_log_manager, test_group_commit)
+{
+  commit_benchmark(std::chrono::microseconds(0));
+}
+
+TEST(test_log_manager, test_group_commit_delay)
+{
+  commit_benchmark(std::chrono::microseconds(200));
+}
+
+int main(int argc, char **argv)
+{
+  // 分析gtest程序的命令行参数
+  testing::InitGoogleTest(&argc, argv);
+
+  // 调用RUN_ALL_TESTS()运行所有测试用例
+  // main函数返回RUN_ALL_TESTS()的运行结果
+  return RUN_ALL_TESTS();
+}
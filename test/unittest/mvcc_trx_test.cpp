@@ -0,0 +1,197 @@
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/storage_engine/buffer/buffer_pool.h"
+#include "include/storage_engine/index/index.h"
+#include "include/storage_engine/recorder/record_manager.h"
+#include "include/storage_engine/recover/log_manager.h"
+#include "include/storage_engine/schema/database.h"
+#include "include/storage_engine/transaction/mvcc_trx.h"
+
+/**
+ * 快照只看到创建之前已经完整提交的事务，正在修改记录的提交对快照不可见
+ */
+TEST(test_mvcc_trx, test_snapshot)
+{
+  const char *log_dir = "mvcc_trx_test_dir";
+  system("rm -rf mvcc_trx_test_dir");
+  ASSERT_EQ(mkdir(log_dir, S_IRWXU), 0);
+  LogManager log_manager;
+  ASSERT_EQ(log_manager.init(log_dir), RC::SUCCESS);
+
+  MvccTrxManager trx_kit;
+  ASSERT_EQ(trx_kit.init(), RC::SUCCESS);
+
+  MvccTrx *trx1 = static_cast<MvccTrx *>(trx_kit.create_trx(&log_manager));
+  MvccTrx *trx2 = static_cast<MvccTrx *>(trx_kit.create_trx(&log_manager));
+  ASSERT_EQ(trx1->start_if_need(), RC::SUCCESS);
+  ASSERT_EQ(trx1->snapshot().xmin(), trx1->id());
+  ASSERT_EQ(trx_kit.oldest_snapshot_xmin(), trx1->id());
+
+  // 模拟另一个事务分配了提交号，但是还没有修改完记录
+  const int32_t commit_xid = trx_kit.start_commit();
+  ASSERT_EQ(trx2->start_if_need(), RC::SUCCESS);
+  ASSERT_GT(trx2->id(), commit_xid);
+  ASSERT_FALSE(trx1->snapshot().committed(commit_xid));
+  ASSERT_FALSE(trx2->snapshot().committed(commit_xid));
+  ASSERT_FALSE(trx1->snapshot().committed(trx2->id()));
+
+  trx_kit.finish_trx(0, commit_xid);
+  ASSERT_FALSE(trx2->snapshot().committed(commit_xid));
+
+  // trx1 提交以后，新的快照可以看到前面的提交，最小的 xmin 是 trx2 开始时 trx1 的事务号
+  ASSERT_EQ(trx1->commit(), RC::SUCCESS);
+  ASSERT_EQ(trx_kit.oldest_snapshot_xmin(), trx2->snapshot().xmin());
+  MvccTrx *trx3 = static_cast<MvccTrx *>(trx_kit.create_trx(&log_manager));
+  ASSERT_EQ(trx3->start_if_need(), RC::SUCCESS);
+  ASSERT_TRUE(trx3->snapshot().committed(commit_xid));
+  ASSERT_EQ(trx3->snapshot().xmin(), trx2->id());
+
+  ASSERT_EQ(trx2->rollback(), RC::SUCCESS);
+  ASSERT_EQ(trx3->commit(), RC::SUCCESS);
+  // 没有活跃事务时，是下一个要分配的事务号
+  const int32_t oldest_xmin = trx_kit.oldest_snapshot_xmin();
+  ASSERT_EQ(oldest_xmin, trx_kit.next_trx_id());
+
+  trx_kit.destroy_trx(trx1);
+  trx_kit.destroy_trx(trx2);
+  trx_kit.destroy_trx(trx3);
+}
+
+// 事务能看到的所有记录的 id
+static std::vector<int> visible_ids(Table *table, Trx *trx)
+{
+  std::vector<int> ids;
+  Field id_field(table, table->table_meta().field("id"));
+  RecordFileScanner scanner;
+  EXPECT_EQ(table->get_record_scanner(scanner, trx, true/*readonly*/), RC::SUCCESS);
+  Record record;
+  while (scanner.has_next()) {
+    EXPECT_EQ(scanner.next(record), RC::SUCCESS);
+    ids.push_back(id_field.get_int(record));
+  }
+  scanner.close_scan();
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+struct RidLess
+{
+  bool operator()(const RID &rid1, const RID &rid2) const { return RID::compare(&rid1, &rid2) < 0; }
+};
+using RidSet = std::set<RID, RidLess>;
+
+// 索引中所有索引项指向的记录
+static RidSet index_rids(Index *index)
+{
+  RidSet rids;
+  IndexScanner *scanner = index->create_scanner(nullptr, 0, true, nullptr, 0, true);
+  EXPECT_NE(scanner, nullptr);
+  RID rid;
+  while (scanner->next_entry(&rid, false) == RC::SUCCESS) {
+    rids.insert(rid);
+  }
+  scanner->destroy();
+  return rids;
+}
+
+/**
+ * 回收已经提交的删除：还有更早的快照能看到时不回收，回收以后槽位可以重新使用，索引项也一起删除
+ */
+TEST(test_mvcc_trx, test_vacuum)
+{
+  const char *db_dir = "mvcc_vacuum_test_dir";
+  system("rm -rf mvcc_vacuum_test_dir");
+  ASSERT_EQ(mkdir(db_dir, S_IRWXU), 0);
+  BufferPoolManager *bpm = new BufferPoolManager();
+  BufferPoolManager::set_instance(bpm);
+  ASSERT_EQ(TrxManager::init_global("mvcc"), RC::SUCCESS);
+  TrxManager *trx_kit = TrxManager::instance();
+
+  {
+    Db db;
+    ASSERT_EQ(db.init("mvcc_vacuum", db_dir), RC::SUCCESS);
+    AttrInfoSqlNode attrs[2] = {{INTS, "id", 4, false}, {INTS, "value", 4, false}};
+    ASSERT_EQ(db.create_table("vacuum_t", 2, attrs), RC::SUCCESS);
+    Table *table = db.find_table("vacuum_t");
+    ASSERT_NE(table, nullptr);
+    std::vector<const FieldMeta *> index_fields = {table->table_meta().field("id")};
+    ASSERT_EQ(table->create_index(nullptr, index_fields, "vacuum_t_id", false), RC::SUCCESS);
+    Index *index = table->find_index("vacuum_t_id");
+    ASSERT_NE(index, nullptr);
+
+    const int record_num = 10;
+    const int delete_num = 4;
+    std::vector<RID> rids;
+    Trx *insert_trx = trx_kit->create_trx(db.log_manager());
+    for (int i = 0; i < record_num; i++) {
+      Value values[2] = {Value(i), Value(i * 10)};
+      Record record;
+      ASSERT_EQ(table->make_record(2, values, record), RC::SUCCESS);
+      ASSERT_EQ(insert_trx->insert_record(table, record), RC::SUCCESS);
+      rids.push_back(record.rid());
+    }
+    ASSERT_EQ(insert_trx->commit(), RC::SUCCESS);
+
+    // 删除提交之前开始的只读事务，一直可以看到被删除的记录
+    Trx *old_trx = trx_kit->create_trx(db.log_manager());
+    ASSERT_EQ(old_trx->start_if_need(), RC::SUCCESS);
+
+    Trx *delete_trx = trx_kit->create_trx(db.log_manager());
+    RidSet dead_rids;
+    for (int i = 0; i < delete_num; i++) {
+      Record record;
+      ASSERT_EQ(table->get_record(rids[i], record), RC::SUCCESS);
+      ASSERT_EQ(delete_trx->delete_record(table, record), RC::SUCCESS);
+      dead_rids.insert(rids[i]);
+    }
+    ASSERT_EQ(delete_trx->commit(), RC::SUCCESS);
+
+    int removed = -1;
+    ASSERT_EQ(db.vacuum(table, removed), RC::SUCCESS);
+    ASSERT_EQ(removed, 0);
+    ASSERT_EQ(visible_ids(table, old_trx).size(), static_cast<size_t>(record_num));
+    ASSERT_EQ(index_rids(index).size(), static_cast<size_t>(record_num));
+
+    // 更早的快照结束以后，被删除的记录对谁都不可见了
+    ASSERT_EQ(old_trx->commit(), RC::SUCCESS);
+    ASSERT_EQ(db.vacuum(nullptr, removed), RC::SUCCESS);
+    ASSERT_EQ(removed, delete_num);
+    ASSERT_EQ(db.vacuum(table, removed), RC::SUCCESS);
+    ASSERT_EQ(removed, 0);
+
+    for (const RID &rid : dead_rids) {
+      Record record;
+      ASSERT_NE(table->get_record(rid, record), RC::SUCCESS);
+    }
+    ASSERT_EQ(index_rids(index), RidSet(rids.begin() + delete_num, rids.end()));
+
+    Trx *read_trx = trx_kit->create_trx(db.log_manager());
+    std::vector<int> expected_ids;
+    for (int i = delete_num; i < record_num; i++) {
+      expected_ids.push_back(i);
+    }
+    ASSERT_EQ(visible_ids(table, read_trx), expected_ids);
+
+    // 新插入的记录使用回收出来的槽位
+    Value values[2] = {Value(record_num), Value(record_num * 10)};
+    Record record;
+    ASSERT_EQ(table->make_record(2, values, record), RC::SUCCESS);
+    ASSERT_EQ(read_trx->insert_record(table, record), RC::SUCCESS);
+    ASSERT_EQ(dead_rids.count(record.rid()), 1UL);
+    ASSERT_EQ(read_trx->commit(), RC::SUCCESS);
+    ASSERT_EQ(index_rids(index).count(record.rid()), 1UL);
+
+    trx_kit->destroy_trx(insert_trx);
+    trx_kit->destroy_trx(old_trx);
+    trx_kit->destroy_trx(delete_trx);
+    trx_kit->destroy_trx(read_trx);
+  }
+
+  BufferPoolManager::set_instance(nullptr);
+  delete bpm;
+}
@@ -0,0 +1,252 @@
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/storage_engine/buffer/buffer_pool.h"
+#include "include/storage_engine/recorder/condition_filter.h"
+#include "include/storage_engine/recorder/record.h"
+#include "include/storage_engine/recorder/record_manager.h"
+
+/**
+ * 变长记录页面：删除记录留下的空洞在剩余空间不够时压缩掉，空槽位会被重新使用，RID 不变
+ */
+TEST(test_record_manager, test_slotted_page)
+{
+  const char *data_file = "test_slotted_page.data";
+  ::remove(data_file);
+  BufferPoolManager *bpm = new BufferPoolManager();
+  FileBufferPool *bp = nullptr;
+  ASSERT_EQ(bpm->create_file(data_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(data_file, bp), RC::SUCCESS);
+
+  Frame *frame = nullptr;
+  ASSERT_EQ(bp->allocate_page(&frame), RC::SUCCESS);
+  const PageNum page_num = frame->page_num();
+
+  RecordPageHandler page_handler;
+  ASSERT_EQ(page_handler.init_empty_slotted_page(*bp, page_num, 16), RC::SUCCESS);
+  frame->unpin();
+
+  // 不同长度的记录
+  std::map<SlotNum, std::string> records;
+  for (int i = 0; page_handler.has_space(100 + i % 300); i++) {
+    std::string data(100 + i % 300, 'a' + i % 26);
+    RID rid;
+    ASSERT_EQ(page_handler.insert_record(data.data(), data.size(), &rid), RC::SUCCESS);
+    ASSERT_EQ(rid.page_num, page_num);
+    records[rid.slot_num] = data;
+  }
+  ASSERT_GT(records.size(), 10u);
+  ASSERT_EQ(page_handler.insert_record(std::string(1000, 'z').data(), 1000, nullptr), RC::RECORD_NOMEM);
+
+  // 删除一半的记录以后可以放下更长的记录，中间的空槽位被重新使用
+  for (auto iter = records.begin(); iter != records.end();) {
+    if (iter->first % 2 == 0) {
+      RID rid(page_num, iter->first);
+      ASSERT_EQ(page_handler.delete_record(&rid), RC::SUCCESS);
+      iter = records.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  std::string long_data(1000, 'z');
+  RID rid;
+  ASSERT_EQ(page_handler.insert_record(long_data.data(), long_data.size(), &rid), RC::SUCCESS);
+  ASSERT_EQ(rid.slot_num, 0);
+  records[rid.slot_num] = long_data;
+
+  RecordPageIterator iterator;
+  iterator.init(page_handler);
+  size_t count = 0;
+  Record record;
+  while (iterator.has_next()) {
+    ASSERT_EQ(iterator.next(record), RC::SUCCESS);
+    ASSERT_EQ(std::string(record.data(), record.len()), records[record.rid().slot_num]);
+    count++;
+  }
+  ASSERT_EQ(count, records.size());
+
+  page_handler.cleanup();
+  bp->close_file();
+  delete bpm;
+  ::remove(data_file);
+}
+
+/**
+ * 溢出页面：长数据跨多个页面存放，删除以后页面可以用来插入记录，扫描时跳过溢出页面
+ */
+TEST(test_record_manager, test_overflow_pages)
+{
+  const char *data_file = "test_overflow_pages.data";
+  ::remove(data_file);
+  BufferPoolManager *bpm = new BufferPoolManager();
+  FileBufferPool *bp = nullptr;
+  ASSERT_EQ(bpm->create_file(data_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(data_file, bp), RC::SUCCESS);
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(file_handler.init(bp, nullptr, 8 /*min_record_size*/), RC::SUCCESS);
+
+  std::string long_data(3 * BP_PAGE_SIZE, ' ');
+  for (size_t i = 0; i < long_data.size(); i++) {
+    long_data[i] = 'a' + i % 26;
+  }
+  PageNum first_page = BP_INVALID_PAGE_NUM;
+  ASSERT_EQ(file_handler.insert_overflow(long_data.data(), long_data.size(), &first_page), RC::SUCCESS);
+  std::string read_data(long_data.size(), '\0');
+  ASSERT_EQ(file_handler.read_overflow(first_page, read_data.size(), read_data.data()), RC::SUCCESS);
+  ASSERT_EQ(read_data, long_data);
+
+  std::vector<RID> rids(10);
+  for (int i = 0; i < 10; i++) {
+    std::string data(8 + i, '0' + i);
+    ASSERT_EQ(file_handler.insert_record(data.data(), data.size(), &rids[i]), RC::SUCCESS);
+  }
+  RecordFileScanner scanner;
+  ASSERT_EQ(scanner.open_scan(nullptr, *bp, nullptr, true /*readonly*/, nullptr), RC::SUCCESS);
+  int count = 0;
+  Record record;
+  while (scanner.has_next()) {
+    ASSERT_EQ(scanner.next(record), RC::SUCCESS);
+    ASSERT_EQ(record.len(), 8 + count);
+    count++;
+  }
+  ASSERT_EQ(count, 10);
+  scanner.close_scan();
+
+  const int page_count = bp->page_count();
+  ASSERT_EQ(file_handler.free_page_count(), 1);
+  ASSERT_EQ(file_handler.delete_overflow(first_page), RC::SUCCESS);
+  ASSERT_EQ(file_handler.free_page_count(), 5);
+  ASSERT_EQ(file_handler.read_overflow(first_page, read_data.size(), read_data.data()), RC::RECORD_NOT_EXIST);
+
+  // 释放的溢出页面用来存放记录，不需要分配新的页面
+  std::string data(2000, 'r');
+  for (int i = 0; i < 12; i++) {
+    RID rid;
+    ASSERT_EQ(file_handler.insert_record(data.data(), data.size(), &rid), RC::SUCCESS);
+  }
+  ASSERT_EQ(bp->page_count(), page_count);
+
+  file_handler.close();
+  bp->close_file();
+  delete bpm;
+  ::remove(data_file);
+}
+
+/**
+ * 定长记录页面：在页面内存上批量过滤，null 和空闲槽位都不满足条件，扫描器按照批量过滤的结果返回记录
+ */
+TEST(test_record_manager, test_filter_records)
+{
+  const char *data_file = "test_filter_records.data";
+  ::remove(data_file);
+  BufferPoolManager *bpm = new BufferPoolManager();
+  FileBufferPool *bp = nullptr;
+  ASSERT_EQ(bpm->create_file(data_file), RC::SUCCESS);
+  ASSERT_EQ(bpm->open_file(data_file, bp), RC::SUCCESS);
+
+  Frame *frame = nullptr;
+  ASSERT_EQ(bp->allocate_page(&frame), RC::SUCCESS);
+  const PageNum page_num = frame->page_num();
+
+  // 记录格式：| a int | f float | null 位图(a 是第0位) | 填充 |
+  const int record_size = 12;
+  RecordPageHandler page_handler;
+  ASSERT_EQ(page_handler.init_empty_page(*bp, page_num, record_size), RC::SUCCESS);
+  frame->unpin();
+
+  const int record_num = 60;
+  std::map<SlotNum, int> live;  // slot -> i
+  for (int i = 0; i < record_num; i++) {
+    char data[record_size] = {0};
+    const int a = i;
+    const float f = static_cast<float>(i % 40);
+    memcpy(data, &a, sizeof(a));
+    memcpy(data + 4, &f, sizeof(f));
+    if (i % 11 == 0) {
+      data[8] = 1;
+    }
+    RID rid;
+    ASSERT_EQ(page_handler.insert_record(data, &rid), RC::SUCCESS);
+    live[rid.slot_num] = i;
+  }
+  for (int i = 0; i < record_num; i += 7) {
+    RID rid(page_num, i);
+    ASSERT_EQ(page_handler.delete_record(&rid), RC::SUCCESS);
+    live.erase(i);
+  }
+
+  // a >= 10 and 30 > f
+  ConDesc a_attr;
+  a_attr.is_attr = true;
+  a_attr.attr_length = 4;
+  a_attr.attr_offset = 0;
+  a_attr.null_bitmap_offset = 8;
+  a_attr.null_bit = 0;
+  ConDesc a_value;
+  a_value.is_attr = false;
+  a_value.value = Value(10);
+  ConDesc f_attr;
+  f_attr.is_attr = true;
+  f_attr.attr_length = 4;
+  f_attr.attr_offset = 4;
+  ConDesc f_value;
+  f_value.is_attr = false;
+  f_value.value = Value(30.0f);
+  DefaultConditionFilter a_filter;
+  DefaultConditionFilter f_filter;
+  ASSERT_EQ(a_filter.init(a_attr, a_value, INTS, GREAT_EQUAL), RC::SUCCESS);
+  ASSERT_EQ(f_filter.init(f_value, f_attr, FLOATS, GREAT_THAN), RC::SUCCESS);
+  const ConditionFilter *filters[] = {&a_filter, &f_filter};
+  CompositeConditionFilter filter;
+  ASSERT_EQ(filter.init(filters, 2), RC::SUCCESS);
+
+  std::set<SlotNum> expected;
+  for (const auto &[slot_num, i] : live) {
+    if (i % 11 != 0 && i >= 10 && i % 40 < 30) {
+      expected.insert(slot_num);
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+
+  std::vector<char> bitmap((page_handler.record_capacity() + 7) / 8);
+  ASSERT_EQ(page_handler.filter_records(filter, bitmap.data()), RC::SUCCESS);
+  std::set<SlotNum> filtered;
+  common::Bitmap result(bitmap.data(), page_handler.record_capacity());
+  for (int i = 0; i < page_handler.record_capacity(); i++) {
+    if (result.get_bit(i)) {
+      filtered.insert(i);
+    }
+  }
+  ASSERT_EQ(filtered, expected);
+  page_handler.cleanup();
+
+  RecordFileScanner scanner;
+  ASSERT_EQ(scanner.open_scan(nullptr, *bp, nullptr, true /*readonly*/, &filter), RC::SUCCESS);
+  std::set<SlotNum> scanned;
+  Record record;
+  while (scanner.has_next()) {
+    ASSERT_EQ(scanner.next(record), RC::SUCCESS);
+    scanned.insert(record.rid().slot_num);
+  }
+  scanner.close_scan();
+  ASSERT_EQ(scanned, expected);
+
+  bp->close_file();
+  delete bpm;
+  ::remove(data_file);
+}
+
+int main(int argc, char **argv)
+{
+  // 分析gtest程序的命令行参数
+  testing::InitGoogleTest(&argc, argv);
+
+  // 调用RUN_ALL_TESTS()运行所有测试用例
+  // main函数返回RUN_ALL_TESTS()的运行结果
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,736 @@
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <map>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/os/process_param.h"
+#include "include/common/global_context.h"
+#include "include/session/server.h"
+#include "include/storage_engine/buffer/buffer_pool.h"
+#include "include/storage_engine/index/bplus_tree_index.h"
+#include "include/storage_engine/schema/database.h"
+#include "include/storage_engine/schema/default_handler.h"
+#include "include/storage_engine/transaction/trx.h"
+
+static const char *SOCKET_PATH = "server_test.sock";
+
+/**
+ * 一个简单的客户端，使用文本协议：请求和应答都以'\0'结尾
+ */
+class TestClient
+{
+public:
+  ~TestClient()
+  {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  bool connect()
+  {
+    fd_ = socket(PF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un sockaddr;
+    memset(&sockaddr, 0, sizeof(sockaddr));
+    sockaddr.sun_family = PF_UNIX;
+    snprintf(sockaddr.sun_path, sizeof(sockaddr.sun_path), "%s", SOCKET_PATH);
+    for (int i = 0; i < 100; i++) {
+      if (::connect(fd_, (struct sockaddr *)&sockaddr, sizeof(sockaddr)) == 0) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+  }
+
+  /**
+   * @brief 执行一条SQL，读取全部应答
+   * @details 执行成功时，服务端最后总会发送一条以"Cost time"开头的耗时统计，
+   * 前面可能还有单独发送的执行状态，这里一直读到耗时统计为止
+   */
+  bool query(const std::string &sql, std::string &result)
+  {
+    if (common::writen(fd_, sql.c_str(), sql.size() + 1) != 0) {
+      return false;
+    }
+
+    result.clear();
+    size_t message_begin = 0;
+    char c = 0;
+    while (::read(fd_, &c, 1) == 1) {
+      if (c != '\0') {
+        result.push_back(c);
+        continue;
+      }
+      if (result.find("Cost time", message_begin) != std::string::npos) {
+        return true;
+      }
+      message_begin = result.size();
+    }
+    return false;
+  }
+
+private:
+  int fd_ = -1;
+};
+
+class ServerTest : public testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    system("rm -rf server_test_dir");
+    GCTX.buffer_pool_manager_ = new BufferPoolManager();
+    BufferPoolManager::set_instance(GCTX.buffer_pool_manager_);
+    GCTX.handler_ = new DefaultHandler();
+    DefaultHandler::set_default(GCTX.handler_);
+    ASSERT_EQ(TrxManager::init_global("vacuous"), RC::SUCCESS);
+    GCTX.trx_manager_ = TrxManager::instance();
+    ASSERT_EQ(GCTX.handler_->init("server_test_dir"), RC::SUCCESS);
+    // 排序使用很小的内存，让数据较多的排序写临时文件
+    common::the_process_param()->set_sort_memory_size(16 * 1024);
+    // 哈希连接同样使用很小的内存，让构建侧的分区写临时文件并重新分区
+    common::the_process_param()->set_join_memory_size(16 * 1024);
+    // 分组聚合也使用很小的内存，让分组多的聚合写临时文件并重新聚合
+    common::the_process_param()->set_group_memory_size(16 * 1024);
+
+    ServerParam server_param;
+    server_param.protocol = CommunicateProtocol::PLAIN;
+    server_param.use_unix_socket = true;
+    server_param.unix_socket_path = SOCKET_PATH;
+#ifdef CONCURRENCY
+    server_param.worker_thread_num = 4;
+#endif
+    server_ = new Server(server_param);
+    server_thread_ = std::thread([]() { server_->serve(); });
+  }
+
+  static void TearDownTestSuite()
+  {
+    // 等待服务启动完成再关闭，否则 shutdown 可能在事件循环开始前执行
+    TestClient client;
+    client.connect();
+    server_->shutdown();
+    server_thread_.join();
+    delete server_;
+
+    DefaultHandler::set_default(nullptr);
+    delete GCTX.handler_;
+    BufferPoolManager::set_instance(nullptr);
+    delete GCTX.buffer_pool_manager_;
+  }
+
+  static Server     *server_;
+  static std::thread server_thread_;
+};
+
+Server     *ServerTest::server_ = nullptr;
+std::thread ServerTest::server_thread_;
+
+/**
+ * 每个连接上的请求按发送的顺序执行，不同连接的请求并发执行
+ */
+TEST_F(ServerTest, concurrent_clients)
+{
+  TestClient admin;
+  ASSERT_TRUE(admin.connect());
+  std::string result;
+  ASSERT_TRUE(admin.query("create table session_order(id int, value int);", result));
+  ASSERT_NE(result.find("SUCCESS"), std::string::npos);
+
+  const int client_num = 4;
+  const int insert_num = 50;
+  std::vector<std::thread> threads;
+  std::vector<int> errors(client_num, 0);
+  for (int c = 0; c < client_num; c++) {
+    threads.emplace_back([c, &errors]() {
+      TestClient client;
+      if (!client.connect()) {
+        errors[c]++;
+        return;
+      }
+      std::string result;
+      for (int i = 0; i < insert_num; i++) {
+        std::string sql = "insert into session_order values(" + std::to_string(c) + "," + std::to_string(i) + ");";
+        if (!client.query(sql, result) || result.find("SUCCESS") == std::string::npos) {
+          errors[c]++;
+        }
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  for (int c = 0; c < client_num; c++) {
+    ASSERT_EQ(errors[c], 0);
+  }
+
+  ASSERT_TRUE(admin.query("select * from session_order;", result));
+  int rows = 0;
+  for (size_t pos = result.find('\n'); pos != std::string::npos; pos = result.find('\n', pos + 1)) {
+    rows++;
+  }
+  // 表头、数据行和耗时统计各占一行
+  ASSERT_EQ(rows, client_num * insert_num + 2);
+}
+
+/**
+ * 扫描、过滤和聚合按批执行，数据跨越多个批次时结果与逐行计算的结果一致
+ */
+TEST_F(ServerTest, batch_aggregation)
+{
+  TestClient client;
+  ASSERT_TRUE(client.connect());
+  std::string result;
+  ASSERT_TRUE(client.query("create table batch_aggregation(id int, value int, score float);", result));
+
+  const int row_num = 3000;
+  int count = 0;
+  long sum = 0;
+  int min_value = INT32_MAX;
+  int max_value = INT32_MIN;
+  for (int i = 0; i < row_num; i++) {
+    const int value = (i * 37) % 101;
+    std::string sql = "insert into batch_aggregation values(" + std::to_string(i) + "," + std::to_string(value) + ",";
+    sql += (i % 10 == 0) ? "null);" : "1.5);";
+    ASSERT_TRUE(client.query(sql, result));
+    if (i >= 1000 && value < 50) {
+      count++;
+      sum += value;
+      min_value = std::min(min_value, value);
+      max_value = std::max(max_value, value);
+    }
+  }
+
+  ASSERT_TRUE(client.query(
+      "select count(*), sum(value), min(value), max(value) from batch_aggregation where id >= 1000 and value < 50;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  std::string expected = std::to_string(count) + "|" + std::to_string(sum) + "|" + std::to_string(min_value) + "|" +
+                         std::to_string(max_value) + "\n";
+  ASSERT_NE(result.find(expected), std::string::npos) << result;
+
+  // score 每10行有一个null
+  ASSERT_TRUE(client.query("select count(score), count(*) from batch_aggregation where 1500 > id;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("1350|1500\n"), std::string::npos) << result;
+
+  // 没有过滤条件的COUNT(*)直接读取页头中的记录数
+  ASSERT_TRUE(client.query("delete from batch_aggregation where id >= 2500;", result));
+  ASSERT_TRUE(client.query("select count(*) from batch_aggregation;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("count(*)\n2500\n"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select count(*), avg(value) from batch_aggregation where id < 0;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("0|NULL\n"), std::string::npos) << result;
+}
+
+/**
+ * CREATE INDEX ... COMPRESSED 创建前缀压缩的索引，不加 COMPRESSED 时仍然是原来的格式
+ */
+TEST_F(ServerTest, compressed_index)
+{
+  TestClient client;
+  ASSERT_TRUE(client.connect());
+  std::string result;
+  ASSERT_TRUE(client.query("create table compressed_index(id int, name char(32));", result));
+  for (int i = 0; i < 300; i++) {
+    char name[32];
+    snprintf(name, sizeof(name), "customer_%05d", i);
+    ASSERT_TRUE(client.query(
+        "insert into compressed_index values(" + std::to_string(i) + ",'" + name + "');", result));
+  }
+  ASSERT_TRUE(client.query("create index compressed_index_name on compressed_index(name) COMPRESSED;", result));
+  ASSERT_NE(result.find("SUCCESS"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("create index compressed_index_id on compressed_index(id);", result));
+  ASSERT_NE(result.find("SUCCESS"), std::string::npos) << result;
+
+  Table *table = GCTX.handler_->find_db("sys")->find_table("compressed_index");
+  ASSERT_NE(table, nullptr);
+  auto *name_index = static_cast<BplusTreeIndex *>(table->find_index("compressed_index_name"));
+  auto *id_index = static_cast<BplusTreeIndex *>(table->find_index("compressed_index_id"));
+  ASSERT_NE(name_index, nullptr);
+  ASSERT_NE(id_index, nullptr);
+  ASSERT_TRUE(name_index->get_index_handler().key_compressed());
+  ASSERT_FALSE(id_index->get_index_handler().key_compressed());
+
+  // 建好索引以后继续插入和删除，走压缩节点的修改路径
+  for (int i = 300; i < 600; i++) {
+    char name[32];
+    snprintf(name, sizeof(name), "customer_%05d", i);
+    ASSERT_TRUE(client.query(
+        "insert into compressed_index values(" + std::to_string(i) + ",'" + name + "');", result));
+  }
+  ASSERT_TRUE(client.query("delete from compressed_index where id < 100;", result));
+
+  ASSERT_TRUE(client.query("select id from compressed_index where name = 'customer_00456';", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("id\n456\n"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select id from compressed_index where name = 'customer_00050';", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("id\nCosttime"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select count(*) from compressed_index where name >= 'customer_00500';", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n100\n"), std::string::npos) << result;
+}
+
+/**
+ * 排序的数据超过内存限制时写到临时文件中再归并，结果与在内存中排序相同
+ */
+TEST_F(ServerTest, external_order_by)
+{
+  TestClient client;
+  ASSERT_TRUE(client.connect());
+  std::string result;
+  ASSERT_TRUE(client.query("create table external_order_by(id int, value int, name char(8));", result));
+
+  const int row_num = 2000;
+  std::vector<std::pair<int, int>> rows;  // (value, id)，value 为 null 时是 INT32_MIN
+  for (int i = 0; i < row_num; i++) {
+    const int value = (i * 7919) % 97;
+    std::string sql = "insert into external_order_by values(" + std::to_string(i) + ",";
+    sql += (i % 50 == 0) ? "null" : std::to_string(value);
+    sql += ",'n" + std::to_string(i % 13) + "');";
+    ASSERT_TRUE(client.query(sql, result));
+    rows.emplace_back(i % 50 == 0 ? INT32_MIN : value, i);
+  }
+
+  // value 降序，null 排在最后，value 相同时按 id 升序
+  std::sort(rows.begin(), rows.end(), [](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+    return a.first != b.first ? a.first > b.first : a.second < b.second;
+  });
+  std::string expected;
+  for (const std::pair<int, int> &row : rows) {
+    expected += std::to_string(row.second) + "|" + (row.first == INT32_MIN ? "NULL" : std::to_string(row.first)) + "\n";
+  }
+
+  ASSERT_TRUE(client.query("select id, value from external_order_by order by value desc, id;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find(expected), std::string::npos) << result.substr(0, 200);
+}
+
+/**
+ * ORDER BY ... LIMIT n 只保留排序后的前 n 行，结果与完整排序的前 n 行相同
+ */
+TEST_F(ServerTest, order_by_limit)
+{
+  TestClient client;
+  ASSERT_TRUE(client.connect());
+  std::string result;
+  ASSERT_TRUE(client.query("create table order_by_limit(id int, value int);", result));
+
+  const int row_num = 2000;
+  const int limit = 25;
+  std::vector<std::pair<int, int>> rows;  // (value, id)
+  for (int i = 0; i < row_num; i++) {
+    const int value = (i * 7919) % 97;
+    ASSERT_TRUE(client.query(
+        "insert into order_by_limit values(" + std::to_string(i) + "," + std::to_string(value) + ");", result));
+    rows.emplace_back(value, i);
+  }
+
+  std::sort(rows.begin(), rows.end(), [](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+    return a.first != b.first ? a.first > b.first : a.second < b.second;
+  });
+  std::string expected = "id|value\n";
+  for (int i = 0; i < limit; i++) {
+    expected += std::to_string(rows[i].second) + "|" + std::to_string(rows[i].first) + "\n";
+  }
+
+  ASSERT_TRUE(client.query(
+      "select id, value from order_by_limit order by value desc, id limit " + std::to_string(limit) + ";", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find(expected + "Costtime"), std::string::npos) << result.substr(0, 200);
+
+  ASSERT_TRUE(client.query("select id, value from order_by_limit order by value LIMIT 0;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("id|value\nCosttime"), std::string::npos) << result.substr(0, 200);
+}
+
+TEST_F(ServerTest, grace_hash_join)
+{
+  TestClient client;
+  ASSERT_TRUE(client.connect());
+  std::string result;
+  ASSERT_TRUE(client.query("create table hash_join_l(id int, k int);", result));
+  ASSERT_TRUE(client.query("create table hash_join_r(id int, k int);", result));
+
+  // 左表中 k=0 的行特别多，这个分区重新分区以后仍然放不进内存
+  std::vector<std::pair<int, int>> left;
+  std::vector<std::pair<int, int>> right;
+  for (int i = 0; i < 1200; i++) {
+    const int k = i < 400 ? 0 : i % 31;
+    std::string sql = "insert into hash_join_l values(" + std::to_string(i) + ",";
+    sql += (i % 97 == 1) ? "null" : std::to_string(k);
+    ASSERT_TRUE(client.query(sql + ");", result));
+    left.emplace_back(i, i % 97 == 1 ? -1 : k);
+  }
+  for (int i = 0; i < 150; i++) {
+    ASSERT_TRUE(client.query(
+        "insert into hash_join_r values(" + std::to_string(i) + "," + std::to_string(i % 37) + ");", result));
+    right.emplace_back(i, i % 37);
+  }
+
+  std::string expected;
+  for (const std::pair<int, int> &l : left) {
+    for (const std::pair<int, int> &r : right) {
+      if (l.second == r.second) {
+        expected += std::to_string(l.first) + "|" + std::to_string(r.first) + "\n";
+      }
+    }
+  }
+
+  ASSERT_TRUE(client.query("select hash_join_l.id, hash_join_r.id from hash_join_l inner join hash_join_r "
+                           "on hash_join_r.k = hash_join_l.k order by hash_join_l.id, hash_join_r.id;",
+      result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find(expected), std::string::npos) << result.substr(0, 200);
+}
+
+/**
+ * 浮点数按照 EPSILON 比较相等，相差小于 EPSILON 的连接键也能连接上，整数与浮点数连接时也一样
+ */
+TEST_F(ServerTest, float_key_join)
+{
+  TestClient client;
+  ASSERT_TRUE(client.connect());
+  std::string result;
+  ASSERT_TRUE(client.query("create table float_join_l(id int, f float);", result));
+  ASSERT_TRUE(client.query("create table float_join_r(id int, f float);", result));
+  ASSERT_TRUE(client.query("create table float_join_i(id int, k int);", result));
+  ASSERT_TRUE(client.query("insert into float_join_l values(1, 1.0);", result));
+  ASSERT_TRUE(client.query("insert into float_join_l values(2, 2.5);", result));
+  ASSERT_TRUE(client.query("insert into float_join_r values(10, 1.0000001);", result));
+  ASSERT_TRUE(client.query("insert into float_join_r values(20, 2.5);", result));
+  ASSERT_TRUE(client.query("insert into float_join_r values(30, 3.5);", result));
+  ASSERT_TRUE(client.query("insert into float_join_i values(100, 1);", result));
+  ASSERT_TRUE(client.query("insert into float_join_i values(300, 3);", result));
+
+  ASSERT_TRUE(client.query("select float_join_l.id, float_join_r.id from float_join_l inner join float_join_r "
+                           "on float_join_l.f = float_join_r.f order by float_join_l.id;",
+      result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("1|10\n2|20\n"), std::string::npos) << result;
+
+  ASSERT_TRUE(client.query("select float_join_r.id, float_join_i.id from float_join_r inner join float_join_i "
+                           "on float_join_i.k = float_join_r.f;",
+      result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("10|100\n"), std::string::npos) << result;
+  ASSERT_EQ(result.find("300"), std::string::npos) << result;
+}
+
+/**
+ * 分组很多时哈希表写到临时文件中再重新聚合，结果与直接在内存中聚合相同
+ */
+TEST_F(ServerTest, hash_group_by)
+{
+  TestClient client;
+  ASSERT_TRUE(client.connect());
+  std::string result;
+  ASSERT_TRUE(client.query("create table hash_group_by(id int, k int, name char(8));", result));
+
+  const int row_num = 3000;
+  const int group_num = 700;
+  std::map<int, std::tuple<int, int, std::string>> expected;  // k -> count, sum(id), max(name)
+  for (int i = 0; i < row_num; i += 100) {
+    std::string sql = "insert into hash_group_by values";
+    for (int j = i; j < i + 100; j++) {
+      const int k = j % group_num;
+      const std::string name = "n" + std::to_string(j % 13);
+      sql += (j == i ? "(" : ",(") + std::to_string(j) + "," + std::to_string(k) + ",'" + name + "')";
+      auto &[count, sum, max_name] = expected[k];
+      count++;
+      sum += j;
+      max_name = std::max(max_name, name);
+    }
+    ASSERT_TRUE(client.query(sql + ";", result));
+    ASSERT_NE(result.find("SUCCESS"), std::string::npos) << result;
+  }
+
+  ASSERT_TRUE(client.query("select k, count(*), sum(id), max(name) from hash_group_by group by k;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  for (const auto &[k, aggr] : expected) {
+    const auto &[count, sum, max_name] = aggr;
+    const std::string line = std::to_string(k) + "|" + std::to_string(count) + "|" + std::to_string(sum) + "|" + max_name;
+    // 每个分组只输出一次
+    ASSERT_NE(result.find("\n" + line + "\n"), std::string::npos) << line;
+    ASSERT_EQ(result.find("\n" + std::to_string(k) + "|"), result.rfind("\n" + std::to_string(k) + "|")) << line;
+  }
+
+  ASSERT_TRUE(client.query("select name, count(*) from hash_group_by where id <= 1300 group by name "
+                           "having count(*) > 100;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\nn0|101\n"), std::string::npos) << result;
+  ASSERT_EQ(result.find("n1|"), std::string::npos) << result;
+}
+
+/**
+ * 查询只用到索引字段时只扫描索引，结果与读取数据页面相同。字符串比字段短、被更新成更短的值都能正确查到
+ */
+TEST_F(ServerTest, index_only_scan)
+{
+  TestClient client;
+  ASSERT_TRUE(client.connect());
+  std::string result;
+  ASSERT_TRUE(client.query("create table index_only_scan(id int, name char(40));", result));
+  for (int i = 0; i < 600; i++) {
+    std::string sql = "insert into index_only_scan values(" + std::to_string(i) + ",";
+    sql += (i % 100 == 7) ? "null);" : "'customer-account-" + std::to_string(i % 50) + "');";
+    ASSERT_TRUE(client.query(sql, result));
+  }
+  ASSERT_TRUE(client.query("create index i_name on index_only_scan(name);", result));
+
+  ASSERT_TRUE(client.query("explain select count(*) from index_only_scan where name = 'customer-account-7';", result));
+  ASSERT_NE(result.find("INDEX_ONLY_SCAN(i_name ON index_only_scan)"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("explain select id from index_only_scan where name = 'customer-account-7';", result));
+  ASSERT_EQ(result.find("INDEX_ONLY_SCAN"), std::string::npos) << result;
+  ASSERT_NE(result.find("INDEX_SCAN(i_name ON index_only_scan)"), std::string::npos) << result;
+
+  // id 为 7、107、... 的行是 null
+  ASSERT_TRUE(client.query("select count(*) from index_only_scan where name = 'customer-account-7';", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n6\n"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select count(*) from index_only_scan where name = 'customer-account-8';", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n12\n"), std::string::npos) << result;
+
+  ASSERT_TRUE(client.query("update index_only_scan set name = 'customer-1' where id = 8;", result));
+  ASSERT_TRUE(client.query("delete from index_only_scan where id = 58;", result));
+  ASSERT_TRUE(client.query("select name from index_only_scan where name = 'customer-1';", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("name\ncustomer-1\n"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select count(*) from index_only_scan where name = 'customer-account-8';", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n10\n"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select id from index_only_scan where name = 'customer-account-8' and id > 400;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("id\n408\n458\n508\n558\n"), std::string::npos) << result;
+}
+
+/**
+ * 导入的数据跨越多个解析段，空索引在导入后构建，非空索引逐条插入，都能通过索引查到。遇到错误的行停止导入
+ */
+TEST_F(ServerTest, load_data)
+{
+  const std::string file_name = "server_test_dir/load_data.txt";
+  FILE *file = fopen(file_name.c_str(), "w");
+  ASSERT_NE(file, nullptr);
+  for (int i = 0; i < 100000; i++) {
+    fprintf(file, "%d| %d |item-%d|%d.5\n", i, i % 100, i % 7, i);
+  }
+  fclose(file);
+  file = fopen("server_test_dir/load_data_error.txt", "w");
+  ASSERT_NE(file, nullptr);
+  fprintf(file, "100000|1|item|1.0\n\n100001|one|item|1.0\n100002|2|item|2.0\n");
+  fclose(file);
+
+  common::the_process_param()->set_load_thread_num(4);
+  TestClient client;
+  ASSERT_TRUE(client.connect());
+  std::string result;
+  ASSERT_TRUE(client.query("create table load_data(id int, k int, name char(10), f float);", result));
+  ASSERT_TRUE(client.query("create index i_k on load_data(k);", result));
+  ASSERT_TRUE(client.query("load data infile '" + file_name + "' into table load_data;", result));
+  ASSERT_NE(result.find("100000 record(s) loaded"), std::string::npos) << result;
+  ASSERT_NE(result.find("row(s) per second"), std::string::npos) << result;
+
+  ASSERT_TRUE(client.query("select count(*) from load_data where k = 42;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n1000\n"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select * from load_data where id = 99999;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n99999|99|item-4|99999.5\n"), std::string::npos) << result;
+
+  ASSERT_TRUE(client.query("load data infile 'server_test_dir/load_data_error.txt' into table load_data;", result));
+  ASSERT_NE(result.find("Line:3 insert record failed"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select count(*) from load_data where k = 1;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n1001\n"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select count(*) from load_data;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n100001\n"), std::string::npos) << result;
+}
+
+/**
+ * 数据页面多的表由多个线程按页面范围并行扫描，每个线程各自聚合，合并后的结果与单线程相同
+ */
+TEST_F(ServerTest, parallel_aggregation)
+{
+  const std::string file_name = "server_test_dir/parallel_aggregation.txt";
+  FILE *file = fopen(file_name.c_str(), "w");
+  ASSERT_NE(file, nullptr);
+  const int row_num = 100000;
+  long sum = 0;
+  int count = 0;
+  for (int i = 0; i < row_num; i++) {
+    const int value = (i * 37) % 1001;
+    fprintf(file, "%d|%d|name-%d|%d.5\n", i, value, i % 1000, i % 10);
+    if (value < 500) {
+      count++;
+      sum += value;
+    }
+  }
+  fclose(file);
+
+  common::the_process_param()->set_scan_thread_num(4);
+  TestClient client;
+  ASSERT_TRUE(client.connect());
+  std::string result;
+  ASSERT_TRUE(client.query("create table parallel_aggregation(id int, v int, name char(12), f float);", result));
+  ASSERT_TRUE(client.query("load data infile '" + file_name + "' into table parallel_aggregation;", result));
+  ASSERT_NE(result.find("100000 record(s) loaded"), std::string::npos) << result;
+
+#ifdef CONCURRENCY
+  ASSERT_TRUE(client.query("explain select sum(v) from parallel_aggregation where v < 500;", result));
+  ASSERT_NE(result.find("GATHER(parallel_aggregation workers=4)"), std::string::npos) << result;
+#endif
+
+  ASSERT_TRUE(client.query(
+      "select count(*), sum(v), min(name), max(name), max(f) from parallel_aggregation where v < 500;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  const std::string expected = std::to_string(count) + "|" + std::to_string(sum) + "|name-0|name-999|9.5\n";
+  ASSERT_NE(result.find(expected), std::string::npos) << result;
+
+  ASSERT_TRUE(client.query("select count(*), min(id), max(id) from parallel_aggregation where id >= 1000;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("99000|1000|99999\n"), std::string::npos) << result;
+}
+
+/**
+ * TEXTS 字段：短文本放在记录中，长文本放在溢出页面上，更新和删除以后溢出页面可以重复使用
+ */
+TEST_F(ServerTest, text_values)
+{
+  TestClient client;
+  ASSERT_TRUE(client.connect());
+  std::string result;
+  ASSERT_TRUE(client.query("create table text_values(id int, name char(10), body text);", result));
+  // 长文本放在TOAST文件的溢出页面上，中等长度的文本是TOAST文件中的一条记录
+  const std::string long_text(20000, 'x');
+  const std::string medium_text(500, 'm');
+  for (int i = 0; i < 200; i++) {
+    std::string body = (i % 50 == 3) ? long_text : (i % 50 == 5) ? medium_text : "text-" + std::to_string(i);
+    ASSERT_TRUE(client.query("insert into text_values values(" + std::to_string(i) + ", 'n', '" + body + "');", result));
+    ASSERT_NE(result.find("SUCCESS"), std::string::npos) << result;
+  }
+
+  ASSERT_TRUE(client.query("select id, body from text_values where id = 42;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n42|text-42\n"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select body from text_values where id = 53;", result));
+  ASSERT_NE(result.find(long_text), std::string::npos);
+  ASSERT_TRUE(client.query("select count(*) from text_values where body = '" + long_text + "';", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n4\n"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select id from text_values where body = '" + medium_text + "';", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n55\n"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select sum(id) from text_values where id < 10;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n45\n"), std::string::npos) << result;
+
+  ASSERT_TRUE(client.query("update text_values set body = 'short' where id = 3;", result));
+  ASSERT_TRUE(client.query("delete from text_values where id = 103;", result));
+  ASSERT_TRUE(client.query("update text_values set body = '" + long_text + "' where id = 7;", result));
+  ASSERT_TRUE(client.query("select count(*) from text_values where body = '" + long_text + "';", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n3\n"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select id, body from text_values where body = 'short';", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n3|short\n"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select count(*) from text_values;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("\n199\n"), std::string::npos) << result;
+}
+
+/**
+ * 负载测试：输出不同并发客户端数量下的QPS
+ */
+TEST_F(ServerTest, load_generator)
+{
+  TestClient admin;
+  ASSERT_TRUE(admin.connect());
+  std::string result;
+  ASSERT_TRUE(admin.query("create table load_generator(id int, value int);", result));
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(admin.query("insert into load_generator values(" + std::to_string(i) + ",1);", result));
+  }
+
+  const int query_num_per_client = 200;
+  for (int client_num = 1; client_num <= 16; client_num *= 2) {
+    std::vector<std::thread> threads;
+    std::vector<int> errors(client_num, 0);
+    auto begin = std::chrono::steady_clock::now();
+    for (int c = 0; c < client_num; c++) {
+      threads.emplace_back([c, &errors]() {
+        TestClient client;
+        if (!client.connect()) {
+          errors[c]++;
+          return;
+        }
+        std::string result;
+        for (int i = 0; i < query_num_per_client; i++) {
+          if (!client.query("select * from load_generator where id < 10;", result)) {
+            errors[c]++;
+          }
+        }
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    printf("server load: clients=%d, queries=%d, qps=%.0f\n",
+           client_num, client_num * query_num_per_client, client_num * query_num_per_client / seconds);
+    for (int c = 0; c < client_num; c++) {
+      ASSERT_EQ(errors[c], 0);
+    }
+  }
+}
+
+/**
+ * VACUUM 语句。测试使用的事务管理器删除时就是物理删除，没有需要回收的记录；vacuum 仍然可以用作列名
+ */
+TEST_F(ServerTest, vacuum)
+{
+  TestClient client;
+  ASSERT_TRUE(client.connect());
+  std::string result;
+  ASSERT_TRUE(client.query("create table vacuum_t(id int, vacuum int);", result));
+  ASSERT_TRUE(client.query("create index vacuum_t_id on vacuum_t(id);", result));
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(client.query("insert into vacuum_t values(" + std::to_string(i) + ", " + std::to_string(i * 10) + ");", result));
+  }
+  ASSERT_TRUE(client.query("delete from vacuum_t where id >= 5;", result));
+
+  ASSERT_TRUE(client.query("vacuum vacuum_t;", result));
+  ASSERT_NE(result.find("SUCCESS. 0 record(s) removed"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("VACUUM;", result));
+  ASSERT_NE(result.find("record(s) removed"), std::string::npos) << result;
+
+  ASSERT_TRUE(client.query("select count(*), sum(vacuum) from vacuum_t;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("5|100\n"), std::string::npos) << result;
+  ASSERT_TRUE(client.query("select vacuum from vacuum_t where id = 3;", result));
+  result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+  ASSERT_NE(result.find("vacuum\n30\n"), std::string::npos) << result;
+}
+
+int main(int argc, char **argv)
+{
+  // 分析gtest程序的命令行参数
+  testing::InitGoogleTest(&argc, argv);
+
+  // 调用RUN_ALL_TESTS()运行所有测试用例
+  // main函数返回RUN_ALL_TESTS()的运行结果
+  return RUN_ALL_TESTS();
+}